@@ -0,0 +1,199 @@
+/****************************************************************************************
+* FILENAME :        atcProcl.c
+*
+* SHORT DESCRIPTION:
+*   Source file for atcProcl module.  
+*
+* DETAILED DESCRIPTION :   
+* This module decodes the advertisements of thermometers running the custom firmware
+* of ATC1441 or pvvx. Both formats use the service data of the environmental sensing
+* uuid 0x181a, they are told apart by the length of the service data (offsets 
+* relative to the service data after the uuid):
+*   - ATC1441, 13 bytes, big endian:
+*       mac address 0 - 5 (display order), temperature 6 - 7 (signed, 0.1 °C),
+*       humidity 8 (%), battery 9 (%), battery voltage 10 - 11 (mV), counter 12
+*   - pvvx, 15 bytes, little endian:
+*       mac address 0 - 5 (reversed), temperature 6 - 7 (signed, 0.01 °C),
+*       humidity 8 - 9 (0.01 %), battery voltage 10 - 11 (mV), battery 12 (%),
+*       counter 13, flags 14
+* The values are converted to the 0.1 units of the mija samples, so the samples of
+* both firmwares are handled like the samples of the original firmware.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17. Oct. 2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+****************************************************************************************/
+
+/***************************************************************************************/
+/* Include Interfaces */
+
+#include "atcProcl.h"
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stddef.h"
+#include "string.h"
+
+/***************************************************************************************/
+/* Local constant defines */
+
+#define ATC_FRAME_LEN           13U
+#define ATC_TEMP_ADR            6U
+#define ATC_HUM_ADR             8U
+#define ATC_BATT_ADR            9U
+#define ATC_CNT_ADR             12U
+
+#define PVVX_FRAME_LEN          15U
+#define PVVX_TEMP_ADR           6U
+#define PVVX_HUM_ADR            8U
+#define PVVX_BATT_ADR           12U
+#define PVVX_CNT_ADR            13U
+
+#define MAC_ADR                 0U
+#define SAMPLES_PER_FRAME       2U      // temperature and humidity, battery
+
+/***************************************************************************************/
+/* Local function like makros */
+
+/***************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/***************************************************************************************/
+/* Local functions prototypes: */
+static bool ReadFrameId_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8, 
+                                uint8_t *mac_u8p, uint8_t *msgCnt_u8p);
+
+/***************************************************************************************/
+/* Local variables: */
+
+/***************************************************************************************/
+/* Global functions (unlimited visibility) */
+
+/**--------------------------------------------------------------------------------------
+ * @brief     reads the sender address and the frame counter of the service data
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+bool atcProcl_GetFrameId_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                const uint8_t *bda_cu8p, uint8_t *mac_u8p, 
+                                uint8_t *msgCnt_u8p)
+{
+    bool exeResult_bol = false;
+
+    (void)bda_cu8p;
+    if((NULL != data_cu8p) && (NULL != mac_u8p) && (NULL != msgCnt_u8p))
+    {
+        exeResult_bol = ReadFrameId_bol(data_cu8p, dataLen_u8, mac_u8p, msgCnt_u8p);
+    }
+
+    return(exeResult_bol);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     decodes the service data into raw samples
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+uint8_t atcProcl_Decode_u8(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                const uint8_t *bda_cu8p, 
+                                mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8)
+{
+    uint8_t samples_u8 = 0U;
+    int16_t temp_s16;
+    uint16_t hum_u16;
+    uint8_t batt_u8;
+
+    (void)bda_cu8p;
+    if(   (NULL != data_cu8p) && (NULL != out_stap) && (SAMPLES_PER_FRAME <= maxOut_u8)
+       && (true == ReadFrameId_bol(data_cu8p, dataLen_u8, 
+                                    out_stap[0].macAddr_u8a, &out_stap[0].msgCnt_u8)))
+    {
+        if(ATC_FRAME_LEN == dataLen_u8)
+        {
+            temp_s16 = (int16_t)(((uint16_t)data_cu8p[ATC_TEMP_ADR] << 8U) 
+                                    | data_cu8p[ATC_TEMP_ADR + 1U]);
+            hum_u16 = (uint16_t)data_cu8p[ATC_HUM_ADR] * 10U;
+            batt_u8 = data_cu8p[ATC_BATT_ADR];
+        }
+        else
+        {
+            temp_s16 = (int16_t)(((uint16_t)data_cu8p[PVVX_TEMP_ADR + 1U] << 8U) 
+                                    | data_cu8p[PVVX_TEMP_ADR]);
+            temp_s16 /= 10;
+            hum_u16 = (uint16_t)(((uint16_t)data_cu8p[PVVX_HUM_ADR + 1U] << 8U) 
+                                    | data_cu8p[PVVX_HUM_ADR]) / 10U;
+            batt_u8 = data_cu8p[PVVX_BATT_ADR];
+        }
+
+        out_stap[0].dataType_u8 = mija_TYPE_TEMPHUM;
+        out_stap[0].value1_u16 = (uint16_t)temp_s16;
+        out_stap[0].value2_u16 = hum_u16;
+
+        memcpy(&out_stap[1], &out_stap[0], sizeof(mijaProcl_rawSample_t));
+        out_stap[1].dataType_u8 = mija_TYPE_BATTERY;
+        out_stap[1].value1_u16 = batt_u8;
+        out_stap[1].value2_u16 = 0U;
+        samples_u8 = SAMPLES_PER_FRAME;
+    }
+
+    return(samples_u8);
+}
+
+/***************************************************************************************/
+/* Local functions: */
+
+/**--------------------------------------------------------------------------------------
+ * @brief     identifies the firmware by the length of the service data and reads the
+ *              sender address in display order and the frame counter
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     data_cu8p     service data behind the uuid
+ * @param     dataLen_u8    length of the service data
+ * @param     mac_u8p       destination of the mac address (mija_SIZE_MAC_ADDR bytes)
+ * @param     msgCnt_u8p    destination of the frame counter
+ * @return    true in case of an ATC1441 or pvvx frame, else false
+*//*-----------------------------------------------------------------------------------*/
+static bool ReadFrameId_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8, 
+                                uint8_t *mac_u8p, uint8_t *msgCnt_u8p)
+{
+    bool exeResult_bol = true;
+
+    if(ATC_FRAME_LEN == dataLen_u8)
+    {
+        memcpy(mac_u8p, &data_cu8p[MAC_ADR], mija_SIZE_MAC_ADDR);
+        *msgCnt_u8p = data_cu8p[ATC_CNT_ADR];
+    }
+    else if(PVVX_FRAME_LEN == dataLen_u8)
+    {
+        for(uint8_t macIdx_u8 = 0U; macIdx_u8 < mija_SIZE_MAC_ADDR; macIdx_u8++)
+        {
+            mac_u8p[macIdx_u8] = data_cu8p[MAC_ADR + mija_SIZE_MAC_ADDR - 1U - macIdx_u8];
+        }
+        *msgCnt_u8p = data_cu8p[PVVX_CNT_ADR];
+    }
+    else
+    {
+        exeResult_bol = false;
+    }
+
+    return(exeResult_bol);
+}
@@ -54,12 +54,22 @@
 #include "esp_gap_ble_api.h"
 
 #include "mijaProcl.h"
+#include "latStat.h"
 
 /***************************************************************************************/
 /* Local constant defines */
 #define MAX_SCAN_DURATION   70U
 #define MIN_CYCLE_TIME      4U
 
+#define SCHED_TICK_MS       1000U       // period of the scan scheduler
+#define DISCOVERY_MS        600000U     // period of the full discovery scan
+#define ARRIVAL_GUARD_MS    2000U       // scan opened before a predicted arrival
+#define PERIOD_WEIGHT       4U          // weight of the learned period against a new one
+#define REPEAT_GAP_MS       1000U       // frames without counter closer than this repeat
+
+#define AD_HEADER_LEN       2U          // length and AD type
+#define AD_ID_LEN           2U          // 16 bit uuid or company id
+
 /***************************************************************************************/
 /* Local function like makros */
 static bool ParamSetValid_bol(bleDrv_param_t *param_stp);
@@ -67,6 +77,20 @@ static void InitializeBleDriver_vd(void);
 static void esp_GapCallBack_st(esp_gap_ble_cb_event_t event_en, 
                                     esp_ble_gap_cb_param_t *param_unp);
 static void TimerCallback_vd(TimerHandle_t xTimer_xp);
+static uint8_t DecodeAdvertisement_u8(const uint8_t *adv_cu8p, uint8_t advLen_u8,
+                                    const uint8_t *bda_cu8p, 
+                                    mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8);
+static bool IsNewFrame_bol(const uint8_t *mac_cu8p, uint8_t msgCnt_u8);
+static uint8_t FindFilterEntry_u8(const uint8_t *mac_cu8p);
+static uint8_t AllocFilterEntry_u8(const uint8_t *mac_cu8p);
+static void LearnArrival_vd(uint8_t entry_u8);
+static void LearnUncountedFrame_vd(const uint8_t *mac_cu8p);
+static void ScheduleScan_vd(void);
+static bool AllExpectedHeard_bol(void);
+static void StartScan_vd(uint32_t duration_u32, bool discovery_bol);
+static void ScanFinished_vd(void);
+static void SyncWhitelist_vd(void);
+static uint32_t GetTimeMs_u32(void);
 
 /***************************************************************************************/
 /* Local type definitions (enum, struct, union) */
@@ -77,14 +101,40 @@ typedef enum objectState_tag
     STATE_INITIALIZE_STARTED,
     STATE_READY_FOR_SCAN,
     STATE_SCAN_ACTIVE,
+    STATE_PARAM_UPDATE,
 }objectState_t;
 
+typedef struct filterEntry_tag
+{
+    uint8_t macAddr_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t lastCnt_u8;
+    bool cntValid_bol;              // lastCnt_u8 holds the counter of a received frame
+    bool used_bol;
+    bool known_bol;                 // expected sender, not replaced by unknown senders
+    bool heard_bol;                 // new frame received during the current scan
+    bool expected_bol;              // arrival predicted within the current scan
+    bool whitelisted_bol;           // address is loaded to the controller whitelist
+    uint32_t lastSeenMs_u32;        // time of the last new frame
+    bleDrv_frameStats_t stats_st;
+}filterEntry_t;
+
 typedef struct objectData_tag
 {
      objectState_t state_en;
      bleDrv_param_t param_st;
      TimerHandle_t timer_xp;
      bool scanEnabled_bol;
+     filterEntry_t filter_sta[bleDrv_FRAME_FILTER_SIZE];
+     uint8_t filterNext_u8;         // next entry to be replaced by an unknown sender
+     uint32_t nextScanMs_u32;       // earliest start of the next scan
+     uint32_t lastDiscoveryMs_u32;  // start of the last full scan
+     uint32_t scanStartMs_u32;
+     bool discovery_bol;            // current scan is a full scan
+     bool discoveryDone_bol;        // at least one full scan was done
+     uint32_t pendingScanSec_u32;   // scan started after the scan parameter update
+     bleDrv_scanStats_t scanStats_st;
+     const bleDrv_decoder_t *decoders_cstpa[bleDrv_MAX_DECODERS];
+     uint8_t decoders_u8;
 }objectData_t;
 /***************************************************************************************/
 /* Local functions prototypes: */
@@ -98,6 +148,10 @@ static objectData_t singleton_sst =
         .scanEnabled_bol = false,
 };
 
+// protects the filter table, used by the bluetooth task, the timer daemon and the
+// tasks of the device modules
+static portMUX_TYPE filterMux_sst = portMUX_INITIALIZER_UNLOCKED;
+
 // scan parameters
 static esp_ble_scan_params_t bleScanParams_sst = 
 {
@@ -105,7 +159,8 @@ static esp_ble_scan_params_t bleScanParams_sst =
     .own_addr_type          = BLE_ADDR_TYPE_PUBLIC,
     .scan_filter_policy     = BLE_SCAN_FILTER_ALLOW_ALL,
     .scan_interval          = 0x50,
-    .scan_window            = 0x30
+    .scan_window            = 0x30,
+    .scan_duplicate         = BLE_SCAN_DUPLICATE_DISABLE
 };
 
 /***************************************************************************************/
@@ -146,7 +201,7 @@ esp_err_t bleDrv_Initialize_st(bleDrv_param_t *param_stp)
             memset(&singleton_sst.param_st, 0U, sizeof(singleton_sst.param_st));
             memcpy(&singleton_sst.param_st, param_stp, sizeof(singleton_sst.param_st));
             InitializeBleDriver_vd();
-            ticks_u32 = pdMS_TO_TICKS(singleton_sst.param_st.cycleTimeInSec_u32 * 1000U);
+            ticks_u32 = pdMS_TO_TICKS(SCHED_TICK_MS);
             singleton_sst.timer_xp = xTimerCreate("Timer", ticks_u32, true, (void *) 0, 
                                                     TimerCallback_vd);
             singleton_sst.scanEnabled_bol = false;
@@ -195,6 +250,108 @@ esp_err_t bleDrv_Deactivate_st(void)
 
 }
 
+/**--------------------------------------------------------------------------------------
+ * @brief     registers an advertisement decoder
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t bleDrv_RegisterDecoder_st(const bleDrv_decoder_t *decoder_cstp)
+{
+    esp_err_t exeResult_st = ESP_FAIL;
+
+    if(   (NULL != decoder_cstp) && (NULL != decoder_cstp->decode_fp)
+       && (bleDrv_MAX_DECODERS > singleton_sst.decoders_u8))
+    {
+        singleton_sst.decoders_cstpa[singleton_sst.decoders_u8] = decoder_cstp;
+        singleton_sst.decoders_u8++;
+        exeResult_st = ESP_OK;
+    }
+
+    return(exeResult_st);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     marks a sender as known or unknown
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t bleDrv_SetKnownDevice_st(const uint8_t *mac_cu8p, bool known_bol)
+{
+    esp_err_t exeResult_st = ESP_FAIL;
+    uint8_t entry_u8;
+
+    if(NULL != mac_cu8p)
+    {
+        portENTER_CRITICAL(&filterMux_sst);
+        entry_u8 = FindFilterEntry_u8(mac_cu8p);
+        if((bleDrv_FRAME_FILTER_SIZE <= entry_u8) && (true == known_bol))
+        {
+            entry_u8 = AllocFilterEntry_u8(mac_cu8p);
+        }
+
+        if(bleDrv_FRAME_FILTER_SIZE > entry_u8)
+        {
+            singleton_sst.filter_sta[entry_u8].known_bol = known_bol;
+            exeResult_st = ESP_OK;
+        }
+        else
+        {
+            // an unknown sender without entry does not need to be removed
+            exeResult_st = (false == known_bol) ? ESP_OK : ESP_FAIL;
+        }
+        portEXIT_CRITICAL(&filterMux_sst);
+    }
+
+    return(exeResult_st);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     enables or disables the known senders only mode
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t bleDrv_SetKnownOnly_st(bool knownOnly_bol)
+{
+    // applied with the start of the next scan
+    singleton_sst.param_st.knownOnly_bol = knownOnly_bol;
+
+    return(ESP_OK);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     get the counters of the scan scheduler
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t bleDrv_GetScanStats_st(bleDrv_scanStats_t *stats_stp)
+{
+    esp_err_t exeResult_st = ESP_FAIL;
+
+    if(NULL != stats_stp)
+    {
+        memcpy(stats_stp, &singleton_sst.scanStats_st, sizeof(bleDrv_scanStats_t));
+        exeResult_st = ESP_OK;
+    }
+
+    return(exeResult_st);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     get the repeated frame filter counters of a sender
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t bleDrv_GetFrameStats_st(const uint8_t *mac_cu8p, bleDrv_frameStats_t *stats_stp)
+{
+    esp_err_t exeResult_st = ESP_FAIL;
+    uint8_t entry_u8;
+
+    if((NULL != mac_cu8p) && (NULL != stats_stp))
+    {
+        portENTER_CRITICAL(&filterMux_sst);
+        entry_u8 = FindFilterEntry_u8(mac_cu8p);
+        if(bleDrv_FRAME_FILTER_SIZE > entry_u8)
+        {
+            memcpy(stats_stp, &singleton_sst.filter_sta[entry_u8].stats_st, 
+                    sizeof(bleDrv_frameStats_t));
+            exeResult_st = ESP_OK;
+        }
+        portEXIT_CRITICAL(&filterMux_sst);
+    }
+
+    return(exeResult_st);
+}
+
 /***************************************************************************************/
 /* Local functions: */
 
@@ -230,7 +387,11 @@ static bool ParamSetValid_bol(bleDrv_param_t *param_stp)
 static void esp_GapCallBack_st(esp_gap_ble_cb_event_t event_en, 
                                     esp_ble_gap_cb_param_t *param_unp)
 {
-    mijaProcl_parsedData_t outData_st;
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t advLen_u8;
+    uint32_t rxUs_u32;
+    uint32_t parsedUs_u32;
+    uint8_t samples_u8;
 
     switch (event_en) 
     {		
@@ -238,12 +399,24 @@ static void esp_GapCallBack_st(esp_gap_ble_cb_event_t event_en,
 			if(param_unp->scan_param_cmpl.status == ESP_BT_STATUS_SUCCESS) 
             {
                 singleton_sst.state_en = STATE_READY_FOR_SCAN;
-                //TODO callback initialize is complete				
+                if(0U != singleton_sst.pendingScanSec_u32)
+                {
+                    // scan parameters were changed for the filter mode of this scan
+                    singleton_sst.state_en = STATE_SCAN_ACTIVE;
+                    singleton_sst.scanStartMs_u32 = GetTimeMs_u32();
+                    esp_ble_gap_start_scanning(singleton_sst.pendingScanSec_u32);
+                    singleton_sst.pendingScanSec_u32 = 0U;
+                }
 			}
 			else 
             {
                 printf("Unable to set scan parameters, error code %d\n\n", 
                                                 param_unp->scan_param_cmpl.status);
+                singleton_sst.pendingScanSec_u32 = 0U;
+                if(STATE_PARAM_UPDATE == singleton_sst.state_en)
+                {
+                    singleton_sst.state_en = STATE_READY_FOR_SCAN;
+                }
             }
 			break;		
 		case ESP_GAP_BLE_SCAN_START_COMPLETE_EVT:			
@@ -256,22 +429,62 @@ static void esp_GapCallBack_st(esp_gap_ble_cb_event_t event_en,
             { 
                 printf("Unable to start scan process, error code %d\n\n", 
                                                 param_unp->scan_start_cmpl.status);
+                singleton_sst.state_en = STATE_READY_FOR_SCAN;
             }
 			break;		
 		case ESP_GAP_BLE_SCAN_RESULT_EVT:
 			if(param_unp->scan_rst.search_evt == ESP_GAP_SEARCH_INQ_RES_EVT) 
 			{
-                if(true == mijaProcl_ParseMessage_bol(&param_unp->scan_rst.ble_adv[0], &outData_st))
+                rxUs_u32 = latStat_Now_u32();
+                if(BLE_SCAN_FILTER_ALLOW_ONLY_WLST == bleScanParams_sst.scan_filter_policy)
                 {
-                    singleton_sst.param_st.dataCb_fp(&outData_st);
+                    singleton_sst.scanStats_st.filteredCb_u32++;
+                }
+                else
+                {
+                    singleton_sst.scanStats_st.callbacks_u32++;
+                }
+                // the scan response is stored behind the advertising data
+                advLen_u8 =   param_unp->scan_rst.adv_data_len 
+                            + param_unp->scan_rst.scan_rsp_len;
+                samples_u8 = DecodeAdvertisement_u8(&param_unp->scan_rst.ble_adv[0], advLen_u8,
+                                                &param_unp->scan_rst.bda[0],
+                                                &sample_sta[0], mija_MAX_OBJECTS);
+                if(0U < samples_u8)
+                {
+                    parsedUs_u32 = latStat_Now_u32();
+                    for(uint8_t idx_u8 = 0U; idx_u8 < samples_u8; idx_u8++)
+                    {
+                        sample_sta[idx_u8].rxUs_u32 = rxUs_u32;
+                        sample_sta[idx_u8].parsedUs_u32 = parsedUs_u32;
+                        singleton_sst.param_st.dataCb_fp(&sample_sta[idx_u8]);
+                    }
+
+                    // a scan around predicted arrivals ends when all were heard
+                    if(   (false == singleton_sst.discovery_bol)
+                       && (STATE_SCAN_ACTIVE == singleton_sst.state_en)
+                       && (true == AllExpectedHeard_bol()))
+                    {
+                        singleton_sst.scanStats_st.earlyStop_u32++;
+                        esp_ble_gap_stop_scanning();
+                    }
                 }
 			}
 			else if(param_unp->scan_rst.search_evt == ESP_GAP_SEARCH_INQ_CMPL_EVT)
 			{
-                singleton_sst.state_en = STATE_READY_FOR_SCAN;
-				//TODO scan complete callback
+                ScanFinished_vd();
 			}
 			break;		
+		case ESP_GAP_BLE_SCAN_STOP_COMPLETE_EVT:
+            ScanFinished_vd();
+			break;		
+		case ESP_GAP_BLE_UPDATE_WHITELIST_COMPLETE_EVT:
+			if(param_unp->update_whitelist_cmpl.status != ESP_BT_STATUS_SUCCESS) 
+            {
+                printf("Unable to update the whitelist, error code %d\n\n", 
+                                                param_unp->update_whitelist_cmpl.status);
+            }
+			break;		
 		default:		
 			printf("Event %d unhandled\n\n", event_en);
 			break;
@@ -321,9 +534,523 @@ static void TimerCallback_vd(TimerHandle_t xTimer_xp)
 {
     if(STATE_READY_FOR_SCAN == singleton_sst.state_en)
     {
-        if(true == singleton_sst.scanEnabled_bol)
+        if(   (true == singleton_sst.scanEnabled_bol)
+           && ((int32_t)(GetTimeMs_u32() - singleton_sst.nextScanMs_u32) >= 0))
         {
-            esp_ble_gap_start_scanning(singleton_sst.param_st.scanDurationInSec_u32);
+            ScheduleScan_vd();
         }
     }   
 }
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Walks the AD structures of an advertisement once and hands the first 
+ *              structure with the type and id of a registered decoder to the decoder.
+ *              The AD structure has to fit completely into the advertisement.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     adv_cu8p      advertisement data
+ * @param     advLen_u8     length of the advertisement data
+ * @param     bda_cu8p      advertiser address
+ * @param     out_stap      array of raw samples
+ * @param     maxOut_u8     number of elements of the sample array
+ * @return    number of samples, 0 if no decoder matched or the frame is repeated
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t DecodeAdvertisement_u8(const uint8_t *adv_cu8p, uint8_t advLen_u8,
+                                    const uint8_t *bda_cu8p, 
+                                    mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8)
+{
+    uint8_t samples_u8 = 0U;
+    const bleDrv_decoder_t *decoder_cstp = NULL;
+    uint16_t pos_u16 = 0U;
+    uint8_t adLen_u8;
+    uint8_t adType_u8;
+    uint16_t id_u16;
+    const uint8_t *data_cu8p;
+    uint8_t dataLen_u8;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+    bool counted_bol;
+
+    while((NULL == decoder_cstp) && ((pos_u16 + AD_HEADER_LEN) <= advLen_u8))
+    {
+        adLen_u8 = adv_cu8p[pos_u16];
+        adType_u8 = adv_cu8p[pos_u16 + 1U];
+        if((0U == adLen_u8) || ((pos_u16 + 1U + adLen_u8) > advLen_u8))
+        {
+            // end of the significant part or a malformed structure
+            pos_u16 = advLen_u8;
+        }
+        else
+        {
+            if(   (   (bleDrv_AD_SERVICE_DATA == adType_u8) 
+                   || (bleDrv_AD_MANUFACTURER == adType_u8))
+               && ((1U + AD_ID_LEN) <= adLen_u8))
+            {
+                // the uuid and the company id are little endian
+                id_u16 = (uint16_t)adv_cu8p[pos_u16 + AD_HEADER_LEN]
+                            | ((uint16_t)adv_cu8p[pos_u16 + AD_HEADER_LEN + 1U] << 8U);
+                for(uint8_t idx_u8 = 0U; idx_u8 < singleton_sst.decoders_u8; idx_u8++)
+                {
+                    if(   (adType_u8 == singleton_sst.decoders_cstpa[idx_u8]->adType_u8)
+                       && (id_u16 == singleton_sst.decoders_cstpa[idx_u8]->id_u16))
+                    {
+                        decoder_cstp = singleton_sst.decoders_cstpa[idx_u8];
+                        data_cu8p = &adv_cu8p[pos_u16 + AD_HEADER_LEN + AD_ID_LEN];
+                        dataLen_u8 = adLen_u8 - 1U - AD_ID_LEN;
+                    }
+                }
+            }
+            pos_u16 += 1U + adLen_u8;
+        }
+    }
+
+    if(NULL != decoder_cstp)
+    {
+        // repeated frames are dropped before the possibly expensive decoding
+        counted_bol =    (NULL != decoder_cstp->frameId_fp)
+                      && (true == decoder_cstp->frameId_fp(data_cu8p, dataLen_u8, bda_cu8p,
+                                                            &mac_u8a[0], &msgCnt_u8));
+        if((false == counted_bol) || (true == IsNewFrame_bol(&mac_u8a[0], msgCnt_u8)))
+        {
+            samples_u8 = decoder_cstp->decode_fp(data_cu8p, dataLen_u8, bda_cu8p,
+                                                    out_stap, maxOut_u8);
+            if((false == counted_bol) && (0U < samples_u8))
+            {
+                LearnUncountedFrame_vd(out_stap[0].macAddr_u8a);
+            }
+        }
+    }
+
+    return(samples_u8);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Checks the sender address and message counter of a frame against the
+ *              last frame of the sender. Sensors repeat every frame several times, only
+ *              the first reception is forwarded to the decoder.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the sender
+ * @param     msgCnt_u8     message counter of the frame
+ * @return    true if the frame has to be decoded, else false
+*//*-----------------------------------------------------------------------------------*/
+static bool IsNewFrame_bol(const uint8_t *mac_cu8p, uint8_t msgCnt_u8)
+{
+    bool newFrame_bol = true;
+    uint8_t entry_u8;
+    filterEntry_t *entry_stp;
+
+    portENTER_CRITICAL(&filterMux_sst);
+    entry_u8 = FindFilterEntry_u8(mac_cu8p);
+
+    if(bleDrv_FRAME_FILTER_SIZE > entry_u8)
+    {
+        entry_stp = &singleton_sst.filter_sta[entry_u8];
+        if(false == entry_stp->cntValid_bol)
+        {
+            // first frame of a sender which was registered before it was heard
+        }
+        else if(msgCnt_u8 == entry_stp->lastCnt_u8)
+        {
+            entry_stp->stats_st.duplicates_u32++;
+            newFrame_bol = false;
+        }
+        else
+        {
+            // the counter is 8 bit wide and wraps around
+            entry_stp->stats_st.missed_u32 += 
+                                    (uint8_t)(msgCnt_u8 - entry_stp->lastCnt_u8 - 1U);
+        }
+    }
+    else
+    {
+        entry_u8 = AllocFilterEntry_u8(mac_cu8p);
+    }
+
+    if((true == newFrame_bol) && (bleDrv_FRAME_FILTER_SIZE > entry_u8))
+    {
+        entry_stp = &singleton_sst.filter_sta[entry_u8];
+        entry_stp->lastCnt_u8 = msgCnt_u8;
+        entry_stp->cntValid_bol = true;
+        entry_stp->stats_st.frames_u32++;
+        LearnArrival_vd(entry_u8);
+    }
+    portEXIT_CRITICAL(&filterMux_sst);
+
+    return(newFrame_bol);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Searches the repeated frame filter entry of a sender, must be called with
+ *              the filter lock taken
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the sender
+ * @return    index of the entry, bleDrv_FRAME_FILTER_SIZE if the sender is unknown
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t FindFilterEntry_u8(const uint8_t *mac_cu8p)
+{
+    uint8_t entry_u8 = 0U;
+
+    while(   (bleDrv_FRAME_FILTER_SIZE > entry_u8)
+          && (   (false == singleton_sst.filter_sta[entry_u8].used_bol)
+              || (0 != memcmp(singleton_sst.filter_sta[entry_u8].macAddr_u8a, mac_cu8p,
+                                mija_SIZE_MAC_ADDR))))
+    {
+        entry_u8++;
+    }
+
+    return(entry_u8);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Allocates the filter entry of a new sender, unknown senders are replaced
+ *              round robin, entries of known senders are kept. An entry which is still
+ *              on the controller whitelist is kept as well until SyncWhitelist_vd
+ *              removed its address. Must be called with the filter lock taken.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the sender
+ * @return    index of the entry, bleDrv_FRAME_FILTER_SIZE if all entries are known
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t AllocFilterEntry_u8(const uint8_t *mac_cu8p)
+{
+    uint8_t entry_u8 = bleDrv_FRAME_FILTER_SIZE;
+    uint8_t tries_u8 = 0U;
+    filterEntry_t *entry_stp;
+
+    while((bleDrv_FRAME_FILTER_SIZE == entry_u8) && (bleDrv_FRAME_FILTER_SIZE > tries_u8))
+    {
+        entry_stp = &singleton_sst.filter_sta[singleton_sst.filterNext_u8];
+        if((false == entry_stp->known_bol) && (false == entry_stp->whitelisted_bol))
+        {
+            entry_u8 = singleton_sst.filterNext_u8;
+        }
+        singleton_sst.filterNext_u8 = (singleton_sst.filterNext_u8 + 1U) 
+                                            % bleDrv_FRAME_FILTER_SIZE;
+        tries_u8++;
+    }
+
+    if(bleDrv_FRAME_FILTER_SIZE > entry_u8)
+    {
+        entry_stp = &singleton_sst.filter_sta[entry_u8];
+        memset(entry_stp, 0U, sizeof(filterEntry_t));
+        memcpy(entry_stp->macAddr_u8a, mac_cu8p, sizeof(entry_stp->macAddr_u8a));
+        entry_stp->used_bol = true;
+    }
+
+    return(entry_u8);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Updates the learned period of a sender with the arrival of a new frame.
+ *              Arrivals after missed frames are reduced to a single period.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     entry_u8      index of the filter entry
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void LearnArrival_vd(uint8_t entry_u8)
+{
+    filterEntry_t *entry_stp = &singleton_sst.filter_sta[entry_u8];
+    uint32_t now_u32 = GetTimeMs_u32();
+    uint32_t delta_u32 = now_u32 - entry_stp->lastSeenMs_u32;
+    uint32_t period_u32 = entry_stp->stats_st.periodMs_u32;
+    uint32_t steps_u32;
+
+    if(0U != entry_stp->lastSeenMs_u32)
+    {
+        if(0U == period_u32)
+        {
+            period_u32 = delta_u32;
+        }
+        else
+        {
+            steps_u32 = (delta_u32 + (period_u32 / 2U)) / period_u32;
+            steps_u32 = (0U == steps_u32) ? 1U : steps_u32;
+            period_u32 = ((period_u32 * (PERIOD_WEIGHT - 1U)) + (delta_u32 / steps_u32))
+                            / PERIOD_WEIGHT;
+        }
+        entry_stp->stats_st.periodMs_u32 = period_u32;
+    }
+    entry_stp->lastSeenMs_u32 = (0U == now_u32) ? 1U : now_u32;
+    entry_stp->heard_bol = true;
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Updates the filter entry of a sender whose frames have no message counter,
+ *              e.g. BTHome without packet id. Such frames are not filtered, but the
+ *              sender is marked as heard and the first frame of a burst of repetitions
+ *              is used to learn the period.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the decoded sender
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void LearnUncountedFrame_vd(const uint8_t *mac_cu8p)
+{
+    uint8_t entry_u8;
+    filterEntry_t *entry_stp;
+
+    portENTER_CRITICAL(&filterMux_sst);
+    entry_u8 = FindFilterEntry_u8(mac_cu8p);
+    if(bleDrv_FRAME_FILTER_SIZE <= entry_u8)
+    {
+        entry_u8 = AllocFilterEntry_u8(mac_cu8p);
+    }
+
+    if(bleDrv_FRAME_FILTER_SIZE > entry_u8)
+    {
+        entry_stp = &singleton_sst.filter_sta[entry_u8];
+        if(   (0U == entry_stp->lastSeenMs_u32)
+           || (REPEAT_GAP_MS <= (GetTimeMs_u32() - entry_stp->lastSeenMs_u32)))
+        {
+            entry_stp->stats_st.frames_u32++;
+            LearnArrival_vd(entry_u8);
+        }
+        else
+        {
+            entry_stp->heard_bol = true;
+        }
+    }
+    portEXIT_CRITICAL(&filterMux_sst);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Decides about the next scan. A full scan is done periodically and as long
+ *              as a known sender has no learned period. Otherwise the radio stays off
+ *              until shortly before the next predicted arrival and the scan covers the
+ *              arrivals which are predicted within the scan duration.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void ScheduleScan_vd(void)
+{
+    uint32_t now_u32 = GetTimeMs_u32();
+    uint32_t scanMs_u32 = singleton_sst.param_st.scanDurationInSec_u32 * 1000U;
+    bool discovery_bol = (false == singleton_sst.discoveryDone_bol)
+                        || ((now_u32 - singleton_sst.lastDiscoveryMs_u32) >= DISCOVERY_MS);
+    int32_t earliest_s32 = INT32_MAX;
+    int32_t latest_s32 = INT32_MIN;
+    int32_t next_s32a[bleDrv_FRAME_FILTER_SIZE];
+    int32_t next_s32;
+    uint32_t elapsed_u32;
+    uint32_t steps_u32;
+    uint32_t period_u32;
+    uint8_t known_u8 = 0U;
+    filterEntry_t *entry_stp;
+
+    // the whitelist must not be changed while a filtered scan is running
+    SyncWhitelist_vd();
+
+    portENTER_CRITICAL(&filterMux_sst);
+    for(uint8_t entry_u8 = 0U; entry_u8 < bleDrv_FRAME_FILTER_SIZE; entry_u8++)
+    {
+        entry_stp = &singleton_sst.filter_sta[entry_u8];
+        next_s32a[entry_u8] = INT32_MAX;
+        if(true == entry_stp->known_bol)
+        {
+            known_u8++;
+            if(0U == entry_stp->stats_st.periodMs_u32)
+            {
+                discovery_bol = true;
+            }
+            else
+            {
+                // first predicted arrival which is not older than the guard time
+                period_u32 = entry_stp->stats_st.periodMs_u32;
+                elapsed_u32 = now_u32 - entry_stp->lastSeenMs_u32;
+                steps_u32 = (elapsed_u32 > ARRIVAL_GUARD_MS) ? 
+                        ((elapsed_u32 - ARRIVAL_GUARD_MS + period_u32 - 1U) / period_u32) : 1U;
+                steps_u32 = (0U == steps_u32) ? 1U : steps_u32;
+                next_s32 = (int32_t)((steps_u32 * period_u32) - elapsed_u32);
+                next_s32a[entry_u8] = next_s32;
+                earliest_s32 = (next_s32 < earliest_s32) ? next_s32 : earliest_s32;
+            }
+        }
+    }
+
+    // senders due later than the scan duration are left to a later scan, otherwise
+    // the early stop waits for them and every scan runs for the full duration
+    for(uint8_t entry_u8 = 0U; entry_u8 < bleDrv_FRAME_FILTER_SIZE; entry_u8++)
+    {
+        next_s32 = next_s32a[entry_u8];
+        singleton_sst.filter_sta[entry_u8].expected_bol = (INT32_MAX != next_s32)
+            && (   (next_s32 == earliest_s32)
+                || ((next_s32 + (int32_t)ARRIVAL_GUARD_MS) <= (int32_t)scanMs_u32));
+        if(true == singleton_sst.filter_sta[entry_u8].expected_bol)
+        {
+            latest_s32 = (next_s32 > latest_s32) ? next_s32 : latest_s32;
+        }
+    }
+    portEXIT_CRITICAL(&filterMux_sst);
+
+    if((true == discovery_bol) || (0U == known_u8))
+    {
+        singleton_sst.lastDiscoveryMs_u32 = now_u32;
+        singleton_sst.discoveryDone_bol = true;
+        singleton_sst.nextScanMs_u32 = now_u32 
+                                    + (singleton_sst.param_st.cycleTimeInSec_u32 * 1000U);
+        StartScan_vd(scanMs_u32, true);
+    }
+    else if(earliest_s32 > (int32_t)ARRIVAL_GUARD_MS)
+    {
+        // radio stays off until shortly before the first predicted arrival
+        singleton_sst.nextScanMs_u32 = now_u32 + (uint32_t)earliest_s32 - ARRIVAL_GUARD_MS;
+    }
+    else
+    {
+        // the scan covers the predicted arrivals of the expected senders
+        latest_s32 += (int32_t)ARRIVAL_GUARD_MS;
+        scanMs_u32 = ((uint32_t)latest_s32 < scanMs_u32) ? (uint32_t)latest_s32 : scanMs_u32;
+        singleton_sst.nextScanMs_u32 = now_u32;
+        StartScan_vd(scanMs_u32, false);
+    }
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Checks if every sender expected in the current scan sent a new frame
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    true if all expected senders were heard
+*//*-----------------------------------------------------------------------------------*/
+static bool AllExpectedHeard_bol(void)
+{
+    bool allHeard_bol = true;
+
+    portENTER_CRITICAL(&filterMux_sst);
+    for(uint8_t entry_u8 = 0U; entry_u8 < bleDrv_FRAME_FILTER_SIZE; entry_u8++)
+    {
+        if(   (true == singleton_sst.filter_sta[entry_u8].expected_bol)
+           && (false == singleton_sst.filter_sta[entry_u8].heard_bol))
+        {
+            allHeard_bol = false;
+        }
+    }
+    portEXIT_CRITICAL(&filterMux_sst);
+
+    return(allHeard_bol);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Starts a scan
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     duration_u32      scan duration in milliseconds, rounded up to seconds
+ * @param     discovery_bol     true for a full scan without early stop
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void StartScan_vd(uint32_t duration_u32, bool discovery_bol)
+{
+    esp_ble_scan_filter_t filter_en = BLE_SCAN_FILTER_ALLOW_ALL;
+
+    portENTER_CRITICAL(&filterMux_sst);
+    for(uint8_t entry_u8 = 0U; entry_u8 < bleDrv_FRAME_FILTER_SIZE; entry_u8++)
+    {
+        singleton_sst.filter_sta[entry_u8].heard_bol = false;
+    }
+    portEXIT_CRITICAL(&filterMux_sst);
+
+    singleton_sst.discovery_bol = discovery_bol;
+    singleton_sst.scanStartMs_u32 = GetTimeMs_u32();
+    singleton_sst.scanStats_st.scans_u32++;
+    if(true == discovery_bol)
+    {
+        singleton_sst.scanStats_st.discovery_u32++;
+    }
+    // a duration of 0 would scan without end
+    duration_u32 = (1000U > duration_u32) ? 1000U : duration_u32;
+
+    if((true == singleton_sst.param_st.knownOnly_bol) && (false == discovery_bol))
+    {
+        filter_en = BLE_SCAN_FILTER_ALLOW_ONLY_WLST;
+    }
+
+    if(filter_en != bleScanParams_sst.scan_filter_policy)
+    {
+        // the controller drops repeated advertisements of whitelisted senders, the
+        // sdkconfig filters by advertisement data, so a new message counter passes
+        bleScanParams_sst.scan_filter_policy = filter_en;
+        bleScanParams_sst.scan_duplicate = (BLE_SCAN_FILTER_ALLOW_ALL == filter_en) ?
+                                    BLE_SCAN_DUPLICATE_DISABLE : BLE_SCAN_DUPLICATE_ENABLE;
+        singleton_sst.pendingScanSec_u32 = (duration_u32 + 999U) / 1000U;
+        singleton_sst.state_en = STATE_PARAM_UPDATE;
+        esp_ble_gap_set_scan_params(&bleScanParams_sst);
+    }
+    else
+    {
+        singleton_sst.state_en = STATE_SCAN_ACTIVE;
+        esp_ble_gap_start_scanning((duration_u32 + 999U) / 1000U);
+    }
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Scan completed or stopped, the radio time is accounted
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void ScanFinished_vd(void)
+{
+    uint32_t scanMs_u32;
+
+    if(STATE_SCAN_ACTIVE == singleton_sst.state_en)
+    {
+        scanMs_u32 = GetTimeMs_u32() - singleton_sst.scanStartMs_u32;
+        singleton_sst.scanStats_st.radioOnMs_u32 += scanMs_u32;
+        if(BLE_SCAN_FILTER_ALLOW_ONLY_WLST == bleScanParams_sst.scan_filter_policy)
+        {
+            singleton_sst.scanStats_st.filteredMs_u32 += scanMs_u32;
+        }
+    }
+    singleton_sst.state_en = STATE_READY_FOR_SCAN;
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Loads the addresses of the known senders to the controller whitelist and
+ *              removes the addresses of senders which are not known anymore
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void SyncWhitelist_vd(void)
+{
+    filterEntry_t *entry_stp;
+    bool listed_bol;
+    bool update_bol;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    for(uint8_t entry_u8 = 0U; entry_u8 < bleDrv_FRAME_FILTER_SIZE; entry_u8++)
+    {
+        // the stack is called outside of the lock with a copy of the address
+        entry_stp = &singleton_sst.filter_sta[entry_u8];
+        portENTER_CRITICAL(&filterMux_sst);
+        listed_bol = (true == entry_stp->used_bol) && (true == entry_stp->known_bol);
+        update_bol = (listed_bol != entry_stp->whitelisted_bol);
+        memcpy(mac_u8a, entry_stp->macAddr_u8a, mija_SIZE_MAC_ADDR);
+        portEXIT_CRITICAL(&filterMux_sst);
+
+        if(   (true == update_bol)
+           && (ESP_OK == esp_ble_gap_update_whitelist(listed_bol, mac_u8a)))
+        {
+            portENTER_CRITICAL(&filterMux_sst);
+            if(0 == memcmp(mac_u8a, entry_stp->macAddr_u8a, mija_SIZE_MAC_ADDR))
+            {
+                entry_stp->whitelisted_bol = listed_bol;
+            }
+            portEXIT_CRITICAL(&filterMux_sst);
+        }
+    }
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Get the time since start in milliseconds
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    time in milliseconds
+*//*-----------------------------------------------------------------------------------*/
+static uint32_t GetTimeMs_u32(void)
+{
+    return((uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS));
+}
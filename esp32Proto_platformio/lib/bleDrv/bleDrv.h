@@ -50,6 +50,12 @@ extern "C"
 
 /****************************************************************************************/
 /* Global constant defines: */
+#define bleDrv_FRAME_FILTER_SIZE    16U     // senders tracked by the repeated frame filter
+#ifndef bleDrv_MAX_DECODERS
+    #define bleDrv_MAX_DECODERS     4U      // advertisement decoders
+#endif
+#define bleDrv_AD_SERVICE_DATA      0x16U   // AD type service data, 16 bit uuid
+#define bleDrv_AD_MANUFACTURER      0xFFU   // AD type manufacturer specific data
 
 /****************************************************************************************/
 /* Global function like macro defines (to be avoided): */
@@ -57,13 +63,57 @@ extern "C"
 /****************************************************************************************/
 /* Global type definitions (enum (en), struct (st), union (un), typedef (tx): */
 
-typedef void (* bleDrv_DataAvailable_td)(mijaProcl_parsedData_t *data_st);
+/* called in the context of the bluetooth stack, the callback must never block */
+typedef void (* bleDrv_DataAvailable_td)(const mijaProcl_rawSample_t *sample_cstp);
+
+/* reads sender address and frame counter of the data behind the uuid or company id,
+   returns false if the frame carries no counter, it is then decoded without filter */
+typedef bool (* bleDrv_FrameId_td)(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                    const uint8_t *bda_cu8p, uint8_t *mac_u8p, 
+                                    uint8_t *msgCnt_u8p);
+
+/* decodes the data behind the uuid or company id, returns the number of samples */
+typedef uint8_t (* bleDrv_Decode_td)(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                    const uint8_t *bda_cu8p, 
+                                    mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8);
+
+/* advertisement decoder, selected by AD type and uuid or company id */
+typedef struct bleDrv_decoder_tag
+{
+    const char *name_cp;
+    uint8_t adType_u8;          /*!< bleDrv_AD_SERVICE_DATA or bleDrv_AD_MANUFACTURER */
+    uint16_t id_u16;            /*!< 16 bit service uuid or company id */
+    bleDrv_FrameId_td frameId_fp;   /*!< optional, NULL if frames carry no counter */
+    bleDrv_Decode_td decode_fp;
+}bleDrv_decoder_t;
+
+/* counters of the scan scheduler */
+typedef struct bleDrv_scanStats_tag
+{
+    uint32_t scans_u32;         /*!< scans started */
+    uint32_t discovery_u32;     /*!< full scans for the discovery of new senders */
+    uint32_t earlyStop_u32;     /*!< scans stopped because all known senders were heard */
+    uint32_t radioOnMs_u32;     /*!< accumulated scan time in milliseconds */
+    uint32_t filteredMs_u32;    /*!< part of the scan time with the whitelist filter */
+    uint32_t callbacks_u32;     /*!< advertisement reports without whitelist filter */
+    uint32_t filteredCb_u32;    /*!< advertisement reports with the whitelist filter */
+}bleDrv_scanStats_t;
+
+/* counters of the repeated frame filter per sender */
+typedef struct bleDrv_frameStats_tag
+{
+    uint32_t frames_u32;        /*!< new frames forwarded to the data callback */
+    uint32_t duplicates_u32;    /*!< repeated frames with an already seen counter */
+    uint32_t missed_u32;        /*!< frames lost, derived from gaps in the counter */
+    uint32_t periodMs_u32;      /*!< learned period of new frames, 0 if not yet known */
+}bleDrv_frameStats_t;
 
 typedef struct bleDrv_param_tag
 {
     uint32_t scanDurationInSec_u32;
     uint32_t cycleTimeInSec_u32;
     bleDrv_DataAvailable_td dataCb_fp;
+    bool knownOnly_bol;         /*!< scan known senders only, except discovery scans */
 }bleDrv_param_t;
 
 /****************************************************************************************/
@@ -99,6 +149,63 @@ extern esp_err_t bleDrv_Activate_st(void);
 
 extern esp_err_t bleDrv_Deactivate_st(void);
 
+/**--------------------------------------------------------------------------------------
+ * @brief     registers an advertisement decoder. The AD structures of an advertisement
+ *              are walked once, the first structure with the type and id of a
+ *              registered decoder is handed to that decoder. Repeated frames are
+ *              dropped by the frame id before the frame is decoded. The decoders have
+ *              to be registered before the scan is activated.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     decoder_cstp          decoder, has to stay valid while the driver is used
+ * @return    ESP_OK in case of success, ESP_FAIL if all decoder slots are used
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t bleDrv_RegisterDecoder_st(const bleDrv_decoder_t *decoder_cstp);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     marks a sender as known or unknown. For known senders the period of new
+ *              frames is learned and the scans are placed around the predicted
+ *              arrivals, a scan is stopped as soon as every known sender was heard.
+ *              A full scan for new senders is done periodically.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p              mac address of the sender
+ * @param     known_bol             true if the sender is expected
+ * @return    ESP_OK in case of success, ESP_FAIL if no filter entry is available
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t bleDrv_SetKnownDevice_st(const uint8_t *mac_cu8p, bool known_bol);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     enables or disables the known senders only mode. The known senders are
+ *              loaded to the controller whitelist and the controller filters repeated
+ *              advertisements, the periodic discovery scans stay unfiltered.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     knownOnly_bol         true to scan known senders only
+ * @return    ESP_OK in case of success, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t bleDrv_SetKnownOnly_st(bool knownOnly_bol);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     get the counters of the scan scheduler
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stats_stp             destination of the counters
+ * @return    ESP_OK in case of success, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t bleDrv_GetScanStats_st(bleDrv_scanStats_t *stats_stp);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     get the repeated frame filter counters of a sender
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p              mac address of the sender
+ * @param     stats_stp             destination of the counters
+ * @return    ESP_OK if the sender is tracked by the filter, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t bleDrv_GetFrameStats_st(const uint8_t *mac_cu8p, 
+                                            bleDrv_frameStats_t *stats_stp);
+
 /****************************************************************************************/
 /* Global data definitions: */
 
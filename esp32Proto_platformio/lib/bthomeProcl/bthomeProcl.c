@@ -0,0 +1,294 @@
+/****************************************************************************************
+* FILENAME :        bthomeProcl.c
+*
+* SHORT DESCRIPTION:
+*   Source file for bthomeProcl module.  
+*
+* DETAILED DESCRIPTION :   
+* This module decodes advertisements in the BTHome v2 format. The data is the service
+* data with the uuid 0xfcd2, the service data is interpreted as follows:
+*   - device information: 0, bit 0: encrypted, bit 2: trigger based,
+*                           bit 5 - 7: version (2)
+*   - objects until the end of the service data, each with a one byte object id 
+*     followed by the data (little endian). The length of the data is defined by the
+*     object id, so an unknown object id ends the evaluation of the frame. Objects
+*     are sent in ascending order, the packet id (0x00) is always the first object.
+*     Decoded objects:
+                                PACKET ID               0x00, 1 byte
+                                BATTERY                 0x01, 1 byte, %
+                                TEMPERATURE             0x02, 2 bytes, signed, 0.01 °C
+                                HUMIDITY                0x03, 2 bytes, 0.01 %
+                                HUMIDITY                0x2E, 1 byte, %
+                                TEMPERATURE             0x45, 2 bytes, signed, 0.1 °C
+* The frame carries no sender address, the advertiser address is used instead. The
+* values are converted to the 0.1 units of the mija samples. Encrypted frames are not
+* supported and ignored.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17. Oct. 2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+****************************************************************************************/
+
+/***************************************************************************************/
+/* Include Interfaces */
+
+#include "bthomeProcl.h"
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stddef.h"
+#include "string.h"
+
+/***************************************************************************************/
+/* Local constant defines */
+
+#define DEVICE_INFO_ADR         0U
+#define OBJECTS_ADR             1U
+#define DEVICE_INFO_ENCRYPTED   0x01U
+#define DEVICE_INFO_VERSION     0xE0U
+#define VERSION_2               0x40U   // version 2 in the version bits
+
+#define OBJ_ID_PACKET_ID        0x00U
+#define OBJ_ID_BATTERY          0x01U
+#define OBJ_ID_TEMP_CENTI       0x02U
+#define OBJ_ID_HUM_CENTI        0x03U
+#define OBJ_ID_HUM_PERCENT      0x2EU
+#define OBJ_ID_TEMP_DECI        0x45U
+
+#define SAMPLE_TYPE_NONE        0U      // object is skipped
+
+/***************************************************************************************/
+/* Local function like makros */
+
+/***************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* descriptor of a known object, the value is converted to 0.1 units */
+typedef struct objectDesc_tag
+{
+    uint8_t objId_u8;
+    uint8_t dataLen_u8;
+    uint8_t sampleType_u8;          // mija data type, SAMPLE_TYPE_NONE if not decoded
+    bool signed_bol;
+    uint8_t mul_u8;                 // value = raw * mul / div
+    uint8_t div_u8;
+}objectDesc_t;
+
+/***************************************************************************************/
+/* Local functions prototypes: */
+static bool CheckFrameHeader_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8);
+static const objectDesc_t * FindObjectDesc_cstp(uint8_t objId_u8);
+
+/***************************************************************************************/
+/* Local variables: */
+
+/* objects of the v2 format sorted by id, the length is needed to skip an object */
+static const objectDesc_t objectDesc_scsa[] =
+{
+    {OBJ_ID_PACKET_ID,      1U, SAMPLE_TYPE_NONE,       false,  1U,     1U},
+    {OBJ_ID_BATTERY,        1U, mija_TYPE_BATTERY,      false,  1U,     1U},
+    {OBJ_ID_TEMP_CENTI,     2U, mija_TYPE_TEMPERATURE,  true,   1U,     10U},
+    {OBJ_ID_HUM_CENTI,      2U, mija_TYPE_HUMIDITY,     false,  1U,     10U},
+    {0x04U,                 3U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // pressure
+    {0x05U,                 3U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // illuminance
+    {0x06U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // mass kg
+    {0x07U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // mass lb
+    {0x08U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // dew point
+    {0x09U,                 1U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // count
+    {0x0AU,                 3U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // energy
+    {0x0BU,                 3U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // power
+    {0x0CU,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // voltage
+    {0x0DU,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // pm2.5
+    {0x0EU,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // pm10
+    {0x12U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // co2
+    {0x13U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // tvoc
+    {0x14U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // moisture
+    {OBJ_ID_HUM_PERCENT,    1U, mija_TYPE_HUMIDITY,     false,  10U,    1U},
+    {0x2FU,                 1U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // moisture
+    {0x3AU,                 1U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // button
+    {0x3CU,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // dimmer
+    {0x3DU,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // count
+    {0x3EU,                 4U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // count
+    {0x3FU,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // rotation
+    {0x40U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // distance mm
+    {0x41U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // distance m
+    {0x42U,                 3U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // duration
+    {0x43U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // current
+    {0x44U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // speed
+    {OBJ_ID_TEMP_DECI,      2U, mija_TYPE_TEMPERATURE,  true,   1U,     1U},
+    {0x46U,                 1U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // uv index
+    {0xF0U,                 2U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // device type
+    {0xF1U,                 4U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // firmware
+    {0xF2U,                 3U, SAMPLE_TYPE_NONE,       false,  1U,     1U},    // firmware
+};
+
+#define OBJECT_DESC_NUM     (sizeof(objectDesc_scsa) / sizeof(objectDesc_scsa[0]))
+
+#define BINARY_FIRST_ID     0x0FU   // binary sensors 0x0f - 0x11 and 0x15 - 0x2d, 1 byte
+#define BINARY_LAST_ID      0x2DU
+
+/***************************************************************************************/
+/* Global functions (unlimited visibility) */
+
+/**--------------------------------------------------------------------------------------
+ * @brief     reads the sender address and the packet id of the service data
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+bool bthomeProcl_GetFrameId_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                    const uint8_t *bda_cu8p, uint8_t *mac_u8p, 
+                                    uint8_t *msgCnt_u8p)
+{
+    bool exeResult_bol = false;
+
+    if(   (NULL != data_cu8p) && (NULL != bda_cu8p) && (NULL != mac_u8p) 
+       && (NULL != msgCnt_u8p)
+       && (true == CheckFrameHeader_bol(data_cu8p, dataLen_u8))
+       && ((OBJECTS_ADR + 2U) <= dataLen_u8)
+       && (OBJ_ID_PACKET_ID == data_cu8p[OBJECTS_ADR]))
+    {
+        memcpy(mac_u8p, bda_cu8p, mija_SIZE_MAC_ADDR);
+        *msgCnt_u8p = data_cu8p[OBJECTS_ADR + 1U];
+        exeResult_bol = true;
+    }
+
+    return(exeResult_bol);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     decodes the objects of the service data into raw samples
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+uint8_t bthomeProcl_Decode_u8(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                const uint8_t *bda_cu8p, 
+                                mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8)
+{
+    uint8_t samples_u8 = 0U;
+    uint8_t pos_u8 = OBJECTS_ADR;
+    uint8_t msgCnt_u8 = 0U;
+    const objectDesc_t *desc_cstp;
+    mijaProcl_rawSample_t *sample_stp;
+    int32_t value_s32;
+
+    if(   (NULL != data_cu8p) && (NULL != bda_cu8p) && (NULL != out_stap)
+       && (true == CheckFrameHeader_bol(data_cu8p, dataLen_u8)))
+    {
+        while((samples_u8 < maxOut_u8) && (pos_u8 < dataLen_u8))
+        {
+            desc_cstp = FindObjectDesc_cstp(data_cu8p[pos_u8]);
+            if(   (NULL == desc_cstp) 
+               || ((pos_u8 + 1U + desc_cstp->dataLen_u8) > dataLen_u8))
+            {
+                // unknown length or truncated object, ignore the rest of the frame
+                pos_u8 = dataLen_u8;
+            }
+            else
+            {
+                if(OBJ_ID_PACKET_ID == desc_cstp->objId_u8)
+                {
+                    msgCnt_u8 = data_cu8p[pos_u8 + 1U];
+                }
+                else if(SAMPLE_TYPE_NONE != desc_cstp->sampleType_u8)
+                {
+                    value_s32 = data_cu8p[pos_u8 + 1U];
+                    if(2U == desc_cstp->dataLen_u8)
+                    {
+                        value_s32 |= (int32_t)data_cu8p[pos_u8 + 2U] << 8U;
+                        if(true == desc_cstp->signed_bol)
+                        {
+                            value_s32 = (int16_t)value_s32;
+                        }
+                    }
+                    value_s32 = (value_s32 * desc_cstp->mul_u8) / desc_cstp->div_u8;
+
+                    sample_stp = &out_stap[samples_u8];
+                    memcpy(sample_stp->macAddr_u8a, bda_cu8p, mija_SIZE_MAC_ADDR);
+                    sample_stp->dataType_u8 = desc_cstp->sampleType_u8;
+                    sample_stp->value1_u16 = (uint16_t)value_s32;
+                    sample_stp->value2_u16 = 0U;
+                    samples_u8++;
+                }
+                pos_u8 += 1U + desc_cstp->dataLen_u8;
+            }
+        }
+
+        // the packet id is the first object, so it is known for all samples
+        for(uint8_t idx_u8 = 0U; idx_u8 < samples_u8; idx_u8++)
+        {
+            out_stap[idx_u8].msgCnt_u8 = msgCnt_u8;
+        }
+    }
+
+    return(samples_u8);
+}
+
+/***************************************************************************************/
+/* Local functions: */
+
+/**--------------------------------------------------------------------------------------
+ * @brief     checks the device information, only unencrypted frames of version 2 are
+ *              accepted
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     data_cu8p     service data behind the uuid
+ * @param     dataLen_u8    length of the service data
+ * @return    true if the frame can be decoded, else false
+*//*-----------------------------------------------------------------------------------*/
+static bool CheckFrameHeader_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8)
+{
+    return(   (OBJECTS_ADR <= dataLen_u8)
+           && (VERSION_2 == (data_cu8p[DEVICE_INFO_ADR] & DEVICE_INFO_VERSION))
+           && (0U == (data_cu8p[DEVICE_INFO_ADR] & DEVICE_INFO_ENCRYPTED)));
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     searches the descriptor of an object id
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     objId_u8      object id
+ * @return    descriptor of the object, NULL if the length of the object is unknown
+*//*-----------------------------------------------------------------------------------*/
+static const objectDesc_t * FindObjectDesc_cstp(uint8_t objId_u8)
+{
+    static const objectDesc_t binaryDesc_scst = 
+                            {BINARY_FIRST_ID, 1U, SAMPLE_TYPE_NONE, false, 1U, 1U};
+    const objectDesc_t *desc_cstp = NULL;
+    uint8_t idx_u8 = 0U;
+
+    if(   (BINARY_FIRST_ID <= objId_u8) && (BINARY_LAST_ID >= objId_u8)
+       && ((0x11U >= objId_u8) || (0x15U <= objId_u8)))
+    {
+        desc_cstp = &binaryDesc_scst;
+    }
+
+    while((NULL == desc_cstp) && (OBJECT_DESC_NUM > idx_u8))
+    {
+        if(objId_u8 == objectDesc_scsa[idx_u8].objId_u8)
+        {
+            desc_cstp = &objectDesc_scsa[idx_u8];
+        }
+        idx_u8++;
+    }
+
+    return(desc_cstp);
+}
@@ -0,0 +1,96 @@
+/*****************************************************************************************
+* FILENAME :        bthomeProcl.h
+*
+* SHORT DESCRIPTION:
+*   Header file for bthomeProcl module.
+*
+* DETAILED DESCRIPTION :
+*       Decoder for the BTHome v2 advertisement format
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17. Oct. 2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*****************************************************************************************/
+#ifndef BTHOMEPROCL_H
+#define BTHOMEPROCL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+/****************************************************************************************/
+/* Imported header files: */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#include "mijaProcl.h"
+
+/****************************************************************************************/
+/* Global constant defines: */
+
+#define bthomeProcl_SERVICE_UUID    0xFCD2U // bthome service data
+
+/****************************************************************************************/
+/* Global function like macro defines (to be avoided): */
+
+/****************************************************************************************/
+/* Global type definitions (enum (en), struct (st), union (un), typedef (tx): */
+
+/****************************************************************************************/
+/* Global function definitions: */
+
+/**--------------------------------------------------------------------------------------
+ * @brief     reads the sender address and the packet id of the service data, the
+ *              decoder interface of the ble driver
+ * @param     data_cu8p     service data behind the uuid
+ * @param     dataLen_u8    length of the service data
+ * @param     bda_cu8p      advertiser address, used as sender address
+ * @param     mac_u8p       destination of the mac address (mija_SIZE_MAC_ADDR bytes)
+ * @param     msgCnt_u8p    destination of the packet id
+ * @return    true in case of an unencrypted v2 frame with packet id, else false
+*//*-----------------------------------------------------------------------------------*/
+extern bool bthomeProcl_GetFrameId_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                        const uint8_t *bda_cu8p, uint8_t *mac_u8p, 
+                                        uint8_t *msgCnt_u8p);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     decodes the temperature, humidity and battery objects of the service data
+ *              into raw samples, the decoder interface of the ble driver
+ * @param     data_cu8p     service data behind the uuid
+ * @param     dataLen_u8    length of the service data
+ * @param     bda_cu8p      advertiser address, used as sender address
+ * @param     out_stap      array of raw samples
+ * @param     maxOut_u8     number of elements of the sample array
+ * @return    number of samples, 0 if the data is no unencrypted v2 frame
+*//*-----------------------------------------------------------------------------------*/
+extern uint8_t bthomeProcl_Decode_u8(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                        const uint8_t *bda_cu8p, 
+                                        mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8);
+
+/****************************************************************************************/
+/* Global data definitions: */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BTHOMEPROCL_H
@@ -0,0 +1,192 @@
+/*****************************************************************************************
+* FILENAME :        latStat.c
+*
+* DESCRIPTION :
+*       Latency histograms of the stages a sensor sample passes from the reception in
+*       the gap callback up to the broker acknowledge. The buckets are scaled in powers
+*       of two, bucket i counts latencies from 2^i us to 2^(i+1) - 1 us. The stages
+*       are recorded by different tasks, updates are done in a short critical section.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* PUBLIC FUNCTIONS :
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "latStat.h"
+
+#include "string.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+/****************************************************************************************/
+/* Local function like makros */
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/****************************************************************************************/
+/* Local functions prototypes: */
+
+/****************************************************************************************/
+/* Local variables: */
+
+static latStat_hist_t hist_ssa[latStat_STAGE_NUM];
+static portMUX_TYPE histMux_sst = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *STAGE_NAMES_CCHPA[latStat_STAGE_NUM] = 
+{
+    "parse", "queue", "sched", "publish", "ack", "total"
+};
+
+/****************************************************************************************/
+/* Global functions (unlimited visibility) */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the monotonic time stamp used for all stages
+*//*-----------------------------------------------------------------------------------*/
+uint32_t latStat_Now_u32(void)
+{
+    return((uint32_t)esp_timer_get_time());
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the histogram bucket of a latency
+*//*-----------------------------------------------------------------------------------*/
+uint8_t latStat_GetBucket_u8(uint32_t latUs_u32)
+{
+    uint8_t bucket_u8 = 0U;
+
+    // position of the highest set bit
+    while((1U < latUs_u32) && ((latStat_BUCKETS - 1U) > bucket_u8))
+    {
+        latUs_u32 >>= 1U;
+        bucket_u8++;
+    }
+    return(bucket_u8);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Records the latency between two time stamps of a stage
+*//*-----------------------------------------------------------------------------------*/
+void latStat_Record_vd(latStat_stage_t stage_en, uint32_t startUs_u32, uint32_t endUs_u32)
+{
+    // unsigned difference, correct across the wrap of the time stamp
+    uint32_t latUs_u32 = endUs_u32 - startUs_u32;
+    latStat_hist_t *hist_stp;
+    uint8_t bucket_u8 = latStat_GetBucket_u8(latUs_u32);
+
+    if(latStat_STAGE_NUM > stage_en)
+    {
+        hist_stp = &hist_ssa[stage_en];
+        portENTER_CRITICAL(&histMux_sst);
+        hist_stp->buckets_u32a[bucket_u8]++;
+        hist_stp->count_u32++;
+        hist_stp->sum_u64 += latUs_u32;
+        hist_stp->max_u32 = (latUs_u32 > hist_stp->max_u32) ? latUs_u32 : hist_stp->max_u32;
+        portEXIT_CRITICAL(&histMux_sst);
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get a copy of the histogram of a stage
+*//*-----------------------------------------------------------------------------------*/
+bool latStat_GetHistogram_bol(latStat_stage_t stage_en, latStat_hist_t *hist_stp)
+{
+    bool valid_bol = false;
+
+    if((latStat_STAGE_NUM > stage_en) && (NULL != hist_stp))
+    {
+        portENTER_CRITICAL(&histMux_sst);
+        memcpy(hist_stp, &hist_ssa[stage_en], sizeof(latStat_hist_t));
+        portEXIT_CRITICAL(&histMux_sst);
+        valid_bol = true;
+    }
+    return(valid_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Estimates a percentile of a histogram
+*//*-----------------------------------------------------------------------------------*/
+uint32_t latStat_GetPercentile_u32(const latStat_hist_t *hist_cstp, uint16_t permille_u16)
+{
+    uint32_t latUs_u32 = 0U;
+    uint32_t total_u32 = 0U;
+    uint32_t rank_u32;
+    uint32_t seen_u32 = 0U;
+    uint8_t bucket_u8 = 0U;
+
+    if(NULL != hist_cstp)
+    {
+        for(bucket_u8 = 0U; bucket_u8 < latStat_BUCKETS; bucket_u8++)
+        {
+            total_u32 += hist_cstp->buckets_u32a[bucket_u8];
+        }
+
+        if(0U < total_u32)
+        {
+            rank_u32 = (uint32_t)(((uint64_t)total_u32 * permille_u16 + 999U) / 1000U);
+            rank_u32 = (0U == rank_u32) ? 1U : rank_u32;
+            for(bucket_u8 = 0U; bucket_u8 < (latStat_BUCKETS - 1U); bucket_u8++)
+            {
+                seen_u32 += hist_cstp->buckets_u32a[bucket_u8];
+                if(seen_u32 >= rank_u32)
+                {
+                    break;
+                }
+            }
+            latUs_u32 = (bucket_u8 < (latStat_BUCKETS - 1U)) ? 
+                            ((2U << bucket_u8) - 1U) : hist_cstp->max_u32;
+            latUs_u32 = (latUs_u32 < hist_cstp->max_u32) ? latUs_u32 : hist_cstp->max_u32;
+        }
+    }
+    return(latUs_u32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the short name of a stage
+*//*-----------------------------------------------------------------------------------*/
+const char * latStat_GetStageName_cchp(latStat_stage_t stage_en)
+{
+    return((latStat_STAGE_NUM > stage_en) ? STAGE_NAMES_CCHPA[stage_en] : "?");
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Clears the histograms of all stages
+*//*-----------------------------------------------------------------------------------*/
+void latStat_Reset_vd(void)
+{
+    portENTER_CRITICAL(&histMux_sst);
+    memset(hist_ssa, 0U, sizeof(hist_ssa));
+    portEXIT_CRITICAL(&histMux_sst);
+}
+
+/****************************************************************************************/
+/* Local functions: */
+
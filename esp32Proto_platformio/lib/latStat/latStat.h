@@ -0,0 +1,144 @@
+/*****************************************************************************************
+* FILENAME :        latStat.h
+*
+* DESCRIPTION :
+*       Header file for the latency statistics of the sensor data path
+*
+* Date: 17. October 2026
+*
+* NOTES :
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*****************************************************************************************/
+#ifndef LATSTAT_H
+#define LATSTAT_H
+/****************************************************************************************/
+/* Imported header files: */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+/****************************************************************************************/
+/* Global constant defines: */
+#define latStat_BUCKETS         24U     // bucket i: [2^i, 2^(i+1)) us, last one open ended
+
+/****************************************************************************************/
+/* Global function like macro defines (to be avoided): */
+
+/****************************************************************************************/
+/* Global type definitions (enum (en), struct (st), union (un), typedef (tx): */
+
+/* stages of a sample between reception and broker acknowledge */
+typedef enum latStat_stage_tag
+{
+    latStat_STAGE_PARSE     = 0,    /*!< gap callback until frame decoded */
+    latStat_STAGE_QUEUE     = 1,    /*!< frame decoded until taken from the sample ring */
+    latStat_STAGE_SCHED     = 2,    /*!< taken from the ring until publication requested */
+    latStat_STAGE_PUBLISH   = 3,    /*!< publication requested until handed to mqtt */
+    latStat_STAGE_ACK       = 4,    /*!< handed to mqtt until acknowledged by the broker */
+    latStat_STAGE_TOTAL     = 5,    /*!< gap callback until acknowledged by the broker */
+    latStat_STAGE_NUM
+}latStat_stage_t;
+
+typedef struct latStat_hist_tag
+{
+    uint32_t buckets_u32a[latStat_BUCKETS];
+    uint32_t count_u32;         /*!< number of recorded latencies */
+    uint32_t max_u32;           /*!< largest latency in us */
+    uint64_t sum_u64;           /*!< sum of all latencies in us */
+}latStat_hist_t;
+
+/****************************************************************************************/
+/* Global function definitions: */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the monotonic time stamp used for all stages
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    time since boot in us, wraps after about 71 minutes
+*//*-----------------------------------------------------------------------------------*/
+extern uint32_t latStat_Now_u32(void);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the histogram bucket of a latency
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     latUs_u32     latency in us
+ * @return    bucket index, 0 for latencies below 2 us
+*//*-----------------------------------------------------------------------------------*/
+extern uint8_t latStat_GetBucket_u8(uint32_t latUs_u32);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Records the latency between two time stamps of a stage, can be called
+ *              from any task
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stage_en      stage of the data path
+ * @param     startUs_u32   time stamp at the begin of the stage
+ * @param     endUs_u32     time stamp at the end of the stage
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+extern void latStat_Record_vd(latStat_stage_t stage_en, uint32_t startUs_u32, 
+                                uint32_t endUs_u32);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get a copy of the histogram of a stage
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stage_en      stage of the data path
+ * @param     hist_stp      destination of the histogram
+ * @return    true if the stage is valid
+*//*-----------------------------------------------------------------------------------*/
+extern bool latStat_GetHistogram_bol(latStat_stage_t stage_en, latStat_hist_t *hist_stp);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Estimates a percentile of a histogram as upper limit of the bucket which
+ *              contains it, limited by the largest latency
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     hist_cstp     histogram
+ * @param     permille_u16  percentile in 0.1 percent, e.g. 990 for p99
+ * @return    latency in us, 0 if the histogram is empty
+*//*-----------------------------------------------------------------------------------*/
+extern uint32_t latStat_GetPercentile_u32(const latStat_hist_t *hist_cstp, 
+                                            uint16_t permille_u16);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the short name of a stage
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stage_en      stage of the data path
+ * @return    name of the stage
+*//*-----------------------------------------------------------------------------------*/
+extern const char * latStat_GetStageName_cchp(latStat_stage_t stage_en);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Clears the histograms of all stages
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+extern void latStat_Reset_vd(void);
+
+/****************************************************************************************/
+/* Global data definitions: */
+
+#endif
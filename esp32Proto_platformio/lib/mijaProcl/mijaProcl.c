@@ -11,28 +11,39 @@
 * address:   0  1  2  3  4       5  6    7  8  9 10     11  12 13 14 15 16 17   18  19  20  21 22   23 24
 * data:     02 01 06 15 16		95 fe	50 20 aa 01		8e	86 10 37 34 2d 58	0d	10	04	ce 00	b9 01	
 *
-* with the following interpretation:
-*   - UUID address 05 and 06, data always = 0x95fe  
-*   - message counter address: 11
-*   - device mac address address: 12 - 17,
+* The advertisement is a list of AD structures (length, AD type, data). The length
+* counts the AD type and the data, a length of 0 ends the list. The mija data is the
+* service data structure (AD type 0x16) with the UUID 0xfe95 (little endian 95 fe),
+* the service data is interpreted as follows (offsets relative to the service data):
+*   - frame control: 0 - 1, bit 3: encrypted, bit 4: mac included, 
+*                           bit 5: capability included, bit 6: objects included
+*   - product id: 2 - 3
+*   - message counter: 4
+*   - device mac address: 5 - 10 (if included), 
             data reverse, means MAC address of example: 58:2D:34:37:10:86
-    - data type address: 18, types: 
-                                TEMPERATURE	            0x04
-                                HUMIDITY	            0x06
-                                BATTERY	                0x0A
-                                TEMPERATURE & HUMIDITY  0x0D
-            (example shows a temperature and humidity message)
-    - length address of the data: 20 with following length in bytes known:
-                                TEMPERATURE	            2
-                                HUMIDITY	            2
-                                BATTERY	                1
-                                TEMPERATURE & HUMIDITY  4
-            (example has got a data length of 4 bytes)
+*   - capability: 11 (if included), followed by two bytes io capability if bit 5 of
+*                 the capability is set
+*   - objects until the end of the service data, each with a two byte object id 
+*     (low byte first), the data length and the data. Known objects:
+                                TEMPERATURE	            0x1004, 2 bytes
+                                HUMIDITY	            0x1006, 2 bytes
+                                BATTERY	                0x100A, 1 byte
+                                TEMPERATURE & HUMIDITY  0x100D, 4 bytes
+            (example shows one temperature and humidity object)
     - data: 2 byte data sets are low byte first, here the data is parsed as follows:
             temperature raw   = 0xce00, humidity raw  = 0xb901
             temperature conv  = 0x00ce, humidity conf = 0x01b9
-            data to float     = data conv / 10
-            temperature float = 20,6 °C, humidity     = 44,1% 
+            the values are kept as integer in 0.1 units, the temperature is signed
+            temperature       = 206 (20,6 °C), humidity = 441 (44,1%) 
+* All reads are checked against the length of the advertisement and the length of
+* the AD structure, objects with an unknown id or an unexpected length are skipped.
+*
+* Encrypted frames of version 4 and 5 (frame control bits 12 - 15) carry the
+* objects AES-CCM encrypted, followed by a 3 byte extended counter and a 4 byte
+* message integrity code. The nonce is built from the mac address, product id,
+* message counter and extended counter, the additional data is the byte 0x11.
+* The bindkey of the sensor has to be set with mijaProcl_SetBindKey_bol, the
+* expanded key is kept in ram so the key schedule is only computed once per key.
 *
 *
 * AUTHOR :    Stephan Wink        CREATED ON :    13. Jan. 2019
@@ -69,35 +80,47 @@
 #include "stddef.h"
 #include "string.h"
 #include "stdio.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "mbedtls/ccm.h"
 //#include "esp_log.h"
 //#include "esp_err.h"
 
 /***************************************************************************************/
 /* Local constant defines */
 
-#define UUID_DATA_LOW_ADR		            5U
-#define UUID_DATA_HIGH_ADR		            6U
-#define MSG_CNT_ADR				            11U
-#define DEVICE_MAC_ADR                      17U
-#define DATA_TYPE_ID_ADR				    18U
-#define DATA_LEN_ADR					    20U
-
-#define DATA_BATTERY_LOWBYTE_ADR		    21U
-
-#define DATA_HUMTEMP_TEMP_LOWBYTE_ADR	    21U
-#define DATA_HUMTEMP_TEMP_HIGHBYTE_ADR	    22U
-#define DATA_HUMTEMP_HUM_LOWBYTE_ADR	    23U
-#define DATA_HUMTEMP_HUM_HIGHBYTE_ADR	    24U
-
-#define DATA_TEMP_LOWBYTE_ADR			    21U
-#define DATA_TEMP_HIGHBYTE_ADR			    22U
-
-#define DATA_HUM_LOWBYTE_ADR			    21U
-#define DATA_HUM_HIGHBYTE_ADR			    22U
-
+#define AD_TYPE_SERVICE_DATA                0x16U   // service data, 16 bit uuid
+#define AD_HEADER_LEN                       2U      // length and AD type
+#define AD_UUID_LEN                         2U
 
 #define UUID_DATA_LOW_VAL		            0x95U
 #define UUID_DATA_HIGH_VAL		            0xFEU
+#define UUID_DATA_VAL                       0xFE95U
+
+#define FRAME_CTRL_ADR                      0U
+#define MSG_CNT_ADR				            4U
+#define DEVICE_MAC_ADR                      5U
+#define CAPABILITY_ADR                      11U
+#define FRAME_MIN_LEN                       5U      // frame control, product id, counter
+#define IO_CAPABILITY_LEN                   2U
+
+#define FRAME_CTRL_ENCRYPTED                0x0008U
+#define FRAME_CTRL_MAC                      0x0010U
+#define FRAME_CTRL_CAPABILITY               0x0020U
+#define FRAME_CTRL_OBJECTS                  0x0040U
+#define FRAME_CTRL_VERSION_SHIFT            12U
+#define CAPABILITY_IO                       0x20U
+
+#define CRYPT_MIN_VERSION                   4U      // mibeacon v4/v5 encryption
+#define CRYPT_EXT_CNT_LEN                   3U
+#define CRYPT_MIC_LEN                       4U
+#define CRYPT_TRAILER_LEN                   (CRYPT_EXT_CNT_LEN + CRYPT_MIC_LEN)
+#define CRYPT_NONCE_LEN                     12U
+#define CRYPT_AAD_VAL                       0x11U
+#define CRYPT_MAX_PAYLOAD                   64U
+
+#define OBJECT_HEADER_LEN                   3U      // object id and data length
 
 #define DATA_TYPE_ID_TEMPHUM			    0x0DU
 #define DATA_TYPE_ID_BATT				    0x0AU
@@ -124,23 +147,68 @@
 /***************************************************************************************/
 /* Local type definitions (enum, struct, union) */
 
+/* descriptor of a known object, the object id is 0x10 followed by the data type */
+typedef struct objectDesc_tag
+{
+    uint16_t objId_u16;
+    uint8_t dataLen_u8;
+    uint8_t lenError_u8;            // parse result bit in case of an unexpected length
+}objectDesc_t;
+
+/* position of the parts of a mija frame inside the service data */
+typedef struct frameInfo_tag
+{
+    const uint8_t *data_cu8p;       // service data after the uuid
+    uint8_t dataLen_u8;
+    uint16_t frameCtrl_u16;
+    uint8_t objOffset_u8;           // first object, dataLen_u8 if no objects
+    uint8_t objEnd_u8;              // end of the objects, before the crypto trailer
+}frameInfo_t;
+
+/* bindkey of an encrypted sensor with its expanded key */
+typedef struct keyEntry_tag
+{
+    uint8_t macAddr_u8a[mija_SIZE_MAC_ADDR];
+    bool used_bol;
+    mbedtls_ccm_context ccm_st;
+}keyEntry_t;
+
 /***************************************************************************************/
 /* Local functions prototypes: */
-static bool CheckTheMsgUuid_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp);
-static void ParseTheMsgCounter_vd(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp);
-static void ParseMacAddr_vd(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp);
-static bool ParseDataType_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp);
-
-static bool ConvertTemperature_bol(uint8_t *msg_u8p, 
-                                    mijaProcl_parsedData_t *outData_stp);
-static bool ConvertHumidity_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp);
-static bool ConvertBattery_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp);
-static bool ConvertTempHum_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp);
+static bool FindServiceData_bol(const uint8_t *adv_cu8p, uint8_t advLen_u8, 
+                                    uint16_t uuid_u16, frameInfo_t *frame_stp);
+static bool ParseFrameHeader_bol(const uint8_t *adv_cu8p, uint8_t advLen_u8, 
+                                    frameInfo_t *frame_stp);
+static bool CheckFrameHeader_bol(frameInfo_t *frame_stp);
+static void ReadFrameId_vd(const frameInfo_t *frame_cstp, uint8_t *mac_u8p, 
+                                    uint8_t *msgCnt_u8p);
+static uint8_t DecodeFrame_u8(const frameInfo_t *frame_cstp, 
+                                    mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8);
+static uint8_t ParseObjects_u8(const frameInfo_t *frame_cstp, const uint8_t *obj_cu8p,
+                                    uint8_t objLen_u8, mijaProcl_rawSample_t *out_stap, 
+                                    uint8_t maxOut_u8);
+static bool DecryptObjects_bol(const frameInfo_t *frame_cstp, uint8_t *plain_u8p);
+static uint8_t FindKeyEntry_u8(const uint8_t *frameMac_cu8p);
+static const objectDesc_t * FindObjectDesc_cstp(uint16_t objId_u16);
+static uint16_t ReadLe16_u16(const uint8_t *data_cu8p);
 static bool DataTypeKnown_bol(mijaProcl_dataType_t type_en);
 
 /***************************************************************************************/
 /* Local variables: */
 
+static const objectDesc_t objectDesc_scsa[] =
+{
+    {0x1000U | DATA_TYPE_ID_TEMP,       DATA_LEN_TEMP_STD,      RET_CODE_UNEXPECTED_TEMP_LENGTH},
+    {0x1000U | DATA_TYPE_ID_HUM,        DATA_LEN_HUM_STD,       RET_CODE_UNEXPECTED_HUM_LENGTH},
+    {0x1000U | DATA_TYPE_ID_BATT,       DATA_LEN_BATTERY_STD,   RET_CODE_UNEXPECTED_BAT_LENGTH},
+    {0x1000U | DATA_TYPE_ID_TEMPHUM,    DATA_LEN_TEMPHUM_STD,   RET_CODE_UNEXPECTED_TEMPHUM_LENGTH},
+};
+
+#define OBJECT_DESC_NUM     (sizeof(objectDesc_scsa) / sizeof(objectDesc_scsa[0]))
+
+static keyEntry_t keyCache_ssa[mija_MAX_BINDKEYS];
+static SemaphoreHandle_t keyMutex_sst = NULL;
+
 /***************************************************************************************/
 /* Global functions (unlimited visibility) */
 
@@ -149,26 +217,241 @@ static bool DataTypeKnown_bol(mijaProcl_dataType_t type_en);
  * @author    S. Wink
  * @date      01. Feb. 2020
 *//*-----------------------------------------------------------------------------------*/
-bool mijaProcl_ParseMessage_bol(uint8_t *msg_u8p, 
+bool mijaProcl_ParseMessage_bol(const uint8_t *msg_cu8p, uint8_t msgLen_u8, 
                                         mijaProcl_parsedData_t *outData_stp)
 {
     bool exeResult_bol = false;
+    mijaProcl_rawSample_t sample_st;
 
-    if((NULL != msg_u8p) && (NULL != outData_stp))
+    if((NULL != msg_cu8p) && (NULL != outData_stp))
     {
         // reset the data structure to initial values
         memset(outData_stp, 0U, sizeof(mijaProcl_parsedData_t));
 
-        if(true == CheckTheMsgUuid_bol(msg_u8p, outData_stp))
+        if(0U < mijaProcl_ParseRawSamples_u8(msg_cu8p, msgLen_u8, &sample_st, 1U))
+        {
+            exeResult_bol = mijaProcl_ConvertRawSample_bol(&sample_st, outData_stp);
+        }
+        else
+        {
+            outData_stp->dataType_en = mija_TYPE_UNKNOWN;
+            outData_stp->parseResult_u8 |= RET_CODE_ERROR_UUID_MISSMATCH;
+        }
+    }
+
+    return(exeResult_bol);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     reads only the sender address and the message counter of a mija message
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+bool mijaProcl_GetFrameId_bol(const uint8_t *msg_cu8p, uint8_t msgLen_u8, 
+                                uint8_t *mac_u8p, uint8_t *msgCnt_u8p)
+{
+    bool exeResult_bol = false;
+    frameInfo_t frame_st;
+
+    if(   (NULL != msg_cu8p) && (NULL != mac_u8p) && (NULL != msgCnt_u8p)
+       && (true == ParseFrameHeader_bol(msg_cu8p, msgLen_u8, &frame_st)))
+    {
+        ReadFrameId_vd(&frame_st, mac_u8p, msgCnt_u8p);
+        exeResult_bol = true;
+    }
+
+    return(exeResult_bol);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     reads the sender address and the message counter of mija service data
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+bool mijaProcl_GetServiceFrameId_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                        const uint8_t *bda_cu8p, uint8_t *mac_u8p, 
+                                        uint8_t *msgCnt_u8p)
+{
+    bool exeResult_bol = false;
+    frameInfo_t frame_st;
+
+    // the mija frame carries the sensor address, the advertiser address is not used
+    (void)bda_cu8p;
+    if((NULL != data_cu8p) && (NULL != mac_u8p) && (NULL != msgCnt_u8p))
+    {
+        frame_st.data_cu8p = data_cu8p;
+        frame_st.dataLen_u8 = dataLen_u8;
+        if(true == CheckFrameHeader_bol(&frame_st))
         {
-            ParseTheMsgCounter_vd(msg_u8p, outData_stp);
+            ReadFrameId_vd(&frame_st, mac_u8p, msgCnt_u8p);
+            exeResult_bol = true;
+        }
+    }
 
-            ParseMacAddr_vd(msg_u8p, outData_stp);
+    return(exeResult_bol);
+}
 
-            if(true == ParseDataType_bol(msg_u8p, outData_stp))
+/**--------------------------------------------------------------------------------------
+ * @brief     parses a message string into compact raw samples without conversion
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+uint8_t mijaProcl_ParseRawSamples_u8(const uint8_t *msg_cu8p, uint8_t msgLen_u8,
+                                        mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8)
+{
+    uint8_t samples_u8 = 0U;
+    frameInfo_t frame_st;
+
+    if(   (NULL != msg_cu8p) && (NULL != out_stap)
+       && (true == ParseFrameHeader_bol(msg_cu8p, msgLen_u8, &frame_st)))
+    {
+        samples_u8 = DecodeFrame_u8(&frame_st, out_stap, maxOut_u8);
+    }
+
+    return(samples_u8);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     decodes mija service data into compact raw samples without conversion
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+uint8_t mijaProcl_DecodeServiceData_u8(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                        const uint8_t *bda_cu8p, 
+                                        mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8)
+{
+    uint8_t samples_u8 = 0U;
+    frameInfo_t frame_st;
+
+    (void)bda_cu8p;
+    if((NULL != data_cu8p) && (NULL != out_stap))
+    {
+        frame_st.data_cu8p = data_cu8p;
+        frame_st.dataLen_u8 = dataLen_u8;
+        if(true == CheckFrameHeader_bol(&frame_st))
+        {
+            samples_u8 = DecodeFrame_u8(&frame_st, out_stap, maxOut_u8);
+        }
+    }
+
+    return(samples_u8);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     sets or removes the bindkey of an encrypted sensor
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+bool mijaProcl_SetBindKey_bol(const uint8_t *mac_cu8p, const uint8_t *key_cu8p)
+{
+    bool exeResult_bol = false;
+    uint8_t frameMac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t entry_u8;
+
+    if(NULL == keyMutex_sst)
+    {
+        keyMutex_sst = xSemaphoreCreateMutex();
+    }
+
+    if(   (NULL != mac_cu8p) && (NULL != keyMutex_sst)
+       && (pdTRUE == xSemaphoreTake(keyMutex_sst, portMAX_DELAY)))
+    {
+        // the cache is searched with the mac in frame order (reversed)
+        for(uint8_t macIdx_u8 = 0U; macIdx_u8 < mija_SIZE_MAC_ADDR; macIdx_u8++)
+        {
+            frameMac_u8a[macIdx_u8] = mac_cu8p[mija_SIZE_MAC_ADDR - 1U - macIdx_u8];
+        }
+
+        entry_u8 = FindKeyEntry_u8(&frameMac_u8a[0]);
+        if(mija_MAX_BINDKEYS > entry_u8)
+        {
+            // replace or remove the existing key
+            mbedtls_ccm_free(&keyCache_ssa[entry_u8].ccm_st);
+            keyCache_ssa[entry_u8].used_bol = false;
+        }
+        else
+        {
+            entry_u8 = 0U;
+            while((mija_MAX_BINDKEYS > entry_u8) && (true == keyCache_ssa[entry_u8].used_bol))
+            {
+                entry_u8++;
+            }
+        }
+
+        if(NULL == key_cu8p)
+        {
+            exeResult_bol = true;
+        }
+        else if(mija_MAX_BINDKEYS > entry_u8)
+        {
+            memcpy(keyCache_ssa[entry_u8].macAddr_u8a, frameMac_u8a, mija_SIZE_MAC_ADDR);
+            mbedtls_ccm_init(&keyCache_ssa[entry_u8].ccm_st);
+            if(0 == mbedtls_ccm_setkey(&keyCache_ssa[entry_u8].ccm_st, MBEDTLS_CIPHER_ID_AES,
+                                        key_cu8p, mija_SIZE_BINDKEY * 8U))
             {
+                keyCache_ssa[entry_u8].used_bol = true;
                 exeResult_bol = true;
             }
+            else
+            {
+                mbedtls_ccm_free(&keyCache_ssa[entry_u8].ccm_st);
+            }
+        }
+        else
+        {
+            // key cache is full
+            exeResult_bol = false;
+        }
+
+        xSemaphoreGive(keyMutex_sst);
+    }
+
+    return(exeResult_bol);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     converts a raw sample into the parsed data structure
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+bool mijaProcl_ConvertRawSample_bol(const mijaProcl_rawSample_t *raw_cstp,
+                                    mijaProcl_parsedData_t *outData_stp)
+{
+    bool exeResult_bol = false;
+
+    if((NULL != raw_cstp) && (NULL != outData_stp))
+    {
+        memset(outData_stp, 0U, sizeof(mijaProcl_parsedData_t));
+        outData_stp->uuid_u16 = (UUID_DATA_LOW_VAL << 8U) + UUID_DATA_HIGH_VAL;
+        memcpy(outData_stp->macAddr_u8a, raw_cstp->macAddr_u8a, 
+                                                    sizeof(outData_stp->macAddr_u8a));
+        outData_stp->msgCnt_u8 = raw_cstp->msgCnt_u8;
+        exeResult_bol = true;
+
+        switch(raw_cstp->dataType_u8)
+        {
+            case DATA_TYPE_ID_TEMP:
+                outData_stp->dataType_en = mija_TYPE_TEMPERATURE;
+                outData_stp->temperature_s16 = (int16_t)raw_cstp->value1_u16;
+                break;
+            case DATA_TYPE_ID_HUM:
+                outData_stp->dataType_en = mija_TYPE_HUMIDITY;
+                outData_stp->humidity_u16 = raw_cstp->value1_u16;
+                break;
+            case DATA_TYPE_ID_BATT:
+                outData_stp->dataType_en = mija_TYPE_BATTERY;
+                outData_stp->battery_u8 = (uint8_t)raw_cstp->value1_u16;
+                break;
+            case DATA_TYPE_ID_TEMPHUM:
+                outData_stp->dataType_en = mija_TYPE_TEMPHUM;
+                outData_stp->temperature_s16 = (int16_t)raw_cstp->value1_u16;
+                outData_stp->humidity_u16 = raw_cstp->value2_u16;
+                break;
+            default:
+                outData_stp->dataType_en = mija_TYPE_UNKNOWN;
+                outData_stp->parseResult_u8 |= RET_CODE_ERROR_UNKNOWN_TYPE;
+                exeResult_bol = false;
+                break;
         }
     }
 
@@ -197,9 +480,9 @@ bool mijaProcl_PrintMessage_bol(mijaProcl_parsedData_t *data_stp)
         printf("\n Message counter: %d", data_stp->msgCnt_u8);
         printf("\n Parser result: %d", data_stp->parseResult_u8);
         printf("\n Sensor Data Type: %d", data_stp->dataType_en);
-        printf("\n Sensor Data Battery %f (%%)", data_stp->battery_f32);
-        printf("\n Sensor Data Temperature: %f (°C)", data_stp->temperature_f32);
-        printf("\n Sensor Data Humidity: %f (%%)", data_stp->humidity_f32);
+        printf("\n Sensor Data Battery %d (%%)", data_stp->battery_u8);
+        printf("\n Sensor Data Temperature: %d (0.1 °C)", data_stp->temperature_s16);
+        printf("\n Sensor Data Humidity: %d (0.1 %%)", data_stp->humidity_u16);
         printf("\n Parser result: %d", data_stp->parseResult_u8);
         printf("\n *****************************************");
         printf("\n");
@@ -233,17 +516,17 @@ extern bool mijaProcl_SetData_bol(mijaProcl_parsedData_t *dest_stp,
             switch(src_stp->dataType_en)
             {
                 case DATA_TYPE_ID_TEMP:
-                    dest_stp->temperature_f32 = src_stp->temperature_f32;
+                    dest_stp->temperature_s16 = src_stp->temperature_s16;
                     break;
                 case DATA_TYPE_ID_HUM:
-                    dest_stp->humidity_f32 = dest_stp->humidity_f32;
+                    dest_stp->humidity_u16 = src_stp->humidity_u16;
                     break;
                 case DATA_TYPE_ID_BATT:
-                    dest_stp->battery_f32 = src_stp->battery_f32;
+                    dest_stp->battery_u8 = src_stp->battery_u8;
                     break;
                 case DATA_TYPE_ID_TEMPHUM:
-                    dest_stp->temperature_f32 =  src_stp->temperature_f32;
-                    dest_stp->humidity_f32 = src_stp->humidity_f32;
+                    dest_stp->temperature_s16 =  src_stp->temperature_s16;
+                    dest_stp->humidity_u16 = src_stp->humidity_u16;
                     break;
                 default:
                     exeResult_bol = false;
@@ -263,223 +546,339 @@ extern bool mijaProcl_SetData_bol(mijaProcl_parsedData_t *dest_stp,
 /* Local functions: */
 
 /**--------------------------------------------------------------------------------------
- * @brief     check for the expected UUID of the message and sets it in the out data
+ * @brief     walks the AD structures of an advertisement and searches the service data
+ *              of the given uuid. The AD structure has to fit completely into the
+ *              advertisement.
  * @author    S. Wink
- * @date      13. Jan. 2020
- * @param     msg_u8p       pointer to input data with the message 
- * @param     outData_stp   pointer to the ouput message data structure 
- * @return    true if UUID is as expected, else false
+ * @date      17. Oct. 2026
+ * @param     adv_cu8p      advertisement data
+ * @param     advLen_u8     length of the advertisement data
+ * @param     uuid_u16      16 bit service uuid
+ * @param     frame_stp     position and length of the service data after the uuid
+ * @return    true if the service data was found, else false
 *//*-----------------------------------------------------------------------------------*/
-static bool CheckTheMsgUuid_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp)
+static bool FindServiceData_bol(const uint8_t *adv_cu8p, uint8_t advLen_u8, 
+                                    uint16_t uuid_u16, frameInfo_t *frame_stp)
 {
-    bool exeResult_bol = false;
+    bool found_bol = false;
+    uint16_t pos_u16 = 0U;
+    uint8_t adLen_u8;
 
-    if(     (UUID_DATA_LOW_VAL == *(msg_u8p + UUID_DATA_LOW_ADR)) 
-		&& (UUID_DATA_HIGH_VAL == *(msg_u8p + UUID_DATA_HIGH_ADR)))
-	{
-		outData_stp->uuid_u16 = *(msg_u8p + UUID_DATA_LOW_ADR);
-        outData_stp->uuid_u16 = outData_stp->uuid_u16 << 8U;
-        outData_stp->uuid_u16 += *(msg_u8p + UUID_DATA_HIGH_ADR); 
-        exeResult_bol = true;
-	}
-    else
+    while((false == found_bol) && ((pos_u16 + AD_HEADER_LEN) <= advLen_u8))
     {
-        exeResult_bol = false;
-        outData_stp->parseResult_u8 |= RET_CODE_ERROR_UUID_MISSMATCH;
+        adLen_u8 = adv_cu8p[pos_u16];
+        if((0U == adLen_u8) || ((pos_u16 + 1U + adLen_u8) > advLen_u8))
+        {
+            // end of the significant part or a malformed structure
+            pos_u16 = advLen_u8;
+        }
+        else
+        {
+            if(   (AD_TYPE_SERVICE_DATA == adv_cu8p[pos_u16 + 1U])
+               && ((1U + AD_UUID_LEN) <= adLen_u8)
+               && (uuid_u16 == ReadLe16_u16(&adv_cu8p[pos_u16 + AD_HEADER_LEN])))
+            {
+                frame_stp->data_cu8p = &adv_cu8p[pos_u16 + AD_HEADER_LEN + AD_UUID_LEN];
+                frame_stp->dataLen_u8 = adLen_u8 - 1U - AD_UUID_LEN;
+                found_bol = true;
+            }
+            pos_u16 += 1U + adLen_u8;
+        }
     }
-    
-    return(exeResult_bol);
+
+    return(found_bol);
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     retrieves the message counter from the message, it is expected, that
- *            the privious checks are already valid (e.g. UUID)
+ * @brief     searches the mija service data and checks the frame header
  * @author    S. Wink
- * @date      13. Jan. 2020
- * @param     msg_u8p       pointer to input data with the message 
- * @param     outData_stp   pointer to the ouput message data structure 
+ * @date      17. Oct. 2026
+ * @param     adv_cu8p      advertisement data
+ * @param     advLen_u8     length of the advertisement data
+ * @param     frame_stp     frame information
+ * @return    true if the frame header is valid, else false
 *//*-----------------------------------------------------------------------------------*/
-static void ParseTheMsgCounter_vd(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp)
+static bool ParseFrameHeader_bol(const uint8_t *adv_cu8p, uint8_t advLen_u8, 
+                                    frameInfo_t *frame_stp)
 {
-    outData_stp->msgCnt_u8 = *(msg_u8p + MSG_CNT_ADR);
+    return(   (true == FindServiceData_bol(adv_cu8p, advLen_u8, UUID_DATA_VAL, frame_stp))
+           && (true == CheckFrameHeader_bol(frame_stp)));
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     retrieves the MAC address of the device from the message, it is expected, 
- *            that the privious checks are already valid (e.g. UUID)
+ * @brief     checks the frame header of the service data, only frames with a mac 
+ *              address are accepted, encrypted frames only in the version 4 or 5 format
  * @author    S. Wink
- * @date      13. Jan. 2020
- * @param     msg_u8p       pointer to input data with the message 
- * @param     outData_stp   pointer to the ouput message data structure 
+ * @date      17. Oct. 2026
+ * @param     frame_stp     frame information, service data and its length are set
+ * @return    true if the frame header is valid, else false
 *//*-----------------------------------------------------------------------------------*/
-static void ParseMacAddr_vd(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp)
+static bool CheckFrameHeader_bol(frameInfo_t *frame_stp)
 {
-    uint8_t msgIdx_u8 = DEVICE_MAC_ADR;
-    uint8_t macIdx_u8 = 0U;
-   
-    while(6 != macIdx_u8)
+    bool exeResult_bol = false;
+    uint16_t offset_u16 = DEVICE_MAC_ADR + mija_SIZE_MAC_ADDR;
+
+    if(FRAME_MIN_LEN <= frame_stp->dataLen_u8)
     {
-        outData_stp->macAddr_u8a[macIdx_u8] = *(msg_u8p + msgIdx_u8);
-        msgIdx_u8--;
-        macIdx_u8++;
+        frame_stp->frameCtrl_u16 = ReadLe16_u16(&frame_stp->data_cu8p[FRAME_CTRL_ADR]);
+
+        frame_stp->objEnd_u8 = frame_stp->dataLen_u8;
+        if(0U != (frame_stp->frameCtrl_u16 & FRAME_CTRL_ENCRYPTED))
+        {
+            // the crypto trailer is located behind the objects
+            frame_stp->objEnd_u8 = (CRYPT_TRAILER_LEN <= frame_stp->dataLen_u8) ?
+                                        (frame_stp->dataLen_u8 - CRYPT_TRAILER_LEN) : 0U;
+        }
+
+        if(   (0U != (frame_stp->frameCtrl_u16 & FRAME_CTRL_MAC))
+           && (   (0U == (frame_stp->frameCtrl_u16 & FRAME_CTRL_ENCRYPTED))
+               || (CRYPT_MIN_VERSION <= (frame_stp->frameCtrl_u16 >> FRAME_CTRL_VERSION_SHIFT)))
+           && (offset_u16 <= frame_stp->objEnd_u8))
+        {
+            exeResult_bol = true;
+
+            if(0U != (frame_stp->frameCtrl_u16 & FRAME_CTRL_CAPABILITY))
+            {
+                exeResult_bol = (CAPABILITY_ADR < frame_stp->objEnd_u8);
+                if(   (true == exeResult_bol) 
+                   && (0U != (frame_stp->data_cu8p[CAPABILITY_ADR] & CAPABILITY_IO)))
+                {
+                    offset_u16 += IO_CAPABILITY_LEN;
+                }
+                offset_u16++;
+            }
+
+            if(0U == (frame_stp->frameCtrl_u16 & FRAME_CTRL_OBJECTS))
+            {
+                offset_u16 = frame_stp->objEnd_u8;
+            }
+
+            exeResult_bol &= (offset_u16 <= frame_stp->objEnd_u8);
+            frame_stp->objOffset_u8 = (uint8_t)offset_u16;
+        }
     }
+
+    return(exeResult_bol);
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     checks the correct data type of the message.
+ * @brief     reads the sender address and the message counter of a checked frame
  * @author    S. Wink
- * @date      13. Jan. 2020
- * @param     msg_u8p       pointer to input data with the message 
- * @param     outData_stp   pointer to the ouput message data structure 
+ * @date      17. Oct. 2026
+ * @param     frame_cstp    frame information
+ * @param     mac_u8p       destination of the mac address (mija_SIZE_MAC_ADDR bytes)
+ * @param     msgCnt_u8p    destination of the message counter
+ * @return    n/a
 *//*-----------------------------------------------------------------------------------*/
-static bool ParseDataType_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp)
+static void ReadFrameId_vd(const frameInfo_t *frame_cstp, uint8_t *mac_u8p, 
+                                    uint8_t *msgCnt_u8p)
 {
-    bool exeResult_bol = true;
-    uint8_t msgType_u8 = *(msg_u8p + DATA_TYPE_ID_ADR);
-
-    switch(msgType_u8)
+    for(uint8_t macIdx_u8 = 0U; macIdx_u8 < mija_SIZE_MAC_ADDR; macIdx_u8++)
     {
-        case DATA_TYPE_ID_TEMP:
-            outData_stp->dataType_en = mija_TYPE_HUMIDITY;
-            exeResult_bol &= ConvertTemperature_bol(msg_u8p, outData_stp);
-            break;
-        case DATA_TYPE_ID_HUM:
-            outData_stp->dataType_en = mija_TYPE_HUMIDITY;
-            exeResult_bol &= ConvertHumidity_bol(msg_u8p, outData_stp);
-            break;
-        case DATA_TYPE_ID_BATT:
-            outData_stp->dataType_en = mija_TYPE_BATTERY;
-            exeResult_bol &= ConvertBattery_bol(msg_u8p, outData_stp);
-            break;
-        case DATA_TYPE_ID_TEMPHUM:
-            outData_stp->dataType_en = mija_TYPE_TEMPHUM;
-            exeResult_bol &= ConvertTempHum_bol(msg_u8p, outData_stp);
-            break;
-        default:
-            outData_stp->dataType_en = mija_TYPE_UNKNOWN;
-            exeResult_bol = false;
-            outData_stp->parseResult_u8 |= RET_CODE_ERROR_UNKNOWN_TYPE;
-            break;
+        mac_u8p[macIdx_u8] = frame_cstp->data_cu8p[DEVICE_MAC_ADR + mija_SIZE_MAC_ADDR 
+                                                    - 1U - macIdx_u8];
     }
-    
-    return(exeResult_bol);
+    *msgCnt_u8p = frame_cstp->data_cu8p[MSG_CNT_ADR];
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     converts the message data to temperature
+ * @brief     decodes a checked frame into raw samples, encrypted objects are decrypted
+ *              with the cached bindkey of the sender first
  * @author    S. Wink
- * @date      13. Jan. 2020
- * @param     msg_u8p       pointer to input data with the message 
- * @param     outData_stp   pointer to the ouput message data structure 
+ * @date      17. Oct. 2026
+ * @param     frame_cstp    frame information
+ * @param     out_stap      array of raw samples
+ * @param     maxOut_u8     number of elements of the sample array
+ * @return    number of samples
 *//*-----------------------------------------------------------------------------------*/
-static bool ConvertTemperature_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp)
+static uint8_t DecodeFrame_u8(const frameInfo_t *frame_cstp, 
+                                    mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8)
 {
-    bool exeResult_bol = false;
-    uint16_t dataRaw_u16 = 0U;
+    uint8_t samples_u8 = 0U;
+    uint8_t plain_u8a[CRYPT_MAX_PAYLOAD];
 
-    if(DATA_LEN_TEMP_STD == *(msg_u8p + DATA_LEN_ADR))
+    if(0U == (frame_cstp->frameCtrl_u16 & FRAME_CTRL_ENCRYPTED))
     {
-        dataRaw_u16 = *(msg_u8p + DATA_TEMP_HIGHBYTE_ADR);
-		dataRaw_u16 = dataRaw_u16 << 8U;
-		dataRaw_u16 += *(msg_u8p + DATA_TEMP_LOWBYTE_ADR);
-		outData_stp->temperature_f32 = ((float)dataRaw_u16) / 10.0F;
-        exeResult_bol = true;
+        samples_u8 = ParseObjects_u8(frame_cstp, 
+                                        &frame_cstp->data_cu8p[frame_cstp->objOffset_u8],
+                                        frame_cstp->objEnd_u8 - frame_cstp->objOffset_u8,
+                                        out_stap, maxOut_u8);
+    }
+    else if(true == DecryptObjects_bol(frame_cstp, &plain_u8a[0]))
+    {
+        samples_u8 = ParseObjects_u8(frame_cstp, &plain_u8a[0], 
+                                        frame_cstp->objEnd_u8 - frame_cstp->objOffset_u8,
+                                        out_stap, maxOut_u8);
     }
     else
     {
-        outData_stp->parseResult_u8 |= RET_CODE_UNEXPECTED_TEMP_LENGTH;
+        // no bindkey or the message integrity check failed
+        samples_u8 = 0U;
     }
-    
 
-    return(exeResult_bol);
+    return(samples_u8);
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     converts the message data to humidity
+ * @brief     decodes the objects of a frame into raw samples
  * @author    S. Wink
- * @date      13. Jan. 2020
- * @param     msg_u8p       pointer to input data with the message 
- * @param     outData_stp   pointer to the ouput message data structure 
+ * @date      17. Oct. 2026
+ * @param     frame_cstp    frame information, source of mac and counter
+ * @param     obj_cu8p      first object
+ * @param     objLen_u8     length of all objects
+ * @param     out_stap      array of raw samples
+ * @param     maxOut_u8     number of elements of the sample array
+ * @return    number of samples
 *//*-----------------------------------------------------------------------------------*/
-static bool ConvertHumidity_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp)
+static uint8_t ParseObjects_u8(const frameInfo_t *frame_cstp, const uint8_t *obj_cu8p,
+                                    uint8_t objLen_u8, mijaProcl_rawSample_t *out_stap, 
+                                    uint8_t maxOut_u8)
 {
-    bool exeResult_bol = false;
-    uint16_t dataRaw_u16 = 0U;
-
-    if(DATA_LEN_HUM_STD == *(msg_u8p + DATA_LEN_ADR))
+    uint8_t samples_u8 = 0U;
+    const objectDesc_t *desc_cstp;
+    const uint8_t *cur_cu8p;
+    uint8_t pos_u8 = 0U;
+    uint8_t dataLen_u8;
+
+    // each object needs its header and the announced data inside the object area
+    while((samples_u8 < maxOut_u8) && ((pos_u8 + OBJECT_HEADER_LEN) <= objLen_u8))
     {
-        dataRaw_u16 = *(msg_u8p + DATA_HUM_HIGHBYTE_ADR);
-        dataRaw_u16 = dataRaw_u16 << 8U;
-        dataRaw_u16 += *(msg_u8p + DATA_HUM_LOWBYTE_ADR);
-        outData_stp->humidity_f32 = ((float)dataRaw_u16) / 10.0F;
-        exeResult_bol = true;
-    }
-    else
-    {
-        outData_stp->parseResult_u8 |= RET_CODE_UNEXPECTED_HUM_LENGTH;
+        cur_cu8p = &obj_cu8p[pos_u8];
+        dataLen_u8 = cur_cu8p[2];
+        if((pos_u8 + OBJECT_HEADER_LEN + dataLen_u8) > objLen_u8)
+        {
+            // truncated object, ignore the rest of the frame
+            pos_u8 = objLen_u8;
+        }
+        else
+        {
+            desc_cstp = FindObjectDesc_cstp(ReadLe16_u16(cur_cu8p));
+            if((NULL != desc_cstp) && (desc_cstp->dataLen_u8 == dataLen_u8))
+            {
+                mijaProcl_rawSample_t *sample_stp = &out_stap[samples_u8];
+
+                for(uint8_t macIdx_u8 = 0U; macIdx_u8 < mija_SIZE_MAC_ADDR; macIdx_u8++)
+                {
+                    sample_stp->macAddr_u8a[macIdx_u8] = 
+                            frame_cstp->data_cu8p[DEVICE_MAC_ADR + mija_SIZE_MAC_ADDR 
+                                                    - 1U - macIdx_u8];
+                }
+                sample_stp->msgCnt_u8 = frame_cstp->data_cu8p[MSG_CNT_ADR];
+                sample_stp->dataType_u8 = (uint8_t)(desc_cstp->objId_u16 & 0x00FFU);
+                sample_stp->value1_u16 = (2U <= dataLen_u8) ? 
+                                ReadLe16_u16(&cur_cu8p[OBJECT_HEADER_LEN]) :
+                                cur_cu8p[OBJECT_HEADER_LEN];
+                sample_stp->value2_u16 = (4U <= dataLen_u8) ?
+                                ReadLe16_u16(&cur_cu8p[OBJECT_HEADER_LEN + 2U]) : 0U;
+                samples_u8++;
+            }
+            pos_u8 += OBJECT_HEADER_LEN + dataLen_u8;
+        }
     }
 
-    return(exeResult_bol);
+    return(samples_u8);
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     converts the message data to battery capacity in percentage
+ * @brief     decrypts and authenticates the objects of an encrypted frame with the
+ *              cached key of the sender. Runs in the context of the bluetooth stack,
+ *              so the key cache is not waited for if it is just modified.
  * @author    S. Wink
- * @date      13. Jan. 2020
- * @param     msg_u8p       pointer to input data with the message 
- * @param     outData_stp   pointer to the ouput message data structure 
+ * @date      17. Oct. 2026
+ * @param     frame_cstp    frame information
+ * @param     plain_u8p     destination of the decrypted objects (CRYPT_MAX_PAYLOAD)
+ * @return    true if the objects were decrypted and the integrity check passed
 *//*-----------------------------------------------------------------------------------*/
-static bool ConvertBattery_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp)
+static bool DecryptObjects_bol(const frameInfo_t *frame_cstp, uint8_t *plain_u8p)
 {
     bool exeResult_bol = false;
-    uint16_t dataRaw_u16 = 0U;
-
-    if(DATA_LEN_BATTERY_STD == *(msg_u8p + DATA_LEN_ADR))
+    const uint8_t *data_cu8p = frame_cstp->data_cu8p;
+    uint8_t objLen_u8 = frame_cstp->objEnd_u8 - frame_cstp->objOffset_u8;
+    uint8_t nonce_u8a[CRYPT_NONCE_LEN];
+    const uint8_t aad_cu8 = CRYPT_AAD_VAL;
+    uint8_t entry_u8;
+
+    if(   (CRYPT_MAX_PAYLOAD >= objLen_u8) && (NULL != keyMutex_sst)
+       && (pdTRUE == xSemaphoreTake(keyMutex_sst, 0U)))
     {
-        dataRaw_u16 = *(msg_u8p + DATA_BATTERY_LOWBYTE_ADR);
-		outData_stp->battery_f32 = ((float)dataRaw_u16);
-        exeResult_bol = true;
-    }
-    else
-    {
-        outData_stp->parseResult_u8 |= RET_CODE_UNEXPECTED_BAT_LENGTH;
+        entry_u8 = FindKeyEntry_u8(&data_cu8p[DEVICE_MAC_ADR]);
+        if(mija_MAX_BINDKEYS > entry_u8)
+        {
+            // nonce: mac (frame order), product id, counter, extended counter
+            memcpy(&nonce_u8a[0], &data_cu8p[DEVICE_MAC_ADR], mija_SIZE_MAC_ADDR);
+            memcpy(&nonce_u8a[6], &data_cu8p[2], 2U);
+            nonce_u8a[8] = data_cu8p[MSG_CNT_ADR];
+            memcpy(&nonce_u8a[9], &data_cu8p[frame_cstp->objEnd_u8], CRYPT_EXT_CNT_LEN);
+
+            exeResult_bol = (0 == mbedtls_ccm_auth_decrypt(&keyCache_ssa[entry_u8].ccm_st,
+                                    objLen_u8, &nonce_u8a[0], CRYPT_NONCE_LEN, 
+                                    &aad_cu8, 1U, &data_cu8p[frame_cstp->objOffset_u8],
+                                    plain_u8p, 
+                                    &data_cu8p[frame_cstp->objEnd_u8 + CRYPT_EXT_CNT_LEN],
+                                    CRYPT_MIC_LEN));
+        }
+        xSemaphoreGive(keyMutex_sst);
     }
 
     return(exeResult_bol);
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     converts the message data to temperture and humidity
+ * @brief     searches the key cache entry of a sender
  * @author    S. Wink
- * @date      13. Jan. 2020
- * @param     msg_u8p       pointer to input data with the message 
- * @param     outData_stp   pointer to the ouput message data structure 
+ * @date      17. Oct. 2026
+ * @param     frameMac_cu8p     mac address in frame order
+ * @return    index of the entry, mija_MAX_BINDKEYS if no key is available
 *//*-----------------------------------------------------------------------------------*/
-static bool ConvertTempHum_bol(uint8_t *msg_u8p, mijaProcl_parsedData_t *outData_stp)
+static uint8_t FindKeyEntry_u8(const uint8_t *frameMac_cu8p)
 {
-    bool exeResult_bol = false;
-    uint16_t dataRaw_u16 = 0U;
+    uint8_t entry_u8 = 0U;
 
-    if(DATA_LEN_TEMPHUM_STD == *(msg_u8p + DATA_LEN_ADR))
+    while(   (mija_MAX_BINDKEYS > entry_u8)
+          && (   (false == keyCache_ssa[entry_u8].used_bol)
+              || (0 != memcmp(keyCache_ssa[entry_u8].macAddr_u8a, frameMac_cu8p,
+                                mija_SIZE_MAC_ADDR))))
     {
-		dataRaw_u16 = *(msg_u8p + DATA_HUMTEMP_TEMP_HIGHBYTE_ADR);
-		dataRaw_u16 = dataRaw_u16 << 8U;
-		dataRaw_u16 += *(msg_u8p + DATA_HUMTEMP_TEMP_LOWBYTE_ADR);
-		outData_stp->temperature_f32 = ((float)dataRaw_u16) / 10.0F;
+        entry_u8++;
+    }
 
-        dataRaw_u16 = *(msg_u8p + DATA_HUMTEMP_HUM_HIGHBYTE_ADR);
-        dataRaw_u16 = dataRaw_u16 << 8U;
-        dataRaw_u16 += *(msg_u8p + DATA_HUMTEMP_HUM_LOWBYTE_ADR);
-        outData_stp->humidity_f32 = ((float)dataRaw_u16) / 10.0F;
+    return(entry_u8);
+}
 
-        exeResult_bol = true;
-    }
-    else
+/**--------------------------------------------------------------------------------------
+ * @brief     searches the descriptor of an object id
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     objId_u16     object id of the frame
+ * @return    pointer to the descriptor, NULL if the object is unknown
+*//*-----------------------------------------------------------------------------------*/
+static const objectDesc_t * FindObjectDesc_cstp(uint16_t objId_u16)
+{
+    const objectDesc_t *desc_cstp = NULL;
+    uint8_t idx_u8 = 0U;
+
+    while((NULL == desc_cstp) && (OBJECT_DESC_NUM > idx_u8))
     {
-        outData_stp->parseResult_u8 |= RET_CODE_UNEXPECTED_TEMPHUM_LENGTH;
+        if(objId_u16 == objectDesc_scsa[idx_u8].objId_u16)
+        {
+            desc_cstp = &objectDesc_scsa[idx_u8];
+        }
+        idx_u8++;
     }
 
-    return(exeResult_bol);
+    return(desc_cstp);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     reads a 16 bit value stored low byte first
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     data_cu8p     pointer to the low byte
+ * @return    value
+*//*-----------------------------------------------------------------------------------*/
+static uint16_t ReadLe16_u16(const uint8_t *data_cu8p)
+{
+    return((uint16_t)(((uint16_t)data_cu8p[1] << 8U) | data_cu8p[0]));
 }
 
 /**--------------------------------------------------------------------------------------
@@ -48,6 +48,10 @@ extern "C"
 /* Global constant defines: */
 
 #define mija_SIZE_MAC_ADDR      6U
+#define mija_MAX_OBJECTS        4U      // objects evaluated per advertisement
+#define mija_SIZE_BINDKEY       16U     // aes-128 key of encrypted sensors
+#define mija_MAX_BINDKEYS       8U      // encrypted sensors with a cached key
+#define mija_SERVICE_UUID       0xFE95U // 16 bit uuid of the mija service data
 /****************************************************************************************/
 /* Global function like macro defines (to be avoided): */
 
@@ -69,12 +73,24 @@ typedef struct mijaProcl_parsedData_tag
     uint8_t macAddr_u8a[mija_SIZE_MAC_ADDR];
     uint8_t msgCnt_u8;
     mijaProcl_dataType_t dataType_en;
-    float battery_f32;
-    float temperature_f32;
-    float humidity_f32;
+    uint8_t battery_u8;         // battery level in percent
+    int16_t temperature_s16;    // temperature in 0.1 degree celsius
+    uint16_t humidity_u16;      // humidity in 0.1 percent
     uint8_t parseResult_u8;
 }mijaProcl_parsedData_t;
 
+/* compact sample as received, the conversion is done outside of the bluetooth stack */
+typedef struct mijaProcl_rawSample_tag
+{
+    uint8_t macAddr_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+    uint8_t dataType_u8;
+    uint16_t value1_u16;        // temperature, humidity or battery raw value
+    uint16_t value2_u16;        // humidity raw value of combined messages
+    uint32_t rxUs_u32;          // time stamp of the reception, set by the ble driver
+    uint32_t parsedUs_u32;      // time stamp after decoding, set by the ble driver
+}mijaProcl_rawSample_t;
+
 typedef struct mijaProcl_param_tag
 {
 
@@ -84,12 +100,84 @@ typedef struct mijaProcl_param_tag
 /* Global function definitions: */
 
 /**--------------------------------------------------------------------------------------
- * @brief     parses a message string and sets the ouput data structure
- * @param     msg_u8p       pointer to input data with the message 
+ * @brief     parses a message string and sets the ouput data structure, only the first
+ *              known object of the message is evaluated
+ * @param     msg_cu8p      pointer to input data with the message 
+ * @param     msgLen_u8     length of the message
  * @param     outData_stp   pointer to the ouput message data structure 
  * @return    true in case of success, else false
 *//*-----------------------------------------------------------------------------------*/
-extern bool mijaProcl_ParseMessage_bol(uint8_t *msg_u8p, 
+extern bool mijaProcl_ParseMessage_bol(const uint8_t *msg_cu8p, uint8_t msgLen_u8, 
+                                            mijaProcl_parsedData_t *outData_stp);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     reads only the sender address and the message counter of a mija message,
+ *              used to identify repeated frames before the message is parsed
+ * @param     msg_cu8p      pointer to input data with the message 
+ * @param     msgLen_u8     length of the message
+ * @param     mac_u8p       destination of the mac address (mija_SIZE_MAC_ADDR bytes)
+ * @param     msgCnt_u8p    destination of the message counter
+ * @return    true in case of a mija message, else false
+*//*-----------------------------------------------------------------------------------*/
+extern bool mijaProcl_GetFrameId_bol(const uint8_t *msg_cu8p, uint8_t msgLen_u8, 
+                                        uint8_t *mac_u8p, uint8_t *msgCnt_u8p);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     parses a message string into compact raw samples without conversion, one
+ *              sample per known object of the message
+ * @param     msg_cu8p      pointer to input data with the message 
+ * @param     msgLen_u8     length of the message
+ * @param     out_stap      array of raw samples
+ * @param     maxOut_u8     number of elements of the sample array
+ * @return    number of samples, 0 if the message is no valid mija message
+*//*-----------------------------------------------------------------------------------*/
+extern uint8_t mijaProcl_ParseRawSamples_u8(const uint8_t *msg_cu8p, uint8_t msgLen_u8,
+                                        mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     reads the sender address and the message counter of mija service data,
+ *              the decoder interface of the ble driver
+ * @param     data_cu8p     service data behind the uuid
+ * @param     dataLen_u8    length of the service data
+ * @param     bda_cu8p      advertiser address, not used
+ * @param     mac_u8p       destination of the mac address (mija_SIZE_MAC_ADDR bytes)
+ * @param     msgCnt_u8p    destination of the message counter
+ * @return    true in case of a valid mija frame, else false
+*//*-----------------------------------------------------------------------------------*/
+extern bool mijaProcl_GetServiceFrameId_bol(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                        const uint8_t *bda_cu8p, uint8_t *mac_u8p, 
+                                        uint8_t *msgCnt_u8p);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     decodes mija service data into compact raw samples, the decoder 
+ *              interface of the ble driver
+ * @param     data_cu8p     service data behind the uuid
+ * @param     dataLen_u8    length of the service data
+ * @param     bda_cu8p      advertiser address, not used
+ * @param     out_stap      array of raw samples
+ * @param     maxOut_u8     number of elements of the sample array
+ * @return    number of samples, 0 if the data is no valid mija frame
+*//*-----------------------------------------------------------------------------------*/
+extern uint8_t mijaProcl_DecodeServiceData_u8(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                        const uint8_t *bda_cu8p, 
+                                        mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     sets or removes the bindkey of an encrypted sensor. The key is expanded
+ *              once and kept in the key cache until it is replaced or removed.
+ * @param     mac_cu8p      mac address of the sensor
+ * @param     key_cu8p      bindkey (mija_SIZE_BINDKEY bytes), NULL removes the key
+ * @return    true in case of success, false if the key cache is full
+*//*-----------------------------------------------------------------------------------*/
+extern bool mijaProcl_SetBindKey_bol(const uint8_t *mac_cu8p, const uint8_t *key_cu8p);
+
+/**--------------------------------------------------------------------------------------
+ * @brief     converts a raw sample into the parsed data structure
+ * @param     raw_cstp      pointer to the raw sample
+ * @param     outData_stp   pointer to the ouput message data structure 
+ * @return    true in case of a known data type, else false
+*//*-----------------------------------------------------------------------------------*/
+extern bool mijaProcl_ConvertRawSample_bol(const mijaProcl_rawSample_t *raw_cstp,
                                             mijaProcl_parsedData_t *outData_stp);
 
 /**--------------------------------------------------------------------------------------
@@ -241,6 +241,7 @@ extern bool gendev_GetSubscriptionByIndex_bol(uint16_t idx_u16,
         dest_stp->discon_fp = OnDisconnectionHandler_vd;
         dest_stp->dataRecv_fp = OnDataReceivedHandler_st;
         dest_stp->qos_u32 = 0;
+        dest_stp->token_u32 = idx_u16;
 
         memset(&dest_stp->topic_u8a[0], 0U, sizeof(dest_stp->topic_u8a));
         memcpy(&dest_stp->topic_u8a[0], &this_sst.subs_chap[idx_u16][0],
@@ -416,14 +417,11 @@ static esp_err_t OnDataReceivedHandler_st(mqttif_msg_t *msg_stp)
 {
     esp_err_t result_st = ESP_OK;
 
-    ESP_LOGD(TAG, "message topic:%.*s received with data:%.*s",
-                    msg_stp->topicLen_u32, msg_stp->topic_chp,
-                    msg_stp->dataLen_u32, msg_stp->data_chp);
+    ESP_LOGD(TAG, "message for subscription %d received, data length: %d",
+                    msg_stp->token_u32, msg_stp->dataLen_u32);
 
-    if(   (0U == strncmp(msg_stp->topic_chp, &this_sst.subs_chap[0][0],
-                            msg_stp->topicLen_u32))
-       || (0U == strncmp(msg_stp->topic_chp, &this_sst.subs_chap[1][0],
-                            msg_stp->topicLen_u32)))
+    // both subscriptions (device and broadcast) accept the same commands
+    if(this_sst.subsCounter_u16 > msg_stp->token_u32)
     {
         if(   (0U != msg_stp->dataLen_u32)
            && (0U == strncmp(msg_stp->data_chp, MQTT_PAYLOAD_CMD_INFO,
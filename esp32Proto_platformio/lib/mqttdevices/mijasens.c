@@ -35,6 +35,8 @@
 #include "mijasens.h"
 
 #include "stdbool.h"
+#include "stdlib.h"
+#include "ctype.h"
 #include "string.h"
 #include "esp_log.h"
 #include "esp_err.h"
@@ -50,6 +52,11 @@
 
 #include "bleDrv.h"
 #include "mijaProcl.h"
+#include "atcProcl.h"
+#include "bthomeProcl.h"
+#include "sampleBuf.h"
+#include "sensHist.h"
+#include "latStat.h"
 
 #include "appIdent.h"
 #include "utils.h"
@@ -57,8 +64,17 @@
 /****************************************************************************************/
 /* Local constant defines */
 
+#ifdef CONFIG_MIJASENS_MAX_SENSORS
+#define MAX_MIJA_SENSORS        CONFIG_MIJASENS_MAX_SENSORS
+#else
 #define MAX_MIJA_SENSORS        5U
+#endif
+#define MAC_HASH_BITS           9U      // hash table size, at least twice the sensors
+#define MAC_HASH_SIZE           (1U << MAC_HASH_BITS)
+#define MAC_HASH_EMPTY          0xFFU
 #define LOCATION_STRING_SIZE    20U
+#define VALUE_STRING_SIZE       13U     // fixed point value formatted as string
+#define LOCATION_JSON_SIZE      (LOCATION_STRING_SIZE * 6U + 1U)  // worst case \u00XX
 
 #define MQTT_SUBSCRIPTIONS_NUM  1U
 
@@ -78,7 +94,27 @@
 
 #define TASK_STACK_SIZE         4096
 #define TASK_PRIORITY           5
-#define QUEUE_ELEMENTS          10
+#define RAW_RING_SIZE           32U     // raw samples between ble stack and task, power of 2
+
+#define PUB_CYCLE_MS            20000U  // default publish interval of a sensor
+#define SCHED_TICK_MS           500U    // period of the publish scheduler
+
+#define REPLAY_BATCH_SIZE       5U      // buffered samples published per replay period
+#define REPLAY_PERIOD_MS        1000U   // period of the buffered sample replay
+
+#define HIST_TEMP_VALID         0x01U   // temperature received, history can be filled
+#define HIST_HUM_VALID          0x02U   // humidity received
+#define HIST_ALL_VALID          (HIST_TEMP_VALID | HIST_HUM_VALID)
+
+#define LAT_PUB_PERIOD_MS       60000U  // period of the latency statistics publication
+
+#define REGISTRY_VERSION        1U      // layout version of the sensor registry blob
+#define REGISTRY_NVS_LIMIT      50U     // entries fitting into one nvs blob, blob layout
+#define REGISTRY_SIZE           ((MAX_MIJA_SENSORS < REGISTRY_NVS_LIMIT) ? \
+                                    MAX_MIJA_SENSORS : REGISTRY_NVS_LIMIT)
+#define REGISTRY_QUEUE_SIZE     8U      // pending registry changes from other tasks
+#define REGISTRY_SAVE_DELAY_MS  5000U   // quiet time after the last change before saving
+#define REGISTRY_SAVE_MAX_MS    60000U  // maximum delay of a save during ongoing changes
 
 /****************************************************************************************/
 /* Local function like makros */
@@ -107,12 +143,40 @@ typedef struct sensorParam_tag
     uint8_t macAddr_u8a[mija_SIZE_MAC_ADDR];
     char loc_cha[LOCATION_STRING_SIZE];
     uint8_t knownSens_u8;
+    uint16_t pubIntv_u16;       // publish interval in seconds, 0: default interval
+    uint16_t dbTemp_u16;        // temperature deadband in 0.1 degree, 0: default
+    uint16_t dbHum_u16;         // humidity deadband in 0.1 percent, 0: default
+    uint16_t dbBatt_u16;        // battery deadband in percent, 0: default
 }sensorParam_t;
 
+/* single producer (ble stack) single consumer (mijasens task) ring, the producer only
+   writes the head, the consumer only writes the tail */
+typedef struct rawRing_tag
+{
+    mijaProcl_rawSample_t buf_sta[RAW_RING_SIZE];
+    uint32_t head_u32;          // free running write counter
+    uint32_t tail_u32;          // free running read counter
+    uint32_t received_u32;      // samples handed over by the ble driver
+    uint32_t dropped_u32;       // samples lost because the ring was full
+}rawRing_t;
+
 typedef struct sensorObject_tag
 {
     sensorParam_t para_st;
     mijaProcl_parsedData_t data_st;
+    TickType_t lastSeen_st;     // tick count of the last advertisement
+    TickType_t lastPub_st;      // tick count of the last publication
+    bool dirty_bol;             // significant change since the last publication
+    bool published_bol;         // the published values below are valid
+    int16_t pubTemp_s16;        // values of the last publication
+    uint16_t pubHum_u16;
+    uint8_t pubBatt_u8;
+    uint8_t histValid_u8;       // values received, see HIST_xxx_VALID
+    sensHist_series_t hist_st;  // history and window aggregates
+    uint32_t aggPubEnd_u32a[sensHist_WIN_NUM];  // end of the last published window, 0: none
+    bool latValid_bol;          // time stamps of the oldest unpublished change are set
+    uint32_t rxUs_u32;          // reception of the oldest unpublished change
+    uint32_t dequeuedUs_u32;    // oldest unpublished change taken from the ring
 }sensorObject_t;
 
 typedef enum mqttState_tag
@@ -127,6 +191,81 @@ typedef struct scanParam_tag
     uint32_t cycle_u32;
 }scanParam_t;
 
+typedef struct filtParam_tag
+{
+    uint32_t knownOnly_u32;     // 1: scan known sensors only between discovery scans
+}filtParam_t;
+
+typedef enum pubMode_tag
+{
+    PUB_MODE_SINGLE     = 0,    // every sensor value is published on its own topic
+    PUB_MODE_COMPACT    = 1,    // all sensor values are published as one json document
+    PUB_MODE_AGGREGATE  = 2,    // aggregates of the last complete windows as json
+    PUB_MODE_MAX
+}pubMode_t;
+
+typedef struct pubParam_tag
+{
+    uint32_t pubMode_u32;
+}pubParam_t;
+
+/* deadbands of the change triggered publication, all 0: every new value is published */
+typedef struct deadbandParam_tag
+{
+    uint32_t temp_u32;          // 0.1 degree celsius
+    uint32_t hum_u32;           // 0.1 percent
+    uint32_t batt_u32;          // percent
+    uint32_t maxSilent_u32;     // seconds without publication, 0: no limit
+}deadbandParam_t;
+
+/* persistent entry of a known sensor */
+typedef struct registryEntry_tag
+{
+    uint8_t macAddr_u8a[mija_SIZE_MAC_ADDR];
+    char loc_cha[LOCATION_STRING_SIZE];
+    uint16_t pubIntv_u16;
+    uint16_t dbTemp_u16;
+    uint16_t dbHum_u16;
+    uint16_t dbBatt_u16;
+}registryEntry_t;
+
+/* sensor registry, stored as one blob, entries 0..count-1 are valid. The blob always
+   has room for REGISTRY_NVS_LIMIT entries, a changed sensor count keeps the blob. */
+typedef struct registryParam_tag
+{
+    uint8_t version_u8;
+    uint8_t count_u8;
+    uint16_t reserved_u16;
+    registryEntry_t entries_sta[REGISTRY_NVS_LIMIT];
+}registryParam_t;
+
+typedef enum registryCmd_tag
+{
+    REG_CMD_ADD,                // register a known sensor with optional location
+    REG_CMD_REMOVE,             // remove a sensor from the registry
+    REG_CMD_UPDATE,             // sensor settings changed
+    REG_CMD_SAVE,               // write pending changes without delay
+}registryCmd_t;
+
+typedef struct registryMsg_tag
+{
+    registryCmd_t cmd_en;
+    uint8_t macAddr_u8a[mija_SIZE_MAC_ADDR];
+    bool locValid_bol;
+    char loc_cha[LOCATION_STRING_SIZE];
+}registryMsg_t;
+
+typedef struct bindKey_tag
+{
+    uint8_t macAddr_u8a[mija_SIZE_MAC_ADDR];    // all zero: entry not used
+    uint8_t key_u8a[mija_SIZE_BINDKEY];
+}bindKey_t;
+
+typedef struct keyParam_tag
+{
+    bindKey_t keys_sta[mija_MAX_BINDKEYS];
+}keyParam_t;
+
 typedef struct moduleData_tag
 {
     mijasens_param_t param_st;
@@ -134,20 +273,47 @@ typedef struct moduleData_tag
     mqttState_t mqtt_en;
     mqttif_msg_t pubMsg_st;
     sensorObject_t sensors_sta[MAX_MIJA_SENSORS];
+    uint8_t usedSensors_u8;                 // sensor slots 0..used-1 are allocated
+    uint8_t schedIdx_u8;                    // last sensor slot visited by the scheduler
+    uint8_t macHash_u8a[MAC_HASH_SIZE];     // open addressing index mac -> sensor slot
     char subs_chap[MQTT_SUBSCRIPTIONS_NUM][mqttif_MAX_SIZE_OF_TOPIC];
     uint16_t subsCounter_u16;
     bleDrv_param_t blePara_st;
     EventGroupHandle_t eventGroup_st;
     TaskHandle_t task_xp;
-    QueueHandle_t queue_xp;
+    SemaphoreHandle_t sensMutex_st;         // sensor list and settings, task and console
+    rawRing_t ring_st;
     TimerHandle_t cycleTimer_st;
     paramif_objHdl_t scanParam_xp;
+    paramif_objHdl_t filtParam_xp;
+    pubMode_t pubMode_en;
+    paramif_objHdl_t pubParam_xp;
+    paramif_objHdl_t keyParam_xp;
+    paramif_objHdl_t dbParam_xp;
+    deadbandParam_t db_st;
+    uint32_t dbSuppressed_u32;              // samples without significant change
+    uint32_t published_u32;                 // sensor publications
+    paramif_objHdl_t regParam_xp;
+    registryParam_t reg_st;                 // ram image of the sensor registry
+    QueueHandle_t regQueue_st;              // registry changes, processed by the task
+    bool regDirty_bol;                      // registry changed since the last save
+    TickType_t regFirstChange_st;           // first unsaved change
+    TickType_t regLastChange_st;            // last unsaved change
+    uint32_t regSaves_u32;                  // registry writes to nvs
+    TickType_t latPub_st;                   // last latency statistics publication
+    TimerHandle_t replayTimer_st;
+    TickType_t replayStart_st;
+    uint32_t replayCnt_u32;
 }objectData_t;
 
 /****************************************************************************************/
 /* Local functions prototypes: */
 static esp_err_t LoadScanParameter_st(void); 
-//static esp_err_t LoadSensors_st(void);
+static esp_err_t LoadPublishParameter_st(void);
+static esp_err_t LoadBindKeys_st(void);
+static esp_err_t LoadDeadbandParameter_st(void);
+static esp_err_t LoadSensors_st(void);
+static void ApplyRegistry_vd(void);
 static void OnConnectionHandler_vd(void);
 static void OnDisconnectionHandler_vd(void);
 static esp_err_t OnSubsReceiveHandler_st(mqttif_msg_t *msg_stp);
@@ -162,13 +328,54 @@ static esp_err_t RegisterBleSettingsCommands_st(void);
 //static int32_t CmdHandlerBleSettings_s32(int32_t argc_s32, char** argv);
 static int32_t CmdHandlerBleSettings2_s32(int32_t argc_s32, char** argv, 
                                             FILE *retStream_xp);
+static esp_err_t RegisterBindKeyCommands_st(void);
+static int32_t CmdHandlerBindKey_s32(int32_t argc_s32, char** argv, FILE *retStream_xp);
+static esp_err_t RegisterHistoryCommands_st(void);
+static int32_t CmdHandlerHistory_s32(int32_t argc_s32, char** argv, FILE *retStream_xp);
+static esp_err_t RegisterDeadbandCommands_st(void);
+static int32_t CmdHandlerDeadband_s32(int32_t argc_s32, char** argv, FILE *retStream_xp);
+static esp_err_t RegisterRegistryCommands_st(void);
+static int32_t CmdHandlerRegistry_s32(int32_t argc_s32, char** argv, FILE *retStream_xp);
+static esp_err_t RegisterLatencyCommands_st(void);
+static int32_t CmdHandlerLatency_s32(int32_t argc_s32, char** argv, FILE *retStream_xp);
+static bool ParseHexString_bol(const char *hex_cchp, uint8_t *dest_u8p, uint8_t len_u8);
 
 static void PublishSensorData_vd(uint8_t sensIdx_u8);
 static void PublishSensorParam_vd(uint8_t sensIdx_u8);
-
-static void DriverCallback_vd(mijaProcl_parsedData_t *data_stp);
-static void HandleQueueEvent_vd(void);
+static void PublishSensorSnapshot_vd(uint8_t sensIdx_u8);
+static void EscapeJsonString_vd(const char *src_cchp, uint32_t srcLen_u32, char *dest_chp);
+static void PublishSensorAggregates_vd(uint8_t sensIdx_u8);
+static void StoreSensorSample_vd(uint8_t sensIdx_u8);
+static void PublishSensor_vd(uint8_t sensIdx_u8);
+static void OnPublishAcked_vd(uint32_t rxUs_u32, uint32_t queuedUs_u32, uint32_t ackUs_u32);
+static void PublishLatencyStats_vd(void);
+static void RunPublishScheduler_vd(void);
+static void StartReplay_vd(void);
+static void ReplaySamples_vd(void);
+
+static void ResetSensors_vd(void);
+static uint16_t HashMac_u16(const uint8_t *mac_cu8p);
+static uint8_t FindSensor_u8(const uint8_t *mac_cu8p);
+static uint8_t AllocSensor_u8(const uint8_t *mac_cu8p);
+static void IndexInsert_vd(uint8_t sensIdx_u8);
+static void IndexRemove_vd(uint8_t sensIdx_u8);
+
+static bool PostRegistryCmd_bol(registryCmd_t cmd_en, const uint8_t *mac_cu8p, 
+                                    const char *loc_cchp);
+static void HandleRegistryEvent_vd(void);
+static uint8_t FindRegistryEntry_u8(const uint8_t *mac_cu8p);
+static void StoreRegistryEntry_vd(uint8_t sensIdx_u8);
+static void RemoveRegistryEntry_vd(const uint8_t *mac_cu8p);
+static void SaveRegistry_vd(bool force_bol);
+
+static void DriverCallback_vd(const mijaProcl_rawSample_t *sample_cstp);
+static void HandleRingEvent_vd(void);
+static void ProcessSample_vd(const mijaProcl_parsedData_t *data_cstp, uint32_t rxUs_u32,
+                                uint32_t dequeuedUs_u32);
+static bool IsSignificantChange_bol(const sensorObject_t *sens_cstp);
+static bool DeadbandActive_bol(void);
 static void TimerCallback_vd(TimerHandle_t xTimer);
+static void ReplayTimerCallback_vd(TimerHandle_t xTimer);
 static void Task_vd(void *pvParameters);
 
 /****************************************************************************************/
@@ -180,6 +387,9 @@ static const int MQTT_CONNECT               = BIT0;
 static const int MQTT_DISCONNECT            = BIT1;
 static const int BLE_DATA_EVENT             = BIT2;
 static const int CYCLE_TIMER                = BIT3;
+static const int REPLAY_TIMER               = BIT4;
+static const int REGISTRY_EVENT             = BIT5;
+static const int SENSOR_RESET               = BIT6;
 
 static const char *TAG                      = MODULE_TAG;
 
@@ -193,6 +403,17 @@ static const char *MQTT_PUB_MSGCNT          = "mija/cnt";
 static const char *MQTT_PUB_ADDR            = "mija/addr";
 static const char *MQTT_PUB_LOC             = "mija/loc";
 static const char *MQTT_PUB_KNOW            = "mija/know";
+static const char *MQTT_PUB_SNAPSHOT        = "mija/state";
+static const char *MQTT_PUB_HISTORY         = "mija/hist";
+static const char *MQTT_PUB_AGGREGATE_CHPA[sensHist_WIN_NUM] = 
+{
+    "mija/agg1m", "mija/agg15m", "mija/agg1h"
+};
+static const char *MQTT_PUB_LATENCY_CHPA[latStat_STAGE_NUM] = 
+{
+    "mija/lat/parse", "mija/lat/queue", "mija/lat/sched", "mija/lat/publish", 
+    "mija/lat/ack", "mija/lat/total"
+};
 
 const subsHandle_t subsHandle_csta[MQTT_SUBSCRIPTIONS_NUM] = 
 {
@@ -206,19 +427,105 @@ static const scanParam_t SCAN_DEFAULT_PARA =
     .cycle_u32 = 20,
 };
 
+static const char *FILT_PARA_IDENT = "bleFilt";
+static const filtParam_t FILT_DEFAULT_PARA = 
+{
+    .knownOnly_u32 = 0U,
+};
+
+static const char *PUB_PARA_IDENT = "mijaPub";
+static const pubParam_t PUB_DEFAULT_PARA = 
+{
+    .pubMode_u32 = PUB_MODE_SINGLE,
+};
+
+static const char *KEY_PARA_IDENT = "mijaKeys";
+static const keyParam_t KEY_DEFAULT_PARA;     // no bindkeys
+
+static const char *REG_PARA_IDENT = "mijaReg";
+static const registryParam_t REG_DEFAULT_PARA = 
+{
+    .version_u8 = REGISTRY_VERSION,
+    .count_u8 = 0U,
+};
+
+static const char *DB_PARA_IDENT = "mijaDb";
+static const deadbandParam_t DB_DEFAULT_PARA = 
+{
+    .temp_u32 = 1U,
+    .hum_u32 = 10U,
+    .batt_u32 = 1U,
+    .maxSilent_u32 = 900U,
+};
+
+// advertisement formats decoded by the ble driver
+static const bleDrv_decoder_t decoders_scsa[] =
+{
+    {"mija",    bleDrv_AD_SERVICE_DATA, mija_SERVICE_UUID, 
+                mijaProcl_GetServiceFrameId_bol,    mijaProcl_DecodeServiceData_u8},
+    {"atc",     bleDrv_AD_SERVICE_DATA, atcProcl_SERVICE_UUID, 
+                atcProcl_GetFrameId_bol,            atcProcl_Decode_u8},
+    {"bthome",  bleDrv_AD_SERVICE_DATA, bthomeProcl_SERVICE_UUID, 
+                bthomeProcl_GetFrameId_bol,         bthomeProcl_Decode_u8},
+};
+
 static struct
 {
     struct arg_lit *read_stp;
     struct arg_lit *write_stp;
     struct arg_int *scanDur_stp;
     struct arg_int *scanCycle_stp;
+    struct arg_int *pubMode_stp;
+    struct arg_int *sensor_stp;
+    struct arg_int *pubIntv_stp;
+    struct arg_int *filter_stp;
     struct arg_end *end_stp;
 }cmdBleScan_sts;
 
-static const uint8_t TEST_SENSOR_0[mija_SIZE_MAC_ADDR] = {0x58,0x2D,0x34,0x37,0x10,0x86};
-static const char *TEST_LOC_0 = "Badezimmer oben";
-static const uint8_t TEST_SENSOR_1[mija_SIZE_MAC_ADDR] = {0x58,0x2D,0x34,0x38,0x64,0x37};
-static const char *TEST_LOC_1 = "Badezimmer unten";
+static struct
+{
+    struct arg_lit *read_stp;
+    struct arg_lit *delete_stp;
+    struct arg_str *mac_stp;
+    struct arg_str *key_stp;
+    struct arg_end *end_stp;
+}cmdBindKey_sts;
+
+static struct
+{
+    struct arg_int *sensor_stp;
+    struct arg_end *end_stp;
+}cmdHistory_sts;
+
+static struct
+{
+    struct arg_lit *read_stp;
+    struct arg_lit *write_stp;
+    struct arg_int *sensor_stp;
+    struct arg_int *temp_stp;
+    struct arg_int *hum_stp;
+    struct arg_int *batt_stp;
+    struct arg_int *silent_stp;
+    struct arg_end *end_stp;
+}cmdDeadband_sts;
+
+static struct
+{
+    struct arg_lit *read_stp;
+    struct arg_str *add_stp;
+    struct arg_str *remove_stp;
+    struct arg_str *loc_stp;
+    struct arg_lit *save_stp;
+    struct arg_end *end_stp;
+}cmdRegistry_sts;
+
+static struct
+{
+    struct arg_lit *read_stp;
+    struct arg_lit *clear_stp;
+    struct arg_int *stage_stp;
+    struct arg_end *end_stp;
+}cmdLatency_sts;
 
 /****************************************************************************************/
 /* Global functions (unlimited visibility) */
@@ -259,6 +566,7 @@ esp_err_t mijasens_Initialize_st(mijasens_param_t *param_stp)
     esp_err_t result_st = ESP_FAIL;
     bool exeResult_bol = true;
     bleDrv_param_t params_st;
+    uint8_t sensIdx_u8;
 
 
     ESP_LOGD(TAG, "initialization started...");
@@ -274,25 +582,48 @@ esp_err_t mijasens_Initialize_st(mijasens_param_t *param_stp)
         this_sst.pubMsg_st.data_chp = malloc(mqttif_MAX_SIZE_OF_DATA * sizeof(char));
         this_sst.pubMsg_st.qos_s32 = 1;
         this_sst.pubMsg_st.retain_s32 = 0;
+        this_sst.pubMsg_st.rxUs_u32 = 0U;
+        this_sst.pubMsg_st.acked_fp = NULL;
         this_sst.mqtt_en = MQTT_STATE_DISCONNECTED;
 
-        // hard coding the first two available sensors to address 0 and 1
-        memcpy(&this_sst.sensors_sta[0].para_st.macAddr_u8a[0], &TEST_SENSOR_0[0], sizeof(TEST_SENSOR_0));
-        memcpy(&this_sst.sensors_sta[0].para_st.loc_cha[0], TEST_LOC_0, strlen(TEST_LOC_0));
-        this_sst.sensors_sta[0].para_st.knownSens_u8 = 1U;
-
-        memcpy(&this_sst.sensors_sta[1].para_st.macAddr_u8a[0], &TEST_SENSOR_1[0], sizeof(TEST_SENSOR_1));
-        memcpy(&this_sst.sensors_sta[1].para_st.loc_cha[0], TEST_LOC_1, strlen(TEST_LOC_1));
-        this_sst.sensors_sta[1].para_st.knownSens_u8 = 1U;
+        ResetSensors_vd();
 
+        this_sst.regQueue_st = xQueueCreate(REGISTRY_QUEUE_SIZE, sizeof(registryMsg_t));
+        exeResult_bol &= (NULL != this_sst.regQueue_st);
+        this_sst.sensMutex_st = xSemaphoreCreateMutex();
+        exeResult_bol &= (NULL != this_sst.sensMutex_st);
+        exeResult_bol &= CHECK_EXE(LoadSensors_st());
         exeResult_bol &= CHECK_EXE(LoadScanParameter_st());
+        exeResult_bol &= CHECK_EXE(LoadPublishParameter_st());
+        exeResult_bol &= CHECK_EXE(LoadBindKeys_st());
+        exeResult_bol &= CHECK_EXE(LoadDeadbandParameter_st());
         exeResult_bol &= CHECK_EXE(bleDrv_InitializeParameter_st(&params_st));
 	    params_st.cycleTimeInSec_u32 = this_sst.blePara_st.cycleTimeInSec_u32;
 	    params_st.scanDurationInSec_u32 = this_sst.blePara_st.scanDurationInSec_u32;
 	    params_st.dataCb_fp = DriverCallback_vd;
+	    params_st.knownOnly_bol = this_sst.blePara_st.knownOnly_bol;
+        for(uint8_t decIdx_u8 = 0U; 
+            decIdx_u8 < (sizeof(decoders_scsa) / sizeof(decoders_scsa[0])); decIdx_u8++)
+        {
+            exeResult_bol &= CHECK_EXE(bleDrv_RegisterDecoder_st(&decoders_scsa[decIdx_u8]));
+        }
 	    exeResult_bol &= CHECK_EXE(bleDrv_Initialize_st(&params_st));
+        for(sensIdx_u8 = 0U; sensIdx_u8 < this_sst.usedSensors_u8; sensIdx_u8++)
+        {
+            if(0U != this_sst.sensors_sta[sensIdx_u8].para_st.knownSens_u8)
+            {
+                exeResult_bol &= CHECK_EXE(bleDrv_SetKnownDevice_st(
+                                    &this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[0],
+                                    true));
+            }
+        }
 
         exeResult_bol &= CHECK_EXE(RegisterBleSettingsCommands_st());
+        exeResult_bol &= CHECK_EXE(RegisterBindKeyCommands_st());
+        exeResult_bol &= CHECK_EXE(RegisterHistoryCommands_st());
+        exeResult_bol &= CHECK_EXE(RegisterDeadbandCommands_st());
+        exeResult_bol &= CHECK_EXE(RegisterRegistryCommands_st());
+        exeResult_bol &= CHECK_EXE(RegisterLatencyCommands_st());
 
         this_sst.eventGroup_st = xEventGroupCreate();
         exeResult_bol &= (NULL != this_sst.eventGroup_st);
@@ -301,12 +632,14 @@ esp_err_t mijasens_Initialize_st(mijasens_param_t *param_stp)
                                         TASK_PRIORITY, &this_sst.task_xp);
         exeResult_bol &= (NULL != this_sst.task_xp);
 
-        this_sst.cycleTimer_st = xTimerCreate("Timer", pdMS_TO_TICKS(20000), true,
+        this_sst.cycleTimer_st = xTimerCreate("Timer", pdMS_TO_TICKS(SCHED_TICK_MS), true,
                                                 (void *) 0, TimerCallback_vd);
         exeResult_bol &= (NULL != this_sst.cycleTimer_st);
 
-        this_sst.queue_xp = xQueueCreate(QUEUE_ELEMENTS, sizeof(mijaProcl_parsedData_t));
-        exeResult_bol &= (NULL != this_sst.queue_xp);
+        exeResult_bol &= CHECK_EXE(sampleBuf_Initialize_td());
+        this_sst.replayTimer_st = xTimerCreate("Replay", pdMS_TO_TICKS(REPLAY_PERIOD_MS),
+                                                true, (void *) 0, ReplayTimerCallback_vd);
+        exeResult_bol &= (NULL != this_sst.replayTimer_st);
     }
     else
     {
@@ -343,6 +676,7 @@ extern bool mijasens_GetSubscriptionByIndex_bol(uint16_t idx_u16,
         dest_stp->discon_fp = OnDisconnectionHandler_vd;
         dest_stp->dataRecv_fp = subsHandle_csta[idx_u16].OnReceiveCb_fcp;
         dest_stp->qos_u32 = 0;
+        dest_stp->token_u32 = idx_u16;
 
         memset(&dest_stp->topic_u8a[0], 0U, sizeof(dest_stp->topic_u8a));
         utils_BuildReceiveTopic_chp(this_sst.param_st.deviceName_chp, 
@@ -443,6 +777,15 @@ static esp_err_t RegisterBleSettingsCommands_st(void)
     cmdBleScan_sts.write_stp = arg_lit0("w", "write", "Command to write the ble settings");
     cmdBleScan_sts.scanCycle_stp = arg_int0("c", "cycle", "<s>", "Cycle time in seconds");
     cmdBleScan_sts.scanDur_stp = arg_int0("s", "scan", "<s>", "Scan duration in seconds");
+    cmdBleScan_sts.pubMode_stp = arg_int0("m", "mode", "<m>", 
+                                    "Publish mode, 0: topic per value, 1: json per sensor, "
+                                    "2: window aggregates");
+    cmdBleScan_sts.sensor_stp = arg_int0("x", "sensor", "<idx>", 
+                                    "Sensor slot for the publish interval");
+    cmdBleScan_sts.pubIntv_stp = arg_int0("i", "interval", "<s>", 
+                                    "Publish interval of the sensor in seconds, 0: default");
+    cmdBleScan_sts.filter_stp = arg_int0("f", "filter", "<0|1>", 
+                                    "1: scan known sensors only between discovery scans");
     cmdBleScan_sts.end_stp = arg_end(2);
 
     exeResult_bol = CHECK_EXE(myConsole_CmdInit_td(&paramCmd));
@@ -464,403 +807,2287 @@ static esp_err_t RegisterBleSettingsCommands_st(void)
     
 }
 
-/**--------------------------------------------------------------------------------------
- * @brief     Handler for console command bluetooth settings
+/**---------------------------------------------------------------------------------------
+ * @brief     Register the bindkey console commands
  * @author    S. Wink
- * @date      17. Feb. 2020
- * @param     argc_s32  count of argument list
- * @param     argv      pointer to argument list
- * @return    not equal to zero if error detected
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the command was registered, else ESP_FAIL
 *//*-----------------------------------------------------------------------------------*/
-/*static int32_t CmdHandlerBleSettings_s32(int32_t argc_s32, char** argv)
+static esp_err_t RegisterBindKeyCommands_st(void)
 {
-    int32_t retValue_s32 = 1;
-    scanParam_t para_st;
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    myConsole_cmd_t paramCmd;
 
-    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdBleScan_sts);
+    cmdBindKey_sts.read_stp = arg_lit0("r", "read", "List the sensors with a bindkey");
+    cmdBindKey_sts.delete_stp = arg_lit0("d", "delete", "Delete the bindkey of the sensor");
+    cmdBindKey_sts.mac_stp = arg_str0("m", "mac", "<mac>", 
+                                    "Sensor mac address, e.g. A4:C1:38:00:11:22");
+    cmdBindKey_sts.key_stp = arg_str0("k", "key", "<hex>", "Bindkey, 32 hex characters");
+    cmdBindKey_sts.end_stp = arg_end(2);
 
-    if(0 == nerrors_s32) 
-    { 
-        ESP_LOGI(TAG, "new ble settings command received: -r=%d, -w=%d, cycle=%d, scan=%d", 
-                            cmdBleScan_sts.read_stp->count, 
-                            cmdBleScan_sts.write_stp->count,
-                            *cmdBleScan_sts.scanCycle_stp->ival,
-                            *cmdBleScan_sts.scanDur_stp->ival);
+    exeResult_bol = CHECK_EXE(myConsole_CmdInit_td(&paramCmd));
+    
+    paramCmd.command = "bleKey";
+    paramCmd.help = "Bindkeys of encrypted sensors";
+    paramCmd.hint = NULL;
+    paramCmd.func2 = &CmdHandlerBindKey_s32;
+    paramCmd.argtable = &cmdBindKey_sts;
 
-        if(0U != cmdBleScan_sts.read_stp->count)
-        {
-            // read command
-            printf("cycle time %d secs, scan duration %d secs", 
-                            this_sst.blePara_st.cycleTimeInSec_u32, 
-                            this_sst.blePara_st.scanDurationInSec_u32);
-            retValue_s32 = 0;
-        }
-        else if(0 != cmdBleScan_sts.write_stp->count)
-        {
-            // write command
-            this_sst.blePara_st.cycleTimeInSec_u32 = *cmdBleScan_sts.scanCycle_stp->ival;
-            this_sst.blePara_st.scanDurationInSec_u32 = *cmdBleScan_sts.scanDur_stp->ival;
-            para_st.cycle_u32 = this_sst.blePara_st.cycleTimeInSec_u32;
-            para_st.scanDur_u32 = this_sst.blePara_st.scanDurationInSec_u32;
-            CHECK_EXE(paramif_Write_td(this_sst.scanParam_xp, (uint8_t *) &para_st));
-            ESP_LOGI(TAG, "new cycle time %d secs, scan duration %d secs received and stored", 
-                            this_sst.blePara_st.cycleTimeInSec_u32, 
-                            this_sst.blePara_st.scanDurationInSec_u32);
-            retValue_s32 = 0;
-        }
-        else
-        {
-            retValue_s32 = 1;
-        }      
-    }
-    else
+    exeResult_bol &= CHECK_EXE(myConsole_CmdRegister_td(&paramCmd));
+
+    if(false == exeResult_bol)
     {
-        arg_print_errors(stderr, cmdBleScan_sts.end_stp, argv[0]);
-        retValue_s32 = 1;
+        result_st = ESP_FAIL;
     }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Register the latency statistics console command
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the command was registered, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t RegisterLatencyCommands_st(void)
+{
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    myConsole_cmd_t paramCmd;
+
+    cmdLatency_sts.read_stp = arg_lit0("r", "read", "Print the latency of all stages");
+    cmdLatency_sts.clear_stp = arg_lit0("c", "clear", "Clear the latency histograms");
+    cmdLatency_sts.stage_stp = arg_int0("x", "stage", "<idx>", 
+                                    "Print the histogram buckets of a stage");
+    cmdLatency_sts.end_stp = arg_end(2);
+
+    exeResult_bol = CHECK_EXE(myConsole_CmdInit_td(&paramCmd));
     
-    return(retValue_s32);
-}*/
+    paramCmd.command = "bleLat";
+    paramCmd.help = "Latency from ble reception to mqtt acknowledge in us";
+    paramCmd.hint = NULL;
+    paramCmd.func2 = &CmdHandlerLatency_s32;
+    paramCmd.argtable = &cmdLatency_sts;
 
-/**--------------------------------------------------------------------------------------
- * @brief     Handler for console command bluetooth settings
+    exeResult_bol &= CHECK_EXE(myConsole_CmdRegister_td(&paramCmd));
+
+    if(false == exeResult_bol)
+    {
+        result_st = ESP_FAIL;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Handler for the latency statistics console command
  * @author    S. Wink
- * @date      17. Feb. 2020
- * @param     argc_s32      count of argument list
- * @param     argv          pointer to argument list
- * @param     retStream_xp  return stream for output data to the user
- * @return    not equal to zero if error detected
+ * @date      17. Oct. 2026
+ * @param     argc_s32        number of arguments
+ * @param     argv            arguments
+ * @param     retStream_xp    output stream of the console
+ * @return    0 if the command was executed, else 1
 *//*-----------------------------------------------------------------------------------*/
-static int32_t CmdHandlerBleSettings2_s32(int32_t argc_s32, char** argv, 
-                                            FILE *retStream_xp)
+static int32_t CmdHandlerLatency_s32(int32_t argc_s32, char** argv, FILE *retStream_xp)
 {
     int32_t retValue_s32 = 1;
-    scanParam_t para_st;
-
-    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdBleScan_sts);
+    latStat_hist_t hist_st;
 
-    if(0 == nerrors_s32) 
-    { 
-        ESP_LOGI(TAG, "new ble settings command received: -r=%d, -w=%d, cycle=%d, scan=%d", 
-                            cmdBleScan_sts.read_stp->count, 
-                            cmdBleScan_sts.write_stp->count,
-                            *cmdBleScan_sts.scanCycle_stp->ival,
-                            *cmdBleScan_sts.scanDur_stp->ival);
+    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdLatency_sts);
 
-        if(0U != cmdBleScan_sts.read_stp->count)
-        {
-            // read command
-            fprintf(retStream_xp,"cycle time %d secs, scan duration %d secs", 
-                            this_sst.blePara_st.cycleTimeInSec_u32, 
-                            this_sst.blePara_st.scanDurationInSec_u32);
-            fprintf(retStream_xp,"\n");
-            fflush(retStream_xp);
-            retValue_s32 = 0;
-        }
-        else if(0 != cmdBleScan_sts.write_stp->count)
+    if(0 != nerrors_s32)
+    {
+        arg_print_errors(stderr, cmdLatency_sts.end_stp, argv[0]);
+    }
+    else if(0 != cmdLatency_sts.read_stp->count)
+    {
+        for(uint8_t stage_u8 = 0U; stage_u8 < latStat_STAGE_NUM; stage_u8++)
         {
-            // write command
-            this_sst.blePara_st.cycleTimeInSec_u32 = *cmdBleScan_sts.scanCycle_stp->ival;
-            this_sst.blePara_st.scanDurationInSec_u32 = *cmdBleScan_sts.scanDur_stp->ival;
-            para_st.cycle_u32 = this_sst.blePara_st.cycleTimeInSec_u32;
-            para_st.scanDur_u32 = this_sst.blePara_st.scanDurationInSec_u32;
-            CHECK_EXE(paramif_Write_td(this_sst.scanParam_xp, (uint8_t *) &para_st));
-            ESP_LOGI(TAG, "new cycle time %d secs, scan duration %d secs received and stored", 
-                            this_sst.blePara_st.cycleTimeInSec_u32, 
-                            this_sst.blePara_st.scanDurationInSec_u32);
-            retValue_s32 = 0;
+            latStat_GetHistogram_bol((latStat_stage_t)stage_u8, &hist_st);
+            fprintf(retStream_xp,"%d %-8s n %u, avg %u, p50 %u, p90 %u, p99 %u, max %u\n",
+                        stage_u8, latStat_GetStageName_cchp((latStat_stage_t)stage_u8),
+                        hist_st.count_u32,
+                        (0U < hist_st.count_u32) ? 
+                            (uint32_t)(hist_st.sum_u64 / hist_st.count_u32) : 0U,
+                        latStat_GetPercentile_u32(&hist_st, 500U),
+                        latStat_GetPercentile_u32(&hist_st, 900U),
+                        latStat_GetPercentile_u32(&hist_st, 990U),
+                        hist_st.max_u32);
         }
-        else
-        {
-            retValue_s32 = 1;
-        }      
+        fflush(retStream_xp);
+        retValue_s32 = 0;
     }
-    else
+    else if(0 != cmdLatency_sts.clear_stp->count)
     {
-        arg_print_errors(stderr, cmdBleScan_sts.end_stp, argv[0]);
-        retValue_s32 = 1;
+        latStat_Reset_vd();
+        retValue_s32 = 0;
+    }
+    else if(   (0 != cmdLatency_sts.stage_stp->count)
+            && (true == latStat_GetHistogram_bol(
+                            (latStat_stage_t)*cmdLatency_sts.stage_stp->ival, &hist_st)))
+    {
+        for(uint8_t bucket_u8 = 0U; bucket_u8 < latStat_BUCKETS; bucket_u8++)
+        {
+            if(0U < hist_st.buckets_u32a[bucket_u8])
+            {
+                fprintf(retStream_xp,">= %u us: %u\n", 
+                            (0U == bucket_u8) ? 0U : (1U << bucket_u8), 
+                            hist_st.buckets_u32a[bucket_u8]);
+            }
+        }
+        fflush(retStream_xp);
+        retValue_s32 = 0;
     }
     
     return(retValue_s32);
 }
 
-/**--------------------------------------------------------------------------------------
- * @brief     Load the scan parameter from the nvmem
+/**---------------------------------------------------------------------------------------
+ * @brief     Register the sensor registry console command
  * @author    S. Wink
- * @date      01. Feb. 2020
- * @return    ESP_OK if successful, else ESP_FAIL
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the command was registered, else ESP_FAIL
 *//*-----------------------------------------------------------------------------------*/
-static esp_err_t LoadScanParameter_st(void)
+static esp_err_t RegisterRegistryCommands_st(void)
 {
     bool exeResult_bol = true;
     esp_err_t result_st = ESP_OK;
-    paramif_allocParam_t deviceAllocParam_st;
-    scanParam_t para_st;
+    myConsole_cmd_t paramCmd;
 
+    cmdRegistry_sts.read_stp = arg_lit0("r", "read", "List the registered sensors");
+    cmdRegistry_sts.add_stp = arg_str0("a", "add", "<mac>", 
+                                    "Register a known sensor, aa:bb:cc:dd:ee:ff");
+    cmdRegistry_sts.remove_stp = arg_str0("d", "delete", "<mac>", 
+                                    "Remove a sensor from the registry");
+    cmdRegistry_sts.loc_stp = arg_str0("l", "loc", "<location>", 
+                                    "Location of the registered sensor");
+    cmdRegistry_sts.save_stp = arg_lit0("s", "save", "Store pending changes now");
+    cmdRegistry_sts.end_stp = arg_end(2);
 
-    exeResult_bol &= CHECK_EXE(paramif_InitializeAllocParameter_td(
-                                                &deviceAllocParam_st));
-    deviceAllocParam_st.length_u16 = sizeof(scanParam_t);
-    deviceAllocParam_st.defaults_u8p = (uint8_t *)&SCAN_DEFAULT_PARA;
-    deviceAllocParam_st.nvsIdent_cp = SCAN_PARA_IDENT;
-    this_sst.scanParam_xp = paramif_Allocate_stp(&deviceAllocParam_st);
-    paramif_PrintHandle_vd(this_sst.scanParam_xp );
-    exeResult_bol &= CHECK_EXE(paramif_Read_td(this_sst.scanParam_xp, 
-                                                (uint8_t *) &para_st));
-    this_sst.blePara_st.cycleTimeInSec_u32 = para_st.cycle_u32;
-	this_sst.blePara_st.scanDurationInSec_u32 = para_st.scanDur_u32;
+    exeResult_bol = CHECK_EXE(myConsole_CmdInit_td(&paramCmd));
     
+    paramCmd.command = "bleReg";
+    paramCmd.help = "Registry of the known sensors";
+    paramCmd.hint = NULL;
+    paramCmd.func2 = &CmdHandlerRegistry_s32;
+    paramCmd.argtable = &cmdRegistry_sts;
+
+    exeResult_bol &= CHECK_EXE(myConsole_CmdRegister_td(&paramCmd));
+
     if(false == exeResult_bol)
     {
         result_st = ESP_FAIL;
     }
     return(result_st);
-
 }
 
 /**---------------------------------------------------------------------------------------
- * @brief     Handler when connected to mqtt broker
+ * @brief     Handler for the sensor registry console command. Changes are forwarded
+ *              to the task of the module which owns the sensor list.
  * @author    S. Wink
- * @date      01. Feb. 2020
- * @return    n/a
+ * @date      17. Oct. 2026
+ * @param     argc_s32        number of arguments
+ * @param     argv            arguments
+ * @param     retStream_xp    output stream of the console
+ * @return    0 if the command was executed, else 1
 *//*-----------------------------------------------------------------------------------*/
-static void OnConnectionHandler_vd(void)
+static int32_t CmdHandlerRegistry_s32(int32_t argc_s32, char** argv, FILE *retStream_xp)
 {
-    this_sst.mqtt_en = MQTT_STATE_CONNECTED;
-    xEventGroupSetBits(this_sst.eventGroup_st, MQTT_CONNECT);
-}
+    int32_t retValue_s32 = 1;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    const registryEntry_t *entry_cstp;
+    const char *mac_cchp = NULL;
+    registryCmd_t cmd_en = REG_CMD_SAVE;
 
-/**---------------------------------------------------------------------------------------
- * @brief     Handler when disconnected from mqtt broker
- * @author    S. Wink
+    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdRegistry_sts);
+
+    if(0 != nerrors_s32)
+    {
+        arg_print_errors(stderr, cmdRegistry_sts.end_stp, argv[0]);
+    }
+    else if(0 != cmdRegistry_sts.read_stp->count)
+    {
+        // the registry is changed by the mijasens task, changes are only posted
+        xSemaphoreTake(this_sst.sensMutex_st, portMAX_DELAY);
+        for(uint8_t regIdx_u8 = 0U; regIdx_u8 < this_sst.reg_st.count_u8; regIdx_u8++)
+        {
+            entry_cstp = &this_sst.reg_st.entries_sta[regIdx_u8];
+            fprintf(retStream_xp,"%02x:%02x:%02x:%02x:%02x:%02x %.*s, interval %d\n",
+                        entry_cstp->macAddr_u8a[0], entry_cstp->macAddr_u8a[1],
+                        entry_cstp->macAddr_u8a[2], entry_cstp->macAddr_u8a[3],
+                        entry_cstp->macAddr_u8a[4], entry_cstp->macAddr_u8a[5],
+                        (int)strnlen(entry_cstp->loc_cha, LOCATION_STRING_SIZE),
+                        entry_cstp->loc_cha, entry_cstp->pubIntv_u16);
+        }
+        fprintf(retStream_xp,"registered %d of %d, saves %d, unsaved changes %d\n",
+                    this_sst.reg_st.count_u8, REGISTRY_SIZE, this_sst.regSaves_u32, 
+                    this_sst.regDirty_bol);
+        xSemaphoreGive(this_sst.sensMutex_st);
+        fflush(retStream_xp);
+        retValue_s32 = 0;
+    }
+    else
+    {
+        if(0 != cmdRegistry_sts.add_stp->count)
+        {
+            mac_cchp = cmdRegistry_sts.add_stp->sval[0];
+            cmd_en = REG_CMD_ADD;
+        }
+        else if(0 != cmdRegistry_sts.remove_stp->count)
+        {
+            mac_cchp = cmdRegistry_sts.remove_stp->sval[0];
+            cmd_en = REG_CMD_REMOVE;
+        }
+
+        if(   (NULL != mac_cchp)
+           && (mija_SIZE_MAC_ADDR != sscanf(mac_cchp, "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+                                            &mac_u8a[0], &mac_u8a[1], &mac_u8a[2], 
+                                            &mac_u8a[3], &mac_u8a[4], &mac_u8a[5])))
+        {
+            fprintf(retStream_xp,"invalid mac address\n");
+            fflush(retStream_xp);
+        }
+        else if(   (0 != cmdRegistry_sts.loc_stp->count)
+                && ((LOCATION_STRING_SIZE - 1U) < strlen(cmdRegistry_sts.loc_stp->sval[0])))
+        {
+            fprintf(retStream_xp,"location too long, max %d characters\n", 
+                        LOCATION_STRING_SIZE - 1U);
+            fflush(retStream_xp);
+        }
+        else if(   ((NULL != mac_cchp) || (0 != cmdRegistry_sts.save_stp->count))
+                && (true == PostRegistryCmd_bol(cmd_en, mac_u8a,
+                                (0 != cmdRegistry_sts.loc_stp->count) ? 
+                                    cmdRegistry_sts.loc_stp->sval[0] : NULL)))
+        {
+            retValue_s32 = 0;
+        }
+    }
+    
+    return(retValue_s32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Register the deadband console command
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the command was registered, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t RegisterDeadbandCommands_st(void)
+{
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    myConsole_cmd_t paramCmd;
+
+    cmdDeadband_sts.read_stp = arg_lit0("r", "read", "Read the deadbands");
+    cmdDeadband_sts.write_stp = arg_lit0("w", "write", "Write the deadbands");
+    cmdDeadband_sts.sensor_stp = arg_int0("x", "sensor", "<idx>", 
+                                    "Sensor slot, without: default of all sensors");
+    cmdDeadband_sts.temp_stp = arg_int0("t", "temp", "<0.1C>", "Temperature deadband");
+    cmdDeadband_sts.hum_stp = arg_int0("u", "hum", "<0.1%>", "Humidity deadband");
+    cmdDeadband_sts.batt_stp = arg_int0("b", "batt", "<%>", "Battery deadband");
+    cmdDeadband_sts.silent_stp = arg_int0("s", "silent", "<s>", 
+                                    "Max. time without publication, 0: no limit");
+    cmdDeadband_sts.end_stp = arg_end(2);
+
+    exeResult_bol = CHECK_EXE(myConsole_CmdInit_td(&paramCmd));
+    
+    paramCmd.command = "bleDb";
+    paramCmd.help = "Deadbands of the change triggered publication";
+    paramCmd.hint = NULL;
+    paramCmd.func2 = &CmdHandlerDeadband_s32;
+    paramCmd.argtable = &cmdDeadband_sts;
+
+    exeResult_bol &= CHECK_EXE(myConsole_CmdRegister_td(&paramCmd));
+
+    if(false == exeResult_bol)
+    {
+        result_st = ESP_FAIL;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Handler for the deadband console command. Without sensor slot the 
+ *              defaults are changed and stored in the parameter memory, with sensor slot
+ *              the deadbands of the sensor are changed, 0 selects the default.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     argc_s32        number of arguments
+ * @param     argv            arguments
+ * @param     retStream_xp    output stream of the console
+ * @return    0 if the command was executed, else 1
+*//*-----------------------------------------------------------------------------------*/
+static int32_t CmdHandlerDeadband_s32(int32_t argc_s32, char** argv, FILE *retStream_xp)
+{
+    int32_t retValue_s32 = 1;
+    sensorParam_t *para_stp;
+    int32_t sensIdx_s32;
+
+    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdDeadband_sts);
+
+    // the deadbands and the sensor list are used by the mijasens task
+    xSemaphoreTake(this_sst.sensMutex_st, portMAX_DELAY);
+    if(0 != nerrors_s32)
+    {
+        arg_print_errors(stderr, cmdDeadband_sts.end_stp, argv[0]);
+    }
+    else if(0 != cmdDeadband_sts.read_stp->count)
+    {
+        fprintf(retStream_xp,"default: temp %d, hum %d, batt %d, max silent %d s\n",
+                    this_sst.db_st.temp_u32, this_sst.db_st.hum_u32, 
+                    this_sst.db_st.batt_u32, this_sst.db_st.maxSilent_u32);
+        for(uint8_t sensIdx_u8 = 0U; sensIdx_u8 < this_sst.usedSensors_u8; sensIdx_u8++)
+        {
+            para_stp = &this_sst.sensors_sta[sensIdx_u8].para_st;
+            fprintf(retStream_xp,"sensor %d: temp %d, hum %d, batt %d\n", sensIdx_u8,
+                        para_stp->dbTemp_u16, para_stp->dbHum_u16, para_stp->dbBatt_u16);
+        }
+        fprintf(retStream_xp,"published %d, suppressed %d\n", 
+                    this_sst.published_u32, this_sst.dbSuppressed_u32);
+        fflush(retStream_xp);
+        retValue_s32 = 0;
+    }
+    else if(0 != cmdDeadband_sts.write_stp->count)
+    {
+        if(0 == cmdDeadband_sts.sensor_stp->count)
+        {
+            if(0 != cmdDeadband_sts.temp_stp->count)
+            {
+                this_sst.db_st.temp_u32 = (uint32_t)*cmdDeadband_sts.temp_stp->ival;
+            }
+            if(0 != cmdDeadband_sts.hum_stp->count)
+            {
+                this_sst.db_st.hum_u32 = (uint32_t)*cmdDeadband_sts.hum_stp->ival;
+            }
+            if(0 != cmdDeadband_sts.batt_stp->count)
+            {
+                this_sst.db_st.batt_u32 = (uint32_t)*cmdDeadband_sts.batt_stp->ival;
+            }
+            if(0 != cmdDeadband_sts.silent_stp->count)
+            {
+                this_sst.db_st.maxSilent_u32 = (uint32_t)*cmdDeadband_sts.silent_stp->ival;
+            }
+            CHECK_EXE(paramif_Write_td(this_sst.dbParam_xp, (uint8_t *) &this_sst.db_st));
+            ESP_LOGI(TAG, "new default deadbands received and stored");
+            retValue_s32 = 0;
+        }
+        else
+        {
+            sensIdx_s32 = *cmdDeadband_sts.sensor_stp->ival;
+            if((0 <= sensIdx_s32) && (this_sst.usedSensors_u8 > sensIdx_s32))
+            {
+                para_stp = &this_sst.sensors_sta[sensIdx_s32].para_st;
+                if(0 != cmdDeadband_sts.temp_stp->count)
+                {
+                    para_stp->dbTemp_u16 = (uint16_t)*cmdDeadband_sts.temp_stp->ival;
+                }
+                if(0 != cmdDeadband_sts.hum_stp->count)
+                {
+                    para_stp->dbHum_u16 = (uint16_t)*cmdDeadband_sts.hum_stp->ival;
+                }
+                if(0 != cmdDeadband_sts.batt_stp->count)
+                {
+                    para_stp->dbBatt_u16 = (uint16_t)*cmdDeadband_sts.batt_stp->ival;
+                }
+                PostRegistryCmd_bol(REG_CMD_UPDATE, para_stp->macAddr_u8a, NULL);
+                ESP_LOGI(TAG, "new deadbands for sensor %d", sensIdx_s32);
+                retValue_s32 = 0;
+            }
+            else
+            {
+                fprintf(retStream_xp,"unsupported sensor\n");
+                fflush(retStream_xp);
+            }
+        }
+    }
+    xSemaphoreGive(this_sst.sensMutex_st);
+    
+    return(retValue_s32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Register the history console command
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the command was registered, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t RegisterHistoryCommands_st(void)
+{
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    myConsole_cmd_t paramCmd;
+
+    cmdHistory_sts.sensor_stp = arg_int1("x", "sensor", "<idx>", "Sensor slot");
+    cmdHistory_sts.end_stp = arg_end(2);
+
+    exeResult_bol = CHECK_EXE(myConsole_CmdInit_td(&paramCmd));
+    
+    paramCmd.command = "bleHist";
+    paramCmd.help = "Dump the value history and window aggregates of a sensor";
+    paramCmd.hint = NULL;
+    paramCmd.func2 = &CmdHandlerHistory_s32;
+    paramCmd.argtable = &cmdHistory_sts;
+
+    exeResult_bol &= CHECK_EXE(myConsole_CmdRegister_td(&paramCmd));
+
+    if(false == exeResult_bol)
+    {
+        result_st = ESP_FAIL;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Handler for the history console command, prints the samples of the
+ *              history oldest first followed by the aggregates of the last windows
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     argc_s32        number of arguments
+ * @param     argv            arguments
+ * @param     retStream_xp    output stream of the console
+ * @return    0 if the command was executed, else 1
+*//*-----------------------------------------------------------------------------------*/
+static int32_t CmdHandlerHistory_s32(int32_t argc_s32, char** argv, FILE *retStream_xp)
+{
+    int32_t retValue_s32 = 1;
+    sensHist_series_t *hist_stp;
+    sensHist_iter_t iter_st;
+    const sensHist_aggregate_t *agg_cstp;
+    char temp_cha[VALUE_STRING_SIZE];
+    char hum_cha[VALUE_STRING_SIZE];
+
+    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdHistory_sts);
+
+    // the history is written by the mijasens task, it waits during the dump
+    xSemaphoreTake(this_sst.sensMutex_st, portMAX_DELAY);
+    if(0 != nerrors_s32)
+    {
+        arg_print_errors(stderr, cmdHistory_sts.end_stp, argv[0]);
+    }
+    else if(   (0 > *cmdHistory_sts.sensor_stp->ival)
+            || (this_sst.usedSensors_u8 <= *cmdHistory_sts.sensor_stp->ival))
+    {
+        fprintf(retStream_xp,"unsupported sensor\n");
+        fflush(retStream_xp);
+    }
+    else
+    {
+        hist_stp = &this_sst.sensors_sta[*cmdHistory_sts.sensor_stp->ival].hist_st;
+        fprintf(retStream_xp,"%d samples, %d bytes\n", 
+                        hist_stp->samples_u16, hist_stp->used_u16);
+        sensHist_IterStart_vd(hist_stp, &iter_st);
+        while(true == sensHist_IterNext_bol(hist_stp, &iter_st))
+        {
+            utils_FixedPointToString_u32(iter_st.sample_st.value_s16a[sensHist_CH_TEMP], 
+                                            1U, temp_cha);
+            utils_FixedPointToString_u32(iter_st.sample_st.value_s16a[sensHist_CH_HUM], 
+                                            1U, hum_cha);
+            fprintf(retStream_xp,"%d s: temp %s, hum %s\n", 
+                        iter_st.sample_st.time_u32, temp_cha, hum_cha);
+        }
+        for(uint8_t win_u8 = 0U; win_u8 < sensHist_WIN_NUM; win_u8++)
+        {
+            agg_cstp = sensHist_GetAggregate_cstp(hist_stp, (sensHist_window_t)win_u8);
+            if(0U < agg_cstp->count_u32)
+            {
+                fprintf(retStream_xp,"window %d s from %d s, count %d, "
+                            "temp %d..%d avg %d, hum %d..%d avg %d (0.1 units)\n",
+                            sensHist_GetWindowLength_u32((sensHist_window_t)win_u8),
+                            agg_cstp->start_u32, agg_cstp->count_u32,
+                            agg_cstp->min_s16a[sensHist_CH_TEMP],
+                            agg_cstp->max_s16a[sensHist_CH_TEMP],
+                            agg_cstp->sum_s32a[sensHist_CH_TEMP] / (int32_t)agg_cstp->count_u32,
+                            agg_cstp->min_s16a[sensHist_CH_HUM],
+                            agg_cstp->max_s16a[sensHist_CH_HUM],
+                            agg_cstp->sum_s32a[sensHist_CH_HUM] / (int32_t)agg_cstp->count_u32);
+            }
+        }
+        fflush(retStream_xp);
+        retValue_s32 = 0;
+    }
+    xSemaphoreGive(this_sst.sensMutex_st);
+    
+    return(retValue_s32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Handler for the bindkey console command, the key is stored in the
+ *              parameter memory and activated without reboot
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     argc_s32        number of arguments
+ * @param     argv            arguments
+ * @param     retStream_xp    output stream of the console
+ * @return    0 if the command was executed, else 1
+*//*-----------------------------------------------------------------------------------*/
+static int32_t CmdHandlerBindKey_s32(int32_t argc_s32, char** argv, FILE *retStream_xp)
+{
+    int32_t retValue_s32 = 1;
+    keyParam_t para_st;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t key_u8a[mija_SIZE_BINDKEY];
+    const uint8_t noMac_cu8a[mija_SIZE_MAC_ADDR] = {0U};
+    uint8_t keyIdx_u8;
+    uint8_t freeIdx_u8 = mija_MAX_BINDKEYS;
+    bool macValid_bol = false;
+
+    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdBindKey_sts);
+
+    if(   (0 == nerrors_s32) 
+       && (ESP_OK == paramif_Read_td(this_sst.keyParam_xp, (uint8_t *) &para_st)))
+    { 
+        if(0 != cmdBindKey_sts.mac_stp->count)
+        {
+            macValid_bol = (mija_SIZE_MAC_ADDR == sscanf(cmdBindKey_sts.mac_stp->sval[0],
+                                    "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx",
+                                    &mac_u8a[0], &mac_u8a[1], &mac_u8a[2], 
+                                    &mac_u8a[3], &mac_u8a[4], &mac_u8a[5]));
+        }
+
+        // search the entry of the sensor and the first free entry
+        keyIdx_u8 = mija_MAX_BINDKEYS;
+        for(uint8_t idx_u8 = 0U; idx_u8 < mija_MAX_BINDKEYS; idx_u8++)
+        {
+            if(0 == memcmp(para_st.keys_sta[idx_u8].macAddr_u8a, noMac_cu8a, 
+                            mija_SIZE_MAC_ADDR))
+            {
+                freeIdx_u8 = (mija_MAX_BINDKEYS == freeIdx_u8) ? idx_u8 : freeIdx_u8;
+            }
+            else if(   (true == macValid_bol)
+                    && (0 == memcmp(para_st.keys_sta[idx_u8].macAddr_u8a, mac_u8a, 
+                                    mija_SIZE_MAC_ADDR)))
+            {
+                keyIdx_u8 = idx_u8;
+            }
+        }
+
+        if(0U != cmdBindKey_sts.read_stp->count)
+        {
+            // the keys itself are not shown
+            for(uint8_t idx_u8 = 0U; idx_u8 < mija_MAX_BINDKEYS; idx_u8++)
+            {
+                if(0 != memcmp(para_st.keys_sta[idx_u8].macAddr_u8a, noMac_cu8a, 
+                                mija_SIZE_MAC_ADDR))
+                {
+                    fprintf(retStream_xp,"%d: %02X:%02X:%02X:%02X:%02X:%02X\n", idx_u8,
+                            para_st.keys_sta[idx_u8].macAddr_u8a[0], 
+                            para_st.keys_sta[idx_u8].macAddr_u8a[1],
+                            para_st.keys_sta[idx_u8].macAddr_u8a[2], 
+                            para_st.keys_sta[idx_u8].macAddr_u8a[3],
+                            para_st.keys_sta[idx_u8].macAddr_u8a[4], 
+                            para_st.keys_sta[idx_u8].macAddr_u8a[5]);
+                }
+            }
+            retValue_s32 = 0;
+        }
+        else if((true == macValid_bol) && (0 != cmdBindKey_sts.delete_stp->count))
+        {
+            if(mija_MAX_BINDKEYS > keyIdx_u8)
+            {
+                memset(&para_st.keys_sta[keyIdx_u8], 0U, sizeof(bindKey_t));
+                mijaProcl_SetBindKey_bol(mac_u8a, NULL);
+                CHECK_EXE(paramif_Write_td(this_sst.keyParam_xp, (uint8_t *) &para_st));
+                retValue_s32 = 0;
+            }
+        }
+        else if(   (true == macValid_bol) && (0 != cmdBindKey_sts.key_stp->count)
+                && (true == ParseHexString_bol(cmdBindKey_sts.key_stp->sval[0], 
+                                                key_u8a, mija_SIZE_BINDKEY)))
+        {
+            keyIdx_u8 = (mija_MAX_BINDKEYS > keyIdx_u8) ? keyIdx_u8 : freeIdx_u8;
+            if(   (mija_MAX_BINDKEYS > keyIdx_u8) 
+               && (true == mijaProcl_SetBindKey_bol(mac_u8a, key_u8a)))
+            {
+                memcpy(para_st.keys_sta[keyIdx_u8].macAddr_u8a, mac_u8a, mija_SIZE_MAC_ADDR);
+                memcpy(para_st.keys_sta[keyIdx_u8].key_u8a, key_u8a, mija_SIZE_BINDKEY);
+                CHECK_EXE(paramif_Write_td(this_sst.keyParam_xp, (uint8_t *) &para_st));
+                ESP_LOGI(TAG, "new bindkey stored in entry %d", keyIdx_u8);
+                retValue_s32 = 0;
+            }
+        }
+        else
+        {
+            retValue_s32 = 1;
+        }
+
+        if(0 != retValue_s32)
+        {
+            fprintf(retStream_xp,"invalid mac address, bindkey or no free entry\n");
+        }
+        fflush(retStream_xp);
+        memset(key_u8a, 0U, sizeof(key_u8a));
+        memset(&para_st, 0U, sizeof(para_st));
+    }
+    else
+    {
+        arg_print_errors(stderr, cmdBindKey_sts.end_stp, argv[0]);
+        retValue_s32 = 1;
+    }
+    
+    return(retValue_s32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Converts a string of hex characters to bytes
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     hex_cchp      hex string, two characters per byte
+ * @param     dest_u8p      destination of the bytes
+ * @param     len_u8        number of bytes expected
+ * @return    true if the string has the expected length and only hex characters
+*//*-----------------------------------------------------------------------------------*/
+static bool ParseHexString_bol(const char *hex_cchp, uint8_t *dest_u8p, uint8_t len_u8)
+{
+    bool exeResult_bol = ((2U * len_u8) == strlen(hex_cchp));
+    uint8_t idx_u8 = 0U;
+
+    while((true == exeResult_bol) && (idx_u8 < len_u8))
+    {
+        exeResult_bol =    isxdigit((int)hex_cchp[2U * idx_u8]) 
+                        && isxdigit((int)hex_cchp[(2U * idx_u8) + 1U])
+                        && (1 == sscanf(&hex_cchp[2U * idx_u8], "%2hhx", &dest_u8p[idx_u8]));
+        idx_u8++;
+    }
+
+    return(exeResult_bol);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Handler for console command bluetooth settings
+ * @author    S. Wink
+ * @date      17. Feb. 2020
+ * @param     argc_s32  count of argument list
+ * @param     argv      pointer to argument list
+ * @return    not equal to zero if error detected
+*//*-----------------------------------------------------------------------------------*/
+/*static int32_t CmdHandlerBleSettings_s32(int32_t argc_s32, char** argv)
+{
+    int32_t retValue_s32 = 1;
+    scanParam_t para_st;
+
+    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdBleScan_sts);
+
+    if(0 == nerrors_s32) 
+    { 
+        ESP_LOGI(TAG, "new ble settings command received: -r=%d, -w=%d, cycle=%d, scan=%d", 
+                            cmdBleScan_sts.read_stp->count, 
+                            cmdBleScan_sts.write_stp->count,
+                            *cmdBleScan_sts.scanCycle_stp->ival,
+                            *cmdBleScan_sts.scanDur_stp->ival);
+
+        if(0U != cmdBleScan_sts.read_stp->count)
+        {
+            // read command
+            printf("cycle time %d secs, scan duration %d secs", 
+                            this_sst.blePara_st.cycleTimeInSec_u32, 
+                            this_sst.blePara_st.scanDurationInSec_u32);
+            retValue_s32 = 0;
+        }
+        else if(0 != cmdBleScan_sts.write_stp->count)
+        {
+            // write command
+            this_sst.blePara_st.cycleTimeInSec_u32 = *cmdBleScan_sts.scanCycle_stp->ival;
+            this_sst.blePara_st.scanDurationInSec_u32 = *cmdBleScan_sts.scanDur_stp->ival;
+            para_st.cycle_u32 = this_sst.blePara_st.cycleTimeInSec_u32;
+            para_st.scanDur_u32 = this_sst.blePara_st.scanDurationInSec_u32;
+            CHECK_EXE(paramif_Write_td(this_sst.scanParam_xp, (uint8_t *) &para_st));
+            ESP_LOGI(TAG, "new cycle time %d secs, scan duration %d secs received and stored", 
+                            this_sst.blePara_st.cycleTimeInSec_u32, 
+                            this_sst.blePara_st.scanDurationInSec_u32);
+            retValue_s32 = 0;
+        }
+        else
+        {
+            retValue_s32 = 1;
+        }      
+    }
+    else
+    {
+        arg_print_errors(stderr, cmdBleScan_sts.end_stp, argv[0]);
+        retValue_s32 = 1;
+    }
+    
+    return(retValue_s32);
+}*/
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Handler for console command bluetooth settings
+ * @author    S. Wink
+ * @date      17. Feb. 2020
+ * @param     argc_s32      count of argument list
+ * @param     argv          pointer to argument list
+ * @param     retStream_xp  return stream for output data to the user
+ * @return    not equal to zero if error detected
+*//*-----------------------------------------------------------------------------------*/
+static int32_t CmdHandlerBleSettings2_s32(int32_t argc_s32, char** argv, 
+                                            FILE *retStream_xp)
+{
+    int32_t retValue_s32 = 1;
+    scanParam_t para_st;
+    pubParam_t pubPara_st;
+    filtParam_t filtPara_st;
+    uint32_t unfilteredMs_u32;
+    bleDrv_frameStats_t frameStats_st;
+    bleDrv_scanStats_t scanStats_st;
+
+    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdBleScan_sts);
+
+    // the settings and the sensor list are used by the mijasens task
+    xSemaphoreTake(this_sst.sensMutex_st, portMAX_DELAY);
+    if(0 == nerrors_s32) 
+    { 
+        ESP_LOGI(TAG, "new ble settings command received: -r=%d, -w=%d, cycle=%d, scan=%d", 
+                            cmdBleScan_sts.read_stp->count, 
+                            cmdBleScan_sts.write_stp->count,
+                            *cmdBleScan_sts.scanCycle_stp->ival,
+                            *cmdBleScan_sts.scanDur_stp->ival);
+
+        if(0U != cmdBleScan_sts.read_stp->count)
+        {
+            // read command
+            fprintf(retStream_xp,"cycle time %d secs, scan duration %d secs, publish mode %d", 
+                            this_sst.blePara_st.cycleTimeInSec_u32, 
+                            this_sst.blePara_st.scanDurationInSec_u32,
+                            this_sst.pubMode_en);
+            fprintf(retStream_xp,"\n");
+            fprintf(retStream_xp,"ble samples received %d, dropped %d", 
+                            __atomic_load_n(&this_sst.ring_st.received_u32, __ATOMIC_RELAXED),
+                            __atomic_load_n(&this_sst.ring_st.dropped_u32, __ATOMIC_RELAXED));
+            fprintf(retStream_xp,"\n");
+            for(uint8_t sensIdx_u8 = 0U; sensIdx_u8 < this_sst.usedSensors_u8; sensIdx_u8++)
+            {
+                if(ESP_OK == bleDrv_GetFrameStats_st(
+                                &this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[0],
+                                &frameStats_st))
+                {
+                    fprintf(retStream_xp,"sensor %d frames %d, duplicates %d, missed %d, "
+                                "period %d ms\n",
+                                sensIdx_u8, frameStats_st.frames_u32, 
+                                frameStats_st.duplicates_u32, frameStats_st.missed_u32,
+                                frameStats_st.periodMs_u32);
+                }
+            }
+            if(ESP_OK == bleDrv_GetScanStats_st(&scanStats_st))
+            {
+                fprintf(retStream_xp,"scans %d, discovery %d, early stop %d, radio on %d ms\n",
+                            scanStats_st.scans_u32, scanStats_st.discovery_u32,
+                            scanStats_st.earlyStop_u32, scanStats_st.radioOnMs_u32);
+                // advertisement callbacks per second of scan time, without and with filter
+                unfilteredMs_u32 = scanStats_st.radioOnMs_u32 - scanStats_st.filteredMs_u32;
+                fprintf(retStream_xp,"known only %d, callbacks/s unfiltered %d, "
+                            "filtered %d\n",
+                            this_sst.blePara_st.knownOnly_bol,
+                            (0U != unfilteredMs_u32) ? 
+                                ((scanStats_st.callbacks_u32 * 1000U) / unfilteredMs_u32) : 0U,
+                            (0U != scanStats_st.filteredMs_u32) ? 
+                                ((scanStats_st.filteredCb_u32 * 1000U) 
+                                    / scanStats_st.filteredMs_u32) : 0U);
+            }
+            fflush(retStream_xp);
+            retValue_s32 = 0;
+        }
+        else if(0 != cmdBleScan_sts.write_stp->count)
+        {
+            // write command
+            retValue_s32 = 0;
+            if(   (0 != cmdBleScan_sts.scanCycle_stp->count)
+               || (0 != cmdBleScan_sts.scanDur_stp->count))
+            {
+                // an option which is not given keeps its current value
+                if(0 != cmdBleScan_sts.scanCycle_stp->count)
+                {
+                    this_sst.blePara_st.cycleTimeInSec_u32 = 
+                                                *cmdBleScan_sts.scanCycle_stp->ival;
+                }
+                if(0 != cmdBleScan_sts.scanDur_stp->count)
+                {
+                    this_sst.blePara_st.scanDurationInSec_u32 = 
+                                                *cmdBleScan_sts.scanDur_stp->ival;
+                }
+                para_st.cycle_u32 = this_sst.blePara_st.cycleTimeInSec_u32;
+                para_st.scanDur_u32 = this_sst.blePara_st.scanDurationInSec_u32;
+                CHECK_EXE(paramif_Write_td(this_sst.scanParam_xp, (uint8_t *) &para_st));
+                ESP_LOGI(TAG, "new cycle time %d secs, scan duration %d secs received and stored", 
+                                this_sst.blePara_st.cycleTimeInSec_u32, 
+                                this_sst.blePara_st.scanDurationInSec_u32);
+            }
+            if(   (0 != cmdBleScan_sts.sensor_stp->count)
+               && (0 != cmdBleScan_sts.pubIntv_stp->count))
+            {
+                if(   (this_sst.usedSensors_u8 > *cmdBleScan_sts.sensor_stp->ival)
+                   && (0 <= *cmdBleScan_sts.sensor_stp->ival)
+                   && (UINT16_MAX >= (uint32_t)*cmdBleScan_sts.pubIntv_stp->ival))
+                {
+                    this_sst.sensors_sta[*cmdBleScan_sts.sensor_stp->ival].para_st.pubIntv_u16
+                                = (uint16_t)*cmdBleScan_sts.pubIntv_stp->ival;
+                    PostRegistryCmd_bol(REG_CMD_UPDATE, 
+                        this_sst.sensors_sta[*cmdBleScan_sts.sensor_stp->ival].para_st.macAddr_u8a,
+                        NULL);
+                    ESP_LOGI(TAG, "new publish interval %d secs for sensor %d", 
+                                    *cmdBleScan_sts.pubIntv_stp->ival,
+                                    *cmdBleScan_sts.sensor_stp->ival);
+                }
+                else
+                {
+                    fprintf(retStream_xp,"unsupported sensor or interval\n");
+                    fflush(retStream_xp);
+                    retValue_s32 = 1;
+                }
+            }
+            if(0 != cmdBleScan_sts.pubMode_stp->count)
+            {
+                if(PUB_MODE_MAX > (uint32_t)*cmdBleScan_sts.pubMode_stp->ival)
+                {
+                    this_sst.pubMode_en = (pubMode_t)*cmdBleScan_sts.pubMode_stp->ival;
+                    pubPara_st.pubMode_u32 = this_sst.pubMode_en;
+                    CHECK_EXE(paramif_Write_td(this_sst.pubParam_xp, 
+                                                (uint8_t *) &pubPara_st));
+                    ESP_LOGI(TAG, "new publish mode %d received and stored", 
+                                    this_sst.pubMode_en);
+                }
+                else
+                {
+                    fprintf(retStream_xp,"unsupported publish mode\n");
+                    fflush(retStream_xp);
+                    retValue_s32 = 1;
+                }
+            }
+            if(0 != cmdBleScan_sts.filter_stp->count)
+            {
+                this_sst.blePara_st.knownOnly_bol = (0 != *cmdBleScan_sts.filter_stp->ival);
+                filtPara_st.knownOnly_u32 = this_sst.blePara_st.knownOnly_bol;
+                CHECK_EXE(paramif_Write_td(this_sst.filtParam_xp, (uint8_t *) &filtPara_st));
+                CHECK_EXE(bleDrv_SetKnownOnly_st(this_sst.blePara_st.knownOnly_bol));
+                ESP_LOGI(TAG, "new scan filter mode %d received and stored", 
+                                this_sst.blePara_st.knownOnly_bol);
+            }
+        }
+        else
+        {
+            retValue_s32 = 1;
+        }      
+    }
+    else
+    {
+        arg_print_errors(stderr, cmdBleScan_sts.end_stp, argv[0]);
+        retValue_s32 = 1;
+    }
+    xSemaphoreGive(this_sst.sensMutex_st);
+    
+    return(retValue_s32);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Load the scan parameter from the nvmem
+ * @author    S. Wink
+ * @date      01. Feb. 2020
+ * @return    ESP_OK if successful, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t LoadScanParameter_st(void)
+{
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    paramif_allocParam_t deviceAllocParam_st;
+    scanParam_t para_st;
+    filtParam_t filtPara_st;
+
+
+    exeResult_bol &= CHECK_EXE(paramif_InitializeAllocParameter_td(
+                                                &deviceAllocParam_st));
+    deviceAllocParam_st.length_u16 = sizeof(scanParam_t);
+    deviceAllocParam_st.defaults_u8p = (uint8_t *)&SCAN_DEFAULT_PARA;
+    deviceAllocParam_st.nvsIdent_cp = SCAN_PARA_IDENT;
+    this_sst.scanParam_xp = paramif_Allocate_stp(&deviceAllocParam_st);
+    paramif_PrintHandle_vd(this_sst.scanParam_xp );
+    exeResult_bol &= CHECK_EXE(paramif_Read_td(this_sst.scanParam_xp, 
+                                                (uint8_t *) &para_st));
+    this_sst.blePara_st.cycleTimeInSec_u32 = para_st.cycle_u32;
+	this_sst.blePara_st.scanDurationInSec_u32 = para_st.scanDur_u32;
+
+    exeResult_bol &= CHECK_EXE(paramif_InitializeAllocParameter_td(
+                                                &deviceAllocParam_st));
+    deviceAllocParam_st.length_u16 = sizeof(filtParam_t);
+    deviceAllocParam_st.defaults_u8p = (uint8_t *)&FILT_DEFAULT_PARA;
+    deviceAllocParam_st.nvsIdent_cp = FILT_PARA_IDENT;
+    this_sst.filtParam_xp = paramif_Allocate_stp(&deviceAllocParam_st);
+    exeResult_bol &= CHECK_EXE(paramif_Read_td(this_sst.filtParam_xp, 
+                                                (uint8_t *) &filtPara_st));
+    this_sst.blePara_st.knownOnly_bol = (0U != filtPara_st.knownOnly_u32);
+    
+    if(false == exeResult_bol)
+    {
+        result_st = ESP_FAIL;
+    }
+    return(result_st);
+
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Load the publish parameter from the nvmem
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @return    ESP_OK if successful, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t LoadPublishParameter_st(void)
+{
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    paramif_allocParam_t allocParam_st;
+    pubParam_t para_st;
+
+    exeResult_bol &= CHECK_EXE(paramif_InitializeAllocParameter_td(&allocParam_st));
+    allocParam_st.length_u16 = sizeof(pubParam_t);
+    allocParam_st.defaults_u8p = (uint8_t *)&PUB_DEFAULT_PARA;
+    allocParam_st.nvsIdent_cp = PUB_PARA_IDENT;
+    this_sst.pubParam_xp = paramif_Allocate_stp(&allocParam_st);
+    exeResult_bol &= CHECK_EXE(paramif_Read_td(this_sst.pubParam_xp, 
+                                                (uint8_t *) &para_st));
+    this_sst.pubMode_en = PUB_MODE_SINGLE;
+    if((true == exeResult_bol) && (PUB_MODE_MAX > para_st.pubMode_u32))
+    {
+        this_sst.pubMode_en = (pubMode_t)para_st.pubMode_u32;
+    }
+
+    if(false == exeResult_bol)
+    {
+        result_st = ESP_FAIL;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Loads the bindkeys of encrypted sensors and hands them to the protocol
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the keys were loaded, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t LoadBindKeys_st(void)
+{
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    paramif_allocParam_t allocParam_st;
+    keyParam_t para_st;
+    const uint8_t noMac_cu8a[mija_SIZE_MAC_ADDR] = {0U};
+
+    exeResult_bol &= CHECK_EXE(paramif_InitializeAllocParameter_td(&allocParam_st));
+    allocParam_st.length_u16 = sizeof(keyParam_t);
+    allocParam_st.defaults_u8p = (uint8_t *)&KEY_DEFAULT_PARA;
+    allocParam_st.nvsIdent_cp = KEY_PARA_IDENT;
+    this_sst.keyParam_xp = paramif_Allocate_stp(&allocParam_st);
+    exeResult_bol &= CHECK_EXE(paramif_Read_td(this_sst.keyParam_xp, 
+                                                (uint8_t *) &para_st));
+
+    for(uint8_t keyIdx_u8 = 0U; (true == exeResult_bol) && (mija_MAX_BINDKEYS > keyIdx_u8);
+        keyIdx_u8++)
+    {
+        if(0 != memcmp(para_st.keys_sta[keyIdx_u8].macAddr_u8a, noMac_cu8a, 
+                        mija_SIZE_MAC_ADDR))
+        {
+            exeResult_bol &= mijaProcl_SetBindKey_bol(para_st.keys_sta[keyIdx_u8].macAddr_u8a,
+                                                para_st.keys_sta[keyIdx_u8].key_u8a);
+        }
+    }
+
+    if(false == exeResult_bol)
+    {
+        result_st = ESP_FAIL;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Load the sensor registry with one read and allocate the known sensors. A
+ *              registry with unknown layout is replaced by an empty registry.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if successful, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t LoadSensors_st(void)
+{
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    paramif_allocParam_t allocParam_st;
+
+    exeResult_bol &= CHECK_EXE(paramif_InitializeAllocParameter_td(&allocParam_st));
+    allocParam_st.length_u16 = sizeof(registryParam_t);
+    allocParam_st.defaults_u8p = (uint8_t *)&REG_DEFAULT_PARA;
+    allocParam_st.nvsIdent_cp = REG_PARA_IDENT;
+    this_sst.regParam_xp = paramif_Allocate_stp(&allocParam_st);
+    exeResult_bol &= CHECK_EXE(paramif_Read_td(this_sst.regParam_xp, 
+                                                (uint8_t *) &this_sst.reg_st));
+
+    if(   (false == exeResult_bol)
+       || (REGISTRY_VERSION != this_sst.reg_st.version_u8)
+       || (REGISTRY_NVS_LIMIT < this_sst.reg_st.count_u8))
+    {
+        ESP_LOGW(TAG, "sensor registry invalid, starting with empty registry");
+        memcpy(&this_sst.reg_st, &REG_DEFAULT_PARA, sizeof(registryParam_t));
+    }
+    else if(REGISTRY_SIZE < this_sst.reg_st.count_u8)
+    {
+        // the number of sensors was reduced, the first entries are kept
+        ESP_LOGW(TAG, "sensor registry truncated to %d entries", REGISTRY_SIZE);
+        memset(&this_sst.reg_st.entries_sta[REGISTRY_SIZE], 0U, 
+                (this_sst.reg_st.count_u8 - REGISTRY_SIZE) * sizeof(registryEntry_t));
+        this_sst.reg_st.count_u8 = REGISTRY_SIZE;
+        this_sst.regFirstChange_st = xTaskGetTickCount();
+        this_sst.regLastChange_st = this_sst.regFirstChange_st;
+        this_sst.regDirty_bol = true;
+    }
+
+    ApplyRegistry_vd();
+    ESP_LOGI(TAG, "%d sensors loaded from the registry", this_sst.reg_st.count_u8);
+
+    if(false == exeResult_bol)
+    {
+        result_st = ESP_FAIL;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Allocates a sensor slot for every registry entry and copies its settings
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void ApplyRegistry_vd(void)
+{
+    const registryEntry_t *entry_cstp;
+    sensorParam_t *para_stp;
+    uint8_t sensIdx_u8;
+
+    for(uint8_t regIdx_u8 = 0U; regIdx_u8 < this_sst.reg_st.count_u8; regIdx_u8++)
+    {
+        entry_cstp = &this_sst.reg_st.entries_sta[regIdx_u8];
+        sensIdx_u8 = AllocSensor_u8(entry_cstp->macAddr_u8a);
+        if(MAX_MIJA_SENSORS > sensIdx_u8)
+        {
+            para_stp = &this_sst.sensors_sta[sensIdx_u8].para_st;
+            memcpy(para_stp->loc_cha, entry_cstp->loc_cha, LOCATION_STRING_SIZE);
+            para_stp->knownSens_u8 = 1U;
+            para_stp->pubIntv_u16 = entry_cstp->pubIntv_u16;
+            para_stp->dbTemp_u16 = entry_cstp->dbTemp_u16;
+            para_stp->dbHum_u16 = entry_cstp->dbHum_u16;
+            para_stp->dbBatt_u16 = entry_cstp->dbBatt_u16;
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Load the default deadbands of the change triggered publication
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if successful, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t LoadDeadbandParameter_st(void)
+{
+    bool exeResult_bol = true;
+    esp_err_t result_st = ESP_OK;
+    paramif_allocParam_t allocParam_st;
+
+    exeResult_bol &= CHECK_EXE(paramif_InitializeAllocParameter_td(&allocParam_st));
+    allocParam_st.length_u16 = sizeof(deadbandParam_t);
+    allocParam_st.defaults_u8p = (uint8_t *)&DB_DEFAULT_PARA;
+    allocParam_st.nvsIdent_cp = DB_PARA_IDENT;
+    this_sst.dbParam_xp = paramif_Allocate_stp(&allocParam_st);
+    exeResult_bol &= CHECK_EXE(paramif_Read_td(this_sst.dbParam_xp, 
+                                                (uint8_t *) &this_sst.db_st));
+    if(false == exeResult_bol)
+    {
+        memcpy(&this_sst.db_st, &DB_DEFAULT_PARA, sizeof(deadbandParam_t));
+        result_st = ESP_FAIL;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Handler when connected to mqtt broker
+ * @author    S. Wink
+ * @date      01. Feb. 2020
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void OnConnectionHandler_vd(void)
+{
+    this_sst.mqtt_en = MQTT_STATE_CONNECTED;
+    xEventGroupSetBits(this_sst.eventGroup_st, MQTT_CONNECT);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Handler when disconnected from mqtt broker
+ * @author    S. Wink
+ * @date      01. Feb. 2020
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void OnDisconnectionHandler_vd(void)
+{
+    this_sst.mqtt_en = MQTT_STATE_DISCONNECTED;
+    xEventGroupSetBits(this_sst.eventGroup_st, MQTT_DISCONNECT);
+}
+
+/**--------------------------------------------------------------------------------------
+ * @brief     Handler when subscription recieved
+ * @author    S. Wink
  * @date      01. Feb. 2020
+ * @param     msg_stp   message data pointer
+ * @return    ESP_OK if successful, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t OnSubsReceiveHandler_st(mqttif_msg_t *msg_stp)
+{
+    esp_err_t result_st = ESP_OK;
+
+    ESP_LOGD(TAG, "message for subscription %d received, data length: %d",
+                    msg_stp->token_u32, msg_stp->dataLen_u32);
+    
+    // the sensor list belongs to the module task, it is reset there
+    xEventGroupSetBits(this_sst.eventGroup_st, SENSOR_RESET);
+
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     function to send sensor data
+ * @author    S. Wink
+ * @date      01. Feb. 2020
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void PublishSensorData_vd(uint8_t sensIdx_u8)
+{
+    if(MQTT_STATE_CONNECTED == this_sst.mqtt_en)
+    {
+        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                    this_sst.param_st.id_u8 + sensIdx_u8,
+                                    MQTT_PUB_TEMP, this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.dataLen_u32 = utils_FixedPointToString_u32(
+                                    this_sst.sensors_sta[sensIdx_u8].data_st.temperature_s16,
+                                    1U, this_sst.pubMsg_st.data_chp);
+        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
+        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                    this_sst.pubMsg_st.data_chp);
+        
+        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                    this_sst.param_st.id_u8 + sensIdx_u8,
+                                    MQTT_PUB_HUM, this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.dataLen_u32 = utils_FixedPointToString_u32(
+                                    this_sst.sensors_sta[sensIdx_u8].data_st.humidity_u16,
+                                    1U, this_sst.pubMsg_st.data_chp);
+        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
+        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                    this_sst.pubMsg_st.data_chp);
+        
+        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                    this_sst.param_st.id_u8 + sensIdx_u8,
+                                    MQTT_PUB_BATT, this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.dataLen_u32 = utils_FixedPointToString_u32(
+                                    this_sst.sensors_sta[sensIdx_u8].data_st.battery_u8,
+                                    0U, this_sst.pubMsg_st.data_chp);
+        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
+        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                    this_sst.pubMsg_st.data_chp);
+
+        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                    this_sst.param_st.id_u8 + sensIdx_u8,
+                                    MQTT_PUB_MSGCNT, this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%d",
+                                    this_sst.sensors_sta[sensIdx_u8].data_st.msgCnt_u8);
+        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
+        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                    this_sst.pubMsg_st.data_chp);
+    }               
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     function to send sensor data
+ * @author    S. Wink
+ * @date      01. Feb. 2020
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void PublishSensorParam_vd(uint8_t sensIdx_u8)
+{
+
+
+    if(MQTT_STATE_CONNECTED == this_sst.mqtt_en)
+    {
+        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                    this_sst.param_st.id_u8 + sensIdx_u8,
+                                    MQTT_PUB_ADDR, this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.dataLen_u32 = 
+                    sprintf(this_sst.pubMsg_st.data_chp, "%02X:%02X:%02X:%02X:%02X:%02X",
+                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[0],
+                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[1],
+                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[2],
+                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[3],
+                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[4],
+                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[5]);
+        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
+        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                    this_sst.pubMsg_st.data_chp);
+        
+        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                    this_sst.param_st.id_u8 + sensIdx_u8,
+                                    MQTT_PUB_LOC, this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%s",
+                                    this_sst.sensors_sta[sensIdx_u8].para_st.loc_cha);
+        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
+        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                    this_sst.pubMsg_st.data_chp);
+        
+        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                    this_sst.param_st.id_u8 + sensIdx_u8,
+                                    MQTT_PUB_KNOW, this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%d",
+                                    this_sst.sensors_sta[sensIdx_u8].para_st.knownSens_u8);
+        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
+        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                    this_sst.pubMsg_st.data_chp);
+    }               
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     function to send the complete sensor object as one json document
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     sensIdx_u8    index of the sensor in the sensor list
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void PublishSensorSnapshot_vd(uint8_t sensIdx_u8)
+{
+    sensorObject_t *sens_stp = &this_sst.sensors_sta[sensIdx_u8];
+    int32_t length_s32;
+    char temp_cha[VALUE_STRING_SIZE];
+    char hum_cha[VALUE_STRING_SIZE];
+    char loc_cha[LOCATION_JSON_SIZE];
+
+    if(MQTT_STATE_CONNECTED == this_sst.mqtt_en)
+    {
+        utils_FixedPointToString_u32(sens_stp->data_st.temperature_s16, 1U, temp_cha);
+        utils_FixedPointToString_u32(sens_stp->data_st.humidity_u16, 1U, hum_cha);
+        EscapeJsonString_vd(sens_stp->para_st.loc_cha, 
+                            strnlen(sens_stp->para_st.loc_cha, LOCATION_STRING_SIZE), 
+                            loc_cha);
+        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                    this_sst.param_st.id_u8 + sensIdx_u8,
+                                    MQTT_PUB_SNAPSHOT, this_sst.pubMsg_st.topic_chp);
+        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+        length_s32 = snprintf(this_sst.pubMsg_st.data_chp, mqttif_MAX_SIZE_OF_DATA,
+                    "{\"temp\":%s,\"hum\":%s,\"batt\":%d,\"cnt\":%d,"
+                    "\"addr\":\"%02X:%02X:%02X:%02X:%02X:%02X\",\"loc\":\"%s\","
+                    "\"know\":%d}",
+                    temp_cha,
+                    hum_cha,
+                    sens_stp->data_st.battery_u8,
+                    sens_stp->data_st.msgCnt_u8,
+                    sens_stp->para_st.macAddr_u8a[0], sens_stp->para_st.macAddr_u8a[1],
+                    sens_stp->para_st.macAddr_u8a[2], sens_stp->para_st.macAddr_u8a[3],
+                    sens_stp->para_st.macAddr_u8a[4], sens_stp->para_st.macAddr_u8a[5],
+                    loc_cha,
+                    sens_stp->para_st.knownSens_u8);
+        if((0 < length_s32) && (mqttif_MAX_SIZE_OF_DATA > length_s32))
+        {
+            this_sst.pubMsg_st.dataLen_u32 = (uint32_t)length_s32;
+            CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, 
+                                                            MAX_PUB_WAIT));
+            ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                        this_sst.pubMsg_st.data_chp);
+        }
+        else
+        {
+            ESP_LOGE(TAG, "sensor snapshot exceeds publish buffer...");
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     copies a string into a json string value, quote, backslash and control 
+ *              characters are escaped
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     src_cchp      source string, not necessarily terminated
+ * @param     srcLen_u32    number of characters to copy
+ * @param     dest_chp      destination, at least 6 bytes per source character plus one
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void EscapeJsonString_vd(const char *src_cchp, uint32_t srcLen_u32, char *dest_chp)
+{
+    uint8_t char_u8;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < srcLen_u32; idx_u32++)
+    {
+        char_u8 = (uint8_t)src_cchp[idx_u32];
+        if(('"' == char_u8) || ('\\' == char_u8))
+        {
+            *dest_chp++ = '\\';
+            *dest_chp++ = (char)char_u8;
+        }
+        else if(0x20U > char_u8)
+        {
+            dest_chp += sprintf(dest_chp, "\\u%04x", char_u8);
+        }
+        else
+        {
+            *dest_chp++ = (char)char_u8;
+        }
+    }
+    *dest_chp = '\0';
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Publishes the aggregates of the last complete windows of a sensor, one 
+ *              topic per window length. A window is published once after it closed,
+ *              the aggregate message is too long for the last value cache of the mqtt
+ *              driver.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sensIdx_u8    index of the sensor in the sensor list
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void PublishSensorAggregates_vd(uint8_t sensIdx_u8)
+{
+    sensorObject_t *sens_stp = &this_sst.sensors_sta[sensIdx_u8];
+    const sensHist_aggregate_t *agg_cstp;
+    int32_t length_s32;
+    char value_chaa[sensHist_CH_NUM * 3U][VALUE_STRING_SIZE];   // min, max, avg
+    uint8_t val_u8;
+    uint32_t end_u32;
+
+    if(MQTT_STATE_CONNECTED == this_sst.mqtt_en)
+    {
+        sensHist_CloseWindows_vd(&sens_stp->hist_st, 
+                                    (uint32_t)(xTaskGetTickCount() / configTICK_RATE_HZ));
+
+        for(uint8_t win_u8 = 0U; win_u8 < sensHist_WIN_NUM; win_u8++)
+        {
+            agg_cstp = sensHist_GetAggregate_cstp(&sens_stp->hist_st, 
+                                                    (sensHist_window_t)win_u8);
+            end_u32 = agg_cstp->start_u32 
+                        + sensHist_GetWindowLength_u32((sensHist_window_t)win_u8);
+            if((0U < agg_cstp->count_u32) && (sens_stp->aggPubEnd_u32a[win_u8] != end_u32))
+            {
+                val_u8 = 0U;
+                for(uint8_t ch_u8 = 0U; ch_u8 < sensHist_CH_NUM; ch_u8++)
+                {
+                    utils_FixedPointToString_u32(agg_cstp->min_s16a[ch_u8], 1U, 
+                                                    value_chaa[val_u8++]);
+                    utils_FixedPointToString_u32(agg_cstp->max_s16a[ch_u8], 1U, 
+                                                    value_chaa[val_u8++]);
+                    utils_FixedPointToString_u32(
+                                    agg_cstp->sum_s32a[ch_u8] / (int32_t)agg_cstp->count_u32,
+                                    1U, value_chaa[val_u8++]);
+                }
+                utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                            this_sst.param_st.id_u8 + sensIdx_u8,
+                                            MQTT_PUB_AGGREGATE_CHPA[win_u8], 
+                                            this_sst.pubMsg_st.topic_chp);
+                this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+                length_s32 = snprintf(this_sst.pubMsg_st.data_chp, mqttif_MAX_SIZE_OF_DATA,
+                            "{\"start\":%d,\"len\":%d,\"n\":%d,"
+                            "\"temp\":{\"min\":%s,\"max\":%s,\"avg\":%s},"
+                            "\"hum\":{\"min\":%s,\"max\":%s,\"avg\":%s}}",
+                            agg_cstp->start_u32, 
+                            sensHist_GetWindowLength_u32((sensHist_window_t)win_u8),
+                            agg_cstp->count_u32,
+                            value_chaa[0], value_chaa[1], value_chaa[2],
+                            value_chaa[3], value_chaa[4], value_chaa[5]);
+                if((0 < length_s32) && (mqttif_MAX_SIZE_OF_DATA > length_s32))
+                {
+                    this_sst.pubMsg_st.dataLen_u32 = (uint32_t)length_s32;
+                    if(true == CHECK_EXE(this_sst.param_st.publishHandler_fp(
+                                                &this_sst.pubMsg_st, MAX_PUB_WAIT)))
+                    {
+                        // a failed publication is repeated with the next call
+                        sens_stp->aggPubEnd_u32a[win_u8] = end_u32;
+                    }
+                    ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                                this_sst.pubMsg_st.data_chp);
+                }
+            }
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Stores the current values of a sensor in the offline sample buffer, used
+ *              instead of the publication while the broker is not connected
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sensIdx_u8    index of the sensor in the sensor list
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void StoreSensorSample_vd(uint8_t sensIdx_u8)
+{
+    mijaProcl_parsedData_t *data_stp = &this_sst.sensors_sta[sensIdx_u8].data_st;
+    sampleBuf_record_t rec_st;
+
+    // only sensors which already sent an advertisement provide valid values
+    if(0U != data_stp->uuid_u16)
+    {
+        memset(&rec_st, 0U, sizeof(rec_st));
+        rec_st.time_u32 = (uint32_t)(xTaskGetTickCount() / configTICK_RATE_HZ);
+        rec_st.temp_s16 = data_stp->temperature_s16;
+        rec_st.hum_u16 = data_stp->humidity_u16;
+        rec_st.batt_u8 = data_stp->battery_u8;
+        memcpy(rec_st.macAddr_u8a, this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a,
+                mija_SIZE_MAC_ADDR);
+        rec_st.msgCnt_u8 = data_stp->msgCnt_u8;
+        CHECK_EXE(sampleBuf_Push_td(&rec_st));
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Publishes the values of one sensor in the configured publish mode, while
+ *              the broker is not connected the values are buffered for the replay
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sensIdx_u8    index of the sensor in the sensor list
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void PublishSensor_vd(uint8_t sensIdx_u8)
+{
+    sensorObject_t *sens_stp = &this_sst.sensors_sta[sensIdx_u8];
+    uint32_t requestUs_u32 = latStat_Now_u32();
+    uint32_t publishedUs_u32;
+
+    // reference of the deadbands, buffered values count as published
+    sens_stp->published_bol = true;
+    sens_stp->pubTemp_s16 = sens_stp->data_st.temperature_s16;
+    sens_stp->pubHum_u16 = sens_stp->data_st.humidity_u16;
+    sens_stp->pubBatt_u8 = sens_stp->data_st.battery_u8;
+    this_sst.published_u32++;
+
+    if((MQTT_STATE_CONNECTED == this_sst.mqtt_en) && (true == sens_stp->latValid_bol))
+    {
+        // the mqtt driver takes the stamp with the first publication of the sample
+        this_sst.pubMsg_st.rxUs_u32 = sens_stp->rxUs_u32;
+        this_sst.pubMsg_st.acked_fp = OnPublishAcked_vd;
+    }
+
+    if(MQTT_STATE_CONNECTED != this_sst.mqtt_en)
+    {
+        StoreSensorSample_vd(sensIdx_u8);
+    }
+    else if(PUB_MODE_COMPACT == this_sst.pubMode_en)
+    {
+        PublishSensorSnapshot_vd(sensIdx_u8);
+    }
+    else if(PUB_MODE_AGGREGATE == this_sst.pubMode_en)
+    {
+        PublishSensorAggregates_vd(sensIdx_u8);
+    }
+    else
+    {
+        PublishSensorData_vd(sensIdx_u8);
+        PublishSensorParam_vd(sensIdx_u8);
+    }
+
+    // buffered samples are not part of the latency statistics
+    if((MQTT_STATE_CONNECTED == this_sst.mqtt_en) && (true == sens_stp->latValid_bol))
+    {
+        publishedUs_u32 = latStat_Now_u32();
+        latStat_Record_vd(latStat_STAGE_SCHED, sens_stp->dequeuedUs_u32, requestUs_u32);
+        latStat_Record_vd(latStat_STAGE_PUBLISH, requestUs_u32, publishedUs_u32);
+    }
+    sens_stp->latValid_bol = false;
+    this_sst.pubMsg_st.acked_fp = NULL;
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Acknowledge of the first publication of a sample, called by the mqtt
+ *              driver in the task of the mqtt client
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     rxUs_u32      reception of the sample
+ * @param     queuedUs_u32  hand over of the publication to the mqtt driver
+ * @param     ackUs_u32     acknowledge of the broker
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void OnPublishAcked_vd(uint32_t rxUs_u32, uint32_t queuedUs_u32, uint32_t ackUs_u32)
+{
+    latStat_Record_vd(latStat_STAGE_ACK, queuedUs_u32, ackUs_u32);
+    latStat_Record_vd(latStat_STAGE_TOTAL, rxUs_u32, ackUs_u32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Publishes the latency statistics, one topic per stage of the data path
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void PublishLatencyStats_vd(void)
+{
+    latStat_hist_t hist_st;
+    int32_t length_s32;
+
+    for(uint8_t stage_u8 = 0U; stage_u8 < latStat_STAGE_NUM; stage_u8++)
+    {
+        if(   (true == latStat_GetHistogram_bol((latStat_stage_t)stage_u8, &hist_st))
+           && (0U < hist_st.count_u32))
+        {
+            utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                        this_sst.param_st.id_u8,
+                                        MQTT_PUB_LATENCY_CHPA[stage_u8], 
+                                        this_sst.pubMsg_st.topic_chp);
+            this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+            length_s32 = snprintf(this_sst.pubMsg_st.data_chp, mqttif_MAX_SIZE_OF_DATA,
+                        "{\"n\":%u,\"avg\":%u,\"p50\":%u,\"p90\":%u,\"p99\":%u,"
+                        "\"max\":%u}",
+                        hist_st.count_u32,
+                        (uint32_t)(hist_st.sum_u64 / hist_st.count_u32),
+                        latStat_GetPercentile_u32(&hist_st, 500U),
+                        latStat_GetPercentile_u32(&hist_st, 900U),
+                        latStat_GetPercentile_u32(&hist_st, 990U),
+                        hist_st.max_u32);
+            if((0 < length_s32) && (mqttif_MAX_SIZE_OF_DATA > length_s32))
+            {
+                this_sst.pubMsg_st.dataLen_u32 = (uint32_t)length_s32;
+                CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, 
+                                                                MAX_PUB_WAIT));
+            }
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Publish scheduler, called every SCHED_TICK_MS. The sensor slots are
+ *              visited round robin and sensors with new data are published once their
+ *              publish interval is elapsed. The number of publications per tick is
+ *              limited, so all sensors are spread over the default publish interval.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void RunPublishScheduler_vd(void)
+{
+    TickType_t now_st = xTaskGetTickCount();
+    uint32_t budget_u32;
+    uint32_t intvMs_u32;
+    uint8_t visited_u8 = 0U;
+    sensorObject_t *sens_stp;
+    bool deadband_bol = DeadbandActive_bol();
+    bool silent_bol;
+
+    budget_u32 = ((this_sst.usedSensors_u8 * SCHED_TICK_MS) + PUB_CYCLE_MS - 1U) 
+                    / PUB_CYCLE_MS;
+
+    while((0U < budget_u32) && (this_sst.usedSensors_u8 > visited_u8))
+    {
+        this_sst.schedIdx_u8 = (this_sst.schedIdx_u8 + 1U) % this_sst.usedSensors_u8;
+        sens_stp = &this_sst.sensors_sta[this_sst.schedIdx_u8];
+        visited_u8++;
+
+        // with deadbands a significant change is published without default delay
+        intvMs_u32 = (0U != sens_stp->para_st.pubIntv_u16) ? 
+                        (sens_stp->para_st.pubIntv_u16 * 1000U) : 
+                        ((true == deadband_bol) ? 0U : PUB_CYCLE_MS);
+        silent_bol =   (true == deadband_bol) && (true == sens_stp->published_bol)
+                    && (0U != this_sst.db_st.maxSilent_u32)
+                    && (pdMS_TO_TICKS(this_sst.db_st.maxSilent_u32 * 1000U) 
+                            <= (now_st - sens_stp->lastPub_st));
+
+        if(   (   (true == sens_stp->dirty_bol)
+               && (   (0U == sens_stp->lastPub_st)
+                   || (pdMS_TO_TICKS(intvMs_u32) <= (now_st - sens_stp->lastPub_st))))
+           || (true == silent_bol))
+        {
+            PublishSensor_vd(this_sst.schedIdx_u8);
+            sens_stp->dirty_bol = false;
+            sens_stp->lastPub_st = now_st;
+            budget_u32--;
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Starts the replay of the buffered samples after the broker connection
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void StartReplay_vd(void)
+{
+    if(0U < sampleBuf_GetCount_u32())
+    {
+        ESP_LOGI(TAG, "replay of %d buffered samples started", sampleBuf_GetCount_u32());
+        this_sst.replayStart_st = xTaskGetTickCount();
+        this_sst.replayCnt_u32 = 0U;
+        (void)xTimerStart(this_sst.replayTimer_st, 0);
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Publishes one batch of buffered samples. The batch size and the replay
+ *              period limit the replay rate, so live values are not delayed.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void ReplaySamples_vd(void)
+{
+    sampleBuf_record_t rec_st;
+    uint32_t now_u32 = (uint32_t)(xTaskGetTickCount() / configTICK_RATE_HZ);
+    uint32_t duration_u32;
+    uint8_t batch_u8 = 0U;
+    char temp_cha[VALUE_STRING_SIZE];
+    char hum_cha[VALUE_STRING_SIZE];
+    uint8_t sensIdx_u8;
+
+    while(   (MQTT_STATE_CONNECTED == this_sst.mqtt_en)
+          && (REPLAY_BATCH_SIZE > batch_u8)
+          && (true == sampleBuf_Pop_bol(&rec_st)))
+    {
+        // the slot of the sensor may have changed since the sample was stored
+        sensIdx_u8 = FindSensor_u8(rec_st.macAddr_u8a);
+        batch_u8++;
+        if(MAX_MIJA_SENSORS > sensIdx_u8)
+        {
+            utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
+                                        this_sst.param_st.id_u8 + sensIdx_u8,
+                                        MQTT_PUB_HISTORY, this_sst.pubMsg_st.topic_chp);
+            this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
+            utils_FixedPointToString_u32(rec_st.temp_s16, 1U, temp_cha);
+            utils_FixedPointToString_u32(rec_st.hum_u16, 1U, hum_cha);
+            this_sst.pubMsg_st.dataLen_u32 = snprintf(this_sst.pubMsg_st.data_chp, 
+                        mqttif_MAX_SIZE_OF_DATA,
+                        "{\"age\":%d,\"temp\":%s,\"hum\":%s,\"batt\":%d,\"cnt\":%d}",
+                        now_u32 - rec_st.time_u32, temp_cha, hum_cha,
+                        rec_st.batt_u8, rec_st.msgCnt_u8);
+            CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, 
+                                                            MAX_PUB_WAIT));
+            ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
+                        this_sst.pubMsg_st.data_chp);
+            this_sst.replayCnt_u32++;
+        }
+        else
+        {
+            ESP_LOGD(TAG, "replay sample of a removed sensor dropped");
+        }
+    }
+
+    if((MQTT_STATE_CONNECTED != this_sst.mqtt_en) || (0U == sampleBuf_GetCount_u32()))
+    {
+        (void)xTimerStop(this_sst.replayTimer_st, 0);
+        duration_u32 = (xTaskGetTickCount() - this_sst.replayStart_st) * portTICK_PERIOD_MS;
+        ESP_LOGI(TAG, "replay stopped, %d samples in %d ms, %d samples left", 
+                    this_sst.replayCnt_u32, duration_u32, sampleBuf_GetCount_u32());
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Removes all sensors from the sensor list and the mac index, called at the
+ *              initialization and in the context of the module task
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void ResetSensors_vd(void)
+{
+    memset(this_sst.sensors_sta, 0U, sizeof(this_sst.sensors_sta));
+    memset(this_sst.macHash_u8a, MAC_HASH_EMPTY, sizeof(this_sst.macHash_u8a));
+    this_sst.usedSensors_u8 = 0U;
+    this_sst.schedIdx_u8 = 0U;
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Calculates the home position of a mac address in the index by
+ *              multiplicative hashing of the 48 bit address
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the sensor
+ * @return    position in the index
+*//*-----------------------------------------------------------------------------------*/
+static uint16_t HashMac_u16(const uint8_t *mac_cu8p)
+{
+    uint64_t key_u64 = 0U;
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < mija_SIZE_MAC_ADDR; idx_u8++)
+    {
+        key_u64 = (key_u64 << 8U) | mac_cu8p[idx_u8];
+    }
+    return((uint16_t)((key_u64 * 0x9E3779B97F4A7C15ULL) >> (64U - MAC_HASH_BITS)));
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Searches the sensor slot of a mac address
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the sensor
+ * @return    sensor slot or MAX_MIJA_SENSORS if the sensor is unknown
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t FindSensor_u8(const uint8_t *mac_cu8p)
+{
+    uint16_t pos_u16 = HashMac_u16(mac_cu8p);
+    uint8_t entry_u8;
+    uint8_t sensIdx_u8 = MAX_MIJA_SENSORS;
+
+    // the index is never full, an empty position always terminates the search
+    while(MAC_HASH_EMPTY != (entry_u8 = this_sst.macHash_u8a[pos_u16]))
+    {
+        if(0 == memcmp(&this_sst.sensors_sta[entry_u8].para_st.macAddr_u8a[0],
+                            mac_cu8p, mija_SIZE_MAC_ADDR))
+        {
+            sensIdx_u8 = entry_u8;
+            break;
+        }
+        pos_u16 = (pos_u16 + 1U) & (MAC_HASH_SIZE - 1U);
+    }
+    return(sensIdx_u8);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Allocates a sensor slot for a new mac address. If all slots are in use
+ *              the unknown sensor which was not seen for the longest time is replaced.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the sensor
+ * @return    sensor slot or MAX_MIJA_SENSORS if no slot is available
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t AllocSensor_u8(const uint8_t *mac_cu8p)
+{
+    uint8_t sensIdx_u8 = MAX_MIJA_SENSORS;
+    TickType_t now_st = xTaskGetTickCount();
+
+    if(MAX_MIJA_SENSORS > this_sst.usedSensors_u8)
+    {
+        sensIdx_u8 = this_sst.usedSensors_u8;
+        this_sst.usedSensors_u8++;
+    }
+    else
+    {
+        for(uint8_t idx_u8 = 0U; idx_u8 < MAX_MIJA_SENSORS; idx_u8++)
+        {
+            if(   (0U == this_sst.sensors_sta[idx_u8].para_st.knownSens_u8)
+               && (   (MAX_MIJA_SENSORS == sensIdx_u8)
+                   || ((now_st - this_sst.sensors_sta[idx_u8].lastSeen_st)
+                        > (now_st - this_sst.sensors_sta[sensIdx_u8].lastSeen_st))))
+            {
+                sensIdx_u8 = idx_u8;
+            }
+        }
+
+        if(MAX_MIJA_SENSORS > sensIdx_u8)
+        {
+            ESP_LOGD(TAG, "sensor slot %d evicted", sensIdx_u8);
+            IndexRemove_vd(sensIdx_u8);
+        }
+    }
+
+    if(MAX_MIJA_SENSORS > sensIdx_u8)
+    {
+        memset(&this_sst.sensors_sta[sensIdx_u8], 0U, sizeof(sensorObject_t));
+        memcpy(&this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[0], mac_cu8p,
+                    mija_SIZE_MAC_ADDR);
+        this_sst.sensors_sta[sensIdx_u8].lastSeen_st = now_st;
+        IndexInsert_vd(sensIdx_u8);
+    }
+    else
+    {
+        ESP_LOGW(TAG, "no sensor slot available...");
+    }
+    return(sensIdx_u8);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Forwards a registry change to the task of the module
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     cmd_en        registry command
+ * @param     mac_cu8p      mac address of the sensor, not used for save
+ * @param     loc_cchp      new location of the sensor or NULL
+ * @return    true if the change was queued
+*//*-----------------------------------------------------------------------------------*/
+static bool PostRegistryCmd_bol(registryCmd_t cmd_en, const uint8_t *mac_cu8p, 
+                                    const char *loc_cchp)
+{
+    bool queued_bol = false;
+    registryMsg_t msg_st;
+
+    memset(&msg_st, 0U, sizeof(msg_st));
+    msg_st.cmd_en = cmd_en;
+    if(REG_CMD_SAVE != cmd_en)
+    {
+        memcpy(msg_st.macAddr_u8a, mac_cu8p, mija_SIZE_MAC_ADDR);
+    }
+    if(NULL != loc_cchp)
+    {
+        strncpy(msg_st.loc_cha, loc_cchp, LOCATION_STRING_SIZE - 1U);
+        msg_st.loc_cha[LOCATION_STRING_SIZE - 1U] = '\0';
+        msg_st.locValid_bol = true;
+    }
+
+    if(pdTRUE == xQueueSendToBack(this_sst.regQueue_st, &msg_st, 0U))
+    {
+        xEventGroupSetBits(this_sst.eventGroup_st, REGISTRY_EVENT);
+        queued_bol = true;
+    }
+    else
+    {
+        ESP_LOGW(TAG, "registry queue full, change dropped");
+    }
+    return(queued_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Applies the queued registry changes to the sensor list and the ram image
+ *              of the registry. The registry is written later by the scheduler.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
  * @return    n/a
 *//*-----------------------------------------------------------------------------------*/
-static void OnDisconnectionHandler_vd(void)
+static void HandleRegistryEvent_vd(void)
 {
-    this_sst.mqtt_en = MQTT_STATE_DISCONNECTED;
-    xEventGroupSetBits(this_sst.eventGroup_st, MQTT_DISCONNECT);
+    registryMsg_t msg_st;
+    uint8_t sensIdx_u8;
+    bool force_bol = false;
+
+    while(pdTRUE == xQueueReceive(this_sst.regQueue_st, &msg_st, 0U))
+    {
+        sensIdx_u8 = FindSensor_u8(msg_st.macAddr_u8a);
+        switch(msg_st.cmd_en)
+        {
+            case REG_CMD_ADD:
+                if(MAX_MIJA_SENSORS == sensIdx_u8)
+                {
+                    sensIdx_u8 = AllocSensor_u8(msg_st.macAddr_u8a);
+                }
+                if(MAX_MIJA_SENSORS > sensIdx_u8)
+                {
+                    this_sst.sensors_sta[sensIdx_u8].para_st.knownSens_u8 = 1U;
+                    if(true == msg_st.locValid_bol)
+                    {
+                        memcpy(this_sst.sensors_sta[sensIdx_u8].para_st.loc_cha, 
+                                msg_st.loc_cha, LOCATION_STRING_SIZE);
+                    }
+                    CHECK_EXE(bleDrv_SetKnownDevice_st(msg_st.macAddr_u8a, true));
+                    StoreRegistryEntry_vd(sensIdx_u8);
+                }
+                break;
+            case REG_CMD_REMOVE:
+                if(MAX_MIJA_SENSORS > sensIdx_u8)
+                {
+                    // the sensor stays in the list as unknown sensor
+                    this_sst.sensors_sta[sensIdx_u8].para_st.knownSens_u8 = 0U;
+                }
+                CHECK_EXE(bleDrv_SetKnownDevice_st(msg_st.macAddr_u8a, false));
+                RemoveRegistryEntry_vd(msg_st.macAddr_u8a);
+                break;
+            case REG_CMD_UPDATE:
+                if(   (MAX_MIJA_SENSORS > sensIdx_u8)
+                   && (0U != this_sst.sensors_sta[sensIdx_u8].para_st.knownSens_u8))
+                {
+                    StoreRegistryEntry_vd(sensIdx_u8);
+                }
+                break;
+            case REG_CMD_SAVE:
+                force_bol = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if(true == force_bol)
+    {
+        SaveRegistry_vd(true);
+    }
 }
 
-/**--------------------------------------------------------------------------------------
- * @brief     Handler when subscription recieved
+/**---------------------------------------------------------------------------------------
+ * @brief     Searches the registry entry of a mac address
  * @author    S. Wink
- * @date      01. Feb. 2020
- * @param     msg_stp   message data pointer
- * @return    ESP_OK if successful, else ESP_FAIL
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the sensor
+ * @return    entry index or REGISTRY_SIZE if the sensor is not registered
 *//*-----------------------------------------------------------------------------------*/
-static esp_err_t OnSubsReceiveHandler_st(mqttif_msg_t *msg_stp)
+static uint8_t FindRegistryEntry_u8(const uint8_t *mac_cu8p)
 {
-    esp_err_t result_st = ESP_OK;
+    uint8_t regIdx_u8 = REGISTRY_SIZE;
 
-    ESP_LOGD(TAG, "message topic:%.*s received with data:%.*s",
-                    msg_stp->topicLen_u32, msg_stp->topic_chp,
-                    msg_stp->dataLen_u32, msg_stp->data_chp);
-    
-    memset(this_sst.sensors_sta, 0U, sizeof(this_sst.sensors_sta));
+    for(uint8_t idx_u8 = 0U; idx_u8 < this_sst.reg_st.count_u8; idx_u8++)
+    {
+        if(0 == memcmp(this_sst.reg_st.entries_sta[idx_u8].macAddr_u8a, mac_cu8p, 
+                        mija_SIZE_MAC_ADDR))
+        {
+            regIdx_u8 = idx_u8;
+            break;
+        }
+    }
+    return(regIdx_u8);
+}
 
-    return(result_st);
+/**---------------------------------------------------------------------------------------
+ * @brief     Copies the settings of a sensor into its registry entry, a new entry is
+ *              appended
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sensIdx_u8    sensor slot
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void StoreRegistryEntry_vd(uint8_t sensIdx_u8)
+{
+    const sensorParam_t *para_cstp = &this_sst.sensors_sta[sensIdx_u8].para_st;
+    registryEntry_t *entry_stp;
+    uint8_t regIdx_u8 = FindRegistryEntry_u8(para_cstp->macAddr_u8a);
+
+    if((REGISTRY_SIZE == regIdx_u8) && (REGISTRY_SIZE > this_sst.reg_st.count_u8))
+    {
+        regIdx_u8 = this_sst.reg_st.count_u8;
+        this_sst.reg_st.count_u8++;
+    }
+
+    if(REGISTRY_SIZE > regIdx_u8)
+    {
+        entry_stp = &this_sst.reg_st.entries_sta[regIdx_u8];
+        memcpy(entry_stp->macAddr_u8a, para_cstp->macAddr_u8a, mija_SIZE_MAC_ADDR);
+        memcpy(entry_stp->loc_cha, para_cstp->loc_cha, LOCATION_STRING_SIZE);
+        entry_stp->pubIntv_u16 = para_cstp->pubIntv_u16;
+        entry_stp->dbTemp_u16 = para_cstp->dbTemp_u16;
+        entry_stp->dbHum_u16 = para_cstp->dbHum_u16;
+        entry_stp->dbBatt_u16 = para_cstp->dbBatt_u16;
+
+        if(false == this_sst.regDirty_bol)
+        {
+            this_sst.regFirstChange_st = xTaskGetTickCount();
+        }
+        this_sst.regLastChange_st = xTaskGetTickCount();
+        this_sst.regDirty_bol = true;
+    }
+    else
+    {
+        ESP_LOGW(TAG, "sensor registry full...");
+    }
 }
 
 /**---------------------------------------------------------------------------------------
- * @brief     function to send sensor data
+ * @brief     Removes the registry entry of a mac address, the last entry takes its place
  * @author    S. Wink
- * @date      01. Feb. 2020
+ * @date      17. Oct. 2026
+ * @param     mac_cu8p      mac address of the sensor
  * @return    n/a
 *//*-----------------------------------------------------------------------------------*/
-static void PublishSensorData_vd(uint8_t sensIdx_u8)
+static void RemoveRegistryEntry_vd(const uint8_t *mac_cu8p)
 {
-    if(MQTT_STATE_CONNECTED == this_sst.mqtt_en)
+    uint8_t regIdx_u8 = FindRegistryEntry_u8(mac_cu8p);
+
+    if(REGISTRY_SIZE > regIdx_u8)
     {
-        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
-                                    this_sst.param_st.id_u8 + sensIdx_u8,
-                                    MQTT_PUB_TEMP, this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%.2f",
-                                    this_sst.sensors_sta[sensIdx_u8].data_st.temperature_f32);
-        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
-        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
-                    this_sst.pubMsg_st.data_chp);
-        
-        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
-                                    this_sst.param_st.id_u8 + sensIdx_u8,
-                                    MQTT_PUB_HUM, this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%.2f",
-                                    this_sst.sensors_sta[sensIdx_u8].data_st.humidity_f32);
-        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
-        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
-                    this_sst.pubMsg_st.data_chp);
-        
-        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
-                                    this_sst.param_st.id_u8 + sensIdx_u8,
-                                    MQTT_PUB_BATT, this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%.2f",
-                                    this_sst.sensors_sta[sensIdx_u8].data_st.battery_f32);
-        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
-        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
-                    this_sst.pubMsg_st.data_chp);
+        this_sst.reg_st.count_u8--;
+        if(this_sst.reg_st.count_u8 != regIdx_u8)
+        {
+            memcpy(&this_sst.reg_st.entries_sta[regIdx_u8],
+                    &this_sst.reg_st.entries_sta[this_sst.reg_st.count_u8], 
+                    sizeof(registryEntry_t));
+        }
+        memset(&this_sst.reg_st.entries_sta[this_sst.reg_st.count_u8], 0U, 
+                sizeof(registryEntry_t));
 
-        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
-                                    this_sst.param_st.id_u8 + sensIdx_u8,
-                                    MQTT_PUB_MSGCNT, this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%d",
-                                    this_sst.sensors_sta[sensIdx_u8].data_st.msgCnt_u8);
-        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
-        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
-                    this_sst.pubMsg_st.data_chp);
-    }               
+        if(false == this_sst.regDirty_bol)
+        {
+            this_sst.regFirstChange_st = xTaskGetTickCount();
+        }
+        this_sst.regLastChange_st = xTaskGetTickCount();
+        this_sst.regDirty_bol = true;
+    }
 }
 
 /**---------------------------------------------------------------------------------------
- * @brief     function to send sensor data
+ * @brief     Writes the registry if changes are pending. To batch a series of changes
+ *              the write is delayed until no change happened for the save delay, but
+ *              not longer than the maximum save delay after the first change.
  * @author    S. Wink
- * @date      01. Feb. 2020
+ * @date      17. Oct. 2026
+ * @param     force_bol     write pending changes without delay
  * @return    n/a
 *//*-----------------------------------------------------------------------------------*/
-static void PublishSensorParam_vd(uint8_t sensIdx_u8)
+static void SaveRegistry_vd(bool force_bol)
 {
+    TickType_t now_st = xTaskGetTickCount();
+
+    if(   (true == this_sst.regDirty_bol)
+       && (   (true == force_bol)
+           || (pdMS_TO_TICKS(REGISTRY_SAVE_DELAY_MS) <= (now_st - this_sst.regLastChange_st))
+           || (pdMS_TO_TICKS(REGISTRY_SAVE_MAX_MS) <= (now_st - this_sst.regFirstChange_st))))
+    {
+        if(true == CHECK_EXE(paramif_Write_td(this_sst.regParam_xp, 
+                                                (uint8_t *) &this_sst.reg_st)))
+        {
+            this_sst.regDirty_bol = false;
+            this_sst.regSaves_u32++;
+            ESP_LOGI(TAG, "sensor registry saved, %d entries", this_sst.reg_st.count_u8);
+        }
+        else
+        {
+            // retry after the save delay
+            this_sst.regFirstChange_st = now_st;
+            this_sst.regLastChange_st = now_st;
+        }
+    }
+}
 
+/**---------------------------------------------------------------------------------------
+ * @brief     Inserts a sensor slot into the mac index using linear probing
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sensIdx_u8    sensor slot with the mac address already set
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void IndexInsert_vd(uint8_t sensIdx_u8)
+{
+    uint16_t pos_u16 = HashMac_u16(&this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[0]);
 
-    if(MQTT_STATE_CONNECTED == this_sst.mqtt_en)
+    while(MAC_HASH_EMPTY != this_sst.macHash_u8a[pos_u16])
     {
-        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
-                                    this_sst.param_st.id_u8 + sensIdx_u8,
-                                    MQTT_PUB_ADDR, this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.dataLen_u32 = 
-                    sprintf(this_sst.pubMsg_st.data_chp, "%02X:%02X:%02X:%02X:%02X:%02X",
-                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[0],
-                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[1],
-                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[2],
-                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[3],
-                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[4],
-                                this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[5]);
-        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
-        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
-                    this_sst.pubMsg_st.data_chp);
-        
-        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
-                                    this_sst.param_st.id_u8 + sensIdx_u8,
-                                    MQTT_PUB_LOC, this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%s",
-                                    this_sst.sensors_sta[sensIdx_u8].para_st.loc_cha);
-        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
-        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
-                    this_sst.pubMsg_st.data_chp);
-        
-        utils_BuildSendTopic_chp(this_sst.param_st.deviceName_chp, 
-                                    this_sst.param_st.id_u8 + sensIdx_u8,
-                                    MQTT_PUB_KNOW, this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.topicLen_u32 = strlen(this_sst.pubMsg_st.topic_chp);
-        this_sst.pubMsg_st.dataLen_u32 = sprintf(this_sst.pubMsg_st.data_chp, "%d",
-                                    this_sst.sensors_sta[sensIdx_u8].para_st.knownSens_u8);
-        CHECK_EXE(this_sst.param_st.publishHandler_fp(&this_sst.pubMsg_st, MAX_PUB_WAIT));
-        ESP_LOGD(TAG, "publish: %s :: %s", this_sst.pubMsg_st.topic_chp, 
-                    this_sst.pubMsg_st.data_chp);
-    }               
+        pos_u16 = (pos_u16 + 1U) & (MAC_HASH_SIZE - 1U);
+    }
+    this_sst.macHash_u8a[pos_u16] = sensIdx_u8;
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Removes a sensor slot from the mac index. Following entries of the probe
+ *              sequence are shifted back, so no deleted markers are needed.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sensIdx_u8    sensor slot with the mac address still set
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void IndexRemove_vd(uint8_t sensIdx_u8)
+{
+    uint16_t pos_u16 = HashMac_u16(&this_sst.sensors_sta[sensIdx_u8].para_st.macAddr_u8a[0]);
+    uint16_t next_u16;
+    uint16_t home_u16;
+    uint8_t entry_u8;
+
+    while(   (MAC_HASH_EMPTY != this_sst.macHash_u8a[pos_u16])
+          && (sensIdx_u8 != this_sst.macHash_u8a[pos_u16]))
+    {
+        pos_u16 = (pos_u16 + 1U) & (MAC_HASH_SIZE - 1U);
+    }
+
+    if(sensIdx_u8 == this_sst.macHash_u8a[pos_u16])
+    {
+        this_sst.macHash_u8a[pos_u16] = MAC_HASH_EMPTY;
+        next_u16 = (pos_u16 + 1U) & (MAC_HASH_SIZE - 1U);
+
+        while(MAC_HASH_EMPTY != (entry_u8 = this_sst.macHash_u8a[next_u16]))
+        {
+            home_u16 = HashMac_u16(&this_sst.sensors_sta[entry_u8].para_st.macAddr_u8a[0]);
+            // move the entry into the gap if its home is not between gap and entry
+            if(   ((next_u16 - home_u16) & (MAC_HASH_SIZE - 1U))
+               >= ((next_u16 - pos_u16) & (MAC_HASH_SIZE - 1U)))
+            {
+                this_sst.macHash_u8a[pos_u16] = entry_u8;
+                this_sst.macHash_u8a[next_u16] = MAC_HASH_EMPTY;
+                pos_u16 = next_u16;
+            }
+            next_u16 = (next_u16 + 1U) & (MAC_HASH_SIZE - 1U);
+        }
+    }
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     Timer callback to re-trigger the scan process
+ * @brief     Callback of the ble driver, runs in the context of the bluetooth stack.
+ *              The sample is copied to the ring without blocking, if the ring is full
+ *              the sample is dropped and counted. The task is only notified when the
+ *              ring was empty, further samples are collected with the same event.
  * @author    S. Wink
  * @date      17. Jan. 2020
- * @param     xTimer_xp     handle of the timer
+ * @param     sample_cstp     raw sample of the advertisement
  * @return    n/a
 *//*-----------------------------------------------------------------------------------*/
-static void DriverCallback_vd(mijaProcl_parsedData_t *data_stp)
+static void DriverCallback_vd(const mijaProcl_rawSample_t *sample_cstp)
 {
-	if((NULL != data_stp) && (NULL != this_sst.queue_xp))
+    rawRing_t *ring_stp = &this_sst.ring_st;
+    uint32_t head_u32;
+
+	if(NULL != sample_cstp)
     {
-        if(pdPASS == xQueueSendToBack(this_sst.queue_xp, (void *) data_stp,
-                                            (TickType_t) 10))
+        head_u32 = ring_stp->head_u32;
+        ring_stp->received_u32++;
+
+        if(RAW_RING_SIZE > (head_u32 - __atomic_load_n(&ring_stp->tail_u32, __ATOMIC_ACQUIRE)))
         {
-            // notify task that new data is available in the queue
-            if(NULL != this_sst.eventGroup_st)
+            memcpy(&ring_stp->buf_sta[head_u32 & (RAW_RING_SIZE - 1U)], sample_cstp, 
+                    sizeof(mijaProcl_rawSample_t));
+            __atomic_store_n(&ring_stp->head_u32, head_u32 + 1U, __ATOMIC_SEQ_CST);
+
+            // notify the task only if the consumer has already emptied the ring
+            if(   (1U == (head_u32 + 1U - __atomic_load_n(&ring_stp->tail_u32, __ATOMIC_SEQ_CST)))
+               && (NULL != this_sst.eventGroup_st))
             {
                 xEventGroupSetBits(this_sst.eventGroup_st, BLE_DATA_EVENT);
             }
         }
+        else
+        {
+            ring_stp->dropped_u32++;
+        }
     }
 }
 
 /**--------------------------------------------------------------------------------------
- * @brief     Handle the queue receive event and print data
+ * @brief     Handle the ring event, drains all samples collected by the ble driver
  * @author    S. Wink
  * @date      01. Feb. 2020
- * @param     xTimer_xp     handle of the timer
  * @return    n/a
 *//*-----------------------------------------------------------------------------------*/
-static void HandleQueueEvent_vd(void)
+static void HandleRingEvent_vd(void)
 {
+    rawRing_t *ring_stp = &this_sst.ring_st;
     mijaProcl_parsedData_t data_st;
+    const mijaProcl_rawSample_t *raw_cstp;
+    uint32_t dequeuedUs_u32;
+    uint32_t tail_u32 = ring_stp->tail_u32;
+    uint32_t head_u32 = __atomic_load_n(&ring_stp->head_u32, __ATOMIC_ACQUIRE);
 
-    if(NULL != this_sst.queue_xp)
+    while(tail_u32 != head_u32)
     {
-        // Receive a message on the created queue.  Block for 10 ticks if a
-        // message is not immediately available.
-        while(pdTRUE == xQueueReceive(this_sst.queue_xp, &data_st, (TickType_t) 10))
+        raw_cstp = &ring_stp->buf_sta[tail_u32 & (RAW_RING_SIZE - 1U)];
+        if(true == mijaProcl_ConvertRawSample_bol(raw_cstp, &data_st))
         {
-            //mijaProcl_PrintMessage_bol(&data_st);
+            dequeuedUs_u32 = latStat_Now_u32();
+            latStat_Record_vd(latStat_STAGE_PARSE, raw_cstp->rxUs_u32, raw_cstp->parsedUs_u32);
+            latStat_Record_vd(latStat_STAGE_QUEUE, raw_cstp->parsedUs_u32, dequeuedUs_u32);
+            ProcessSample_vd(&data_st, raw_cstp->rxUs_u32, dequeuedUs_u32);
+        }
+        tail_u32++;
+        __atomic_store_n(&ring_stp->tail_u32, tail_u32, __ATOMIC_SEQ_CST);
 
-            // search if the sensor is already allocated
-            uint8_t sensIdFound_u8 = MAX_MIJA_SENSORS;
-            uint8_t idx_u8 = 0U;
+        // samples stored in the meantime were not notified, collect them as well
+        if(tail_u32 == head_u32)
+        {
+            head_u32 = __atomic_load_n(&ring_stp->head_u32, __ATOMIC_SEQ_CST);
+        }
+    }
+}
 
-            while(idx_u8 < MAX_MIJA_SENSORS)
-            {
-                if(0 == memcmp(&this_sst.sensors_sta[idx_u8].para_st.macAddr_u8a, 
-                                    data_st.macAddr_u8a, sizeof(data_st.macAddr_u8a)))
-                {
-                    sensIdFound_u8 = idx_u8;
-                    mijaProcl_SetData_bol(&this_sst.sensors_sta[sensIdFound_u8].data_st, 
-                                            &data_st);
-                    break;
-                }
-                idx_u8++;
-            }
+/**--------------------------------------------------------------------------------------
+ * @brief     Stores a converted sample in the slot of its sensor
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     data_cstp         converted sample
+ * @param     rxUs_u32          reception time stamp of the sample
+ * @param     dequeuedUs_u32    time stamp when the sample was taken from the ring
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void ProcessSample_vd(const mijaProcl_parsedData_t *data_cstp, uint32_t rxUs_u32,
+                                uint32_t dequeuedUs_u32)
+{
+    // search if the sensor is already allocated, else allocate a new slot
+    uint8_t sensIdFound_u8 = FindSensor_u8(&data_cstp->macAddr_u8a[0]);
+    sensorObject_t *sens_stp;
+    sensHist_sample_t sample_st;
+
+    if(MAX_MIJA_SENSORS > sensIdFound_u8)
+    {
+        mijaProcl_SetData_bol(&this_sst.sensors_sta[sensIdFound_u8].data_st, 
+                                (mijaProcl_parsedData_t *)data_cstp);
+    }
+    else
+    {
+        sensIdFound_u8 = AllocSensor_u8(&data_cstp->macAddr_u8a[0]);
+        if(MAX_MIJA_SENSORS > sensIdFound_u8)
+        {
+            memcpy(&this_sst.sensors_sta[sensIdFound_u8].data_st, data_cstp, 
+                    sizeof(mijaProcl_parsedData_t));
+        }
+    }
 
-            if(sensIdFound_u8 == MAX_MIJA_SENSORS)
+    if(MAX_MIJA_SENSORS > sensIdFound_u8)
+    {
+        sens_stp = &this_sst.sensors_sta[sensIdFound_u8];
+        sens_stp->lastSeen_st = xTaskGetTickCount();
+        if(true == IsSignificantChange_bol(sens_stp))
+        {
+            // the latency is measured from the oldest change not yet published
+            if(false == sens_stp->latValid_bol)
             {
-                idx_u8 = 0U;
-                // search for an empty sensor list element
-                while(idx_u8 < MAX_MIJA_SENSORS)
-                {
-                    uint8_t default_u8a[mija_SIZE_MAC_ADDR];
-                    memset(&default_u8a[0], 0U, sizeof(default_u8a));
-                    if(0 == memcmp(&this_sst.sensors_sta[idx_u8].para_st.macAddr_u8a, 
-                                    default_u8a, sizeof(default_u8a)))
-                    {
-                        sensIdFound_u8 = idx_u8;
-                        // first: copy the complete data set
-                        memcpy(&this_sst.sensors_sta[idx_u8].data_st, &data_st, 
-                                sizeof(data_st));
-                        // second: set the mac address in the parameter section for later 
-                        // identification
-                        memcpy(&this_sst.sensors_sta[idx_u8].para_st.macAddr_u8a[0], 
-                                    &data_st.macAddr_u8a[0], 
-                                    sizeof(data_st.macAddr_u8a));
-                        break;
-                    }
-                    idx_u8++;
-                }
+                sens_stp->rxUs_u32 = rxUs_u32;
+                sens_stp->dequeuedUs_u32 = dequeuedUs_u32;
+                sens_stp->latValid_bol = true;
             }
+            sens_stp->dirty_bol = true;
+        }
+        else
+        {
+            this_sst.dbSuppressed_u32++;
+        }
 
-            /*if(sensIdFound_u8 < MAX_MIJA_SENSORS)
-            {
-                
-                PublishSensorData_vd(sensIdFound_u8);
-                PublishSensorParam_vd(sensIdFound_u8);
-                ESP_LOGD(TAG, "*** Sensor ID: %d ***", sensIdFound_u8);
-                mijaProcl_PrintMessage_bol(&this_sst.sensors_sta[sensIdFound_u8].data_st);
-            }*/
+        // the history starts when both values are known
+        if(   (mija_TYPE_TEMPERATURE == data_cstp->dataType_en)
+           || (mija_TYPE_TEMPHUM == data_cstp->dataType_en))
+        {
+            sens_stp->histValid_u8 |= HIST_TEMP_VALID;
+        }
+        if(   (mija_TYPE_HUMIDITY == data_cstp->dataType_en)
+           || (mija_TYPE_TEMPHUM == data_cstp->dataType_en))
+        {
+            sens_stp->histValid_u8 |= HIST_HUM_VALID;
+        }
+        if(   (HIST_ALL_VALID == sens_stp->histValid_u8)
+           && (mija_TYPE_BATTERY != data_cstp->dataType_en))
+        {
+            sample_st.time_u32 = (uint32_t)(sens_stp->lastSeen_st / configTICK_RATE_HZ);
+            sample_st.value_s16a[sensHist_CH_TEMP] = sens_stp->data_st.temperature_s16;
+            sample_st.value_s16a[sensHist_CH_HUM] = (int16_t)sens_stp->data_st.humidity_u16;
+            sensHist_AddSample_vd(&sens_stp->hist_st, &sample_st);
         }
     }
 }
 
+/**---------------------------------------------------------------------------------------
+ * @brief     Compares the current values of a sensor with the last published values, 
+ *              a change is significant if it exceeds the deadband of the sensor or the
+ *              default deadband
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sens_cstp     sensor object
+ * @return    true if the values have to be published
+*//*-----------------------------------------------------------------------------------*/
+static bool IsSignificantChange_bol(const sensorObject_t *sens_cstp)
+{
+    bool significant_bol = true;
+    const sensorParam_t *para_cstp = &sens_cstp->para_st;
+    uint32_t dbTemp_u32;
+    uint32_t dbHum_u32;
+    uint32_t dbBatt_u32;
+
+    if((true == DeadbandActive_bol()) && (true == sens_cstp->published_bol))
+    {
+        dbTemp_u32 = (0U != para_cstp->dbTemp_u16) ? para_cstp->dbTemp_u16 
+                                                    : this_sst.db_st.temp_u32;
+        dbHum_u32 = (0U != para_cstp->dbHum_u16) ? para_cstp->dbHum_u16 
+                                                    : this_sst.db_st.hum_u32;
+        dbBatt_u32 = (0U != para_cstp->dbBatt_u16) ? para_cstp->dbBatt_u16 
+                                                    : this_sst.db_st.batt_u32;
+
+        significant_bol = 
+               ((uint32_t)abs(sens_cstp->data_st.temperature_s16 - sens_cstp->pubTemp_s16) 
+                    > dbTemp_u32)
+            || ((uint32_t)abs((int32_t)sens_cstp->data_st.humidity_u16 
+                                - sens_cstp->pubHum_u16) > dbHum_u32)
+            || ((uint32_t)abs((int32_t)sens_cstp->data_st.battery_u8 
+                                - sens_cstp->pubBatt_u8) > dbBatt_u32);
+    }
+
+    return(significant_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Checks if the change triggered publication is configured
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    true if at least one default deadband is set
+*//*-----------------------------------------------------------------------------------*/
+static bool DeadbandActive_bol(void)
+{
+    return(   (0U != this_sst.db_st.temp_u32) || (0U != this_sst.db_st.hum_u32)
+           || (0U != this_sst.db_st.batt_u32));
+}
+
 /**---------------------------------------------------------------------------------------
  * @brief     callback function for the timer event handler
  * @author    S. Wink
@@ -873,6 +3100,17 @@ static void TimerCallback_vd(TimerHandle_t xTimer)
     xEventGroupSetBits(this_sst.eventGroup_st, CYCLE_TIMER);
 }
 
+/**---------------------------------------------------------------------------------------
+ * @brief     callback function for the replay timer
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     xTimer      handle to timer
+*//*-----------------------------------------------------------------------------------*/
+static void ReplayTimerCallback_vd(TimerHandle_t xTimer)
+{
+    xEventGroupSetBits(this_sst.eventGroup_st, REPLAY_TIMER);
+}
+
 /**---------------------------------------------------------------------------------------
  * @brief     task routine for the mqtt handling
  * @author    S. Wink
@@ -882,8 +3120,8 @@ static void TimerCallback_vd(TimerHandle_t xTimer)
 static void Task_vd(void *pvParameters)
 {
     EventBits_t uxBits_st;
-    uint32_t bits_u32 =   MQTT_CONNECT | MQTT_DISCONNECT | BLE_DATA_EVENT | CYCLE_TIMER;
-    uint8_t sensId_u8 = 0U;
+    uint32_t bits_u32 =   MQTT_CONNECT | MQTT_DISCONNECT | BLE_DATA_EVENT | CYCLE_TIMER
+                        | REPLAY_TIMER | REGISTRY_EVENT | SENSOR_RESET;
 
     ESP_LOGD(TAG, "mijasens-task started...");
     while(1)
@@ -891,9 +3129,13 @@ static void Task_vd(void *pvParameters)
         uxBits_st = xEventGroupWaitBits(this_sst.eventGroup_st, bits_u32,
                                             true, false, portMAX_DELAY); // @suppress("Symbol is not resolved")
 
+        // the console commands wait until the events are handled
+        xSemaphoreTake(this_sst.sensMutex_st, portMAX_DELAY);
+
         if(0 != (uxBits_st & MQTT_CONNECT))
         {
             ESP_LOGD(TAG, "mqtt connected and topic subscribed");
+            StartReplay_vd();
         }
         if(0 != (uxBits_st & MQTT_DISCONNECT))
         {
@@ -902,14 +3144,39 @@ static void Task_vd(void *pvParameters)
         }
         if(0 != (uxBits_st & BLE_DATA_EVENT))
         {
-			HandleQueueEvent_vd();
+			HandleRingEvent_vd();
         }
 
         if(0 != (uxBits_st & CYCLE_TIMER))
         {
-			PublishSensorData_vd(sensId_u8);
-            PublishSensorParam_vd(sensId_u8);
-            sensId_u8 = (sensId_u8 + 1U) % 2U;
+            RunPublishScheduler_vd();
+            SaveRegistry_vd(false);
+            if(   (MQTT_STATE_CONNECTED == this_sst.mqtt_en)
+               && (pdMS_TO_TICKS(LAT_PUB_PERIOD_MS) 
+                        <= (xTaskGetTickCount() - this_sst.latPub_st)))
+            {
+                this_sst.latPub_st = xTaskGetTickCount();
+                PublishLatencyStats_vd();
+            }
+        }
+
+        if(0 != (uxBits_st & REPLAY_TIMER))
+        {
+            ReplaySamples_vd();
+        }
+
+        if(0 != (uxBits_st & REGISTRY_EVENT))
+        {
+            HandleRegistryEvent_vd();
+        }
+
+        if(0 != (uxBits_st & SENSOR_RESET))
+        {
+            // unknown sensors are dropped, the registered sensors start again
+            ResetSensors_vd();
+            ApplyRegistry_vd();
+            ESP_LOGI(TAG, "sensors reset, %d known sensors kept", this_sst.usedSensors_u8);
         }
+        xSemaphoreGive(this_sst.sensMutex_st);
     }
 }
@@ -43,14 +43,29 @@ vAUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "mqtt_client.h"
+#include "esp_timer.h"
 
 /****************************************************************************************/
 /* Local constant defines */
 
 #define MODULE_TAG "mqttdrv"
 
+#define PUB_SLOTS_NUM       4U      // number of publications which can be in flight
+#define EARLY_ACKS_NUM      PUB_SLOTS_NUM   // acknowledges received before the msg id
+
+#define LVC_ENTRIES_NUM     16U     // number of topics held in the last value cache
+#define LVC_TOPIC_SIZE      64U     // publications with longer topics bypass the cache
+#define LVC_DATA_SIZE       64U     // publications with longer data bypass the cache
+#define LVC_MAX_AGE_MS      300000U // unchanged values are published again, 0 = never
+
+#define TOPIC_LEVEL_SEP     '/'
+#define TOPIC_WILDCARD_ONE  '+'     // single level wildcard
+#define TOPIC_WILDCARD_ALL  '#'     // multi level wildcard
+#define TOPIC_CHILDS_MIN    4U      // initial size of the child array of a topic level
+
 /****************************************************************************************/
 /* Local function like makros */
 #define CHECK_EXE(arg) utils_CheckAndLogExecution_vd(MODULE_TAG, arg, __LINE__)
@@ -73,8 +88,62 @@ typedef struct mqttdrv_subsObj_tag
      bool subscribed_bol;
      mqttdrv_subsHdl_t next_xp;
      mqttdrv_subsHdl_t last_xp;
+     mqttdrv_subsHdl_t nextInNode_xp;   // next subscription with the same topic filter
 }mqttdrv_subsObj_t;
 
+typedef struct topicNode_tag
+{
+     struct topicNode_tag **childs_stpp;    // plain levels sorted by length and content
+     struct topicNode_tag *wildOne_stp;     // '+' level
+     struct topicNode_tag *wildAll_stp;     // '#' level
+     mqttdrv_subsHdl_t subs_xp;         // subscriptions whose filter ends at this level
+     uint16_t childsNum_u16;
+     uint16_t childsSize_u16;
+     uint16_t levelLen_u16;
+     char level_ca[];                   // topic level, not zero terminated
+}topicNode_t;
+
+typedef struct rxAssembly_tag
+{
+     bool active_bol;
+     uint32_t topicLen_u32;
+     uint32_t totalLen_u32;
+     uint32_t rcvdLen_u32;
+     char topic_ca[mqttif_MAX_SIZE_OF_TOPIC];
+     char data_ca[mqttif_MAX_SIZE_OF_DATA];
+}rxAssembly_t;
+
+typedef enum pubSlotState_tag
+{
+     SLOT_FREE,
+     SLOT_PENDING,
+     SLOT_WAIT_ACK
+}pubSlotState_t;
+
+typedef struct pubSlot_tag
+{
+     pubSlotState_t state_en;
+     mqttif_msg_t msg_st;
+     uint32_t queuedUs_u32;     // time stamp of the hand over to the mqtt driver
+     char topic_ca[mqttif_MAX_SIZE_OF_TOPIC];
+     char data_ca[mqttif_MAX_SIZE_OF_DATA];
+}pubSlot_t;
+
+typedef struct lvcEntry_tag
+{
+     bool used_bol;
+     bool pending_bol;          // newest value is not published so far
+     TickType_t pubTime_st;     // tick count of the last publication
+     uint32_t rxUs_u32;         // latency stamp of the pending value
+     mqttif_Acked_td acked_fp;  // acknowledge callback of the pending value or NULL
+     int32_t qos_s32;
+     int32_t retain_s32;
+     uint16_t topicLen_u16;
+     uint16_t dataLen_u16;
+     char topic_ca[LVC_TOPIC_SIZE];
+     char data_ca[LVC_DATA_SIZE];
+}lvcEntry_t;
+
 typedef struct objectData_tag
 {
      objectState_t state_en;
@@ -86,6 +155,17 @@ typedef struct objectData_tag
 /* Local functions prototypes: */
 static void AddSubsToList_vd(mqttdrv_subsHdl_t subsHdl_xp);
 static void RemoveSubsFromList_vd(mqttdrv_subsHdl_t subsHdl_xp);
+static void IndexAddSubs_vd(mqttdrv_subsHdl_t subsHdl_xp);
+static bool IndexRemoveSubs_bol(topicNode_t *node_stp, const char *level_cchp,
+                                    const char *end_cchp, mqttdrv_subsHdl_t subsHdl_xp);
+static void IndexDispatch_vd(const topicNode_t *node_stp, const char *level_cchp,
+                                const char *end_cchp, mqttif_msg_t *msg_stp);
+static void IndexNotifySubs_vd(const topicNode_t *node_stp, mqttif_msg_t *msg_stp);
+static bool IndexFindChild_bol(const topicNode_t *node_stp, const char *level_cchp,
+                                uint16_t levelLen_u16, uint16_t *pos_u16p);
+static topicNode_t **IndexGetWildcard_stpp(topicNode_t *node_stp, const char *level_cchp,
+                                            uint16_t levelLen_u16);
+static const char *GetLevelEnd_cchp(const char *level_cchp, const char *end_cchp);
 static esp_err_t MqttEventHandler_st(esp_mqtt_event_handle_t event_stp);
 static void HandleConnect_vd(esp_mqtt_event_handle_t event_stp);
 static void HandleDisconnect_vd(esp_mqtt_event_handle_t event_stp);
@@ -94,6 +174,23 @@ static void HandleUnsubscription_vd(esp_mqtt_event_handle_t event_stp);
 static void HandlePublish_vd(esp_mqtt_event_handle_t event_stp);
 static void HandleData_vd(esp_mqtt_event_handle_t event_stp);
 static void HandleError_vd(esp_mqtt_event_handle_t event_stp);
+static bool AssembleData_bol(esp_mqtt_event_handle_t event_stp);
+static void DispatchData_vd(char *topic_chp, uint32_t topicLen_u32, char *data_chp,
+                                uint32_t dataLen_u32);
+static void ReleasePubSlot_vd(uint8_t slotIdx_u8);
+static void ReleaseWaitingSlots_vd(void);
+static bool TakeEarlyAck_bol(int32_t msgId_s32);
+static esp_err_t EnqueuePublication_td(const char *topic_cchp, uint32_t topicLen_u32,
+                                        const char *data_cchp, uint32_t dataLen_u32,
+                                        int32_t qos_s32, int32_t retain_s32,
+                                        mqttif_msg_t *stamp_stp, uint32_t timeOut_u32);
+static void NotifyAcked_vd(uint8_t slotIdx_u8);
+static uint32_t GetTimeUs_u32(void);
+static esp_err_t PublishCached_td(mqttif_msg_t *msg_stp, uint32_t timeOut_u32);
+static lvcEntry_t *GetCacheEntry_stp(mqttif_msg_t *msg_stp);
+static void StoreCacheEntry_vd(lvcEntry_t *entry_stp, mqttif_msg_t *msg_stp);
+static void FlushCache_vd(void);
+static void PublishPendingSlots_vd(void);
 static esp_err_t Connect(void);
 static esp_err_t Disconnect(void);
 static void Task_vd(void *pvParameters);
@@ -117,11 +214,32 @@ static objectData_t this_sst =
 
 static EventGroupHandle_t mqttEventGroup_sts;
 
-static SemaphoreHandle_t publishSema_sts;
-
-static char topicVector_sca[mqttif_MAX_SIZE_OF_TOPIC];
-static char dataVector_sca[mqttif_MAX_SIZE_OF_DATA];
-static mqttif_msg_t pubMsg_sts;
+// slot indices which are free for new publications, the ring is full if empty
+static QueueHandle_t freeSlotQueue_sts;
+// slot indices which are filled and wait for the mqtt task to be published
+static QueueHandle_t pendingSlotQueue_sts;
+
+static pubSlot_t pubSlots_sta[PUB_SLOTS_NUM];
+// protects the slot states and msg ids between the mqtt task and the client task
+static portMUX_TYPE slotMux_sst = portMUX_INITIALIZER_UNLOCKED;
+// acknowledges which arrived before esp_mqtt_client_publish returned the msg id
+static int32_t earlyAcks_s32a[EARLY_ACKS_NUM];
+static uint8_t earlyAckIdx_u8s = 0U;
+// incremented with every connection loss, publications of an old session are released
+static uint32_t session_u32s = 0U;
+
+// last published value per topic, protected by the cache mutex
+static lvcEntry_t lvcEntries_sta[LVC_ENTRIES_NUM];
+static SemaphoreHandle_t lvcMutex_sts;
+static mqttdrv_cacheStats_t lvcStats_sts;
+// set if a cache flush stopped because all publication slots were in use
+static bool lvcFlushPending_bol = false;
+
+// root of the subscription topic index, the root itself holds no topic level
+static topicNode_t topicRoot_sts;
+
+// reassembly buffer for received messages split over several data events
+static rxAssembly_t rxAssembly_sts;
 /****************************************************************************************/
 /* Global functions (unlimited visibility) */
 
@@ -192,15 +310,29 @@ esp_err_t mqttdrv_Initialize_td(mqttdrv_param_t *param_stp)
         ESP_LOGE(TAG, "mqtt client init wrong state detected...");
     }
 
-    publishSema_sts = xSemaphoreCreateBinary();
-    if(NULL == publishSema_sts)
+    freeSlotQueue_sts = xQueueCreate(PUB_SLOTS_NUM, sizeof(uint8_t));
+    pendingSlotQueue_sts = xQueueCreate(PUB_SLOTS_NUM, sizeof(uint8_t));
+    if((NULL == freeSlotQueue_sts) || (NULL == pendingSlotQueue_sts))
     {
         result_st = ESP_FAIL;
-        ESP_LOGE(TAG, "mqtt client init sema alloc failed...");
+        ESP_LOGE(TAG, "mqtt client init publish queue alloc failed...");
     }
-    else
+
+    if(NULL == lvcMutex_sts)
     {
-        xSemaphoreGive(publishSema_sts);
+        lvcMutex_sts = xSemaphoreCreateMutex();
+        if(NULL == lvcMutex_sts)
+        {
+            // publications work without the cache, only log the failure
+            ESP_LOGE(TAG, "mqtt client init cache mutex alloc failed...");
+        }
+    }
+
+    for(uint8_t slotIdx_u8 = 0U; slotIdx_u8 < PUB_SLOTS_NUM; slotIdx_u8++)
+    {
+        pubSlots_sta[slotIdx_u8].msg_st.topic_chp = pubSlots_sta[slotIdx_u8].topic_ca;
+        pubSlots_sta[slotIdx_u8].msg_st.data_chp = pubSlots_sta[slotIdx_u8].data_ca;
+        ReleasePubSlot_vd(slotIdx_u8);
     }
 
     mqttEventGroup_sts = xEventGroupCreate();
@@ -262,6 +394,7 @@ mqttdrv_subsHdl_t mqttdrv_AllocSubs_xp(mqttif_substParam_t *subsParam_stp)
             memcpy(&handle_xp->param_st, subsParam_stp, sizeof(handle_xp->param_st));
             handle_xp->subscribed_bol = false;
             handle_xp->next_xp = NULL;
+            handle_xp->nextInNode_xp = NULL;
 
             // add the handle to the list, either as first element or at the end
             AddSubsToList_vd(handle_xp);
@@ -394,7 +527,7 @@ uint8_t mqttdrv_GetNumberOfSubscriptions_td(void)
 }
 
 /**---------------------------------------------------------------------------------------
- * @brief     Un-Subscribe MQTT message
+ * @brief     Publish MQTT message
 *//*-----------------------------------------------------------------------------------*/
 esp_err_t mqttdrv_Publish_td(mqttif_msg_t *msg_stp, uint32_t timeOut_u32)
 {
@@ -402,49 +535,42 @@ esp_err_t mqttdrv_Publish_td(mqttif_msg_t *msg_stp, uint32_t timeOut_u32)
 
     ESP_LOGD(TAG, "publish request function called...");
 
-    if(NULL == publishSema_sts)
-        ESP_LOGE(TAG, "publish sema is null");
-    if(NULL == msg_stp)
-            ESP_LOGE(TAG, "publish msg is null");
-    if(mqttif_MAX_SIZE_OF_DATA < msg_stp->dataLen_u32)
+    if((NULL == freeSlotQueue_sts) || (NULL == pendingSlotQueue_sts))
+    {
+        ESP_LOGE(TAG, "publish queue is null");
+    }
+    else if(NULL == msg_stp)
+    {
+        ESP_LOGE(TAG, "publish msg is null");
+    }
+    else if(mqttif_MAX_SIZE_OF_DATA <= msg_stp->dataLen_u32)
+    {
         ESP_LOGE(TAG, "publish msg data length max reached");
-    if(mqttif_MAX_SIZE_OF_TOPIC < msg_stp->topicLen_u32)
-            ESP_LOGE(TAG, "publish msg topic length max: %d", msg_stp->topicLen_u32);
-
-    if(   (NULL != publishSema_sts)
-       && (NULL != msg_stp)
-       && (mqttif_MAX_SIZE_OF_DATA > msg_stp->dataLen_u32)
-       && (mqttif_MAX_SIZE_OF_TOPIC > msg_stp->topicLen_u32))
-    {
-        ESP_LOGD(TAG, "publish msg parameter check ok...");
-        /* See if we can obtain the semaphore.  If the semaphore is not
-        available wait to see if it becomes free. */
-        if(pdTRUE == xSemaphoreTake(publishSema_sts, ( TickType_t ) timeOut_u32))
-        {
-            /* We were able to obtain the semaphore and can now access the
-            shared resource. */
-            ESP_LOGD(TAG, "publish sema obtained...");
-            memset(topicVector_sca, 0x00, mqttif_MAX_SIZE_OF_TOPIC);
-            memset(dataVector_sca, 0x00, mqttif_MAX_SIZE_OF_TOPIC);
-            pubMsg_sts.topic_chp = topicVector_sca;
-            pubMsg_sts.data_chp = dataVector_sca;
-            pubMsg_sts.topicLen_u32 = msg_stp->topicLen_u32;
-            pubMsg_sts.dataLen_u32 = msg_stp->dataLen_u32;
-            memcpy(pubMsg_sts.topic_chp, msg_stp->topic_chp, pubMsg_sts.topicLen_u32);
-            memcpy(pubMsg_sts.data_chp, msg_stp->data_chp, pubMsg_sts.dataLen_u32);
-            pubMsg_sts.msgId_s32 = 0;
-            pubMsg_sts.qos_s32 = msg_stp->qos_s32;
-            pubMsg_sts.retain_s32 = msg_stp->qos_s32;
+    }
+    else if(mqttif_MAX_SIZE_OF_TOPIC <= msg_stp->topicLen_u32)
+    {
+        ESP_LOGE(TAG, "publish msg topic length max: %d", msg_stp->topicLen_u32);
+    }
+    else
+    {
+        result_st = PublishCached_td(msg_stp, timeOut_u32);
+    }
+    return(result_st);
+}
 
-            xEventGroupSetBits(mqttEventGroup_sts, PUBLISH_REQ);
-            result_st = ESP_OK;
-        }
-        else
-        {
-            /* We could not obtain the semaphore and can therefore not access
-            the shared resource safely. */
-            ESP_LOGW(TAG, "publish sema request failed...");
-        }
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the counters of the publication last value cache
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t mqttdrv_GetCacheStats_td(mqttdrv_cacheStats_t *stats_stp)
+{
+    esp_err_t result_st = ESP_FAIL;
+
+    if(   (NULL != stats_stp) && (NULL != lvcMutex_sts)
+       && (pdTRUE == xSemaphoreTake(lvcMutex_sts, portMAX_DELAY)))
+    {
+        memcpy(stats_stp, &lvcStats_sts, sizeof(mqttdrv_cacheStats_t));
+        xSemaphoreGive(lvcMutex_sts);
+        result_st = ESP_OK;
     }
     return(result_st);
 }
@@ -461,6 +587,8 @@ esp_err_t mqttdrv_Publish_td(mqttif_msg_t *msg_stp, uint32_t timeOut_u32)
 *//*------------------------------------------------------------------------------------*/
 static void AddSubsToList_vd(mqttdrv_subsHdl_t subsHdl_xp)
 {
+    IndexAddSubs_vd(subsHdl_xp);
+
     if(NULL == this_sst.subst_xp)
     {
         this_sst.subst_xp = subsHdl_xp;
@@ -478,7 +606,7 @@ static void AddSubsToList_vd(mqttdrv_subsHdl_t subsHdl_xp)
 }
 
 /**---------------------------------------------------------------------------------------
- * @brief     Add the subscription object handle to the list for later handling
+ * @brief     Remove the subscription object handle from the list and free it
  * @author    S. Wink
  * @date      24. Jan. 2019
  * @param     subsHdl_xp        subscription handler
@@ -488,18 +616,28 @@ static void RemoveSubsFromList_vd(mqttdrv_subsHdl_t subsHdl_xp)
 {
     mqttdrv_subsHdl_t last_xp = NULL;
     mqttdrv_subsHdl_t current_xp;
+    const char *topic_cchp;
 
     if((NULL != subsHdl_xp) && (NULL != this_sst.subst_xp))
     {
-        last_xp = this_sst.subst_xp;
-        current_xp = this_sst.subst_xp->next_xp;
+        topic_cchp = (const char *)&subsHdl_xp->param_st.topic_u8a[0];
+        (void)IndexRemoveSubs_bol(&topicRoot_sts, topic_cchp,
+                                    topic_cchp + strlen(topic_cchp), subsHdl_xp);
 
+        current_xp = this_sst.subst_xp;
         while(NULL != current_xp)
         {
             if(subsHdl_xp == current_xp)
             {
                 // we found the object to remove
-                last_xp->next_xp = current_xp->next_xp;
+                if(NULL == last_xp)
+                {
+                    this_sst.subst_xp = current_xp->next_xp;
+                }
+                else
+                {
+                    last_xp->next_xp = current_xp->next_xp;
+                }
                 free(current_xp);
                 break;
             }
@@ -509,6 +647,352 @@ static void RemoveSubsFromList_vd(mqttdrv_subsHdl_t subsHdl_xp)
     }
 }
 
+/**---------------------------------------------------------------------------------------
+ * @brief     Returns the end of the topic level which starts at level_cchp, this is
+ *              either the next level separator or the end of the topic
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     level_cchp        start of the topic level
+ * @param     end_cchp          end of the complete topic
+ * @return    pointer to the level separator or end_cchp
+*//*------------------------------------------------------------------------------------*/
+static const char *GetLevelEnd_cchp(const char *level_cchp, const char *end_cchp)
+{
+    const char *sep_cchp = memchr(level_cchp, TOPIC_LEVEL_SEP, end_cchp - level_cchp);
+
+    return((NULL != sep_cchp) ? sep_cchp : end_cchp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Binary search of a plain topic level in the sorted child array of a node,
+ *              the levels are ordered by length first and by content second
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     node_stp          index node of the parent level
+ * @param     level_cchp        start of the topic level
+ * @param     levelLen_u16      length of the topic level
+ * @param     pos_u16p          position of the level or where it has to be inserted
+ * @return    true if the level was found
+*//*------------------------------------------------------------------------------------*/
+static bool IndexFindChild_bol(const topicNode_t *node_stp, const char *level_cchp,
+                                uint16_t levelLen_u16, uint16_t *pos_u16p)
+{
+    uint16_t low_u16 = 0U;
+    uint16_t high_u16 = node_stp->childsNum_u16;
+    uint16_t mid_u16;
+    const topicNode_t *child_cstp;
+    int32_t cmp_s32;
+
+    while(low_u16 < high_u16)
+    {
+        mid_u16 = low_u16 + ((high_u16 - low_u16) / 2U);
+        child_cstp = node_stp->childs_stpp[mid_u16];
+        cmp_s32 = (int32_t)child_cstp->levelLen_u16 - (int32_t)levelLen_u16;
+        if(0 == cmp_s32)
+        {
+            cmp_s32 = memcmp(child_cstp->level_ca, level_cchp, levelLen_u16);
+        }
+
+        if(0 == cmp_s32)
+        {
+            *pos_u16p = mid_u16;
+            return(true);
+        }
+        else if(0 > cmp_s32)
+        {
+            low_u16 = mid_u16 + 1U;
+        }
+        else
+        {
+            high_u16 = mid_u16;
+        }
+    }
+    *pos_u16p = low_u16;
+    return(false);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Returns the reference of the wildcard level of a node, if the topic level
+ *              is a wildcard
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     node_stp          index node of the parent level
+ * @param     level_cchp        start of the topic level
+ * @param     levelLen_u16      length of the topic level
+ * @return    reference of the wildcard level or NULL for a plain level
+*//*------------------------------------------------------------------------------------*/
+static topicNode_t **IndexGetWildcard_stpp(topicNode_t *node_stp, const char *level_cchp,
+                                            uint16_t levelLen_u16)
+{
+    topicNode_t **wild_stpp = NULL;
+
+    if((1U == levelLen_u16) && (TOPIC_WILDCARD_ONE == level_cchp[0]))
+    {
+        wild_stpp = &node_stp->wildOne_stp;
+    }
+    else if((1U == levelLen_u16) && (TOPIC_WILDCARD_ALL == level_cchp[0]))
+    {
+        wild_stpp = &node_stp->wildAll_stp;
+    }
+    return(wild_stpp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Insert the subscription into the topic index, missing topic levels are
+ *              allocated on the way
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     subsHdl_xp        subscription handler
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void IndexAddSubs_vd(mqttdrv_subsHdl_t subsHdl_xp)
+{
+    topicNode_t *node_stp = &topicRoot_sts;
+    topicNode_t *child_stp;
+    topicNode_t **wild_stpp;
+    topicNode_t **childs_stpp;
+    const char *level_cchp = (const char *)&subsHdl_xp->param_st.topic_u8a[0];
+    const char *end_cchp = level_cchp + strlen(level_cchp);
+    const char *levelEnd_cchp;
+    uint16_t levelLen_u16;
+    uint16_t pos_u16;
+    uint16_t size_u16;
+
+    while(NULL != node_stp)
+    {
+        levelEnd_cchp = GetLevelEnd_cchp(level_cchp, end_cchp);
+        levelLen_u16 = (uint16_t)(levelEnd_cchp - level_cchp);
+
+        wild_stpp = IndexGetWildcard_stpp(node_stp, level_cchp, levelLen_u16);
+        if(NULL != wild_stpp)
+        {
+            child_stp = *wild_stpp;
+        }
+        else if(true == IndexFindChild_bol(node_stp, level_cchp, levelLen_u16, &pos_u16))
+        {
+            child_stp = node_stp->childs_stpp[pos_u16];
+        }
+        else
+        {
+            child_stp = NULL;
+        }
+
+        if(NULL == child_stp)
+        {
+            if(   (NULL == wild_stpp) 
+               && (node_stp->childsNum_u16 == node_stp->childsSize_u16))
+            {
+                size_u16 = (0U == node_stp->childsSize_u16) ? 
+                                TOPIC_CHILDS_MIN : (2U * node_stp->childsSize_u16);
+                childs_stpp = realloc(node_stp->childs_stpp, 
+                                        size_u16 * sizeof(topicNode_t *));
+                if(NULL == childs_stpp)
+                {
+                    ESP_LOGE(TAG, "topic index allocation failed...");
+                    break;
+                }
+                node_stp->childs_stpp = childs_stpp;
+                node_stp->childsSize_u16 = size_u16;
+            }
+
+            child_stp = calloc(1U, sizeof(topicNode_t) + levelLen_u16);
+            if(NULL == child_stp)
+            {
+                ESP_LOGE(TAG, "topic index allocation failed...");
+                break;
+            }
+            child_stp->levelLen_u16 = levelLen_u16;
+            memcpy(child_stp->level_ca, level_cchp, levelLen_u16);
+
+            if(NULL != wild_stpp)
+            {
+                *wild_stpp = child_stp;
+            }
+            else
+            {
+                memmove(&node_stp->childs_stpp[pos_u16 + 1U], 
+                        &node_stp->childs_stpp[pos_u16],
+                        (node_stp->childsNum_u16 - pos_u16) * sizeof(topicNode_t *));
+                node_stp->childs_stpp[pos_u16] = child_stp;
+                node_stp->childsNum_u16++;
+            }
+        }
+        node_stp = child_stp;
+
+        if(end_cchp == levelEnd_cchp)
+        {
+            // last level of the filter reached, attach the subscription here
+            subsHdl_xp->nextInNode_xp = node_stp->subs_xp;
+            node_stp->subs_xp = subsHdl_xp;
+            break;
+        }
+        level_cchp = levelEnd_cchp + 1;
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Remove the subscription from the topic index and free topic levels which
+ *              are not used anymore
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     node_stp          index node of the parent level
+ * @param     level_cchp        start of the current filter level
+ * @param     end_cchp          end of the subscription filter
+ * @param     subsHdl_xp        subscription handler
+ * @return    true if the parent node has no children and subscriptions anymore
+*//*------------------------------------------------------------------------------------*/
+static bool IndexRemoveSubs_bol(topicNode_t *node_stp, const char *level_cchp,
+                                    const char *end_cchp, mqttdrv_subsHdl_t subsHdl_xp)
+{
+    const char *levelEnd_cchp = GetLevelEnd_cchp(level_cchp, end_cchp);
+    uint16_t levelLen_u16 = (uint16_t)(levelEnd_cchp - level_cchp);
+    topicNode_t **wild_stpp = IndexGetWildcard_stpp(node_stp, level_cchp, levelLen_u16);
+    topicNode_t *child_stp = NULL;
+    mqttdrv_subsHdl_t *subs_xpp;
+    bool childUnused_bol = false;
+    uint16_t pos_u16 = 0U;
+
+    if(NULL != wild_stpp)
+    {
+        child_stp = *wild_stpp;
+    }
+    else if(true == IndexFindChild_bol(node_stp, level_cchp, levelLen_u16, &pos_u16))
+    {
+        child_stp = node_stp->childs_stpp[pos_u16];
+    }
+
+    if(NULL != child_stp)
+    {
+        if(end_cchp == levelEnd_cchp)
+        {
+            subs_xpp = &child_stp->subs_xp;
+            while((NULL != *subs_xpp) && (subsHdl_xp != *subs_xpp))
+            {
+                subs_xpp = &(*subs_xpp)->nextInNode_xp;
+            }
+            if(NULL != *subs_xpp)
+            {
+                *subs_xpp = subsHdl_xp->nextInNode_xp;
+            }
+            childUnused_bol =    (NULL == child_stp->subs_xp) 
+                              && (0U == child_stp->childsNum_u16)
+                              && (NULL == child_stp->wildOne_stp)
+                              && (NULL == child_stp->wildAll_stp);
+        }
+        else
+        {
+            childUnused_bol = IndexRemoveSubs_bol(child_stp, levelEnd_cchp + 1, end_cchp,
+                                                    subsHdl_xp);
+        }
+
+        if(true == childUnused_bol)
+        {
+            if(NULL != wild_stpp)
+            {
+                *wild_stpp = NULL;
+            }
+            else
+            {
+                node_stp->childsNum_u16--;
+                memmove(&node_stp->childs_stpp[pos_u16], 
+                        &node_stp->childs_stpp[pos_u16 + 1U],
+                        (node_stp->childsNum_u16 - pos_u16) * sizeof(topicNode_t *));
+                if(0U == node_stp->childsNum_u16)
+                {
+                    free(node_stp->childs_stpp);
+                    node_stp->childs_stpp = NULL;
+                    node_stp->childsSize_u16 = 0U;
+                }
+            }
+            free(child_stp);
+        }
+    }
+
+    return(   (NULL == node_stp->subs_xp) 
+           && (0U == node_stp->childsNum_u16)
+           && (NULL == node_stp->wildOne_stp)
+           && (NULL == node_stp->wildAll_stp));
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Walk the topic index level by level and call all subscriptions whose
+ *              filter matches the received topic, including '+' and '#' wildcards. The
+ *              plain level is found by a binary search, so a level costs O(log n) 
+ *              compares for n plain levels below the same parent.
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     node_stp          index node of the parent level
+ * @param     level_cchp        start of the current topic level
+ * @param     end_cchp          end of the received topic
+ * @param     msg_stp           received message
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void IndexDispatch_vd(const topicNode_t *node_stp, const char *level_cchp,
+                                const char *end_cchp, mqttif_msg_t *msg_stp)
+{
+    const char *levelEnd_cchp = GetLevelEnd_cchp(level_cchp, end_cchp);
+    uint16_t levelLen_u16 = (uint16_t)(levelEnd_cchp - level_cchp);
+    const topicNode_t *match_cstpa[2] = {node_stp->wildOne_stp, NULL};
+    const topicNode_t *child_cstp;
+    uint16_t pos_u16;
+
+    if(NULL != node_stp->wildAll_stp)
+    {
+        // multi level wildcard matches the remaining topic
+        IndexNotifySubs_vd(node_stp->wildAll_stp, msg_stp);
+    }
+    if(true == IndexFindChild_bol(node_stp, level_cchp, levelLen_u16, &pos_u16))
+    {
+        match_cstpa[1] = node_stp->childs_stpp[pos_u16];
+    }
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < 2U; idx_u8++)
+    {
+        child_cstp = match_cstpa[idx_u8];
+        if((NULL != child_cstp) && (end_cchp != levelEnd_cchp))
+        {
+            IndexDispatch_vd(child_cstp, levelEnd_cchp + 1, end_cchp, msg_stp);
+        }
+        else if(NULL != child_cstp)
+        {
+            IndexNotifySubs_vd(child_cstp, msg_stp);
+
+            // a multi level wildcard also matches its parent level
+            if(NULL != child_cstp->wildAll_stp)
+            {
+                IndexNotifySubs_vd(child_cstp->wildAll_stp, msg_stp);
+            }
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Call the data receive callbacks of all subscriptions of an index node
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     node_stp          index node with the matching filter
+ * @param     msg_stp           received message
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void IndexNotifySubs_vd(const topicNode_t *node_stp, mqttif_msg_t *msg_stp)
+{
+    mqttdrv_subsHdl_t subs_xp = node_stp->subs_xp;
+
+    while(NULL != subs_xp)
+    {
+        if(NULL != subs_xp->param_st.dataRecv_fp)
+        {
+            msg_stp->token_u32 = subs_xp->param_st.token_u32;
+            subs_xp->param_st.dataRecv_fp(msg_stp);
+        }
+        else
+        {
+            ESP_LOGW(TAG, "subscription received without callback function");
+        }
+        subs_xp = subs_xp->nextInNode_xp;
+    }
+}
+
 /**---------------------------------------------------------------------------------------
  * @brief     Event handling for MQTT events
  * @author    S. Wink
@@ -601,6 +1085,9 @@ static void HandleConnect_vd(esp_mqtt_event_handle_t event_stp)
         this_sst.state_en = STATE_CONNECTED;
         ESP_LOGI(TAG, "mqtt connected...");
 
+        // publish the newest values which were collected while offline
+        FlushCache_vd();
+
         // TODO message to control task that MQTT is online
 
         mqttdrv_subsHdl_t index_xps = this_sst.subst_xp;
@@ -644,6 +1131,8 @@ static void HandleDisconnect_vd(esp_mqtt_event_handle_t event_stp)
     {
         this_sst.state_en = STATE_DISCONNECTED;
         ESP_LOGI(TAG, "mqtt disconnected...");
+        // no acknowledge will be received for the publications in flight
+        ReleaseWaitingSlots_vd();
 
         // TODO: message to control task that MQTT is offline
 
@@ -678,20 +1167,41 @@ static void HandleDisconnect_vd(esp_mqtt_event_handle_t event_stp)
 *//*------------------------------------------------------------------------------------*/
 static void HandlePublish_vd(esp_mqtt_event_handle_t event_stp)
 {
+    uint8_t slotIdx_u8 = 0U;
+
+    portENTER_CRITICAL(&slotMux_sst);
+    while(PUB_SLOTS_NUM > slotIdx_u8)
+    {
+        if(   (SLOT_WAIT_ACK == pubSlots_sta[slotIdx_u8].state_en)
+           && (event_stp->msg_id == pubSlots_sta[slotIdx_u8].msg_st.msgId_s32))
+        {
+            break;
+        }
+        slotIdx_u8++;
+    }
+    if(PUB_SLOTS_NUM == slotIdx_u8)
+    {
+        // the publishing task may not have stored the msg id so far
+        earlyAcks_s32a[earlyAckIdx_u8s] = event_stp->msg_id;
+        earlyAckIdx_u8s = (earlyAckIdx_u8s + 1U) % EARLY_ACKS_NUM;
+    }
+    portEXIT_CRITICAL(&slotMux_sst);
 
-    if(event_stp->msg_id == pubMsg_sts.msgId_s32)
+    if(PUB_SLOTS_NUM > slotIdx_u8)
     {
         ESP_LOGD(TAG, "publication as requested complete, msg_id=%d", event_stp->msg_id);
+        NotifyAcked_vd(slotIdx_u8);
+        ReleasePubSlot_vd(slotIdx_u8);
+        if(true == lvcFlushPending_bol)
+        {
+            // a slot is free again, continue the interrupted cache flush
+            xEventGroupSetBits(mqttEventGroup_sts, PUBLISH_REQ);
+        }
     }
     else
     {
-        ESP_LOGW(TAG, "unexpected publication:, msg_id=%d", event_stp->msg_id);
+        ESP_LOGD(TAG, "acknowledge before msg id stored, msg_id=%d", event_stp->msg_id);
     }
-
-    /* We have finished accessing the shared resource.  Release the
-    semaphore. */
-    ESP_LOGD(TAG, "sema released...");
-    xSemaphoreGive(publishSema_sts);
 }
 
 /**---------------------------------------------------------------------------------------
@@ -703,55 +1213,576 @@ static void HandlePublish_vd(esp_mqtt_event_handle_t event_stp)
 *//*------------------------------------------------------------------------------------*/
 static void HandleData_vd(esp_mqtt_event_handle_t event_stp)
 {
-    mqttdrv_subsHdl_t index_xps = this_sst.subst_xp;
+    if(   (0 == event_stp->current_data_offset)
+       && (event_stp->data_len == event_stp->total_data_len))
+    {
+        // complete message in one event, hand over the client buffers directly
+        DispatchData_vd(event_stp->topic, event_stp->topic_len,
+                            event_stp->data, event_stp->data_len);
+    }
+    else if(true == AssembleData_bol(event_stp))
+    {
+        DispatchData_vd(&rxAssembly_sts.topic_ca[0], rxAssembly_sts.topicLen_u32,
+                            &rxAssembly_sts.data_ca[0], rxAssembly_sts.totalLen_u32);
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Collects the fragments of a received message which is split over several
+ *              data events. Only the first fragment contains the topic.
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     event_stp        event structure
+ * @return    true if the message is completely received
+*//*------------------------------------------------------------------------------------*/
+static bool AssembleData_bol(esp_mqtt_event_handle_t event_stp)
+{
+    bool complete_bol = false;
+    uint32_t offset_u32 = (uint32_t)event_stp->current_data_offset;
+    uint32_t dataLen_u32 = (uint32_t)event_stp->data_len;
+
+    if(0U == offset_u32)
+    {
+        rxAssembly_sts.active_bol = false;
+
+        if(   (NULL == event_stp->topic)
+           || (mqttif_MAX_SIZE_OF_TOPIC <= (uint32_t)event_stp->topic_len)
+           || (mqttif_MAX_SIZE_OF_DATA < (uint32_t)event_stp->total_data_len))
+        {
+            ESP_LOGW(TAG, "fragmented message too large, total length: %d",
+                        event_stp->total_data_len);
+        }
+        else
+        {
+            rxAssembly_sts.topicLen_u32 = (uint32_t)event_stp->topic_len;
+            rxAssembly_sts.totalLen_u32 = (uint32_t)event_stp->total_data_len;
+            rxAssembly_sts.rcvdLen_u32 = 0U;
+            memcpy(&rxAssembly_sts.topic_ca[0], event_stp->topic,
+                    rxAssembly_sts.topicLen_u32);
+            rxAssembly_sts.active_bol = true;
+        }
+    }
+
+    if(true == rxAssembly_sts.active_bol)
+    {
+        if(   (offset_u32 != rxAssembly_sts.rcvdLen_u32)
+           || ((offset_u32 + dataLen_u32) > rxAssembly_sts.totalLen_u32))
+        {
+            ESP_LOGW(TAG, "unexpected message fragment at offset: %d", offset_u32);
+            rxAssembly_sts.active_bol = false;
+        }
+        else
+        {
+            memcpy(&rxAssembly_sts.data_ca[offset_u32], event_stp->data, dataLen_u32);
+            rxAssembly_sts.rcvdLen_u32 += dataLen_u32;
+
+            if(rxAssembly_sts.rcvdLen_u32 == rxAssembly_sts.totalLen_u32)
+            {
+                rxAssembly_sts.active_bol = false;
+                complete_bol = true;
+            }
+        }
+    }
+
+    return(complete_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Hands over a complete received message to the matching subscriptions
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     topic_chp        topic of the message, not zero terminated
+ * @param     topicLen_u32     length of the topic
+ * @param     data_chp         message payload
+ * @param     dataLen_u32      length of the payload
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void DispatchData_vd(char *topic_chp, uint32_t topicLen_u32, char *data_chp,
+                                uint32_t dataLen_u32)
+{
     mqttif_msg_t msg_st;
 
-    msg_st.topic_chp = event_stp->topic;
-    msg_st.topicLen_u32 = event_stp->topic_len;
-    msg_st.dataLen_u32 = event_stp->data_len;
-    msg_st.data_chp = event_stp->data;
+    msg_st.topic_chp = topic_chp;
+    msg_st.topicLen_u32 = topicLen_u32;
+    msg_st.dataLen_u32 = dataLen_u32;
+    msg_st.data_chp = data_chp;
+    msg_st.msgId_s32 = 0;
+    msg_st.qos_s32 = 0;
+    msg_st.retain_s32 = 0;
+    msg_st.token_u32 = 0U;
 
     ESP_LOGD(TAG, "topic=%.*s, length: %d", msg_st.topicLen_u32, msg_st.topic_chp,
             msg_st.topicLen_u32);
-    ESP_LOGD(TAG, "data=%.*s, length: %d", msg_st.dataLen_u32, msg_st.data_chp,
-            msg_st.dataLen_u32);
+    ESP_LOGD(TAG, "data length: %d", msg_st.dataLen_u32);
 
-    if(NULL != index_xps)
+    if(NULL != topic_chp)
     {
-        while(NULL != index_xps)
+        IndexDispatch_vd(&topicRoot_sts, topic_chp, topic_chp + topicLen_u32, &msg_st);
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Handler for error event
+ * @author    S. Wink
+ * @date      31. Mar. 2019
+ * @param     event_stp        event structure
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void HandleError_vd(esp_mqtt_event_handle_t event_stp)
+{
+    ESP_LOGE(TAG, "MQTT_EVENT_ERROR detected...");
+
+    // ensure that the publication resources waiting for an acknowledge get released
+    ReleaseWaitingSlots_vd();
+    xEventGroupSetBits(mqttEventGroup_sts, MQTT_ERR);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Releases all slots waiting for an acknowledge after the session was lost.
+ *              Slots which are just handed over to the client are released by the
+ *              mqtt task, because the session counter changed.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void ReleaseWaitingSlots_vd(void)
+{
+    bool release_bola[PUB_SLOTS_NUM];
+
+    portENTER_CRITICAL(&slotMux_sst);
+    session_u32s++;
+    memset(earlyAcks_s32a, 0U, sizeof(earlyAcks_s32a));
+    for(uint8_t slotIdx_u8 = 0U; slotIdx_u8 < PUB_SLOTS_NUM; slotIdx_u8++)
+    {
+        release_bola[slotIdx_u8] = (SLOT_WAIT_ACK == pubSlots_sta[slotIdx_u8].state_en);
+        if(true == release_bola[slotIdx_u8])
+        {
+            // taken out of the search of the acknowledge handler
+            pubSlots_sta[slotIdx_u8].state_en = SLOT_PENDING;
+        }
+    }
+    portEXIT_CRITICAL(&slotMux_sst);
+
+    for(uint8_t slotIdx_u8 = 0U; slotIdx_u8 < PUB_SLOTS_NUM; slotIdx_u8++)
+    {
+        if(true == release_bola[slotIdx_u8])
+        {
+            ReleasePubSlot_vd(slotIdx_u8);
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Searches and removes an acknowledge which arrived before the msg id of its
+ *              publication was known, must be called with the slot lock taken
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     msgId_s32     msg id returned by the client
+ * @return    true if the publication was already acknowledged
+*//*------------------------------------------------------------------------------------*/
+static bool TakeEarlyAck_bol(int32_t msgId_s32)
+{
+    bool found_bol = false;
+
+    for(uint8_t ackIdx_u8 = 0U; ackIdx_u8 < EARLY_ACKS_NUM; ackIdx_u8++)
+    {
+        if((0 != msgId_s32) && (msgId_s32 == earlyAcks_s32a[ackIdx_u8]))
+        {
+            earlyAcks_s32a[ackIdx_u8] = 0;
+            found_bol = true;
+            break;
+        }
+    }
+    return(found_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Marks a publication slot as free and returns it to the free slot ring
+ * @author    S. Wink
+ * @date      16. Oct. 2026
+ * @param     slotIdx_u8        index of the publication slot
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void ReleasePubSlot_vd(uint8_t slotIdx_u8)
+{
+    pubSlots_sta[slotIdx_u8].state_en = SLOT_FREE;
+    pubSlots_sta[slotIdx_u8].msg_st.msgId_s32 = 0;
+    (void)xQueueSendToBack(freeSlotQueue_sts, &slotIdx_u8, 0U);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Hands the time stamps of an acknowledged publication to the publisher
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     slotIdx_u8        index of the publication slot
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void NotifyAcked_vd(uint8_t slotIdx_u8)
+{
+    const pubSlot_t *slot_cstp = &pubSlots_sta[slotIdx_u8];
+
+    if(NULL != slot_cstp->msg_st.acked_fp)
+    {
+        slot_cstp->msg_st.acked_fp(slot_cstp->msg_st.rxUs_u32, slot_cstp->queuedUs_u32,
+                                    GetTimeUs_u32());
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the time stamp of the publication latencies
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    time since boot in us, wraps after about 71 minutes
+*//*------------------------------------------------------------------------------------*/
+static uint32_t GetTimeUs_u32(void)
+{
+    return((uint32_t)esp_timer_get_time());
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Copies a message into a free publication slot and hands it over to the
+ *              mqtt task
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     topic_cchp        topic of the message
+ * @param     topicLen_u32      length of the topic
+ * @param     data_cchp         message payload
+ * @param     dataLen_u32       length of the payload
+ * @param     qos_s32           quality of service of the publication
+ * @param     retain_s32        retain flag of the publication
+ * @param     stamp_stp         message with the latency stamps, the acknowledge
+ *                                callback is taken over by the slot, NULL if none
+ * @param     timeOut_u32       ticks to wait for a free publication slot
+ * @return    ESP_OK if the message was queued for publication
+*//*------------------------------------------------------------------------------------*/
+static esp_err_t EnqueuePublication_td(const char *topic_cchp, uint32_t topicLen_u32,
+                                        const char *data_cchp, uint32_t dataLen_u32,
+                                        int32_t qos_s32, int32_t retain_s32,
+                                        mqttif_msg_t *stamp_stp, uint32_t timeOut_u32)
+{
+    esp_err_t result_st = ESP_FAIL;
+    uint8_t slotIdx_u8;
+    pubSlot_t *slot_stp;
+
+    /* See if we can obtain a free publication slot. If all slots are in flight
+    wait to see if one becomes free. */
+    if(pdTRUE == xQueueReceive(freeSlotQueue_sts, &slotIdx_u8, (TickType_t) timeOut_u32))
+    {
+        /* We own the slot until it is handed over to the mqtt task, no further
+        locking is needed to fill it. */
+        ESP_LOGD(TAG, "publish slot %d obtained...", slotIdx_u8);
+        slot_stp = &pubSlots_sta[slotIdx_u8];
+        memcpy(slot_stp->topic_ca, topic_cchp, topicLen_u32);
+        slot_stp->topic_ca[topicLen_u32] = '\0';
+        memcpy(slot_stp->data_ca, data_cchp, dataLen_u32);
+        slot_stp->data_ca[dataLen_u32] = '\0';
+        slot_stp->msg_st.topicLen_u32 = topicLen_u32;
+        slot_stp->msg_st.dataLen_u32 = dataLen_u32;
+        slot_stp->msg_st.msgId_s32 = 0;
+        slot_stp->msg_st.qos_s32 = qos_s32;
+        slot_stp->msg_st.retain_s32 = retain_s32;
+        slot_stp->msg_st.rxUs_u32 = 0U;
+        slot_stp->msg_st.acked_fp = NULL;
+        if(NULL != stamp_stp)
+        {
+            // only the first publication of a message buffer reports the acknowledge
+            slot_stp->msg_st.rxUs_u32 = stamp_stp->rxUs_u32;
+            slot_stp->msg_st.acked_fp = stamp_stp->acked_fp;
+            stamp_stp->acked_fp = NULL;
+        }
+        slot_stp->queuedUs_u32 = GetTimeUs_u32();
+        slot_stp->state_en = SLOT_PENDING;
+
+        (void)xQueueSendToBack(pendingSlotQueue_sts, &slotIdx_u8, 0U);
+        xEventGroupSetBits(mqttEventGroup_sts, PUBLISH_REQ);
+        result_st = ESP_OK;
+    }
+    else
+    {
+        /* All publication slots are still waiting for their acknowledge. */
+        ESP_LOGW(TAG, "publish slot request failed...");
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Runs a publication through the last value cache. Unchanged values are
+ *              suppressed, while disconnected the newest value per topic is kept in the
+ *              cache. Messages which do not fit into the cache are published directly.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     msg_stp           message to be published
+ * @param     timeOut_u32       ticks to wait for a free publication slot
+ * @return    ESP_OK if the message was queued, cached or suppressed
+*//*------------------------------------------------------------------------------------*/
+static esp_err_t PublishCached_td(mqttif_msg_t *msg_stp, uint32_t timeOut_u32)
+{
+    esp_err_t result_st = ESP_FAIL;
+    lvcEntry_t *entry_stp = NULL;
+    bool publish_bol = true;
+
+    if(   (NULL != lvcMutex_sts)
+       && (LVC_TOPIC_SIZE > msg_stp->topicLen_u32)
+       && (LVC_DATA_SIZE > msg_stp->dataLen_u32)
+       && (pdTRUE == xSemaphoreTake(lvcMutex_sts, portMAX_DELAY)))
+    {
+        entry_stp = GetCacheEntry_stp(msg_stp);
+        if(NULL == entry_stp)
+        {
+            // all entries hold offline values, publish without the cache
+        }
+        else if(STATE_CONNECTED != this_sst.state_en)
+        {
+            // offline, only the newest value per topic is kept until reconnection
+            if(true == entry_stp->pending_bol)
+            {
+                lvcStats_sts.coalesced_u32++;
+            }
+            StoreCacheEntry_vd(entry_stp, msg_stp);
+            entry_stp->pending_bol = true;
+            entry_stp->rxUs_u32 = msg_stp->rxUs_u32;
+            entry_stp->acked_fp = msg_stp->acked_fp;
+            msg_stp->acked_fp = NULL;
+            publish_bol = false;
+            result_st = ESP_OK;
+        }
+        else if(   (false == entry_stp->pending_bol)
+                && (msg_stp->dataLen_u32 == entry_stp->dataLen_u16)
+                && (msg_stp->qos_s32 == entry_stp->qos_s32)
+                && (msg_stp->retain_s32 == entry_stp->retain_s32)
+                && (0 == memcmp(entry_stp->data_ca, msg_stp->data_chp, msg_stp->dataLen_u32))
+                && (   (0U == LVC_MAX_AGE_MS)
+                    || (pdMS_TO_TICKS(LVC_MAX_AGE_MS)
+                            > (xTaskGetTickCount() - entry_stp->pubTime_st))))
+        {
+            lvcStats_sts.suppressed_u32++;
+            publish_bol = false;
+            result_st = ESP_OK;
+        }
+        else
+        {
+            StoreCacheEntry_vd(entry_stp, msg_stp);
+            entry_stp->pending_bol = false;
+        }
+        xSemaphoreGive(lvcMutex_sts);
+    }
+
+    if(true == publish_bol)
+    {
+        result_st = EnqueuePublication_td(msg_stp->topic_chp, msg_stp->topicLen_u32,
+                                            msg_stp->data_chp, msg_stp->dataLen_u32,
+                                            msg_stp->qos_s32, msg_stp->retain_s32,
+                                            msg_stp, timeOut_u32);
+
+        if(   (ESP_OK != result_st) && (NULL != entry_stp)
+           && (pdTRUE == xSemaphoreTake(lvcMutex_sts, portMAX_DELAY)))
+        {
+            // value was not sent, keep it for the next cache flush if still cached
+            if(   (msg_stp->topicLen_u32 == entry_stp->topicLen_u16)
+               && (0 == memcmp(entry_stp->topic_ca, msg_stp->topic_chp,
+                                msg_stp->topicLen_u32)))
+            {
+                entry_stp->pending_bol = true;
+                entry_stp->rxUs_u32 = msg_stp->rxUs_u32;
+                entry_stp->acked_fp = msg_stp->acked_fp;
+                msg_stp->acked_fp = NULL;
+                lvcFlushPending_bol = true;
+            }
+            xSemaphoreGive(lvcMutex_sts);
+        }
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Searches the cache entry of the message topic. If the topic is not cached
+ *              a free entry or the least recently published entry is taken. Entries
+ *              with unpublished values are never replaced. Has to be called with the
+ *              cache mutex taken.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     msg_stp           message to be published
+ * @return    pointer to the cache entry or NULL if no entry is available
+*//*------------------------------------------------------------------------------------*/
+static lvcEntry_t *GetCacheEntry_stp(mqttif_msg_t *msg_stp)
+{
+    lvcEntry_t *entry_stp = NULL;
+    lvcEntry_t *oldest_stp = NULL;
+    TickType_t now_st = xTaskGetTickCount();
+    uint8_t idx_u8;
+
+    for(idx_u8 = 0U; idx_u8 < LVC_ENTRIES_NUM; idx_u8++)
+    {
+        entry_stp = &lvcEntries_sta[idx_u8];
+        if(false == entry_stp->used_bol)
         {
-            if(0U == strncmp(event_stp->topic,
-                             (char *)&index_xps->param_st.topic_u8a[0],
-                             event_stp->topic_len))
+            if((NULL == oldest_stp) || (true == oldest_stp->used_bol))
             {
-                if(NULL !=  index_xps->param_st.dataRecv_fp)
+                oldest_stp = entry_stp;
+            }
+        }
+        else if(   (msg_stp->topicLen_u32 == entry_stp->topicLen_u16)
+                && (0 == memcmp(entry_stp->topic_ca, msg_stp->topic_chp,
+                                msg_stp->topicLen_u32)))
+        {
+            break;
+        }
+        else if(   (false == entry_stp->pending_bol)
+                && (   (NULL == oldest_stp)
+                    || (   (true == oldest_stp->used_bol)
+                        && ((now_st - entry_stp->pubTime_st) 
+                                > (now_st - oldest_stp->pubTime_st)))))
+        {
+            oldest_stp = entry_stp;
+        }
+    }
+
+    if(LVC_ENTRIES_NUM > idx_u8)
+    {
+        lvcStats_sts.hit_u32++;
+    }
+    else
+    {
+        lvcStats_sts.miss_u32++;
+        entry_stp = oldest_stp;
+        if(NULL != entry_stp)
+        {
+            entry_stp->used_bol = true;
+            entry_stp->pending_bol = false;
+            entry_stp->topicLen_u16 = (uint16_t)msg_stp->topicLen_u32;
+            memcpy(entry_stp->topic_ca, msg_stp->topic_chp, msg_stp->topicLen_u32);
+            // invalidate the old value, the first value of a topic is always published
+            entry_stp->dataLen_u16 = LVC_DATA_SIZE;
+            entry_stp->acked_fp = NULL;
+        }
+    }
+    return(entry_stp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Stores the message value in the cache entry, the acknowledge of a replaced
+ *              pending value is dropped. Has to be called with the cache mutex taken.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     entry_stp         cache entry of the message topic
+ * @param     msg_stp           message to be published
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void StoreCacheEntry_vd(lvcEntry_t *entry_stp, mqttif_msg_t *msg_stp)
+{
+    entry_stp->dataLen_u16 = (uint16_t)msg_stp->dataLen_u32;
+    memcpy(entry_stp->data_ca, msg_stp->data_chp, msg_stp->dataLen_u32);
+    entry_stp->qos_s32 = msg_stp->qos_s32;
+    entry_stp->retain_s32 = msg_stp->retain_s32;
+    entry_stp->pubTime_st = xTaskGetTickCount();
+    entry_stp->acked_fp = NULL;
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Publishes all cached values which were not published so far, the
+ *              acknowledge callback of the value is handed over to the publication. 
+ *              The flush never blocks, if no publication slot is free it is continued
+ *              after the next publication acknowledge.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*------------------------------------------------------------------------------------*/
+static void FlushCache_vd(void)
+{
+    lvcEntry_t *entry_stp;
+    mqttif_msg_t stamp_st;
+
+    if((NULL != lvcMutex_sts) && (pdTRUE == xSemaphoreTake(lvcMutex_sts, portMAX_DELAY)))
+    {
+        lvcFlushPending_bol = false;
+        for(uint8_t idx_u8 = 0U; idx_u8 < LVC_ENTRIES_NUM; idx_u8++)
+        {
+            entry_stp = &lvcEntries_sta[idx_u8];
+            if((true == entry_stp->used_bol) && (true == entry_stp->pending_bol))
+            {
+                stamp_st.rxUs_u32 = entry_stp->rxUs_u32;
+                stamp_st.acked_fp = entry_stp->acked_fp;
+                if(ESP_OK == EnqueuePublication_td(entry_stp->topic_ca,
+                                                    entry_stp->topicLen_u16,
+                                                    entry_stp->data_ca,
+                                                    entry_stp->dataLen_u16,
+                                                    entry_stp->qos_s32,
+                                                    entry_stp->retain_s32, &stamp_st, 0U))
                 {
-                    index_xps->param_st.dataRecv_fp(&msg_st);
+                    entry_stp->pending_bol = false;
+                    entry_stp->acked_fp = NULL;
+                    entry_stp->pubTime_st = xTaskGetTickCount();
                 }
                 else
                 {
-                    ESP_LOGW(TAG, "subscription received without callback function");
+                    lvcFlushPending_bol = true;
+                    break;
                 }
             }
-            index_xps = index_xps->next_xp;
         }
+        xSemaphoreGive(lvcMutex_sts);
     }
 }
 
 /**---------------------------------------------------------------------------------------
- * @brief     Handler for error event
+ * @brief     Hands the queued publication slots over to the mqtt client. The broker
+ *              acknowledge is handled in the client task and can arrive before
+ *              esp_mqtt_client_publish returns the msg id. Therefore the msg id and the
+ *              wait state are set under the slot lock, and an acknowledge which was
+ *              already received releases the slot at once. Slots of QoS 0, failed
+ *              publications and publications of a lost session are released directly.
  * @author    S. Wink
- * @date      31. Mar. 2019
- * @param     event_stp        event structure
+ * @date      17. Oct. 2026
  * @return    n/a
 *//*------------------------------------------------------------------------------------*/
-static void HandleError_vd(esp_mqtt_event_handle_t event_stp)
+static void PublishPendingSlots_vd(void)
 {
-    ESP_LOGE(TAG, "MQTT_EVENT_ERROR detected...");
+    uint8_t slotIdx_u8;
+    pubSlot_t *slot_stp;
+    int32_t msgId_s32;
+    uint32_t session_u32;
+    bool acked_bol;
+    bool release_bol;
+
+    while(pdTRUE == xQueueReceive(pendingSlotQueue_sts, &slotIdx_u8, 0U))
+    {
+        ESP_LOGD(TAG, "publish start, slot %d...", slotIdx_u8);
+        slot_stp = &pubSlots_sta[slotIdx_u8];
+        portENTER_CRITICAL(&slotMux_sst);
+        session_u32 = session_u32s;
+        portEXIT_CRITICAL(&slotMux_sst);
+        msgId_s32 = esp_mqtt_client_publish(this_sst.client_xp,
+                                            slot_stp->msg_st.topic_chp,
+                                            slot_stp->msg_st.data_chp,
+                                            slot_stp->msg_st.dataLen_u32,
+                                            slot_stp->msg_st.qos_s32,
+                                            slot_stp->msg_st.retain_s32);
+
+        portENTER_CRITICAL(&slotMux_sst);
+        slot_stp->msg_st.msgId_s32 = msgId_s32;
+        acked_bol = TakeEarlyAck_bol(msgId_s32);
+        release_bol =    (-1 == msgId_s32) || (0 == slot_stp->msg_st.qos_s32)
+                      || (session_u32 != session_u32s) || (true == acked_bol);
+        if(false == release_bol)
+        {
+            slot_stp->state_en = SLOT_WAIT_ACK;
+        }
+        portEXIT_CRITICAL(&slotMux_sst);
 
-    // ensure that the publication resource gets released
-    xSemaphoreGive(publishSema_sts);
-    xEventGroupSetBits(mqttEventGroup_sts, MQTT_ERR);
+        if(-1 == msgId_s32)
+        {
+            // message publication failed
+            ESP_LOGE(TAG, "error during publication");
+        }
+        else if(true == acked_bol)
+        {
+            NotifyAcked_vd(slotIdx_u8);
+        }
+        if(true == release_bol)
+        {
+            ReleasePubSlot_vd(slotIdx_u8);
+        }
+    }
 }
 
 /**---------------------------------------------------------------------------------------
@@ -846,23 +1877,10 @@ static void Task_vd(void *pvParameters)
         }
         if(0 != (uxBits_st & PUBLISH_REQ))
         {
-            ESP_LOGD(TAG, "publish start...");
-            pubMsg_sts.msgId_s32 = esp_mqtt_client_publish(this_sst.client_xp,
-                                                            pubMsg_sts.topic_chp,
-                                                            pubMsg_sts.data_chp,
-                                                            pubMsg_sts.dataLen_u32,
-                                                            pubMsg_sts.qos_s32,
-                                                            pubMsg_sts.retain_s32);
-            if((-1 == pubMsg_sts.msgId_s32))
-            {
-                // message publication failed
-                xSemaphoreGive(publishSema_sts);
-                ESP_LOGE(TAG, "error during publication");
-            }
-            else if(0 == pubMsg_sts.qos_s32)
+            PublishPendingSlots_vd();
+            if((true == lvcFlushPending_bol) && (STATE_CONNECTED == this_sst.state_en))
             {
-                // we don't need a message send confirmation
-                xSemaphoreGive(publishSema_sts);
+                FlushCache_vd();
             }
         }
         if(0 != (uxBits_st & MQTT_ERR))
@@ -66,9 +66,18 @@ typedef struct mqttdrv_substParam_tag
     mqttif_Connected_td conn_fp;
     mqttif_Disconnected_td discon_fp;
     mqttif_DataReceived_td dataRecv_fp;
+    uint32_t token_u32;
 }mqttdrv_substParam_t;
 
 typedef struct mqttdrv_subsObj_tag* mqttdrv_subsHdl_t;
+
+typedef struct mqttdrv_cacheStats_tag
+{
+    uint32_t hit_u32;           /*!< publications with a topic already in the cache */
+    uint32_t miss_u32;          /*!< publications with a topic not in the cache */
+    uint32_t suppressed_u32;    /*!< unchanged values which were not published */
+    uint32_t coalesced_u32;     /*!< offline values replaced by a newer value */
+}mqttdrv_cacheStats_t;
 /****************************************************************************************/
 /* Global function definitions: */
 
@@ -152,15 +161,31 @@ extern esp_err_t mqttdrv_UnSubscribe_td(mqttdrv_subsHdl_t subsHdl_xp);
 extern uint8_t mqttdrv_GetNumberOfSubscriptions_td(void);
 
 /**---------------------------------------------------------------------------------------
- * @brief     Un-Subscribe MQTT message
+ * @brief     Publish MQTT message. The message is copied to one of the internal
+ *              publication slots, the function only blocks if all slots are still
+ *              waiting for the broker acknowledge. Unchanged values of a topic are
+ *              suppressed until they reach the cache max age, while disconnected only
+ *              the newest value per topic is kept and published after reconnection.
+ *              The acknowledge callback of a kept value is called after it was 
+ *              published, suppressed values and values replaced by a newer value are
+ *              never acknowledged.
  * @author    S. Wink
  * @date      25. Mar. 2019
- * @param     subsHdl_xp         subscription handle
  * param      msg_st             message to be published
- * @return    ESP_OK if the message was successful un-subscribed
+ * @param     timeOut_u32        ticks to wait for a free publication slot
+ * @return    ESP_OK if the message was successful queued for publication
 *//*-----------------------------------------------------------------------------------*/
 extern esp_err_t mqttdrv_Publish_td(mqttif_msg_t *msg_stp, uint32_t timeOut_u32);
 
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the counters of the publication last value cache
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stats_stp          destination of the counters
+ * @return    ESP_OK if the counters were copied
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t mqttdrv_GetCacheStats_td(mqttdrv_cacheStats_t *stats_stp);
+
 /****************************************************************************************/
 /* Global data definitions: */
 
@@ -46,6 +46,18 @@ vAUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
 
 /****************************************************************************************/
 /* Global type definitions (enum (en), struct (st), union (un), typedef (tx): */
+
+/* called in the task of the mqtt client when the broker acknowledged a publication,
+ * with the reception stamp of the message, the hand over to the driver and the
+ * acknowledge, all in us of esp_timer_get_time */
+typedef void (* mqttif_Acked_td)(uint32_t rxUs_u32, uint32_t queuedUs_u32,
+                                    uint32_t ackUs_u32);
+
+/* For received messages the topic and data pointers are borrowed views into the
+ * buffers of the mqtt driver. They are only valid during the data received callback,
+ * data which is needed afterwards has to be copied by the subscriber. The token is
+ * the one given with the subscription parameter of the matching subscription, so the
+ * receiver does not need to compare the topic again. */
 typedef struct mqttif_msg_tag
 {
         uint32_t topicLen_u32;
@@ -55,6 +67,9 @@ typedef struct mqttif_msg_tag
         int32_t msgId_s32;
         int32_t qos_s32;
         int32_t retain_s32;
+        uint32_t token_u32;
+        uint32_t rxUs_u32;          // reception of the published data, see acked_fp
+        mqttif_Acked_td acked_fp;   // NULL or acknowledge callback, reset when taken over
 }mqttif_msg_t;
 
 typedef void (* mqttif_Connected_td)(void);
@@ -69,6 +84,7 @@ typedef struct mqttif_substParam_tag
     mqttif_Connected_td conn_fp;
     mqttif_Disconnected_td discon_fp;
     mqttif_DataReceived_td dataRecv_fp;
+    uint32_t token_u32;     // handed back in received messages of this subscription
 }mqttif_substParam_t;
 
 /****************************************************************************************/
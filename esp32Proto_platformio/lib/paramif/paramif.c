@@ -2,7 +2,18 @@
 * FILENAME :        paramif.c
 *
 * DESCRIPTION :
-*       This module handles the non volatile parameter storage
+*       This module handles the non volatile parameter storage. Every allocated
+*       parameter object has a ram shadow which is loaded at allocation and serves all
+*       reads. Writes only update the shadow, changed objects are written to nvs
+*       together with one commit when too many objects are waiting or when
+*       paramif_Flush_td is called, e.g. before a reboot. After a quiet time the
+*       flush request callback asks the owning task to call paramif_Flush_td.
+*       The objects are kept in pool blocks, a new block is allocated if all objects
+*       are in use. Objects are found by their nvs identifier through a hash table.
+*       Often changing values can be stored in the append only log of paramlog
+*       instead of nvs, the log records are written without commit.
+*       All objects can be exported to one binary document and imported again with
+*       one commit, the console command transfers the document base64 coded in parts.
 *
 * AUTHOR :    Stephan Wink        CREATED ON :    14.02.2019
 *
@@ -34,18 +45,43 @@ vAUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
 /* Include Interfaces */
 
 #include "paramif.h"
+#include "paramlog.h"
 
 #include "nvs.h"
 #include "nvs_flash.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+#include "rom/crc.h"
+#include "mbedtls/base64.h"
+#include "argtable3/argtable3.h"
+#include "myConsole.h"
 
 #include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
 
 /****************************************************************************************/
 /* Local constant defines */
-#define config_MAX_PARAMETER_OBJECTS    10
+#ifdef CONFIG_PARAMIF_POOL_BLOCK_SIZE
+#define POOL_BLOCK_SIZE     CONFIG_PARAMIF_POOL_BLOCK_SIZE
+#else
+#define POOL_BLOCK_SIZE     16U     // objects per pool block
+#endif
+#define HASH_BITS           6U      // buckets of the identifier hash table
+#define HASH_SIZE           (1U << HASH_BITS)
 #define STORAGE_NAMESPACE "parameter"
+#define COMMIT_DELAY_MS     2000U   // quiet time after the last write before the commit
+#define COMMIT_MAX_DIRTY    4U      // changed objects which trigger an immediate commit
+#define BLOB_MAGIC          0xB10BU // marks a blob with header, older blobs are raw data
+#define LEGACY_VERSION      1U      // schema version of the raw blobs without header
+#define EXPORT_MAGIC        0x50455850U // marks an export document
+#define EXPORT_VERSION      1U      // format of the export document
+#define EXPORT_PART_SIZE    1500U   // document bytes per console line, 2000 base64 chars
+#define IMPORT_MAX_SIZE     8192U   // maximum size of an import document
+#define IDENT_SIZE          16U     // nvs identifier incl. termination
 static const char *TAG = "paramif";
 
 /****************************************************************************************/
@@ -54,12 +90,47 @@ static const char *TAG = "paramif";
 /****************************************************************************************/
 /* Local type definitions (enum, struct, union) */
 
+ /* header of an export document (12 bytes), followed by one entry per object:
+    identifier length (1 byte), identifier, blob length (2 bytes), blob */
+ typedef struct exportHeader_tag
+ {
+     uint32_t magic_u32;
+     uint16_t length_u16;       // length of the entries behind the header
+     uint16_t crc_u16;          // crc16 of the entries
+     uint16_t count_u16;        // number of entries
+     uint8_t version_u8;
+     uint8_t reserved_u8;
+ }exportHeader_t;
+
+ /* header stored in front of the parameter data (8 bytes) */
+ typedef struct blobHeader_tag
+ {
+     uint16_t magic_u16;
+     uint16_t length_u16;       // length of the data behind the header
+     uint16_t crc_u16;          // crc16 of the data
+     uint8_t version_u8;        // schema version of the data
+     uint8_t reserved_u8;
+ }blobHeader_t;
+
  typedef struct paramif_obj_tag
  {
-     paramif_allocParam_t param_st;
-     uint8_t objPoolIdx_u8;
+     paramif_allocParam_t param_st;    // the identifier points to ident_ca
+     char ident_ca[IDENT_SIZE];         // copy of the nvs identifier
+     uint16_t objPoolIdx_u16;
+     bool used_bol;             // object is allocated
+     struct paramif_obj_tag *hashNext_stp;  // next object in the same hash bucket
+     uint8_t *blob_u8p;         // ram copy of the blob, header and data
+     uint8_t *shadow_u8p;       // ram copy of the parameter data inside the blob
+     bool valid_bol;            // shadow holds stored data or defaults
+     bool dirty_bol;            // shadow not written to nvs so far
  }paramif_obj_t;
 
+ typedef struct poolBlock_tag
+ {
+     struct poolBlock_tag *next_stp;
+     paramif_obj_t objects_sta[POOL_BLOCK_SIZE];
+ }poolBlock_t;
+
  typedef enum moduleState_tag
  {
      STATE_NOT_INITIALIZED,
@@ -68,12 +139,53 @@ static const char *TAG = "paramif";
 
 /****************************************************************************************/
 /* Local functions prototypes: */
+static void LoadShadow_vd(paramif_objHdl_t handle_xp);
+static bool CheckHeader_bol(const uint8_t *blob_u8p, size_t length_st);
+static void FillHeader_vd(paramif_obj_t *obj_stp);
+static esp_err_t WalkDocument_td(const uint8_t *src_u8p, size_t length_st, 
+                                    bool apply_bol);
+static uint8_t *SnapshotShadows_u8p(void);
+static void RestoreShadows_vd(const uint8_t *snap_u8p);
+static int32_t CmdHandlerParam_s32(int32_t argc_s32, char** argv, FILE *retStream_xp);
+static void PrintExportPart_vd(uint16_t part_u16, FILE *retStream_xp);
+static void AppendImportPart_vd(const char *part_cchp, FILE *retStream_xp);
+static bool MigrateBlob_bol(paramif_objHdl_t handle_xp, size_t length_st);
+static esp_err_t GetBlob_td(paramif_objHdl_t handle_xp, uint8_t *dest_u8p, 
+                            size_t *length_stp);
+static esp_err_t SetBlob_td(paramif_objHdl_t handle_xp, bool *commit_bolp);
+static paramif_obj_t *GetObject_stp(uint16_t objIdx_u16);
+static paramif_obj_t *AllocObject_stp(void);
+static uint8_t HashIdent_u8(const char *nvsIdent_cp);
+static paramif_obj_t *FindLocked_stp(const char *nvsIdent_cp);
+static void HashRemove_vd(paramif_obj_t *obj_stp);
+static esp_err_t FlushLocked_td(void);
+static void CommitTimerCallback_vd(TimerHandle_t xTimer);
 
 /****************************************************************************************/
 /* Local variables: */
 
- static paramif_obj_t objectPool_stsa[config_MAX_PARAMETER_OBJECTS];
+ static poolBlock_t firstBlock_sts;
+ static uint16_t poolSize_u16s = POOL_BLOCK_SIZE;     // objects of all pool blocks
+ static paramif_obj_t *hashTable_stspa[HASH_SIZE];
  static moduleState_t moduleState_ens = STATE_NOT_INITIALIZED;
+ static nvs_handle nvsHandle_sts;
+ static SemaphoreHandle_t poolMutex_sts;
+ static TimerHandle_t commitTimer_sts;
+ static paramif_FlushRequest_td flushRequest_fps;
+ static uint16_t dirtyObjects_u16s;
+ static paramif_stats_t stats_sts;
+ static uint8_t *importBuf_u8ps;   // import document collected from the console
+ static uint16_t importLen_u16s;
+
+ static struct
+ {
+     struct arg_lit *list_stp;
+     struct arg_int *export_stp;
+     struct arg_str *append_stp;
+     struct arg_lit *import_stp;
+     struct arg_lit *clear_stp;
+     struct arg_end *end_stp;
+ }cmdParam_sts;
 /****************************************************************************************/
 /* Global functions (unlimited visibility) */
 
@@ -86,7 +198,15 @@ static const char *TAG = "paramif";
 *//*-----------------------------------------------------------------------------------*/
 esp_err_t paramif_InitializeParameter_td(paramif_param_t *param_stp)
 {
-    return(ESP_OK);
+    esp_err_t err_st = ESP_ERR_INVALID_ARG;
+
+    if(NULL != param_stp)
+    {
+        param_stp->flushRequest_fp = NULL;
+        err_st = ESP_OK;
+    }
+
+    return(err_st);
 }
 
 /**---------------------------------------------------------------------------------------
@@ -99,17 +219,13 @@ esp_err_t paramif_InitializeParameter_td(paramif_param_t *param_stp)
 esp_err_t paramif_Initialize_td(paramif_param_t *param_stp)
 {
     esp_err_t err_st = ESP_FAIL;
-    uint8_t idx_u8 = 0U;
 
-
-    if(STATE_NOT_INITIALIZED == moduleState_ens)
+    if((NULL != param_stp) && (STATE_NOT_INITIALIZED == moduleState_ens))
     {
-        // deallocate all parameter objects from pool
-        while(config_MAX_PARAMETER_OBJECTS > idx_u8)
-        {
-            objectPool_stsa[idx_u8].objPoolIdx_u8 = config_MAX_PARAMETER_OBJECTS;
-            idx_u8++;
-        }
+        flushRequest_fps = param_stp->flushRequest_fp;
+        // all objects of the first pool block are free
+        memset(&firstBlock_sts, 0U, sizeof(firstBlock_sts));
+        memset(hashTable_stspa, 0U, sizeof(hashTable_stspa));
 
         err_st = nvs_flash_init();
         if (   (ESP_ERR_NVS_NO_FREE_PAGES == err_st)
@@ -119,6 +235,18 @@ esp_err_t paramif_Initialize_td(paramif_param_t *param_stp)
             err_st = nvs_flash_init();
         }
         ESP_ERROR_CHECK(err_st);
+        // without log partition all objects are stored in nvs
+        (void)paramlog_Initialize_td();
+
+        // the namespace stays open, objects are loaded and written with one handle
+        err_st = nvs_open(STORAGE_NAMESPACE, NVS_READWRITE, &nvsHandle_sts);
+        poolMutex_sts = xSemaphoreCreateMutex();
+        commitTimer_sts = xTimerCreate("paramif", pdMS_TO_TICKS(COMMIT_DELAY_MS), false,
+                                        (void *) 0, CommitTimerCallback_vd);
+        if((ESP_OK == err_st) && ((NULL == poolMutex_sts) || (NULL == commitTimer_sts)))
+        {
+            err_st = ESP_ERR_NO_MEM;
+        }
     }
     else
     {
@@ -168,10 +296,35 @@ esp_err_t paramif_DeActivate_td(void)
 esp_err_t paramif_EraseAllParameter_td(void)
 {
     esp_err_t err_st;
+    paramif_obj_t *obj_stp;
+
+    if(STATE_INITIALIZED == moduleState_ens)
+    {
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        nvs_close(nvsHandle_sts);
+    }
 
     ESP_ERROR_CHECK(nvs_flash_erase());
     err_st = nvs_flash_init();
     ESP_ERROR_CHECK(err_st);
+    (void)paramlog_EraseAll_td();
+
+    if(STATE_INITIALIZED == moduleState_ens)
+    {
+        err_st = nvs_open(STORAGE_NAMESPACE, NVS_READWRITE, &nvsHandle_sts);
+        // pending changes are dropped, the shadows fall back to the defaults
+        dirtyObjects_u16s = 0U;
+        for(uint16_t idx_u16 = 0U; idx_u16 < poolSize_u16s; idx_u16++)
+        {
+            obj_stp = GetObject_stp(idx_u16);
+            if(true == obj_stp->used_bol)
+            {
+                obj_stp->dirty_bol = false;
+                LoadShadow_vd(obj_stp);
+            }
+        }
+        xSemaphoreGive(poolMutex_sts);
+    }
 
     return(err_st);
 }
@@ -191,6 +344,9 @@ esp_err_t paramif_InitializeAllocParameter_td(paramif_allocParam_t *param_stp)
         param_stp->defaults_u8p = NULL;
         param_stp->length_u16 = 0U;
         param_stp->nvsIdent_cp = NULL;
+        param_stp->version_u8 = LEGACY_VERSION;
+        param_stp->migrate_fp = NULL;
+        param_stp->backend_en = paramif_BACKEND_NVS;
         err_st = ESP_OK;
     }
     else
@@ -212,24 +368,80 @@ esp_err_t paramif_InitializeAllocParameter_td(paramif_allocParam_t *param_stp)
 paramif_objHdl_t paramif_Allocate_stp(paramif_allocParam_t *param_stp)
 {
     paramif_objHdl_t retObj_xp = NULL;
-    uint8_t idx_u8 = 0U;
-
+    uint8_t hash_u8;
 
-    if((NULL != param_stp) && (STATE_INITIALIZED == moduleState_ens))
+    if(   (NULL != param_stp) && (NULL != param_stp->nvsIdent_cp)
+       && (IDENT_SIZE > strlen(param_stp->nvsIdent_cp))
+       && (STATE_INITIALIZED == moduleState_ens))
     {
-        while(config_MAX_PARAMETER_OBJECTS > idx_u8)
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        retObj_xp = FindLocked_stp(param_stp->nvsIdent_cp);
+        if(NULL != retObj_xp)
         {
-            if(config_MAX_PARAMETER_OBJECTS == objectPool_stsa[idx_u8].objPoolIdx_u8)
+            // the object is already allocated, hand out the existing handle
+            if(param_stp->length_u16 != retObj_xp->param_st.length_u16)
             {
-                // we found an empty object in the pool, use it
-                objectPool_stsa[idx_u8].objPoolIdx_u8 = idx_u8;
-                memcpy(&objectPool_stsa[idx_u8].param_st, param_stp,
-                        sizeof(objectPool_stsa[idx_u8].param_st));
-                retObj_xp = &objectPool_stsa[idx_u8];
-                break;
+                ESP_LOGE(TAG, "parameter %s allocated with other length", 
+                            param_stp->nvsIdent_cp);
+                retObj_xp = NULL;
+            }
+        }
+        else
+        {
+            retObj_xp = AllocObject_stp();
+            if(NULL != retObj_xp)
+            {
+                retObj_xp->blob_u8p = malloc(sizeof(blobHeader_t) + param_stp->length_u16);
+            }
+
+            if((NULL != retObj_xp) && (NULL != retObj_xp->blob_u8p))
+            {
+                retObj_xp->shadow_u8p = retObj_xp->blob_u8p + sizeof(blobHeader_t);
+                memcpy(&retObj_xp->param_st, param_stp, sizeof(retObj_xp->param_st));
+                // the identifier of the caller may be a temporary buffer
+                strcpy(retObj_xp->ident_ca, param_stp->nvsIdent_cp);
+                retObj_xp->param_st.nvsIdent_cp = retObj_xp->ident_ca;
+                if(   (paramif_BACKEND_LOG == param_stp->backend_en)
+                   && (   (false == paramlog_IsAvailable_bol())
+                       || (paramlog_MAX_DATA_LEN 
+                                < (sizeof(blobHeader_t) + param_stp->length_u16))))
+                {
+                    retObj_xp->param_st.backend_en = paramif_BACKEND_NVS;
+                }
+                retObj_xp->used_bol = true;
+                retObj_xp->dirty_bol = false;
+                hash_u8 = HashIdent_u8(param_stp->nvsIdent_cp);
+                retObj_xp->hashNext_stp = hashTable_stspa[hash_u8];
+                hashTable_stspa[hash_u8] = retObj_xp;
+                LoadShadow_vd(retObj_xp);
+            }
+            else
+            {
+                ESP_LOGE(TAG, "parameter allocation failed: %s", param_stp->nvsIdent_cp);
+                retObj_xp = NULL;
             }
-            idx_u8++;
         }
+        xSemaphoreGive(poolMutex_sts);
+    }
+    return(retObj_xp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Searches an allocated parameter set by its nvs identifier
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     nvsIdent_cp         nvs identifier of the parameter set
+ * @return    NULL if the parameter set is not allocated, else the handle
+*//*-----------------------------------------------------------------------------------*/
+paramif_objHdl_t paramif_Find_stp(const char *nvsIdent_cp)
+{
+    paramif_objHdl_t retObj_xp = NULL;
+
+    if((NULL != nvsIdent_cp) && (STATE_INITIALIZED == moduleState_ens))
+    {
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        retObj_xp = FindLocked_stp(nvsIdent_cp);
+        xSemaphoreGive(poolMutex_sts);
     }
     return(retObj_xp);
 }
@@ -245,7 +457,26 @@ void paramif_DeAllocate_stp(paramif_objHdl_t paraObj_xp)
 {
     if(NULL != paraObj_xp)
     {
-        paraObj_xp->objPoolIdx_u8 = config_MAX_PARAMETER_OBJECTS;
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        if(true == paraObj_xp->dirty_bol)
+        {
+            // the pending change is written with the next commit
+            (void)FlushLocked_td();
+        }
+        if(true == paraObj_xp->dirty_bol)
+        {
+            // the write failed, the change is lost with the object
+            ESP_LOGE(TAG, "change of %s dropped", paraObj_xp->param_st.nvsIdent_cp);
+            paraObj_xp->dirty_bol = false;
+            dirtyObjects_u16s--;
+        }
+        HashRemove_vd(paraObj_xp);
+        paraObj_xp->used_bol = false;
+        free(paraObj_xp->blob_u8p);
+        paraObj_xp->blob_u8p = NULL;
+        paraObj_xp->shadow_u8p = NULL;
+        paraObj_xp->valid_bol = false;
+        xSemaphoreGive(poolMutex_sts);
     }
 }
 
@@ -260,36 +491,17 @@ void paramif_DeAllocate_stp(paramif_objHdl_t paraObj_xp)
 esp_err_t paramif_Read_td(paramif_objHdl_t handle_xp, uint8_t *dest_u8p)
 {
     esp_err_t err_st = ESP_FAIL;
-    nvs_handle fileHandle_st;
-    uint16_t length_u16 = 0U;
 
-    if((NULL != handle_xp) && (STATE_INITIALIZED == moduleState_ens))
+    if((NULL != handle_xp) && (NULL != dest_u8p) && (STATE_INITIALIZED == moduleState_ens))
     {
-        length_u16 = handle_xp->param_st.length_u16;
-        err_st = nvs_open(STORAGE_NAMESPACE, NVS_READONLY, &fileHandle_st);
-
-        if(ESP_OK == err_st)
-        {
-            err_st = nvs_get_blob(fileHandle_st,
-                                    handle_xp->param_st.nvsIdent_cp, dest_u8p,
-                                    (size_t *)&length_u16);
-
-            if(ESP_OK == err_st)
-            {
-                nvs_close(fileHandle_st);
-            }
-        }
-
-        /* if everything works fine, the error return status should stay at
-         * ESP_OK if this is not the case, we will set the data to defaults if
-         * available */
-        if((ESP_OK != err_st) && handle_xp->param_st.defaults_u8p != NULL)
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        if(true == handle_xp->valid_bol)
         {
+            memcpy(dest_u8p, handle_xp->shadow_u8p, handle_xp->param_st.length_u16);
+            stats_sts.reads_u32++;
             err_st = ESP_OK;
-            memcpy(dest_u8p, handle_xp->param_st.defaults_u8p,
-                    handle_xp->param_st.length_u16);
-            err_st = paramif_Write_td(handle_xp, handle_xp->param_st.defaults_u8p);
         }
+        xSemaphoreGive(poolMutex_sts);
     }
 
     return(err_st);
@@ -325,22 +537,235 @@ uint16_t paramif_GetLength_u16(paramif_objHdl_t handle_xp, uint8_t *src_u8p)
 esp_err_t paramif_Write_td(paramif_objHdl_t handle_xp, uint8_t *src_u8p)
 {
     esp_err_t err_st = ESP_FAIL;
-    nvs_handle fileHandle_st;
 
-    if((NULL != handle_xp) && (STATE_INITIALIZED == moduleState_ens))
+    if((NULL != handle_xp) && (NULL != src_u8p) && (STATE_INITIALIZED == moduleState_ens))
     {
-        err_st = nvs_open(STORAGE_NAMESPACE, NVS_READWRITE, &fileHandle_st);
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        stats_sts.writes_u32++;
+        err_st = ESP_OK;
+        if(   (true == handle_xp->valid_bol)
+           && (0 == memcmp(handle_xp->shadow_u8p, src_u8p, handle_xp->param_st.length_u16)))
+        {
+            stats_sts.unchanged_u32++;
+        }
+        else
+        {
+            memcpy(handle_xp->shadow_u8p, src_u8p, handle_xp->param_st.length_u16);
+            handle_xp->valid_bol = true;
+            if(false == handle_xp->dirty_bol)
+            {
+                handle_xp->dirty_bol = true;
+                dirtyObjects_u16s++;
+            }
+
+            if(COMMIT_MAX_DIRTY <= dirtyObjects_u16s)
+            {
+                err_st = FlushLocked_td();
+            }
+            else
+            {
+                // restarts the quiet time with every change
+                xTimerReset(commitTimer_sts, 0U);
+            }
+        }
+        xSemaphoreGive(poolMutex_sts);
+    }
+
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     writes all changed parameters to nvs with one commit
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_ERR in case of an error, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramif_Flush_td(void)
+{
+    esp_err_t err_st = ESP_FAIL;
 
+    if(STATE_INITIALIZED == moduleState_ens)
+    {
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        err_st = FlushLocked_td();
+        xSemaphoreGive(poolMutex_sts);
+    }
+
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     get the counters of the parameter storage
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stats_stp     destination of the counters
+ * @return    ESP_ERR in case of an error, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramif_GetStats_td(paramif_stats_t *stats_stp)
+{
+    esp_err_t err_st = ESP_FAIL;
+
+    if((NULL != stats_stp) && (STATE_INITIALIZED == moduleState_ens))
+    {
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        memcpy(stats_stp, &stats_sts, sizeof(paramif_stats_t));
+        xSemaphoreGive(poolMutex_sts);
+        err_st = ESP_OK;
+    }
+
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     exports all loaded parameter objects to one document
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     dest_u8p      destination of the document, NULL to get the length only
+ * @param     size_st       size of the destination
+ * @param     length_stp    length of the document
+ * @return    ESP_ERR_INVALID_SIZE if the destination is too small, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramif_Export_td(uint8_t *dest_u8p, size_t size_st, size_t *length_stp)
+{
+    esp_err_t err_st = ESP_FAIL;
+    paramif_obj_t *obj_stp;
+    exportHeader_t header_st;
+    size_t length_st = sizeof(exportHeader_t);
+    uint16_t blobLen_u16;
+    uint8_t identLen_u8;
+
+    if((NULL != length_stp) && (STATE_INITIALIZED == moduleState_ens))
+    {
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        memset(&header_st, 0U, sizeof(header_st));
+        for(uint16_t idx_u16 = 0U; idx_u16 < poolSize_u16s; idx_u16++)
+        {
+            obj_stp = GetObject_stp(idx_u16);
+            if((true == obj_stp->used_bol) && (true == obj_stp->valid_bol))
+            {
+                identLen_u8 = (uint8_t)strlen(obj_stp->param_st.nvsIdent_cp);
+                blobLen_u16 = sizeof(blobHeader_t) + obj_stp->param_st.length_u16;
+                if(   (NULL != dest_u8p) 
+                   && ((length_st + 3U + identLen_u8 + blobLen_u16) <= size_st))
+                {
+                    FillHeader_vd(obj_stp);
+                    dest_u8p[length_st] = identLen_u8;
+                    memcpy(&dest_u8p[length_st + 1U], obj_stp->param_st.nvsIdent_cp, 
+                            identLen_u8);
+                    memcpy(&dest_u8p[length_st + 1U + identLen_u8], &blobLen_u16, 2U);
+                    memcpy(&dest_u8p[length_st + 3U + identLen_u8], obj_stp->blob_u8p, 
+                            blobLen_u16);
+                }
+                length_st += 3U + identLen_u8 + blobLen_u16;
+                header_st.count_u16++;
+            }
+        }
+
+        *length_stp = length_st;
+        if(NULL == dest_u8p)
+        {
+            err_st = ESP_OK;
+        }
+        else if(   (size_st < length_st) 
+                || ((sizeof(exportHeader_t) + UINT16_MAX) < length_st))
+        {
+            err_st = ESP_ERR_INVALID_SIZE;
+        }
+        else
+        {
+            header_st.magic_u32 = EXPORT_MAGIC;
+            header_st.length_u16 = length_st - sizeof(exportHeader_t);
+            header_st.crc_u16 = crc16_le(0U, &dest_u8p[sizeof(exportHeader_t)], 
+                                            header_st.length_u16);
+            header_st.version_u8 = EXPORT_VERSION;
+            memcpy(dest_u8p, &header_st, sizeof(exportHeader_t));
+            err_st = ESP_OK;
+        }
+        xSemaphoreGive(poolMutex_sts);
+    }
+
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     imports a document of paramif_Export_td, the document is checked
+ *              completely before the objects are changed and written with one commit.
+ *              If the objects can not be stored, the shadows of before are restored.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     src_u8p       document
+ * @param     length_st     length of the document
+ * @return    ESP_ERR_INVALID_ARG if the document is not valid, ESP_ERR_NO_MEM if no
+ *              memory for the restore is left, ESP_FAIL if the objects are not stored,
+ *              else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramif_Import_td(const uint8_t *src_u8p, size_t length_st)
+{
+    esp_err_t err_st = ESP_FAIL;
+    uint8_t *snap_u8p = NULL;
+
+    if((NULL != src_u8p) && (STATE_INITIALIZED == moduleState_ens))
+    {
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        err_st = WalkDocument_td(src_u8p, length_st, false);
         if(ESP_OK == err_st)
         {
-            err_st = nvs_set_blob(fileHandle_st, handle_xp->param_st.nvsIdent_cp,
-                    src_u8p, handle_xp->param_st.length_u16);
+            snap_u8p = SnapshotShadows_u8p();
+            if(NULL == snap_u8p)
+            {
+                err_st = ESP_ERR_NO_MEM;
+            }
+        }
+        if(ESP_OK == err_st)
+        {
+            err_st = WalkDocument_td(src_u8p, length_st, true);
             if(ESP_OK == err_st)
             {
-                err_st = nvs_commit(fileHandle_st);
+                err_st = FlushLocked_td();
+            }
+            if(ESP_OK != err_st)
+            {
+                ESP_LOGE(TAG, "import not stored, parameters restored");
+                RestoreShadows_vd(snap_u8p);
             }
-            nvs_close(fileHandle_st);
         }
+        xSemaphoreGive(poolMutex_sts);
+        free(snap_u8p);
+    }
+
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     registers the console command for the export and import of parameters
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the command was registered, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramif_RegisterCommands_td(void)
+{
+    esp_err_t err_st = ESP_OK;
+    myConsole_cmd_t paramCmd;
+
+    cmdParam_sts.list_stp = arg_lit0("l", "list", "List the parameter objects");
+    cmdParam_sts.export_stp = arg_int0("e", "export", "<part>", 
+                                    "Print one part of the export document");
+    cmdParam_sts.append_stp = arg_str0("a", "append", "<base64>", 
+                                    "Append one part to the import document");
+    cmdParam_sts.import_stp = arg_lit0("i", "import", 
+                                    "Check and store the import document");
+    cmdParam_sts.clear_stp = arg_lit0("c", "clear", "Drop the import document");
+    cmdParam_sts.end_stp = arg_end(2);
+
+    err_st = myConsole_CmdInit_td(&paramCmd);
+    if(ESP_OK == err_st)
+    {
+        paramCmd.command = "para";
+        paramCmd.help = "Export and import of all parameters";
+        paramCmd.hint = NULL;
+        paramCmd.func2 = &CmdHandlerParam_s32;
+        paramCmd.argtable = &cmdParam_sts;
+        err_st = myConsole_CmdRegister_td(&paramCmd);
     }
 
     return(err_st);
@@ -398,7 +823,7 @@ void paramif_PrintHandle_vd(paramif_objHdl_t handle_xp)
     }
     else
     {
-        ESP_LOGI(TAG, "index of object: %d", handle_xp->objPoolIdx_u8);
+        ESP_LOGI(TAG, "index of object: %d", handle_xp->objPoolIdx_u16);
         ESP_LOGI(TAG, "parameter id: %s", handle_xp->param_st.nvsIdent_cp);
         ESP_LOGI(TAG, "length of parameter: %d", handle_xp->param_st.length_u16);
         if(NULL == handle_xp->param_st.defaults_u8p)
@@ -411,4 +836,782 @@ void paramif_PrintHandle_vd(paramif_objHdl_t handle_xp)
 /****************************************************************************************/
 /* Local functions: */
 
+/**---------------------------------------------------------------------------------------
+ * @brief     Loads the shadow of a parameter object from nvs. A blob of an older schema
+ *              version or a raw blob without header is upgraded and marked dirty, the
+ *              upgraded objects are written together after the commit delay. A missing
+ *              or not usable blob is replaced by the defaults, the defaults are not
+ *              written to nvs.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     handle_xp parameter handle
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void LoadShadow_vd(paramif_objHdl_t handle_xp)
+{
+    esp_err_t err_st;
+    blobHeader_t *header_stp = (blobHeader_t *)handle_xp->blob_u8p;
+    size_t length_st = sizeof(blobHeader_t) + handle_xp->param_st.length_u16;
+
+    err_st = GetBlob_td(handle_xp, handle_xp->blob_u8p, &length_st);
+    stats_sts.loads_u32++;
+
+    if(   (ESP_OK == err_st) && (true == CheckHeader_bol(handle_xp->blob_u8p, length_st))
+       && (handle_xp->param_st.version_u8 == header_stp->version_u8)
+       && (handle_xp->param_st.length_u16 == header_stp->length_u16))
+    {
+        handle_xp->valid_bol = true;
+    }
+    else if((ESP_OK == err_st) || (ESP_ERR_NVS_INVALID_LENGTH == err_st))
+    {
+        // older version, raw blob or another length, nvs returned the stored length
+        handle_xp->valid_bol = MigrateBlob_bol(handle_xp, length_st);
+    }
+    else
+    {
+        handle_xp->valid_bol = false;
+    }
+
+    if((false == handle_xp->valid_bol) && (NULL != handle_xp->param_st.defaults_u8p))
+    {
+        memcpy(handle_xp->shadow_u8p, handle_xp->param_st.defaults_u8p, 
+                handle_xp->param_st.length_u16);
+        handle_xp->valid_bol = true;
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Checks the header and the crc of a blob
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     blob_u8p      blob read from nvs
+ * @param     length_st     length of the blob
+ * @return    true if the blob starts with a valid header
+*//*-----------------------------------------------------------------------------------*/
+static bool CheckHeader_bol(const uint8_t *blob_u8p, size_t length_st)
+{
+    bool valid_bol = false;
+    blobHeader_t header_st;
+
+    if(sizeof(blobHeader_t) <= length_st)
+    {
+        // blobs of an import document are not aligned
+        memcpy(&header_st, blob_u8p, sizeof(blobHeader_t));
+        valid_bol =    (BLOB_MAGIC == header_st.magic_u16)
+                    && ((sizeof(blobHeader_t) + header_st.length_u16) == length_st)
+                    && (header_st.crc_u16 == crc16_le(0U, blob_u8p + sizeof(blobHeader_t),
+                                                        header_st.length_u16));
+    }
+    return(valid_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Updates the header in front of the shadow of an object
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     obj_stp       parameter object
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void FillHeader_vd(paramif_obj_t *obj_stp)
+{
+    blobHeader_t *header_stp = (blobHeader_t *)obj_stp->blob_u8p;
+
+    header_stp->magic_u16 = BLOB_MAGIC;
+    header_stp->length_u16 = obj_stp->param_st.length_u16;
+    header_stp->crc_u16 = crc16_le(0U, obj_stp->shadow_u8p, obj_stp->param_st.length_u16);
+    header_stp->version_u8 = obj_stp->param_st.version_u8;
+    header_stp->reserved_u8 = 0U;
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Reads a blob which does not fit to the current schema and upgrades it
+ *              step by step with the migration function of the object. Raw blobs
+ *              without header are handled as version 1.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     handle_xp     parameter handle
+ * @param     length_st     length of the stored blob
+ * @return    true if the shadow holds the upgraded data
+*//*-----------------------------------------------------------------------------------*/
+static bool MigrateBlob_bol(paramif_objHdl_t handle_xp, size_t length_st)
+{
+    bool migrated_bol = false;
+    uint8_t *buf_u8p;
+    uint8_t *data_u8p;
+    uint8_t version_u8 = LEGACY_VERSION;
+    uint16_t length_u16;
+    uint16_t bufSize_u16;
+    const blobHeader_t *header_cstp;
+
+    // intermediate versions have to fit into the larger one of old and new length
+    bufSize_u16 = (length_st > handle_xp->param_st.length_u16) ? 
+                    (uint16_t)length_st : handle_xp->param_st.length_u16;
+    buf_u8p = malloc(bufSize_u16);
+
+    if(   (NULL != buf_u8p) && (UINT16_MAX >= length_st)
+       && (ESP_OK == GetBlob_td(handle_xp, buf_u8p, &length_st)))
+    {
+        header_cstp = (const blobHeader_t *)buf_u8p;
+        data_u8p = buf_u8p;
+        length_u16 = (uint16_t)length_st;
+        if(true == CheckHeader_bol(buf_u8p, length_st))
+        {
+            version_u8 = header_cstp->version_u8;
+            length_u16 = header_cstp->length_u16;
+            data_u8p = buf_u8p + sizeof(blobHeader_t);
+        }
+        else if(   (sizeof(blobHeader_t) <= length_st)
+                && (BLOB_MAGIC == header_cstp->magic_u16))
+        {
+            ESP_LOGE(TAG, "parameter %s corrupted", handle_xp->param_st.nvsIdent_cp);
+            version_u8 = UINT8_MAX;
+        }
+        // data moved to the buffer start, the migration works in place
+        memmove(buf_u8p, data_u8p, length_u16);
+
+        while(   (version_u8 < handle_xp->param_st.version_u8) 
+              && (NULL != handle_xp->param_st.migrate_fp)
+              && (ESP_OK == handle_xp->param_st.migrate_fp(version_u8, buf_u8p,
+                                                            &length_u16, bufSize_u16)))
+        {
+            version_u8++;
+        }
+
+        if(   (version_u8 == handle_xp->param_st.version_u8)
+           && (length_u16 == handle_xp->param_st.length_u16))
+        {
+            memcpy(handle_xp->shadow_u8p, buf_u8p, length_u16);
+            // the upgraded blob is written with the next commit
+            if(false == handle_xp->dirty_bol)
+            {
+                handle_xp->dirty_bol = true;
+                dirtyObjects_u16s++;
+            }
+            xTimerReset(commitTimer_sts, 0U);
+            stats_sts.migrated_u32++;
+            ESP_LOGI(TAG, "parameter %s upgraded to version %d", 
+                        handle_xp->param_st.nvsIdent_cp, version_u8);
+            migrated_bol = true;
+        }
+        else
+        {
+            ESP_LOGW(TAG, "parameter %s version %d not usable", 
+                        handle_xp->param_st.nvsIdent_cp, version_u8);
+            stats_sts.rejected_u32++;
+        }
+    }
+    free(buf_u8p);
+    return(migrated_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get an object of the pool by its index over all pool blocks
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     objIdx_u16    index of the object, has to be below the pool size
+ * @return    pointer to the object
+*//*-----------------------------------------------------------------------------------*/
+static paramif_obj_t *GetObject_stp(uint16_t objIdx_u16)
+{
+    poolBlock_t *block_stp = &firstBlock_sts;
+
+    while(POOL_BLOCK_SIZE <= objIdx_u16)
+    {
+        block_stp = block_stp->next_stp;
+        objIdx_u16 -= POOL_BLOCK_SIZE;
+    }
+    return(&block_stp->objects_sta[objIdx_u16]);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Takes a free object from the pool, a new pool block is appended if all
+ *              objects are in use. Blocks are never freed, the handles stay valid.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    free object or NULL if no memory is available
+*//*-----------------------------------------------------------------------------------*/
+static paramif_obj_t *AllocObject_stp(void)
+{
+    paramif_obj_t *obj_stp = NULL;
+    poolBlock_t *block_stp = &firstBlock_sts;
+    uint16_t objIdx_u16 = 0U;
+
+    while(NULL == obj_stp)
+    {
+        for(uint16_t idx_u16 = 0U; idx_u16 < POOL_BLOCK_SIZE; idx_u16++)
+        {
+            if(false == block_stp->objects_sta[idx_u16].used_bol)
+            {
+                obj_stp = &block_stp->objects_sta[idx_u16];
+                obj_stp->objPoolIdx_u16 = objIdx_u16 + idx_u16;
+                break;
+            }
+        }
 
+        if((NULL == obj_stp) && (NULL == block_stp->next_stp))
+        {
+            if((UINT16_MAX - POOL_BLOCK_SIZE) < poolSize_u16s)
+            {
+                break;
+            }
+            block_stp->next_stp = calloc(1U, sizeof(poolBlock_t));
+            if(NULL == block_stp->next_stp)
+            {
+                break;
+            }
+            poolSize_u16s += POOL_BLOCK_SIZE;
+            ESP_LOGI(TAG, "parameter pool grown to %d objects", poolSize_u16s);
+        }
+        block_stp = block_stp->next_stp;
+        objIdx_u16 += POOL_BLOCK_SIZE;
+    }
+    return(obj_stp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Calculates the hash bucket of an nvs identifier (FNV-1a)
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     nvsIdent_cp   nvs identifier
+ * @return    hash bucket
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t HashIdent_u8(const char *nvsIdent_cp)
+{
+    uint32_t hash_u32 = 2166136261U;
+
+    while('\0' != *nvsIdent_cp)
+    {
+        hash_u32 = (hash_u32 ^ (uint8_t)*nvsIdent_cp) * 16777619U;
+        nvsIdent_cp++;
+    }
+    return((uint8_t)((hash_u32 ^ (hash_u32 >> 16U)) & (HASH_SIZE - 1U)));
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Searches an allocated object by its nvs identifier, the pool mutex has to
+ *              be taken by the caller
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     nvsIdent_cp   nvs identifier
+ * @return    object or NULL if not allocated
+*//*-----------------------------------------------------------------------------------*/
+static paramif_obj_t *FindLocked_stp(const char *nvsIdent_cp)
+{
+    paramif_obj_t *obj_stp = hashTable_stspa[HashIdent_u8(nvsIdent_cp)];
+
+    while((NULL != obj_stp) && (0 != strcmp(obj_stp->param_st.nvsIdent_cp, nvsIdent_cp)))
+    {
+        obj_stp = obj_stp->hashNext_stp;
+    }
+    return(obj_stp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Removes an object from its hash bucket
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     obj_stp       object to be removed
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void HashRemove_vd(paramif_obj_t *obj_stp)
+{
+    paramif_obj_t **link_stpp = &hashTable_stspa[HashIdent_u8(obj_stp->param_st.nvsIdent_cp)];
+
+    while((NULL != *link_stpp) && (obj_stp != *link_stpp))
+    {
+        link_stpp = &(*link_stpp)->hashNext_stp;
+    }
+    if(NULL != *link_stpp)
+    {
+        *link_stpp = obj_stp->hashNext_stp;
+    }
+    obj_stp->hashNext_stp = NULL;
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Writes the changed objects to nvs and commits them once, the pool mutex
+ *              has to be taken by the caller
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_ERR in case of an error, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t FlushLocked_td(void)
+{
+    esp_err_t err_st = ESP_OK;
+    paramif_obj_t *obj_stp;
+    uint16_t written_u16 = 0U;
+    bool commit_bol = false;
+
+    xTimerStop(commitTimer_sts, 0U);
+
+    for(uint16_t idx_u16 = 0U; (0U < dirtyObjects_u16s) && (poolSize_u16s > idx_u16); 
+        idx_u16++)
+    {
+        obj_stp = GetObject_stp(idx_u16);
+        if((true == obj_stp->used_bol) && (true == obj_stp->dirty_bol))
+        {
+            FillHeader_vd(obj_stp);
+            if(ESP_OK == SetBlob_td(obj_stp, &commit_bol))
+            {
+                obj_stp->dirty_bol = false;
+                dirtyObjects_u16s--;
+                written_u16++;
+            }
+            else
+            {
+                ESP_LOGE(TAG, "parameter write failed: %s", obj_stp->param_st.nvsIdent_cp);
+                err_st = ESP_FAIL;
+            }
+        }
+    }
+
+    stats_sts.blobWrites_u32 += written_u16;
+    if(true == commit_bol)
+    {
+        if(ESP_OK == nvs_commit(nvsHandle_sts))
+        {
+            stats_sts.commits_u32++;
+        }
+        else
+        {
+            err_st = ESP_FAIL;
+        }
+    }
+
+    if(0U < dirtyObjects_u16s)
+    {
+        // retry the failed objects after the quiet time
+        xTimerReset(commitTimer_sts, 0U);
+    }
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Reads the stored blob of an object from its backend. An object of the log
+ *              backend without record is read from nvs, so the value stored before
+ *              the change of the backend is kept.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     handle_xp     parameter handle
+ * @param     dest_u8p      destination of the blob
+ * @param     length_stp    in: size of the destination, out: length of the blob
+ * @return    ESP_ERR_NVS_INVALID_LENGTH if the destination is too small, else the
+ *              result of the backend
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t GetBlob_td(paramif_objHdl_t handle_xp, uint8_t *dest_u8p, 
+                            size_t *length_stp)
+{
+    esp_err_t err_st = ESP_ERR_NOT_FOUND;
+
+    if(paramif_BACKEND_LOG == handle_xp->param_st.backend_en)
+    {
+        err_st = paramlog_Read_td(handle_xp->param_st.nvsIdent_cp, dest_u8p, length_stp);
+        if(ESP_ERR_INVALID_SIZE == err_st)
+        {
+            err_st = ESP_ERR_NVS_INVALID_LENGTH;
+        }
+    }
+
+    if(ESP_ERR_NOT_FOUND == err_st)
+    {
+        err_st = nvs_get_blob(nvsHandle_sts, handle_xp->param_st.nvsIdent_cp, dest_u8p, 
+                                length_stp);
+    }
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Writes the blob of an object to its backend
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     handle_xp     parameter handle
+ * @param     commit_bolp   set to true if the blob was written to nvs and needs a commit
+ * @return    result of the backend
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t SetBlob_td(paramif_objHdl_t handle_xp, bool *commit_bolp)
+{
+    esp_err_t err_st;
+    uint16_t length_u16 = sizeof(blobHeader_t) + handle_xp->param_st.length_u16;
+
+    if(paramif_BACKEND_LOG == handle_xp->param_st.backend_en)
+    {
+        err_st = paramlog_Write_td(handle_xp->param_st.nvsIdent_cp, handle_xp->blob_u8p,
+                                    length_u16);
+    }
+    else
+    {
+        err_st = nvs_set_blob(nvsHandle_sts, handle_xp->param_st.nvsIdent_cp, 
+                                handle_xp->blob_u8p, length_u16);
+        if(ESP_OK == err_st)
+        {
+            *commit_bolp = true;
+        }
+    }
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Walks through the entries of an import document. Without apply the document
+ *              is only checked, every identifier has to be allocated with the same
+ *              length and schema version. With apply the changed objects are marked
+ *              dirty. The pool mutex has to be taken by the caller.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     src_u8p       document
+ * @param     length_st     length of the document
+ * @param     apply_bol     true to copy the data to the shadows
+ * @return    ESP_ERR_INVALID_ARG if the document is not valid, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t WalkDocument_td(const uint8_t *src_u8p, size_t length_st, bool apply_bol)
+{
+    esp_err_t err_st = ESP_ERR_INVALID_ARG;
+    exportHeader_t header_st;
+    blobHeader_t blobHeader_st;
+    paramif_obj_t *obj_stp;
+    char ident_ca[IDENT_SIZE];
+    size_t pos_st = sizeof(exportHeader_t);
+    uint16_t blobLen_u16;
+    uint8_t identLen_u8;
+
+    if(sizeof(exportHeader_t) <= length_st)
+    {
+        memcpy(&header_st, src_u8p, sizeof(exportHeader_t));
+        if(   (EXPORT_MAGIC == header_st.magic_u32) 
+           && (EXPORT_VERSION == header_st.version_u8)
+           && ((sizeof(exportHeader_t) + header_st.length_u16) == length_st)
+           && (header_st.crc_u16 == crc16_le(0U, &src_u8p[sizeof(exportHeader_t)], 
+                                                header_st.length_u16)))
+        {
+            err_st = ESP_OK;
+        }
+    }
+
+    for(uint16_t idx_u16 = 0U; (ESP_OK == err_st) && (idx_u16 < header_st.count_u16); 
+        idx_u16++)
+    {
+        err_st = ESP_ERR_INVALID_ARG;
+        obj_stp = NULL;
+        identLen_u8 = (pos_st < length_st) ? src_u8p[pos_st] : 0U;
+        if((0U < identLen_u8) && (IDENT_SIZE > identLen_u8) 
+           && ((pos_st + 3U + identLen_u8) <= length_st))
+        {
+            memcpy(ident_ca, &src_u8p[pos_st + 1U], identLen_u8);
+            ident_ca[identLen_u8] = '\0';
+            memcpy(&blobLen_u16, &src_u8p[pos_st + 1U + identLen_u8], 2U);
+            pos_st += 3U + identLen_u8;
+            obj_stp = FindLocked_stp(ident_ca);
+        }
+
+        if(   (NULL != obj_stp) && ((pos_st + blobLen_u16) <= length_st)
+           && (true == CheckHeader_bol(&src_u8p[pos_st], blobLen_u16)))
+        {
+            memcpy(&blobHeader_st, &src_u8p[pos_st], sizeof(blobHeader_t));
+            if(   (obj_stp->param_st.version_u8 == blobHeader_st.version_u8)
+               && (obj_stp->param_st.length_u16 == blobHeader_st.length_u16))
+            {
+                err_st = ESP_OK;
+            }
+        }
+
+        if(ESP_OK != err_st)
+        {
+            ESP_LOGE(TAG, "import entry %d not valid", idx_u16);
+        }
+        else if(   (true == apply_bol)
+                && (   (false == obj_stp->valid_bol)
+                    || (0 != memcmp(obj_stp->shadow_u8p, 
+                                    &src_u8p[pos_st + sizeof(blobHeader_t)],
+                                    obj_stp->param_st.length_u16))))
+        {
+            memcpy(obj_stp->shadow_u8p, &src_u8p[pos_st + sizeof(blobHeader_t)],
+                    obj_stp->param_st.length_u16);
+            obj_stp->valid_bol = true;
+            if(false == obj_stp->dirty_bol)
+            {
+                obj_stp->dirty_bol = true;
+                dirtyObjects_u16s++;
+            }
+        }
+        pos_st += blobLen_u16;
+    }
+
+    if((ESP_OK == err_st) && (pos_st != length_st))
+    {
+        err_st = ESP_ERR_INVALID_ARG;
+    }
+    return(err_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Copies the shadows and flags of all allocated objects, the pool mutex has
+ *              to be taken by the caller
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    the copy, to be freed by the caller, NULL if no memory is left
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t *SnapshotShadows_u8p(void)
+{
+    paramif_obj_t *obj_stp;
+    uint8_t *snap_u8p;
+    size_t size_st = 1U;
+    size_t pos_st = 0U;
+
+    // per object the valid and dirty flag followed by the shadow
+    for(uint16_t idx_u16 = 0U; poolSize_u16s > idx_u16; idx_u16++)
+    {
+        obj_stp = GetObject_stp(idx_u16);
+        if(true == obj_stp->used_bol)
+        {
+            size_st += 2U + obj_stp->param_st.length_u16;
+        }
+    }
+
+    snap_u8p = malloc(size_st);
+    for(uint16_t idx_u16 = 0U; (NULL != snap_u8p) && (poolSize_u16s > idx_u16); idx_u16++)
+    {
+        obj_stp = GetObject_stp(idx_u16);
+        if(true == obj_stp->used_bol)
+        {
+            snap_u8p[pos_st] = (uint8_t)obj_stp->valid_bol;
+            snap_u8p[pos_st + 1U] = (uint8_t)obj_stp->dirty_bol;
+            memcpy(&snap_u8p[pos_st + 2U], obj_stp->shadow_u8p, 
+                    obj_stp->param_st.length_u16);
+            pos_st += 2U + obj_stp->param_st.length_u16;
+        }
+    }
+    return(snap_u8p);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Restores the shadows of SnapshotShadows_u8p. An object changed by the
+ *              import which was already written stays dirty, so the old data is
+ *              written again. The pool mutex has to be taken by the caller.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     snap_u8p      copy of SnapshotShadows_u8p, the pool is unchanged since
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void RestoreShadows_vd(const uint8_t *snap_u8p)
+{
+    paramif_obj_t *obj_stp;
+    size_t pos_st = 0U;
+    bool dirty_bol;
+
+    for(uint16_t idx_u16 = 0U; poolSize_u16s > idx_u16; idx_u16++)
+    {
+        obj_stp = GetObject_stp(idx_u16);
+        if(   (true == obj_stp->used_bol)
+           && (   ((bool)snap_u8p[pos_st] != obj_stp->valid_bol)
+               || (0 != memcmp(&snap_u8p[pos_st + 2U], obj_stp->shadow_u8p,
+                                obj_stp->param_st.length_u16))))
+        {
+            // a failed write left the stored data of before, a written object not
+            dirty_bol = ((bool)snap_u8p[pos_st + 1U]) || (false == obj_stp->dirty_bol);
+            if((true == dirty_bol) && (false == obj_stp->dirty_bol))
+            {
+                dirtyObjects_u16s++;
+            }
+            else if((false == dirty_bol) && (true == obj_stp->dirty_bol))
+            {
+                dirtyObjects_u16s--;
+            }
+            obj_stp->dirty_bol = dirty_bol;
+            obj_stp->valid_bol = (bool)snap_u8p[pos_st];
+            memcpy(obj_stp->shadow_u8p, &snap_u8p[pos_st + 2U], 
+                    obj_stp->param_st.length_u16);
+        }
+        if(true == obj_stp->used_bol)
+        {
+            pos_st += 2U + obj_stp->param_st.length_u16;
+        }
+    }
+
+    if(0U < dirtyObjects_u16s)
+    {
+        xTimerReset(commitTimer_sts, 0U);
+    }
+    else
+    {
+        xTimerStop(commitTimer_sts, 0U);
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Handler for the parameter export and import console command
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     argc_s32        number of arguments
+ * @param     argv            arguments
+ * @param     retStream_xp    output stream of the console
+ * @return    0 if the command was executed, else 1
+*//*-----------------------------------------------------------------------------------*/
+static int32_t CmdHandlerParam_s32(int32_t argc_s32, char** argv, FILE *retStream_xp)
+{
+    int32_t retValue_s32 = 1;
+    paramif_obj_t *obj_stp;
+
+    int32_t nerrors_s32 = arg_parse(argc_s32, argv, (void**) &cmdParam_sts);
+
+    if(0 != nerrors_s32)
+    {
+        arg_print_errors(stderr, cmdParam_sts.end_stp, argv[0]);
+    }
+    else if(0 != cmdParam_sts.list_stp->count)
+    {
+        xSemaphoreTake(poolMutex_sts, portMAX_DELAY);
+        for(uint16_t idx_u16 = 0U; idx_u16 < poolSize_u16s; idx_u16++)
+        {
+            obj_stp = GetObject_stp(idx_u16);
+            if(true == obj_stp->used_bol)
+            {
+                fprintf(retStream_xp, "%s, length %d, version %d, %s%s\n", 
+                        obj_stp->param_st.nvsIdent_cp, obj_stp->param_st.length_u16,
+                        obj_stp->param_st.version_u8,
+                        (paramif_BACKEND_LOG == obj_stp->param_st.backend_en) ? 
+                            "log" : "nvs",
+                        (true == obj_stp->dirty_bol) ? ", dirty" : "");
+            }
+        }
+        xSemaphoreGive(poolMutex_sts);
+        retValue_s32 = 0;
+    }
+    else if(0 != cmdParam_sts.export_stp->count)
+    {
+        PrintExportPart_vd((uint16_t)cmdParam_sts.export_stp->ival[0], retStream_xp);
+        retValue_s32 = 0;
+    }
+    else if(0 != cmdParam_sts.append_stp->count)
+    {
+        AppendImportPart_vd(cmdParam_sts.append_stp->sval[0], retStream_xp);
+        retValue_s32 = 0;
+    }
+    else if(0 != cmdParam_sts.import_stp->count)
+    {
+        if(ESP_OK == paramif_Import_td(importBuf_u8ps, importLen_u16s))
+        {
+            fprintf(retStream_xp, "parameters imported, reboot to apply\n");
+            retValue_s32 = 0;
+        }
+        else
+        {
+            fprintf(retStream_xp, "import document rejected\n");
+        }
+    }
+    else if(0 != cmdParam_sts.clear_stp->count)
+    {
+        importLen_u16s = 0U;
+        retValue_s32 = 0;
+    }
+
+    if((0 != nerrors_s32) || (0 != cmdParam_sts.import_stp->count) 
+       || (0 != cmdParam_sts.clear_stp->count))
+    {
+        free(importBuf_u8ps);
+        importBuf_u8ps = NULL;
+        importLen_u16s = 0U;
+    }
+    return(retValue_s32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Prints one part of the export document base64 coded, the document is
+ *              built again for every part
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     part_u16        part of the document starting with 0
+ * @param     retStream_xp    output stream of the console
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void PrintExportPart_vd(uint16_t part_u16, FILE *retStream_xp)
+{
+    uint8_t *doc_u8p = NULL;
+    unsigned char *text_ucp = NULL;
+    size_t length_st = 0U;
+    size_t textLen_st = 0U;
+    size_t partLen_st;
+    uint16_t parts_u16;
+
+    if(ESP_OK == paramif_Export_td(NULL, 0U, &length_st))
+    {
+        doc_u8p = malloc(length_st);
+        text_ucp = malloc(((EXPORT_PART_SIZE / 3U) * 4U) + 1U);
+    }
+
+    if(   (NULL != doc_u8p) && (NULL != text_ucp)
+       && (ESP_OK == paramif_Export_td(doc_u8p, length_st, &length_st)))
+    {
+        parts_u16 = (length_st + EXPORT_PART_SIZE - 1U) / EXPORT_PART_SIZE;
+        if(part_u16 < parts_u16)
+        {
+            partLen_st = length_st - (part_u16 * EXPORT_PART_SIZE);
+            partLen_st = (EXPORT_PART_SIZE < partLen_st) ? EXPORT_PART_SIZE : partLen_st;
+            (void)mbedtls_base64_encode(text_ucp, ((EXPORT_PART_SIZE / 3U) * 4U) + 1U,
+                                        &textLen_st, &doc_u8p[part_u16 * EXPORT_PART_SIZE],
+                                        partLen_st);
+            fprintf(retStream_xp, "part %d of %d\n%.*s\n", part_u16 + 1U, parts_u16, 
+                    (int)textLen_st, text_ucp);
+        }
+        else
+        {
+            fprintf(retStream_xp, "document has %d parts\n", parts_u16);
+        }
+    }
+    else
+    {
+        fprintf(retStream_xp, "export failed\n");
+    }
+    free(text_ucp);
+    free(doc_u8p);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Decodes a base64 coded part and appends it to the import document
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     part_cchp       base64 coded part
+ * @param     retStream_xp    output stream of the console
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void AppendImportPart_vd(const char *part_cchp, FILE *retStream_xp)
+{
+    size_t length_st = 0U;
+
+    if(NULL == importBuf_u8ps)
+    {
+        importBuf_u8ps = malloc(IMPORT_MAX_SIZE);
+        importLen_u16s = 0U;
+    }
+
+    if(   (NULL != importBuf_u8ps)
+       && (0 == mbedtls_base64_decode(&importBuf_u8ps[importLen_u16s], 
+                                        IMPORT_MAX_SIZE - importLen_u16s, &length_st,
+                                        (const unsigned char *)part_cchp, 
+                                        strlen(part_cchp))))
+    {
+        importLen_u16s += length_st;
+        fprintf(retStream_xp, "import document %d bytes\n", importLen_u16s);
+    }
+    else
+    {
+        // a lost part makes the document useless
+        fprintf(retStream_xp, "part not decoded, import document dropped\n");
+        importLen_u16s = 0U;
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Commit timer callback, requests the flush after the quiet time. The nvs
+ *            write blocks for several ms and would stall all other timers of the daemon
+ *            task, so it is only signalled here and done in the context of the owner.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     xTimer    handle of the timer
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void CommitTimerCallback_vd(TimerHandle_t xTimer)
+{
+    if(NULL != flushRequest_fps)
+    {
+        flushRequest_fps();
+    }
+}
@@ -48,20 +48,50 @@ extern "C"
 
 /****************************************************************************************/
 /* Global type definitions (enum (en), struct (st), union (un), typedef (tx): */
+// called from the timer daemon when the quiet time has passed, shall only signal a task
+// which then calls paramif_Flush_td
+typedef void (* paramif_FlushRequest_td)(void);
+
 typedef struct paramif_param_tag
 {
-
+    paramif_FlushRequest_td flushRequest_fp;    /*!< NULL, flushed at COMMIT_MAX_DIRTY */
 }paramif_param_t;
 
+typedef enum paramif_backend_tag
+{
+    paramif_BACKEND_NVS     = 0,    /*!< nvs blob, for configuration data */
+    paramif_BACKEND_LOG     = 1,    /*!< append only log, for often changing values */
+}paramif_backend_t;
+
+/* upgrades the data of a parameter set in place from version_u8 to version_u8 + 1, the
+   buffer holds bufSize_u16 bytes, the length is updated to the new length */
+typedef esp_err_t (*paramif_Migrate_td)(uint8_t version_u8, uint8_t *data_u8p,
+                                        uint16_t *length_u16p, uint16_t bufSize_u16);
+
 typedef struct paramif_allocParam_tag
 {
     const char *nvsIdent_cp;
     uint16_t length_u16;
     uint8_t *defaults_u8p;
+    uint8_t version_u8;             /*!< schema version of the data, starts with 1 */
+    paramif_Migrate_td migrate_fp;  /*!< upgrade of older versions, NULL if not needed */
+    paramif_backend_t backend_en;   /*!< storage of the parameter set */
 }paramif_allocParam_t;
 
 typedef struct paramif_obj_tag *paramif_objHdl_t;
 
+typedef struct paramif_stats_tag
+{
+    uint32_t loads_u32;         /*!< objects loaded from nvs at allocation */
+    uint32_t reads_u32;         /*!< reads served from the ram shadow */
+    uint32_t writes_u32;        /*!< write requests */
+    uint32_t unchanged_u32;     /*!< write requests without change of the data */
+    uint32_t blobWrites_u32;    /*!< objects written to nvs */
+    uint32_t commits_u32;       /*!< nvs commits */
+    uint32_t migrated_u32;      /*!< objects upgraded from an older version */
+    uint32_t rejected_u32;      /*!< stored objects replaced by defaults (crc, version) */
+}paramif_stats_t;
+
 /****************************************************************************************/
 /* Global function definitions: */
 
@@ -110,7 +140,8 @@ extern esp_err_t paramif_DeActivate_td(void);
 extern esp_err_t paramif_EraseAllParameter_td(void);
 
 /**---------------------------------------------------------------------------------------
- * @brief     Set the parameter structure for one object to defaults
+ * @brief     Set the parameter structure for one object to defaults, the schema
+ *              version is set to 1 without migration function, stored in nvs
  * @author    S. Wink
  * @date      15. Feb. 2019
  * @param     param_stp           pointer to parameter structure
@@ -119,8 +150,14 @@ extern esp_err_t paramif_EraseAllParameter_td(void);
 extern esp_err_t paramif_InitializeAllocParameter_td(paramif_allocParam_t *param_stp);
 
 /**---------------------------------------------------------------------------------------
- * @brief     Allocates a new parameter set and returns a pointer to the parameter. This
- *              is only possible if the module is not activated.
+ * @brief     Allocates a new parameter set and returns a pointer to the parameter. If a
+ *              parameter set with the same nvs identifier and length is already
+ *              allocated its handle is returned. The pool grows if all objects are used.
+ *              Stored data of an older schema version is upgraded with the migration
+ *              function of the parameter set and written back with the next commit.
+ *              A parameter set for the log backend is stored in nvs if the log
+ *              partition is not available or the data exceeds a log record. If the log
+ *              holds no record so far, the data is taken from nvs once.
  * @author    S. Wink
  * @date      15. Feb. 2019
  * @param     param_stp           pointer to parameter structure
@@ -128,6 +165,15 @@ extern esp_err_t paramif_InitializeAllocParameter_td(paramif_allocParam_t *param
 *//*-----------------------------------------------------------------------------------*/
 extern paramif_objHdl_t paramif_Allocate_stp(paramif_allocParam_t *param_stp);
 
+/**---------------------------------------------------------------------------------------
+ * @brief     Searches an allocated parameter set by its nvs identifier
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     nvsIdent_cp         nvs identifier of the parameter set
+ * @return    NULL if the parameter set is not allocated, else the handle
+*//*-----------------------------------------------------------------------------------*/
+extern paramif_objHdl_t paramif_Find_stp(const char *nvsIdent_cp);
+
 /**---------------------------------------------------------------------------------------
  * @brief     Read parameter from storage device
  * @author    S. Wink
@@ -148,7 +194,9 @@ extern esp_err_t paramif_Read_td(paramif_objHdl_t handle_xp, uint8_t *dest_u8p);
 extern uint16_t paramif_GetLength_u16(paramif_objHdl_t handle_xp, uint8_t *src_u8p);
 
 /**---------------------------------------------------------------------------------------
- * @brief     writes data to the non volatile flash
+ * @brief     writes data to the non volatile flash. The data is written to nvs after
+ *              a quiet time or together with other changed parameters, unchanged data
+ *              is not written at all.
  * @author    S. Wink
  * @date      15. Feb. 2019
  * @param     handle_xp parameter handle
@@ -157,6 +205,57 @@ extern uint16_t paramif_GetLength_u16(paramif_objHdl_t handle_xp, uint8_t *src_u
 *//*-----------------------------------------------------------------------------------*/
 extern esp_err_t paramif_Write_td(paramif_objHdl_t handle_xp, uint8_t *src_u8p);
 
+/**---------------------------------------------------------------------------------------
+ * @brief     writes all changed parameters to nvs with one commit, has to be called
+ *              before a reboot
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_ERR in case of an error, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramif_Flush_td(void);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     get the counters of the parameter storage
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stats_stp     destination of the counters
+ * @return    ESP_ERR in case of an error, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramif_GetStats_td(paramif_stats_t *stats_stp);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     exports all loaded parameter objects to one document. Every entry holds
+ *              the identifier and the stored blob with schema version and crc.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     dest_u8p      destination of the document, NULL to get the length only
+ * @param     size_st       size of the destination
+ * @param     length_stp    length of the document
+ * @return    ESP_ERR_INVALID_SIZE if the destination is too small, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramif_Export_td(uint8_t *dest_u8p, size_t size_st, size_t *length_stp);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     imports a document of paramif_Export_td. The document is checked
+ *              completely before any object is changed, every identifier has to be
+ *              allocated with the same length and schema version. The changed objects
+ *              are written with one commit, the users read them after a reboot.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     src_u8p       document
+ * @param     length_st     length of the document
+ * @return    ESP_ERR_INVALID_ARG if the document is not valid, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramif_Import_td(const uint8_t *src_u8p, size_t length_st);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     registers the console command for the export and import of parameters
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the command was registered, else ESP_FAIL
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramif_RegisterCommands_td(void);
+
 /**---------------------------------------------------------------------------------------
  * @brief     erase the parameter to 0xFF
  * @author    S. Wink
@@ -0,0 +1,652 @@
+/*****************************************************************************************
+* FILENAME :        paramlog.c
+*
+* DESCRIPTION :
+*       Append only record log for parameters which change often. Every write appends
+*       a small record with a sequence number to the current sector of the log
+*       partition, a ram index points to the newest record of every key. If the
+*       free sectors run short, the live records of the oldest sector are copied to
+*       the head of the log and the sector is erased. So every sector is erased
+*       once per round through the partition instead of rewriting nvs pages on
+*       every change.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* PUBLIC FUNCTIONS :
+*
+* Copyright (c) [2017] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "paramlog.h"
+
+#include "string.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "rom/crc.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define MODULE_TAG              "paramlog"
+
+#define SECTOR_SIZE             4096U       // erase unit of the log partition
+#define SECTOR_MAGIC            0x4C4F4750U // marks a sector in use
+#define ERASED_U32              0xFFFFFFFFU
+#define MAX_KEYS                32U         // keys held in the ram index
+#define MIN_SECTORS             3U          // head, tail and one sector for compaction
+#define FREE_RESERVE            2U          // free sectors before a user write opens one
+#define KEY_SIZE                (paramlog_MAX_KEY_LEN + 1U)
+#define SECTOR_HDR_SIZE         sizeof(sectorHeader_t)
+#define RECORD_HDR_SIZE         sizeof(recordHeader_t)
+
+/****************************************************************************************/
+/* Local function like makros */
+#define ALIGN4(x)               (((x) + 3U) & ~3U)
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* header at the start of every sector in use (8 bytes) */
+typedef struct sectorHeader_tag
+{
+    uint32_t magic_u32;
+    uint32_t seq_u32;           // sector sequence, the oldest sector has the lowest
+}sectorHeader_t;
+
+/* header in front of the record data, records are aligned to 4 bytes (24 bytes) */
+typedef struct recordHeader_tag
+{
+    uint32_t seq_u32;           // record sequence, the newest record of a key wins
+    uint16_t length_u16;        // length of the data behind the header
+    uint16_t crc_u16;           // crc16 of key and data
+    char key_ca[KEY_SIZE];
+}recordHeader_t;
+
+typedef struct indexEntry_tag
+{
+    char key_ca[KEY_SIZE];
+    uint32_t offset_u32;        // partition offset of the newest record
+    uint32_t seq_u32;
+    uint16_t length_u16;
+}indexEntry_t;
+
+typedef struct objectData_tag
+{
+    const esp_partition_t *part_stp;
+    uint16_t sectors_u16;       // sectors of the partition
+    uint16_t tail_u16;          // oldest sector in use
+    uint16_t head_u16;          // sector records are appended to
+    uint16_t used_u16;          // sectors in use
+    uint32_t headOffset_u32;    // next free byte in the head sector
+    uint32_t sectorSeq_u32;
+    uint32_t recordSeq_u32;
+    indexEntry_t index_sta[MAX_KEYS];
+    uint16_t keys_u16;
+    uint8_t buf_u8a[paramlog_MAX_DATA_LEN];
+    paramlog_stats_t stats_st;
+}objectData_t;
+
+/****************************************************************************************/
+/* Local functions prototypes: */
+static void ScanLog_vd(void);
+static uint32_t ScanSector_u32(uint16_t sector_u16);
+static indexEntry_t *FindEntry_stp(const char *key_cp);
+static indexEntry_t *UpdateIndex_stp(const char *key_cp, uint32_t offset_u32, 
+                                        uint32_t seq_u32, uint16_t length_u16);
+static esp_err_t AppendRecord_td(const char *key_cp, const uint8_t *src_u8p, 
+                                    uint16_t length_u16, bool userWrite_bol);
+static esp_err_t OpenNextSector_td(void);
+static esp_err_t CompactTail_td(void);
+static esp_err_t EraseSector_td(uint16_t sector_u16);
+static uint16_t RecordCrc_u16(const char *key_cp, const uint8_t *data_u8p, 
+                                uint16_t length_u16);
+
+/****************************************************************************************/
+/* Local variables: */
+
+static const char *TAG = MODULE_TAG;
+
+static objectData_t this_sst;
+
+/****************************************************************************************/
+/* Global functions (unlimited visibility) */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Initialization of the parameter log
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramlog_Initialize_td(void)
+{
+    esp_err_t result_st = ESP_ERR_NOT_FOUND;
+
+    memset(&this_sst, 0U, sizeof(this_sst));
+    this_sst.part_stp = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                        (esp_partition_subtype_t)paramlog_PARTITION_SUBTYPE,
+                                        paramlog_PARTITION_LABEL);
+    if(NULL != this_sst.part_stp)
+    {
+        this_sst.sectors_u16 = this_sst.part_stp->size / SECTOR_SIZE;
+        if(MIN_SECTORS <= this_sst.sectors_u16)
+        {
+            ScanLog_vd();
+            ESP_LOGI(TAG, "log partition found, %d of %d sectors used, %d keys",
+                        this_sst.used_u16, this_sst.sectors_u16, this_sst.keys_u16);
+            result_st = ESP_OK;
+        }
+        else
+        {
+            ESP_LOGE(TAG, "log partition too small...");
+            this_sst.part_stp = NULL;
+        }
+    }
+    else
+    {
+        ESP_LOGI(TAG, "no log partition, parameters are stored in nvs");
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Check if the log partition is available
+*//*-----------------------------------------------------------------------------------*/
+bool paramlog_IsAvailable_bol(void)
+{
+    return(NULL != this_sst.part_stp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Reads the newest record of a key
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramlog_Read_td(const char *key_cp, uint8_t *dest_u8p, size_t *length_stp)
+{
+    esp_err_t result_st = ESP_ERR_NOT_FOUND;
+    indexEntry_t *entry_stp = NULL;
+
+    if((NULL != this_sst.part_stp) && (NULL != key_cp))
+    {
+        entry_stp = FindEntry_stp(key_cp);
+    }
+
+    if((NULL != entry_stp) && (NULL != dest_u8p) && (NULL != length_stp))
+    {
+        if(entry_stp->length_u16 > *length_stp)
+        {
+            result_st = ESP_ERR_INVALID_SIZE;
+        }
+        else
+        {
+            result_st = esp_partition_read(this_sst.part_stp, 
+                                            entry_stp->offset_u32 + RECORD_HDR_SIZE,
+                                            dest_u8p, entry_stp->length_u16);
+        }
+        *length_stp = entry_stp->length_u16;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Appends a new record of a key
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramlog_Write_td(const char *key_cp, const uint8_t *src_u8p, uint16_t length_u16)
+{
+    esp_err_t result_st = ESP_FAIL;
+
+    if(   (NULL != this_sst.part_stp) && (NULL != key_cp) && (NULL != src_u8p)
+       && (paramlog_MAX_KEY_LEN >= strlen(key_cp))
+       && (paramlog_MAX_DATA_LEN >= length_u16))
+    {
+        if((NULL == FindEntry_stp(key_cp)) && (MAX_KEYS <= this_sst.keys_u16))
+        {
+            ESP_LOGE(TAG, "no index entry left for %s", key_cp);
+            result_st = ESP_ERR_NO_MEM;
+        }
+        else
+        {
+            result_st = AppendRecord_td(key_cp, src_u8p, length_u16, true);
+        }
+
+        if(ESP_OK == result_st)
+        {
+            this_sst.stats_st.appends_u32++;
+            this_sst.stats_st.userBytes_u32 += length_u16;
+        }
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Erases the complete log partition
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t paramlog_EraseAll_td(void)
+{
+    esp_err_t result_st = ESP_FAIL;
+
+    if(NULL != this_sst.part_stp)
+    {
+        result_st = esp_partition_erase_range(this_sst.part_stp, 0U,
+                                                this_sst.sectors_u16 * SECTOR_SIZE);
+        this_sst.stats_st.erases_u32 += this_sst.sectors_u16;
+        memset(this_sst.index_sta, 0U, sizeof(this_sst.index_sta));
+        this_sst.keys_u16 = 0U;
+        this_sst.used_u16 = 0U;
+        this_sst.tail_u16 = 0U;
+        this_sst.head_u16 = this_sst.sectors_u16 - 1U;
+        this_sst.headOffset_u32 = SECTOR_SIZE;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the counters of the parameter log
+*//*-----------------------------------------------------------------------------------*/
+void paramlog_GetStats_vd(paramlog_stats_t *stats_stp)
+{
+    if(NULL != stats_stp)
+    {
+        memcpy(stats_stp, &this_sst.stats_st, sizeof(paramlog_stats_t));
+    }
+}
+
+/****************************************************************************************/
+/* Local functions: */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Scans all sectors of the partition, finds the oldest and the newest sector
+ *              and builds the index from the records in between
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void ScanLog_vd(void)
+{
+    sectorHeader_t header_st;
+    uint32_t minSeq_u32 = ERASED_U32;
+    uint32_t maxSeq_u32 = 0U;
+    uint16_t sector_u16;
+
+    // without sectors in use the first write opens sector 0
+    this_sst.head_u16 = this_sst.sectors_u16 - 1U;
+    this_sst.headOffset_u32 = SECTOR_SIZE;
+
+    for(sector_u16 = 0U; sector_u16 < this_sst.sectors_u16; sector_u16++)
+    {
+        if(ESP_OK != esp_partition_read(this_sst.part_stp, sector_u16 * SECTOR_SIZE,
+                                        &header_st, SECTOR_HDR_SIZE))
+        {
+            header_st.magic_u32 = 0U;
+        }
+
+        if(SECTOR_MAGIC == header_st.magic_u32)
+        {
+            if(header_st.seq_u32 < minSeq_u32)
+            {
+                minSeq_u32 = header_st.seq_u32;
+                this_sst.tail_u16 = sector_u16;
+            }
+            if(header_st.seq_u32 >= maxSeq_u32)
+            {
+                maxSeq_u32 = header_st.seq_u32;
+                this_sst.head_u16 = sector_u16;
+            }
+            this_sst.used_u16++;
+        }
+        else if(ERASED_U32 != header_st.magic_u32)
+        {
+            // interrupted erase or header write, the sector is cleaned now
+            (void)EraseSector_td(sector_u16);
+        }
+    }
+
+    if(0U < this_sst.used_u16)
+    {
+        // the sectors are used as ring, the records are scanned from old to new
+        this_sst.used_u16 = ((this_sst.head_u16 + this_sst.sectors_u16 - this_sst.tail_u16)
+                                % this_sst.sectors_u16) + 1U;
+        this_sst.sectorSeq_u32 = maxSeq_u32 + 1U;
+        for(uint16_t idx_u16 = 0U; idx_u16 < this_sst.used_u16; idx_u16++)
+        {
+            sector_u16 = (this_sst.tail_u16 + idx_u16) % this_sst.sectors_u16;
+            this_sst.headOffset_u32 = ScanSector_u32(sector_u16);
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Adds the records of a sector to the index. A record with a bad crc ends
+ *              the sector, it is not used for appends any more.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sector_u16        sector to be scanned
+ * @return    offset of the first free byte in the sector
+*//*-----------------------------------------------------------------------------------*/
+static uint32_t ScanSector_u32(uint16_t sector_u16)
+{
+    recordHeader_t header_st;
+    uint32_t base_u32 = sector_u16 * SECTOR_SIZE;
+    uint32_t offset_u32 = SECTOR_HDR_SIZE;
+    uint32_t size_u32;
+    bool end_bol = false;
+
+    while((false == end_bol) && ((offset_u32 + RECORD_HDR_SIZE) <= SECTOR_SIZE))
+    {
+        if(ESP_OK != esp_partition_read(this_sst.part_stp, base_u32 + offset_u32,
+                                        &header_st, RECORD_HDR_SIZE))
+        {
+            offset_u32 = SECTOR_SIZE;
+            end_bol = true;
+        }
+        else if(ERASED_U32 == header_st.seq_u32)
+        {
+            end_bol = true;
+        }
+        else
+        {
+            size_u32 = ALIGN4(RECORD_HDR_SIZE + header_st.length_u16);
+            header_st.key_ca[paramlog_MAX_KEY_LEN] = '\0';
+            if(   (paramlog_MAX_DATA_LEN < header_st.length_u16)
+               || (SECTOR_SIZE < (offset_u32 + size_u32))
+               || (ESP_OK != esp_partition_read(this_sst.part_stp, 
+                                            base_u32 + offset_u32 + RECORD_HDR_SIZE,
+                                            this_sst.buf_u8a, header_st.length_u16))
+               || (header_st.crc_u16 != RecordCrc_u16(header_st.key_ca, this_sst.buf_u8a,
+                                                        header_st.length_u16)))
+            {
+                ESP_LOGW(TAG, "sector %d closed at broken record", sector_u16);
+                offset_u32 = SECTOR_SIZE;
+                end_bol = true;
+            }
+            else
+            {
+                (void)UpdateIndex_stp(header_st.key_ca, base_u32 + offset_u32,
+                                        header_st.seq_u32, header_st.length_u16);
+                if(header_st.seq_u32 >= this_sst.recordSeq_u32)
+                {
+                    this_sst.recordSeq_u32 = header_st.seq_u32 + 1U;
+                }
+                offset_u32 += size_u32;
+            }
+        }
+    }
+    return(offset_u32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Searches the index entry of a key
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     key_cp            key of the record
+ * @return    index entry or NULL if the key is not stored
+*//*-----------------------------------------------------------------------------------*/
+static indexEntry_t *FindEntry_stp(const char *key_cp)
+{
+    indexEntry_t *entry_stp = NULL;
+
+    for(uint16_t idx_u16 = 0U; (NULL == entry_stp) && (idx_u16 < this_sst.keys_u16); 
+        idx_u16++)
+    {
+        if(0 == strncmp(this_sst.index_sta[idx_u16].key_ca, key_cp, KEY_SIZE))
+        {
+            entry_stp = &this_sst.index_sta[idx_u16];
+        }
+    }
+    return(entry_stp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Points the index entry of a key to a newer record, a new entry is added
+ *              for an unknown key
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     key_cp            key of the record
+ * @param     offset_u32        partition offset of the record
+ * @param     seq_u32           sequence number of the record
+ * @param     length_u16        length of the record data
+ * @return    index entry or NULL if the index is full
+*//*-----------------------------------------------------------------------------------*/
+static indexEntry_t *UpdateIndex_stp(const char *key_cp, uint32_t offset_u32, 
+                                        uint32_t seq_u32, uint16_t length_u16)
+{
+    indexEntry_t *entry_stp = FindEntry_stp(key_cp);
+
+    if((NULL == entry_stp) && (MAX_KEYS > this_sst.keys_u16))
+    {
+        entry_stp = &this_sst.index_sta[this_sst.keys_u16];
+        this_sst.keys_u16++;
+        strncpy(entry_stp->key_ca, key_cp, KEY_SIZE);
+        entry_stp->seq_u32 = 0U;
+    }
+
+    if((NULL != entry_stp) && (seq_u32 >= entry_stp->seq_u32))
+    {
+        entry_stp->offset_u32 = offset_u32;
+        entry_stp->seq_u32 = seq_u32;
+        entry_stp->length_u16 = length_u16;
+    }
+    return(entry_stp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Writes a record to the head sector. If the record does not fit, the next
+ *              sector is opened. A user write compacts the oldest sectors before, so
+ *              one free sector is left for the copies of the compaction.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     key_cp            key of the record
+ * @param     src_u8p           data of the record
+ * @param     length_u16        length of the data
+ * @param     userWrite_bol     true for a user write, false for a compaction copy
+ * @return    ESP_ERR_NO_MEM if the log is full, else the result of the flash write
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t AppendRecord_td(const char *key_cp, const uint8_t *src_u8p, 
+                                    uint16_t length_u16, bool userWrite_bol)
+{
+    esp_err_t result_st = ESP_OK;
+    recordHeader_t header_st;
+    uint32_t size_u32 = ALIGN4(RECORD_HDR_SIZE + length_u16);
+    uint32_t offset_u32;
+    uint16_t required_u16 = (true == userWrite_bol) ? FREE_RESERVE : 1U;
+    uint16_t free_u16 = (uint16_t)(this_sst.sectors_u16 - this_sst.used_u16);
+
+    if(SECTOR_SIZE < (this_sst.headOffset_u32 + size_u32))
+    {
+        // every compaction reclaims one sector, at most one round through the log
+        for(uint16_t idx_u16 = 0U; 
+               (true == userWrite_bol) && (ESP_OK == result_st) 
+            && (idx_u16 < this_sst.sectors_u16) && (FREE_RESERVE > free_u16); idx_u16++)
+        {
+            result_st = CompactTail_td();
+            free_u16 = (uint16_t)(this_sst.sectors_u16 - this_sst.used_u16);
+        }
+
+        if((ESP_OK == result_st) && (required_u16 <= free_u16))
+        {
+            result_st = OpenNextSector_td();
+        }
+        else
+        {
+            ESP_LOGE(TAG, "log is full, record %s not written", key_cp);
+            result_st = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if(ESP_OK == result_st)
+    {
+        memset(&header_st, 0U, RECORD_HDR_SIZE);
+        header_st.seq_u32 = this_sst.recordSeq_u32;
+        header_st.length_u16 = length_u16;
+        strncpy(header_st.key_ca, key_cp, paramlog_MAX_KEY_LEN);
+        header_st.crc_u16 = RecordCrc_u16(header_st.key_ca, src_u8p, length_u16);
+
+        offset_u32 = (this_sst.head_u16 * SECTOR_SIZE) + this_sst.headOffset_u32;
+        // a power loss between both writes leaves a record with a bad crc
+        result_st = esp_partition_write(this_sst.part_stp, offset_u32, 
+                                        &header_st, RECORD_HDR_SIZE);
+        if(ESP_OK == result_st)
+        {
+            result_st = esp_partition_write(this_sst.part_stp, offset_u32 + RECORD_HDR_SIZE,
+                                            src_u8p, length_u16);
+        }
+
+        if(ESP_OK == result_st)
+        {
+            (void)UpdateIndex_stp(header_st.key_ca, offset_u32, header_st.seq_u32, 
+                                    length_u16);
+            this_sst.recordSeq_u32++;
+            this_sst.headOffset_u32 += size_u32;
+            this_sst.stats_st.flashBytes_u32 += RECORD_HDR_SIZE + length_u16;
+        }
+        else
+        {
+            // the rest of the sector is not trusted any more
+            ESP_LOGE(TAG, "write to log partition failed: %d", result_st);
+            this_sst.headOffset_u32 = SECTOR_SIZE;
+        }
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Takes the next free sector as head sector
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    result of the flash write
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t OpenNextSector_td(void)
+{
+    esp_err_t result_st = ESP_OK;
+    sectorHeader_t header_st;
+    uint16_t next_u16 = (this_sst.head_u16 + 1U) % this_sst.sectors_u16;
+
+    // free sectors are erased by the compaction, only a dirty one is erased here
+    if(   (ESP_OK != esp_partition_read(this_sst.part_stp, next_u16 * SECTOR_SIZE,
+                                        &header_st, SECTOR_HDR_SIZE))
+       || (ERASED_U32 != header_st.magic_u32) || (ERASED_U32 != header_st.seq_u32))
+    {
+        result_st = EraseSector_td(next_u16);
+    }
+
+    // the magic is written after the sequence, a torn header is never taken as head
+    if(ESP_OK == result_st)
+    {
+        header_st.magic_u32 = SECTOR_MAGIC;
+        header_st.seq_u32 = this_sst.sectorSeq_u32;
+        result_st = esp_partition_write(this_sst.part_stp,
+                                        (next_u16 * SECTOR_SIZE) + sizeof(uint32_t),
+                                        &header_st.seq_u32, sizeof(uint32_t));
+    }
+    if(ESP_OK == result_st)
+    {
+        result_st = esp_partition_write(this_sst.part_stp, next_u16 * SECTOR_SIZE,
+                                        &header_st.magic_u32, sizeof(uint32_t));
+    }
+
+    if(ESP_OK == result_st)
+    {
+        if(0U == this_sst.used_u16)
+        {
+            this_sst.tail_u16 = next_u16;
+        }
+        this_sst.head_u16 = next_u16;
+        this_sst.used_u16++;
+        this_sst.sectorSeq_u32++;
+        this_sst.headOffset_u32 = SECTOR_HDR_SIZE;
+        this_sst.stats_st.flashBytes_u32 += SECTOR_HDR_SIZE;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Copies the live records of the oldest sector to the head and erases it
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the sector was reclaimed
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t CompactTail_td(void)
+{
+    esp_err_t result_st = ESP_OK;
+    indexEntry_t *entry_stp;
+    uint32_t base_u32 = this_sst.tail_u16 * SECTOR_SIZE;
+
+    for(uint16_t idx_u16 = 0U; (ESP_OK == result_st) && (idx_u16 < this_sst.keys_u16); 
+        idx_u16++)
+    {
+        entry_stp = &this_sst.index_sta[idx_u16];
+        if(   (base_u32 <= entry_stp->offset_u32) 
+           && ((base_u32 + SECTOR_SIZE) > entry_stp->offset_u32))
+        {
+            result_st = esp_partition_read(this_sst.part_stp, 
+                                            entry_stp->offset_u32 + RECORD_HDR_SIZE,
+                                            this_sst.buf_u8a, entry_stp->length_u16);
+            if(ESP_OK == result_st)
+            {
+                result_st = AppendRecord_td(entry_stp->key_ca, this_sst.buf_u8a, 
+                                            entry_stp->length_u16, false);
+                this_sst.stats_st.relocated_u32++;
+            }
+        }
+    }
+
+    if(ESP_OK == result_st)
+    {
+        result_st = EraseSector_td(this_sst.tail_u16);
+    }
+
+    if(ESP_OK == result_st)
+    {
+        this_sst.tail_u16 = (this_sst.tail_u16 + 1U) % this_sst.sectors_u16;
+        this_sst.used_u16--;
+        this_sst.stats_st.compactions_u32++;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Erases one sector of the log partition
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     sector_u16        sector to be erased
+ * @return    result of the flash erase
+*//*-----------------------------------------------------------------------------------*/
+static esp_err_t EraseSector_td(uint16_t sector_u16)
+{
+    this_sst.stats_st.erases_u32++;
+    return(esp_partition_erase_range(this_sst.part_stp, sector_u16 * SECTOR_SIZE, 
+                                        SECTOR_SIZE));
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Calculates the crc of a record over the key and the data
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     key_cp            key of the record, padded with zeros to the key size
+ * @param     data_u8p          data of the record
+ * @param     length_u16        length of the data
+ * @return    crc16 of the record
+*//*-----------------------------------------------------------------------------------*/
+static uint16_t RecordCrc_u16(const char *key_cp, const uint8_t *data_u8p, 
+                                uint16_t length_u16)
+{
+    return(crc16_le(crc16_le(0U, (const uint8_t *)key_cp, KEY_SIZE), data_u8p, length_u16));
+}
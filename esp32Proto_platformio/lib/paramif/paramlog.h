@@ -0,0 +1,131 @@
+/*****************************************************************************************
+* FILENAME :        paramlog.h
+*
+* DESCRIPTION :
+*       Header file for the append only parameter log on a dedicated flash partition
+*
+* Date: 17. October 2026
+*
+* NOTES :
+*
+* Copyright (c) [2019] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*****************************************************************************************/
+#ifndef PARAMLOG_H
+#define PARAMLOG_H
+/****************************************************************************************/
+/* Imported header files: */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "stddef.h"
+#include "esp_err.h"
+
+/****************************************************************************************/
+/* Global constant defines: */
+#define paramlog_PARTITION_LABEL    "paramlog"  // optional log partition
+#define paramlog_PARTITION_SUBTYPE  0x41
+#define paramlog_MAX_KEY_LEN        15U         // same limit as the nvs keys
+#define paramlog_MAX_DATA_LEN       256U        // maximum length of one record
+
+/****************************************************************************************/
+/* Global function like macro defines (to be avoided): */
+
+/****************************************************************************************/
+/* Global type definitions (enum (en), struct (st), union (un), typedef (tx): */
+
+typedef struct paramlog_stats_tag
+{
+    uint32_t appends_u32;       /*!< records written on request of the user */
+    uint32_t userBytes_u32;     /*!< data bytes written on request of the user */
+    uint32_t flashBytes_u32;    /*!< bytes written to flash incl. headers and copies */
+    uint32_t relocated_u32;     /*!< live records copied by the compaction */
+    uint32_t compactions_u32;   /*!< sectors reclaimed by the compaction */
+    uint32_t erases_u32;        /*!< sector erases */
+}paramlog_stats_t;
+
+/****************************************************************************************/
+/* Global function definitions: */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Initialization of the parameter log. The partition is scanned once and
+ *              the ram index of the newest record per key is built. The log is not
+ *              thread safe, it is used by paramif under its pool mutex.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_ERR_NOT_FOUND if the partition is not available, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramlog_Initialize_td(void);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Check if the log partition is available
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    true if the log is usable
+*//*-----------------------------------------------------------------------------------*/
+extern bool paramlog_IsAvailable_bol(void);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Reads the newest record of a key
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     key_cp            key of the record
+ * @param     dest_u8p          destination of the data
+ * @param     length_stp        in: size of the destination, out: length of the record
+ * @return    ESP_ERR_NOT_FOUND if the key is not stored, ESP_ERR_INVALID_SIZE if the
+ *              destination is too small, else ESP_OK
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramlog_Read_td(const char *key_cp, uint8_t *dest_u8p, 
+                                    size_t *length_stp);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Appends a new record of a key, the older records of the key become garbage
+ *              and are removed by the compaction of their sector
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     key_cp            key of the record
+ * @param     src_u8p           data of the record
+ * @param     length_u16        length of the data
+ * @return    ESP_ERR_NO_MEM if the log is full, ESP_OK if the record was written
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramlog_Write_td(const char *key_cp, const uint8_t *src_u8p, 
+                                    uint16_t length_u16);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Erases the complete log partition
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the partition was erased
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t paramlog_EraseAll_td(void);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the counters of the parameter log
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stats_stp         destination of the counters
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+extern void paramlog_GetStats_vd(paramlog_stats_t *stats_stp);
+
+/****************************************************************************************/
+/* Global data definitions: */
+
+#endif
@@ -0,0 +1,296 @@
+/*****************************************************************************************
+* FILENAME :        sampleBuf.c
+*
+* DESCRIPTION :
+*       Bounded buffer for sensor samples which could not be published. The newest
+*       records are kept in a ram ring, older records are moved to an optional flash
+*       partition which is also used as ring. The content of the spill partition is
+*       not recovered after a reboot.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* PUBLIC FUNCTIONS :
+*
+* Copyright (c) [2017] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "sampleBuf.h"
+
+#include "string.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define MODULE_TAG              "sampleBuf"
+
+#define RAM_RECORDS             64U         // records held in ram
+#define FLASH_SECTOR_SIZE       4096U       // erase unit of the spill partition
+#define RECORD_SIZE             sizeof(sampleBuf_record_t)
+#define RECORDS_PER_SECTOR      (FLASH_SECTOR_SIZE / RECORD_SIZE)
+
+/****************************************************************************************/
+/* Local function like makros */
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+typedef struct ringIdx_tag
+{
+    uint32_t head_u32;          // next record to be written
+    uint32_t tail_u32;          // oldest record
+    uint32_t count_u32;         // number of records
+    uint32_t capacity_u32;      // maximum number of records
+}ringIdx_t;
+
+typedef struct objectData_tag
+{
+    sampleBuf_record_t ram_sta[RAM_RECORDS];
+    ringIdx_t ramIdx_st;
+    const esp_partition_t *part_stp;
+    ringIdx_t flashIdx_st;
+    sampleBuf_stats_t stats_st;
+}objectData_t;
+
+/****************************************************************************************/
+/* Local functions prototypes: */
+static bool SpillRecord_bol(const sampleBuf_record_t *rec_cstp);
+static bool ReadSpilledRecord_bol(sampleBuf_record_t *rec_stp);
+
+/****************************************************************************************/
+/* Local variables: */
+
+static const char *TAG = MODULE_TAG;
+
+static objectData_t this_sst;
+
+/****************************************************************************************/
+/* Global functions (unlimited visibility) */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Initialization of the sample buffer
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t sampleBuf_Initialize_td(void)
+{
+    memset(&this_sst, 0U, sizeof(this_sst));
+    this_sst.ramIdx_st.capacity_u32 = RAM_RECORDS;
+
+    this_sst.part_stp = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                        (esp_partition_subtype_t)sampleBuf_PARTITION_SUBTYPE,
+                                        sampleBuf_PARTITION_LABEL);
+    if(NULL != this_sst.part_stp)
+    {
+        // only complete sectors are used, a sector is erased when the ring enters it
+        this_sst.flashIdx_st.capacity_u32 = (this_sst.part_stp->size / FLASH_SECTOR_SIZE)
+                                                * RECORDS_PER_SECTOR;
+        ESP_LOGI(TAG, "spill partition found, capacity: %d records",
+                    this_sst.flashIdx_st.capacity_u32);
+    }
+    else
+    {
+        ESP_LOGI(TAG, "no spill partition, ram capacity: %d records", RAM_RECORDS);
+    }
+
+    return(ESP_OK);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Stores a sample record, if the buffer is full the oldest record is dropped
+*//*-----------------------------------------------------------------------------------*/
+esp_err_t sampleBuf_Push_td(const sampleBuf_record_t *rec_cstp)
+{
+    esp_err_t result_st = ESP_FAIL;
+    ringIdx_t *ram_stp = &this_sst.ramIdx_st;
+
+    if(NULL != rec_cstp)
+    {
+        if(ram_stp->capacity_u32 == ram_stp->count_u32)
+        {
+            // ram is full, move the oldest ram record to flash or drop it
+            if(false == SpillRecord_bol(&this_sst.ram_sta[ram_stp->tail_u32]))
+            {
+                this_sst.stats_st.dropped_u32++;
+            }
+            ram_stp->tail_u32 = (ram_stp->tail_u32 + 1U) % ram_stp->capacity_u32;
+            ram_stp->count_u32--;
+        }
+
+        memcpy(&this_sst.ram_sta[ram_stp->head_u32], rec_cstp, RECORD_SIZE);
+        ram_stp->head_u32 = (ram_stp->head_u32 + 1U) % ram_stp->capacity_u32;
+        ram_stp->count_u32++;
+        this_sst.stats_st.stored_u32++;
+        result_st = ESP_OK;
+    }
+    return(result_st);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Takes the oldest record out of the buffer
+*//*-----------------------------------------------------------------------------------*/
+bool sampleBuf_Pop_bol(sampleBuf_record_t *rec_stp)
+{
+    bool available_bol = false;
+    ringIdx_t *ram_stp = &this_sst.ramIdx_st;
+
+    if(NULL != rec_stp)
+    {
+        // spilled records are always older than the records in ram
+        available_bol = ReadSpilledRecord_bol(rec_stp);
+
+        if((false == available_bol) && (0U < ram_stp->count_u32))
+        {
+            memcpy(rec_stp, &this_sst.ram_sta[ram_stp->tail_u32], RECORD_SIZE);
+            ram_stp->tail_u32 = (ram_stp->tail_u32 + 1U) % ram_stp->capacity_u32;
+            ram_stp->count_u32--;
+            available_bol = true;
+        }
+
+        if(true == available_bol)
+        {
+            this_sst.stats_st.replayed_u32++;
+        }
+    }
+    return(available_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the number of records in the buffer
+*//*-----------------------------------------------------------------------------------*/
+uint32_t sampleBuf_GetCount_u32(void)
+{
+    return(this_sst.ramIdx_st.count_u32 + this_sst.flashIdx_st.count_u32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the maximum number of records the buffer can hold
+*//*-----------------------------------------------------------------------------------*/
+uint32_t sampleBuf_GetCapacity_u32(void)
+{
+    return(this_sst.ramIdx_st.capacity_u32 + this_sst.flashIdx_st.capacity_u32);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the counters of the sample buffer
+*//*-----------------------------------------------------------------------------------*/
+void sampleBuf_GetStats_vd(sampleBuf_stats_t *stats_stp)
+{
+    if(NULL != stats_stp)
+    {
+        memcpy(stats_stp, &this_sst.stats_st, sizeof(sampleBuf_stats_t));
+    }
+}
+
+/****************************************************************************************/
+/* Local functions: */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Writes a record to the spill partition. When the ring enters a new sector
+ *              the sector is erased, records of the ring tail in this sector are lost.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     rec_cstp          record to be written
+ * @return    true if the record was written to flash
+*//*-----------------------------------------------------------------------------------*/
+static bool SpillRecord_bol(const sampleBuf_record_t *rec_cstp)
+{
+    bool written_bol = false;
+    ringIdx_t *flash_stp = &this_sst.flashIdx_st;
+    uint32_t lost_u32;
+    esp_err_t result_st = ESP_OK;
+
+    if((NULL != this_sst.part_stp) && (0U < flash_stp->capacity_u32))
+    {
+        if(0U == (flash_stp->head_u32 % RECORDS_PER_SECTOR))
+        {
+            if(   (0U < flash_stp->count_u32)
+               && ((flash_stp->tail_u32 / RECORDS_PER_SECTOR)
+                        == (flash_stp->head_u32 / RECORDS_PER_SECTOR)))
+            {
+                // the ring tail is located in the sector to be erased
+                lost_u32 = RECORDS_PER_SECTOR - (flash_stp->tail_u32 % RECORDS_PER_SECTOR);
+                lost_u32 = (lost_u32 < flash_stp->count_u32) ?
+                                lost_u32 : flash_stp->count_u32;
+                flash_stp->tail_u32 = (flash_stp->tail_u32 + lost_u32)
+                                        % flash_stp->capacity_u32;
+                flash_stp->count_u32 -= lost_u32;
+                this_sst.stats_st.dropped_u32 += lost_u32;
+            }
+
+            result_st = esp_partition_erase_range(this_sst.part_stp,
+                                                    flash_stp->head_u32 * RECORD_SIZE,
+                                                    FLASH_SECTOR_SIZE);
+        }
+
+        if(ESP_OK == result_st)
+        {
+            result_st = esp_partition_write(this_sst.part_stp, 
+                                            flash_stp->head_u32 * RECORD_SIZE,
+                                            rec_cstp, RECORD_SIZE);
+        }
+
+        if(ESP_OK == result_st)
+        {
+            flash_stp->head_u32 = (flash_stp->head_u32 + 1U) % flash_stp->capacity_u32;
+            flash_stp->count_u32++;
+            this_sst.stats_st.spilled_u32++;
+            written_bol = true;
+        }
+        else
+        {
+            ESP_LOGE(TAG, "write to spill partition failed: %d", result_st);
+        }
+    }
+    return(written_bol);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Reads the oldest record of the spill partition and removes it from the ring
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     rec_stp           destination of the record
+ * @return    true if a record was read
+*//*-----------------------------------------------------------------------------------*/
+static bool ReadSpilledRecord_bol(sampleBuf_record_t *rec_stp)
+{
+    bool read_bol = false;
+    ringIdx_t *flash_stp = &this_sst.flashIdx_st;
+
+    while((false == read_bol) && (0U < flash_stp->count_u32))
+    {
+        read_bol = (ESP_OK == esp_partition_read(this_sst.part_stp,
+                                                    flash_stp->tail_u32 * RECORD_SIZE,
+                                                    rec_stp, RECORD_SIZE));
+        if(false == read_bol)
+        {
+            ESP_LOGE(TAG, "read from spill partition failed...");
+            this_sst.stats_st.dropped_u32++;
+        }
+        flash_stp->tail_u32 = (flash_stp->tail_u32 + 1U) % flash_stp->capacity_u32;
+        flash_stp->count_u32--;
+    }
+    return(read_bol);
+}
@@ -0,0 +1,129 @@
+/*****************************************************************************************
+* FILENAME :        sampleBuf.h
+*
+* DESCRIPTION :
+*       Header file for the offline sensor sample buffer
+*
+* Date: 17. October 2026
+*
+* NOTES :
+*
+* Copyright (c) [2019] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*****************************************************************************************/
+#ifndef SAMPLEBUF_H
+#define SAMPLEBUF_H
+/****************************************************************************************/
+/* Imported header files: */
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "esp_err.h"
+
+/****************************************************************************************/
+/* Global constant defines: */
+#define sampleBuf_PARTITION_LABEL   "offbuf"    // optional spill partition
+#define sampleBuf_PARTITION_SUBTYPE 0x40
+
+/****************************************************************************************/
+/* Global function like macro defines (to be avoided): */
+
+/****************************************************************************************/
+/* Global type definitions (enum (en), struct (st), union (un), typedef (tx): */
+
+/* binary record format, used in ram and in the spill partition (16 bytes) */
+typedef struct sampleBuf_record_tag
+{
+    uint32_t time_u32;          /*!< seconds since boot when the sample was taken */
+    int16_t temp_s16;           /*!< temperature in 0.1 degree celsius */
+    uint16_t hum_u16;           /*!< humidity in 0.1 percent */
+    uint8_t macAddr_u8a[6];     /*!< mac address of the sensor, slots can be reused */
+    uint8_t batt_u8;            /*!< battery level in percent */
+    uint8_t msgCnt_u8;          /*!< message counter of the sensor advertisement */
+}sampleBuf_record_t;
+
+typedef struct sampleBuf_stats_tag
+{
+    uint32_t stored_u32;        /*!< records stored in the buffer */
+    uint32_t spilled_u32;       /*!< records moved from ram to the spill partition */
+    uint32_t replayed_u32;      /*!< records taken out of the buffer */
+    uint32_t dropped_u32;       /*!< oldest records overwritten because of overflow */
+}sampleBuf_stats_t;
+
+/****************************************************************************************/
+/* Global function definitions: */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Initialization of the sample buffer. If the spill partition is available
+ *              records which do not fit into ram are moved to flash. The buffer is not
+ *              thread safe and has to be used by one task only.
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    ESP_OK if the buffer is usable
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t sampleBuf_Initialize_td(void);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Stores a sample record, if the buffer is full the oldest record is dropped
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     rec_cstp          record to be stored
+ * @return    ESP_OK if the record was stored
+*//*-----------------------------------------------------------------------------------*/
+extern esp_err_t sampleBuf_Push_td(const sampleBuf_record_t *rec_cstp);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Takes the oldest record out of the buffer
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     rec_stp           destination of the record
+ * @return    true if a record was available
+*//*-----------------------------------------------------------------------------------*/
+extern bool sampleBuf_Pop_bol(sampleBuf_record_t *rec_stp);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the number of records in the buffer
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    number of records
+*//*-----------------------------------------------------------------------------------*/
+extern uint32_t sampleBuf_GetCount_u32(void);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the maximum number of records the buffer can hold
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @return    capacity in records
+*//*-----------------------------------------------------------------------------------*/
+extern uint32_t sampleBuf_GetCapacity_u32(void);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the counters of the sample buffer
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     stats_stp         destination of the counters
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+extern void sampleBuf_GetStats_vd(sampleBuf_stats_t *stats_stp);
+
+/****************************************************************************************/
+/* Global data definitions: */
+
+#endif
@@ -0,0 +1,361 @@
+/*****************************************************************************************
+* FILENAME :        sensHist.c
+*
+* DESCRIPTION :
+*       History of the temperature and humidity values of a sensor. The samples are
+*       kept in a byte ring, each sample is coded as the difference to the previous
+*       sample: time difference, temperature difference and humidity difference, each
+*       as zigzag coded varint (7 bits per byte, bit 7 set if another byte follows).
+*       Typical samples need 3 bytes. The values of the sample before the oldest one
+*       are kept as reference, it is moved forward when the oldest sample is dropped.
+*       The minimum, maximum, sum and count of the 1 min, 15 min and 1 h windows are
+*       updated with every sample in constant time.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* PUBLIC FUNCTIONS :
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "sensHist.h"
+
+#include "string.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define VARINT_MAX_BYTES        5U      // 32 bit value
+#define FIELDS_PER_SAMPLE       (1U + sensHist_CH_NUM)
+#define SAMPLE_MAX_BYTES        (FIELDS_PER_SAMPLE * VARINT_MAX_BYTES)
+#define VARINT_MORE             0x80U
+#define VARINT_MASK             0x7FU
+
+/****************************************************************************************/
+/* Local function like makros */
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/****************************************************************************************/
+/* Local functions prototypes: */
+static uint8_t EncodeVarint_u8(uint32_t value_u32, uint8_t *dest_u8p);
+static uint8_t DecodeSample_u8(const sensHist_series_t *series_cstp, uint16_t pos_u16,
+                                    sensHist_sample_t *sample_stp);
+static void DropOldest_vd(sensHist_series_t *series_stp);
+static void UpdateWindows_vd(sensHist_series_t *series_stp, 
+                                    const sensHist_sample_t *sample_cstp);
+static uint32_t ZigZag_u32(int32_t value_s32);
+static int32_t UnZigZag_s32(uint32_t value_u32);
+
+/****************************************************************************************/
+/* Local variables: */
+
+static const uint32_t windowLength_scu32a[sensHist_WIN_NUM] = {60U, 900U, 3600U};
+
+/****************************************************************************************/
+/* Global functions (unlimited visibility) */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Adds a sample to the history and updates the aggregates of all windows
+*//*-----------------------------------------------------------------------------------*/
+void sensHist_AddSample_vd(sensHist_series_t *series_stp, 
+                            const sensHist_sample_t *sample_cstp)
+{
+    uint8_t code_u8a[SAMPLE_MAX_BYTES];
+    uint8_t len_u8;
+
+    if((NULL != series_stp) && (NULL != sample_cstp))
+    {
+        if(false == series_stp->valid_bol)
+        {
+            memcpy(&series_stp->last_st, sample_cstp, sizeof(sensHist_sample_t));
+            series_stp->valid_bol = true;
+        }
+        if(0U == series_stp->samples_u16)
+        {
+            memcpy(&series_stp->base_st, &series_stp->last_st, sizeof(sensHist_sample_t));
+        }
+
+        len_u8 = EncodeVarint_u8(sample_cstp->time_u32 - series_stp->last_st.time_u32,
+                                    &code_u8a[0]);
+        for(uint8_t ch_u8 = 0U; ch_u8 < sensHist_CH_NUM; ch_u8++)
+        {
+            len_u8 += EncodeVarint_u8(ZigZag_u32((int32_t)sample_cstp->value_s16a[ch_u8] 
+                                            - series_stp->last_st.value_s16a[ch_u8]),
+                                        &code_u8a[len_u8]);
+        }
+
+        while((sensHist_RING_BYTES - series_stp->used_u16) < len_u8)
+        {
+            DropOldest_vd(series_stp);
+        }
+
+        for(uint8_t idx_u8 = 0U; idx_u8 < len_u8; idx_u8++)
+        {
+            series_stp->ring_u8a[series_stp->head_u16] = code_u8a[idx_u8];
+            series_stp->head_u16 = (series_stp->head_u16 + 1U) % sensHist_RING_BYTES;
+        }
+        series_stp->used_u16 += len_u8;
+        series_stp->samples_u16++;
+        memcpy(&series_stp->last_st, sample_cstp, sizeof(sensHist_sample_t));
+
+        UpdateWindows_vd(series_stp, sample_cstp);
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Closes the windows which ended before the given time
+*//*-----------------------------------------------------------------------------------*/
+void sensHist_CloseWindows_vd(sensHist_series_t *series_stp, uint32_t now_u32)
+{
+    sensHist_aggregate_t *open_stp;
+
+    if(NULL != series_stp)
+    {
+        for(uint8_t win_u8 = 0U; win_u8 < sensHist_WIN_NUM; win_u8++)
+        {
+            open_stp = &series_stp->open_sta[win_u8];
+            if(   (0U < open_stp->count_u32)
+               && ((now_u32 - open_stp->start_u32) >= windowLength_scu32a[win_u8]))
+            {
+                memcpy(&series_stp->closed_sta[win_u8], open_stp, 
+                        sizeof(sensHist_aggregate_t));
+                memset(open_stp, 0U, sizeof(sensHist_aggregate_t));
+            }
+        }
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the aggregates of the last complete window
+*//*-----------------------------------------------------------------------------------*/
+const sensHist_aggregate_t * sensHist_GetAggregate_cstp(
+                                    const sensHist_series_t *series_cstp,
+                                    sensHist_window_t win_en)
+{
+    const sensHist_aggregate_t *agg_cstp = NULL;
+
+    if((NULL != series_cstp) && (sensHist_WIN_NUM > win_en))
+    {
+        agg_cstp = &series_cstp->closed_sta[win_en];
+    }
+    return(agg_cstp);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the length of a window
+*//*-----------------------------------------------------------------------------------*/
+uint32_t sensHist_GetWindowLength_u32(sensHist_window_t win_en)
+{
+    return((sensHist_WIN_NUM > win_en) ? windowLength_scu32a[win_en] : 0U);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Starts reading the samples of a series, oldest sample first
+*//*-----------------------------------------------------------------------------------*/
+void sensHist_IterStart_vd(const sensHist_series_t *series_cstp, sensHist_iter_t *iter_stp)
+{
+    if((NULL != series_cstp) && (NULL != iter_stp))
+    {
+        iter_stp->pos_u16 = series_cstp->tail_u16;
+        iter_stp->remaining_u16 = series_cstp->samples_u16;
+        memcpy(&iter_stp->sample_st, &series_cstp->base_st, sizeof(sensHist_sample_t));
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Reads the next sample of a series
+*//*-----------------------------------------------------------------------------------*/
+bool sensHist_IterNext_bol(const sensHist_series_t *series_cstp, sensHist_iter_t *iter_stp)
+{
+    bool read_bol = false;
+    uint8_t len_u8;
+
+    if((NULL != series_cstp) && (NULL != iter_stp) && (0U < iter_stp->remaining_u16))
+    {
+        len_u8 = DecodeSample_u8(series_cstp, iter_stp->pos_u16, &iter_stp->sample_st);
+        iter_stp->pos_u16 = (iter_stp->pos_u16 + len_u8) % sensHist_RING_BYTES;
+        iter_stp->remaining_u16--;
+        read_bol = true;
+    }
+    return(read_bol);
+}
+
+/****************************************************************************************/
+/* Local functions: */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Writes a value as varint
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     value_u32         value to be coded
+ * @param     dest_u8p          destination, VARINT_MAX_BYTES bytes
+ * @return    number of bytes written
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t EncodeVarint_u8(uint32_t value_u32, uint8_t *dest_u8p)
+{
+    uint8_t len_u8 = 0U;
+
+    while(VARINT_MASK < value_u32)
+    {
+        dest_u8p[len_u8] = (uint8_t)(value_u32 & VARINT_MASK) | VARINT_MORE;
+        value_u32 >>= 7U;
+        len_u8++;
+    }
+    dest_u8p[len_u8] = (uint8_t)value_u32;
+    len_u8++;
+
+    return(len_u8);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Decodes the sample at a ring position and applies the differences to the
+ *              previous sample
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     series_cstp       history of the sensor
+ * @param     pos_u16           ring position of the first byte of the sample
+ * @param     sample_stp        previous sample, replaced by the decoded sample
+ * @return    number of bytes of the sample
+*//*-----------------------------------------------------------------------------------*/
+static uint8_t DecodeSample_u8(const sensHist_series_t *series_cstp, uint16_t pos_u16,
+                                    sensHist_sample_t *sample_stp)
+{
+    uint8_t len_u8 = 0U;
+    uint32_t field_u32a[FIELDS_PER_SAMPLE];
+    uint8_t byte_u8;
+    uint8_t shift_u8;
+
+    for(uint8_t field_u8 = 0U; field_u8 < FIELDS_PER_SAMPLE; field_u8++)
+    {
+        field_u32a[field_u8] = 0U;
+        shift_u8 = 0U;
+        do
+        {
+            byte_u8 = series_cstp->ring_u8a[(pos_u16 + len_u8) % sensHist_RING_BYTES];
+            field_u32a[field_u8] |= (uint32_t)(byte_u8 & VARINT_MASK) << shift_u8;
+            shift_u8 += 7U;
+            len_u8++;
+        }while(0U != (byte_u8 & VARINT_MORE));
+    }
+
+    sample_stp->time_u32 += field_u32a[0];
+    for(uint8_t ch_u8 = 0U; ch_u8 < sensHist_CH_NUM; ch_u8++)
+    {
+        sample_stp->value_s16a[ch_u8] = (int16_t)(sample_stp->value_s16a[ch_u8] 
+                                                    + UnZigZag_s32(field_u32a[1U + ch_u8]));
+    }
+
+    return(len_u8);
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Drops the oldest sample, the reference moves to the dropped sample
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     series_stp        history of the sensor
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void DropOldest_vd(sensHist_series_t *series_stp)
+{
+    uint8_t len_u8;
+
+    len_u8 = DecodeSample_u8(series_stp, series_stp->tail_u16, &series_stp->base_st);
+    series_stp->tail_u16 = (series_stp->tail_u16 + len_u8) % sensHist_RING_BYTES;
+    series_stp->used_u16 -= len_u8;
+    series_stp->samples_u16--;
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Adds a sample to the open windows, a window is closed first if the sample 
+ *              belongs to a later window
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     series_stp        history of the sensor
+ * @param     sample_cstp       new sample
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+static void UpdateWindows_vd(sensHist_series_t *series_stp, 
+                                    const sensHist_sample_t *sample_cstp)
+{
+    sensHist_aggregate_t *open_stp;
+    uint32_t start_u32;
+    int16_t value_s16;
+
+    sensHist_CloseWindows_vd(series_stp, sample_cstp->time_u32);
+
+    for(uint8_t win_u8 = 0U; win_u8 < sensHist_WIN_NUM; win_u8++)
+    {
+        open_stp = &series_stp->open_sta[win_u8];
+        start_u32 = sample_cstp->time_u32 
+                        - (sample_cstp->time_u32 % windowLength_scu32a[win_u8]);
+        if(0U == open_stp->count_u32)
+        {
+            open_stp->start_u32 = start_u32;
+            for(uint8_t ch_u8 = 0U; ch_u8 < sensHist_CH_NUM; ch_u8++)
+            {
+                open_stp->min_s16a[ch_u8] = INT16_MAX;
+                open_stp->max_s16a[ch_u8] = INT16_MIN;
+                open_stp->sum_s32a[ch_u8] = 0;
+            }
+        }
+
+        for(uint8_t ch_u8 = 0U; ch_u8 < sensHist_CH_NUM; ch_u8++)
+        {
+            value_s16 = sample_cstp->value_s16a[ch_u8];
+            open_stp->min_s16a[ch_u8] = (value_s16 < open_stp->min_s16a[ch_u8]) ?
+                                            value_s16 : open_stp->min_s16a[ch_u8];
+            open_stp->max_s16a[ch_u8] = (value_s16 > open_stp->max_s16a[ch_u8]) ?
+                                            value_s16 : open_stp->max_s16a[ch_u8];
+            open_stp->sum_s32a[ch_u8] += value_s16;
+        }
+        open_stp->count_u32++;
+    }
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Maps a signed value to an unsigned value, small magnitudes stay small
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     value_s32         signed value
+ * @return    zigzag coded value
+*//*-----------------------------------------------------------------------------------*/
+static uint32_t ZigZag_u32(int32_t value_s32)
+{
+    return(((uint32_t)value_s32 << 1U) ^ (uint32_t)(value_s32 >> 31));
+}
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Reverts the zigzag coding
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     value_u32         zigzag coded value
+ * @return    signed value
+*//*-----------------------------------------------------------------------------------*/
+static int32_t UnZigZag_s32(uint32_t value_u32)
+{
+    return((int32_t)(value_u32 >> 1U) ^ -(int32_t)(value_u32 & 1U));
+}
@@ -0,0 +1,183 @@
+/*****************************************************************************************
+* FILENAME :        sensHist.h
+*
+* DESCRIPTION :
+*       Header file for the sensor value history with windowed aggregates
+*
+* Date: 17. October 2026
+*
+* NOTES :
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*****************************************************************************************/
+#ifndef SENSHIST_H
+#define SENSHIST_H
+/****************************************************************************************/
+/* Imported header files: */
+
+#include "stdint.h"
+#include "stdbool.h"
+
+/****************************************************************************************/
+/* Global constant defines: */
+#ifdef CONFIG_SENSHIST_RING_BYTES
+#define sensHist_RING_BYTES     CONFIG_SENSHIST_RING_BYTES
+#else
+#define sensHist_RING_BYTES     192U    // encoded samples per sensor, about 3 bytes each
+#endif
+
+/****************************************************************************************/
+/* Global function like macro defines (to be avoided): */
+
+/****************************************************************************************/
+/* Global type definitions (enum (en), struct (st), union (un), typedef (tx): */
+
+typedef enum sensHist_window_tag
+{
+    sensHist_WIN_1MIN       = 0,
+    sensHist_WIN_15MIN      = 1,
+    sensHist_WIN_1H         = 2,
+    sensHist_WIN_NUM
+}sensHist_window_t;
+
+typedef enum sensHist_channel_tag
+{
+    sensHist_CH_TEMP        = 0,    /*!< temperature in 0.1 degree celsius */
+    sensHist_CH_HUM         = 1,    /*!< humidity in 0.1 percent */
+    sensHist_CH_NUM
+}sensHist_channel_t;
+
+/* one sample of the history */
+typedef struct sensHist_sample_tag
+{
+    uint32_t time_u32;          /*!< seconds since boot */
+    int16_t value_s16a[sensHist_CH_NUM];
+}sensHist_sample_t;
+
+/* aggregates of one time window, the windows are aligned to multiples of their length */
+typedef struct sensHist_aggregate_tag
+{
+    uint32_t start_u32;         /*!< start of the window in seconds since boot */
+    uint32_t count_u32;         /*!< samples in the window, 0 if no window was closed */
+    int16_t min_s16a[sensHist_CH_NUM];
+    int16_t max_s16a[sensHist_CH_NUM];
+    int32_t sum_s32a[sensHist_CH_NUM];
+}sensHist_aggregate_t;
+
+/* history of one sensor, a zeroed structure is an empty history. The samples are 
+   stored as zigzag varint coded differences to the previous sample, the oldest 
+   samples are dropped if the ring is full. */
+typedef struct sensHist_series_tag
+{
+    uint8_t ring_u8a[sensHist_RING_BYTES];
+    uint16_t head_u16;          /*!< next byte to be written */
+    uint16_t tail_u16;          /*!< first byte of the oldest sample */
+    uint16_t used_u16;          /*!< bytes in use */
+    uint16_t samples_u16;       /*!< samples in the ring */
+    bool valid_bol;             /*!< at least one sample was added */
+    sensHist_sample_t base_st;  /*!< reference of the oldest sample in the ring */
+    sensHist_sample_t last_st;  /*!< newest sample */
+    sensHist_aggregate_t open_sta[sensHist_WIN_NUM];    /*!< windows in progress */
+    sensHist_aggregate_t closed_sta[sensHist_WIN_NUM];  /*!< last complete windows */
+}sensHist_series_t;
+
+/* read position of a series */
+typedef struct sensHist_iter_tag
+{
+    uint16_t pos_u16;
+    uint16_t remaining_u16;
+    sensHist_sample_t sample_st;
+}sensHist_iter_t;
+
+/****************************************************************************************/
+/* Global function definitions: */
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Adds a sample to the history and updates the aggregates of all windows, 
+ *              a window is closed with the first sample behind its end
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     series_stp        history of the sensor
+ * @param     sample_cstp       sample, the time must not be older than the last sample
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+extern void sensHist_AddSample_vd(sensHist_series_t *series_stp, 
+                                    const sensHist_sample_t *sample_cstp);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Closes the windows which ended before the given time, so the aggregates
+ *              are complete even if the sensor stopped sending
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     series_stp        history of the sensor
+ * @param     now_u32           current time in seconds since boot
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+extern void sensHist_CloseWindows_vd(sensHist_series_t *series_stp, uint32_t now_u32);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the aggregates of the last complete window
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     series_cstp       history of the sensor
+ * @param     win_en            window length
+ * @return    aggregates, count is 0 if no window was closed yet
+*//*-----------------------------------------------------------------------------------*/
+extern const sensHist_aggregate_t * sensHist_GetAggregate_cstp(
+                                    const sensHist_series_t *series_cstp,
+                                    sensHist_window_t win_en);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Get the length of a window
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     win_en            window
+ * @return    length of the window in seconds
+*//*-----------------------------------------------------------------------------------*/
+extern uint32_t sensHist_GetWindowLength_u32(sensHist_window_t win_en);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Starts reading the samples of a series, oldest sample first
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     series_cstp       history of the sensor
+ * @param     iter_stp          read position
+ * @return    n/a
+*//*-----------------------------------------------------------------------------------*/
+extern void sensHist_IterStart_vd(const sensHist_series_t *series_cstp, 
+                                    sensHist_iter_t *iter_stp);
+
+/**---------------------------------------------------------------------------------------
+ * @brief     Reads the next sample of a series into the sample of the read position, 
+ *              the series must not be modified while it is read
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     series_cstp       history of the sensor
+ * @param     iter_stp          read position
+ * @return    true if a sample was read
+*//*-----------------------------------------------------------------------------------*/
+extern bool sensHist_IterNext_bol(const sensHist_series_t *series_cstp, 
+                                    sensHist_iter_t *iter_stp);
+
+/****************************************************************************************/
+/* Global data definitions: */
+
+#endif
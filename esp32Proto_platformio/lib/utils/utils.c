@@ -72,6 +72,44 @@ char* utils_IntegerToDecString_chp(int32_t value_s32, char* buffer_chp)
     return itoa(value_s32, buffer_chp, 10);       // call the library function
 }
 
+/**---------------------------------------------------------------------------------------
+ * @brief     Copies a fixed point value to its decimal representation
+*//*-----------------------------------------------------------------------------------*/
+uint32_t utils_FixedPointToString_u32(int32_t value_s32, uint8_t decimals_u8,
+                                        char* buffer_chp)
+{
+    char digits_cha[12];
+    uint32_t digitCnt_u32 = 0U;
+    uint32_t length_u32 = 0U;
+    // unsigned magnitude, also valid for the most negative value
+    uint32_t value_u32 = (0 > value_s32) ? (0U - (uint32_t)value_s32) : (uint32_t)value_s32;
+
+    // collect the digits in reverse order, at least one digit before the point
+    do
+    {
+        digits_cha[digitCnt_u32++] = (char)('0' + (value_u32 % 10U));
+        value_u32 /= 10U;
+    }
+    while((0U != value_u32) || (digitCnt_u32 <= decimals_u8));
+
+    if(0 > value_s32)
+    {
+        buffer_chp[length_u32++] = '-';
+    }
+
+    while(0U < digitCnt_u32)
+    {
+        if(digitCnt_u32 == decimals_u8)
+        {
+            buffer_chp[length_u32++] = '.';
+        }
+        buffer_chp[length_u32++] = digits_cha[--digitCnt_u32];
+    }
+    buffer_chp[length_u32] = '\0';
+
+    return(length_u32);
+}
+
 /**---------------------------------------------------------------------------------------
  * @brief     Copies a RGB color code to a string
 *//*-----------------------------------------------------------------------------------*/
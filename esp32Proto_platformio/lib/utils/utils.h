@@ -72,6 +72,19 @@ extern char* utils_FloatToString_chp(float value_f32, char* buffer_chp);
 *//*-----------------------------------------------------------------------------------*/
 extern char* utils_IntegerToDecString_chp(int32_t value_s32, char* buffer_chp);
 
+/**---------------------------------------------------------------------------------------
+ * @brief     Copies a fixed point value to its decimal representation, e.g. the value
+ *              -206 with one decimal is converted to "-20.6"
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+ * @param     value_s32   value in units of 10^-decimals
+ * @param     decimals_u8 number of decimal places (0..9)
+ * @param     buffer_chp  pointer to result buffer string, at least 13 characters
+ * @return    length of the string without the terminating zero
+*//*-----------------------------------------------------------------------------------*/
+extern uint32_t utils_FixedPointToString_u32(int32_t value_s32, uint8_t decimals_u8,
+                                                char* buffer_chp);
+
 /**---------------------------------------------------------------------------------------
  * @brief     Copies a integer value to decimal representive in a character buffer
  * @author    winkste
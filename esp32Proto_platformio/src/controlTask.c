@@ -84,6 +84,7 @@ static void ServiceCbWifiDisconnected_vd(void);
 static void StartFullService_vd(void);
 static void StartSelfServicesOnly_vd(void);
 static void SocketErrorCb_vd(void);
+static void ParamFlushRequestCb_vd(void);
 
 static void InitializeParameterHandling_vd(void);
 static void StartupAndApplicationIdent_vd(void);
@@ -98,6 +99,7 @@ const int WIFI_AP_CLIENT    = BIT1;
 const int WIFI_DISCONN      = BIT2;
 const int SOCKET_ERROR      = BIT3;
 const int SYSTEM_REBOOT     = BIT4;
+const int PARAM_FLUSH       = BIT5;
 
 
 static EventGroupHandle_t controlEventGroup_sts;
@@ -140,6 +142,9 @@ esp_err_t controlTask_StartSystem_td(void)
 
     CHECK_EXE(logcfg_Configure_st(logcfg_DEVICES));
 
+    /* setup event group for event receiving from other tasks and processes */
+    controlEventGroup_sts = xEventGroupCreate();
+
     InitializeParameterHandling_vd();
 
     /* initialize console object for message processing */
@@ -149,9 +154,6 @@ esp_err_t controlTask_StartSystem_td(void)
 
     StartupAndApplicationIdent_vd();
 
-    /* setup event group for event receiving from other tasks and processes */
-    controlEventGroup_sts = xEventGroupCreate();
-
     InitializeWifi_vd();
 
     InitializeBasicWifiServices_vd();
@@ -180,7 +182,7 @@ static void Task_vd(void *param_vdp)
 {
     EventBits_t uxBits_st;
     uint32_t bits_u32 = WIFI_STATION | WIFI_AP_CLIENT | WIFI_DISCONN |
-                        SOCKET_ERROR | SYSTEM_REBOOT;
+                        SOCKET_ERROR | SYSTEM_REBOOT | PARAM_FLUSH;
 
     ESP_LOGI(TAG, "controlTask started...");
     while(1)
@@ -210,9 +212,15 @@ static void Task_vd(void *param_vdp)
             ESP_LOGE(TAG, "SOCKET_ERROR received...");
         }
 
+        if(0 != (uxBits_st & PARAM_FLUSH))
+        {
+            CHECK_EXE(paramif_Flush_td());
+        }
+
         if(0 != (uxBits_st & SYSTEM_REBOOT))
         {
             vTaskDelay(5000 / portTICK_RATE_MS);
+            CHECK_EXE(paramif_Flush_td());
             esp_restart();
         }
     }
@@ -233,6 +241,7 @@ static void RegisterCommands_vd(void)
     };
 
     ESP_ERROR_CHECK(myConsole_CmdRegister_td(&rebootCommand_stc));
+    ESP_ERROR_CHECK(paramif_RegisterCommands_td());
 }
 
 /**---------------------------------------------------------------------------------------
@@ -336,6 +345,17 @@ static void SocketErrorCb_vd(void)
     xEventGroupSetBits(controlEventGroup_sts, SOCKET_ERROR);
 }
 
+/**---------------------------------------------------------------------------------------
+ * @brief     callback of the parameter module from the timer daemon, the changed
+ *            parameters are written by the control task
+ * @author    S. Wink
+ * @date      17. Oct. 2026
+*//*-----------------------------------------------------------------------------------*/
+static void ParamFlushRequestCb_vd(void)
+{
+    xEventGroupSetBits(controlEventGroup_sts, PARAM_FLUSH);
+}
+
 /**---------------------------------------------------------------------------------------
  * @brief     Initialize and configer the parameter handling
  * @author    S. Wink
@@ -346,6 +366,7 @@ static void InitializeParameterHandling_vd(void)
     paramif_param_t paramHdl_st;
 
     CHECK_EXE(paramif_InitializeParameter_td(&paramHdl_st));
+    paramHdl_st.flushRequest_fp = ParamFlushRequestCb_vd;
     CHECK_EXE(paramif_Initialize_td(&paramHdl_st));
 }
 
@@ -367,6 +388,8 @@ static void StartupAndApplicationIdent_vd(void)
     controlAllocParam_st.length_u16 = sizeof(ctrlData_t);
     controlAllocParam_st.defaults_u8p = (uint8_t *)&defaultControlData_stsc;
     controlAllocParam_st.nvsIdent_cp = CTRL_PARA_IDENT;
+    // the startup counter changes with every boot
+    controlAllocParam_st.backend_en = paramif_BACKEND_LOG;
     ctrlParaHdl_xp = paramif_Allocate_stp(&controlAllocParam_st);
 
     /* update startup counter in none volatile memory */
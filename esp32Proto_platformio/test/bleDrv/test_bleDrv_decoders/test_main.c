@@ -0,0 +1,430 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the advertisement decoders for the ATC1441 and pvvx custom
+*       firmware and for BTHome v2, and of the dispatch of the ble driver by AD type and
+*       uuid. The benchmark measures the dispatch with 1, 4 and 16 registered decoders.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+// room for the benchmark with 16 registered decoders
+#define bleDrv_MAX_DECODERS     16U
+
+#include "bleDrv.c"
+#include "atcProcl.h"
+#include "bthomeProcl.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define BENCH_ADVS          1000000U
+#define ADV_SIZE            31U
+#define FILLER_UUID         0x2000U     // uuids of the decoders which never match
+#define UNKNOWN_UUID        0x181BU
+#define COMPANY_ID          0x0499U
+
+/****************************************************************************************/
+/* Local variables: */
+
+static const uint8_t BDA_CU8A[mija_SIZE_MAC_ADDR] = {0xA4, 0xC1, 0x38, 0x11, 0x22, 0x33};
+
+/* ATC1441: mac, temperature 22.5 (be), humidity 58 %, battery 90 %, 3000 mV, counter */
+static const uint8_t ATC_CU8A[] =
+{
+    0xA4, 0xC1, 0x38, 0x11, 0x22, 0x33, 0x00, 0xE1, 0x3A, 0x5A, 0x0B, 0xB8, 0x07
+};
+
+/* pvvx: reversed mac, 22.34 and 58.12 % (le), 2950 mV, battery 85 %, counter, flags */
+static const uint8_t PVVX_CU8A[] =
+{
+    0x33, 0x22, 0x11, 0x38, 0xC1, 0xA4, 0xBA, 0x08, 0xB4, 0x16, 0x86, 0x0B, 0x55, 0x2A,
+    0x04
+};
+
+/* BTHome v2: packet id, battery 97 %, temperature 25.06, humidity 50.55 % */
+static const uint8_t BTHOME_CU8A[] =
+{
+    0x40, 0x00, 0x2A, 0x01, 0x61, 0x02, 0xCA, 0x09, 0x03, 0xBF, 0x13
+};
+
+static const bleDrv_decoder_t MIJA_DECODER_CST =
+{
+    "mija", bleDrv_AD_SERVICE_DATA, mija_SERVICE_UUID, mijaProcl_GetServiceFrameId_bol,
+    mijaProcl_DecodeServiceData_u8
+};
+static const bleDrv_decoder_t ATC_DECODER_CST =
+{
+    "atc", bleDrv_AD_SERVICE_DATA, atcProcl_SERVICE_UUID, atcProcl_GetFrameId_bol,
+    atcProcl_Decode_u8
+};
+static const bleDrv_decoder_t BTHOME_DECODER_CST =
+{
+    "bthome", bleDrv_AD_SERVICE_DATA, bthomeProcl_SERVICE_UUID, bthomeProcl_GetFrameId_bol,
+    bthomeProcl_Decode_u8
+};
+
+static bleDrv_decoder_t fillerDecoder_sta[bleDrv_MAX_DECODERS];
+static uint32_t manufacturerCalls_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static uint8_t NoSample_u8(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                            const uint8_t *bda_cu8p, mijaProcl_rawSample_t *out_stap,
+                            uint8_t maxOut_u8)
+{
+    return(0U);
+}
+
+static uint8_t ManufacturerSample_u8(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                        const uint8_t *bda_cu8p,
+                                        mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8)
+{
+    manufacturerCalls_u32s++;
+    memcpy(out_stap[0].macAddr_u8a, bda_cu8p, mija_SIZE_MAC_ADDR);
+    out_stap[0].dataType_u8 = mija_TYPE_BATTERY;
+    out_stap[0].value1_u16 = data_cu8p[0];
+    return(1U);
+}
+
+/* flags and one AD structure with the 16 bit uuid or company id in front of the data */
+static uint8_t BuildAdv_u8(uint8_t adType_u8, uint16_t id_u16, const uint8_t *data_cu8p,
+                            uint8_t dataLen_u8, uint8_t *adv_u8p)
+{
+    adv_u8p[0] = 0x02U;
+    adv_u8p[1] = 0x01U;
+    adv_u8p[2] = 0x06U;
+    adv_u8p[3] = (uint8_t)(dataLen_u8 + 3U);
+    adv_u8p[4] = adType_u8;
+    adv_u8p[5] = (uint8_t)id_u16;
+    adv_u8p[6] = (uint8_t)(id_u16 >> 8U);
+    memcpy(&adv_u8p[7], data_cu8p, dataLen_u8);
+    return((uint8_t)(7U + dataLen_u8));
+}
+
+/* fillers with uuids which never match in front, the decoder of the frame last */
+static void RegisterDecoders_vd(uint8_t num_u8, const bleDrv_decoder_t *last_cstp)
+{
+    singleton_sst.decoders_u8 = 0U;
+    for(uint8_t idx_u8 = 0U; (idx_u8 + 1U) < num_u8; idx_u8++)
+    {
+        fillerDecoder_sta[idx_u8].name_cp = "filler";
+        fillerDecoder_sta[idx_u8].adType_u8 = bleDrv_AD_SERVICE_DATA;
+        fillerDecoder_sta[idx_u8].id_u16 = FILLER_UUID + idx_u8;
+        fillerDecoder_sta[idx_u8].frameId_fp = NULL;
+        fillerDecoder_sta[idx_u8].decode_fp = NoSample_u8;
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_RegisterDecoder_st(&fillerDecoder_sta[idx_u8]));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_RegisterDecoder_st(last_cstp));
+}
+
+static void CheckSample_vd(const mijaProcl_rawSample_t *sample_cstp, uint8_t type_u8,
+                            int16_t value1_s16, uint16_t value2_u16, uint8_t msgCnt_u8)
+{
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(BDA_CU8A, sample_cstp->macAddr_u8a, mija_SIZE_MAC_ADDR);
+    TEST_ASSERT_EQUAL(type_u8, sample_cstp->dataType_u8);
+    TEST_ASSERT_EQUAL_INT16(value1_s16, (int16_t)sample_cstp->value1_u16);
+    TEST_ASSERT_EQUAL(value2_u16, sample_cstp->value2_u16);
+    TEST_ASSERT_EQUAL(msgCnt_u8, sample_cstp->msgCnt_u8);
+}
+
+static void BenchDispatch_vd(uint8_t num_u8)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t adv_u8a[ADV_SIZE];
+    uint8_t frame_u8a[sizeof(ATC_CU8A)];
+    uint8_t advLen_u8;
+    volatile uint32_t samples_u32 = 0U;
+    uint64_t startNs_u64;
+    char name_ca[48];
+
+    RegisterDecoders_vd(num_u8, &ATC_DECODER_CST);
+    memcpy(frame_u8a, ATC_CU8A, sizeof(ATC_CU8A));
+
+    // an advertisement without registered decoder, the pure dispatch cost
+    advLen_u8 = BuildAdv_u8(bleDrv_AD_SERVICE_DATA, UNKNOWN_UUID, frame_u8a,
+                            sizeof(frame_u8a), adv_u8a);
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_ADVS; idx_u32++)
+    {
+        samples_u32 += DecodeAdvertisement_u8(adv_u8a, advLen_u8, BDA_CU8A, sample_sta,
+                                                mija_MAX_OBJECTS);
+    }
+    snprintf(name_ca, sizeof(name_ca), "dispatch %2u decoders, no match", num_u8);
+    fake_Bench_vd(name_ca, BENCH_ADVS, fake_HostNs_u64() - startNs_u64);
+    TEST_ASSERT_EQUAL_UINT32(0U, samples_u32);
+
+    // the matching decoder is the last one, every frame is new and decoded
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_ADVS; idx_u32++)
+    {
+        frame_u8a[sizeof(frame_u8a) - 1U] = (uint8_t)idx_u32;
+        advLen_u8 = BuildAdv_u8(bleDrv_AD_SERVICE_DATA, atcProcl_SERVICE_UUID, frame_u8a,
+                                sizeof(frame_u8a), adv_u8a);
+        samples_u32 += DecodeAdvertisement_u8(adv_u8a, advLen_u8, BDA_CU8A, sample_sta,
+                                                mija_MAX_OBJECTS);
+    }
+    snprintf(name_ca, sizeof(name_ca), "dispatch %2u decoders, atc decoded", num_u8);
+    fake_Bench_vd(name_ca, BENCH_ADVS, fake_HostNs_u64() - startNs_u64);
+    TEST_ASSERT_EQUAL_UINT32(2U * BENCH_ADVS, samples_u32);
+}
+
+void setUp(void)
+{
+    memset(singleton_sst.filter_sta, 0, sizeof(singleton_sst.filter_sta));
+    singleton_sst.filterNext_u8 = 0U;
+    singleton_sst.decoders_u8 = 0U;
+    manufacturerCalls_u32s = 0U;
+    // a learned arrival needs a time stamp which is not 0
+    fake_AdvanceMs_vd(1000U);
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_AtcFrame(void)
+{
+    mijaProcl_rawSample_t sample_sta[2];
+    uint8_t frame_u8a[sizeof(ATC_CU8A)];
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+
+    TEST_ASSERT_TRUE(atcProcl_GetFrameId_bol(ATC_CU8A, sizeof(ATC_CU8A), NULL, mac_u8a,
+                                                &msgCnt_u8));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(BDA_CU8A, mac_u8a, mija_SIZE_MAC_ADDR);
+    TEST_ASSERT_EQUAL(0x07U, msgCnt_u8);
+
+    TEST_ASSERT_EQUAL(2U, atcProcl_Decode_u8(ATC_CU8A, sizeof(ATC_CU8A), NULL, sample_sta,
+                                                2U));
+    CheckSample_vd(&sample_sta[0], mija_TYPE_TEMPHUM, 225, 580U, 0x07U);
+    CheckSample_vd(&sample_sta[1], mija_TYPE_BATTERY, 90, 0U, 0x07U);
+
+    // below zero in big endian
+    memcpy(frame_u8a, ATC_CU8A, sizeof(ATC_CU8A));
+    frame_u8a[6] = 0xFFU;
+    frame_u8a[7] = 0xCBU;
+    TEST_ASSERT_EQUAL(2U, atcProcl_Decode_u8(frame_u8a, sizeof(frame_u8a), NULL,
+                                                sample_sta, 2U));
+    TEST_ASSERT_EQUAL_INT16(-53, (int16_t)sample_sta[0].value1_u16);
+}
+
+static void test_PvvxFrame(void)
+{
+    mijaProcl_rawSample_t sample_sta[2];
+    uint8_t frame_u8a[sizeof(PVVX_CU8A)];
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+
+    // the address is sent in reversed order
+    TEST_ASSERT_TRUE(atcProcl_GetFrameId_bol(PVVX_CU8A, sizeof(PVVX_CU8A), NULL, mac_u8a,
+                                                &msgCnt_u8));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(BDA_CU8A, mac_u8a, mija_SIZE_MAC_ADDR);
+    TEST_ASSERT_EQUAL(0x2AU, msgCnt_u8);
+
+    // 0.01 units are reduced to 0.1
+    TEST_ASSERT_EQUAL(2U, atcProcl_Decode_u8(PVVX_CU8A, sizeof(PVVX_CU8A), NULL,
+                                                sample_sta, 2U));
+    CheckSample_vd(&sample_sta[0], mija_TYPE_TEMPHUM, 223, 581U, 0x2AU);
+    CheckSample_vd(&sample_sta[1], mija_TYPE_BATTERY, 85, 0U, 0x2AU);
+
+    // -12.34 in little endian
+    memcpy(frame_u8a, PVVX_CU8A, sizeof(PVVX_CU8A));
+    frame_u8a[6] = 0x2EU;
+    frame_u8a[7] = 0xFBU;
+    TEST_ASSERT_EQUAL(2U, atcProcl_Decode_u8(frame_u8a, sizeof(frame_u8a), NULL,
+                                                sample_sta, 2U));
+    TEST_ASSERT_EQUAL_INT16(-123, (int16_t)sample_sta[0].value1_u16);
+}
+
+static void test_AtcRejectsOtherFrames(void)
+{
+    mijaProcl_rawSample_t sample_sta[2];
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+
+    // the firmware is known by the length only
+    TEST_ASSERT_FALSE(atcProcl_GetFrameId_bol(ATC_CU8A, sizeof(ATC_CU8A) - 1U, NULL,
+                                                mac_u8a, &msgCnt_u8));
+    TEST_ASSERT_FALSE(atcProcl_GetFrameId_bol(PVVX_CU8A, sizeof(PVVX_CU8A) + 1U, NULL,
+                                                mac_u8a, &msgCnt_u8));
+    TEST_ASSERT_EQUAL(0U, atcProcl_Decode_u8(ATC_CU8A, 14U, NULL, sample_sta, 2U));
+    // both samples or none
+    TEST_ASSERT_EQUAL(0U, atcProcl_Decode_u8(ATC_CU8A, sizeof(ATC_CU8A), NULL,
+                                                sample_sta, 1U));
+    TEST_ASSERT_EQUAL(0U, atcProcl_Decode_u8(NULL, sizeof(ATC_CU8A), NULL, sample_sta, 2U));
+}
+
+static void test_BthomeFrame(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+
+    // the address of a BTHome sender is the advertiser address
+    TEST_ASSERT_TRUE(bthomeProcl_GetFrameId_bol(BTHOME_CU8A, sizeof(BTHOME_CU8A), BDA_CU8A,
+                                                mac_u8a, &msgCnt_u8));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(BDA_CU8A, mac_u8a, mija_SIZE_MAC_ADDR);
+    TEST_ASSERT_EQUAL(0x2AU, msgCnt_u8);
+
+    TEST_ASSERT_EQUAL(3U, bthomeProcl_Decode_u8(BTHOME_CU8A, sizeof(BTHOME_CU8A), BDA_CU8A,
+                                                sample_sta, mija_MAX_OBJECTS));
+    CheckSample_vd(&sample_sta[0], mija_TYPE_BATTERY, 97, 0U, 0x2AU);
+    CheckSample_vd(&sample_sta[1], mija_TYPE_TEMPERATURE, 250, 0U, 0x2AU);
+    CheckSample_vd(&sample_sta[2], mija_TYPE_HUMIDITY, 505, 0U, 0x2AU);
+
+    // the number of samples is limited by the output array
+    TEST_ASSERT_EQUAL(2U, bthomeProcl_Decode_u8(BTHOME_CU8A, sizeof(BTHOME_CU8A), BDA_CU8A,
+                                                sample_sta, 2U));
+}
+
+static void test_BthomeObjects(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+    // binary object skipped, -1.1 in 0.1 units, 55 % in full percent, unknown object 0x50
+    const uint8_t frame_cu8a[] =
+    {
+        0x40, 0x00, 0x05, 0x10, 0x01, 0x45, 0xF5, 0xFF, 0x2E, 0x37, 0x50, 0x01, 0x02, 0x00,
+        0x00
+    };
+    const uint8_t noPacketId_cu8a[] = {0x40, 0x02, 0xCA, 0x09};
+    const uint8_t encrypted_cu8a[] = {0x41, 0x00, 0x05, 0x02, 0xCA, 0x09};
+    const uint8_t version1_cu8a[] = {0x20, 0x00, 0x05, 0x02, 0xCA, 0x09};
+    const uint8_t truncated_cu8a[] = {0x40, 0x00, 0x05, 0x01, 0x61, 0x02, 0xCA};
+
+    // the rest of the frame behind an object of unknown length is ignored
+    TEST_ASSERT_EQUAL(2U, bthomeProcl_Decode_u8(frame_cu8a, sizeof(frame_cu8a), BDA_CU8A,
+                                                sample_sta, mija_MAX_OBJECTS));
+    CheckSample_vd(&sample_sta[0], mija_TYPE_TEMPERATURE, -11, 0U, 0x05U);
+    CheckSample_vd(&sample_sta[1], mija_TYPE_HUMIDITY, 550, 0U, 0x05U);
+
+    // frames without packet id are decoded but not counted
+    TEST_ASSERT_FALSE(bthomeProcl_GetFrameId_bol(noPacketId_cu8a, sizeof(noPacketId_cu8a),
+                                                BDA_CU8A, mac_u8a, &msgCnt_u8));
+    TEST_ASSERT_EQUAL(1U, bthomeProcl_Decode_u8(noPacketId_cu8a, sizeof(noPacketId_cu8a),
+                                                BDA_CU8A, sample_sta, mija_MAX_OBJECTS));
+    TEST_ASSERT_EQUAL(0U, bthomeProcl_Decode_u8(encrypted_cu8a, sizeof(encrypted_cu8a),
+                                                BDA_CU8A, sample_sta, mija_MAX_OBJECTS));
+    TEST_ASSERT_FALSE(bthomeProcl_GetFrameId_bol(version1_cu8a, sizeof(version1_cu8a),
+                                                BDA_CU8A, mac_u8a, &msgCnt_u8));
+    TEST_ASSERT_EQUAL(0U, bthomeProcl_Decode_u8(version1_cu8a, sizeof(version1_cu8a),
+                                                BDA_CU8A, sample_sta, mija_MAX_OBJECTS));
+    // the truncated temperature is dropped, the battery before is kept
+    TEST_ASSERT_EQUAL(1U, bthomeProcl_Decode_u8(truncated_cu8a, sizeof(truncated_cu8a),
+                                                BDA_CU8A, sample_sta, mija_MAX_OBJECTS));
+    TEST_ASSERT_EQUAL(mija_TYPE_BATTERY, sample_sta[0].dataType_u8);
+}
+
+static void test_DispatchByUuid(void)
+{
+    const bleDrv_decoder_t manufacturer_cst =
+    {
+        "manufacturer", bleDrv_AD_MANUFACTURER, COMPANY_ID, NULL, ManufacturerSample_u8
+    };
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t adv_u8a[ADV_SIZE];
+    uint8_t advLen_u8;
+
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_RegisterDecoder_st(&MIJA_DECODER_CST));
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_RegisterDecoder_st(&ATC_DECODER_CST));
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_RegisterDecoder_st(&BTHOME_DECODER_CST));
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_RegisterDecoder_st(&manufacturer_cst));
+
+    advLen_u8 = BuildAdv_u8(bleDrv_AD_SERVICE_DATA, atcProcl_SERVICE_UUID, ATC_CU8A,
+                            sizeof(ATC_CU8A), adv_u8a);
+    TEST_ASSERT_EQUAL(2U, DecodeAdvertisement_u8(adv_u8a, advLen_u8, BDA_CU8A, sample_sta,
+                                                    mija_MAX_OBJECTS));
+    CheckSample_vd(&sample_sta[0], mija_TYPE_TEMPHUM, 225, 580U, 0x07U);
+    // the repetition is dropped before the decoding
+    TEST_ASSERT_EQUAL(0U, DecodeAdvertisement_u8(adv_u8a, advLen_u8, BDA_CU8A, sample_sta,
+                                                    mija_MAX_OBJECTS));
+
+    advLen_u8 = BuildAdv_u8(bleDrv_AD_SERVICE_DATA, bthomeProcl_SERVICE_UUID, BTHOME_CU8A,
+                            sizeof(BTHOME_CU8A), adv_u8a);
+    TEST_ASSERT_EQUAL(3U, DecodeAdvertisement_u8(adv_u8a, advLen_u8, BDA_CU8A, sample_sta,
+                                                    mija_MAX_OBJECTS));
+    TEST_ASSERT_EQUAL(mija_TYPE_HUMIDITY, sample_sta[2].dataType_u8);
+
+    // the same data with a uuid of no decoder and as manufacturer data
+    advLen_u8 = BuildAdv_u8(bleDrv_AD_SERVICE_DATA, UNKNOWN_UUID, BTHOME_CU8A,
+                            sizeof(BTHOME_CU8A), adv_u8a);
+    TEST_ASSERT_EQUAL(0U, DecodeAdvertisement_u8(adv_u8a, advLen_u8, BDA_CU8A, sample_sta,
+                                                    mija_MAX_OBJECTS));
+    advLen_u8 = BuildAdv_u8(bleDrv_AD_MANUFACTURER, COMPANY_ID, BTHOME_CU8A,
+                            sizeof(BTHOME_CU8A), adv_u8a);
+    TEST_ASSERT_EQUAL(1U, DecodeAdvertisement_u8(adv_u8a, advLen_u8, BDA_CU8A, sample_sta,
+                                                    mija_MAX_OBJECTS));
+    TEST_ASSERT_EQUAL_UINT32(1U, manufacturerCalls_u32s);
+
+    // an AD structure which is longer than the advertisement is not dispatched
+    advLen_u8 = BuildAdv_u8(bleDrv_AD_SERVICE_DATA, bthomeProcl_SERVICE_UUID, BTHOME_CU8A,
+                            sizeof(BTHOME_CU8A), adv_u8a);
+    TEST_ASSERT_EQUAL(0U, DecodeAdvertisement_u8(adv_u8a, advLen_u8 - 1U, BDA_CU8A,
+                                                    sample_sta, mija_MAX_OBJECTS));
+}
+
+static void test_RegistryIsLimited(void)
+{
+    RegisterDecoders_vd(bleDrv_MAX_DECODERS, &ATC_DECODER_CST);
+    TEST_ASSERT_EQUAL(ESP_FAIL, bleDrv_RegisterDecoder_st(&BTHOME_DECODER_CST));
+    TEST_ASSERT_EQUAL(ESP_FAIL, bleDrv_RegisterDecoder_st(NULL));
+}
+
+/* cost of the dispatch with 1, 4 and 16 registered decoders */
+static void test_BenchDispatch(void)
+{
+    BenchDispatch_vd(1U);
+    BenchDispatch_vd(4U);
+    BenchDispatch_vd(16U);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_AtcFrame);
+    RUN_TEST(test_PvvxFrame);
+    RUN_TEST(test_AtcRejectsOtherFrames);
+    RUN_TEST(test_BthomeFrame);
+    RUN_TEST(test_BthomeObjects);
+    RUN_TEST(test_DispatchByUuid);
+    RUN_TEST(test_RegistryIsLimited);
+    RUN_TEST(test_BenchDispatch);
+    return(UNITY_END());
+}
@@ -0,0 +1,420 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Replay of an advertisement trace through the gap callback of the ble driver.
+*       Sensors repeat every frame several times, the repeated frame filter has to
+*       decode each frame once and count repetitions and lost frames per sensor.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+#include "bleDrv.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define TRACE_SENSORS       6U
+#define TRACE_FRAMES        2000U       // new frames per sensor, the counter wraps 7 times
+#define FRAME_PERIOD_MS     10000U      // a new frame every 10 s, like the LYWSD03MMC
+#define REPEAT_SPACING_MS   100U        // repetitions of a frame follow each other closely
+#define REPEAT_MAX          6U          // receptions of one frame, 1 to REPEAT_MAX
+#define LOSS_PERMILLE       50U         // frames lost completely on the radio
+
+#define ADV_LEN             25U
+#define ADV_CNT_POS         11U
+#define ADV_MAC_POS         12U
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* one reception of the trace */
+typedef struct traceRec_tag
+{
+    uint32_t timeMs_u32;
+    uint8_t sensor_u8;
+    uint8_t msgCnt_u8;
+}traceRec_t;
+
+/* what the filter has to report for a sensor after the replay */
+typedef struct expected_tag
+{
+    uint32_t frames_u32;
+    uint32_t duplicates_u32;
+    uint32_t missed_u32;
+}expected_t;
+
+/****************************************************************************************/
+/* Local variables: */
+
+// service data of a LYWSD03MMC with a temperature and humidity object, message counter
+// and mac address are replaced per reception
+static const uint8_t ADV_TEMPLATE_CU8A[ADV_LEN] =
+{
+    0x02, 0x01, 0x06, 0x15, 0x16, 0x95, 0xFE, 0x50, 0x20, 0xAA, 0x01, 0x8E,
+    0x86, 0x10, 0x37, 0x34, 0x2D, 0x58, 0x0D, 0x10, 0x04, 0xCE, 0x00, 0xB9, 0x01
+};
+
+static traceRec_t *trace_stps;
+static uint32_t traceLen_u32s;
+static expected_t expected_stsa[TRACE_SENSORS];
+static uint32_t received_u32s;
+static uint32_t decoded_u32s;
+static bool initialized_bols = false;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static void OnSample_vd(const mijaProcl_rawSample_t *sample_cstp)
+{
+    (void)sample_cstp;
+    received_u32s++;
+}
+
+/* the mija decoder, counts the frames which were not dropped by the filter */
+static uint8_t CountingDecode_u8(const uint8_t *data_cu8p, uint8_t dataLen_u8,
+                                    const uint8_t *bda_cu8p,
+                                    mijaProcl_rawSample_t *out_stap, uint8_t maxOut_u8)
+{
+    decoded_u32s++;
+    return(mijaProcl_DecodeServiceData_u8(data_cu8p, dataLen_u8, bda_cu8p, out_stap,
+                                            maxOut_u8));
+}
+
+static const bleDrv_decoder_t countedDecoder_scs =
+{
+    "mija", bleDrv_AD_SERVICE_DATA, mija_SERVICE_UUID,
+    mijaProcl_GetServiceFrameId_bol, CountingDecode_u8
+};
+
+// the same decoder without frame id, every reception is decoded
+static const bleDrv_decoder_t uncountedDecoder_scs =
+{
+    "mija", bleDrv_AD_SERVICE_DATA, mija_SERVICE_UUID, NULL, CountingDecode_u8
+};
+
+static void SensorMac_vd(uint8_t sensor_u8, uint8_t *mac_u8p)
+{
+    static const uint8_t BASE_CU8A[mija_SIZE_MAC_ADDR] =
+                                            {0xA4, 0xC1, 0x38, 0x00, 0x10, 0x00};
+
+    memcpy(mac_u8p, BASE_CU8A, mija_SIZE_MAC_ADDR);
+    mac_u8p[5] = sensor_u8;
+}
+
+/* hands one advertisement to the gap callback like the bluetooth stack */
+static void Receive_vd(uint8_t sensor_u8, uint8_t msgCnt_u8)
+{
+    esp_ble_gap_cb_param_t param_un;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    SensorMac_vd(sensor_u8, &mac_u8a[0]);
+    memset(&param_un, 0, sizeof(param_un));
+    param_un.scan_rst.search_evt = ESP_GAP_SEARCH_INQ_RES_EVT;
+    memcpy(param_un.scan_rst.ble_adv, ADV_TEMPLATE_CU8A, ADV_LEN);
+    param_un.scan_rst.ble_adv[ADV_CNT_POS] = msgCnt_u8;
+    for(uint8_t idx_u8 = 0U; idx_u8 < mija_SIZE_MAC_ADDR; idx_u8++)
+    {
+        // the frame carries the mac address reversed
+        param_un.scan_rst.ble_adv[ADV_MAC_POS + idx_u8] = mac_u8a[mija_SIZE_MAC_ADDR
+                                                                    - 1U - idx_u8];
+    }
+    memcpy(param_un.scan_rst.bda, mac_u8a, ESP_BD_ADDR_LEN);
+    param_un.scan_rst.adv_data_len = ADV_LEN;
+    esp_GapCallBack_st(ESP_GAP_BLE_SCAN_RESULT_EVT, &param_un);
+}
+
+/* builds the trace of all sensors sorted by time. Every frame is received 1 to
+   REPEAT_MAX times or lost completely, the sensors start at different counters. */
+static void BuildTrace_vd(void)
+{
+    uint32_t seed_u32 = 0x1234567U;
+    uint32_t maxLen_u32 = TRACE_SENSORS * TRACE_FRAMES * REPEAT_MAX;
+    uint32_t pending_u32a[TRACE_SENSORS] = {0U};
+    uint32_t time_u32;
+    uint32_t repeats_u32;
+    uint8_t cnt_u8;
+
+    trace_stps = (traceRec_t *)malloc(maxLen_u32 * sizeof(traceRec_t));
+    traceLen_u32s = 0U;
+    memset(expected_stsa, 0, sizeof(expected_stsa));
+
+    for(uint32_t frame_u32 = 0U; frame_u32 < TRACE_FRAMES; frame_u32++)
+    {
+        for(uint8_t sensor_u8 = 0U; sensor_u8 < TRACE_SENSORS; sensor_u8++)
+        {
+            seed_u32 = (seed_u32 * 1103515245U) + 12345U;
+            cnt_u8 = (uint8_t)((sensor_u8 * 40U) + frame_u32);
+            // the first frame is always received, it starts the entry of the sensor
+            if((0U != frame_u32) && (LOSS_PERMILLE > ((seed_u32 >> 8) % 1000U)))
+            {
+                pending_u32a[sensor_u8]++;
+            }
+            else
+            {
+                repeats_u32 = 1U + ((seed_u32 >> 20) % REPEAT_MAX);
+                time_u32 = (frame_u32 * FRAME_PERIOD_MS) + (sensor_u8 * 1000U);
+                for(uint32_t rep_u32 = 0U; rep_u32 < repeats_u32; rep_u32++)
+                {
+                    trace_stps[traceLen_u32s].timeMs_u32 = time_u32
+                                                            + (rep_u32 * REPEAT_SPACING_MS);
+                    trace_stps[traceLen_u32s].sensor_u8 = sensor_u8;
+                    trace_stps[traceLen_u32s].msgCnt_u8 = cnt_u8;
+                    traceLen_u32s++;
+                }
+                expected_stsa[sensor_u8].frames_u32++;
+                expected_stsa[sensor_u8].duplicates_u32 += repeats_u32 - 1U;
+                expected_stsa[sensor_u8].missed_u32 += pending_u32a[sensor_u8];
+                pending_u32a[sensor_u8] = 0U;
+            }
+        }
+    }
+}
+
+static void ResetFilter_vd(void)
+{
+    memset(singleton_sst.filter_sta, 0, sizeof(singleton_sst.filter_sta));
+    singleton_sst.filterNext_u8 = 0U;
+    received_u32s = 0U;
+    decoded_u32s = 0U;
+}
+
+void setUp(void)
+{
+    bleDrv_param_t param_st;
+
+    if(false == initialized_bols)
+    {
+        fake_NvsReset_vd();
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_InitializeParameter_st(&param_st));
+        param_st.scanDurationInSec_u32 = 5U;
+        param_st.cycleTimeInSec_u32 = 10U;
+        param_st.dataCb_fp = OnSample_vd;
+        param_st.knownOnly_bol = false;
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_Initialize_st(&param_st));
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_RegisterDecoder_st(&countedDecoder_scs));
+        BuildTrace_vd();
+        initialized_bols = true;
+    }
+    singleton_sst.decoders_cstpa[0] = &countedDecoder_scs;
+    ResetFilter_vd();
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_RepeatedFrameIsDecodedOnce(void)
+{
+    bleDrv_frameStats_t stats_st;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    Receive_vd(1U, 10U);
+    Receive_vd(1U, 10U);
+    Receive_vd(1U, 10U);
+    TEST_ASSERT_EQUAL_UINT32(1U, decoded_u32s);
+    TEST_ASSERT_EQUAL_UINT32(1U, received_u32s);
+
+    // the same counter of another sensor is a new frame
+    Receive_vd(2U, 10U);
+    TEST_ASSERT_EQUAL_UINT32(2U, decoded_u32s);
+
+    SensorMac_vd(1U, &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.frames_u32);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats_st.duplicates_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_st.missed_u32);
+}
+
+static void test_CounterGapsAndWrapAround(void)
+{
+    bleDrv_frameStats_t stats_st;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    Receive_vd(3U, 250U);
+    Receive_vd(3U, 253U);     // 251 and 252 lost
+    Receive_vd(3U, 255U);     // 254 lost
+    Receive_vd(3U, 0U);       // wraps without loss
+    Receive_vd(3U, 4U);       // 1, 2 and 3 lost
+
+    SensorMac_vd(3U, &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+    TEST_ASSERT_EQUAL_UINT32(5U, stats_st.frames_u32);
+    TEST_ASSERT_EQUAL_UINT32(6U, stats_st.missed_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_st.duplicates_u32);
+}
+
+static void test_UnknownSendersReplacedKnownKept(void)
+{
+    bleDrv_frameStats_t stats_st;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    SensorMac_vd(0U, &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_SetKnownDevice_st(&mac_u8a[0], true));
+    Receive_vd(0U, 7U);
+
+    // more unknown senders than entries
+    for(uint8_t sensor_u8 = 1U; sensor_u8 <= (2U * bleDrv_FRAME_FILTER_SIZE); sensor_u8++)
+    {
+        Receive_vd(sensor_u8, 1U);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.frames_u32);
+
+    // the known sender still filters its repetition
+    Receive_vd(0U, 7U);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.duplicates_u32);
+
+    // the first unknown sender was replaced, the newest is tracked
+    SensorMac_vd(1U, &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_FAIL, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+    SensorMac_vd((uint8_t)(2U * bleDrv_FRAME_FILTER_SIZE), &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+}
+
+static void test_KnownBeforeFirstFrame(void)
+{
+    bleDrv_frameStats_t stats_st;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    // the first frame has the counter 0, the entry of the known sender holds none
+    SensorMac_vd(4U, &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_SetKnownDevice_st(&mac_u8a[0], true));
+    Receive_vd(4U, 0U);
+    TEST_ASSERT_EQUAL_UINT32(1U, decoded_u32s);
+
+    // the first frame with any other counter counts no lost frames
+    SensorMac_vd(5U, &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_SetKnownDevice_st(&mac_u8a[0], true));
+    Receive_vd(5U, 100U);
+    Receive_vd(5U, 100U);
+    Receive_vd(5U, 102U);
+    TEST_ASSERT_EQUAL_UINT32(3U, decoded_u32s);
+
+    SensorMac_vd(4U, &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.frames_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_st.duplicates_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_st.missed_u32);
+    SensorMac_vd(5U, &mac_u8a[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+    TEST_ASSERT_EQUAL_UINT32(2U, stats_st.frames_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.duplicates_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.missed_u32);
+}
+
+/* replays the whole trace, the filter has to forward exactly the new frames and count
+   the repetitions and losses of every sensor */
+static void test_TraceReplay(void)
+{
+    bleDrv_frameStats_t stats_st;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint32_t frames_u32 = 0U;
+    uint32_t startMs_u32 = (uint32_t)(fake_nowUs_s64 / 1000);
+    uint32_t nowMs_u32;
+    char line_ca[128];
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < traceLen_u32s; idx_u32++)
+    {
+        nowMs_u32 = (uint32_t)(fake_nowUs_s64 / 1000) - startMs_u32;
+        if(trace_stps[idx_u32].timeMs_u32 > nowMs_u32)
+        {
+            fake_AdvanceMs_vd(trace_stps[idx_u32].timeMs_u32 - nowMs_u32);
+        }
+        Receive_vd(trace_stps[idx_u32].sensor_u8, trace_stps[idx_u32].msgCnt_u8);
+    }
+
+    for(uint8_t sensor_u8 = 0U; sensor_u8 < TRACE_SENSORS; sensor_u8++)
+    {
+        SensorMac_vd(sensor_u8, &mac_u8a[0]);
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetFrameStats_st(&mac_u8a[0], &stats_st));
+        TEST_ASSERT_EQUAL_UINT32(expected_stsa[sensor_u8].frames_u32, stats_st.frames_u32);
+        TEST_ASSERT_EQUAL_UINT32(expected_stsa[sensor_u8].duplicates_u32,
+                                    stats_st.duplicates_u32);
+        TEST_ASSERT_EQUAL_UINT32(expected_stsa[sensor_u8].missed_u32, stats_st.missed_u32);
+        TEST_ASSERT_UINT32_WITHIN(100U, FRAME_PERIOD_MS, stats_st.periodMs_u32);
+        frames_u32 += expected_stsa[sensor_u8].frames_u32;
+    }
+    TEST_ASSERT_EQUAL_UINT32(frames_u32, decoded_u32s);
+    TEST_ASSERT_EQUAL_UINT32(frames_u32, received_u32s);
+
+    snprintf(line_ca, sizeof(line_ca), "bleDrv trace: %u receptions, %u decoded",
+                traceLen_u32s, decoded_u32s);
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+}
+
+/* cpu time of the gap callback per reception with and without the filter */
+static void test_BenchFilterAgainstDecodeAll(void)
+{
+    uint64_t startNs_u64;
+    uint32_t decoded_u32;
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t idx_u32 = 0U; idx_u32 < traceLen_u32s; idx_u32++)
+    {
+        Receive_vd(trace_stps[idx_u32].sensor_u8, trace_stps[idx_u32].msgCnt_u8);
+    }
+    fake_Bench_vd("bleDrv callback, repeated frame filter", traceLen_u32s,
+                    fake_HostNs_u64() - startNs_u64);
+    decoded_u32 = decoded_u32s;
+
+    singleton_sst.decoders_cstpa[0] = &uncountedDecoder_scs;
+    ResetFilter_vd();
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t idx_u32 = 0U; idx_u32 < traceLen_u32s; idx_u32++)
+    {
+        Receive_vd(trace_stps[idx_u32].sensor_u8, trace_stps[idx_u32].msgCnt_u8);
+    }
+    fake_Bench_vd("bleDrv callback, every frame decoded", traceLen_u32s,
+                    fake_HostNs_u64() - startNs_u64);
+    TEST_ASSERT_EQUAL_UINT32(traceLen_u32s, decoded_u32s);
+    TEST_ASSERT_LESS_THAN_UINT32(traceLen_u32s, decoded_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_RepeatedFrameIsDecodedOnce);
+    RUN_TEST(test_CounterGapsAndWrapAround);
+    RUN_TEST(test_UnknownSendersReplacedKnownKept);
+    RUN_TEST(test_KnownBeforeFirstFrame);
+    RUN_TEST(test_TraceReplay);
+    RUN_TEST(test_BenchFilterAgainstDecodeAll);
+    free(trace_stps);
+    return(UNITY_END());
+}
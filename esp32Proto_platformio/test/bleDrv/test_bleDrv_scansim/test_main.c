@@ -0,0 +1,389 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Simulator of the adaptive scan scheduler of the ble driver. Synthetic sensors
+*       advertise with their own period and jitter, the scheduler runs on the fake clock
+*       against the fake bluetooth controller. Each run reports the radio-on time and
+*       the share of the frames of the known sensors which were received.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+#include "bleDrv.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define SIM_MS              (4U * 3600U * 1000U)    // simulated time per run
+#define STEP_MS             50U
+#define KNOWN_SENSORS       8U
+#define UNKNOWN_SENSORS     4U                      // neighbours, never marked as known
+#define ADVERTISERS         (KNOWN_SENSORS + UNKNOWN_SENSORS)
+#define REPEATS             5U                      // receptions of each frame
+#define REPEAT_SPACING_MS   100U
+#define JITTER_MS           300U                    // random delay of a frame
+
+#define SCAN_DURATION_SEC   5U
+#define CYCLE_TIME_SEC      10U
+
+#define ADV_LEN             25U
+#define ADV_CNT_POS         11U
+#define ADV_MAC_POS         12U
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* synthetic sensor, sends a new frame every period plus jitter and repeats it */
+typedef struct advertiser_tag
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint32_t periodMs_u32;
+    uint32_t nextMs_u32;            // next reception
+    uint8_t repeat_u8;              // receptions of the current frame left
+    uint8_t msgCnt_u8;
+    uint32_t sent_u32;              // new frames
+}advertiser_t;
+
+/* result of one simulation run */
+typedef struct simResult_tag
+{
+    double radioOn_f64;             // part of the time the radio was scanning
+    double capture_f64;             // part of the frames of known sensors received
+    uint32_t scans_u32;
+    uint32_t discovery_u32;
+    uint32_t earlyStop_u32;
+    uint32_t callbacks_u32;         // reports handed to the gap callback, no whitelist
+    uint32_t filteredCb_u32;        // reports handed to the gap callback, whitelist scan
+    double cbPerSec_f64;            // all reports per second of simulated time
+}simResult_t;
+
+/****************************************************************************************/
+/* Local variables: */
+
+static const uint32_t PERIODS_CU32A[ADVERTISERS] =
+{
+    10000U, 12000U, 15000U, 20000U, 30000U, 30000U, 60000U, 60000U,
+    10000U, 20000U, 30000U, 60000U
+};
+
+static const uint8_t ADV_TEMPLATE_CU8A[ADV_LEN] =
+{
+    0x02, 0x01, 0x06, 0x15, 0x16, 0x95, 0xFE, 0x50, 0x20, 0xAA, 0x01, 0x8E,
+    0x86, 0x10, 0x37, 0x34, 0x2D, 0x58, 0x0D, 0x10, 0x04, 0xCE, 0x00, 0xB9, 0x01
+};
+
+// the driver keeps the pointer to the decoder
+static const bleDrv_decoder_t MIJA_DECODER_CST =
+{
+    "mija", bleDrv_AD_SERVICE_DATA, mija_SERVICE_UUID, mijaProcl_GetServiceFrameId_bol,
+    mijaProcl_DecodeServiceData_u8
+};
+
+static advertiser_t adv_sta[ADVERTISERS];
+static uint32_t captured_u32sa[ADVERTISERS];
+static uint32_t seed_u32s;
+static bool initialized_bols = false;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static uint32_t Random_u32(void)
+{
+    seed_u32s = (seed_u32s * 1103515245U) + 12345U;
+    return(seed_u32s >> 8);
+}
+
+/* every data callback is a new frame, repetitions are dropped by the frame filter */
+static void OnSample_vd(const mijaProcl_rawSample_t *sample_cstp)
+{
+    uint8_t idx_u8 = sample_cstp->macAddr_u8a[5];
+
+    if(ADVERTISERS > idx_u8)
+    {
+        captured_u32sa[idx_u8]++;
+    }
+}
+
+static void Transmit_vd(advertiser_t *adv_stp)
+{
+    uint8_t data_u8a[ADV_LEN];
+
+    memcpy(data_u8a, ADV_TEMPLATE_CU8A, ADV_LEN);
+    data_u8a[ADV_CNT_POS] = adv_stp->msgCnt_u8;
+    for(uint8_t idx_u8 = 0U; idx_u8 < mija_SIZE_MAC_ADDR; idx_u8++)
+    {
+        data_u8a[ADV_MAC_POS + idx_u8] = adv_stp->mac_u8a[mija_SIZE_MAC_ADDR - 1U - idx_u8];
+    }
+    (void)fake_BleAdvertise_bol(adv_stp->mac_u8a, data_u8a, ADV_LEN);
+}
+
+/* transmissions of the advertisers which are due at the time of the simulation */
+static void RunAdvertisers_vd(uint32_t nowMs_u32)
+{
+    advertiser_t *adv_stp;
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < ADVERTISERS; idx_u8++)
+    {
+        adv_stp = &adv_sta[idx_u8];
+        while(adv_stp->nextMs_u32 <= nowMs_u32)
+        {
+            if(0U == adv_stp->repeat_u8)
+            {
+                adv_stp->msgCnt_u8++;
+                adv_stp->sent_u32++;
+                adv_stp->repeat_u8 = REPEATS;
+            }
+            Transmit_vd(adv_stp);
+            adv_stp->repeat_u8--;
+            adv_stp->nextMs_u32 += (0U != adv_stp->repeat_u8) ? REPEAT_SPACING_MS :
+                        (adv_stp->periodMs_u32 - ((REPEATS - 1U) * REPEAT_SPACING_MS)
+                            + (Random_u32() % JITTER_MS));
+        }
+    }
+}
+
+/* runs the scan scheduler against the advertisers for SIM_MS */
+static void Simulate_vd(uint8_t known_u8, bool knownOnly_bol, simResult_t *result_stp)
+{
+    bleDrv_scanStats_t stats_st;
+    uint32_t startMs_u32;
+    uint32_t nowMs_u32 = 0U;
+    uint32_t sent_u32 = 0U;
+    uint32_t captured_u32 = 0U;
+
+    // a fresh scheduler, the driver itself is initialized once
+    memset(singleton_sst.filter_sta, 0, sizeof(singleton_sst.filter_sta));
+    memset(&singleton_sst.scanStats_st, 0, sizeof(singleton_sst.scanStats_st));
+    singleton_sst.filterNext_u8 = 0U;
+    singleton_sst.discoveryDone_bol = false;
+    singleton_sst.nextScanMs_u32 = GetTimeMs_u32();
+    singleton_sst.param_st.knownOnly_bol = knownOnly_bol;
+    fake_BleReset_vd();
+    memset(captured_u32sa, 0, sizeof(captured_u32sa));
+    seed_u32s = 0xADU;
+
+    startMs_u32 = GetTimeMs_u32();
+    for(uint8_t idx_u8 = 0U; idx_u8 < ADVERTISERS; idx_u8++)
+    {
+        memset(&adv_sta[idx_u8], 0, sizeof(advertiser_t));
+        adv_sta[idx_u8].mac_u8a[0] = 0xA4;
+        adv_sta[idx_u8].mac_u8a[1] = 0xC1;
+        adv_sta[idx_u8].mac_u8a[5] = idx_u8;
+        adv_sta[idx_u8].periodMs_u32 = PERIODS_CU32A[idx_u8];
+        adv_sta[idx_u8].nextMs_u32 = Random_u32() % PERIODS_CU32A[idx_u8];
+        if(idx_u8 < known_u8)
+        {
+            TEST_ASSERT_EQUAL(ESP_OK, bleDrv_SetKnownDevice_st(adv_sta[idx_u8].mac_u8a,
+                                                                true));
+        }
+    }
+
+    while(nowMs_u32 < SIM_MS)
+    {
+        fake_AdvanceMs_vd(STEP_MS);
+        fake_BlePoll_vd();
+        nowMs_u32 = GetTimeMs_u32() - startMs_u32;
+        RunAdvertisers_vd(nowMs_u32);
+    }
+    // the scan which is still running is accounted up to now
+    (void)esp_ble_gap_stop_scanning();
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < KNOWN_SENSORS; idx_u8++)
+    {
+        sent_u32 += adv_sta[idx_u8].sent_u32;
+        captured_u32 += captured_u32sa[idx_u8];
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_GetScanStats_st(&stats_st));
+    result_stp->radioOn_f64 = (double)fake_bleRadioOnUs_u64 / ((double)nowMs_u32 * 1000.0);
+    result_stp->capture_f64 = (double)captured_u32 / (double)sent_u32;
+    result_stp->scans_u32 = stats_st.scans_u32;
+    result_stp->discovery_u32 = stats_st.discovery_u32;
+    result_stp->earlyStop_u32 = stats_st.earlyStop_u32;
+    result_stp->callbacks_u32 = stats_st.callbacks_u32;
+    result_stp->filteredCb_u32 = stats_st.filteredCb_u32;
+    result_stp->cbPerSec_f64 = (double)(stats_st.callbacks_u32 + stats_st.filteredCb_u32)
+                                / ((double)nowMs_u32 / 1000.0);
+
+    // the driver accounts the same radio time as the controller
+    TEST_ASSERT_UINT32_WITHIN(nowMs_u32 / 100U, (uint32_t)(fake_bleRadioOnUs_u64 / 1000U),
+                                stats_st.radioOnMs_u32);
+}
+
+static void Report_vd(const char *name_cchp, const simResult_t *result_cstp)
+{
+    char line_ca[224];
+
+    snprintf(line_ca, sizeof(line_ca), "bleDrv sim %-22s radio on %5.1f %%, capture "
+                "%5.1f %%, %u scans, %u discovery, %u early stops, %u + %u filtered "
+                "reports, %.2f reports/s", name_cchp,
+                100.0 * result_cstp->radioOn_f64, 100.0 * result_cstp->capture_f64,
+                result_cstp->scans_u32, result_cstp->discovery_u32,
+                result_cstp->earlyStop_u32, result_cstp->callbacks_u32,
+                result_cstp->filteredCb_u32, result_cstp->cbPerSec_f64);
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+}
+
+void setUp(void)
+{
+    bleDrv_param_t param_st;
+
+    if(false == initialized_bols)
+    {
+        fake_NvsReset_vd();
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_InitializeParameter_st(&param_st));
+        param_st.scanDurationInSec_u32 = SCAN_DURATION_SEC;
+        param_st.cycleTimeInSec_u32 = CYCLE_TIME_SEC;
+        param_st.dataCb_fp = OnSample_vd;
+        param_st.knownOnly_bol = false;
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_Initialize_st(&param_st));
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_RegisterDecoder_st(&MIJA_DECODER_CST));
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_Activate_st());
+        initialized_bols = true;
+    }
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* without known sensors every scan is a full scan of the configured duty cycle */
+static void test_FixedDutyCycleWithoutKnownSensors(void)
+{
+    simResult_t result_st;
+
+    Simulate_vd(0U, false, &result_st);
+    Report_vd("fixed duty cycle", &result_st);
+    TEST_ASSERT_EQUAL_UINT32(result_st.scans_u32, result_st.discovery_u32);
+    TEST_ASSERT_UINT32_WITHIN(3U, (100U * SCAN_DURATION_SEC) / CYCLE_TIME_SEC,
+                                (uint32_t)(100.0 * result_st.radioOn_f64));
+}
+
+static void test_AdaptiveScansAroundArrivals(void)
+{
+    simResult_t fixed_st;
+    simResult_t adaptive_st;
+
+    Simulate_vd(0U, false, &fixed_st);
+    Simulate_vd(KNOWN_SENSORS, false, &adaptive_st);
+    Report_vd("adaptive", &adaptive_st);
+
+    // less radio time for at least the same share of received frames
+    TEST_ASSERT_LESS_THAN_UINT32((uint32_t)(1000.0 * fixed_st.radioOn_f64),
+                                    (uint32_t)(1000.0 * adaptive_st.radioOn_f64));
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32((uint32_t)(1000.0 * fixed_st.capture_f64),
+                                        (uint32_t)(1000.0 * adaptive_st.capture_f64));
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, adaptive_st.earlyStop_u32);
+
+    // the full scan is repeated every DISCOVERY_MS, more full scans are done until
+    // every sender has a period, periods of a multiple of the cycle learn slowly
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(SIM_MS / DISCOVERY_MS, adaptive_st.discovery_u32);
+    TEST_ASSERT_LESS_THAN_UINT32(fixed_st.scans_u32 / 10U, adaptive_st.discovery_u32);
+}
+
+/* the whitelist keeps the reports of the neighbours out of the gap callback */
+static void test_KnownOnlyFiltersNeighbours(void)
+{
+    simResult_t adaptive_st;
+    simResult_t knownOnly_st;
+
+    Simulate_vd(KNOWN_SENSORS, false, &adaptive_st);
+    Simulate_vd(KNOWN_SENSORS, true, &knownOnly_st);
+    Report_vd("adaptive, known only", &knownOnly_st);
+
+    // only the discovery scans of the known only run are unfiltered
+    TEST_ASSERT_EQUAL_UINT32(0U, adaptive_st.filteredCb_u32);
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, knownOnly_st.filteredCb_u32);
+    TEST_ASSERT_LESS_THAN_UINT32(knownOnly_st.filteredCb_u32, knownOnly_st.callbacks_u32);
+    TEST_ASSERT_LESS_THAN_UINT32((uint32_t)(100.0 * adaptive_st.cbPerSec_f64), 
+                                    (uint32_t)(100.0 * knownOnly_st.cbPerSec_f64));
+    TEST_ASSERT_UINT32_WITHIN(20U, (uint32_t)(1000.0 * adaptive_st.capture_f64),
+                                (uint32_t)(1000.0 * knownOnly_st.capture_f64));
+}
+
+/* the whitelist follows the known senders, also if the entry of a sender which is not
+   known anymore is wanted by new senders before the next scan */
+static void test_WhitelistFollowsKnownSenders(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR] = {0xA4, 0xC1, 0x00, 0x00, 0x00, 0x00};
+
+    memset(singleton_sst.filter_sta, 0, sizeof(singleton_sst.filter_sta));
+    singleton_sst.filterNext_u8 = 0U;
+    fake_BleReset_vd();
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < 2U; idx_u8++)
+    {
+        mac_u8a[5] = idx_u8;
+        TEST_ASSERT_EQUAL(ESP_OK, bleDrv_SetKnownDevice_st(mac_u8a, true));
+    }
+    SyncWhitelist_vd();
+    TEST_ASSERT_EQUAL_UINT32(2U, fake_bleWhitelistNum_u32);
+
+    // more new senders than entries, before the whitelist is synchronized again
+    mac_u8a[5] = 0U;
+    TEST_ASSERT_EQUAL(ESP_OK, bleDrv_SetKnownDevice_st(mac_u8a, false));
+    for(uint8_t idx_u8 = 0U; idx_u8 < (2U * bleDrv_FRAME_FILTER_SIZE); idx_u8++)
+    {
+        mac_u8a[5] = 0x80U + idx_u8;
+        (void)IsNewFrame_bol(mac_u8a, 1U);
+    }
+    SyncWhitelist_vd();
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_bleWhitelistNum_u32);
+    mac_u8a[5] = 0U;
+    TEST_ASSERT_FALSE(fake_BleWhitelisted_bol(mac_u8a));
+    mac_u8a[5] = 1U;
+    TEST_ASSERT_TRUE(fake_BleWhitelisted_bol(mac_u8a));
+
+    // the entry of the removed sender is free for new senders now
+    for(uint8_t idx_u8 = 0U; idx_u8 < bleDrv_FRAME_FILTER_SIZE; idx_u8++)
+    {
+        mac_u8a[5] = 0xC0U + idx_u8;
+        (void)IsNewFrame_bol(mac_u8a, 1U);
+    }
+    mac_u8a[5] = 0U;
+    TEST_ASSERT_EQUAL_UINT8(bleDrv_FRAME_FILTER_SIZE, FindFilterEntry_u8(mac_u8a));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_FixedDutyCycleWithoutKnownSensors);
+    RUN_TEST(test_AdaptiveScansAroundArrivals);
+    RUN_TEST(test_KnownOnlyFiltersNeighbours);
+    RUN_TEST(test_WhitelistFollowsKnownSenders);
+    return(UNITY_END());
+}
@@ -0,0 +1,216 @@
+/*****************************************************************************************
+* FILENAME :        fake_ble.h
+*
+* DESCRIPTION :
+*       Host implementation of the bluedroid gap interface used by the ble driver. The
+*       completion events of the scan parameter, scan start and scan stop calls are
+*       delivered before the call returns. A scan ends when the test advanced the clock
+*       by the scan duration and calls fake_BlePoll_vd. fake_BleAdvertise_bol delivers
+*       an advertisement while a scan is running, a whitelist scan only passes the
+*       senders on the whitelist. The radio-on time of all scans is accumulated.
+*
+*****************************************************************************************/
+#ifndef FAKE_BLE_H
+#define FAKE_BLE_H
+
+#include "fake_esp.h"
+#include "esp_bt.h"
+#include "esp_bt_main.h"
+#include "esp_gap_ble_api.h"
+
+#define FAKE_BLE_WHITELIST_NUM  16U
+
+esp_gap_ble_cb_t fake_bleCallback_fp = NULL;
+esp_ble_scan_params_t fake_bleScanParams_st;
+bool fake_bleScanning_bol = false;
+int64_t fake_bleScanEndUs_s64 = 0;
+int64_t fake_bleScanStartUs_s64 = 0;
+uint64_t fake_bleRadioOnUs_u64 = 0U;
+uint32_t fake_bleScanStarts_u32 = 0U;
+uint32_t fake_bleParamSets_u32 = 0U;
+uint32_t fake_bleWhitelistUpdates_u32 = 0U;
+uint32_t fake_bleAdvDelivered_u32 = 0U;
+esp_bd_addr_t fake_bleWhitelist_ta[FAKE_BLE_WHITELIST_NUM];
+uint32_t fake_bleWhitelistNum_u32 = 0U;
+
+static inline void fake_BleEvent_vd(esp_gap_ble_cb_event_t event_en,
+                                    esp_ble_gap_cb_param_t *param_unp)
+{
+    if(NULL != fake_bleCallback_fp)
+    {
+        fake_bleCallback_fp(event_en, param_unp);
+    }
+}
+
+static inline void fake_BleStopRadio_vd(void)
+{
+    if(true == fake_bleScanning_bol)
+    {
+        fake_bleRadioOnUs_u64 += (uint64_t)(fake_nowUs_s64 - fake_bleScanStartUs_s64);
+        fake_bleScanning_bol = false;
+    }
+}
+
+static inline void fake_BleReset_vd(void)
+{
+    fake_bleScanning_bol = false;
+    fake_bleRadioOnUs_u64 = 0U;
+    fake_bleScanStarts_u32 = 0U;
+    fake_bleParamSets_u32 = 0U;
+    fake_bleWhitelistUpdates_u32 = 0U;
+    fake_bleAdvDelivered_u32 = 0U;
+    fake_bleWhitelistNum_u32 = 0U;
+}
+
+/* ends a scan whose duration has elapsed, as the stack does with the inquiry complete */
+static inline void fake_BlePoll_vd(void)
+{
+    esp_ble_gap_cb_param_t param_un;
+
+    if((true == fake_bleScanning_bol) && (fake_nowUs_s64 >= fake_bleScanEndUs_s64))
+    {
+        // the radio is off when the scan time is over, not when the event is handled
+        fake_bleRadioOnUs_u64 += (uint64_t)(fake_bleScanEndUs_s64 - fake_bleScanStartUs_s64);
+        fake_bleScanning_bol = false;
+        memset(&param_un, 0, sizeof(param_un));
+        param_un.scan_rst.search_evt = ESP_GAP_SEARCH_INQ_CMPL_EVT;
+        fake_BleEvent_vd(ESP_GAP_BLE_SCAN_RESULT_EVT, &param_un);
+    }
+}
+
+static inline bool fake_BleWhitelisted_bol(const uint8_t *bda_cu8p)
+{
+    bool listed_bol = false;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < fake_bleWhitelistNum_u32; idx_u32++)
+    {
+        listed_bol |= (0 == memcmp(fake_bleWhitelist_ta[idx_u32], bda_cu8p,
+                                    ESP_BD_ADDR_LEN));
+    }
+    return(listed_bol);
+}
+
+/* delivers an advertisement if a scan is running and the filter policy passes it */
+static inline bool fake_BleAdvertise_bol(const uint8_t *bda_cu8p, const uint8_t *adv_cu8p,
+                                            uint8_t advLen_u8)
+{
+    esp_ble_gap_cb_param_t param_un;
+    bool delivered_bol = false;
+
+    fake_BlePoll_vd();
+    if(   (true == fake_bleScanning_bol)
+       && (   (BLE_SCAN_FILTER_ALLOW_ONLY_WLST != fake_bleScanParams_st.scan_filter_policy)
+           || (true == fake_BleWhitelisted_bol(bda_cu8p))))
+    {
+        memset(&param_un, 0, sizeof(param_un));
+        param_un.scan_rst.search_evt = ESP_GAP_SEARCH_INQ_RES_EVT;
+        memcpy(param_un.scan_rst.bda, bda_cu8p, ESP_BD_ADDR_LEN);
+        memcpy(param_un.scan_rst.ble_adv, adv_cu8p, advLen_u8);
+        param_un.scan_rst.adv_data_len = advLen_u8;
+        fake_bleAdvDelivered_u32++;
+        delivered_bol = true;
+        fake_BleEvent_vd(ESP_GAP_BLE_SCAN_RESULT_EVT, &param_un);
+    }
+    return(delivered_bol);
+}
+
+esp_err_t esp_bt_controller_mem_release(esp_bt_mode_t mode_en)
+{
+    (void)mode_en;
+    return(ESP_OK);
+}
+
+esp_err_t esp_bt_controller_init(esp_bt_controller_config_t *cfg_stp)
+{
+    (void)cfg_stp;
+    return(ESP_OK);
+}
+
+esp_err_t esp_bt_controller_enable(esp_bt_mode_t mode_en)
+{
+    (void)mode_en;
+    return(ESP_OK);
+}
+
+esp_err_t esp_bluedroid_init(void)
+{
+    return(ESP_OK);
+}
+
+esp_err_t esp_bluedroid_enable(void)
+{
+    return(ESP_OK);
+}
+
+esp_err_t esp_ble_gap_register_callback(esp_gap_ble_cb_t callback_fp)
+{
+    fake_bleCallback_fp = callback_fp;
+    return(ESP_OK);
+}
+
+esp_err_t esp_ble_gap_set_scan_params(esp_ble_scan_params_t *params_stp)
+{
+    esp_ble_gap_cb_param_t param_un;
+
+    fake_bleScanParams_st = *params_stp;
+    fake_bleParamSets_u32++;
+    memset(&param_un, 0, sizeof(param_un));
+    param_un.scan_param_cmpl.status = ESP_BT_STATUS_SUCCESS;
+    fake_BleEvent_vd(ESP_GAP_BLE_SCAN_PARAM_SET_COMPLETE_EVT, &param_un);
+    return(ESP_OK);
+}
+
+esp_err_t esp_ble_gap_start_scanning(uint32_t duration_u32)
+{
+    esp_ble_gap_cb_param_t param_un;
+
+    fake_bleScanning_bol = true;
+    fake_bleScanStartUs_s64 = fake_nowUs_s64;
+    fake_bleScanEndUs_s64 = fake_nowUs_s64 + ((int64_t)duration_u32 * 1000000);
+    fake_bleScanStarts_u32++;
+    memset(&param_un, 0, sizeof(param_un));
+    param_un.scan_start_cmpl.status = ESP_BT_STATUS_SUCCESS;
+    fake_BleEvent_vd(ESP_GAP_BLE_SCAN_START_COMPLETE_EVT, &param_un);
+    return(ESP_OK);
+}
+
+esp_err_t esp_ble_gap_stop_scanning(void)
+{
+    esp_ble_gap_cb_param_t param_un;
+
+    fake_BleStopRadio_vd();
+    memset(&param_un, 0, sizeof(param_un));
+    param_un.scan_stop_cmpl.status = ESP_BT_STATUS_SUCCESS;
+    fake_BleEvent_vd(ESP_GAP_BLE_SCAN_STOP_COMPLETE_EVT, &param_un);
+    return(ESP_OK);
+}
+
+esp_err_t esp_ble_gap_update_whitelist(bool add_bol, esp_bd_addr_t bda)
+{
+    esp_ble_gap_cb_param_t param_un;
+    uint32_t idx_u32 = 0U;
+
+    fake_bleWhitelistUpdates_u32++;
+    while(   (idx_u32 < fake_bleWhitelistNum_u32)
+          && (0 != memcmp(fake_bleWhitelist_ta[idx_u32], bda, ESP_BD_ADDR_LEN)))
+    {
+        idx_u32++;
+    }
+    if((true == add_bol) && (idx_u32 == fake_bleWhitelistNum_u32)
+       && (FAKE_BLE_WHITELIST_NUM > fake_bleWhitelistNum_u32))
+    {
+        memcpy(fake_bleWhitelist_ta[fake_bleWhitelistNum_u32++], bda, ESP_BD_ADDR_LEN);
+    }
+    else if((false == add_bol) && (idx_u32 < fake_bleWhitelistNum_u32))
+    {
+        fake_bleWhitelistNum_u32--;
+        memmove(fake_bleWhitelist_ta[idx_u32], fake_bleWhitelist_ta[idx_u32 + 1U],
+                (fake_bleWhitelistNum_u32 - idx_u32) * ESP_BD_ADDR_LEN);
+    }
+    memset(&param_un, 0, sizeof(param_un));
+    param_un.update_whitelist_cmpl.status = ESP_BT_STATUS_SUCCESS;
+    fake_BleEvent_vd(ESP_GAP_BLE_UPDATE_WHITELIST_COMPLETE_EVT, &param_un);
+    return(ESP_OK);
+}
+
+#endif
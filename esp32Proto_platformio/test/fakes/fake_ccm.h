@@ -0,0 +1,283 @@
+/*****************************************************************************************
+* FILENAME :        fake_ccm.h
+*
+* DESCRIPTION :
+*       Host implementation of the mbedtls aes-ccm interface, a plain software AES-128
+*       (FIPS-197) with the CCM mode of RFC 3610. It replaces the hardware accelerated
+*       mbedtls of the target, so the decryption of the protocol can be checked with
+*       known test vectors and benchmarked on the host. Only 128 bit keys are supported.
+*
+*****************************************************************************************/
+#ifndef FAKE_CCM_H
+#define FAKE_CCM_H
+
+#include "fake_esp.h"
+#include "mbedtls/ccm.h"
+
+#define FAKE_AES_BLOCK_SIZE     16U
+#define FAKE_AES_ROUNDS         10U
+
+static const uint8_t FAKE_AES_SBOX_CU8A[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7,
+    0xab, 0x76, 0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf,
+    0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5,
+    0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15, 0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a,
+    0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e,
+    0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed,
+    0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf, 0xd0, 0xef,
+    0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff,
+    0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d,
+    0x64, 0x5d, 0x19, 0x73, 0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee,
+    0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c,
+    0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5,
+    0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08, 0xba, 0x78, 0x25, 0x2e,
+    0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a, 0x70, 0x3e,
+    0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55,
+    0x28, 0xdf, 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f,
+    0xb0, 0x54, 0xbb, 0x16,
+};
+
+uint32_t fake_aesBlocks_u32 = 0U;       // encrypted blocks, cost of the decryption
+
+static inline uint8_t fake_AesXtime_u8(uint8_t value_u8)
+{
+    return((uint8_t)((value_u8 << 1) ^ ((0U != (value_u8 & 0x80U)) ? 0x1BU : 0x00U)));
+}
+
+static inline void fake_AesEncrypt_vd(const uint8_t *roundKeys_cu8p, const uint8_t *in_cu8p,
+                                        uint8_t *out_u8p)
+{
+    uint8_t state_u8a[FAKE_AES_BLOCK_SIZE];
+    uint8_t tmp_u8a[FAKE_AES_BLOCK_SIZE];
+    uint8_t all_u8;
+
+    fake_aesBlocks_u32++;
+    for(uint8_t idx_u8 = 0U; idx_u8 < FAKE_AES_BLOCK_SIZE; idx_u8++)
+    {
+        state_u8a[idx_u8] = in_cu8p[idx_u8] ^ roundKeys_cu8p[idx_u8];
+    }
+    for(uint8_t round_u8 = 1U; round_u8 <= FAKE_AES_ROUNDS; round_u8++)
+    {
+        // sub bytes and shift rows, the state is stored column by column
+        for(uint8_t idx_u8 = 0U; idx_u8 < FAKE_AES_BLOCK_SIZE; idx_u8++)
+        {
+            tmp_u8a[idx_u8] = FAKE_AES_SBOX_CU8A[state_u8a[((idx_u8 + (4U * (idx_u8 % 4U)))
+                                                            % FAKE_AES_BLOCK_SIZE)]];
+        }
+        for(uint8_t col_u8 = 0U; col_u8 < 4U; col_u8++)
+        {
+            uint8_t *c_u8p = &tmp_u8a[4U * col_u8];
+
+            if(FAKE_AES_ROUNDS != round_u8)
+            {
+                all_u8 = c_u8p[0] ^ c_u8p[1] ^ c_u8p[2] ^ c_u8p[3];
+                state_u8a[(4U * col_u8) + 0U] = c_u8p[0] ^ all_u8 ^ fake_AesXtime_u8(c_u8p[0] ^ c_u8p[1]);
+                state_u8a[(4U * col_u8) + 1U] = c_u8p[1] ^ all_u8 ^ fake_AesXtime_u8(c_u8p[1] ^ c_u8p[2]);
+                state_u8a[(4U * col_u8) + 2U] = c_u8p[2] ^ all_u8 ^ fake_AesXtime_u8(c_u8p[2] ^ c_u8p[3]);
+                state_u8a[(4U * col_u8) + 3U] = c_u8p[3] ^ all_u8 ^ fake_AesXtime_u8(c_u8p[3] ^ c_u8p[0]);
+            }
+            else
+            {
+                memcpy(&state_u8a[4U * col_u8], c_u8p, 4U);
+            }
+        }
+        for(uint8_t idx_u8 = 0U; idx_u8 < FAKE_AES_BLOCK_SIZE; idx_u8++)
+        {
+            state_u8a[idx_u8] ^= roundKeys_cu8p[(round_u8 * FAKE_AES_BLOCK_SIZE) + idx_u8];
+        }
+    }
+    memcpy(out_u8p, state_u8a, FAKE_AES_BLOCK_SIZE);
+}
+
+void mbedtls_ccm_init(mbedtls_ccm_context *ctx)
+{
+    memset(ctx, 0, sizeof(mbedtls_ccm_context));
+}
+
+void mbedtls_ccm_free(mbedtls_ccm_context *ctx)
+{
+    memset(ctx, 0, sizeof(mbedtls_ccm_context));
+}
+
+int mbedtls_ccm_setkey(mbedtls_ccm_context *ctx, mbedtls_cipher_id_t cipher,
+                        const unsigned char *key, unsigned int keybits)
+{
+    int result_s32 = MBEDTLS_ERR_CCM_BAD_INPUT;
+    uint8_t *rk_u8p = ctx->roundKeys_u8a;
+    uint8_t rcon_u8 = 0x01U;
+    uint8_t tmp_u8a[4];
+
+    if((MBEDTLS_CIPHER_ID_AES == cipher) && (128U == keybits))
+    {
+        memcpy(rk_u8p, key, FAKE_AES_BLOCK_SIZE);
+        for(uint32_t idx_u32 = 16U; idx_u32 < sizeof(ctx->roundKeys_u8a); idx_u32 += 4U)
+        {
+            memcpy(tmp_u8a, &rk_u8p[idx_u32 - 4U], 4U);
+            if(0U == (idx_u32 % FAKE_AES_BLOCK_SIZE))
+            {
+                // rotate word, sub word and round constant
+                uint8_t first_u8 = tmp_u8a[0];
+                tmp_u8a[0] = FAKE_AES_SBOX_CU8A[tmp_u8a[1]] ^ rcon_u8;
+                tmp_u8a[1] = FAKE_AES_SBOX_CU8A[tmp_u8a[2]];
+                tmp_u8a[2] = FAKE_AES_SBOX_CU8A[tmp_u8a[3]];
+                tmp_u8a[3] = FAKE_AES_SBOX_CU8A[first_u8];
+                rcon_u8 = fake_AesXtime_u8(rcon_u8);
+            }
+            for(uint8_t byte_u8 = 0U; byte_u8 < 4U; byte_u8++)
+            {
+                rk_u8p[idx_u32 + byte_u8] = rk_u8p[idx_u32 - 16U + byte_u8] ^ tmp_u8a[byte_u8];
+            }
+        }
+        ctx->keySet_s32 = 1;
+        result_s32 = 0;
+    }
+    return(result_s32);
+}
+
+/* computes the cbc-mac over the b0 block, the additional data and the payload */
+static inline void fake_CcmMac_vd(const mbedtls_ccm_context *ctx, size_t length,
+                                    const unsigned char *iv, size_t iv_len,
+                                    const unsigned char *add, size_t add_len,
+                                    const unsigned char *plain, size_t tag_len,
+                                    uint8_t *mac_u8p)
+{
+    uint8_t block_u8a[FAKE_AES_BLOCK_SIZE];
+    uint8_t q_u8 = (uint8_t)(15U - iv_len);
+    size_t pos_st;
+    size_t len_st;
+
+    memset(block_u8a, 0, sizeof(block_u8a));
+    block_u8a[0] = (uint8_t)(((0U < add_len) ? 0x40U : 0x00U) | (((tag_len - 2U) / 2U) << 3)
+                                | (q_u8 - 1U));
+    memcpy(&block_u8a[1], iv, iv_len);
+    for(uint8_t idx_u8 = 0U; idx_u8 < q_u8; idx_u8++)
+    {
+        block_u8a[15U - idx_u8] = (uint8_t)(length >> (8U * idx_u8));
+    }
+    fake_AesEncrypt_vd(ctx->roundKeys_u8a, block_u8a, mac_u8p);
+
+    if(0U < add_len)
+    {
+        // the additional data of the protocols is shorter than 0xFF00 bytes
+        memset(block_u8a, 0, sizeof(block_u8a));
+        block_u8a[0] = (uint8_t)(add_len >> 8);
+        block_u8a[1] = (uint8_t)add_len;
+        pos_st = 2U;
+        for(size_t idx_st = 0U; idx_st < add_len; idx_st++)
+        {
+            block_u8a[pos_st++] = add[idx_st];
+            if((FAKE_AES_BLOCK_SIZE == pos_st) || ((idx_st + 1U) == add_len))
+            {
+                for(uint8_t byte_u8 = 0U; byte_u8 < FAKE_AES_BLOCK_SIZE; byte_u8++)
+                {
+                    mac_u8p[byte_u8] ^= block_u8a[byte_u8];
+                }
+                fake_AesEncrypt_vd(ctx->roundKeys_u8a, mac_u8p, mac_u8p);
+                memset(block_u8a, 0, sizeof(block_u8a));
+                pos_st = 0U;
+            }
+        }
+    }
+
+    for(pos_st = 0U; pos_st < length; pos_st += FAKE_AES_BLOCK_SIZE)
+    {
+        len_st = ((length - pos_st) < FAKE_AES_BLOCK_SIZE) ? (length - pos_st)
+                                                            : FAKE_AES_BLOCK_SIZE;
+        for(size_t idx_st = 0U; idx_st < len_st; idx_st++)
+        {
+            mac_u8p[idx_st] ^= plain[pos_st + idx_st];
+        }
+        fake_AesEncrypt_vd(ctx->roundKeys_u8a, mac_u8p, mac_u8p);
+    }
+}
+
+/* counter mode, counter block 0 encrypts the mac, the payload starts with counter 1 */
+static inline void fake_CcmCtr_vd(const mbedtls_ccm_context *ctx, size_t length,
+                                    const unsigned char *iv, size_t iv_len,
+                                    const unsigned char *input, unsigned char *output,
+                                    uint8_t *mac_u8p, size_t tag_len)
+{
+    uint8_t ctr_u8a[FAKE_AES_BLOCK_SIZE];
+    uint8_t stream_u8a[FAKE_AES_BLOCK_SIZE];
+    uint8_t q_u8 = (uint8_t)(15U - iv_len);
+    uint32_t count_u32 = 0U;
+    size_t len_st;
+
+    memset(ctr_u8a, 0, sizeof(ctr_u8a));
+    ctr_u8a[0] = (uint8_t)(q_u8 - 1U);
+    memcpy(&ctr_u8a[1], iv, iv_len);
+    fake_AesEncrypt_vd(ctx->roundKeys_u8a, ctr_u8a, stream_u8a);
+    for(size_t idx_st = 0U; idx_st < tag_len; idx_st++)
+    {
+        mac_u8p[idx_st] ^= stream_u8a[idx_st];
+    }
+
+    for(size_t pos_st = 0U; pos_st < length; pos_st += FAKE_AES_BLOCK_SIZE)
+    {
+        count_u32++;
+        ctr_u8a[15] = (uint8_t)count_u32;
+        ctr_u8a[14] = (uint8_t)(count_u32 >> 8);
+        fake_AesEncrypt_vd(ctx->roundKeys_u8a, ctr_u8a, stream_u8a);
+        len_st = ((length - pos_st) < FAKE_AES_BLOCK_SIZE) ? (length - pos_st)
+                                                            : FAKE_AES_BLOCK_SIZE;
+        for(size_t idx_st = 0U; idx_st < len_st; idx_st++)
+        {
+            output[pos_st + idx_st] = input[pos_st + idx_st] ^ stream_u8a[idx_st];
+        }
+    }
+}
+
+int mbedtls_ccm_encrypt_and_tag(mbedtls_ccm_context *ctx, size_t length,
+                                const unsigned char *iv, size_t iv_len,
+                                const unsigned char *add, size_t add_len,
+                                const unsigned char *input, unsigned char *output,
+                                unsigned char *tag, size_t tag_len)
+{
+    int result_s32 = MBEDTLS_ERR_CCM_BAD_INPUT;
+    uint8_t mac_u8a[FAKE_AES_BLOCK_SIZE];
+
+    if((1 == ctx->keySet_s32) && (7U <= iv_len) && (13U >= iv_len) && (4U <= tag_len)
+       && (16U >= tag_len) && (0U == (tag_len % 2U)))
+    {
+        fake_CcmMac_vd(ctx, length, iv, iv_len, add, add_len, input, tag_len, mac_u8a);
+        fake_CcmCtr_vd(ctx, length, iv, iv_len, input, output, mac_u8a, tag_len);
+        memcpy(tag, mac_u8a, tag_len);
+        result_s32 = 0;
+    }
+    return(result_s32);
+}
+
+int mbedtls_ccm_auth_decrypt(mbedtls_ccm_context *ctx, size_t length,
+                                const unsigned char *iv, size_t iv_len,
+                                const unsigned char *add, size_t add_len,
+                                const unsigned char *input, unsigned char *output,
+                                const unsigned char *tag, size_t tag_len)
+{
+    int result_s32 = MBEDTLS_ERR_CCM_BAD_INPUT;
+    uint8_t mac_u8a[FAKE_AES_BLOCK_SIZE];
+    uint8_t check_u8a[FAKE_AES_BLOCK_SIZE];
+
+    if((1 == ctx->keySet_s32) && (7U <= iv_len) && (13U >= iv_len) && (4U <= tag_len)
+       && (16U >= tag_len) && (0U == (tag_len % 2U)))
+    {
+        // decrypt first, the mac is computed over the plain text
+        memset(mac_u8a, 0, sizeof(mac_u8a));
+        fake_CcmCtr_vd(ctx, length, iv, iv_len, input, output, mac_u8a, tag_len);
+        fake_CcmMac_vd(ctx, length, iv, iv_len, add, add_len, output, tag_len, check_u8a);
+        for(size_t idx_st = 0U; idx_st < tag_len; idx_st++)
+        {
+            check_u8a[idx_st] ^= mac_u8a[idx_st];
+        }
+        result_s32 = (0 == memcmp(check_u8a, tag, tag_len)) ? 0 : MBEDTLS_ERR_CCM_AUTH_FAILED;
+        if(0 != result_s32)
+        {
+            memset(output, 0, length);
+        }
+    }
+    return(result_s32);
+}
+
+#endif
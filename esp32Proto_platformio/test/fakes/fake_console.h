@@ -0,0 +1,420 @@
+/*****************************************************************************************
+* FILENAME :        fake_console.h
+*
+* DESCRIPTION :
+*       Host implementation of the console interface used by the modules: the command
+*       registration of myConsole, a reduced argtable3 parser and the base64 codec of
+*       mbedtls. The parser knows the option forms of the console commands, -x <val>,
+*       -x<val>, --long <val>, --long=<val> and positional values. fake_ConsoleRun_s32
+*       splits a command line at blanks and calls the registered command handler.
+*
+*****************************************************************************************/
+#ifndef FAKE_CONSOLE_H
+#define FAKE_CONSOLE_H
+
+#include <stdlib.h>
+#include "fake_esp.h"
+#include "myConsole.h"
+#include "argtable3/argtable3.h"
+#include "mbedtls/base64.h"
+
+#define FAKE_CONSOLE_CMDS_NUM   32U
+#define FAKE_CONSOLE_ARGS_NUM   16U
+#define FAKE_CONSOLE_LINE_SIZE  2048U   // command line buffer of the console task
+
+myConsole_cmd_t fake_consoleCmds_sta[FAKE_CONSOLE_CMDS_NUM];
+uint32_t fake_consoleCmdsNum_u32 = 0U;
+
+static inline void fake_ConsoleReset_vd(void)
+{
+    fake_consoleCmdsNum_u32 = 0U;
+}
+
+/* runs a command line like the console task, returns the result of the handler or -1
+   if the command is unknown. The output of the handler is written to out_xp. */
+static inline int32_t fake_ConsoleRun_s32(const char *line_cchp, FILE *out_xp)
+{
+    static char line_sca[FAKE_CONSOLE_LINE_SIZE];
+    char *argv_chpa[FAKE_CONSOLE_ARGS_NUM];
+    int argc_s32 = 0;
+    int32_t result_s32 = -1;
+    char *tok_chp;
+
+    snprintf(line_sca, sizeof(line_sca), "%s", line_cchp);
+    tok_chp = strtok(line_sca, " ");
+    while((NULL != tok_chp) && ((FAKE_CONSOLE_ARGS_NUM - 1) > argc_s32))
+    {
+        argv_chpa[argc_s32++] = tok_chp;
+        tok_chp = strtok(NULL, " ");
+    }
+    argv_chpa[argc_s32] = NULL;
+
+    for(uint32_t idx_u32 = 0U; (0 < argc_s32) && (idx_u32 < fake_consoleCmdsNum_u32);
+        idx_u32++)
+    {
+        if(0 == strcmp(fake_consoleCmds_sta[idx_u32].command, argv_chpa[0]))
+        {
+            if(NULL != fake_consoleCmds_sta[idx_u32].func2)
+            {
+                result_s32 = fake_consoleCmds_sta[idx_u32].func2(argc_s32, argv_chpa,
+                                                                    out_xp);
+            }
+            else
+            {
+                result_s32 = fake_consoleCmds_sta[idx_u32].func(argc_s32, argv_chpa);
+            }
+        }
+    }
+    return(result_s32);
+}
+
+esp_err_t myConsole_CmdInit_td(myConsole_cmd_t *cmd_stp)
+{
+    esp_err_t result_st = ESP_FAIL;
+
+    if(NULL != cmd_stp)
+    {
+        memset(cmd_stp, 0, sizeof(myConsole_cmd_t));
+        result_st = ESP_OK;
+    }
+    return(result_st);
+}
+
+esp_err_t myConsole_CmdRegister_td(const myConsole_cmd_t *cmd_stp)
+{
+    esp_err_t result_st = ESP_ERR_NO_MEM;
+
+    if(FAKE_CONSOLE_CMDS_NUM > fake_consoleCmdsNum_u32)
+    {
+        fake_consoleCmds_sta[fake_consoleCmdsNum_u32++] = *cmd_stp;
+        result_st = ESP_OK;
+    }
+    return(result_st);
+}
+
+static inline void *fake_ArgNew_vp(size_t size_st, char type_c, const char *shortopts_cchp,
+                                    const char *longopts_cchp, const char *datatype_cchp,
+                                    const char *glossary_cchp, int mincount_s32)
+{
+    struct arg_hdr *hdr_stp = calloc(1U, size_st);
+
+    hdr_stp->type = type_c;
+    hdr_stp->shortopts = shortopts_cchp;
+    hdr_stp->longopts = longopts_cchp;
+    hdr_stp->datatype = datatype_cchp;
+    hdr_stp->glossary = glossary_cchp;
+    hdr_stp->mincount = mincount_s32;
+    hdr_stp->maxcount = 1;
+    return(hdr_stp);
+}
+
+struct arg_lit *arg_lit0(const char *shortopts, const char *longopts, const char *glossary)
+{
+    return(fake_ArgNew_vp(sizeof(struct arg_lit), ARG_TYPE_LIT, shortopts, longopts,
+                            NULL, glossary, 0));
+}
+
+struct arg_int *arg_int0(const char *shortopts, const char *longopts, const char *datatype,
+                            const char *glossary)
+{
+    struct arg_int *arg_stp = fake_ArgNew_vp(sizeof(struct arg_int), ARG_TYPE_INT,
+                                    shortopts, longopts, datatype, glossary, 0);
+    arg_stp->ival = arg_stp->values;
+    return(arg_stp);
+}
+
+struct arg_int *arg_int1(const char *shortopts, const char *longopts, const char *datatype,
+                            const char *glossary)
+{
+    struct arg_int *arg_stp = arg_int0(shortopts, longopts, datatype, glossary);
+    arg_stp->hdr.mincount = 1;
+    return(arg_stp);
+}
+
+struct arg_str *arg_str0(const char *shortopts, const char *longopts, const char *datatype,
+                            const char *glossary)
+{
+    struct arg_str *arg_stp = fake_ArgNew_vp(sizeof(struct arg_str), ARG_TYPE_STR,
+                                    shortopts, longopts, datatype, glossary, 0);
+    arg_stp->sval = arg_stp->values;
+    return(arg_stp);
+}
+
+struct arg_str *arg_str1(const char *shortopts, const char *longopts, const char *datatype,
+                            const char *glossary)
+{
+    struct arg_str *arg_stp = arg_str0(shortopts, longopts, datatype, glossary);
+    arg_stp->hdr.mincount = 1;
+    return(arg_stp);
+}
+
+struct arg_end *arg_end(int maxerrors)
+{
+    (void)maxerrors;
+    return(fake_ArgNew_vp(sizeof(struct arg_end), ARG_TYPE_END, NULL, NULL, NULL, NULL,
+                            0));
+}
+
+/* checks if name_cchp of nameLen_st characters is one of the comma separated names */
+static inline bool fake_ArgMatch_bol(const char *names_cchp, const char *name_cchp,
+                                        size_t nameLen_st)
+{
+    bool match_bol = false;
+    const char *end_cchp;
+
+    while((false == match_bol) && (NULL != names_cchp) && ('\0' != *names_cchp))
+    {
+        end_cchp = strchr(names_cchp, ',');
+        end_cchp = (NULL == end_cchp) ? (names_cchp + strlen(names_cchp)) : end_cchp;
+        match_bol =    ((size_t)(end_cchp - names_cchp) == nameLen_st)
+                    && (0 == strncmp(names_cchp, name_cchp, nameLen_st));
+        names_cchp = ('\0' == *end_cchp) ? end_cchp : (end_cchp + 1);
+    }
+    return(match_bol);
+}
+
+/* stores a value in an int or string argument, returns false on a parse error */
+static inline bool fake_ArgStore_bol(struct arg_hdr *hdr_stp, const char *val_cchp)
+{
+    bool stored_bol = false;
+    struct arg_int *int_stp = (struct arg_int *)hdr_stp;
+    struct arg_str *str_stp = (struct arg_str *)hdr_stp;
+    char *end_chp;
+    long value_s32;
+
+    if((NULL != val_cchp) && (ARG_TYPE_INT == hdr_stp->type)
+       && (ARG_MAX_VALUES > int_stp->count))
+    {
+        value_s32 = strtol(val_cchp, &end_chp, 0);
+        if(('\0' != *val_cchp) && ('\0' == *end_chp))
+        {
+            int_stp->values[int_stp->count++] = (int)value_s32;
+            stored_bol = true;
+        }
+    }
+    else if((NULL != val_cchp) && (ARG_TYPE_STR == hdr_stp->type)
+            && (ARG_MAX_VALUES > str_stp->count))
+    {
+        str_stp->values[str_stp->count++] = val_cchp;
+        stored_bol = true;
+    }
+    return(stored_bol);
+}
+
+static inline int *fake_ArgCount_s32p(struct arg_hdr *hdr_stp)
+{
+    int *count_s32p = &((struct arg_lit *)hdr_stp)->count;
+
+    if(ARG_TYPE_INT == hdr_stp->type)
+    {
+        count_s32p = &((struct arg_int *)hdr_stp)->count;
+    }
+    else if(ARG_TYPE_STR == hdr_stp->type)
+    {
+        count_s32p = &((struct arg_str *)hdr_stp)->count;
+    }
+    else if(ARG_TYPE_END == hdr_stp->type)
+    {
+        count_s32p = &((struct arg_end *)hdr_stp)->count;
+    }
+    return(count_s32p);
+}
+
+int arg_parse(int argc, char **argv, void **argtable)
+{
+    struct arg_hdr **table_stpp = (struct arg_hdr **)argtable;
+    struct arg_hdr *hdr_stp;
+    struct arg_end *end_stp;
+    const char *arg_cchp;
+    const char *val_cchp;
+    const char *eq_cchp;
+    size_t nameLen_st;
+    uint32_t num_u32 = 0U;
+    int errors_s32 = 0;
+
+    while(ARG_TYPE_END != table_stpp[num_u32]->type)
+    {
+        *fake_ArgCount_s32p(table_stpp[num_u32]) = 0;
+        num_u32++;
+    }
+    end_stp = (struct arg_end *)table_stpp[num_u32];
+
+    for(int idx_s32 = 1; idx_s32 < argc; idx_s32++)
+    {
+        arg_cchp = argv[idx_s32];
+        hdr_stp = NULL;
+        val_cchp = NULL;
+        if(('-' == arg_cchp[0]) && ('-' == arg_cchp[1]))
+        {
+            eq_cchp = strchr(arg_cchp + 2, '=');
+            nameLen_st = (NULL == eq_cchp) ? strlen(arg_cchp + 2)
+                                            : (size_t)(eq_cchp - (arg_cchp + 2));
+            val_cchp = (NULL == eq_cchp) ? NULL : (eq_cchp + 1);
+            for(uint32_t tab_u32 = 0U; (NULL == hdr_stp) && (tab_u32 < num_u32); tab_u32++)
+            {
+                if(true == fake_ArgMatch_bol(table_stpp[tab_u32]->longopts, arg_cchp + 2,
+                                                nameLen_st))
+                {
+                    hdr_stp = table_stpp[tab_u32];
+                }
+            }
+        }
+        else if(('-' == arg_cchp[0]) && ('\0' != arg_cchp[1]))
+        {
+            val_cchp = ('\0' != arg_cchp[2]) ? (arg_cchp + 2) : NULL;
+            for(uint32_t tab_u32 = 0U; (NULL == hdr_stp) && (tab_u32 < num_u32); tab_u32++)
+            {
+                if(   (NULL != table_stpp[tab_u32]->shortopts)
+                   && (NULL != strchr(table_stpp[tab_u32]->shortopts, arg_cchp[1])))
+                {
+                    hdr_stp = table_stpp[tab_u32];
+                }
+            }
+        }
+        else
+        {
+            // positional value, the first positional argument with room takes it
+            val_cchp = arg_cchp;
+            for(uint32_t tab_u32 = 0U; (NULL == hdr_stp) && (tab_u32 < num_u32); tab_u32++)
+            {
+                if(   (NULL == table_stpp[tab_u32]->shortopts)
+                   && (NULL == table_stpp[tab_u32]->longopts)
+                   && (table_stpp[tab_u32]->maxcount
+                            > *fake_ArgCount_s32p(table_stpp[tab_u32])))
+                {
+                    hdr_stp = table_stpp[tab_u32];
+                }
+            }
+        }
+
+        if(NULL == hdr_stp)
+        {
+            errors_s32++;
+        }
+        else if(ARG_TYPE_LIT == hdr_stp->type)
+        {
+            ((struct arg_lit *)hdr_stp)->count++;
+        }
+        else
+        {
+            if((NULL == val_cchp) && ((idx_s32 + 1) < argc))
+            {
+                idx_s32++;
+                val_cchp = argv[idx_s32];
+            }
+            errors_s32 += (true == fake_ArgStore_bol(hdr_stp, val_cchp)) ? 0 : 1;
+        }
+    }
+
+    for(uint32_t tab_u32 = 0U; tab_u32 < num_u32; tab_u32++)
+    {
+        if(table_stpp[tab_u32]->mincount > *fake_ArgCount_s32p(table_stpp[tab_u32]))
+        {
+            errors_s32++;
+        }
+    }
+    end_stp->count = errors_s32;
+    return(errors_s32);
+}
+
+void arg_print_errors(FILE *fp, struct arg_end *end, const char *progname)
+{
+    fprintf(fp, "%s: %d argument errors\n", progname, end->count);
+}
+
+void arg_print_syntax(FILE *fp, void **argtable, const char *suffix)
+{
+    (void)fp;
+    (void)argtable;
+    (void)suffix;
+}
+
+void arg_print_glossary(FILE *fp, void **argtable, const char *format)
+{
+    (void)fp;
+    (void)argtable;
+    (void)format;
+}
+
+void arg_print_formatted(FILE *fp, const unsigned lmargin, const unsigned rmargin,
+                            const char *text)
+{
+    (void)lmargin;
+    (void)rmargin;
+    fprintf(fp, "%s\n", text);
+}
+
+static const char FAKE_BASE64_CCHA[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+int mbedtls_base64_encode(unsigned char *dst, size_t dlen, size_t *olen,
+                            const unsigned char *src, size_t slen)
+{
+    int result_s32 = MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+    size_t need_st = (((slen + 2U) / 3U) * 4U) + 1U;
+    size_t out_st = 0U;
+    uint32_t bits_u32;
+
+    *olen = need_st;
+    if((NULL != dst) && (dlen >= need_st))
+    {
+        for(size_t idx_st = 0U; idx_st < slen; idx_st += 3U)
+        {
+            bits_u32 = (uint32_t)src[idx_st] << 16;
+            bits_u32 |= ((idx_st + 1U) < slen) ? ((uint32_t)src[idx_st + 1U] << 8) : 0U;
+            bits_u32 |= ((idx_st + 2U) < slen) ? (uint32_t)src[idx_st + 2U] : 0U;
+            dst[out_st++] = FAKE_BASE64_CCHA[(bits_u32 >> 18) & 0x3FU];
+            dst[out_st++] = FAKE_BASE64_CCHA[(bits_u32 >> 12) & 0x3FU];
+            dst[out_st++] = ((idx_st + 1U) < slen) ?
+                                FAKE_BASE64_CCHA[(bits_u32 >> 6) & 0x3FU] : '=';
+            dst[out_st++] = ((idx_st + 2U) < slen) ? FAKE_BASE64_CCHA[bits_u32 & 0x3FU]
+                                                    : '=';
+        }
+        dst[out_st] = '\0';
+        *olen = out_st;
+        result_s32 = 0;
+    }
+    return(result_s32);
+}
+
+int mbedtls_base64_decode(unsigned char *dst, size_t dlen, size_t *olen,
+                            const unsigned char *src, size_t slen)
+{
+    int result_s32 = 0;
+    uint32_t bits_u32 = 0U;
+    uint32_t num_u32 = 0U;
+    size_t out_st = 0U;
+    const char *pos_cchp;
+
+    for(size_t idx_st = 0U; (0 == result_s32) && (idx_st < slen) && ('=' != src[idx_st]);
+        idx_st++)
+    {
+        pos_cchp = strchr(FAKE_BASE64_CCHA, src[idx_st]);
+        if((NULL == pos_cchp) || ('\0' == src[idx_st]))
+        {
+            result_s32 = MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+        }
+        else
+        {
+            bits_u32 = (bits_u32 << 6) | (uint32_t)(pos_cchp - FAKE_BASE64_CCHA);
+            num_u32 += 6U;
+            if(8U <= num_u32)
+            {
+                num_u32 -= 8U;
+                if((NULL != dst) && (out_st < dlen))
+                {
+                    dst[out_st] = (unsigned char)(bits_u32 >> num_u32);
+                }
+                out_st++;
+            }
+        }
+    }
+    *olen = out_st;
+    if((0 == result_s32) && ((NULL == dst) || (out_st > dlen)))
+    {
+        result_s32 = MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+    }
+    return(result_s32);
+}
+
+#endif
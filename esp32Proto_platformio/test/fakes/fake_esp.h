@@ -0,0 +1,101 @@
+/*****************************************************************************************
+* FILENAME :        fake_esp.h
+*
+* DESCRIPTION :
+*       Host implementation of the ESP-IDF basics for the native unit tests: log output,
+*       error names, the rom crc and the system clock. The clock is only advanced by 
+*       the tests, esp_timer_get_time and the FreeRTOS tick count are derived from it.
+*       The newlib extension itoa is only implemented for base 10.
+*       Like all fakes this file holds definitions and is included once per test.
+*
+*****************************************************************************************/
+#ifndef FAKE_ESP_H
+#define FAKE_ESP_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "rom/crc.h"
+
+int32_t fake_logLevel_s32 = ESP_LOG_NONE;
+
+// microseconds since boot, advanced by the tests only
+volatile int64_t fake_nowUs_s64 = 0;
+
+void fake_Log_vd(esp_log_level_t level_en, const char *tag_cchp, 
+                    const char *format_cchp, ...)
+{
+    va_list args_st;
+
+    if((int32_t)level_en <= fake_logLevel_s32)
+    {
+        printf("%c (%s) ", "NEWIDV"[level_en], tag_cchp);
+        va_start(args_st, format_cchp);
+        vprintf(format_cchp, args_st);
+        va_end(args_st);
+        printf("\n");
+    }
+}
+
+const char *esp_err_to_name(esp_err_t code_st)
+{
+    static char name_sca[16];
+
+    snprintf(name_sca, sizeof(name_sca), "0x%x", (unsigned int)code_st);
+    return(name_sca);
+}
+
+char *itoa(int value, char *buffer, int base)
+{
+    (void)base;
+    sprintf(buffer, "%d", value);
+    return(buffer);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return(fake_nowUs_s64);
+}
+
+// crc16 of the esp32 rom, reflected polynomial 0x8408, in and out inverted
+uint16_t crc16_le(uint16_t crc_u16, uint8_t const *buf_cu8p, uint32_t len_u32)
+{
+    crc_u16 = (uint16_t)~crc_u16;
+    for(uint32_t idx_u32 = 0U; idx_u32 < len_u32; idx_u32++)
+    {
+        crc_u16 ^= buf_cu8p[idx_u32];
+        for(uint8_t bit_u8 = 0U; bit_u8 < 8U; bit_u8++)
+        {
+            crc_u16 = (0U != (crc_u16 & 1U)) ? ((crc_u16 >> 1) ^ 0x8408U) : (crc_u16 >> 1);
+        }
+    }
+    return((uint16_t)~crc_u16);
+}
+
+/* monotonic host time for the benchmarks */
+static inline uint64_t fake_HostNs_u64(void)
+{
+    struct timespec now_st;
+
+    clock_gettime(CLOCK_MONOTONIC, &now_st);
+    return(((uint64_t)now_st.tv_sec * 1000000000ULL) + (uint64_t)now_st.tv_nsec);
+}
+
+/* prints one benchmark result in a fixed format, picked up from the test log */
+static inline void fake_Bench_vd(const char *name_cchp, uint32_t ops_u32, 
+                                    uint64_t elapsedNs_u64)
+{
+    double perOp_f64 = (0U != ops_u32) ? ((double)elapsedNs_u64 / ops_u32) : 0.0;
+    double perSec_f64 = (0U != elapsedNs_u64) ? 
+                            ((double)ops_u32 * 1e9 / (double)elapsedNs_u64) : 0.0;
+
+    printf("BENCH %-40s %10u ops %12.1f ns/op %14.0f ops/s\n", name_cchp, 
+            (unsigned int)ops_u32, perOp_f64, perSec_f64);
+}
+
+#endif
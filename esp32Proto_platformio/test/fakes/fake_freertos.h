@@ -0,0 +1,444 @@
+/*****************************************************************************************
+* FILENAME :        fake_freertos.h
+*
+* DESCRIPTION :
+*       Host implementation of the FreeRTOS objects used by the modules. Nothing blocks
+*       and no task is started, the tests call the task handlers themselves. Queues,
+*       semaphores and event groups are protected by one recursive host mutex which 
+*       also implements the critical sections, so producer threads of the stress tests
+*       see the same locking as on the target. Software timers expire when the tests
+*       advance the clock with fake_AdvanceUs_vd or fake_AdvanceMs_vd.
+*
+*****************************************************************************************/
+#ifndef FAKE_FREERTOS_H
+#define FAKE_FREERTOS_H
+
+#include <pthread.h>
+#include <stdlib.h>
+#include "fake_esp.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "freertos/timers.h"
+
+#define FAKE_TASKS_NUM      8U
+#define FAKE_TIMERS_NUM     16U
+
+struct fake_queue_tag
+{
+    uint8_t *items_u8p;
+    uint32_t itemSize_u32;
+    uint32_t length_u32;
+    uint32_t head_u32;
+    uint32_t count_u32;
+};
+
+struct fake_eventGroup_tag
+{
+    EventBits_t bits_u32;
+};
+
+struct fake_timer_tag
+{
+    const char *name_cchp;
+    TickType_t period_u32;
+    bool autoReload_bol;
+    bool active_bol;
+    TickType_t expiry_u32;
+    void *id_vp;
+    TimerCallbackFunction_t callback_fp;
+};
+
+typedef struct fake_task_tag
+{
+    const char *name_cchp;
+    TaskFunction_t task_fp;
+    void *param_vp;
+}fake_task_t;
+
+static pthread_mutex_t fake_critMutex_sst;
+static pthread_once_t fake_critOnce_sst = PTHREAD_ONCE_INIT;
+static fake_task_t fake_tasks_ssa[FAKE_TASKS_NUM];
+static uint8_t fake_tasksNum_u8s = 0U;
+static struct fake_timer_tag *fake_timers_sspa[FAKE_TIMERS_NUM];
+static uint8_t fake_timersNum_u8s = 0U;
+
+static void fake_InitCritical_vd(void)
+{
+    pthread_mutexattr_t attr_st;
+
+    pthread_mutexattr_init(&attr_st);
+    pthread_mutexattr_settype(&attr_st, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&fake_critMutex_sst, &attr_st);
+}
+
+void fake_EnterCritical_vd(portMUX_TYPE *mux_xp)
+{
+    (void)mux_xp;
+    pthread_once(&fake_critOnce_sst, fake_InitCritical_vd);
+    pthread_mutex_lock(&fake_critMutex_sst);
+}
+
+void fake_ExitCritical_vd(portMUX_TYPE *mux_xp)
+{
+    (void)mux_xp;
+    pthread_mutex_unlock(&fake_critMutex_sst);
+}
+
+/* tasks ***************************************************************************/
+
+BaseType_t xTaskCreate(TaskFunction_t task_fp, const char *name_cchp, 
+                        uint32_t stackDepth_u32, void *param_vp, 
+                        UBaseType_t prio_u32, TaskHandle_t *handle_xp)
+{
+    BaseType_t result_s32 = pdFAIL;
+
+    (void)stackDepth_u32;
+    (void)prio_u32;
+    if(FAKE_TASKS_NUM > fake_tasksNum_u8s)
+    {
+        fake_tasks_ssa[fake_tasksNum_u8s].name_cchp = name_cchp;
+        fake_tasks_ssa[fake_tasksNum_u8s].task_fp = task_fp;
+        fake_tasks_ssa[fake_tasksNum_u8s].param_vp = param_vp;
+        if(NULL != handle_xp)
+        {
+            *handle_xp = &fake_tasks_ssa[fake_tasksNum_u8s];
+        }
+        fake_tasksNum_u8s++;
+        result_s32 = pdPASS;
+    }
+    return(result_s32);
+}
+
+void vTaskDelete(TaskHandle_t handle_xp)
+{
+    (void)handle_xp;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return((TickType_t)(fake_nowUs_s64 / (1000000 / configTICK_RATE_HZ)));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return(NULL);
+}
+
+/* queues and semaphores ************************************************************/
+
+QueueHandle_t xQueueCreate(UBaseType_t length_u32, UBaseType_t itemSize_u32)
+{
+    struct fake_queue_tag *queue_stp = calloc(1U, sizeof(struct fake_queue_tag));
+
+    if(NULL != queue_stp)
+    {
+        queue_stp->length_u32 = length_u32;
+        queue_stp->itemSize_u32 = itemSize_u32;
+        queue_stp->items_u8p = calloc(length_u32, (0U != itemSize_u32) ? itemSize_u32 : 1U);
+    }
+    return(queue_stp);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue_xp, const void *item_cvp, 
+                            TickType_t ticks_u32)
+{
+    BaseType_t result_s32 = pdFALSE;
+    uint32_t pos_u32;
+
+    (void)ticks_u32;
+    fake_EnterCritical_vd(NULL);
+    if(queue_xp->count_u32 < queue_xp->length_u32)
+    {
+        pos_u32 = (queue_xp->head_u32 + queue_xp->count_u32) % queue_xp->length_u32;
+        if(0U != queue_xp->itemSize_u32)
+        {
+            memcpy(&queue_xp->items_u8p[pos_u32 * queue_xp->itemSize_u32], item_cvp,
+                    queue_xp->itemSize_u32);
+        }
+        queue_xp->count_u32++;
+        result_s32 = pdTRUE;
+    }
+    fake_ExitCritical_vd(NULL);
+    return(result_s32);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue_xp, void *item_vp, TickType_t ticks_u32)
+{
+    BaseType_t result_s32 = pdFALSE;
+
+    (void)ticks_u32;
+    fake_EnterCritical_vd(NULL);
+    if(0U != queue_xp->count_u32)
+    {
+        if(0U != queue_xp->itemSize_u32)
+        {
+            memcpy(item_vp, &queue_xp->items_u8p[queue_xp->head_u32 * queue_xp->itemSize_u32],
+                    queue_xp->itemSize_u32);
+        }
+        queue_xp->head_u32 = (queue_xp->head_u32 + 1U) % queue_xp->length_u32;
+        queue_xp->count_u32--;
+        result_s32 = pdTRUE;
+    }
+    fake_ExitCritical_vd(NULL);
+    return(result_s32);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue_xp)
+{
+    return(queue_xp->count_u32);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_u32, UBaseType_t initial_u32)
+{
+    SemaphoreHandle_t sema_xp = xQueueCreate(max_u32, 0U);
+
+    if(NULL != sema_xp)
+    {
+        sema_xp->count_u32 = initial_u32;
+    }
+    return(sema_xp);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return(xSemaphoreCreateCounting(1U, 0U));
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return(xSemaphoreCreateCounting(1U, 1U));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sema_xp, TickType_t ticks_u32)
+{
+    return(xQueueReceive(sema_xp, NULL, ticks_u32));
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sema_xp)
+{
+    return(xQueueSendToBack(sema_xp, NULL, 0U));
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sema_xp)
+{
+    free(sema_xp->items_u8p);
+    free(sema_xp);
+}
+
+/* event groups *********************************************************************/
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return(calloc(1U, sizeof(struct fake_eventGroup_tag)));
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group_xp, EventBits_t bits_u32)
+{
+    EventBits_t result_u32;
+
+    fake_EnterCritical_vd(NULL);
+    group_xp->bits_u32 |= bits_u32;
+    result_u32 = group_xp->bits_u32;
+    fake_ExitCritical_vd(NULL);
+    return(result_u32);
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group_xp, EventBits_t bits_u32)
+{
+    EventBits_t result_u32;
+
+    fake_EnterCritical_vd(NULL);
+    result_u32 = group_xp->bits_u32;
+    group_xp->bits_u32 &= ~bits_u32;
+    fake_ExitCritical_vd(NULL);
+    return(result_u32);
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group_xp)
+{
+    return(group_xp->bits_u32);
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group_xp, EventBits_t bits_u32, 
+                                BaseType_t clear_s32, BaseType_t all_s32, 
+                                TickType_t ticks_u32)
+{
+    EventBits_t result_u32;
+    bool done_bol;
+
+    (void)ticks_u32;
+    fake_EnterCritical_vd(NULL);
+    result_u32 = group_xp->bits_u32;
+    done_bol = (pdFALSE != all_s32) ? (bits_u32 == (result_u32 & bits_u32)) 
+                                    : (0U != (result_u32 & bits_u32));
+    if((true == done_bol) && (pdFALSE != clear_s32))
+    {
+        group_xp->bits_u32 &= ~bits_u32;
+    }
+    fake_ExitCritical_vd(NULL);
+    return(result_u32);
+}
+
+/* software timers ******************************************************************/
+
+TimerHandle_t xTimerCreate(const char *name_cchp, TickType_t period_u32, 
+                            UBaseType_t autoReload_u32, void *id_vp, 
+                            TimerCallbackFunction_t callback_fp)
+{
+    struct fake_timer_tag *timer_stp = NULL;
+
+    if(FAKE_TIMERS_NUM > fake_timersNum_u8s)
+    {
+        timer_stp = calloc(1U, sizeof(struct fake_timer_tag));
+        timer_stp->name_cchp = name_cchp;
+        timer_stp->period_u32 = period_u32;
+        timer_stp->autoReload_bol = (pdFALSE != autoReload_u32);
+        timer_stp->id_vp = id_vp;
+        timer_stp->callback_fp = callback_fp;
+        fake_timers_sspa[fake_timersNum_u8s] = timer_stp;
+        fake_timersNum_u8s++;
+    }
+    return(timer_stp);
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer_xp, TickType_t ticks_u32)
+{
+    (void)ticks_u32;
+    timer_xp->active_bol = true;
+    timer_xp->expiry_u32 = xTaskGetTickCount() + timer_xp->period_u32;
+    return(pdPASS);
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer_xp, TickType_t ticks_u32)
+{
+    (void)ticks_u32;
+    timer_xp->active_bol = false;
+    return(pdPASS);
+}
+
+BaseType_t xTimerReset(TimerHandle_t timer_xp, TickType_t ticks_u32)
+{
+    return(xTimerStart(timer_xp, ticks_u32));
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer_xp, TickType_t period_u32,
+                                TickType_t ticks_u32)
+{
+    timer_xp->period_u32 = period_u32;
+    return(xTimerStart(timer_xp, ticks_u32));
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer_xp)
+{
+    return((true == timer_xp->active_bol) ? pdTRUE : pdFALSE);
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer_xp)
+{
+    return(timer_xp->id_vp);
+}
+
+/* test control *********************************************************************/
+
+/* returns the timer created with the given name, NULL if there is none */
+static inline TimerHandle_t fake_FindTimer_xp(const char *name_cchp)
+{
+    TimerHandle_t timer_xp = NULL;
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < fake_timersNum_u8s; idx_u8++)
+    {
+        if(   (NULL != fake_timers_sspa[idx_u8]->name_cchp)
+           && (0 == strcmp(fake_timers_sspa[idx_u8]->name_cchp, name_cchp)))
+        {
+            timer_xp = fake_timers_sspa[idx_u8];
+        }
+    }
+    return(timer_xp);
+}
+
+/* deletes all timers like a power cycle, the handles of the modules become invalid */
+static inline void fake_TimersReset_vd(void)
+{
+    for(uint8_t idx_u8 = 0U; idx_u8 < fake_timersNum_u8s; idx_u8++)
+    {
+        free(fake_timers_sspa[idx_u8]);
+        fake_timers_sspa[idx_u8] = NULL;
+    }
+    fake_timersNum_u8s = 0U;
+}
+
+/* runs the callback of the timer as the timer daemon would */
+static inline void fake_FireTimer_vd(TimerHandle_t timer_xp)
+{
+    if((true == timer_xp->autoReload_bol) && (0U != timer_xp->period_u32))
+    {
+        timer_xp->expiry_u32 += timer_xp->period_u32;
+    }
+    else
+    {
+        timer_xp->active_bol = false;
+    }
+    timer_xp->callback_fp(timer_xp);
+}
+
+/* advances the clock, timers which expire on the way are fired in order */
+static inline void fake_AdvanceUs_vd(int64_t us_s64)
+{
+    int64_t end_s64 = fake_nowUs_s64 + us_s64;
+    const int64_t tickUs_s64 = 1000000 / configTICK_RATE_HZ;
+    TimerHandle_t next_xp;
+
+    do
+    {
+        next_xp = NULL;
+        for(uint8_t idx_u8 = 0U; idx_u8 < fake_timersNum_u8s; idx_u8++)
+        {
+            TimerHandle_t timer_xp = fake_timers_sspa[idx_u8];
+            if(   (true == timer_xp->active_bol)
+               && (end_s64 >= ((int64_t)timer_xp->expiry_u32 * tickUs_s64))
+               && ((NULL == next_xp) || (timer_xp->expiry_u32 < next_xp->expiry_u32)))
+            {
+                next_xp = timer_xp;
+            }
+        }
+        if(NULL != next_xp)
+        {
+            if(fake_nowUs_s64 < ((int64_t)next_xp->expiry_u32 * tickUs_s64))
+            {
+                fake_nowUs_s64 = (int64_t)next_xp->expiry_u32 * tickUs_s64;
+            }
+            fake_FireTimer_vd(next_xp);
+        }
+    } while(NULL != next_xp);
+    fake_nowUs_s64 = end_s64;
+}
+
+static inline void fake_AdvanceMs_vd(uint32_t ms_u32)
+{
+    fake_AdvanceUs_vd((int64_t)ms_u32 * 1000);
+}
+
+void vTaskDelay(TickType_t ticks_u32)
+{
+    fake_AdvanceUs_vd((int64_t)ticks_u32 * (1000000 / configTICK_RATE_HZ));
+}
+
+/* returns the entry function of the task created with the given name */
+static inline TaskFunction_t fake_FindTask_fp(const char *name_cchp)
+{
+    TaskFunction_t task_fp = NULL;
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < fake_tasksNum_u8s; idx_u8++)
+    {
+        if(0 == strcmp(fake_tasks_ssa[idx_u8].name_cchp, name_cchp))
+        {
+            task_fp = fake_tasks_ssa[idx_u8].task_fp;
+        }
+    }
+    return(task_fp);
+}
+
+#endif
@@ -0,0 +1,239 @@
+/*****************************************************************************************
+* FILENAME :        fake_mqtt.h
+*
+* DESCRIPTION :
+*       Host implementation of the esp-mqtt client. Publications are recorded and get
+*       a message id, the broker acknowledge of QoS 1/2 publications is delivered to
+*       the event handler after fake_mqttAckLatencyUs_u32 when the test calls
+*       fake_MqttDeliverAcks_u32. With fake_mqttAckInPublish_bol the acknowledge
+*       arrives before esp_mqtt_client_publish returns, as it can happen on the target
+*       when the mqtt task preempts the publishing task.
+*
+*****************************************************************************************/
+#ifndef FAKE_MQTT_H
+#define FAKE_MQTT_H
+
+#include "fake_esp.h"
+#include "mqtt_client.h"
+
+#define FAKE_MQTT_LOG_NUM       64U     // publications kept for inspection
+#define FAKE_MQTT_ACKS_NUM      64U     // acknowledges in flight
+#define FAKE_MQTT_TOPIC_SIZE    128U
+#define FAKE_MQTT_DATA_SIZE     512U
+
+typedef struct fake_mqttPub_tag
+{
+    char topic_ca[FAKE_MQTT_TOPIC_SIZE];
+    char data_ca[FAKE_MQTT_DATA_SIZE];
+    int len_s32;
+    int qos_s32;
+    int retain_s32;
+    int msgId_s32;
+}fake_mqttPub_t;
+
+typedef struct fake_mqttAck_tag
+{
+    int msgId_s32;
+    int64_t dueUs_s64;
+}fake_mqttAck_t;
+
+struct esp_mqtt_client
+{
+    esp_mqtt_client_config_t config_st;
+    bool started_bol;
+};
+
+static struct esp_mqtt_client fake_mqttClient_sst;
+
+uint32_t fake_mqttPublishCalls_u32 = 0U;
+uint32_t fake_mqttPublishBytes_u32 = 0U;        // topic and data bytes
+uint32_t fake_mqttSubscribeCalls_u32 = 0U;
+uint32_t fake_mqttAckLatencyUs_u32 = 20000U;
+bool fake_mqttAckInPublish_bol = false;
+bool fake_mqttPublishFail_bol = false;
+fake_mqttPub_t fake_mqttLog_sta[FAKE_MQTT_LOG_NUM];
+static int fake_mqttNextId_s32s = 1;
+static fake_mqttAck_t fake_mqttAcks_ssa[FAKE_MQTT_ACKS_NUM];
+static uint32_t fake_mqttAcksNum_u32s = 0U;
+
+/* sends one event to the handler of the client */
+static inline void fake_MqttEvent_vd(esp_mqtt_event_id_t id_en, int msgId_s32)
+{
+    esp_mqtt_event_t event_st;
+
+    memset(&event_st, 0, sizeof(event_st));
+    event_st.event_id = id_en;
+    event_st.client = &fake_mqttClient_sst;
+    event_st.msg_id = msgId_s32;
+    if(NULL != fake_mqttClient_sst.config_st.event_handle)
+    {
+        (void)fake_mqttClient_sst.config_st.event_handle(&event_st);
+    }
+}
+
+/* sends one data event, a fragment of total_s32 bytes starting at offset_s32 */
+static inline void fake_MqttData_vd(const char *topic_cchp, const char *data_cchp,
+                                    int len_s32, int offset_s32, int total_s32)
+{
+    esp_mqtt_event_t event_st;
+
+    memset(&event_st, 0, sizeof(event_st));
+    event_st.event_id = MQTT_EVENT_DATA;
+    event_st.client = &fake_mqttClient_sst;
+    // esp-mqtt only reports the topic with the first fragment
+    event_st.topic = (0 == offset_s32) ? (char *)topic_cchp : NULL;
+    event_st.topic_len = (0 == offset_s32) ? (int)strlen(topic_cchp) : 0;
+    event_st.data = (char *)data_cchp;
+    event_st.data_len = len_s32;
+    event_st.current_data_offset = offset_s32;
+    event_st.total_data_len = total_s32;
+    (void)fake_mqttClient_sst.config_st.event_handle(&event_st);
+}
+
+/* delivers the acknowledges which are due at the current time, returns the number */
+static inline uint32_t fake_MqttDeliverAcks_u32(void)
+{
+    uint32_t delivered_u32 = 0U;
+    uint32_t idx_u32 = 0U;
+    int msgId_s32;
+
+    while(idx_u32 < fake_mqttAcksNum_u32s)
+    {
+        if(fake_nowUs_s64 >= fake_mqttAcks_ssa[idx_u32].dueUs_s64)
+        {
+            msgId_s32 = fake_mqttAcks_ssa[idx_u32].msgId_s32;
+            fake_mqttAcksNum_u32s--;
+            memmove(&fake_mqttAcks_ssa[idx_u32], &fake_mqttAcks_ssa[idx_u32 + 1U],
+                    (fake_mqttAcksNum_u32s - idx_u32) * sizeof(fake_mqttAck_t));
+            fake_MqttEvent_vd(MQTT_EVENT_PUBLISHED, msgId_s32);
+            delivered_u32++;
+        }
+        else
+        {
+            idx_u32++;
+        }
+    }
+    return(delivered_u32);
+}
+
+/* drops the acknowledges in flight, as a broker connection loss does */
+static inline void fake_MqttDropAcks_vd(void)
+{
+    fake_mqttAcksNum_u32s = 0U;
+}
+
+static inline uint32_t fake_MqttAcksInFlight_u32(void)
+{
+    return(fake_mqttAcksNum_u32s);
+}
+
+/* resets the counters and the publication log */
+static inline void fake_MqttReset_vd(void)
+{
+    fake_mqttPublishCalls_u32 = 0U;
+    fake_mqttPublishBytes_u32 = 0U;
+    fake_mqttSubscribeCalls_u32 = 0U;
+    fake_mqttAcksNum_u32s = 0U;
+    fake_mqttAckInPublish_bol = false;
+    fake_mqttPublishFail_bol = false;
+    memset(fake_mqttLog_sta, 0, sizeof(fake_mqttLog_sta));
+}
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config_cstp)
+{
+    fake_mqttClient_sst.config_st = *config_cstp;
+    fake_mqttClient_sst.started_bol = false;
+    return(&fake_mqttClient_sst);
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client_xp)
+{
+    client_xp->started_bol = true;
+    return(ESP_OK);
+}
+
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client_xp)
+{
+    client_xp->started_bol = false;
+    return(ESP_OK);
+}
+
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client_xp)
+{
+    (void)client_xp;
+    return(ESP_OK);
+}
+
+int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client_xp, const char *topic_cchp,
+                                int qos_s32)
+{
+    (void)client_xp;
+    (void)topic_cchp;
+    (void)qos_s32;
+    fake_mqttSubscribeCalls_u32++;
+    return(0);
+}
+
+int esp_mqtt_client_unsubscribe(esp_mqtt_client_handle_t client_xp, 
+                                const char *topic_cchp)
+{
+    (void)client_xp;
+    (void)topic_cchp;
+    return(0);
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client_xp, const char *topic_cchp, 
+                            const char *data_cchp, int len_s32, int qos_s32, 
+                            int retain_s32)
+{
+    int msgId_s32 = -1;
+    fake_mqttPub_t *pub_stp;
+
+    (void)client_xp;
+    if(false == fake_mqttPublishFail_bol)
+    {
+        // esp-mqtt returns 0 for QoS 0 publications, they are never acknowledged
+        msgId_s32 = 0;
+        if(0 != qos_s32)
+        {
+            msgId_s32 = fake_mqttNextId_s32s;
+            fake_mqttNextId_s32s = (65535 == fake_mqttNextId_s32s) ? 
+                                        1 : (fake_mqttNextId_s32s + 1);
+        }
+
+        pub_stp = &fake_mqttLog_sta[fake_mqttPublishCalls_u32 % FAKE_MQTT_LOG_NUM];
+        snprintf(pub_stp->topic_ca, sizeof(pub_stp->topic_ca), "%s", topic_cchp);
+        snprintf(pub_stp->data_ca, sizeof(pub_stp->data_ca), "%.*s", len_s32, data_cchp);
+        pub_stp->len_s32 = len_s32;
+        pub_stp->qos_s32 = qos_s32;
+        pub_stp->retain_s32 = retain_s32;
+        pub_stp->msgId_s32 = msgId_s32;
+        fake_mqttPublishCalls_u32++;
+        fake_mqttPublishBytes_u32 += (uint32_t)strlen(topic_cchp) + (uint32_t)len_s32;
+
+        if(0 != msgId_s32)
+        {
+            if(true == fake_mqttAckInPublish_bol)
+            {
+                fake_MqttEvent_vd(MQTT_EVENT_PUBLISHED, msgId_s32);
+            }
+            else if(FAKE_MQTT_ACKS_NUM > fake_mqttAcksNum_u32s)
+            {
+                fake_mqttAcks_ssa[fake_mqttAcksNum_u32s].msgId_s32 = msgId_s32;
+                fake_mqttAcks_ssa[fake_mqttAcksNum_u32s].dueUs_s64 = 
+                                        fake_nowUs_s64 + fake_mqttAckLatencyUs_u32;
+                fake_mqttAcksNum_u32s++;
+            }
+        }
+    }
+    return(msgId_s32);
+}
+
+/* returns the n-th last publication, 0 is the newest one */
+static inline const fake_mqttPub_t *fake_MqttLastPub_cstp(uint32_t back_u32)
+{
+    return(&fake_mqttLog_sta[(fake_mqttPublishCalls_u32 - 1U - back_u32) 
+                                % FAKE_MQTT_LOG_NUM]);
+}
+
+#endif
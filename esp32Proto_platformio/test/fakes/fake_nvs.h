@@ -0,0 +1,189 @@
+/*****************************************************************************************
+* FILENAME :        fake_nvs.h
+*
+* DESCRIPTION :
+*       Host implementation of the nvs blob interface. The blobs are held in ram and
+*       survive a re-initialization of the modules, so a test can simulate a reboot.
+*       Every nvs_set_blob and nvs_commit is counted, fake_NvsResetCounters_vd starts
+*       a new boot for the counters without touching the stored blobs.
+*
+*****************************************************************************************/
+#ifndef FAKE_NVS_H
+#define FAKE_NVS_H
+
+#include "fake_esp.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+
+#define FAKE_NVS_ENTRIES_NUM    64U
+#define FAKE_NVS_KEY_SIZE       16U     // 15 characters and the terminator
+#define FAKE_NVS_BLOB_SIZE      4096U
+
+typedef struct fake_nvsEntry_tag
+{
+    char key_ca[FAKE_NVS_KEY_SIZE];
+    uint8_t data_u8a[FAKE_NVS_BLOB_SIZE];
+    size_t length_st;
+    bool used_bol;
+}fake_nvsEntry_t;
+
+fake_nvsEntry_t fake_nvsEntries_sta[FAKE_NVS_ENTRIES_NUM];
+uint32_t fake_nvsGetCalls_u32 = 0U;
+uint32_t fake_nvsSetCalls_u32 = 0U;
+uint32_t fake_nvsSetBytes_u32 = 0U;
+uint32_t fake_nvsCommits_u32 = 0U;
+uint32_t fake_nvsOpens_u32 = 0U;
+bool fake_nvsSetFail_bol = false;
+
+static inline fake_nvsEntry_t *fake_NvsFind_stp(const char *key_cchp)
+{
+    fake_nvsEntry_t *entry_stp = NULL;
+
+    for(uint32_t idx_u32 = 0U; (NULL == entry_stp) && (FAKE_NVS_ENTRIES_NUM > idx_u32);
+        idx_u32++)
+    {
+        if(   (true == fake_nvsEntries_sta[idx_u32].used_bol)
+           && (0 == strcmp(fake_nvsEntries_sta[idx_u32].key_ca, key_cchp)))
+        {
+            entry_stp = &fake_nvsEntries_sta[idx_u32];
+        }
+    }
+    return(entry_stp);
+}
+
+/* starts the counters of a new boot, the stored blobs are kept */
+static inline void fake_NvsResetCounters_vd(void)
+{
+    fake_nvsGetCalls_u32 = 0U;
+    fake_nvsSetCalls_u32 = 0U;
+    fake_nvsSetBytes_u32 = 0U;
+    fake_nvsCommits_u32 = 0U;
+    fake_nvsOpens_u32 = 0U;
+    fake_nvsSetFail_bol = false;
+}
+
+/* erases all blobs and resets the counters */
+static inline void fake_NvsReset_vd(void)
+{
+    memset(fake_nvsEntries_sta, 0, sizeof(fake_nvsEntries_sta));
+    fake_NvsResetCounters_vd();
+}
+
+/* stores a blob without counting it, for prepared flash contents of older firmware */
+static inline void fake_NvsPut_vd(const char *key_cchp, const void *data_cvp,
+                                    size_t length_st)
+{
+    fake_nvsEntry_t *entry_stp = fake_NvsFind_stp(key_cchp);
+
+    for(uint32_t idx_u32 = 0U; (NULL == entry_stp) && (FAKE_NVS_ENTRIES_NUM > idx_u32);
+        idx_u32++)
+    {
+        if(false == fake_nvsEntries_sta[idx_u32].used_bol)
+        {
+            entry_stp = &fake_nvsEntries_sta[idx_u32];
+            snprintf(entry_stp->key_ca, sizeof(entry_stp->key_ca), "%s", key_cchp);
+            entry_stp->used_bol = true;
+        }
+    }
+    memcpy(entry_stp->data_u8a, data_cvp, length_st);
+    entry_stp->length_st = length_st;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    return(ESP_OK);
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    memset(fake_nvsEntries_sta, 0, sizeof(fake_nvsEntries_sta));
+    return(ESP_OK);
+}
+
+esp_err_t nvs_open(const char *name_cchp, nvs_open_mode mode_en, nvs_handle *handle_xp)
+{
+    (void)name_cchp;
+    (void)mode_en;
+    fake_nvsOpens_u32++;
+    *handle_xp = 1U;
+    return(ESP_OK);
+}
+
+void nvs_close(nvs_handle handle_x)
+{
+    (void)handle_x;
+}
+
+esp_err_t nvs_get_blob(nvs_handle handle_x, const char *key_cchp, void *out_vp,
+                        size_t *length_stp)
+{
+    esp_err_t result_st = ESP_ERR_NVS_NOT_FOUND;
+    fake_nvsEntry_t *entry_stp = fake_NvsFind_stp(key_cchp);
+
+    (void)handle_x;
+    fake_nvsGetCalls_u32++;
+    if(NULL != entry_stp)
+    {
+        // like nvs a NULL buffer only returns the length of the blob
+        result_st = ESP_OK;
+        if((NULL != out_vp) && (*length_stp < entry_stp->length_st))
+        {
+            result_st = ESP_ERR_NVS_INVALID_LENGTH;
+        }
+        else if(NULL != out_vp)
+        {
+            memcpy(out_vp, entry_stp->data_u8a, entry_stp->length_st);
+        }
+        *length_stp = entry_stp->length_st;
+    }
+    return(result_st);
+}
+
+esp_err_t nvs_set_blob(nvs_handle handle_x, const char *key_cchp, const void *value_cvp,
+                        size_t length_st)
+{
+    esp_err_t result_st = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+
+    (void)handle_x;
+    if(FAKE_NVS_KEY_SIZE <= strlen(key_cchp))
+    {
+        result_st = ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+    else if((false == fake_nvsSetFail_bol) && (FAKE_NVS_BLOB_SIZE >= length_st))
+    {
+        fake_NvsPut_vd(key_cchp, value_cvp, length_st);
+        fake_nvsSetCalls_u32++;
+        fake_nvsSetBytes_u32 += (uint32_t)length_st;
+        result_st = ESP_OK;
+    }
+    return(result_st);
+}
+
+esp_err_t nvs_erase_key(nvs_handle handle_x, const char *key_cchp)
+{
+    esp_err_t result_st = ESP_ERR_NVS_NOT_FOUND;
+    fake_nvsEntry_t *entry_stp = fake_NvsFind_stp(key_cchp);
+
+    (void)handle_x;
+    if(NULL != entry_stp)
+    {
+        entry_stp->used_bol = false;
+        result_st = ESP_OK;
+    }
+    return(result_st);
+}
+
+esp_err_t nvs_erase_all(nvs_handle handle_x)
+{
+    (void)handle_x;
+    return(nvs_flash_erase());
+}
+
+esp_err_t nvs_commit(nvs_handle handle_x)
+{
+    (void)handle_x;
+    fake_nvsCommits_u32++;
+    return(ESP_OK);
+}
+
+#endif
@@ -0,0 +1,248 @@
+/*****************************************************************************************
+* FILENAME :        fake_partition.h
+*
+* DESCRIPTION :
+*       Host implementation of the esp_partition interface with the behaviour of nor
+*       flash: erased bytes read 0xFF, a write can only clear bits and a sector is
+*       erased as a whole. The data partitions "offbuf" and "paramlog" are known, their
+*       size is set by the test before the module is initialized. Erases and written
+*       bytes are counted per partition and sector. A power loss is simulated with a
+*       write budget, the flash image can be stored in and loaded from a file.
+*
+*****************************************************************************************/
+#ifndef FAKE_PARTITION_H
+#define FAKE_PARTITION_H
+
+#include "fake_esp.h"
+#include "esp_partition.h"
+
+#define FAKE_PART_SECTOR_SIZE   4096U
+#define FAKE_PART_MAX_SIZE      (64U * FAKE_PART_SECTOR_SIZE)
+#define FAKE_PART_SECTORS_NUM   (FAKE_PART_MAX_SIZE / FAKE_PART_SECTOR_SIZE)
+#define FAKE_PART_NUM           2U
+
+typedef struct fake_part_tag
+{
+    esp_partition_t part_st;
+    bool present_bol;
+    uint8_t flash_u8a[FAKE_PART_MAX_SIZE];
+    uint32_t erases_u32a[FAKE_PART_SECTORS_NUM];
+    uint32_t writes_u32;            // calls of esp_partition_write
+    uint32_t writtenBytes_u32;
+    uint32_t reads_u32;
+    uint32_t programErrors_u32;     // writes which would have to set a cleared bit
+}fake_part_t;
+
+fake_part_t fake_parts_sta[FAKE_PART_NUM] =
+{
+    {.part_st = {.type = ESP_PARTITION_TYPE_DATA, .subtype = (esp_partition_subtype_t)0x40,
+                 .address = 0x310000U, .size = 0U, .label = "offbuf"}},
+    {.part_st = {.type = ESP_PARTITION_TYPE_DATA, .subtype = (esp_partition_subtype_t)0x41,
+                 .address = 0x350000U, .size = 0U, .label = "paramlog"}},
+};
+
+// bytes which are still programmed before the power fails, negative: no power loss
+int32_t fake_partWriteBudget_s32 = -1;
+bool fake_partPowerLost_bol = false;
+
+static inline fake_part_t *fake_PartGet_stp(const char *label_cchp)
+{
+    fake_part_t *part_stp = NULL;
+
+    for(uint32_t idx_u32 = 0U; (NULL == part_stp) && (FAKE_PART_NUM > idx_u32); idx_u32++)
+    {
+        if(0 == strcmp(fake_parts_sta[idx_u32].part_st.label, label_cchp))
+        {
+            part_stp = &fake_parts_sta[idx_u32];
+        }
+    }
+    return(part_stp);
+}
+
+/* creates an erased partition of size_u32 bytes, 0 removes the partition */
+static inline void fake_PartSetup_vd(const char *label_cchp, uint32_t size_u32)
+{
+    fake_part_t *part_stp = fake_PartGet_stp(label_cchp);
+
+    memset(part_stp->flash_u8a, 0xFF, sizeof(part_stp->flash_u8a));
+    memset(part_stp->erases_u32a, 0, sizeof(part_stp->erases_u32a));
+    part_stp->writes_u32 = 0U;
+    part_stp->writtenBytes_u32 = 0U;
+    part_stp->reads_u32 = 0U;
+    part_stp->programErrors_u32 = 0U;
+    part_stp->part_st.size = size_u32;
+    part_stp->present_bol = (0U != size_u32);
+    fake_partWriteBudget_s32 = -1;
+    fake_partPowerLost_bol = false;
+}
+
+/* power returns, the flash content is kept */
+static inline void fake_PartPowerOn_vd(void)
+{
+    fake_partWriteBudget_s32 = -1;
+    fake_partPowerLost_bol = false;
+}
+
+static inline uint32_t fake_PartErases_u32(const char *label_cchp)
+{
+    fake_part_t *part_stp = fake_PartGet_stp(label_cchp);
+    uint32_t erases_u32 = 0U;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < FAKE_PART_SECTORS_NUM; idx_u32++)
+    {
+        erases_u32 += part_stp->erases_u32a[idx_u32];
+    }
+    return(erases_u32);
+}
+
+static inline uint32_t fake_PartMaxSectorErases_u32(const char *label_cchp)
+{
+    fake_part_t *part_stp = fake_PartGet_stp(label_cchp);
+    uint32_t max_u32 = 0U;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < FAKE_PART_SECTORS_NUM; idx_u32++)
+    {
+        max_u32 = (part_stp->erases_u32a[idx_u32] > max_u32) ?
+                        part_stp->erases_u32a[idx_u32] : max_u32;
+    }
+    return(max_u32);
+}
+
+/* stores the flash image of a partition in a file */
+static inline bool fake_PartSave_bol(const char *label_cchp, const char *path_cchp)
+{
+    fake_part_t *part_stp = fake_PartGet_stp(label_cchp);
+    FILE *file_xp = fopen(path_cchp, "wb");
+    bool saved_bol = false;
+
+    if(NULL != file_xp)
+    {
+        saved_bol = (part_stp->part_st.size == fwrite(part_stp->flash_u8a, 1U,
+                                                        part_stp->part_st.size, file_xp));
+        fclose(file_xp);
+    }
+    return(saved_bol);
+}
+
+/* loads the flash image of a partition from a file, the counters are kept */
+static inline bool fake_PartLoad_bol(const char *label_cchp, const char *path_cchp)
+{
+    fake_part_t *part_stp = fake_PartGet_stp(label_cchp);
+    FILE *file_xp = fopen(path_cchp, "rb");
+    bool loaded_bol = false;
+
+    if(NULL != file_xp)
+    {
+        loaded_bol = (part_stp->part_st.size == fread(part_stp->flash_u8a, 1U,
+                                                        part_stp->part_st.size, file_xp));
+        fclose(file_xp);
+    }
+    return(loaded_bol);
+}
+
+static inline fake_part_t *fake_PartOf_stp(const esp_partition_t *part_cstp)
+{
+    return((fake_part_t *)((const uint8_t *)part_cstp - offsetof(fake_part_t, part_st)));
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type_en,
+                                                esp_partition_subtype_t sub_en,
+                                                const char *label_cchp)
+{
+    const esp_partition_t *found_cstp = NULL;
+    fake_part_t *part_stp;
+
+    for(uint32_t idx_u32 = 0U; (NULL == found_cstp) && (FAKE_PART_NUM > idx_u32); idx_u32++)
+    {
+        part_stp = &fake_parts_sta[idx_u32];
+        if(   (true == part_stp->present_bol) && (type_en == part_stp->part_st.type)
+           && (   (ESP_PARTITION_SUBTYPE_ANY == sub_en)
+               || (sub_en == part_stp->part_st.subtype))
+           && ((NULL == label_cchp) || (0 == strcmp(label_cchp, part_stp->part_st.label))))
+        {
+            found_cstp = &part_stp->part_st;
+        }
+    }
+    return(found_cstp);
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part_cstp, size_t offset_st,
+                                void *dst_vp, size_t size_st)
+{
+    esp_err_t result_st = ESP_ERR_INVALID_SIZE;
+    fake_part_t *part_stp = fake_PartOf_stp(part_cstp);
+
+    if((offset_st + size_st) <= part_cstp->size)
+    {
+        memcpy(dst_vp, &part_stp->flash_u8a[offset_st], size_st);
+        part_stp->reads_u32++;
+        result_st = ESP_OK;
+    }
+    return(result_st);
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *part_cstp, size_t offset_st,
+                                const void *src_cvp, size_t size_st)
+{
+    esp_err_t result_st = ESP_ERR_INVALID_SIZE;
+    fake_part_t *part_stp = fake_PartOf_stp(part_cstp);
+    const uint8_t *src_cu8p = (const uint8_t *)src_cvp;
+    uint8_t *dst_u8p;
+
+    if((offset_st + size_st) <= part_cstp->size)
+    {
+        result_st = ESP_OK;
+        part_stp->writes_u32++;
+        for(size_t idx_st = 0U; (ESP_OK == result_st) && (idx_st < size_st); idx_st++)
+        {
+            if(0 == fake_partWriteBudget_s32)
+            {
+                fake_partPowerLost_bol = true;
+                result_st = ESP_FAIL;
+            }
+            else
+            {
+                fake_partWriteBudget_s32 -= (0 < fake_partWriteBudget_s32) ? 1 : 0;
+                dst_u8p = &part_stp->flash_u8a[offset_st + idx_st];
+                if(src_cu8p[idx_st] != (*dst_u8p & src_cu8p[idx_st]))
+                {
+                    part_stp->programErrors_u32++;
+                }
+                *dst_u8p &= src_cu8p[idx_st];
+                part_stp->writtenBytes_u32++;
+            }
+        }
+    }
+    return(result_st);
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *part_cstp, size_t offset_st,
+                                    size_t size_st)
+{
+    esp_err_t result_st = ESP_ERR_INVALID_SIZE;
+    fake_part_t *part_stp = fake_PartOf_stp(part_cstp);
+
+    if(   (0U == (offset_st % FAKE_PART_SECTOR_SIZE))
+       && (0U == (size_st % FAKE_PART_SECTOR_SIZE))
+       && ((offset_st + size_st) <= part_cstp->size))
+    {
+        result_st = ESP_OK;
+        if(0 == fake_partWriteBudget_s32)
+        {
+            fake_partPowerLost_bol = true;
+            result_st = ESP_FAIL;
+        }
+        else
+        {
+            memset(&part_stp->flash_u8a[offset_st], 0xFF, size_st);
+            for(size_t sec_st = offset_st / FAKE_PART_SECTOR_SIZE;
+                sec_st < ((offset_st + size_st) / FAKE_PART_SECTOR_SIZE); sec_st++)
+            {
+                part_stp->erases_u32a[sec_st]++;
+            }
+        }
+    }
+    return(result_st);
+}
+
+#endif
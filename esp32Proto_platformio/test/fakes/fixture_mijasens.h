@@ -0,0 +1,124 @@
+/*****************************************************************************************
+* FILENAME :        fixture_mijasens.h
+*
+* DESCRIPTION :
+*       Shared fixture of the mijasens tests, included after mijasens.c. It boots the
+*       module once with the parameter interface on the fakes, runs one pass of the
+*       module task and lets the simulated sensors send their samples. The suites keep
+*       their own publish handler and reset the state they look at in setUp.
+*
+*****************************************************************************************/
+#ifndef FIXTURE_MIJASENS_H
+#define FIXTURE_MIJASENS_H
+
+bool fixture_booted_bol = false;
+bool fixture_flushRequest_bol = false;
+
+/* the commit timer of paramif requests the flush, done by the control task */
+static inline void fixture_FlushRequest_vd(void)
+{
+    fixture_flushRequest_bol = true;
+}
+
+/* the module registers its decoders and commands once, like after a boot */
+static inline void fixture_Boot_vd(mqttif_Publish_td publish_fp)
+{
+    paramif_param_t paramifPara_st;
+    mijasens_param_t para_st;
+
+    if(false == fixture_booted_bol)
+    {
+        fake_NvsReset_vd();
+        fake_PartSetup_vd("paramlog", 0U);
+        fake_PartSetup_vd("offbuf", 0U);
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeParameter_td(&paramifPara_st));
+        paramifPara_st.flushRequest_fp = fixture_FlushRequest_vd;
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Initialize_td(&paramifPara_st));
+        TEST_ASSERT_EQUAL(ESP_OK, mijasens_InitializeParameter_st(&para_st));
+        para_st.publishHandler_fp = publish_fp;
+        para_st.deviceName_chp = "dev";
+        para_st.id_u8 = 1U;
+        TEST_ASSERT_EQUAL(ESP_OK, mijasens_Initialize_st(&para_st));
+        fixture_booted_bol = true;
+    }
+    fixture_flushRequest_bol = false;
+}
+
+/* one pass of the module task, the bits are handled like in Task_vd without the
+   publication of the latency statistics */
+static inline void fixture_RunTask_vd(void)
+{
+    EventBits_t bits_u32 = xEventGroupWaitBits(this_sst.eventGroup_st,
+                                MQTT_CONNECT | MQTT_DISCONNECT | BLE_DATA_EVENT
+                                | CYCLE_TIMER | REPLAY_TIMER | REGISTRY_EVENT
+                                | SENSOR_RESET, true, false, 0U);
+
+    xSemaphoreTake(this_sst.sensMutex_st, portMAX_DELAY);
+    if(0U != (bits_u32 & MQTT_CONNECT))
+    {
+        StartReplay_vd();
+    }
+    if(0U != (bits_u32 & BLE_DATA_EVENT))
+    {
+        HandleRingEvent_vd();
+    }
+    if(0U != (bits_u32 & CYCLE_TIMER))
+    {
+        RunPublishScheduler_vd();
+        SaveRegistry_vd(false);
+    }
+    if(0U != (bits_u32 & REPLAY_TIMER))
+    {
+        ReplaySamples_vd();
+    }
+    if(0U != (bits_u32 & REGISTRY_EVENT))
+    {
+        HandleRegistryEvent_vd();
+    }
+    if(0U != (bits_u32 & SENSOR_RESET))
+    {
+        ResetSensors_vd();
+        ApplyRegistry_vd();
+    }
+    xSemaphoreGive(this_sst.sensMutex_st);
+
+    if(true == fixture_flushRequest_bol)
+    {
+        fixture_flushRequest_bol = false;
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    }
+}
+
+/* advances the clock in scheduler ticks and runs the task after every tick */
+static inline void fixture_RunFor_vd(uint32_t ms_u32)
+{
+    for(uint32_t idx_u32 = 0U; idx_u32 < (ms_u32 / SCHED_TICK_MS); idx_u32++)
+    {
+        fake_AdvanceMs_vd(SCHED_TICK_MS);
+        fixture_RunTask_vd();
+    }
+}
+
+/* a sensor sends a combined temperature and humidity sample and its battery, the
+   samples wait in the ring for the next pass of the task */
+static inline void fixture_SendSample_vd(uint8_t sens_u8, uint8_t msgCnt_u8,
+                                            int16_t temp_s16, uint16_t hum_u16,
+                                            uint8_t batt_u8)
+{
+    mijaProcl_rawSample_t raw_st;
+
+    memset(&raw_st, 0, sizeof(raw_st));
+    raw_st.macAddr_u8a[0] = 0xA4;
+    raw_st.macAddr_u8a[1] = 0xC1;
+    raw_st.macAddr_u8a[5] = sens_u8;
+    raw_st.msgCnt_u8 = msgCnt_u8;
+    raw_st.dataType_u8 = mija_TYPE_TEMPHUM;
+    raw_st.value1_u16 = (uint16_t)temp_s16;
+    raw_st.value2_u16 = hum_u16;
+    DriverCallback_vd(&raw_st);
+    raw_st.dataType_u8 = mija_TYPE_BATTERY;
+    raw_st.value1_u16 = batt_u8;
+    DriverCallback_vd(&raw_st);
+}
+
+#endif
@@ -0,0 +1,138 @@
+/*****************************************************************************************
+* FILENAME :        fuzz_mijaProcl.c
+*
+* DESCRIPTION :
+*       Fuzz target of the mija advertisement parser. Built with -fsanitize=fuzzer and
+*       -D FUZZ_LIBFUZZER for libFuzzer, without it the main function runs the files
+*       given as arguments or stdin, which serves afl-fuzz and the replay of crash
+*       inputs.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fake_freertos.h"
+#include "fake_ccm.h"
+
+#include "mijaProcl.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define FUZZ_MAX_INPUT      255U        // the parser takes the length as uint8_t
+
+/****************************************************************************************/
+/* Local variables: */
+
+// the sensor with this address has a bindkey, so encrypted frames reach the decryption
+static const uint8_t FUZZ_MAC_CU8A[mija_SIZE_MAC_ADDR] =
+                                            {0xA4, 0xC1, 0x38, 0x00, 0x10, 0x01};
+static const uint8_t FUZZ_KEY_CU8A[mija_SIZE_BINDKEY] =
+{
+    0xE9, 0xEF, 0xAA, 0x68, 0x73, 0xF9, 0xF9, 0xC8,
+    0x7A, 0x5E, 0x75, 0xA5, 0xF8, 0x14, 0x80, 0x1C
+};
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* every entry point of the parser gets the input, the input is copied to a buffer of
+   its exact length so the address sanitizer reports reads behind the advertisement */
+int LLVMFuzzerTestOneInput(const uint8_t *data_cu8p, size_t size_x)
+{
+    static bool keySet_bols = false;
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    mijaProcl_parsedData_t parsed_st;
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+    uint8_t len_u8 = (uint8_t)((FUZZ_MAX_INPUT < size_x) ? FUZZ_MAX_INPUT : size_x);
+    uint8_t *adv_u8p = (uint8_t *)malloc((0U == len_u8) ? 1U : len_u8);
+    uint8_t samples_u8;
+    bool frameId_bol;
+
+    if(false == keySet_bols)
+    {
+        keySet_bols = mijaProcl_SetBindKey_bol(FUZZ_MAC_CU8A, FUZZ_KEY_CU8A);
+    }
+    memcpy(adv_u8p, data_cu8p, len_u8);
+
+    // the whole advertisement
+    frameId_bol = mijaProcl_GetFrameId_bol(adv_u8p, len_u8, &mac_u8a[0], &msgCnt_u8);
+    samples_u8 = mijaProcl_ParseRawSamples_u8(adv_u8p, len_u8, &sample_sta[0],
+                                                mija_MAX_OBJECTS);
+    if((mija_MAX_OBJECTS < samples_u8) || ((0U < samples_u8) && (false == frameId_bol)))
+    {
+        // samples of a frame without valid header
+        abort();
+    }
+    for(uint8_t idx_u8 = 0U; idx_u8 < samples_u8; idx_u8++)
+    {
+        (void)mijaProcl_ConvertRawSample_bol(&sample_sta[idx_u8], &parsed_st);
+    }
+    (void)mijaProcl_ParseMessage_bol(adv_u8p, len_u8, &parsed_st);
+
+    // the input as service data behind the uuid, as handed over by the ble driver
+    frameId_bol = mijaProcl_GetServiceFrameId_bol(adv_u8p, len_u8, NULL, &mac_u8a[0],
+                                                    &msgCnt_u8);
+    samples_u8 = mijaProcl_DecodeServiceData_u8(adv_u8p, len_u8, NULL, &sample_sta[0],
+                                                    mija_MAX_OBJECTS);
+    if((mija_MAX_OBJECTS < samples_u8) || ((0U < samples_u8) && (false == frameId_bol)))
+    {
+        abort();
+    }
+
+    free(adv_u8p);
+    return(0);
+}
+
+#ifndef FUZZ_LIBFUZZER
+/* replay and afl driver: runs the files given as arguments, or stdin without argument */
+int main(int argc, char **argv)
+{
+    static uint8_t buf_u8a[4096];
+    FILE *file_stp;
+    size_t len_x;
+
+    if(1 >= argc)
+    {
+        len_x = fread(buf_u8a, 1U, sizeof(buf_u8a), stdin);
+        (void)LLVMFuzzerTestOneInput(buf_u8a, len_x);
+    }
+    for(int arg_s32 = 1; arg_s32 < argc; arg_s32++)
+    {
+        file_stp = fopen(argv[arg_s32], "rb");
+        if(NULL != file_stp)
+        {
+            len_x = fread(buf_u8a, 1U, sizeof(buf_u8a), file_stp);
+            fclose(file_stp);
+            (void)LLVMFuzzerTestOneInput(buf_u8a, len_x);
+        }
+    }
+    return(0);
+}
+#endif
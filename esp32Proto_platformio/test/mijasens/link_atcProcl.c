@@ -0,0 +1 @@
+#include "atcProcl.c"
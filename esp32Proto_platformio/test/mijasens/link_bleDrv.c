@@ -0,0 +1 @@
+#include "bleDrv.c"
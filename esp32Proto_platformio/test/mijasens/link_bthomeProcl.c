@@ -0,0 +1 @@
+#include "bthomeProcl.c"
@@ -0,0 +1 @@
+#include "paramif.c"
@@ -0,0 +1 @@
+#include "paramlog.c"
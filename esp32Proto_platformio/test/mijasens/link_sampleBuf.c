@@ -0,0 +1 @@
+#include "sampleBuf.c"
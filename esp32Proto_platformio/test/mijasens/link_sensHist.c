@@ -0,0 +1 @@
+#include "sensHist.c"
@@ -0,0 +1,268 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the change triggered publication of mijasens with deadbands and
+*       the max silent interval, and of the bleDb console command. The benchmark replays
+*       an indoor day of all sensors and reports the publications with and without
+*       deadbands.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include <math.h>
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+#include "mijasens.c"
+#include "fixture_mijasens.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define SENSORS_NUM         MAX_MIJA_SENSORS
+#define SAMPLE_PERIOD_MS    10000U      // advertisement period of the simulated sensors
+#define TRACE_MS            (24U * 3600U * 1000U)
+#define DAY_S               86400.0
+
+/****************************************************************************************/
+/* Local variables: */
+
+static uint32_t pubCalls_u32s;
+static uint32_t seed_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static esp_err_t CountPublish_td(mqttif_msg_t *msg_stp, uint32_t wait_u32)
+{
+    (void)msg_stp;
+    (void)wait_u32;
+    pubCalls_u32s++;
+    return(ESP_OK);
+}
+
+/* a sensor sends a combined temperature and humidity sample and its battery */
+static void SendSample_vd(uint8_t sens_u8, uint8_t msgCnt_u8, int16_t temp_s16,
+                            uint16_t hum_u16, uint8_t batt_u8)
+{
+    fixture_SendSample_vd(sens_u8, msgCnt_u8, temp_s16, hum_u16, batt_u8);
+    fixture_RunTask_vd();
+}
+
+/* noise of the sensor, sum of uniform values, about normal with the given deviation */
+static double Noise_f64(double sigma_f64)
+{
+    double sum_f64 = 0.0;
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < 12U; idx_u8++)
+    {
+        seed_u32s = (seed_u32s * 1103515245U) + 12345U;
+        sum_f64 += (double)(seed_u32s >> 8) / 16777216.0;
+    }
+    return((sum_f64 - 6.0) * sigma_f64);
+}
+
+/* indoor day of the sensors: a daily swing of temperature and humidity with noise of
+   the sensor, quantized to 0.1, and the battery losing one percent at noon. Every
+   sensor has its own offset and phase. Returns the sensor publications of the day. */
+static uint32_t ReplayIndoorDay_u32(void)
+{
+    double time_f64;
+    double phase_f64;
+    int16_t temp_s16;
+    uint16_t hum_u16;
+    uint8_t msgCnt_u8 = 0U;
+
+    seed_u32s = 0x1DA7U;
+    this_sst.published_u32 = 0U;
+    for(uint32_t ms_u32 = 0U; ms_u32 < TRACE_MS; ms_u32 += SAMPLE_PERIOD_MS)
+    {
+        time_f64 = (double)ms_u32 / 1000.0;
+        for(uint8_t sens_u8 = 0U; sens_u8 < SENSORS_NUM; sens_u8++)
+        {
+            phase_f64 = 2.0 * M_PI * ((time_f64 / DAY_S) + (0.1 * sens_u8));
+            temp_s16 = (int16_t)lround(10.0 * (20.5 + sens_u8 + (1.5 * sin(phase_f64))
+                                                + Noise_f64(0.03)));
+            hum_u16 = (uint16_t)lround(10.0 * (48.0 - (4.0 * sin(phase_f64))
+                                                + Noise_f64(0.2)));
+            SendSample_vd(sens_u8, msgCnt_u8, temp_s16, hum_u16,
+                            (ms_u32 < (TRACE_MS / 2U)) ? 90U : 89U);
+        }
+        msgCnt_u8++;
+        fixture_RunFor_vd(SAMPLE_PERIOD_MS);
+    }
+    return(this_sst.published_u32);
+}
+
+void setUp(void)
+{
+    fixture_Boot_vd(CountPublish_td);
+
+    ResetSensors_vd();
+    memcpy(&this_sst.db_st, &DB_DEFAULT_PARA, sizeof(deadbandParam_t));
+    this_sst.pubMode_en = PUB_MODE_COMPACT;
+    this_sst.published_u32 = 0U;
+    this_sst.dbSuppressed_u32 = 0U;
+    OnConnectionHandler_vd();
+    (void)xEventGroupClearBits(this_sst.eventGroup_st, 0xFFFFFFU);
+    (void)xTimerStart(this_sst.cycleTimer_st, 0U);
+    pubCalls_u32s = 0U;
+}
+
+void tearDown(void)
+{
+    (void)xTimerStop(this_sst.cycleTimer_st, 0U);
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_ChangeBelowDeadbandIsSuppressed(void)
+{
+    SendSample_vd(0U, 1U, 215, 480U, 90U);
+    fixture_RunFor_vd(1000U);
+    TEST_ASSERT_EQUAL_UINT32(1U, pubCalls_u32s);
+
+    // half of the humidity deadband, the same temperature and battery
+    SendSample_vd(0U, 2U, 215, 485U, 90U);
+    fixture_RunFor_vd(1000U);
+    TEST_ASSERT_EQUAL_UINT32(1U, pubCalls_u32s);
+    TEST_ASSERT_EQUAL_UINT32(2U, this_sst.dbSuppressed_u32);
+
+    // a change of one step of the sensor resolution is within the deadband
+    SendSample_vd(0U, 3U, 214, 490U, 89U);
+    fixture_RunFor_vd(1000U);
+    TEST_ASSERT_EQUAL_UINT32(1U, pubCalls_u32s);
+
+    // compared with the published value, not with the last sample
+    SendSample_vd(0U, 4U, 215, 491U, 90U);
+    fixture_RunFor_vd(1000U);
+    TEST_ASSERT_EQUAL_UINT32(2U, pubCalls_u32s);
+    SendSample_vd(0U, 5U, 213, 491U, 90U);
+    fixture_RunFor_vd(1000U);
+    TEST_ASSERT_EQUAL_UINT32(3U, pubCalls_u32s);
+}
+
+static void test_SilentSensorIsRepublished(void)
+{
+    uint8_t msgCnt_u8 = 0U;
+
+    SendSample_vd(0U, msgCnt_u8++, 215, 480U, 90U);
+    fixture_RunFor_vd(1000U);
+    for(uint32_t ms_u32 = 1000U;
+        (ms_u32 + SAMPLE_PERIOD_MS) < (DB_DEFAULT_PARA.maxSilent_u32 * 1000U);
+        ms_u32 += SAMPLE_PERIOD_MS)
+    {
+        SendSample_vd(0U, msgCnt_u8++, 215, 480U, 90U);
+        fixture_RunFor_vd(SAMPLE_PERIOD_MS);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1U, pubCalls_u32s);
+    fixture_RunFor_vd(SAMPLE_PERIOD_MS);
+    TEST_ASSERT_EQUAL_UINT32(2U, pubCalls_u32s);
+}
+
+/* a deadband of the sensor replaces the default, 0 selects the default again */
+static void test_SensorDeadbandOverridesDefault(void)
+{
+    SendSample_vd(0U, 1U, 215, 480U, 90U);
+    SendSample_vd(1U, 1U, 215, 480U, 90U);
+    fixture_RunFor_vd(1000U);
+    TEST_ASSERT_EQUAL_UINT32(2U, pubCalls_u32s);
+
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleDb -w -x 0 -t 5", stdout));
+    TEST_ASSERT_EQUAL_UINT16(5U, this_sst.sensors_sta[0].para_st.dbTemp_u16);
+    SendSample_vd(0U, 2U, 218, 480U, 90U);
+    SendSample_vd(1U, 2U, 218, 480U, 90U);
+    fixture_RunFor_vd(1000U);
+    TEST_ASSERT_EQUAL_UINT32(3U, pubCalls_u32s);
+
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleDb -w -x 0 -t 0", stdout));
+    SendSample_vd(0U, 3U, 219, 480U, 90U);
+    fixture_RunFor_vd(1000U);
+    TEST_ASSERT_EQUAL_UINT32(4U, pubCalls_u32s);
+    TEST_ASSERT_EQUAL(1, fake_ConsoleRun_s32("bleDb -w -x 9 -t 5", stdout));
+}
+
+static void test_ConsoleStoresDefaults(void)
+{
+    deadbandParam_t stored_st;
+
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleDb -w -t 3 -u 20 -b 2 -s 600", stdout));
+    TEST_ASSERT_EQUAL_UINT32(3U, this_sst.db_st.temp_u32);
+    TEST_ASSERT_EQUAL_UINT32(20U, this_sst.db_st.hum_u32);
+    TEST_ASSERT_EQUAL_UINT32(2U, this_sst.db_st.batt_u32);
+    TEST_ASSERT_EQUAL_UINT32(600U, this_sst.db_st.maxSilent_u32);
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(this_sst.dbParam_xp, (uint8_t *)&stored_st));
+    TEST_ASSERT_EQUAL_MEMORY(&this_sst.db_st, &stored_st, sizeof(deadbandParam_t));
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleDb -r", stdout));
+
+    // all deadbands 0 restore the periodic publication
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleDb -w -t 0 -u 0 -b 0", stdout));
+    TEST_ASSERT_FALSE(DeadbandActive_bol());
+}
+
+/* messages of an indoor day with and without deadbands */
+static void test_BenchReplayIndoorDay(void)
+{
+    uint32_t periodic_u32;
+    uint32_t deadband_u32;
+    char line_ca[128];
+
+    memset(&this_sst.db_st, 0, sizeof(this_sst.db_st));
+    periodic_u32 = ReplayIndoorDay_u32();
+
+    setUp();
+    deadband_u32 = ReplayIndoorDay_u32();
+
+    snprintf(line_ca, sizeof(line_ca), "mijasens indoor day, %u sensors: %u publications "
+                "periodic, %u with deadbands, %.1f times less", SENSORS_NUM, periodic_u32,
+                deadband_u32, (double)periodic_u32 / (double)deadband_u32);
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+
+    // every sensor is published at least once per max silent interval
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(SENSORS_NUM * (TRACE_MS / 1000U)
+                                        / DB_DEFAULT_PARA.maxSilent_u32, deadband_u32);
+    TEST_ASSERT_LESS_THAN_UINT32(periodic_u32 / 5U, deadband_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ChangeBelowDeadbandIsSuppressed);
+    RUN_TEST(test_SilentSensorIsRepublished);
+    RUN_TEST(test_SensorDeadbandOverridesDefault);
+    RUN_TEST(test_ConsoleStoresDefaults);
+    RUN_TEST(test_BenchReplayIndoorDay);
+    return(UNITY_END());
+}
@@ -0,0 +1,295 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host test of the latency instrumentation of the data path from the gap callback
+*       to the broker acknowledge. Samples pass the ble driver stamps, the sample ring,
+*       the publish scheduler and an mqtt driver stand-in with fake time, the histograms
+*       of latStat are checked for their buckets and percentiles.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+#include "mijasens.c"
+#include "fixture_mijasens.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define PARSE_US            40U         // gap callback until decoded
+#define QUEUE_US            1500U       // waiting in the sample ring
+#define SCHED_US            20000U      // waiting for the publish scheduler
+#define PUBLISH_US          300U        // publish semaphore and hand over to mqtt
+#define ACK_US              80000U      // round trip to the broker
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* publication handed to the mqtt driver stand-in, waiting for the broker */
+typedef struct pendingAck_tag
+{
+    mqttif_Acked_td acked_fp;
+    uint32_t rxUs_u32;
+    uint32_t queuedUs_u32;
+}pendingAck_t;
+
+/****************************************************************************************/
+/* Local variables: */
+
+static pendingAck_t pending_sts;
+static char totalData_ca[mqttif_MAX_SIZE_OF_DATA + 1U];
+static uint32_t latTopics_u32s;
+static uint8_t temp_u8s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* mqtt driver stand-in: the hand over takes PUBLISH_US, the driver stamps the first
+   publication of a sample and resets the callback like mqttdrv does */
+static esp_err_t Publish_td(mqttif_msg_t *msg_stp, uint32_t wait_u32)
+{
+    (void)wait_u32;
+    fake_AdvanceUs_vd(PUBLISH_US);
+    if(NULL != msg_stp->acked_fp)
+    {
+        pending_sts.acked_fp = msg_stp->acked_fp;
+        pending_sts.rxUs_u32 = msg_stp->rxUs_u32;
+        pending_sts.queuedUs_u32 = latStat_Now_u32();
+        msg_stp->acked_fp = NULL;
+    }
+    if(NULL != strstr(msg_stp->topic_chp, "mija/lat/"))
+    {
+        latTopics_u32s++;
+    }
+    if(NULL != strstr(msg_stp->topic_chp, MQTT_PUB_LATENCY_CHPA[latStat_STAGE_TOTAL]))
+    {
+        memcpy(totalData_ca, msg_stp->data_chp, msg_stp->dataLen_u32);
+        totalData_ca[msg_stp->dataLen_u32] = '\0';
+    }
+    return(ESP_OK);
+}
+
+/* the broker acknowledges the pending publication after the given round trip */
+static void Ack_vd(uint32_t ackUs_u32)
+{
+    TEST_ASSERT_NOT_NULL(pending_sts.acked_fp);
+    fake_AdvanceUs_vd(ackUs_u32);
+    pending_sts.acked_fp(pending_sts.rxUs_u32, pending_sts.queuedUs_u32, 
+                            latStat_Now_u32());
+    pending_sts.acked_fp = NULL;
+}
+
+/* one sample through the pipeline with fake time: the ble driver stamps reception and
+   decoding, the task drains the ring and the scheduler publishes the change */
+static void RunSample_vd(uint32_t queueUs_u32, uint32_t schedUs_u32)
+{
+    mijaProcl_rawSample_t raw_st;
+
+    memset(&raw_st, 0, sizeof(raw_st));
+    raw_st.macAddr_u8a[0] = 0xA4;
+    raw_st.macAddr_u8a[1] = 0xC1;
+    raw_st.msgCnt_u8 = temp_u8s;
+    raw_st.dataType_u8 = mija_TYPE_TEMPHUM;
+    // every sample exceeds the deadband, the scheduler publishes it without delay
+    raw_st.value1_u16 = 200U + ((temp_u8s & 1U) * 10U);
+    raw_st.value2_u16 = 480U;
+    temp_u8s++;
+
+    raw_st.rxUs_u32 = latStat_Now_u32();
+    fake_AdvanceUs_vd(PARSE_US);
+    raw_st.parsedUs_u32 = latStat_Now_u32();
+    DriverCallback_vd(&raw_st);
+    fake_AdvanceUs_vd(queueUs_u32);
+    HandleRingEvent_vd();
+    fake_AdvanceUs_vd(schedUs_u32);
+    RunPublishScheduler_vd();
+}
+
+void setUp(void)
+{
+    fixture_Boot_vd(Publish_td);
+
+    // the test drives the scheduler, the time stamps only advance where intended
+    (void)xTimerStop(this_sst.cycleTimer_st, 0U);
+    ResetSensors_vd();
+    memcpy(&this_sst.db_st, &DB_DEFAULT_PARA, sizeof(deadbandParam_t));
+    this_sst.db_st.temp_u32 = 1U;
+    this_sst.pubMode_en = PUB_MODE_COMPACT;
+    OnConnectionHandler_vd();
+    (void)xEventGroupClearBits(this_sst.eventGroup_st, 0xFFFFFFU);
+    memset(&pending_sts, 0, sizeof(pending_sts));
+    totalData_ca[0] = '\0';
+    latTopics_u32s = 0U;
+    latStat_Reset_vd();
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* bucket i holds [2^i, 2^(i+1)) us, the last bucket is open ended */
+static void test_BucketBoundaries(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(0U, latStat_GetBucket_u8(0U));
+    TEST_ASSERT_EQUAL_UINT8(0U, latStat_GetBucket_u8(1U));
+    TEST_ASSERT_EQUAL_UINT8(1U, latStat_GetBucket_u8(2U));
+    TEST_ASSERT_EQUAL_UINT8(1U, latStat_GetBucket_u8(3U));
+    TEST_ASSERT_EQUAL_UINT8(2U, latStat_GetBucket_u8(4U));
+    TEST_ASSERT_EQUAL_UINT8(9U, latStat_GetBucket_u8(1023U));
+    TEST_ASSERT_EQUAL_UINT8(10U, latStat_GetBucket_u8(1024U));
+    TEST_ASSERT_EQUAL_UINT8(latStat_BUCKETS - 2U, 
+                            latStat_GetBucket_u8((1U << (latStat_BUCKETS - 1U)) - 1U));
+    TEST_ASSERT_EQUAL_UINT8(latStat_BUCKETS - 1U, 
+                            latStat_GetBucket_u8(1U << (latStat_BUCKETS - 1U)));
+    TEST_ASSERT_EQUAL_UINT8(latStat_BUCKETS - 1U, latStat_GetBucket_u8(UINT32_MAX));
+}
+
+/* the latency is the unsigned difference, the wrap of the time stamp is no outlier */
+static void test_RecordAcrossTimestampWrap(void)
+{
+    latStat_hist_t hist_st;
+
+    latStat_Record_vd(latStat_STAGE_ACK, 0xFFFFFF00U, 0x100U);
+    TEST_ASSERT_TRUE(latStat_GetHistogram_bol(latStat_STAGE_ACK, &hist_st));
+    TEST_ASSERT_EQUAL_UINT32(1U, hist_st.count_u32);
+    TEST_ASSERT_EQUAL_UINT32(512U, hist_st.max_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, hist_st.buckets_u32a[9]);
+    TEST_ASSERT_FALSE(latStat_GetHistogram_bol(latStat_STAGE_NUM, &hist_st));
+}
+
+/* every stage of one sample lands in the bucket of its fake duration */
+static void test_PipelineStagesBucketed(void)
+{
+    static const uint32_t STAGE_US_CU32A[latStat_STAGE_NUM] =
+    {
+        PARSE_US, QUEUE_US, SCHED_US, PUBLISH_US, ACK_US,
+        PARSE_US + QUEUE_US + SCHED_US + PUBLISH_US + ACK_US
+    };
+    latStat_hist_t hist_st;
+
+    RunSample_vd(QUEUE_US, SCHED_US);
+    Ack_vd(ACK_US);
+
+    for(uint8_t stage_u8 = 0U; stage_u8 < latStat_STAGE_NUM; stage_u8++)
+    {
+        TEST_ASSERT_TRUE(latStat_GetHistogram_bol((latStat_stage_t)stage_u8, &hist_st));
+        TEST_ASSERT_EQUAL_UINT32(1U, hist_st.count_u32);
+        TEST_ASSERT_EQUAL_UINT32(STAGE_US_CU32A[stage_u8], hist_st.max_u32);
+        TEST_ASSERT_EQUAL_UINT32(1U, 
+                    hist_st.buckets_u32a[latStat_GetBucket_u8(STAGE_US_CU32A[stage_u8])]);
+    }
+}
+
+/* percentiles are the upper limit of the bucket, limited by the maximum */
+static void test_PipelinePercentiles(void)
+{
+    latStat_hist_t hist_st;
+
+    // 90 fast, 9 slow and one very slow acknowledge
+    for(uint32_t idx_u32 = 0U; idx_u32 < 100U; idx_u32++)
+    {
+        RunSample_vd(QUEUE_US, SCHED_US);
+        Ack_vd((90U > idx_u32) ? 5000U : ((99U > idx_u32) ? 50000U : 900000U));
+    }
+
+    TEST_ASSERT_TRUE(latStat_GetHistogram_bol(latStat_STAGE_ACK, &hist_st));
+    TEST_ASSERT_EQUAL_UINT32(100U, hist_st.count_u32);
+    TEST_ASSERT_EQUAL_UINT32(90U, hist_st.buckets_u32a[12]);
+    TEST_ASSERT_EQUAL_UINT32(9U, hist_st.buckets_u32a[15]);
+    TEST_ASSERT_EQUAL_UINT32(1U, hist_st.buckets_u32a[19]);
+    TEST_ASSERT_EQUAL_UINT32(8191U, latStat_GetPercentile_u32(&hist_st, 500U));
+    TEST_ASSERT_EQUAL_UINT32(8191U, latStat_GetPercentile_u32(&hist_st, 900U));
+    TEST_ASSERT_EQUAL_UINT32(65535U, latStat_GetPercentile_u32(&hist_st, 990U));
+    TEST_ASSERT_EQUAL_UINT32(900000U, latStat_GetPercentile_u32(&hist_st, 1000U));
+    TEST_ASSERT_EQUAL_UINT32((90U * 5000U + 9U * 50000U + 900000U) / 100U,
+                                (uint32_t)(hist_st.sum_u64 / hist_st.count_u32));
+
+    memset(&hist_st, 0, sizeof(hist_st));
+    TEST_ASSERT_EQUAL_UINT32(0U, latStat_GetPercentile_u32(&hist_st, 990U));
+}
+
+/* samples buffered while the broker is offline are not part of the statistics */
+static void test_OfflineSamplesNotRecorded(void)
+{
+    latStat_hist_t hist_st;
+
+    OnDisconnectionHandler_vd();
+    RunSample_vd(QUEUE_US, SCHED_US);
+    TEST_ASSERT_NULL(pending_sts.acked_fp);
+    TEST_ASSERT_TRUE(latStat_GetHistogram_bol(latStat_STAGE_SCHED, &hist_st));
+    TEST_ASSERT_EQUAL_UINT32(0U, hist_st.count_u32);
+    // the ble side of the data path is still measured
+    TEST_ASSERT_TRUE(latStat_GetHistogram_bol(latStat_STAGE_QUEUE, &hist_st));
+    TEST_ASSERT_EQUAL_UINT32(1U, hist_st.count_u32);
+}
+
+/* the stats topics carry the same numbers as the console */
+static void test_StatsTopicAndConsole(void)
+{
+    char expected_ca[mqttif_MAX_SIZE_OF_DATA];
+    uint32_t totalUs_u32 = PARSE_US + QUEUE_US + SCHED_US + PUBLISH_US + ACK_US;
+
+    RunSample_vd(QUEUE_US, SCHED_US);
+    Ack_vd(ACK_US);
+    PublishLatencyStats_vd();
+    TEST_ASSERT_EQUAL_UINT32(latStat_STAGE_NUM, latTopics_u32s);
+    snprintf(expected_ca, sizeof(expected_ca), 
+                "{\"n\":1,\"avg\":%u,\"p50\":%u,\"p90\":%u,\"p99\":%u,\"max\":%u}",
+                totalUs_u32, totalUs_u32, totalUs_u32, totalUs_u32, totalUs_u32);
+    TEST_ASSERT_EQUAL_STRING(expected_ca, totalData_ca);
+
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleLat -r", stdout));
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleLat -x 5", stdout));
+    TEST_ASSERT_EQUAL(1, fake_ConsoleRun_s32("bleLat -x 9", stdout));
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleLat -c", stdout));
+    latTopics_u32s = 0U;
+    PublishLatencyStats_vd();
+    TEST_ASSERT_EQUAL_UINT32(0U, latTopics_u32s);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_BucketBoundaries);
+    RUN_TEST(test_RecordAcrossTimestampWrap);
+    RUN_TEST(test_PipelineStagesBucketed);
+    RUN_TEST(test_PipelinePercentiles);
+    RUN_TEST(test_OfflineSamplesNotRecorded);
+    RUN_TEST(test_StatsTopicAndConsole);
+    return(UNITY_END());
+}
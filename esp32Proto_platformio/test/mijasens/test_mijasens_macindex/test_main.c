@@ -0,0 +1,275 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the mac index of mijasens. The module is built with the largest
+*       sensor capacity of the Kconfig range, the tests cover lookup, removal and the
+*       eviction of unknown sensors. The benchmarks compare the hash lookup with the
+*       former linear search.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+// largest capacity of the Kconfig range, the benchmarks fill a part of it
+#define CONFIG_MIJASENS_MAX_SENSORS     250U
+
+#include "mijasens.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define BENCH_LOOKUPS       1000000U
+#define CHURN_SENSORS       500U        // advertisers competing for the sensor slots
+
+/****************************************************************************************/
+/* Local variables: */
+
+static uint32_t rand_u32s = 1U;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static uint32_t Rand_u32(void)
+{
+    rand_u32s = (rand_u32s * 1103515245U) + 12345U;
+    return(rand_u32s >> 8U);
+}
+
+/* mac addresses of one vendor, only the lower bytes differ like on a real site */
+static void MakeMac_vd(uint32_t num_u32, uint8_t *mac_u8p)
+{
+    mac_u8p[0] = 0xA4;
+    mac_u8p[1] = 0xC1;
+    mac_u8p[2] = 0x38;
+    mac_u8p[3] = (uint8_t)(num_u32 >> 16U);
+    mac_u8p[4] = (uint8_t)(num_u32 >> 8U);
+    mac_u8p[5] = (uint8_t)num_u32;
+}
+
+/* the search of the former implementation, used as reference of the benchmark */
+static uint8_t LinearFind_u8(const uint8_t *mac_cu8p)
+{
+    uint8_t sensIdx_u8 = MAX_MIJA_SENSORS;
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < MAX_MIJA_SENSORS; idx_u8++)
+    {
+        if(0 == memcmp(&this_sst.sensors_sta[idx_u8].para_st.macAddr_u8a[0], mac_cu8p,
+                        mija_SIZE_MAC_ADDR))
+        {
+            sensIdx_u8 = idx_u8;
+            break;
+        }
+    }
+    return(sensIdx_u8);
+}
+
+static void FillSensors_vd(uint32_t num_u32)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < num_u32; idx_u32++)
+    {
+        MakeMac_vd(idx_u32, mac_u8a);
+        TEST_ASSERT_EQUAL_UINT8(idx_u32, AllocSensor_u8(mac_u8a));
+    }
+}
+
+void setUp(void)
+{
+    ResetSensors_vd();
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_AllocatedSensorsAreFound(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    FillSensors_vd(MAX_MIJA_SENSORS);
+    TEST_ASSERT_EQUAL_UINT8(MAX_MIJA_SENSORS, this_sst.usedSensors_u8);
+    for(uint32_t idx_u32 = 0U; idx_u32 < MAX_MIJA_SENSORS; idx_u32++)
+    {
+        MakeMac_vd(idx_u32, mac_u8a);
+        TEST_ASSERT_EQUAL_UINT8(idx_u32, FindSensor_u8(mac_u8a));
+    }
+    MakeMac_vd(MAX_MIJA_SENSORS, mac_u8a);
+    TEST_ASSERT_EQUAL_UINT8(MAX_MIJA_SENSORS, FindSensor_u8(mac_u8a));
+}
+
+/* removals in random order, the shifted probe sequences keep every entry reachable */
+static void test_RemovalKeepsProbeSequences(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    bool removed_bola[MAX_MIJA_SENSORS] = {false};
+    uint8_t sensIdx_u8;
+
+    FillSensors_vd(MAX_MIJA_SENSORS);
+    for(uint32_t round_u32 = 0U; round_u32 < (MAX_MIJA_SENSORS / 2U); round_u32++)
+    {
+        do
+        {
+            sensIdx_u8 = (uint8_t)(Rand_u32() % MAX_MIJA_SENSORS);
+        }while(true == removed_bola[sensIdx_u8]);
+        IndexRemove_vd(sensIdx_u8);
+        removed_bola[sensIdx_u8] = true;
+
+        for(uint32_t idx_u32 = 0U; idx_u32 < MAX_MIJA_SENSORS; idx_u32++)
+        {
+            MakeMac_vd(idx_u32, mac_u8a);
+            TEST_ASSERT_EQUAL_UINT8((true == removed_bola[idx_u32]) ? MAX_MIJA_SENSORS
+                                        : idx_u32, FindSensor_u8(mac_u8a));
+        }
+    }
+}
+
+static void test_FullListEvictsLeastRecentlySeenUnknownSensor(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    FillSensors_vd(MAX_MIJA_SENSORS);
+    fake_AdvanceMs_vd(1000U);
+    for(uint32_t idx_u32 = 0U; idx_u32 < MAX_MIJA_SENSORS; idx_u32++)
+    {
+        this_sst.sensors_sta[idx_u32].lastSeen_st = xTaskGetTickCount();
+    }
+    // sensor 7 was seen last a while ago, sensor 3 even earlier but it is registered
+    this_sst.sensors_sta[7].lastSeen_st -= 500U;
+    this_sst.sensors_sta[3].lastSeen_st -= 900U;
+    this_sst.sensors_sta[3].para_st.knownSens_u8 = 1U;
+
+    MakeMac_vd(1000U, mac_u8a);
+    TEST_ASSERT_EQUAL_UINT8(7U, AllocSensor_u8(mac_u8a));
+    TEST_ASSERT_EQUAL_UINT8(7U, FindSensor_u8(mac_u8a));
+    MakeMac_vd(7U, mac_u8a);
+    TEST_ASSERT_EQUAL_UINT8(MAX_MIJA_SENSORS, FindSensor_u8(mac_u8a));
+    MakeMac_vd(3U, mac_u8a);
+    TEST_ASSERT_EQUAL_UINT8(3U, FindSensor_u8(mac_u8a));
+}
+
+static void test_KnownSensorsAreNeverEvicted(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    FillSensors_vd(MAX_MIJA_SENSORS);
+    for(uint32_t idx_u32 = 0U; idx_u32 < MAX_MIJA_SENSORS; idx_u32++)
+    {
+        this_sst.sensors_sta[idx_u32].para_st.knownSens_u8 = 1U;
+    }
+    MakeMac_vd(1000U, mac_u8a);
+    TEST_ASSERT_EQUAL_UINT8(MAX_MIJA_SENSORS, AllocSensor_u8(mac_u8a));
+    TEST_ASSERT_EQUAL_UINT8(MAX_MIJA_SENSORS, FindSensor_u8(mac_u8a));
+}
+
+/* lookups of advertising sensors at 5, 50 and 250 sensors in the list, compared to the
+   linear search of the former implementation */
+static void test_BenchLookup(void)
+{
+    static const uint32_t SENSORS_CU32A[] = {5U, 50U, MAX_MIJA_SENSORS};
+    static uint8_t macs_u8a[MAX_MIJA_SENSORS][mija_SIZE_MAC_ADDR];
+    volatile uint32_t sum_u32 = 0U;
+    uint32_t num_u32;
+    uint64_t startNs_u64;
+    char name_ca[48];
+
+    for(uint32_t run_u32 = 0U; run_u32 < 3U; run_u32++)
+    {
+        num_u32 = SENSORS_CU32A[run_u32];
+        ResetSensors_vd();
+        FillSensors_vd(num_u32);
+        for(uint32_t idx_u32 = 0U; idx_u32 < num_u32; idx_u32++)
+        {
+            MakeMac_vd(idx_u32, macs_u8a[idx_u32]);
+        }
+
+        startNs_u64 = fake_HostNs_u64();
+        for(uint32_t op_u32 = 0U; op_u32 < BENCH_LOOKUPS; op_u32++)
+        {
+            sum_u32 += FindSensor_u8(macs_u8a[op_u32 % num_u32]);
+        }
+        snprintf(name_ca, sizeof(name_ca), "mijasens hash lookup, %u sensors", num_u32);
+        fake_Bench_vd(name_ca, BENCH_LOOKUPS, fake_HostNs_u64() - startNs_u64);
+
+        startNs_u64 = fake_HostNs_u64();
+        for(uint32_t op_u32 = 0U; op_u32 < BENCH_LOOKUPS; op_u32++)
+        {
+            sum_u32 += LinearFind_u8(macs_u8a[op_u32 % num_u32]);
+        }
+        snprintf(name_ca, sizeof(name_ca), "mijasens linear lookup, %u sensors", num_u32);
+        fake_Bench_vd(name_ca, BENCH_LOOKUPS, fake_HostNs_u64() - startNs_u64);
+    }
+    TEST_ASSERT_TRUE(0U < sum_u32);
+}
+
+/* the slot index is 8 bit, so 500 sensors exceed the capacity: every advertisement of
+   an evicted sensor costs a failed lookup and an eviction */
+static void test_BenchChurnWith500Advertisers(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint32_t evictions_u32 = 0U;
+    uint64_t startNs_u64 = fake_HostNs_u64();
+
+    for(uint32_t op_u32 = 0U; op_u32 < (BENCH_LOOKUPS / 10U); op_u32++)
+    {
+        MakeMac_vd(Rand_u32() % CHURN_SENSORS, mac_u8a);
+        fake_AdvanceMs_vd(1U);
+        if(MAX_MIJA_SENSORS == FindSensor_u8(mac_u8a))
+        {
+            TEST_ASSERT_TRUE(MAX_MIJA_SENSORS > AllocSensor_u8(mac_u8a));
+            evictions_u32++;
+        }
+    }
+    fake_Bench_vd("mijasens lookup, 500 advertisers", BENCH_LOOKUPS / 10U,
+                    fake_HostNs_u64() - startNs_u64);
+    printf("BENCH mijasens 500 advertisers on %u slots: %u of %u lookups allocated\n",
+            MAX_MIJA_SENSORS, evictions_u32, BENCH_LOOKUPS / 10U);
+    TEST_ASSERT_EQUAL_UINT8(MAX_MIJA_SENSORS, this_sst.usedSensors_u8);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_AllocatedSensorsAreFound);
+    RUN_TEST(test_RemovalKeepsProbeSequences);
+    RUN_TEST(test_FullListEvictsLeastRecentlySeenUnknownSensor);
+    RUN_TEST(test_KnownSensorsAreNeverEvicted);
+    RUN_TEST(test_BenchLookup);
+    RUN_TEST(test_BenchChurnWith500Advertisers);
+    return(UNITY_END());
+}
@@ -0,0 +1,304 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host simulation of a broker outage. mijasens runs on the fakes with a spill
+*       partition, the samples of one hour without broker are buffered and replayed
+*       after the reconnect. The remaining tests use the sample buffer directly for the
+*       overflow, the ram only and the flash failure case.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+#include "mijasens.c"
+#include "fixture_mijasens.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define SENSORS_NUM         MAX_MIJA_SENSORS
+#define SAMPLE_PERIOD_MS    10000U      // advertisement period of the simulated sensors
+#define OUTAGE_MS           3600000U
+#define RAM_RECORDS         64U         // ram part of the sample buffer
+#define SPILL_SECTORS       4U          // 1024 records in flash
+#define BENCH_RECORDS       100000U
+
+/****************************************************************************************/
+/* Local variables: */
+
+static uint32_t livePubs_u32s;
+static uint32_t histPubs_u32s;
+static uint32_t lastAge_u32s;
+static uint8_t msgCnt_u8s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* publish handler of the mqtt driver, the replayed samples use the history topic */
+static esp_err_t CountPublish_td(mqttif_msg_t *msg_stp, uint32_t wait_u32)
+{
+    (void)wait_u32;
+    if(NULL != strstr(msg_stp->topic_chp, MQTT_PUB_HISTORY))
+    {
+        histPubs_u32s++;
+        (void)sscanf(msg_stp->data_chp, "{\"age\":%u", &lastAge_u32s);
+    }
+    else
+    {
+        livePubs_u32s++;
+    }
+    return(ESP_OK);
+}
+
+/* every sensor sends a combined temperature and humidity sample and its battery */
+static void SendSamples_vd(void)
+{
+    for(uint8_t sens_u8 = 0U; sens_u8 < SENSORS_NUM; sens_u8++)
+    {
+        fixture_SendSample_vd(sens_u8, msgCnt_u8s, 
+                                (int16_t)(200 + sens_u8 + (msgCnt_u8s % 50U)),
+                                (uint16_t)(480 - sens_u8), 90U);
+    }
+    msgCnt_u8s++;
+    fixture_RunTask_vd();
+}
+
+/* the sensors keep sending while the clock advances in scheduler ticks */
+static void RunFor_vd(uint32_t ms_u32)
+{
+    for(uint32_t time_u32 = 0U; time_u32 < ms_u32; time_u32 += SCHED_TICK_MS)
+    {
+        if(0U == (time_u32 % SAMPLE_PERIOD_MS))
+        {
+            SendSamples_vd();
+        }
+        fake_AdvanceMs_vd(SCHED_TICK_MS);
+        fixture_RunTask_vd();
+    }
+}
+
+static void MakeRecord_vd(uint32_t seq_u32, sampleBuf_record_t *rec_stp)
+{
+    memset(rec_stp, 0, sizeof(sampleBuf_record_t));
+    rec_stp->time_u32 = seq_u32;
+    rec_stp->temp_s16 = (int16_t)(seq_u32 % 400U) - 100;
+    rec_stp->hum_u16 = (uint16_t)(seq_u32 % 1000U);
+    rec_stp->macAddr_u8a[5] = (uint8_t)seq_u32;
+    rec_stp->msgCnt_u8 = (uint8_t)seq_u32;
+}
+
+void setUp(void)
+{
+    fixture_Boot_vd(CountPublish_td);
+
+    // the buffer spills to a partition which is empty at the start of every test
+    fake_PartSetup_vd("offbuf", SPILL_SECTORS * FAKE_PART_SECTOR_SIZE);
+    TEST_ASSERT_EQUAL(ESP_OK, sampleBuf_Initialize_td());
+
+    ResetSensors_vd();
+    memset(&this_sst.db_st, 0, sizeof(this_sst.db_st));
+    this_sst.pubMode_en = PUB_MODE_COMPACT;
+    OnConnectionHandler_vd();
+    (void)xEventGroupClearBits(this_sst.eventGroup_st, 0xFFFFFFU);
+    (void)xTimerStart(this_sst.cycleTimer_st, 0U);
+    livePubs_u32s = 0U;
+    histPubs_u32s = 0U;
+    msgCnt_u8s = 0U;
+}
+
+void tearDown(void)
+{
+    (void)xTimerStop(this_sst.cycleTimer_st, 0U);
+    (void)xTimerStop(this_sst.replayTimer_st, 0U);
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* one hour without broker, every buffered sample is replayed after the reconnect */
+static void test_HourOutageIsReplayedWithoutLoss(void)
+{
+    sampleBuf_stats_t stats_st;
+    int64_t replayStartUs_s64;
+    double replaySec_f64;
+    char line_ca[128];
+
+    RunFor_vd(2U * PUB_CYCLE_MS);
+    OnDisconnectionHandler_vd();
+    livePubs_u32s = 0U;
+    RunFor_vd(OUTAGE_MS);
+    TEST_ASSERT_EQUAL_UINT32(0U, livePubs_u32s);
+    TEST_ASSERT_EQUAL_UINT32(0U, histPubs_u32s);
+
+    sampleBuf_GetStats_vd(&stats_st);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(SENSORS_NUM * (OUTAGE_MS / PUB_CYCLE_MS),
+                                        stats_st.stored_u32);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(sampleBuf_GetCapacity_u32(), stats_st.stored_u32);
+    TEST_ASSERT_EQUAL_UINT32(stats_st.stored_u32, sampleBuf_GetCount_u32());
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_st.dropped_u32);
+
+    replayStartUs_s64 = fake_nowUs_s64;
+    OnConnectionHandler_vd();
+    while(0U < sampleBuf_GetCount_u32())
+    {
+        RunFor_vd(SCHED_TICK_MS);
+    }
+    replaySec_f64 = (double)(fake_nowUs_s64 - replayStartUs_s64) / 1e6;
+
+    sampleBuf_GetStats_vd(&stats_st);
+    TEST_ASSERT_EQUAL_UINT32(stats_st.stored_u32, histPubs_u32s);
+    TEST_ASSERT_EQUAL_UINT32(stats_st.stored_u32, stats_st.replayed_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_st.dropped_u32);
+    // the newest sample was taken at the end of the outage
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32((uint32_t)replaySec_f64 + (PUB_CYCLE_MS / 1000U),
+                                        lastAge_u32s);
+    // the rate limit holds and the live values are published during the replay
+    TEST_ASSERT_TRUE((histPubs_u32s / replaySec_f64)
+                        <= ((REPLAY_BATCH_SIZE * 1000.0) / REPLAY_PERIOD_MS));
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(SENSORS_NUM * (uint32_t)(replaySec_f64 * 1000.0
+                                            / PUB_CYCLE_MS), livePubs_u32s);
+
+    snprintf(line_ca, sizeof(line_ca), "mijasens outage 1h: %u samples, %u spilled, "
+                "replay %.0f s, %.1f samples/s, %u live publications during replay",
+                stats_st.stored_u32, stats_st.spilled_u32, replaySec_f64,
+                histPubs_u32s / replaySec_f64, livePubs_u32s);
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+}
+
+/* beyond the capacity the oldest samples are dropped, the rest keeps its order */
+static void test_OverflowDropsOldestRecords(void)
+{
+    sampleBuf_record_t rec_st;
+    sampleBuf_stats_t stats_st;
+    uint32_t capacity_u32 = sampleBuf_GetCapacity_u32();
+    uint32_t pushed_u32 = capacity_u32 + 1000U;
+    uint32_t last_u32;
+
+    for(uint32_t seq_u32 = 0U; seq_u32 < pushed_u32; seq_u32++)
+    {
+        MakeRecord_vd(seq_u32, &rec_st);
+        TEST_ASSERT_EQUAL(ESP_OK, sampleBuf_Push_td(&rec_st));
+    }
+    sampleBuf_GetStats_vd(&stats_st);
+    TEST_ASSERT_EQUAL_UINT32(pushed_u32, sampleBuf_GetCount_u32() + stats_st.dropped_u32);
+    // the flash ring loses at most one sector when it wraps
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(capacity_u32 - (FAKE_PART_SECTOR_SIZE
+                                        / sizeof(sampleBuf_record_t)),
+                                        sampleBuf_GetCount_u32());
+
+    TEST_ASSERT_TRUE(sampleBuf_Pop_bol(&rec_st));
+    TEST_ASSERT_EQUAL_UINT32(stats_st.dropped_u32, rec_st.time_u32);
+    last_u32 = rec_st.time_u32;
+    while(true == sampleBuf_Pop_bol(&rec_st))
+    {
+        TEST_ASSERT_EQUAL_UINT32(last_u32 + 1U, rec_st.time_u32);
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)rec_st.time_u32, rec_st.macAddr_u8a[5]);
+        last_u32 = rec_st.time_u32;
+    }
+    TEST_ASSERT_EQUAL_UINT32(pushed_u32 - 1U, last_u32);
+}
+
+static void test_WithoutPartitionRamOnly(void)
+{
+    sampleBuf_record_t rec_st;
+    sampleBuf_stats_t stats_st;
+
+    fake_PartSetup_vd("offbuf", 0U);
+    TEST_ASSERT_EQUAL(ESP_OK, sampleBuf_Initialize_td());
+    TEST_ASSERT_EQUAL_UINT32(RAM_RECORDS, sampleBuf_GetCapacity_u32());
+    for(uint32_t seq_u32 = 0U; seq_u32 < 100U; seq_u32++)
+    {
+        MakeRecord_vd(seq_u32, &rec_st);
+        TEST_ASSERT_EQUAL(ESP_OK, sampleBuf_Push_td(&rec_st));
+    }
+    sampleBuf_GetStats_vd(&stats_st);
+    TEST_ASSERT_EQUAL_UINT32(RAM_RECORDS, sampleBuf_GetCount_u32());
+    TEST_ASSERT_EQUAL_UINT32(100U - RAM_RECORDS, stats_st.dropped_u32);
+    TEST_ASSERT_TRUE(sampleBuf_Pop_bol(&rec_st));
+    TEST_ASSERT_EQUAL_UINT32(100U - RAM_RECORDS, rec_st.time_u32);
+}
+
+static void test_FailedSpillIsCountedAsDrop(void)
+{
+    sampleBuf_record_t rec_st;
+    sampleBuf_stats_t stats_st;
+
+    fake_partWriteBudget_s32 = 0;
+    for(uint32_t seq_u32 = 0U; seq_u32 < (RAM_RECORDS + 10U); seq_u32++)
+    {
+        MakeRecord_vd(seq_u32, &rec_st);
+        TEST_ASSERT_EQUAL(ESP_OK, sampleBuf_Push_td(&rec_st));
+    }
+    sampleBuf_GetStats_vd(&stats_st);
+    TEST_ASSERT_EQUAL_UINT32(10U, stats_st.dropped_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_st.spilled_u32);
+    TEST_ASSERT_EQUAL_UINT32(RAM_RECORDS, sampleBuf_GetCount_u32());
+    fake_PartPowerOn_vd();
+}
+
+/* host throughput of push and pop with the spill partition in use */
+static void test_BenchPushPop(void)
+{
+    sampleBuf_record_t rec_st;
+    uint64_t startNs_u64 = fake_HostNs_u64();
+
+    for(uint32_t seq_u32 = 0U; seq_u32 < BENCH_RECORDS; seq_u32++)
+    {
+        MakeRecord_vd(seq_u32, &rec_st);
+        (void)sampleBuf_Push_td(&rec_st);
+        if(0U == (seq_u32 % 2U))
+        {
+            (void)sampleBuf_Pop_bol(&rec_st);
+        }
+    }
+    while(true == sampleBuf_Pop_bol(&rec_st))
+    {
+    }
+    fake_Bench_vd("sampleBuf push and pop with spill", BENCH_RECORDS,
+                    fake_HostNs_u64() - startNs_u64);
+    TEST_ASSERT_EQUAL_UINT32(0U, sampleBuf_GetCount_u32());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_HourOutageIsReplayedWithoutLoss);
+    RUN_TEST(test_OverflowDropsOldestRecords);
+    RUN_TEST(test_WithoutPartitionRamOnly);
+    RUN_TEST(test_FailedSpillIsCountedAsDrop);
+    RUN_TEST(test_BenchPushPop);
+    return(UNITY_END());
+}
@@ -0,0 +1,241 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the publish modes of mijasens. The module runs with the real ble
+*       driver, parameter interface and protocols on top of the fakes, the publish
+*       handler counts the calls and the bytes on the wire. The benchmark compares the
+*       per field topics with the compact json document for one publish cycle of all
+*       sensors.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+#include "mijasens.c"
+#include "fixture_mijasens.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define SENSORS_NUM         MAX_MIJA_SENSORS
+#define SAMPLE_PERIOD_MS    10000U      // advertisement period of the simulated sensors
+
+/****************************************************************************************/
+/* Local variables: */
+
+static uint32_t pubCalls_u32s;
+static uint32_t pubBytes_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* publish handler of the mqtt driver, counts the calls and the bytes on the wire */
+static esp_err_t CountPublish_td(mqttif_msg_t *msg_stp, uint32_t wait_u32)
+{
+    (void)wait_u32;
+    pubCalls_u32s++;
+    pubBytes_u32s += msg_stp->topicLen_u32 + msg_stp->dataLen_u32;
+    return(ESP_OK);
+}
+
+/* every sensor sends a combined temperature and humidity sample and its battery */
+static void SendSamples_vd(uint8_t msgCnt_u8)
+{
+    for(uint8_t sens_u8 = 0U; sens_u8 < SENSORS_NUM; sens_u8++)
+    {
+        fixture_SendSample_vd(sens_u8, msgCnt_u8, (int16_t)(215 + sens_u8 + msgCnt_u8),
+                                (uint16_t)(480 - sens_u8), 90U);
+    }
+    fixture_RunTask_vd();
+}
+
+/* samples for the given time, the cycle publications are counted at the end */
+static void RunCycle_vd(uint32_t ms_u32)
+{
+    uint8_t msgCnt_u8 = 0U;
+
+    for(uint32_t time_u32 = 0U; time_u32 < ms_u32; time_u32 += SAMPLE_PERIOD_MS)
+    {
+        SendSamples_vd(msgCnt_u8++);
+        fixture_RunFor_vd(SAMPLE_PERIOD_MS);
+    }
+}
+
+void setUp(void)
+{
+    fixture_Boot_vd(CountPublish_td);
+
+    ResetSensors_vd();
+    memset(&this_sst.db_st, 0, sizeof(this_sst.db_st));
+    OnConnectionHandler_vd();
+    (void)xEventGroupClearBits(this_sst.eventGroup_st, 0xFFFFFFU);
+    (void)xTimerStart(this_sst.cycleTimer_st, 0U);
+    pubCalls_u32s = 0U;
+    pubBytes_u32s = 0U;
+}
+
+void tearDown(void)
+{
+    (void)xTimerStop(this_sst.cycleTimer_st, 0U);
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_ConsoleSelectsPublishMode(void)
+{
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleSet -w -m 1", stdout));
+    TEST_ASSERT_EQUAL(PUB_MODE_COMPACT, this_sst.pubMode_en);
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleSet -w --mode=0", stdout));
+    TEST_ASSERT_EQUAL(PUB_MODE_SINGLE, this_sst.pubMode_en);
+    TEST_ASSERT_EQUAL(1, fake_ConsoleRun_s32("bleSet -w -m 7", stdout));
+    TEST_ASSERT_EQUAL(PUB_MODE_SINGLE, this_sst.pubMode_en);
+}
+
+static void test_ConsoleKeepsScanTimingNotGiven(void)
+{
+    this_sst.blePara_st.cycleTimeInSec_u32 = 60U;
+    this_sst.blePara_st.scanDurationInSec_u32 = 10U;
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleSet -w -c 120", stdout));
+    TEST_ASSERT_EQUAL_UINT32(120U, this_sst.blePara_st.cycleTimeInSec_u32);
+    TEST_ASSERT_EQUAL_UINT32(10U, this_sst.blePara_st.scanDurationInSec_u32);
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleSet -w -s 20", stdout));
+    TEST_ASSERT_EQUAL_UINT32(120U, this_sst.blePara_st.cycleTimeInSec_u32);
+    TEST_ASSERT_EQUAL_UINT32(20U, this_sst.blePara_st.scanDurationInSec_u32);
+}
+
+/* the console commands share the sensor list with the task, every path releases it */
+static void test_ConsoleCommandsReleaseSensorLock(void)
+{
+    static const char *LINES_CCHPA[] = 
+    {
+        "bleSet -r", "bleSet -w -m 1", "bleSet -w -m 7", "bleSet --bad", 
+        "bleHist -x 0", "bleHist -x 99", "bleHist", 
+        "bleDb -r", "bleDb -w -x 9 -t 5", "bleDb --bad", "bleReg -r"
+    };
+
+    SendSamples_vd(1U);
+    for(uint8_t idx_u8 = 0U; idx_u8 < (sizeof(LINES_CCHPA) / sizeof(char *)); idx_u8++)
+    {
+        (void)fake_ConsoleRun_s32(LINES_CCHPA[idx_u8], stdout);
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(this_sst.sensMutex_st, 0U));
+        TEST_ASSERT_EQUAL(pdFALSE, xSemaphoreTake(this_sst.sensMutex_st, 0U));
+        (void)xSemaphoreGive(this_sst.sensMutex_st);
+    }
+}
+
+static void test_SingleModePublishesSevenTopicsPerSensor(void)
+{
+    this_sst.pubMode_en = PUB_MODE_SINGLE;
+    RunCycle_vd(PUB_CYCLE_MS);
+    TEST_ASSERT_EQUAL_UINT32(SENSORS_NUM, this_sst.usedSensors_u8);
+    TEST_ASSERT_EQUAL_UINT32(7U * SENSORS_NUM, pubCalls_u32s);
+}
+
+static void test_CompactModePublishesOneDocumentPerSensor(void)
+{
+    this_sst.pubMode_en = PUB_MODE_COMPACT;
+    RunCycle_vd(PUB_CYCLE_MS);
+    TEST_ASSERT_EQUAL_UINT32(SENSORS_NUM, pubCalls_u32s);
+}
+
+static void test_CompactDocumentHoldsAllFields(void)
+{
+    this_sst.pubMode_en = PUB_MODE_COMPACT;
+    SendSamples_vd(3U);
+    PublishSensor_vd(0U);
+    TEST_ASSERT_EQUAL_STRING("std/dev/s/1/mija/state", this_sst.pubMsg_st.topic_chp);
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":21.8,\"hum\":48.0,\"batt\":90,\"cnt\":3,"
+                                "\"addr\":\"A4:C1:00:00:00:00\",\"loc\":\"\",\"know\":0}",
+                                this_sst.pubMsg_st.data_chp);
+}
+
+static void test_CompactDocumentEscapesLocation(void)
+{
+    this_sst.pubMode_en = PUB_MODE_COMPACT;
+    SendSamples_vd(3U);
+    strcpy(this_sst.sensors_sta[0].para_st.loc_cha, "a\"b\\c\nd");
+    PublishSensor_vd(0U);
+    TEST_ASSERT_NOT_NULL(strstr(this_sst.pubMsg_st.data_chp, 
+                                "\"loc\":\"a\\\"b\\\\c\\u000ad\","));
+}
+
+static void test_AggregateModePublishesClosedWindowsOnce(void)
+{
+    this_sst.pubMode_en = PUB_MODE_AGGREGATE;
+    RunCycle_vd(3U * 60000U);
+    // the 1 min window is closed at least twice, 15 min and 1 h are still open
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2U * SENSORS_NUM, pubCalls_u32s);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(3U * SENSORS_NUM, pubCalls_u32s);
+}
+
+static void test_BenchPublishCallsAndBytesPerCycle(void)
+{
+    static const char *NAMES_CCHPA[] = {"single", "compact"};
+    uint32_t calls_u32a[2];
+    uint32_t bytes_u32a[2];
+    char name_ca[64];
+
+    for(uint8_t mode_u8 = 0U; mode_u8 < 2U; mode_u8++)
+    {
+        setUp();
+        this_sst.pubMode_en = (pubMode_t)mode_u8;
+        RunCycle_vd(PUB_CYCLE_MS);
+        calls_u32a[mode_u8] = pubCalls_u32s;
+        bytes_u32a[mode_u8] = pubBytes_u32s;
+        snprintf(name_ca, sizeof(name_ca), "mijasens cycle %s: %u sensors, %u publish calls,"
+                    " %u bytes", NAMES_CCHPA[mode_u8], SENSORS_NUM, calls_u32a[mode_u8],
+                    bytes_u32a[mode_u8]);
+        TEST_MESSAGE(name_ca);
+        printf("BENCH %s\n", name_ca);
+    }
+    TEST_ASSERT_EQUAL_UINT32(calls_u32a[PUB_MODE_SINGLE], 7U * calls_u32a[PUB_MODE_COMPACT]);
+    TEST_ASSERT_LESS_THAN_UINT32(bytes_u32a[PUB_MODE_SINGLE], bytes_u32a[PUB_MODE_COMPACT]);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ConsoleSelectsPublishMode);
+    RUN_TEST(test_ConsoleKeepsScanTimingNotGiven);
+    RUN_TEST(test_ConsoleCommandsReleaseSensorLock);
+    RUN_TEST(test_SingleModePublishesSevenTopicsPerSensor);
+    RUN_TEST(test_CompactModePublishesOneDocumentPerSensor);
+    RUN_TEST(test_CompactDocumentHoldsAllFields);
+    RUN_TEST(test_CompactDocumentEscapesLocation);
+    RUN_TEST(test_AggregateModePublishesClosedWindowsOnce);
+    RUN_TEST(test_BenchPublishCallsAndBytesPerCycle);
+    return(UNITY_END());
+}
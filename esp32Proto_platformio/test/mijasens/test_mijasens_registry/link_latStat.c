@@ -0,0 +1 @@
+#include "latStat.c"
@@ -0,0 +1,352 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the persistent sensor registry of mijasens against the nvs stand-
+*       in: registration with the bleReg console command, debounced saves of a burst of
+*       changes, removal, and the load of the registry with one read at boot.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+// room for a full registry blob, so the registry is not limited by the sensor slots
+#define CONFIG_MIJASENS_MAX_SENSORS     64U
+
+#include "mijasens.c"
+#include "fixture_mijasens.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define CMD_GAP_MS          500U        // time between two console commands of a burst
+#define PARAMIF_COMMIT_MS   2500U       // commit delay of paramif with one scheduler tick
+
+/****************************************************************************************/
+/* Local variables: */
+
+// defined by paramif, not part of its interface
+extern void paramif_DeAllocate_stp(paramif_objHdl_t paraObj_xp);
+
+/****************************************************************************************/
+/* Local functions: */
+
+static esp_err_t CountPublish_td(mqttif_msg_t *msg_stp, uint32_t wait_u32)
+{
+    (void)msg_stp;
+    (void)wait_u32;
+    return(ESP_OK);
+}
+
+static void MakeMac_vd(uint8_t sens_u8, uint8_t *mac_u8p)
+{
+    const uint8_t mac_cu8a[mija_SIZE_MAC_ADDR] = {0xA4, 0xC1, 0x38, 0x00, 0x00, sens_u8};
+
+    memcpy(mac_u8p, mac_cu8a, mija_SIZE_MAC_ADDR);
+}
+
+/* registers a sensor with the console command, like a user typing a series of them */
+static void AddSensor_vd(uint8_t sens_u8, const char *loc_cchp)
+{
+    char cmd_ca[64];
+
+    snprintf(cmd_ca, sizeof(cmd_ca), "bleReg -a a4:c1:38:00:00:%02x -l %s", sens_u8,
+                loc_cchp);
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32(cmd_ca, stdout));
+    fixture_RunFor_vd(CMD_GAP_MS);
+}
+
+/* a reboot: the ram state is lost and the registry is loaded from nvs again */
+static void Reboot_vd(void)
+{
+    paramif_DeAllocate_stp(this_sst.regParam_xp);
+    memset(&this_sst.reg_st, 0xA5, sizeof(this_sst.reg_st));
+    this_sst.regDirty_bol = false;
+    ResetSensors_vd();
+    fake_NvsResetCounters_vd();
+    TEST_ASSERT_EQUAL(ESP_OK, LoadSensors_st());
+}
+
+void setUp(void)
+{
+    fixture_Boot_vd(CountPublish_td);
+
+    // every test starts with an empty registry in nvs
+    HandleRegistryEvent_vd();
+    memcpy(&this_sst.reg_st, &REG_DEFAULT_PARA, sizeof(registryParam_t));
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(this_sst.regParam_xp,
+                                                (uint8_t *)&this_sst.reg_st));
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    this_sst.regDirty_bol = false;
+    this_sst.regSaves_u32 = 0U;
+    fixture_flushRequest_bol = false;
+    ResetSensors_vd();
+    (void)xEventGroupClearBits(this_sst.eventGroup_st, 0xFFFFFFU);
+    (void)xTimerStart(this_sst.cycleTimer_st, 0U);
+    fake_NvsResetCounters_vd();
+}
+
+void tearDown(void)
+{
+    (void)xTimerStop(this_sst.cycleTimer_st, 0U);
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_ConsoleAddsKnownSensor(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t sensIdx_u8;
+
+    MakeMac_vd(1U, mac_u8a);
+    AddSensor_vd(1U, "kitchen");
+    sensIdx_u8 = FindSensor_u8(mac_u8a);
+    TEST_ASSERT_LESS_THAN_UINT32(MAX_MIJA_SENSORS, sensIdx_u8);
+    TEST_ASSERT_EQUAL_UINT8(1U, this_sst.sensors_sta[sensIdx_u8].para_st.knownSens_u8);
+    TEST_ASSERT_EQUAL_STRING("kitchen", this_sst.sensors_sta[sensIdx_u8].para_st.loc_cha);
+    TEST_ASSERT_EQUAL_UINT8(1U, this_sst.reg_st.count_u8);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(mac_u8a, this_sst.reg_st.entries_sta[0].macAddr_u8a,
+                                    mija_SIZE_MAC_ADDR);
+
+    // the change is only in ram until the save delay passed
+    TEST_ASSERT_TRUE(this_sst.regDirty_bol);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+    fixture_RunFor_vd(REGISTRY_SAVE_DELAY_MS + PARAMIF_COMMIT_MS);
+    TEST_ASSERT_FALSE(this_sst.regDirty_bol);
+    TEST_ASSERT_EQUAL_UINT32(1U, this_sst.regSaves_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsSetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsCommits_u32);
+
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleReg -r", stdout));
+    TEST_ASSERT_EQUAL(1, fake_ConsoleRun_s32("bleReg -a a4:c1:38", stdout));
+}
+
+/* a location which does not fit the registry entry is rejected, not truncated */
+static void test_ConsoleRejectsTooLongLocation(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t sensIdx_u8;
+
+    TEST_ASSERT_EQUAL(1, fake_ConsoleRun_s32(
+                            "bleReg -a a4:c1:38:00:00:02 -l abcdefghijklmnopqrst", stdout));
+    fixture_RunFor_vd(CMD_GAP_MS);
+    TEST_ASSERT_EQUAL_UINT8(0U, this_sst.reg_st.count_u8);
+
+    AddSensor_vd(2U, "abcdefghijklmnopqrs");
+    MakeMac_vd(2U, mac_u8a);
+    sensIdx_u8 = FindSensor_u8(mac_u8a);
+    TEST_ASSERT_LESS_THAN_UINT32(MAX_MIJA_SENSORS, sensIdx_u8);
+    TEST_ASSERT_EQUAL_STRING("abcdefghijklmnopqrs", 
+                                this_sst.sensors_sta[sensIdx_u8].para_st.loc_cha);
+    TEST_ASSERT_EQUAL_STRING("abcdefghijklmnopqrs", this_sst.reg_st.entries_sta[0].loc_cha);
+}
+
+/* a burst of registrations is written with one nvs write and one commit */
+static void test_BurstOfFiftyIsOneSave(void)
+{
+    char loc_ca[LOCATION_STRING_SIZE];
+
+    for(uint8_t sens_u8 = 0U; sens_u8 < REGISTRY_NVS_LIMIT; sens_u8++)
+    {
+        snprintf(loc_ca, sizeof(loc_ca), "room%u", sens_u8);
+        AddSensor_vd(sens_u8, loc_ca);
+    }
+    TEST_ASSERT_EQUAL_UINT8(REGISTRY_NVS_LIMIT, this_sst.reg_st.count_u8);
+    TEST_ASSERT_EQUAL_UINT8(REGISTRY_NVS_LIMIT, this_sst.usedSensors_u8);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+
+    fixture_RunFor_vd(REGISTRY_SAVE_DELAY_MS + PARAMIF_COMMIT_MS);
+    TEST_ASSERT_EQUAL_UINT32(1U, this_sst.regSaves_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsSetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsCommits_u32);
+
+    // the registry is full, a further sensor is not stored
+    AddSensor_vd(REGISTRY_NVS_LIMIT, "attic");
+    TEST_ASSERT_EQUAL_UINT8(REGISTRY_NVS_LIMIT, this_sst.reg_st.count_u8);
+    TEST_ASSERT_FALSE(this_sst.regDirty_bol);
+}
+
+/* ongoing changes delay the save, but not longer than the maximum save delay */
+static void test_OngoingChangesSavedWithinMax(void)
+{
+    uint32_t elapsed_u32 = 0U;
+
+    while((0U == this_sst.regSaves_u32) && (elapsed_u32 < (2U * REGISTRY_SAVE_MAX_MS)))
+    {
+        AddSensor_vd(1U, (0U == (elapsed_u32 & 1024U)) ? "hall" : "floor");
+        fixture_RunFor_vd(REGISTRY_SAVE_DELAY_MS / 2U);
+        elapsed_u32 += CMD_GAP_MS + (REGISTRY_SAVE_DELAY_MS / 2U);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1U, this_sst.regSaves_u32);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(REGISTRY_SAVE_MAX_MS, elapsed_u32);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(REGISTRY_SAVE_MAX_MS + REGISTRY_SAVE_DELAY_MS,
+                                        elapsed_u32);
+}
+
+static void test_SaveCommandWritesNow(void)
+{
+    AddSensor_vd(2U, "garage");
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleReg -s", stdout));
+    fixture_RunTask_vd();
+    TEST_ASSERT_EQUAL_UINT32(1U, this_sst.regSaves_u32);
+    TEST_ASSERT_FALSE(this_sst.regDirty_bol);
+
+    // nothing pending, a further save does not write
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleReg -s", stdout));
+    fixture_RunFor_vd(REGISTRY_SAVE_DELAY_MS + PARAMIF_COMMIT_MS);
+    TEST_ASSERT_EQUAL_UINT32(1U, this_sst.regSaves_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsSetCalls_u32);
+}
+
+/* the last entry moves into the gap, the sensor stays in the list as unknown sensor */
+static void test_RemoveMovesLastEntry(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    AddSensor_vd(1U, "a");
+    AddSensor_vd(2U, "b");
+    AddSensor_vd(3U, "c");
+    TEST_ASSERT_EQUAL(0, fake_ConsoleRun_s32("bleReg -d a4:c1:38:00:00:01", stdout));
+    fixture_RunTask_vd();
+
+    TEST_ASSERT_EQUAL_UINT8(2U, this_sst.reg_st.count_u8);
+    MakeMac_vd(3U, mac_u8a);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(mac_u8a, this_sst.reg_st.entries_sta[0].macAddr_u8a,
+                                    mija_SIZE_MAC_ADDR);
+    TEST_ASSERT_EQUAL_STRING("c", this_sst.reg_st.entries_sta[0].loc_cha);
+    MakeMac_vd(1U, mac_u8a);
+    TEST_ASSERT_EQUAL_UINT8(REGISTRY_SIZE, FindRegistryEntry_u8(mac_u8a));
+    TEST_ASSERT_EQUAL_UINT8(0U, 
+                this_sst.sensors_sta[FindSensor_u8(mac_u8a)].para_st.knownSens_u8);
+}
+
+/* the registry is loaded with one nvs read and restores the sensor settings */
+static void test_BootLoadsWithOneRead(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    char loc_ca[LOCATION_STRING_SIZE];
+    uint8_t sensIdx_u8;
+
+    for(uint8_t sens_u8 = 0U; sens_u8 < REGISTRY_NVS_LIMIT; sens_u8++)
+    {
+        snprintf(loc_ca, sizeof(loc_ca), "room%u", sens_u8);
+        AddSensor_vd(sens_u8, loc_ca);
+    }
+    this_sst.sensors_sta[FindSensor_u8(this_sst.reg_st.entries_sta[7].macAddr_u8a)]
+        .para_st.dbTemp_u16 = 5U;
+    TEST_ASSERT_TRUE(PostRegistryCmd_bol(REG_CMD_UPDATE, 
+                                            this_sst.reg_st.entries_sta[7].macAddr_u8a, 
+                                            NULL));
+    fixture_RunFor_vd(REGISTRY_SAVE_DELAY_MS + PARAMIF_COMMIT_MS);
+
+    Reboot_vd();
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsGetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+    TEST_ASSERT_FALSE(this_sst.regDirty_bol);
+    TEST_ASSERT_EQUAL_UINT8(REGISTRY_NVS_LIMIT, this_sst.reg_st.count_u8);
+    TEST_ASSERT_EQUAL_UINT8(REGISTRY_NVS_LIMIT, this_sst.usedSensors_u8);
+    for(uint8_t sens_u8 = 0U; sens_u8 < REGISTRY_NVS_LIMIT; sens_u8++)
+    {
+        MakeMac_vd(sens_u8, mac_u8a);
+        sensIdx_u8 = FindSensor_u8(mac_u8a);
+        TEST_ASSERT_LESS_THAN_UINT32(MAX_MIJA_SENSORS, sensIdx_u8);
+        snprintf(loc_ca, sizeof(loc_ca), "room%u", sens_u8);
+        TEST_ASSERT_EQUAL_STRING(loc_ca, this_sst.sensors_sta[sensIdx_u8].para_st.loc_cha);
+        TEST_ASSERT_EQUAL_UINT8(1U, this_sst.sensors_sta[sensIdx_u8].para_st.knownSens_u8);
+        TEST_ASSERT_EQUAL_UINT16((7U == sens_u8) ? 5U : 0U,
+                                    this_sst.sensors_sta[sensIdx_u8].para_st.dbTemp_u16);
+    }
+}
+
+/* a registry of an unknown layout or with an invalid count starts empty */
+static void test_InvalidRegistryStartsEmpty(void)
+{
+    registryParam_t reg_st;
+
+    memcpy(&reg_st, &REG_DEFAULT_PARA, sizeof(reg_st));
+    reg_st.version_u8 = REGISTRY_VERSION + 1U;
+    reg_st.count_u8 = 1U;
+    MakeMac_vd(1U, reg_st.entries_sta[0].macAddr_u8a);
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(this_sst.regParam_xp, (uint8_t *)&reg_st));
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    Reboot_vd();
+    TEST_ASSERT_EQUAL_UINT8(REGISTRY_VERSION, this_sst.reg_st.version_u8);
+    TEST_ASSERT_EQUAL_UINT8(0U, this_sst.reg_st.count_u8);
+    TEST_ASSERT_EQUAL_UINT8(0U, this_sst.usedSensors_u8);
+
+    reg_st.version_u8 = REGISTRY_VERSION;
+    reg_st.count_u8 = REGISTRY_NVS_LIMIT + 1U;
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(this_sst.regParam_xp, (uint8_t *)&reg_st));
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    Reboot_vd();
+    TEST_ASSERT_EQUAL_UINT8(0U, this_sst.reg_st.count_u8);
+    TEST_ASSERT_EQUAL_UINT8(0U, this_sst.usedSensors_u8);
+}
+
+/* a reset of the sensor list drops the unknown sensors and keeps the registered ones */
+static void test_SensorResetKeepsRegistered(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t sensIdx_u8;
+
+    AddSensor_vd(1U, "a");
+    AddSensor_vd(2U, "b");
+    MakeMac_vd(9U, mac_u8a);
+    TEST_ASSERT_LESS_THAN_UINT32(MAX_MIJA_SENSORS, AllocSensor_u8(mac_u8a));
+    TEST_ASSERT_EQUAL_UINT8(3U, this_sst.usedSensors_u8);
+
+    (void)xEventGroupSetBits(this_sst.eventGroup_st, SENSOR_RESET);
+    fixture_RunTask_vd();
+    TEST_ASSERT_EQUAL_UINT8(2U, this_sst.usedSensors_u8);
+    TEST_ASSERT_EQUAL_UINT8(MAX_MIJA_SENSORS, FindSensor_u8(mac_u8a));
+    MakeMac_vd(2U, mac_u8a);
+    sensIdx_u8 = FindSensor_u8(mac_u8a);
+    TEST_ASSERT_EQUAL_STRING("b", this_sst.sensors_sta[sensIdx_u8].para_st.loc_cha);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ConsoleAddsKnownSensor);
+    RUN_TEST(test_ConsoleRejectsTooLongLocation);
+    RUN_TEST(test_BurstOfFiftyIsOneSave);
+    RUN_TEST(test_OngoingChangesSavedWithinMax);
+    RUN_TEST(test_SaveCommandWritesNow);
+    RUN_TEST(test_RemoveMovesLastEntry);
+    RUN_TEST(test_BootLoadsWithOneRead);
+    RUN_TEST(test_InvalidRegistryStartsEmpty);
+    RUN_TEST(test_SensorResetKeepsRegistered);
+    return(UNITY_END());
+}
@@ -0,0 +1,288 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host stress test of the sample ring between the ble driver callback and the
+*       mijasens task. A producer and a consumer thread run the real ring code, a stand-
+*       in of latStat observes the sequence number of every sample the task takes out of
+*       the ring.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include <sched.h>
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+#include "mijasens.c"
+#include "fixture_mijasens.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define STRESS_SAMPLES      1000000U
+#define SEQ_MARK            0xA5A5A5A5U     // parse stamp = sequence number ^ SEQ_MARK
+#define BURST_MAX           64U             // samples the producer sends without pause
+#define IDLE_TIMEOUT_NS     1000000000ULL   // consumer waits this long for a notification
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+typedef struct stress_tag
+{
+    uint32_t consumed_u32;
+    uint32_t notified_u32;
+    uint32_t lastSeq_u32;
+    uint32_t orderErrors_u32;
+    uint32_t tornErrors_u32;
+    bool producerDone_bol;
+    bool lostWakeup_bol;
+}stress_t;
+
+/****************************************************************************************/
+/* Local variables: */
+
+static stress_t stress_sts;
+
+/****************************************************************************************/
+/* latStat stand-in, the parse stage stamps of every sample taken from the ring carry the
+   sequence number of the producer */
+
+uint32_t latStat_Now_u32(void)
+{
+    return((uint32_t)esp_timer_get_time());
+}
+
+void latStat_Record_vd(latStat_stage_t stage_en, uint32_t startUs_u32, uint32_t endUs_u32)
+{
+    if(latStat_STAGE_PARSE == stage_en)
+    {
+        if((startUs_u32 ^ SEQ_MARK) != endUs_u32)
+        {
+            stress_sts.tornErrors_u32++;
+        }
+        if((0U < stress_sts.consumed_u32) && (startUs_u32 <= stress_sts.lastSeq_u32))
+        {
+            stress_sts.orderErrors_u32++;
+        }
+        stress_sts.lastSeq_u32 = startUs_u32;
+        stress_sts.consumed_u32++;
+    }
+}
+
+bool latStat_GetHistogram_bol(latStat_stage_t stage_en, latStat_hist_t *hist_stp)
+{
+    (void)stage_en;
+    memset(hist_stp, 0, sizeof(latStat_hist_t));
+    return(false);
+}
+
+uint32_t latStat_GetPercentile_u32(const latStat_hist_t *hist_cstp, uint16_t permille_u16)
+{
+    (void)hist_cstp;
+    (void)permille_u16;
+    return(0U);
+}
+
+const char *latStat_GetStageName_cchp(latStat_stage_t stage_en)
+{
+    (void)stage_en;
+    return("");
+}
+
+void latStat_Reset_vd(void)
+{
+}
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* the ble stack: sends bursts of samples without ever waiting for the consumer */
+static void *Producer_vp(void *arg_vp)
+{
+    mijaProcl_rawSample_t raw_st;
+    uint32_t burst_u32 = 0U;
+
+    (void)arg_vp;
+    memset(&raw_st, 0, sizeof(raw_st));
+    raw_st.macAddr_u8a[0] = 0xA4;
+    raw_st.macAddr_u8a[1] = 0xC1;
+    raw_st.dataType_u8 = mija_TYPE_TEMPHUM;
+    raw_st.value2_u16 = 480U;
+
+    for(uint32_t seq_u32 = 1U; seq_u32 <= STRESS_SAMPLES; seq_u32++)
+    {
+        raw_st.macAddr_u8a[5] = (uint8_t)(seq_u32 % 4U);
+        raw_st.msgCnt_u8 = (uint8_t)seq_u32;
+        raw_st.value1_u16 = (uint16_t)(200U + (seq_u32 % 100U));
+        raw_st.rxUs_u32 = seq_u32;
+        raw_st.parsedUs_u32 = seq_u32 ^ SEQ_MARK;
+        DriverCallback_vd(&raw_st);
+
+        if(0U == burst_u32)
+        {
+            burst_u32 = 1U + (seq_u32 % BURST_MAX);
+            (void)sched_yield();
+        }
+        burst_u32--;
+    }
+    __atomic_store_n(&stress_sts.producerDone_bol, true, __ATOMIC_SEQ_CST);
+    return(NULL);
+}
+
+/* the mijasens task: drains the ring only after a notification like Task_vd */
+static void *Consumer_vp(void *arg_vp)
+{
+    EventBits_t bits_u32;
+    uint64_t idleNs_u64 = 0U;
+    bool done_bol = false;
+
+    (void)arg_vp;
+    while(false == done_bol)
+    {
+        bits_u32 = xEventGroupWaitBits(this_sst.eventGroup_st, BLE_DATA_EVENT, true, false,
+                                        portMAX_DELAY);
+        if(0U != (bits_u32 & BLE_DATA_EVENT))
+        {
+            stress_sts.notified_u32++;
+            HandleRingEvent_vd();
+            idleNs_u64 = 0U;
+        }
+        else if(true == __atomic_load_n(&stress_sts.producerDone_bol, __ATOMIC_SEQ_CST))
+        {
+            // samples left without notification would wait until the next advertisement
+            if(0U == idleNs_u64)
+            {
+                idleNs_u64 = fake_HostNs_u64();
+            }
+            else if(IDLE_TIMEOUT_NS < (fake_HostNs_u64() - idleNs_u64))
+            {
+                stress_sts.lostWakeup_bol = (this_sst.ring_st.tail_u32
+                                    != __atomic_load_n(&this_sst.ring_st.head_u32,
+                                                        __ATOMIC_SEQ_CST));
+                done_bol = true;
+            }
+        }
+        else
+        {
+            (void)sched_yield();
+        }
+    }
+    return(NULL);
+}
+
+void setUp(void)
+{
+    fixture_Boot_vd(NULL);
+
+    ResetSensors_vd();
+    memset(&this_sst.ring_st, 0, sizeof(this_sst.ring_st));
+    memset(&stress_sts, 0, sizeof(stress_sts));
+    (void)xEventGroupClearBits(this_sst.eventGroup_st, 0xFFFFFFU);
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_FullRingDropsAndCounts(void)
+{
+    mijaProcl_rawSample_t raw_st;
+
+    memset(&raw_st, 0, sizeof(raw_st));
+    raw_st.dataType_u8 = mija_TYPE_TEMPHUM;
+    for(uint32_t seq_u32 = 1U; seq_u32 <= (RAW_RING_SIZE + 5U); seq_u32++)
+    {
+        raw_st.rxUs_u32 = seq_u32;
+        raw_st.parsedUs_u32 = seq_u32 ^ SEQ_MARK;
+        DriverCallback_vd(&raw_st);
+    }
+    TEST_ASSERT_EQUAL_UINT32(RAW_RING_SIZE + 5U, this_sst.ring_st.received_u32);
+    TEST_ASSERT_EQUAL_UINT32(5U, this_sst.ring_st.dropped_u32);
+
+    // one notification for the whole batch, the oldest samples are kept
+    TEST_ASSERT_EQUAL_HEX32(BLE_DATA_EVENT, xEventGroupClearBits(this_sst.eventGroup_st,
+                                                                    BLE_DATA_EVENT));
+    HandleRingEvent_vd();
+    TEST_ASSERT_EQUAL_UINT32(RAW_RING_SIZE, stress_sts.consumed_u32);
+    TEST_ASSERT_EQUAL_UINT32(RAW_RING_SIZE, stress_sts.lastSeq_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, xEventGroupGetBits(this_sst.eventGroup_st));
+
+    // the drained ring notifies again with the next sample
+    DriverCallback_vd(&raw_st);
+    TEST_ASSERT_EQUAL_HEX32(BLE_DATA_EVENT, xEventGroupGetBits(this_sst.eventGroup_st));
+}
+
+/* producer and consumer on their own threads, every sample is either taken out in order
+   and intact or counted as dropped, and no sample is left without notification */
+static void test_StressProducerConsumerThreads(void)
+{
+    pthread_t producer_st;
+    pthread_t consumer_st;
+    uint64_t startNs_u64 = fake_HostNs_u64();
+    uint64_t elapsedNs_u64;
+    char line_ca[128];
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&consumer_st, NULL, Consumer_vp, NULL));
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer_st, NULL, Producer_vp, NULL));
+    (void)pthread_join(producer_st, NULL);
+    (void)pthread_join(consumer_st, NULL);
+    elapsedNs_u64 = fake_HostNs_u64() - startNs_u64;
+
+    TEST_ASSERT_FALSE(stress_sts.lostWakeup_bol);
+    TEST_ASSERT_EQUAL_UINT32(0U, stress_sts.tornErrors_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stress_sts.orderErrors_u32);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_SAMPLES, this_sst.ring_st.received_u32);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_SAMPLES,
+                                stress_sts.consumed_u32 + this_sst.ring_st.dropped_u32);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_SAMPLES, stress_sts.lastSeq_u32);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(stress_sts.consumed_u32, stress_sts.notified_u32);
+
+    fake_Bench_vd("mijasens ring producer/consumer", STRESS_SAMPLES, elapsedNs_u64);
+    snprintf(line_ca, sizeof(line_ca), "mijasens ring: %u consumed, %u dropped, "
+                "%.1f samples per notification", stress_sts.consumed_u32,
+                this_sst.ring_st.dropped_u32,
+                (double)stress_sts.consumed_u32 / stress_sts.notified_u32);
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_FullRingDropsAndCounts);
+    RUN_TEST(test_StressProducerConsumerThreads);
+    return(UNITY_END());
+}
@@ -0,0 +1,284 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the publish scheduler of mijasens with a fake clock. 16 sensors
+*       advertise with their own phase into 24 sensor slots, the publish handler records
+*       the publications per slot and the time from the first unpublished reception to
+*       the publication.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+#include "fake_ble.h"
+#include "fake_ccm.h"
+
+// more slots than sensors, empty slots must not be published
+#define CONFIG_MIJASENS_MAX_SENSORS     24U
+
+#include "mijasens.c"
+#include "fixture_mijasens.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define SENSORS_NUM         16U
+#define STEP_MS             100U        // resolution of the simulation
+#define ADV_PERIOD_MS       2000U       // advertisement period of the simulated sensors
+#define RUN_MS              (30U * PUB_CYCLE_MS)
+
+/****************************************************************************************/
+/* Local variables: */
+
+static uint32_t pubs_u32sa[CONFIG_MIJASENS_MAX_SENSORS];        // per sensor slot
+static int64_t pendingUs_s64sa[SENSORS_NUM];    // per sensor, oldest unpublished sample
+static uint32_t maxLatMs_u32s;
+static uint32_t tickPubs_u32s;
+static uint32_t maxTickPubs_u32s;
+static uint32_t foreignPubs_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* publish handler of the mqtt driver, the sensor slot is taken from the topic */
+static esp_err_t RecordPublish_td(mqttif_msg_t *msg_stp, uint32_t wait_u32)
+{
+    unsigned int id_u32 = 0U;
+    uint32_t slot_u32;
+    uint8_t sens_u8;
+    uint32_t latMs_u32;
+
+    (void)wait_u32;
+    if(   (1 == sscanf(msg_stp->topic_chp, "std/dev/s/%u/", &id_u32))
+       && (1U <= id_u32) && (SENSORS_NUM >= id_u32))
+    {
+        slot_u32 = id_u32 - 1U;
+        sens_u8 = this_sst.sensors_sta[slot_u32].para_st.macAddr_u8a[5];
+        pubs_u32sa[slot_u32]++;
+        tickPubs_u32s++;
+        if(0 <= pendingUs_s64sa[sens_u8])
+        {
+            latMs_u32 = (uint32_t)((fake_nowUs_s64 - pendingUs_s64sa[sens_u8]) / 1000);
+            maxLatMs_u32s = (latMs_u32 > maxLatMs_u32s) ? latMs_u32 : maxLatMs_u32s;
+            pendingUs_s64sa[sens_u8] = -1;
+        }
+    }
+    else
+    {
+        foreignPubs_u32s++;
+    }
+    return(ESP_OK);
+}
+
+/* one pass of the module task, the bits are handled like in Task_vd */
+static void RunTask_vd(void)
+{
+    EventBits_t bits_u32 = xEventGroupWaitBits(this_sst.eventGroup_st,
+                                BLE_DATA_EVENT | CYCLE_TIMER, true, false, 0U);
+
+    if(0U != (bits_u32 & BLE_DATA_EVENT))
+    {
+        HandleRingEvent_vd();
+    }
+    if(0U != (bits_u32 & CYCLE_TIMER))
+    {
+        tickPubs_u32s = 0U;
+        RunPublishScheduler_vd();
+        maxTickPubs_u32s = (tickPubs_u32s > maxTickPubs_u32s) ?
+                                tickPubs_u32s : maxTickPubs_u32s;
+    }
+}
+
+/* sends a new temperature of the sensor, every sample is a change */
+static void SendSample_vd(uint8_t sens_u8, uint8_t msgCnt_u8)
+{
+    mijaProcl_rawSample_t raw_st;
+
+    memset(&raw_st, 0, sizeof(raw_st));
+    raw_st.macAddr_u8a[0] = 0xA4;
+    raw_st.macAddr_u8a[1] = 0xC1;
+    raw_st.macAddr_u8a[5] = sens_u8;
+    raw_st.msgCnt_u8 = msgCnt_u8;
+    raw_st.dataType_u8 = mija_TYPE_TEMPHUM;
+    raw_st.value1_u16 = (uint16_t)(200 + msgCnt_u8);
+    raw_st.value2_u16 = 480U;
+    DriverCallback_vd(&raw_st);
+    if(0 > pendingUs_s64sa[sens_u8])
+    {
+        pendingUs_s64sa[sens_u8] = fake_nowUs_s64;
+    }
+}
+
+/* the sensors advertise with their own phase while the clock advances */
+static void RunFor_vd(uint32_t ms_u32)
+{
+    uint32_t phaseMs_u32;
+
+    for(uint32_t time_u32 = 0U; time_u32 < ms_u32; time_u32 += STEP_MS)
+    {
+        for(uint8_t sens_u8 = 0U; sens_u8 < SENSORS_NUM; sens_u8++)
+        {
+            phaseMs_u32 = (sens_u8 * 700U) % ADV_PERIOD_MS;
+            if(0U == ((time_u32 + phaseMs_u32) % ADV_PERIOD_MS))
+            {
+                SendSample_vd(sens_u8, (uint8_t)(time_u32 / ADV_PERIOD_MS));
+            }
+        }
+        RunTask_vd();
+        fake_AdvanceMs_vd(STEP_MS);
+        RunTask_vd();
+    }
+}
+
+void setUp(void)
+{
+    fixture_Boot_vd(RecordPublish_td);
+
+    ResetSensors_vd();
+    memset(&this_sst.db_st, 0, sizeof(this_sst.db_st));
+    this_sst.pubMode_en = PUB_MODE_COMPACT;
+    OnConnectionHandler_vd();
+    (void)xEventGroupClearBits(this_sst.eventGroup_st, 0xFFFFFFU);
+    (void)xTimerStart(this_sst.cycleTimer_st, 0U);
+    memset(pubs_u32sa, 0, sizeof(pubs_u32sa));
+    for(uint32_t idx_u32 = 0U; idx_u32 < SENSORS_NUM; idx_u32++)
+    {
+        pendingUs_s64sa[idx_u32] = -1;
+    }
+    maxLatMs_u32s = 0U;
+    maxTickPubs_u32s = 0U;
+    foreignPubs_u32s = 0U;
+}
+
+void tearDown(void)
+{
+    (void)xTimerStop(this_sst.cycleTimer_st, 0U);
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* every sensor gets the same share of the publications, empty slots get none */
+static void test_AllSensorsArePublishedEqually(void)
+{
+    uint32_t min_u32 = UINT32_MAX;
+    uint32_t max_u32 = 0U;
+
+    RunFor_vd(RUN_MS);
+    TEST_ASSERT_EQUAL_UINT8(SENSORS_NUM, this_sst.usedSensors_u8);
+    for(uint32_t sens_u32 = 0U; sens_u32 < SENSORS_NUM; sens_u32++)
+    {
+        min_u32 = (pubs_u32sa[sens_u32] < min_u32) ? pubs_u32sa[sens_u32] : min_u32;
+        max_u32 = (pubs_u32sa[sens_u32] > max_u32) ? pubs_u32sa[sens_u32] : max_u32;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1U, max_u32 - min_u32);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32((RUN_MS / PUB_CYCLE_MS) - 1U, min_u32);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32((RUN_MS / PUB_CYCLE_MS) + 1U, max_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, foreignPubs_u32s);
+}
+
+/* the publications are spread over the cycle instead of a burst per cycle */
+static void test_PublicationsAreSpreadOverTheCycle(void)
+{
+    uint32_t budget_u32 = ((SENSORS_NUM * SCHED_TICK_MS) + PUB_CYCLE_MS - 1U)
+                            / PUB_CYCLE_MS;
+
+    RunFor_vd(RUN_MS);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(budget_u32, maxTickPubs_u32s);
+}
+
+/* a received sample is published within one cycle plus the round robin delay */
+static void test_ReceptionToPublishLatencyIsBounded(void)
+{
+    uint32_t budget_u32 = ((SENSORS_NUM * SCHED_TICK_MS) + PUB_CYCLE_MS - 1U)
+                            / PUB_CYCLE_MS;
+    uint32_t boundMs_u32 = PUB_CYCLE_MS + (((SENSORS_NUM + budget_u32 - 1U) / budget_u32)
+                                            * SCHED_TICK_MS);
+    char line_ca[96];
+
+    RunFor_vd(RUN_MS);
+    snprintf(line_ca, sizeof(line_ca), "mijasens scheduler: %u sensors, max latency %u ms, "
+                "bound %u ms", SENSORS_NUM, maxLatMs_u32s, boundMs_u32);
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(boundMs_u32, maxLatMs_u32s);
+}
+
+static void test_SensorIntervalIsKept(void)
+{
+    static const uint8_t MAC2_CU8A[mija_SIZE_MAC_ADDR] = {0xA4, 0xC1, 0U, 0U, 0U, 2U};
+    static const uint8_t MAC3_CU8A[mija_SIZE_MAC_ADDR] = {0xA4, 0xC1, 0U, 0U, 0U, 3U};
+    static const uint8_t MAC4_CU8A[mija_SIZE_MAC_ADDR] = {0xA4, 0xC1, 0U, 0U, 0U, 4U};
+    uint8_t slot2_u8;
+    uint8_t slot3_u8;
+
+    RunFor_vd(PUB_CYCLE_MS);
+    // sensor 2 only every third default cycle, sensor 3 every 10 s
+    slot2_u8 = FindSensor_u8(MAC2_CU8A);
+    slot3_u8 = FindSensor_u8(MAC3_CU8A);
+    this_sst.sensors_sta[slot2_u8].para_st.pubIntv_u16 = 3U * (PUB_CYCLE_MS / 1000U);
+    this_sst.sensors_sta[slot3_u8].para_st.pubIntv_u16 = 10U;
+    memset(pubs_u32sa, 0, sizeof(pubs_u32sa));
+
+    RunFor_vd(RUN_MS);
+    TEST_ASSERT_UINT32_WITHIN(1U, RUN_MS / (3U * PUB_CYCLE_MS), pubs_u32sa[slot2_u8]);
+    TEST_ASSERT_UINT32_WITHIN(2U, RUN_MS / 10000U, pubs_u32sa[slot3_u8]);
+    TEST_ASSERT_UINT32_WITHIN(1U, RUN_MS / PUB_CYCLE_MS,
+                                pubs_u32sa[FindSensor_u8(MAC4_CU8A)]);
+}
+
+/* sensors without a new sample are not published again */
+static void test_UnchangedSensorsAreSkipped(void)
+{
+    RunFor_vd(PUB_CYCLE_MS);
+    memset(pubs_u32sa, 0, sizeof(pubs_u32sa));
+    for(uint32_t tick_u32 = 0U; tick_u32 < (RUN_MS / SCHED_TICK_MS); tick_u32++)
+    {
+        fake_AdvanceMs_vd(SCHED_TICK_MS);
+        RunTask_vd();
+    }
+    for(uint32_t sens_u32 = 0U; sens_u32 < SENSORS_NUM; sens_u32++)
+    {
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(1U, pubs_u32sa[sens_u32]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_AllSensorsArePublishedEqually);
+    RUN_TEST(test_PublicationsAreSpreadOverTheCycle);
+    RUN_TEST(test_ReceptionToPublishLatencyIsBounded);
+    RUN_TEST(test_SensorIntervalIsKept);
+    RUN_TEST(test_UnchangedSensorsAreSkipped);
+    return(UNITY_END());
+}
@@ -0,0 +1,455 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host test of the export and import of all parameter objects. A document exported
+*       by one device is imported by a new one directly and in base64 parts over the
+*       console, documents which do not fit the device are rejected without change. The
+*       provisioning by one command per parameter set is compared with the bulk import
+*       by console lines and nvs commits.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+
+#include "paramif.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define SETUP_OBJECTS_NUM   10U
+#define PARAM_MAX_SIZE      2048U
+#define REPLY_MAX_SIZE      2100U       // one part of the export document incl. text
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* parameter set allocated at boot by one of the modules */
+typedef struct setupObject_tag
+{
+    const char *ident_cchp;
+    uint16_t length_u16;
+}setupObject_t;
+
+/* console lines and nvs accesses of a provisioning */
+typedef struct provCount_tag
+{
+    uint32_t lines_u32;
+    uint32_t sets_u32;
+    uint32_t commits_u32;
+}provCount_t;
+
+/****************************************************************************************/
+/* Local variables: */
+
+/* the parameter sets of controlTask, wifiCtrl, devmgr and mijasens with their sizes */
+static const setupObject_t SETUP_OBJECTS_CSTA[SETUP_OBJECTS_NUM] =
+{
+    {"ctrl", 8U}, {"wifiMode", 4U}, {"wifiStation", 100U}, {"devmgr", 12U},
+    {"mijaScan", 16U}, {"mijaFilt", 12U}, {"mijaPub", 4U}, {"mijaKey", 340U},
+    {"mijaReg", 1704U}, {"mijaDb", 16U}
+};
+
+static uint8_t defaults_u8sa[PARAM_MAX_SIZE];
+static paramif_objHdl_t handles_xpsa[SETUP_OBJECTS_NUM];
+static uint32_t lines_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* runs a command line like the console socket and returns the reply text */
+static int32_t RunLine_s32(const char *line_cchp, char *reply_chp, size_t size_st)
+{
+    FILE *out_xp = tmpfile();
+    int32_t result_s32;
+    size_t length_st;
+
+    TEST_ASSERT_NOT_NULL(out_xp);
+    lines_u32s++;
+    result_s32 = fake_ConsoleRun_s32(line_cchp, out_xp);
+    rewind(out_xp);
+    length_st = fread(reply_chp, 1U, size_st - 1U, out_xp);
+    reply_chp[length_st] = '\0';
+    fclose(out_xp);
+    return(result_s32);
+}
+
+/* power off without flush, the ram shadow is lost */
+static void PowerOff_vd(void)
+{
+    for(uint16_t idx_u16 = 0U; idx_u16 < POOL_BLOCK_SIZE; idx_u16++)
+    {
+        free(firstBlock_sts.objects_sta[idx_u16].blob_u8p);
+    }
+    memset(&firstBlock_sts, 0, sizeof(firstBlock_sts));
+    memset(&stats_sts, 0, sizeof(stats_sts));
+    memset(handles_xpsa, 0, sizeof(handles_xpsa));
+    dirtyObjects_u16s = 0U;
+    moduleState_ens = STATE_NOT_INITIALIZED;
+    free(importBuf_u8ps);
+    importBuf_u8ps = NULL;
+    importLen_u16s = 0U;
+    fake_ConsoleReset_vd();
+    fake_TimersReset_vd();
+    commitTimer_sts = NULL;
+}
+
+/* every module allocates its parameters, the control task registers the console */
+static void Boot_vd(void)
+{
+    paramif_param_t param_st;
+    paramif_allocParam_t alloc_st;
+
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeParameter_td(&param_st));
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Initialize_td(&param_st));
+    for(uint8_t idx_u8 = 0U; idx_u8 < SETUP_OBJECTS_NUM; idx_u8++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeAllocParameter_td(&alloc_st));
+        alloc_st.nvsIdent_cp = SETUP_OBJECTS_CSTA[idx_u8].ident_cchp;
+        alloc_st.length_u16 = SETUP_OBJECTS_CSTA[idx_u8].length_u16;
+        alloc_st.defaults_u8p = defaults_u8sa;
+        handles_xpsa[idx_u8] = paramif_Allocate_stp(&alloc_st);
+        TEST_ASSERT_NOT_NULL(handles_xpsa[idx_u8]);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_RegisterCommands_td());
+}
+
+/* a new device from the factory, the nvs holds no parameters */
+static void NewDevice_vd(void)
+{
+    PowerOff_vd();
+    fake_NvsReset_vd();
+    Boot_vd();
+    fake_NvsResetCounters_vd();
+    lines_u32s = 0U;
+}
+
+static void FillObject_vd(uint8_t idx_u8, uint8_t seed_u8, uint8_t *data_u8p)
+{
+    for(uint16_t pos_u16 = 0U; pos_u16 < SETUP_OBJECTS_CSTA[idx_u8].length_u16; pos_u16++)
+    {
+        data_u8p[pos_u16] = (uint8_t)(seed_u8 + idx_u8 + pos_u16);
+    }
+}
+
+/* the setup of a device in the field, stored with one flush */
+static void WriteSetup_vd(uint8_t seed_u8)
+{
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < SETUP_OBJECTS_NUM; idx_u8++)
+    {
+        FillObject_vd(idx_u8, seed_u8, data_u8a);
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[idx_u8], data_u8a));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+}
+
+static void CheckSetup_vd(uint8_t seed_u8)
+{
+    uint8_t expected_u8a[PARAM_MAX_SIZE];
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < SETUP_OBJECTS_NUM; idx_u8++)
+    {
+        FillObject_vd(idx_u8, seed_u8, expected_u8a);
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[idx_u8], data_u8a));
+        TEST_ASSERT_EQUAL_MEMORY(expected_u8a, data_u8a,
+                                    SETUP_OBJECTS_CSTA[idx_u8].length_u16);
+    }
+}
+
+static uint8_t *Export_u8p(size_t *length_stp)
+{
+    uint8_t *doc_u8p;
+
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Export_td(NULL, 0U, length_stp));
+    doc_u8p = malloc(*length_stp);
+    TEST_ASSERT_NOT_NULL(doc_u8p);
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Export_td(doc_u8p, *length_stp, length_stp));
+    return(doc_u8p);
+}
+
+/* collects the base64 parts of the export document from the console of the source
+   device, the parts are stored as "para -a" lines for the target device */
+static uint16_t ExportLines_u16(char lines_caa[][REPLY_MAX_SIZE + 8U], uint16_t max_u16)
+{
+    char command_ca[32];
+    char reply_ca[REPLY_MAX_SIZE];
+    char *text_chp;
+    unsigned int part_u32 = 0U;
+    unsigned int parts_u32 = 1U;
+
+    while(part_u32 < parts_u32)
+    {
+        TEST_ASSERT_LESS_THAN_UINT32(max_u16, part_u32);
+        snprintf(command_ca, sizeof(command_ca), "para -e %u", part_u32);
+        TEST_ASSERT_EQUAL(0, RunLine_s32(command_ca, reply_ca, sizeof(reply_ca)));
+        TEST_ASSERT_EQUAL(2, sscanf(reply_ca, "part %u of %u", &part_u32, &parts_u32));
+        text_chp = strchr(reply_ca, '\n') + 1;
+        text_chp[strcspn(text_chp, "\n")] = '\0';
+        snprintf(lines_caa[part_u32 - 1U], REPLY_MAX_SIZE + 8U, "para -a %s", text_chp);
+    }
+    return((uint16_t)parts_u32);
+}
+
+void setUp(void)
+{
+    memset(defaults_u8sa, 0xA5, sizeof(defaults_u8sa));
+    fake_PartSetup_vd(paramlog_PARTITION_LABEL, 0U);
+    NewDevice_vd();
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* the export of a device is imported by a new one with one commit and survives the
+   reboot of the new device */
+static void test_ExportImportRoundTrip(void)
+{
+    uint8_t *doc_u8p;
+    size_t length_st;
+    size_t small_st;
+
+    WriteSetup_vd(0x10U);
+    doc_u8p = Export_u8p(&length_st);
+    small_st = length_st - 1U;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE,
+                        paramif_Export_td(doc_u8p, small_st, &small_st));
+    TEST_ASSERT_EQUAL_UINT32(length_st, small_st);
+
+    NewDevice_vd();
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Import_td(doc_u8p, length_st));
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsCommits_u32);
+    TEST_ASSERT_EQUAL_UINT32(SETUP_OBJECTS_NUM, fake_nvsSetCalls_u32);
+    CheckSetup_vd(0x10U);
+
+    PowerOff_vd();
+    Boot_vd();
+    CheckSetup_vd(0x10U);
+
+    // the same document again changes no object
+    fake_NvsResetCounters_vd();
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Import_td(doc_u8p, length_st));
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+    free(doc_u8p);
+}
+
+/* a document which does not fit the device is rejected before any object changes */
+static void test_InvalidDocumentRejected(void)
+{
+    paramif_allocParam_t alloc_st;
+    uint8_t *doc_u8p;
+    size_t length_st;
+    uint16_t length_u16 = 20U;
+
+    WriteSetup_vd(0x20U);
+    doc_u8p = Export_u8p(&length_st);
+    NewDevice_vd();
+    WriteSetup_vd(0x30U);
+    fake_NvsResetCounters_vd();
+
+    // bad crc, truncated document and no document
+    doc_u8p[length_st - 1U] ^= 0x01U;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, paramif_Import_td(doc_u8p, length_st));
+    doc_u8p[length_st - 1U] ^= 0x01U;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, paramif_Import_td(doc_u8p, length_st - 1U));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, paramif_Import_td(doc_u8p, 4U));
+    TEST_ASSERT_EQUAL(ESP_FAIL, paramif_Import_td(NULL, length_st));
+    CheckSetup_vd(0x30U);
+    free(doc_u8p);
+
+    // an object of the source device is unknown to the target
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeAllocParameter_td(&alloc_st));
+    alloc_st.nvsIdent_cp = "extra";
+    alloc_st.length_u16 = sizeof(length_u16);
+    alloc_st.defaults_u8p = (uint8_t *)&length_u16;
+    TEST_ASSERT_NOT_NULL(paramif_Allocate_stp(&alloc_st));
+    doc_u8p = Export_u8p(&length_st);
+    NewDevice_vd();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, paramif_Import_td(doc_u8p, length_st));
+    free(doc_u8p);
+
+    // an object with another length on the target
+    paramif_DeAllocate_stp(handles_xpsa[SETUP_OBJECTS_NUM - 1U]);
+    alloc_st.nvsIdent_cp = SETUP_OBJECTS_CSTA[SETUP_OBJECTS_NUM - 1U].ident_cchp;
+    alloc_st.length_u16 = sizeof(length_u16);
+    handles_xpsa[SETUP_OBJECTS_NUM - 1U] = paramif_Allocate_stp(&alloc_st);
+    TEST_ASSERT_NOT_NULL(handles_xpsa[SETUP_OBJECTS_NUM - 1U]);
+    doc_u8p = Export_u8p(&length_st);
+    paramif_DeAllocate_stp(handles_xpsa[SETUP_OBJECTS_NUM - 1U]);
+    alloc_st.length_u16 = SETUP_OBJECTS_CSTA[SETUP_OBJECTS_NUM - 1U].length_u16;
+    alloc_st.defaults_u8p = defaults_u8sa;
+    TEST_ASSERT_NOT_NULL(paramif_Allocate_stp(&alloc_st));
+    fake_NvsResetCounters_vd();
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, paramif_Import_td(doc_u8p, length_st));
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsCommits_u32);
+    free(doc_u8p);
+}
+
+/* an import which can not be stored leaves the parameters of before, in ram and nvs */
+static void test_FailedImportRestoresShadows(void)
+{
+    uint8_t *doc_u8p;
+    size_t length_st;
+
+    WriteSetup_vd(0x60U);
+    doc_u8p = Export_u8p(&length_st);
+    WriteSetup_vd(0x70U);
+    fake_NvsResetCounters_vd();
+
+    fake_nvsSetFail_bol = true;
+    TEST_ASSERT_EQUAL(ESP_FAIL, paramif_Import_td(doc_u8p, length_st));
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsCommits_u32);
+    TEST_ASSERT_EQUAL_UINT16(0U, dirtyObjects_u16s);
+    CheckSetup_vd(0x70U);
+
+    fake_nvsSetFail_bol = false;
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsCommits_u32);
+    PowerOff_vd();
+    Boot_vd();
+    CheckSetup_vd(0x70U);
+
+    // the same document is stored once the nvs works again
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Import_td(doc_u8p, length_st));
+    CheckSetup_vd(0x60U);
+    free(doc_u8p);
+}
+
+/* the document travels in base64 parts over the console, a broken part drops it */
+static void test_ConsoleRoundTrip(void)
+{
+    static char lines_casa[4][REPLY_MAX_SIZE + 8U];
+    char reply_ca[REPLY_MAX_SIZE];
+    uint16_t parts_u16;
+
+    WriteSetup_vd(0x40U);
+    parts_u16 = ExportLines_u16(lines_casa, 4U);
+    TEST_ASSERT_EQUAL_UINT16(2U, parts_u16);
+    TEST_ASSERT_EQUAL(0, RunLine_s32("para -e 9", reply_ca, sizeof(reply_ca)));
+    TEST_ASSERT_EQUAL_STRING("document has 2 parts\n", reply_ca);
+
+    // a part which is not base64 drops the document, the import finds none
+    NewDevice_vd();
+    TEST_ASSERT_EQUAL(0, RunLine_s32(lines_casa[0], reply_ca, sizeof(reply_ca)));
+    TEST_ASSERT_EQUAL(0, RunLine_s32("para -a **", reply_ca, sizeof(reply_ca)));
+    TEST_ASSERT_EQUAL_STRING("part not decoded, import document dropped\n", reply_ca);
+    TEST_ASSERT_EQUAL(1, RunLine_s32("para -i", reply_ca, sizeof(reply_ca)));
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsCommits_u32);
+
+    // the missing second part is noticed by the check of the document
+    TEST_ASSERT_EQUAL(0, RunLine_s32(lines_casa[0], reply_ca, sizeof(reply_ca)));
+    TEST_ASSERT_EQUAL(1, RunLine_s32("para -i", reply_ca, sizeof(reply_ca)));
+    TEST_ASSERT_EQUAL_STRING("import document rejected\n", reply_ca);
+
+    for(uint16_t idx_u16 = 0U; idx_u16 < parts_u16; idx_u16++)
+    {
+        TEST_ASSERT_EQUAL(0, RunLine_s32(lines_casa[idx_u16], reply_ca, sizeof(reply_ca)));
+    }
+    TEST_ASSERT_EQUAL(0, RunLine_s32("para -i", reply_ca, sizeof(reply_ca)));
+    TEST_ASSERT_EQUAL_STRING("parameters imported, reboot to apply\n", reply_ca);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsCommits_u32);
+    PowerOff_vd();
+    Boot_vd();
+    CheckSetup_vd(0x40U);
+}
+
+/* provisioning of a new device over the console socket: before, every parameter set
+   had its own command (stpa, mod, dev, bleSet, ...) which wrote and committed it, now
+   the export parts of a reference device are appended and imported at once */
+static void test_ProvisioningComparison(void)
+{
+    static char lines_casa[4][REPLY_MAX_SIZE + 8U];
+    char reply_ca[REPLY_MAX_SIZE];
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+    provCount_t single_st;
+    provCount_t bulk_st;
+    uint16_t parts_u16;
+    char text_ca[160];
+
+    WriteSetup_vd(0x50U);
+    parts_u16 = ExportLines_u16(lines_casa, 4U);
+
+    // one command per parameter set, each with its own commit
+    NewDevice_vd();
+    for(uint8_t idx_u8 = 0U; idx_u8 < SETUP_OBJECTS_NUM; idx_u8++)
+    {
+        lines_u32s++;
+        FillObject_vd(idx_u8, 0x50U, data_u8a);
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[idx_u8], data_u8a));
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    }
+    CheckSetup_vd(0x50U);
+    single_st.lines_u32 = lines_u32s;
+    single_st.sets_u32 = fake_nvsSetCalls_u32;
+    single_st.commits_u32 = fake_nvsCommits_u32;
+
+    // the parts of the document and one import
+    NewDevice_vd();
+    for(uint16_t idx_u16 = 0U; idx_u16 < parts_u16; idx_u16++)
+    {
+        TEST_ASSERT_EQUAL(0, RunLine_s32(lines_casa[idx_u16], reply_ca, sizeof(reply_ca)));
+    }
+    TEST_ASSERT_EQUAL(0, RunLine_s32("para -i", reply_ca, sizeof(reply_ca)));
+    CheckSetup_vd(0x50U);
+    bulk_st.lines_u32 = lines_u32s;
+    bulk_st.sets_u32 = fake_nvsSetCalls_u32;
+    bulk_st.commits_u32 = fake_nvsCommits_u32;
+
+    snprintf(text_ca, sizeof(text_ca), "provisioning of %u parameter sets, console lines "
+                "%u -> %u, nvs sets %u -> %u, commits %u -> %u", SETUP_OBJECTS_NUM,
+                single_st.lines_u32, bulk_st.lines_u32, single_st.sets_u32,
+                bulk_st.sets_u32, single_st.commits_u32, bulk_st.commits_u32);
+    TEST_MESSAGE(text_ca);
+    printf("BENCH %s\n", text_ca);
+    TEST_ASSERT_EQUAL_UINT32(parts_u16 + 1U, bulk_st.lines_u32);
+    TEST_ASSERT_LESS_THAN_UINT32(single_st.lines_u32, bulk_st.lines_u32);
+    TEST_ASSERT_EQUAL_UINT32(SETUP_OBJECTS_NUM, single_st.commits_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, bulk_st.commits_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ExportImportRoundTrip);
+    RUN_TEST(test_InvalidDocumentRejected);
+    RUN_TEST(test_FailedImportRestoresShadows);
+    RUN_TEST(test_ConsoleRoundTrip);
+    RUN_TEST(test_ProvisioningComparison);
+    return(UNITY_END());
+}
@@ -0,0 +1,308 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host test of the versioned parameter blobs of paramif. Raw blobs of the first
+*       firmware and blobs with header of version 2 are upgraded to version 3 by the
+*       migration function, unusable blobs fall back to the defaults. The benchmark
+*       migrates 50 objects at boot.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+
+#include "paramif.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define SCHEMA_VERSION      3U
+#define BENCH_OBJECTS_NUM   50U
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* the schema history of a parameter set: version 1 stored the interval only, version 2
+   added the window, version 3 the offset */
+typedef struct schemaV1_tag
+{
+    uint16_t interval_u16;
+}schemaV1_t;
+
+typedef struct schemaV2_tag
+{
+    uint16_t interval_u16;
+    uint16_t window_u16;
+}schemaV2_t;
+
+typedef struct schemaV3_tag
+{
+    uint16_t interval_u16;
+    uint16_t window_u16;
+    int16_t offset_s16;
+}schemaV3_t;
+
+/****************************************************************************************/
+/* Local variables: */
+
+static const schemaV3_t DEFAULTS_CST = {.interval_u16 = 1U, .window_u16 = 1U,
+                                        .offset_s16 = 1};
+static uint32_t migrations_u32s;
+static bool initialized_bols = false;
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* upgrades the data one version, the new fields get the values of the old firmware */
+static esp_err_t Migrate_td(uint8_t version_u8, uint8_t *data_u8p, uint16_t *length_u16p,
+                                uint16_t bufSize_u16)
+{
+    esp_err_t err_st = ESP_FAIL;
+    schemaV2_t v2_st;
+    schemaV3_t v3_st;
+
+    migrations_u32s++;
+    if((1U == version_u8) && (sizeof(schemaV2_t) <= bufSize_u16))
+    {
+        memcpy(&v2_st, data_u8p, sizeof(schemaV1_t));
+        v2_st.window_u16 = 7U;
+        memcpy(data_u8p, &v2_st, sizeof(v2_st));
+        *length_u16p = sizeof(v2_st);
+        err_st = ESP_OK;
+    }
+    else if((2U == version_u8) && (sizeof(schemaV3_t) <= bufSize_u16))
+    {
+        memcpy(&v3_st, data_u8p, sizeof(schemaV2_t));
+        v3_st.offset_s16 = -9;
+        memcpy(data_u8p, &v3_st, sizeof(v3_st));
+        *length_u16p = sizeof(v3_st);
+        err_st = ESP_OK;
+    }
+    return(err_st);
+}
+
+/* stores a blob of the given version with header, like a former firmware */
+static void PutVersion_vd(const char *ident_cchp, uint8_t version_u8, const void *data_cvp,
+                            uint16_t length_u16)
+{
+    uint8_t blob_u8a[sizeof(blobHeader_t) + sizeof(schemaV3_t)];
+    blobHeader_t header_st;
+
+    header_st.magic_u16 = BLOB_MAGIC;
+    header_st.length_u16 = length_u16;
+    header_st.crc_u16 = crc16_le(0U, data_cvp, length_u16);
+    header_st.version_u8 = version_u8;
+    header_st.reserved_u8 = 0U;
+    memcpy(blob_u8a, &header_st, sizeof(header_st));
+    memcpy(&blob_u8a[sizeof(header_st)], data_cvp, length_u16);
+    fake_NvsPut_vd(ident_cchp, blob_u8a, sizeof(header_st) + length_u16);
+}
+
+static paramif_objHdl_t Allocate_xp(const char *ident_cchp, paramif_Migrate_td migrate_fp)
+{
+    paramif_allocParam_t alloc_st;
+
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeAllocParameter_td(&alloc_st));
+    alloc_st.nvsIdent_cp = ident_cchp;
+    alloc_st.length_u16 = sizeof(schemaV3_t);
+    alloc_st.defaults_u8p = (uint8_t *)&DEFAULTS_CST;
+    alloc_st.version_u8 = SCHEMA_VERSION;
+    alloc_st.migrate_fp = migrate_fp;
+    return(paramif_Allocate_stp(&alloc_st));
+}
+
+static void ReadV3_vd(paramif_objHdl_t handle_xp, schemaV3_t *data_stp)
+{
+    TEST_ASSERT_NOT_NULL(handle_xp);
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handle_xp, (uint8_t *)data_stp));
+}
+
+void setUp(void)
+{
+    paramif_param_t param_st;
+
+    if(false == initialized_bols)
+    {
+        fake_NvsReset_vd();
+        fake_PartSetup_vd("paramlog", 0U);
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeParameter_td(&param_st));
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Initialize_td(&param_st));
+        initialized_bols = true;
+    }
+    memset(&stats_sts, 0, sizeof(stats_sts));
+    fake_NvsResetCounters_vd();
+    migrations_u32s = 0U;
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* a raw blob of the first firmware is upgraded in two steps and written back once */
+static void test_RawV1MigratedToV3(void)
+{
+    const schemaV1_t v1_cst = {.interval_u16 = 42U};
+    paramif_objHdl_t handle_xp;
+    schemaV3_t data_st;
+
+    fake_NvsPut_vd("rawV1", &v1_cst, sizeof(v1_cst));
+    handle_xp = Allocate_xp("rawV1", Migrate_td);
+    ReadV3_vd(handle_xp, &data_st);
+    TEST_ASSERT_EQUAL_UINT16(42U, data_st.interval_u16);
+    TEST_ASSERT_EQUAL_UINT16(7U, data_st.window_u16);
+    TEST_ASSERT_EQUAL_INT16(-9, data_st.offset_s16);
+    TEST_ASSERT_EQUAL_UINT32(2U, migrations_u32s);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_sts.migrated_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsSetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(blobHeader_t) + sizeof(schemaV3_t), 
+                                fake_NvsFind_stp("rawV1")->length_st);
+
+    // the next boot reads the upgraded blob without migration
+    paramif_DeAllocate_stp(handle_xp);
+    handle_xp = Allocate_xp("rawV1", Migrate_td);
+    ReadV3_vd(handle_xp, &data_st);
+    TEST_ASSERT_EQUAL_INT16(-9, data_st.offset_s16);
+    TEST_ASSERT_EQUAL_UINT32(2U, migrations_u32s);
+    TEST_ASSERT_FALSE(handle_xp->dirty_bol);
+    paramif_DeAllocate_stp(handle_xp);
+}
+
+/* a blob with header of version 2 needs one step only */
+static void test_HeaderV2MigratedToV3(void)
+{
+    const schemaV2_t v2_cst = {.interval_u16 = 5U, .window_u16 = 6U};
+    paramif_objHdl_t handle_xp;
+    schemaV3_t data_st;
+
+    PutVersion_vd("hdrV2", 2U, &v2_cst, sizeof(v2_cst));
+    handle_xp = Allocate_xp("hdrV2", Migrate_td);
+    ReadV3_vd(handle_xp, &data_st);
+    TEST_ASSERT_EQUAL_UINT16(5U, data_st.interval_u16);
+    TEST_ASSERT_EQUAL_UINT16(6U, data_st.window_u16);
+    TEST_ASSERT_EQUAL_INT16(-9, data_st.offset_s16);
+    TEST_ASSERT_EQUAL_UINT32(1U, migrations_u32s);
+    paramif_DeAllocate_stp(handle_xp);
+}
+
+/* blobs which can not be upgraded are replaced by the defaults and counted */
+static void test_UnusableBlobsRejected(void)
+{
+    const schemaV1_t v1_cst = {.interval_u16 = 42U};
+    const schemaV2_t v2_cst = {.interval_u16 = 5U, .window_u16 = 6U};
+    const schemaV3_t v3_cst = {.interval_u16 = 8U, .window_u16 = 8U, .offset_s16 = 8};
+    uint8_t blob_u8a[sizeof(blobHeader_t) + sizeof(schemaV2_t)];
+    paramif_objHdl_t handles_xpa[3];
+    schemaV3_t data_st;
+
+    // crc error of a stored blob
+    PutVersion_vd("crcErr", 2U, &v2_cst, sizeof(v2_cst));
+    memcpy(blob_u8a, fake_NvsFind_stp("crcErr")->data_u8a, sizeof(blob_u8a));
+    blob_u8a[sizeof(blobHeader_t)] ^= 0x01U;
+    fake_NvsPut_vd("crcErr", blob_u8a, sizeof(blob_u8a));
+    // version of a newer firmware after a downgrade
+    PutVersion_vd("newer", SCHEMA_VERSION + 1U, &v3_cst, sizeof(v3_cst));
+    // an older version without migration function
+    fake_NvsPut_vd("noMigr", &v1_cst, sizeof(v1_cst));
+
+    handles_xpa[0] = Allocate_xp("crcErr", Migrate_td);
+    handles_xpa[1] = Allocate_xp("newer", Migrate_td);
+    handles_xpa[2] = Allocate_xp("noMigr", NULL);
+    for(uint8_t idx_u8 = 0U; idx_u8 < 3U; idx_u8++)
+    {
+        ReadV3_vd(handles_xpa[idx_u8], &data_st);
+        TEST_ASSERT_EQUAL_MEMORY(&DEFAULTS_CST, &data_st, sizeof(data_st));
+        TEST_ASSERT_FALSE(handles_xpa[idx_u8]->dirty_bol);
+        paramif_DeAllocate_stp(handles_xpa[idx_u8]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3U, stats_sts.rejected_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_sts.migrated_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+}
+
+/* boot with 50 objects of the first firmware: all are upgraded with one commit */
+static void test_BenchBootMigration(void)
+{
+    const schemaV1_t v1_cst = {.interval_u16 = 42U};
+    paramif_objHdl_t handles_xpa[BENCH_OBJECTS_NUM];
+    char idents_caa[BENCH_OBJECTS_NUM][IDENT_SIZE];
+    schemaV3_t data_st;
+    uint64_t startNs_u64;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_OBJECTS_NUM; idx_u32++)
+    {
+        snprintf(idents_caa[idx_u32], IDENT_SIZE, "obj%02u", idx_u32);
+        fake_NvsPut_vd(idents_caa[idx_u32], &v1_cst, sizeof(v1_cst));
+    }
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_OBJECTS_NUM; idx_u32++)
+    {
+        handles_xpa[idx_u32] = Allocate_xp(idents_caa[idx_u32], Migrate_td);
+    }
+    fake_Bench_vd("paramif boot migration v1 to v3", BENCH_OBJECTS_NUM, 
+                    fake_HostNs_u64() - startNs_u64);
+
+    TEST_ASSERT_EQUAL_UINT32(BENCH_OBJECTS_NUM, stats_sts.migrated_u32);
+    TEST_ASSERT_EQUAL_UINT32(2U * BENCH_OBJECTS_NUM, migrations_u32s);
+    // the load returns the stored length, the migration reads the old blob once more
+    TEST_ASSERT_EQUAL_UINT32(2U * BENCH_OBJECTS_NUM, fake_nvsGetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+
+    // the upgraded blobs are written with the commit after the quiet time
+    fake_AdvanceMs_vd(COMMIT_DELAY_MS);
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    TEST_ASSERT_EQUAL_UINT32(BENCH_OBJECTS_NUM, fake_nvsSetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsCommits_u32);
+    for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_OBJECTS_NUM; idx_u32++)
+    {
+        ReadV3_vd(handles_xpa[idx_u32], &data_st);
+        TEST_ASSERT_EQUAL_UINT16(42U, data_st.interval_u16);
+        TEST_ASSERT_EQUAL_INT16(-9, data_st.offset_s16);
+        paramif_DeAllocate_stp(handles_xpa[idx_u32]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_RawV1MigratedToV3);
+    RUN_TEST(test_HeaderV2MigratedToV3);
+    RUN_TEST(test_UnusableBlobsRejected);
+    RUN_TEST(test_BenchBootMigration);
+    return(UNITY_END());
+}
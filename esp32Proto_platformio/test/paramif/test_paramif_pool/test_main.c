@@ -0,0 +1,252 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host test of the growable object pool of paramif with the hashed lookup by the
+*       nvs identifier. 200 parameter objects are allocated, looked up, freed and
+*       allocated again, the benchmark reports the allocation and lookup time.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+
+#include "paramif.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define OBJECTS_NUM         200U
+#define BENCH_ROUNDS        1000U       // lookups of every object in the benchmark
+
+/****************************************************************************************/
+/* Local variables: */
+
+static paramif_objHdl_t handles_xpsa[OBJECTS_NUM];
+static uint32_t defaults_u32s = 0x12345678U;
+static bool initialized_bols = false;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static void MakeIdent_vd(uint32_t idx_u32, char *ident_chp)
+{
+    snprintf(ident_chp, IDENT_SIZE, "sens%03u", idx_u32);
+}
+
+/* allocates the objects with the identifier in a temporary buffer, like a module which
+   builds the identifier of a sensor type at runtime */
+static void AllocateAll_vd(void)
+{
+    paramif_allocParam_t alloc_st;
+    char ident_ca[IDENT_SIZE];
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < OBJECTS_NUM; idx_u32++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeAllocParameter_td(&alloc_st));
+        MakeIdent_vd(idx_u32, ident_ca);
+        alloc_st.nvsIdent_cp = ident_ca;
+        alloc_st.length_u16 = sizeof(defaults_u32s);
+        alloc_st.defaults_u8p = (uint8_t *)&defaults_u32s;
+        handles_xpsa[idx_u32] = paramif_Allocate_stp(&alloc_st);
+        memset(ident_ca, 0, sizeof(ident_ca));
+    }
+}
+
+static void DeAllocateAll_vd(void)
+{
+    for(uint32_t idx_u32 = 0U; idx_u32 < OBJECTS_NUM; idx_u32++)
+    {
+        paramif_DeAllocate_stp(handles_xpsa[idx_u32]);
+        handles_xpsa[idx_u32] = NULL;
+    }
+}
+
+/* the lookup of the former fixed pool, a scan over all objects */
+static paramif_obj_t *LinearFind_stp(const char *ident_cchp)
+{
+    paramif_obj_t *found_stp = NULL;
+    paramif_obj_t *obj_stp;
+
+    for(uint16_t idx_u16 = 0U; (NULL == found_stp) && (idx_u16 < poolSize_u16s); idx_u16++)
+    {
+        obj_stp = GetObject_stp(idx_u16);
+        if(   (true == obj_stp->used_bol)
+           && (0 == strcmp(obj_stp->param_st.nvsIdent_cp, ident_cchp)))
+        {
+            found_stp = obj_stp;
+        }
+    }
+    return(found_stp);
+}
+
+void setUp(void)
+{
+    paramif_param_t param_st;
+
+    if(false == initialized_bols)
+    {
+        fake_NvsReset_vd();
+        fake_PartSetup_vd("paramlog", 0U);
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeParameter_td(&param_st));
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Initialize_td(&param_st));
+        initialized_bols = true;
+    }
+}
+
+void tearDown(void)
+{
+    DeAllocateAll_vd();
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* the pool grows beyond the first block, every object keeps its own handle */
+static void test_AllocateTwoHundred(void)
+{
+    char ident_ca[IDENT_SIZE];
+    uint32_t value_u32;
+
+    AllocateAll_vd();
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(OBJECTS_NUM, poolSize_u16s);
+    TEST_ASSERT_LESS_THAN_UINT32(OBJECTS_NUM + POOL_BLOCK_SIZE, poolSize_u16s);
+    for(uint32_t idx_u32 = 0U; idx_u32 < OBJECTS_NUM; idx_u32++)
+    {
+        TEST_ASSERT_NOT_NULL(handles_xpsa[idx_u32]);
+        MakeIdent_vd(idx_u32, ident_ca);
+        // the identifier was copied, the buffer of the caller is cleared
+        TEST_ASSERT_EQUAL_STRING(ident_ca, handles_xpsa[idx_u32]->param_st.nvsIdent_cp);
+        TEST_ASSERT_EQUAL_PTR(handles_xpsa[idx_u32], paramif_Find_stp(ident_ca));
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[idx_u32], 
+                                                    (uint8_t *)&value_u32));
+        TEST_ASSERT_EQUAL_UINT32(defaults_u32s, value_u32);
+    }
+    TEST_ASSERT_NULL(paramif_Find_stp("sens999"));
+}
+
+/* a second allocation of an identifier hands out the existing handle */
+static void test_ReopenExistingHandle(void)
+{
+    paramif_allocParam_t alloc_st;
+    uint16_t poolSize_u16;
+
+    AllocateAll_vd();
+    poolSize_u16 = poolSize_u16s;
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeAllocParameter_td(&alloc_st));
+    alloc_st.nvsIdent_cp = "sens123";
+    alloc_st.length_u16 = sizeof(defaults_u32s);
+    TEST_ASSERT_EQUAL_PTR(handles_xpsa[123], paramif_Allocate_stp(&alloc_st));
+    TEST_ASSERT_EQUAL_UINT16(poolSize_u16, poolSize_u16s);
+
+    // another length is a conflict of two modules
+    alloc_st.length_u16 = sizeof(defaults_u32s) + 1U;
+    TEST_ASSERT_NULL(paramif_Allocate_stp(&alloc_st));
+
+    // too long for nvs
+    alloc_st.nvsIdent_cp = "sensorParameters";
+    TEST_ASSERT_NULL(paramif_Allocate_stp(&alloc_st));
+}
+
+/* freed objects leave the hash table and their slots are used again */
+static void test_FreedSlotsReused(void)
+{
+    char ident_ca[IDENT_SIZE];
+    uint16_t poolSize_u16;
+
+    AllocateAll_vd();
+    poolSize_u16 = poolSize_u16s;
+    for(uint32_t idx_u32 = 0U; idx_u32 < OBJECTS_NUM; idx_u32 += 2U)
+    {
+        paramif_DeAllocate_stp(handles_xpsa[idx_u32]);
+        handles_xpsa[idx_u32] = NULL;
+    }
+    for(uint32_t idx_u32 = 0U; idx_u32 < OBJECTS_NUM; idx_u32++)
+    {
+        MakeIdent_vd(idx_u32, ident_ca);
+        TEST_ASSERT_EQUAL_PTR(handles_xpsa[idx_u32], paramif_Find_stp(ident_ca));
+    }
+
+    DeAllocateAll_vd();
+    AllocateAll_vd();
+    TEST_ASSERT_EQUAL_UINT16(poolSize_u16, poolSize_u16s);
+}
+
+/* allocation and lookup of 200 objects, the lookup compared with a scan of the pool */
+static void test_BenchAllocateAndLookup(void)
+{
+    char idents_caa[OBJECTS_NUM][IDENT_SIZE];
+    uint64_t startNs_u64;
+    uint32_t found_u32 = 0U;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < OBJECTS_NUM; idx_u32++)
+    {
+        MakeIdent_vd(idx_u32, idents_caa[idx_u32]);
+    }
+
+    startNs_u64 = fake_HostNs_u64();
+    AllocateAll_vd();
+    fake_Bench_vd("paramif_Allocate_stp, 200 objects", OBJECTS_NUM, 
+                    fake_HostNs_u64() - startNs_u64);
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t round_u32 = 0U; round_u32 < BENCH_ROUNDS; round_u32++)
+    {
+        for(uint32_t idx_u32 = 0U; idx_u32 < OBJECTS_NUM; idx_u32++)
+        {
+            found_u32 += (NULL != paramif_Find_stp(idents_caa[idx_u32])) ? 1U : 0U;
+        }
+    }
+    fake_Bench_vd("paramif_Find_stp, hashed", BENCH_ROUNDS * OBJECTS_NUM, 
+                    fake_HostNs_u64() - startNs_u64);
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t round_u32 = 0U; round_u32 < BENCH_ROUNDS; round_u32++)
+    {
+        for(uint32_t idx_u32 = 0U; idx_u32 < OBJECTS_NUM; idx_u32++)
+        {
+            found_u32 += (NULL != LinearFind_stp(idents_caa[idx_u32])) ? 1U : 0U;
+        }
+    }
+    fake_Bench_vd("paramif lookup, linear scan", BENCH_ROUNDS * OBJECTS_NUM, 
+                    fake_HostNs_u64() - startNs_u64);
+    TEST_ASSERT_EQUAL_UINT32(2U * BENCH_ROUNDS * OBJECTS_NUM, found_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_AllocateTwoHundred);
+    RUN_TEST(test_ReopenExistingHandle);
+    RUN_TEST(test_FreedSlotsReused);
+    RUN_TEST(test_BenchAllocateAndLookup);
+    return(UNITY_END());
+}
@@ -0,0 +1,380 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host test of the ram shadow of paramif against the nvs stand-in. A typical boot
+*       of controlTask, wifiCtrl, devmgr and mijasens is counted with the former paramif
+*       and with the shadow, further tests cover the coalesced commits, the flush before
+*       a reboot and the retry of a failed write.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_nvs.h"
+#include "fake_partition.h"
+#include "fake_console.h"
+
+#include "paramif.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define BOOT_OBJECTS_NUM    10U
+#define PARAM_MAX_SIZE      2048U
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* parameter set allocated at boot by one of the modules */
+typedef struct bootObject_tag
+{
+    const char *ident_cchp;
+    uint16_t length_u16;
+}bootObject_t;
+
+/* nvs accesses of a scenario */
+typedef struct nvsCount_tag
+{
+    uint32_t opens_u32;
+    uint32_t gets_u32;
+    uint32_t sets_u32;
+    uint32_t commits_u32;
+}nvsCount_t;
+
+/****************************************************************************************/
+/* Local variables: */
+
+/* the parameter sets of controlTask, wifiCtrl, devmgr and mijasens with their sizes */
+static const bootObject_t BOOT_OBJECTS_CSTA[BOOT_OBJECTS_NUM] =
+{
+    {"ctrl", 8U}, {"wifiMode", 4U}, {"wifiStation", 100U}, {"devmgr", 12U},
+    {"mijaScan", 16U}, {"mijaFilt", 12U}, {"mijaPub", 4U}, {"mijaKey", 340U},
+    {"mijaReg", 1704U}, {"mijaDb", 16U}
+};
+
+static uint8_t defaults_u8sa[PARAM_MAX_SIZE];
+static paramif_objHdl_t handles_xpsa[BOOT_OBJECTS_NUM];
+static bool flushRequest_bols;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static void FlushRequest_vd(void)
+{
+    flushRequest_bols = true;
+}
+
+/* the control task flushes on the request of the commit timer, a failed flush is only
+   logged there */
+static void RunFor_vd(uint32_t ms_u32)
+{
+    for(uint32_t idx_u32 = 0U; idx_u32 < (ms_u32 / 100U); idx_u32++)
+    {
+        fake_AdvanceMs_vd(100U);
+        if(true == flushRequest_bols)
+        {
+            flushRequest_bols = false;
+            (void)paramif_Flush_td();
+        }
+    }
+}
+
+static void GetCount_vd(nvsCount_t *count_stp)
+{
+    count_stp->opens_u32 = fake_nvsOpens_u32;
+    count_stp->gets_u32 = fake_nvsGetCalls_u32;
+    count_stp->sets_u32 = fake_nvsSetCalls_u32;
+    count_stp->commits_u32 = fake_nvsCommits_u32;
+}
+
+/* power off without flush, the ram shadow is lost */
+static void PowerOff_vd(void)
+{
+    (void)xTimerStop(commitTimer_sts, 0U);
+    for(uint16_t idx_u16 = 0U; idx_u16 < POOL_BLOCK_SIZE; idx_u16++)
+    {
+        free(firstBlock_sts.objects_sta[idx_u16].blob_u8p);
+    }
+    memset(&firstBlock_sts, 0, sizeof(firstBlock_sts));
+    memset(&stats_sts, 0, sizeof(stats_sts));
+    memset(handles_xpsa, 0, sizeof(handles_xpsa));
+    dirtyObjects_u16s = 0U;
+    moduleState_ens = STATE_NOT_INITIALIZED;
+    flushRequest_bols = false;
+}
+
+/* a typical boot: every module allocates and reads its parameters, the control task
+   increments the startup counter */
+static void Boot_vd(void)
+{
+    paramif_param_t param_st;
+    paramif_allocParam_t alloc_st;
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+
+    fake_NvsResetCounters_vd();
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeParameter_td(&param_st));
+    param_st.flushRequest_fp = FlushRequest_vd;
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Initialize_td(&param_st));
+    for(uint8_t idx_u8 = 0U; idx_u8 < BOOT_OBJECTS_NUM; idx_u8++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_InitializeAllocParameter_td(&alloc_st));
+        alloc_st.nvsIdent_cp = BOOT_OBJECTS_CSTA[idx_u8].ident_cchp;
+        alloc_st.length_u16 = BOOT_OBJECTS_CSTA[idx_u8].length_u16;
+        alloc_st.defaults_u8p = defaults_u8sa;
+        handles_xpsa[idx_u8] = paramif_Allocate_stp(&alloc_st);
+        TEST_ASSERT_NOT_NULL(handles_xpsa[idx_u8]);
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[idx_u8], data_u8a));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[0], data_u8a));
+    data_u8a[0]++;
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[0], data_u8a));
+}
+
+/* the former paramif: every read and write opened the namespace, a read without
+   stored data wrote the defaults back, every write was committed */
+static void LegacyWrite_vd(const bootObject_t *obj_cstp, const uint8_t *data_cu8p)
+{
+    nvs_handle handle_x;
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open(STORAGE_NAMESPACE, NVS_READWRITE, &handle_x));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_set_blob(handle_x, obj_cstp->ident_cchp, data_cu8p,
+                                            obj_cstp->length_u16));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_commit(handle_x));
+    nvs_close(handle_x);
+}
+
+static void LegacyRead_vd(const bootObject_t *obj_cstp, uint8_t *data_u8p)
+{
+    nvs_handle handle_x;
+    size_t length_st = obj_cstp->length_u16;
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open(STORAGE_NAMESPACE, NVS_READONLY, &handle_x));
+    if(ESP_OK == nvs_get_blob(handle_x, obj_cstp->ident_cchp, data_u8p, &length_st))
+    {
+        nvs_close(handle_x);
+    }
+    else
+    {
+        memcpy(data_u8p, defaults_u8sa, obj_cstp->length_u16);
+        LegacyWrite_vd(obj_cstp, data_u8p);
+    }
+}
+
+static void LegacyBoot_vd(void)
+{
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+
+    fake_NvsResetCounters_vd();
+    for(uint8_t idx_u8 = 0U; idx_u8 < BOOT_OBJECTS_NUM; idx_u8++)
+    {
+        LegacyRead_vd(&BOOT_OBJECTS_CSTA[idx_u8], data_u8a);
+    }
+    LegacyRead_vd(&BOOT_OBJECTS_CSTA[0], data_u8a);
+    data_u8a[0]++;
+    LegacyWrite_vd(&BOOT_OBJECTS_CSTA[0], data_u8a);
+}
+
+static void PrintCount_vd(const char *name_cchp, const nvsCount_t *legacy_cstp,
+                            const nvsCount_t *shadow_cstp)
+{
+    char line_ca[160];
+
+    snprintf(line_ca, sizeof(line_ca), "paramif %s: open %u -> %u, get %u -> %u, "
+                "set %u -> %u, commit %u -> %u", name_cchp,
+                legacy_cstp->opens_u32, shadow_cstp->opens_u32,
+                legacy_cstp->gets_u32, shadow_cstp->gets_u32,
+                legacy_cstp->sets_u32, shadow_cstp->sets_u32,
+                legacy_cstp->commits_u32, shadow_cstp->commits_u32);
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+}
+
+void setUp(void)
+{
+    fake_NvsReset_vd();
+    fake_PartSetup_vd("paramlog", 0U);
+    memset(defaults_u8sa, 0x5A, sizeof(defaults_u8sa));
+    if(STATE_INITIALIZED == moduleState_ens)
+    {
+        PowerOff_vd();
+    }
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* the first boot with an empty nvs and the following boot, with the former paramif and
+   with the ram shadow */
+static void test_BootFlashWrites(void)
+{
+    nvsCount_t legacy_sta[2];
+    nvsCount_t shadow_sta[2];
+
+    for(uint8_t boot_u8 = 0U; boot_u8 < 2U; boot_u8++)
+    {
+        LegacyBoot_vd();
+        GetCount_vd(&legacy_sta[boot_u8]);
+    }
+
+    fake_NvsReset_vd();
+    for(uint8_t boot_u8 = 0U; boot_u8 < 2U; boot_u8++)
+    {
+        Boot_vd();
+        RunFor_vd(COMMIT_DELAY_MS + 100U);
+        GetCount_vd(&shadow_sta[boot_u8]);
+        PowerOff_vd();
+    }
+    PrintCount_vd("first boot", &legacy_sta[0], &shadow_sta[0]);
+    PrintCount_vd("second boot", &legacy_sta[1], &shadow_sta[1]);
+
+    // defaults are not written back, only the startup counter is stored
+    TEST_ASSERT_EQUAL_UINT32(BOOT_OBJECTS_NUM + 1U, legacy_sta[0].sets_u32);
+    for(uint8_t boot_u8 = 0U; boot_u8 < 2U; boot_u8++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(1U, shadow_sta[boot_u8].opens_u32);
+        TEST_ASSERT_EQUAL_UINT32(BOOT_OBJECTS_NUM, shadow_sta[boot_u8].gets_u32);
+        TEST_ASSERT_EQUAL_UINT32(1U, shadow_sta[boot_u8].sets_u32);
+        TEST_ASSERT_EQUAL_UINT32(1U, shadow_sta[boot_u8].commits_u32);
+    }
+}
+
+/* reads are served from ram, writes are coalesced until the quiet time passed */
+static void test_WritesCoalesced(void)
+{
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+    paramif_stats_t stats_st;
+
+    Boot_vd();
+    RunFor_vd(COMMIT_DELAY_MS + 100U);
+    fake_NvsResetCounters_vd();
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < 100U; idx_u8++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[4], data_u8a));
+        data_u8a[1] = idx_u8;
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[4], data_u8a));
+        RunFor_vd(COMMIT_DELAY_MS / 2U);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsGetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_nvsSetCalls_u32);
+    RunFor_vd(COMMIT_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsSetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsCommits_u32);
+
+    // the same data again does not change the flash
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[4], data_u8a));
+    RunFor_vd(COMMIT_DELAY_MS + 100U);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsSetCalls_u32);
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_GetStats_td(&stats_st));
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.unchanged_u32);
+}
+
+/* COMMIT_MAX_DIRTY changed objects are written at once with one commit */
+static void test_CountTriggeredCommit(void)
+{
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+
+    Boot_vd();
+    RunFor_vd(COMMIT_DELAY_MS + 100U);
+    fake_NvsResetCounters_vd();
+
+    for(uint8_t idx_u8 = 1U; idx_u8 <= COMMIT_MAX_DIRTY; idx_u8++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[idx_u8], data_u8a));
+        data_u8a[0] ^= 0xFFU;
+        TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[idx_u8], data_u8a));
+    }
+    TEST_ASSERT_EQUAL_UINT32(COMMIT_MAX_DIRTY, fake_nvsSetCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsCommits_u32);
+    TEST_ASSERT_EQUAL_UINT16(0U, dirtyObjects_u16s);
+}
+
+/* the flush before the reboot stores pending changes, a power loss drops them */
+static void test_FlushOnReboot(void)
+{
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+    uint8_t read_u8a[PARAM_MAX_SIZE];
+
+    Boot_vd();
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    PowerOff_vd();
+
+    Boot_vd();
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[3], data_u8a));
+    data_u8a[2] = 0x11U;
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[3], data_u8a));
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Flush_td());
+    PowerOff_vd();
+    Boot_vd();
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[3], read_u8a));
+    TEST_ASSERT_EQUAL_UINT8(0x11U, read_u8a[2]);
+
+    data_u8a[2] = 0x22U;
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[3], data_u8a));
+    PowerOff_vd();
+    Boot_vd();
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[3], read_u8a));
+    TEST_ASSERT_EQUAL_UINT8(0x11U, read_u8a[2]);
+}
+
+/* a failed write stays dirty and is retried after the quiet time */
+static void test_FailedWriteRetried(void)
+{
+    uint8_t data_u8a[PARAM_MAX_SIZE];
+
+    Boot_vd();
+    RunFor_vd(COMMIT_DELAY_MS + 100U);
+    fake_NvsResetCounters_vd();
+
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Read_td(handles_xpsa[5], data_u8a));
+    data_u8a[0] = 0x33U;
+    TEST_ASSERT_EQUAL(ESP_OK, paramif_Write_td(handles_xpsa[5], data_u8a));
+    fake_nvsSetFail_bol = true;
+    RunFor_vd(COMMIT_DELAY_MS + 100U);
+    TEST_ASSERT_EQUAL_UINT16(1U, dirtyObjects_u16s);
+    fake_nvsSetFail_bol = false;
+    RunFor_vd(COMMIT_DELAY_MS + 100U);
+    TEST_ASSERT_EQUAL_UINT16(0U, dirtyObjects_u16s);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_nvsSetCalls_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_BootFlashWrites);
+    RUN_TEST(test_WritesCoalesced);
+    RUN_TEST(test_CountTriggeredCommit);
+    RUN_TEST(test_FlushOnReboot);
+    RUN_TEST(test_FailedWriteRetried);
+    return(UNITY_END());
+}
@@ -0,0 +1,69 @@
+/* host stand-in of argtable3, a reduced parser in test/fakes/fake_console.h supports
+   the option forms used by the console commands: -x <val>, --long <val>, --long=<val> */
+#ifndef ARGTABLE3_H
+#define ARGTABLE3_H
+
+#include <stdio.h>
+
+#define ARG_MAX_VALUES      4
+
+enum {
+    ARG_TYPE_LIT = 'l',
+    ARG_TYPE_INT = 'i',
+    ARG_TYPE_STR = 's',
+    ARG_TYPE_END = 'e',
+};
+
+struct arg_hdr {
+    char type;
+    const char *shortopts;
+    const char *longopts;
+    const char *datatype;
+    const char *glossary;
+    int mincount;
+    int maxcount;
+};
+
+struct arg_lit {
+    struct arg_hdr hdr;
+    int count;
+};
+
+struct arg_int {
+    struct arg_hdr hdr;
+    int count;
+    int *ival;
+    int values[ARG_MAX_VALUES];
+};
+
+struct arg_str {
+    struct arg_hdr hdr;
+    int count;
+    const char **sval;
+    const char *values[ARG_MAX_VALUES];
+};
+
+struct arg_end {
+    struct arg_hdr hdr;
+    int count;
+};
+
+extern struct arg_lit *arg_lit0(const char *shortopts, const char *longopts, 
+                                const char *glossary);
+extern struct arg_int *arg_int0(const char *shortopts, const char *longopts, 
+                                const char *datatype, const char *glossary);
+extern struct arg_int *arg_int1(const char *shortopts, const char *longopts, 
+                                const char *datatype, const char *glossary);
+extern struct arg_str *arg_str0(const char *shortopts, const char *longopts, 
+                                const char *datatype, const char *glossary);
+extern struct arg_str *arg_str1(const char *shortopts, const char *longopts, 
+                                const char *datatype, const char *glossary);
+extern struct arg_end *arg_end(int maxerrors);
+extern int arg_parse(int argc, char **argv, void **argtable);
+extern void arg_print_errors(FILE *fp, struct arg_end *end, const char *progname);
+extern void arg_print_syntax(FILE *fp, void **argtable, const char *suffix);
+extern void arg_print_glossary(FILE *fp, void **argtable, const char *format);
+extern void arg_print_formatted(FILE *fp, const unsigned lmargin, const unsigned rmargin, 
+                                const char *text);
+
+#endif
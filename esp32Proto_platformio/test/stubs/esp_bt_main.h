@@ -0,0 +1,9 @@
+#ifndef ESP_BT_MAIN_H
+#define ESP_BT_MAIN_H
+
+#include "esp_err.h"
+
+extern esp_err_t esp_bluedroid_init(void);
+extern esp_err_t esp_bluedroid_enable(void);
+
+#endif
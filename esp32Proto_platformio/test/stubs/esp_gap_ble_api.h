@@ -0,0 +1,98 @@
+#ifndef ESP_GAP_BLE_API_H
+#define ESP_GAP_BLE_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define ESP_BD_ADDR_LEN                 6
+#define ESP_BLE_ADV_DATA_LEN_MAX        31
+#define ESP_BLE_SCAN_RSP_DATA_LEN_MAX   31
+
+typedef uint8_t esp_bd_addr_t[ESP_BD_ADDR_LEN];
+
+typedef enum {
+    ESP_BT_STATUS_SUCCESS = 0,
+    ESP_BT_STATUS_FAIL,
+} esp_bt_status_t;
+
+typedef enum {
+    ESP_GAP_BLE_SCAN_PARAM_SET_COMPLETE_EVT = 2,
+    ESP_GAP_BLE_SCAN_RESULT_EVT,
+    ESP_GAP_BLE_SCAN_START_COMPLETE_EVT = 7,
+    ESP_GAP_BLE_SCAN_STOP_COMPLETE_EVT = 18,
+    ESP_GAP_BLE_UPDATE_WHITELIST_COMPLETE_EVT = 23,
+} esp_gap_ble_cb_event_t;
+
+typedef enum {
+    ESP_GAP_SEARCH_INQ_RES_EVT = 0,
+    ESP_GAP_SEARCH_INQ_CMPL_EVT = 1,
+} esp_gap_search_evt_t;
+
+typedef enum {
+    BLE_SCAN_TYPE_PASSIVE = 0x0,
+    BLE_SCAN_TYPE_ACTIVE = 0x1,
+} esp_ble_scan_type_t;
+
+typedef enum {
+    BLE_ADDR_TYPE_PUBLIC = 0x00,
+    BLE_ADDR_TYPE_RANDOM = 0x01,
+} esp_ble_addr_type_t;
+
+typedef enum {
+    BLE_SCAN_FILTER_ALLOW_ALL = 0x0,
+    BLE_SCAN_FILTER_ALLOW_ONLY_WLST = 0x1,
+    BLE_SCAN_FILTER_ALLOW_UND_RPA_DIR = 0x2,
+    BLE_SCAN_FILTER_ALLOW_WLIST_PRA_DIR = 0x3,
+} esp_ble_scan_filter_t;
+
+typedef enum {
+    BLE_SCAN_DUPLICATE_DISABLE = 0x0,
+    BLE_SCAN_DUPLICATE_ENABLE = 0x1,
+} esp_ble_scan_duplicate_t;
+
+typedef struct {
+    esp_ble_scan_type_t scan_type;
+    esp_ble_addr_type_t own_addr_type;
+    esp_ble_scan_filter_t scan_filter_policy;
+    uint16_t scan_interval;
+    uint16_t scan_window;
+    esp_ble_scan_duplicate_t scan_duplicate;
+} esp_ble_scan_params_t;
+
+typedef union {
+    struct ble_scan_param_cmpl_evt_param {
+        esp_bt_status_t status;
+    } scan_param_cmpl;
+    struct ble_scan_result_evt_param {
+        esp_gap_search_evt_t search_evt;
+        esp_bd_addr_t bda;
+        int rssi;
+        uint8_t ble_adv[ESP_BLE_ADV_DATA_LEN_MAX + ESP_BLE_SCAN_RSP_DATA_LEN_MAX];
+        int flag;
+        int num_resps;
+        uint8_t adv_data_len;
+        uint8_t scan_rsp_len;
+    } scan_rst;
+    struct ble_scan_start_cmpl_evt_param {
+        esp_bt_status_t status;
+    } scan_start_cmpl;
+    struct ble_scan_stop_cmpl_evt_param {
+        esp_bt_status_t status;
+    } scan_stop_cmpl;
+    struct ble_update_whitelist_cmpl_evt_param {
+        esp_bt_status_t status;
+        int wl_opration;
+    } update_whitelist_cmpl;
+} esp_ble_gap_cb_param_t;
+
+typedef void (* esp_gap_ble_cb_t)(esp_gap_ble_cb_event_t event, 
+                                    esp_ble_gap_cb_param_t *param);
+
+extern esp_err_t esp_ble_gap_register_callback(esp_gap_ble_cb_t callback_fp);
+extern esp_err_t esp_ble_gap_set_scan_params(esp_ble_scan_params_t *params_stp);
+extern esp_err_t esp_ble_gap_start_scanning(uint32_t duration_u32);
+extern esp_err_t esp_ble_gap_stop_scanning(void);
+extern esp_err_t esp_ble_gap_update_whitelist(bool add_bol, esp_bd_addr_t bda);
+
+#endif
@@ -0,0 +1,27 @@
+/* host stand-in of the ESP-IDF log, quiet unless fake_logLevel_s32 is raised */
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+#include <stdint.h>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+extern int32_t fake_logLevel_s32;
+extern void fake_Log_vd(esp_log_level_t level_en, const char *tag_cchp, 
+                        const char *format_cchp, ...) 
+                        __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, format, ...) fake_Log_vd(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) fake_Log_vd(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) fake_Log_vd(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) fake_Log_vd(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) fake_Log_vd(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+#endif
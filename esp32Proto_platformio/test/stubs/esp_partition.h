@@ -0,0 +1,37 @@
+#ifndef ESP_PARTITION_H
+#define ESP_PARTITION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_ANY = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct {
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+    bool encrypted;
+} esp_partition_t;
+
+extern const esp_partition_t *esp_partition_find_first(esp_partition_type_t type_en,
+                                                        esp_partition_subtype_t sub_en,
+                                                        const char *label_cchp);
+extern esp_err_t esp_partition_read(const esp_partition_t *part_cstp, size_t offset_st,
+                                    void *dst_vp, size_t size_st);
+extern esp_err_t esp_partition_write(const esp_partition_t *part_cstp, size_t offset_st,
+                                    const void *src_cvp, size_t size_st);
+extern esp_err_t esp_partition_erase_range(const esp_partition_t *part_cstp, 
+                                            size_t offset_st, size_t size_st);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef ESP_TIMER_H
+#define ESP_TIMER_H
+
+#include <stdint.h>
+
+/* microseconds of the fake clock, see fake_timer.h */
+extern int64_t esp_timer_get_time(void);
+
+#endif
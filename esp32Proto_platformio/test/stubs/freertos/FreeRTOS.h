@@ -0,0 +1,46 @@
+/* host stand-in of the FreeRTOS header for the native unit tests, implemented by
+   test/fakes/fake_freertos.h */
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE                      1
+#define pdFALSE                     0
+#define pdPASS                      pdTRUE
+#define pdFAIL                      pdFALSE
+#define portMAX_DELAY               0xFFFFFFFFU
+#define configTICK_RATE_HZ          1000U
+#define portTICK_PERIOD_MS          (1000U / configTICK_RATE_HZ)
+#define portTICK_RATE_MS            portTICK_PERIOD_MS
+#define pdMS_TO_TICKS(ms)           ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+
+#define BIT0                        0x00000001
+#define BIT1                        0x00000002
+#define BIT2                        0x00000004
+#define BIT3                        0x00000008
+#define BIT4                        0x00000010
+#define BIT5                        0x00000020
+#define BIT6                        0x00000040
+#define BIT7                        0x00000080
+#define BIT8                        0x00000100
+#define BIT9                        0x00000200
+
+/* critical sections of all tasks are mapped to one recursive host mutex */
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    0
+extern void fake_EnterCritical_vd(portMUX_TYPE *mux_xp);
+extern void fake_ExitCritical_vd(portMUX_TYPE *mux_xp);
+#define portENTER_CRITICAL(mux)         fake_EnterCritical_vd(mux)
+#define portEXIT_CRITICAL(mux)          fake_ExitCritical_vd(mux)
+#define portENTER_CRITICAL_ISR(mux)     fake_EnterCritical_vd(mux)
+#define portEXIT_CRITICAL_ISR(mux)      fake_ExitCritical_vd(mux)
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef EVENT_GROUPS_H
+#define EVENT_GROUPS_H
+
+#include "FreeRTOS.h"
+
+typedef struct fake_eventGroup_tag * EventGroupHandle_t;
+typedef uint32_t EventBits_t;
+
+/* a wait returns the bits which are set at once, it never blocks */
+extern EventGroupHandle_t xEventGroupCreate(void);
+extern EventBits_t xEventGroupSetBits(EventGroupHandle_t group_xp, EventBits_t bits_u32);
+extern EventBits_t xEventGroupClearBits(EventGroupHandle_t group_xp, 
+                                        EventBits_t bits_u32);
+extern EventBits_t xEventGroupGetBits(EventGroupHandle_t group_xp);
+extern EventBits_t xEventGroupWaitBits(EventGroupHandle_t group_xp, 
+                                        EventBits_t bits_u32, BaseType_t clear_s32,
+                                        BaseType_t all_s32, TickType_t ticks_u32);
+
+#endif
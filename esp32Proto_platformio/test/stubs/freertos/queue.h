@@ -0,0 +1,16 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "FreeRTOS.h"
+
+typedef struct fake_queue_tag * QueueHandle_t;
+
+/* queues never block, a timeout returns at once */
+extern QueueHandle_t xQueueCreate(UBaseType_t length_u32, UBaseType_t itemSize_u32);
+extern BaseType_t xQueueSendToBack(QueueHandle_t queue_xp, const void *item_cvp, 
+                                    TickType_t ticks_u32);
+extern BaseType_t xQueueReceive(QueueHandle_t queue_xp, void *item_vp, 
+                                    TickType_t ticks_u32);
+extern UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue_xp);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+/* semaphores are queues without data, a take never blocks */
+extern SemaphoreHandle_t xSemaphoreCreateBinary(void);
+extern SemaphoreHandle_t xSemaphoreCreateMutex(void);
+extern SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_u32, 
+                                                    UBaseType_t initial_u32);
+extern BaseType_t xSemaphoreTake(SemaphoreHandle_t sema_xp, TickType_t ticks_u32);
+extern BaseType_t xSemaphoreGive(SemaphoreHandle_t sema_xp);
+extern void vSemaphoreDelete(SemaphoreHandle_t sema_xp);
+
+#endif
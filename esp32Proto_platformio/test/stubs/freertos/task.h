@@ -0,0 +1,18 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void * TaskHandle_t;
+typedef void (* TaskFunction_t)(void *);
+
+/* tasks are recorded but never started, the tests call the handlers directly */
+extern BaseType_t xTaskCreate(TaskFunction_t task_fp, const char *name_cchp, 
+                                uint32_t stackDepth_u32, void *param_vp, 
+                                UBaseType_t prio_u32, TaskHandle_t *handle_xp);
+extern void vTaskDelete(TaskHandle_t handle_xp);
+extern void vTaskDelay(TickType_t ticks_u32);
+extern TickType_t xTaskGetTickCount(void);
+extern TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef TIMERS_H
+#define TIMERS_H
+
+#include "FreeRTOS.h"
+
+typedef struct fake_timer_tag * TimerHandle_t;
+typedef void (* TimerCallbackFunction_t)(TimerHandle_t);
+
+/* timers expire when the tests advance the tick count, see fake_AdvanceTicks_vd */
+extern TimerHandle_t xTimerCreate(const char *name_cchp, TickType_t period_u32, 
+                                    UBaseType_t autoReload_u32, void *id_vp, 
+                                    TimerCallbackFunction_t callback_fp);
+extern BaseType_t xTimerStart(TimerHandle_t timer_xp, TickType_t ticks_u32);
+extern BaseType_t xTimerStop(TimerHandle_t timer_xp, TickType_t ticks_u32);
+extern BaseType_t xTimerReset(TimerHandle_t timer_xp, TickType_t ticks_u32);
+extern BaseType_t xTimerChangePeriod(TimerHandle_t timer_xp, TickType_t period_u32,
+                                        TickType_t ticks_u32);
+extern BaseType_t xTimerIsTimerActive(TimerHandle_t timer_xp);
+extern void * pvTimerGetTimerID(TimerHandle_t timer_xp);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef MBEDTLS_CCM_H
+#define MBEDTLS_CCM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MBEDTLS_ERR_CCM_BAD_INPUT       -0x000D
+#define MBEDTLS_ERR_CCM_AUTH_FAILED     -0x000F
+
+typedef enum {
+    MBEDTLS_CIPHER_ID_NONE = 0,
+    MBEDTLS_CIPHER_ID_NULL,
+    MBEDTLS_CIPHER_ID_AES,
+} mbedtls_cipher_id_t;
+
+/* aes-128 only, implemented in software by test/fakes/fake_ccm.h */
+typedef struct {
+    uint8_t roundKeys_u8a[176];
+    int keySet_s32;
+} mbedtls_ccm_context;
+
+extern void mbedtls_ccm_init(mbedtls_ccm_context *ctx);
+extern int mbedtls_ccm_setkey(mbedtls_ccm_context *ctx, mbedtls_cipher_id_t cipher,
+                                const unsigned char *key, unsigned int keybits);
+extern void mbedtls_ccm_free(mbedtls_ccm_context *ctx);
+extern int mbedtls_ccm_encrypt_and_tag(mbedtls_ccm_context *ctx, size_t length,
+                                        const unsigned char *iv, size_t iv_len,
+                                        const unsigned char *add, size_t add_len,
+                                        const unsigned char *input, unsigned char *output,
+                                        unsigned char *tag, size_t tag_len);
+extern int mbedtls_ccm_auth_decrypt(mbedtls_ccm_context *ctx, size_t length,
+                                    const unsigned char *iv, size_t iv_len,
+                                    const unsigned char *add, size_t add_len,
+                                    const unsigned char *input, unsigned char *output,
+                                    const unsigned char *tag, size_t tag_len);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct esp_mqtt_client * esp_mqtt_client_handle_t;
+
+typedef enum {
+    MQTT_EVENT_ERROR = 0,
+    MQTT_EVENT_CONNECTED,
+    MQTT_EVENT_DISCONNECTED,
+    MQTT_EVENT_SUBSCRIBED,
+    MQTT_EVENT_UNSUBSCRIBED,
+    MQTT_EVENT_PUBLISHED,
+    MQTT_EVENT_DATA,
+    MQTT_EVENT_BEFORE_CONNECT,
+} esp_mqtt_event_id_t;
+
+typedef struct {
+    esp_mqtt_event_id_t event_id;
+    esp_mqtt_client_handle_t client;
+    void *user_context;
+    char *data;
+    int data_len;
+    int total_data_len;
+    int current_data_offset;
+    char *topic;
+    int topic_len;
+    int msg_id;
+} esp_mqtt_event_t;
+
+typedef esp_mqtt_event_t * esp_mqtt_event_handle_t;
+typedef esp_err_t (* mqtt_event_callback_t)(esp_mqtt_event_handle_t event);
+
+typedef struct {
+    mqtt_event_callback_t event_handle;
+    const char *host;
+    const char *uri;
+    uint32_t port;
+    const char *client_id;
+    const char *username;
+    const char *password;
+} esp_mqtt_client_config_t;
+
+extern esp_mqtt_client_handle_t esp_mqtt_client_init(
+                                    const esp_mqtt_client_config_t *config_cstp);
+extern esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client_xp);
+extern esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client_xp);
+extern esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client_xp);
+extern int esp_mqtt_client_subscribe(esp_mqtt_client_handle_t client_xp, 
+                                        const char *topic_cchp, int qos_s32);
+extern int esp_mqtt_client_unsubscribe(esp_mqtt_client_handle_t client_xp, 
+                                        const char *topic_cchp);
+extern int esp_mqtt_client_publish(esp_mqtt_client_handle_t client_xp, 
+                                    const char *topic_cchp, const char *data_cchp, 
+                                    int len_s32, int qos_s32, int retain_s32);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef NVS_H
+#define NVS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef uint32_t nvs_handle;
+typedef nvs_handle nvs_handle_t;
+
+typedef enum {
+    NVS_READONLY,
+    NVS_READWRITE
+} nvs_open_mode;
+
+extern esp_err_t nvs_open(const char *name_cchp, nvs_open_mode mode_en, 
+                            nvs_handle *handle_xp);
+extern esp_err_t nvs_get_blob(nvs_handle handle_x, const char *key_cchp, void *out_vp,
+                                size_t *length_stp);
+extern esp_err_t nvs_set_blob(nvs_handle handle_x, const char *key_cchp, 
+                                const void *value_cvp, size_t length_st);
+extern esp_err_t nvs_erase_key(nvs_handle handle_x, const char *key_cchp);
+extern esp_err_t nvs_erase_all(nvs_handle handle_x);
+extern esp_err_t nvs_commit(nvs_handle handle_x);
+extern void nvs_close(nvs_handle handle_x);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef NVS_FLASH_H
+#define NVS_FLASH_H
+
+#include "nvs.h"
+
+extern esp_err_t nvs_flash_init(void);
+extern esp_err_t nvs_flash_erase(void);
+
+#endif
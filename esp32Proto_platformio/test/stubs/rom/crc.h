@@ -0,0 +1,8 @@
+#ifndef ROM_CRC_H
+#define ROM_CRC_H
+
+#include <stdint.h>
+
+extern uint16_t crc16_le(uint16_t crc_u16, uint8_t const *buf_cu8p, uint32_t len_u32);
+
+#endif
@@ -0,0 +1,6 @@
+/* host stand-in of the generated sdkconfig.h, the tests define the CONFIG_ values they
+   need before including the module under test */
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+#endif
@@ -0,0 +1,9 @@
+/* the newlib of the target provides itoa, the host libc does not, see fake_esp.h */
+#include_next <stdlib.h>
+
+#ifndef FAKE_STDLIB_H
+#define FAKE_STDLIB_H
+
+extern char *itoa(int value, char *buffer, int base);
+
+#endif
@@ -0,0 +1,363 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the encrypted MiBeacon v4/v5 frames. The software aes-ccm of the
+*       host build is checked with the NIST SP 800-38C and RFC 3610 vectors, encrypted
+*       frames are built like a sensor sends them and decoded with the cached bindkey.
+*       The benchmark measures decrypted frames per second.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_ccm.h"
+
+#include "mijaProcl.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define BENCH_FRAMES        200000U
+
+#define FRAME_CTRL_V5       0x5858U     // version 5, encrypted, mac and objects included
+#define PRODUCT_ID          0x055BU     // LYWSD03MMC
+#define SERVICE_DATA_POS    7U          // flags, AD length, AD type and uuid in front
+
+/****************************************************************************************/
+/* Local type definitions (enum, struct, union) */
+
+/* aes-ccm test vector, hex strings */
+typedef struct ccmVector_tag
+{
+    const char *key_cchp;
+    const char *nonce_cchp;
+    const char *aad_cchp;
+    const char *plain_cchp;
+    const char *cipher_cchp;
+    const char *tag_cchp;
+}ccmVector_t;
+
+/****************************************************************************************/
+/* Local variables: */
+
+// NIST SP 800-38C appendix C examples 1 to 3 and RFC 3610 packet vector #1, example 3
+// uses the 12 byte nonce of the MiBeacon frames
+static const ccmVector_t CCM_VECTORS_CSTA[] =
+{
+    {"404142434445464748494a4b4c4d4e4f", "10111213141516", "0001020304050607",
+     "20212223", "7162015b", "4dac255d"},
+    {"404142434445464748494a4b4c4d4e4f", "1011121314151617",
+     "000102030405060708090a0b0c0d0e0f", "202122232425262728292a2b2c2d2e2f",
+     "d2a1f0e051ea5f62081a7792073d593d", "1fc64fbfaccd"},
+    {"404142434445464748494a4b4c4d4e4f", "101112131415161718191a1b",
+     "000102030405060708090a0b0c0d0e0f10111213",
+     "202122232425262728292a2b2c2d2e2f3031323334353637",
+     "e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5", "484392fbc1b09951"},
+    {"c0c1c2c3c4c5c6c7c8c9cacbcccdcecf", "00000003020100a0a1a2a3a4a5", "0001020304050607",
+     "08090a0b0c0d0e0f101112131415161718191a1b1c1d1e",
+     "588c979a61c663d2f066d0c2c0f989806d5f6b61dac384", "17e8d12cfdf926e0"},
+};
+
+static const uint8_t MAC_CU8A[mija_SIZE_MAC_ADDR] = {0xA4, 0xC1, 0x38, 0x02, 0x83, 0xF4};
+static const uint8_t KEY_CU8A[mija_SIZE_BINDKEY] =
+{
+    0xE9, 0xEF, 0xAA, 0x68, 0x73, 0xF9, 0xF9, 0xC8,
+    0x7A, 0x5E, 0x75, 0xA5, 0xF8, 0x14, 0x80, 0x1C
+};
+
+// temperature 21.0 and humidity 39.5 percent in one object
+static const uint8_t OBJECTS_CU8A[] = {0x0D, 0x10, 0x04, 0xD2, 0x00, 0x8B, 0x01};
+
+/****************************************************************************************/
+/* Local functions: */
+
+static uint32_t Hex_u32(const char *hex_cchp, uint8_t *out_u8p)
+{
+    uint32_t len_u32 = 0U;
+
+    while((0 != hex_cchp[0]) && (0 != hex_cchp[1]))
+    {
+        (void)sscanf(hex_cchp, "%2hhx", &out_u8p[len_u32++]);
+        hex_cchp += 2;
+    }
+    return(len_u32);
+}
+
+/* builds an encrypted MiBeacon v5 advertisement as a sensor sends it: the objects are
+   encrypted with the nonce of mac (frame order), product id, counter and extended
+   counter, the additional data is the byte 0x11 */
+static uint8_t BuildEncrypted_u8(const uint8_t *key_cu8p, uint8_t msgCnt_u8,
+                                    const uint8_t *obj_cu8p, uint8_t objLen_u8,
+                                    uint8_t *adv_u8p)
+{
+    mbedtls_ccm_context ccm_st;
+    uint8_t nonce_u8a[CRYPT_NONCE_LEN];
+    const uint8_t aad_cu8 = CRYPT_AAD_VAL;
+    uint8_t *data_u8p = &adv_u8p[SERVICE_DATA_POS];
+    uint8_t pos_u8 = 0U;
+
+    data_u8p[pos_u8++] = (uint8_t)FRAME_CTRL_V5;
+    data_u8p[pos_u8++] = (uint8_t)(FRAME_CTRL_V5 >> 8);
+    data_u8p[pos_u8++] = (uint8_t)PRODUCT_ID;
+    data_u8p[pos_u8++] = (uint8_t)(PRODUCT_ID >> 8);
+    data_u8p[pos_u8++] = msgCnt_u8;
+    for(uint8_t idx_u8 = 0U; idx_u8 < mija_SIZE_MAC_ADDR; idx_u8++)
+    {
+        data_u8p[pos_u8++] = MAC_CU8A[mija_SIZE_MAC_ADDR - 1U - idx_u8];
+    }
+
+    memcpy(&nonce_u8a[0], &data_u8p[DEVICE_MAC_ADR], mija_SIZE_MAC_ADDR);
+    memcpy(&nonce_u8a[6], &data_u8p[2], 2U);
+    nonce_u8a[8] = msgCnt_u8;
+    nonce_u8a[9] = 0x01U;
+    nonce_u8a[10] = 0x02U;
+    nonce_u8a[11] = 0x00U;
+
+    mbedtls_ccm_init(&ccm_st);
+    TEST_ASSERT_EQUAL_INT(0, mbedtls_ccm_setkey(&ccm_st, MBEDTLS_CIPHER_ID_AES, key_cu8p,
+                                                mija_SIZE_BINDKEY * 8U));
+    TEST_ASSERT_EQUAL_INT(0, mbedtls_ccm_encrypt_and_tag(&ccm_st, objLen_u8, nonce_u8a,
+                                CRYPT_NONCE_LEN, &aad_cu8, 1U, obj_cu8p, &data_u8p[pos_u8],
+                                &data_u8p[pos_u8 + objLen_u8 + CRYPT_EXT_CNT_LEN],
+                                CRYPT_MIC_LEN));
+    mbedtls_ccm_free(&ccm_st);
+    pos_u8 += objLen_u8;
+    memcpy(&data_u8p[pos_u8], &nonce_u8a[9], CRYPT_EXT_CNT_LEN);
+    pos_u8 += CRYPT_EXT_CNT_LEN + CRYPT_MIC_LEN;
+
+    adv_u8p[0] = 0x02U;
+    adv_u8p[1] = 0x01U;
+    adv_u8p[2] = 0x06U;
+    adv_u8p[3] = (uint8_t)(1U + AD_UUID_LEN + pos_u8);
+    adv_u8p[4] = AD_TYPE_SERVICE_DATA;
+    adv_u8p[5] = UUID_DATA_LOW_VAL;
+    adv_u8p[6] = UUID_DATA_HIGH_VAL;
+    return((uint8_t)(SERVICE_DATA_POS + pos_u8));
+}
+
+void setUp(void)
+{
+    // every test starts without keys
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(MAC_CU8A, NULL));
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* the host software path of the aes-ccm interface against the published vectors */
+static void test_CcmVectors(void)
+{
+    mbedtls_ccm_context ccm_st;
+    uint8_t key_u8a[16], nonce_u8a[16], aad_u8a[32], plain_u8a[32];
+    uint8_t cipher_u8a[32], tag_u8a[16], out_u8a[32], outTag_u8a[16];
+    uint32_t nonceLen_u32, aadLen_u32, len_u32, tagLen_u32;
+
+    for(uint32_t vec_u32 = 0U; vec_u32 < (sizeof(CCM_VECTORS_CSTA)
+                                            / sizeof(CCM_VECTORS_CSTA[0])); vec_u32++)
+    {
+        (void)Hex_u32(CCM_VECTORS_CSTA[vec_u32].key_cchp, key_u8a);
+        nonceLen_u32 = Hex_u32(CCM_VECTORS_CSTA[vec_u32].nonce_cchp, nonce_u8a);
+        aadLen_u32 = Hex_u32(CCM_VECTORS_CSTA[vec_u32].aad_cchp, aad_u8a);
+        len_u32 = Hex_u32(CCM_VECTORS_CSTA[vec_u32].plain_cchp, plain_u8a);
+        (void)Hex_u32(CCM_VECTORS_CSTA[vec_u32].cipher_cchp, cipher_u8a);
+        tagLen_u32 = Hex_u32(CCM_VECTORS_CSTA[vec_u32].tag_cchp, tag_u8a);
+
+        mbedtls_ccm_init(&ccm_st);
+        TEST_ASSERT_EQUAL_INT(0, mbedtls_ccm_setkey(&ccm_st, MBEDTLS_CIPHER_ID_AES,
+                                                    key_u8a, 128U));
+        TEST_ASSERT_EQUAL_INT(0, mbedtls_ccm_encrypt_and_tag(&ccm_st, len_u32, nonce_u8a,
+                                    nonceLen_u32, aad_u8a, aadLen_u32, plain_u8a, out_u8a,
+                                    outTag_u8a, tagLen_u32));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(cipher_u8a, out_u8a, len_u32);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(tag_u8a, outTag_u8a, tagLen_u32);
+
+        TEST_ASSERT_EQUAL_INT(0, mbedtls_ccm_auth_decrypt(&ccm_st, len_u32, nonce_u8a,
+                                    nonceLen_u32, aad_u8a, aadLen_u32, cipher_u8a, out_u8a,
+                                    tag_u8a, tagLen_u32));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(plain_u8a, out_u8a, len_u32);
+
+        // a modified cipher text fails the authentication
+        cipher_u8a[0] ^= 0x01U;
+        TEST_ASSERT_EQUAL_INT(MBEDTLS_ERR_CCM_AUTH_FAILED, mbedtls_ccm_auth_decrypt(
+                                    &ccm_st, len_u32, nonce_u8a, nonceLen_u32, aad_u8a,
+                                    aadLen_u32, cipher_u8a, out_u8a, tag_u8a, tagLen_u32));
+        mbedtls_ccm_free(&ccm_st);
+    }
+}
+
+static void test_EncryptedFrameIsDecoded(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t adv_u8a[64];
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+    uint8_t msgCnt_u8;
+    uint8_t len_u8 = BuildEncrypted_u8(KEY_CU8A, 0x5BU, OBJECTS_CU8A, sizeof(OBJECTS_CU8A),
+                                        adv_u8a);
+
+    // the frame id is readable without the key
+    TEST_ASSERT_TRUE(mijaProcl_GetFrameId_bol(adv_u8a, len_u8, mac_u8a, &msgCnt_u8));
+    TEST_ASSERT_EQUAL_MEMORY(MAC_CU8A, mac_u8a, mija_SIZE_MAC_ADDR);
+    TEST_ASSERT_EQUAL_UINT8(0x5BU, msgCnt_u8);
+    TEST_ASSERT_EQUAL_UINT8(0U, mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                                mija_MAX_OBJECTS));
+
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(MAC_CU8A, KEY_CU8A));
+    TEST_ASSERT_EQUAL_UINT8(1U, mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                                mija_MAX_OBJECTS));
+    TEST_ASSERT_EQUAL_UINT8(mija_TYPE_TEMPHUM, sample_sta[0].dataType_u8);
+    TEST_ASSERT_EQUAL_UINT16(210U, sample_sta[0].value1_u16);
+    TEST_ASSERT_EQUAL_UINT16(395U, sample_sta[0].value2_u16);
+    TEST_ASSERT_EQUAL_MEMORY(MAC_CU8A, sample_sta[0].macAddr_u8a, mija_SIZE_MAC_ADDR);
+
+    // removed key
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(MAC_CU8A, NULL));
+    TEST_ASSERT_EQUAL_UINT8(0U, mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                                mija_MAX_OBJECTS));
+}
+
+static void test_WrongKeyOrModifiedFrameIsRejected(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t key_u8a[mija_SIZE_BINDKEY];
+    uint8_t adv_u8a[64];
+    uint8_t len_u8 = BuildEncrypted_u8(KEY_CU8A, 0x10U, OBJECTS_CU8A, sizeof(OBJECTS_CU8A),
+                                        adv_u8a);
+
+    memcpy(key_u8a, KEY_CU8A, sizeof(key_u8a));
+    key_u8a[15] ^= 0x80U;
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(MAC_CU8A, key_u8a));
+    TEST_ASSERT_EQUAL_UINT8(0U, mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                                mija_MAX_OBJECTS));
+
+    // the replaced key decrypts, a changed counter breaks the nonce and the mic
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(MAC_CU8A, KEY_CU8A));
+    TEST_ASSERT_EQUAL_UINT8(1U, mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                                mija_MAX_OBJECTS));
+    adv_u8a[SERVICE_DATA_POS + MSG_CNT_ADR]++;
+    TEST_ASSERT_EQUAL_UINT8(0U, mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                                mija_MAX_OBJECTS));
+    adv_u8a[SERVICE_DATA_POS + MSG_CNT_ADR]--;
+    adv_u8a[len_u8 - 1U] ^= 0x01U;
+    TEST_ASSERT_EQUAL_UINT8(0U, mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                                mija_MAX_OBJECTS));
+}
+
+static void test_KeyCacheLimit(void)
+{
+    uint8_t mac_u8a[mija_SIZE_MAC_ADDR];
+
+    memcpy(mac_u8a, MAC_CU8A, sizeof(mac_u8a));
+    for(uint8_t idx_u8 = 0U; idx_u8 < mija_MAX_BINDKEYS; idx_u8++)
+    {
+        mac_u8a[0] = idx_u8;
+        TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(mac_u8a, KEY_CU8A));
+    }
+    mac_u8a[0] = mija_MAX_BINDKEYS;
+    TEST_ASSERT_FALSE(mijaProcl_SetBindKey_bol(mac_u8a, KEY_CU8A));
+
+    // a key of a sensor in the cache can still be replaced, a removed key frees its entry
+    mac_u8a[0] = 0U;
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(mac_u8a, KEY_CU8A));
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(mac_u8a, NULL));
+    mac_u8a[0] = mija_MAX_BINDKEYS;
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(mac_u8a, KEY_CU8A));
+
+    for(uint8_t idx_u8 = 1U; idx_u8 <= mija_MAX_BINDKEYS; idx_u8++)
+    {
+        mac_u8a[0] = idx_u8;
+        TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(mac_u8a, NULL));
+    }
+}
+
+/* decrypted frames per second with the cached key schedule, with the key schedule
+   computed per frame and for plain frames */
+static void test_BenchDecryptedFrames(void)
+{
+    static const uint8_t PLAIN_CU8A[] =
+    {
+        0x02, 0x01, 0x06, 0x15, 0x16, 0x95, 0xFE, 0x50, 0x20, 0xAA, 0x01, 0x8E,
+        0x86, 0x10, 0x37, 0x34, 0x2D, 0x58, 0x0D, 0x10, 0x04, 0xCE, 0x00, 0xB9, 0x01
+    };
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    mbedtls_ccm_context ccm_st;
+    uint8_t adv_u8a[64];
+    uint8_t len_u8 = BuildEncrypted_u8(KEY_CU8A, 0x77U, OBJECTS_CU8A, sizeof(OBJECTS_CU8A),
+                                        adv_u8a);
+    volatile uint32_t samples_u32 = 0U;
+    uint64_t startNs_u64;
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t frame_u32 = 0U; frame_u32 < BENCH_FRAMES; frame_u32++)
+    {
+        samples_u32 += mijaProcl_ParseRawSamples_u8(PLAIN_CU8A, sizeof(PLAIN_CU8A),
+                                                    sample_sta, mija_MAX_OBJECTS);
+    }
+    fake_Bench_vd("mijaProcl plain frame", BENCH_FRAMES, fake_HostNs_u64() - startNs_u64);
+
+    TEST_ASSERT_TRUE(mijaProcl_SetBindKey_bol(MAC_CU8A, KEY_CU8A));
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t frame_u32 = 0U; frame_u32 < BENCH_FRAMES; frame_u32++)
+    {
+        samples_u32 += mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                    mija_MAX_OBJECTS);
+    }
+    fake_Bench_vd("mijaProcl encrypted frame, cached key", BENCH_FRAMES,
+                    fake_HostNs_u64() - startNs_u64);
+
+    // the cost which the key cache saves on every frame
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t frame_u32 = 0U; frame_u32 < BENCH_FRAMES; frame_u32++)
+    {
+        mbedtls_ccm_init(&ccm_st);
+        (void)mbedtls_ccm_setkey(&ccm_st, MBEDTLS_CIPHER_ID_AES, KEY_CU8A,
+                                    mija_SIZE_BINDKEY * 8U);
+        mbedtls_ccm_free(&ccm_st);
+        samples_u32 += mijaProcl_ParseRawSamples_u8(adv_u8a, len_u8, sample_sta,
+                                                    mija_MAX_OBJECTS);
+    }
+    fake_Bench_vd("mijaProcl encrypted frame, key per frame", BENCH_FRAMES,
+                    fake_HostNs_u64() - startNs_u64);
+
+    TEST_ASSERT_EQUAL_UINT32(3U * BENCH_FRAMES, samples_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_CcmVectors);
+    RUN_TEST(test_EncryptedFrameIsDecoded);
+    RUN_TEST(test_WrongKeyOrModifiedFrameIsRejected);
+    RUN_TEST(test_KeyCacheLimit);
+    RUN_TEST(test_BenchDecryptedFrames);
+    return(UNITY_END());
+}
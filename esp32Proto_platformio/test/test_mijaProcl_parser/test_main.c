@@ -0,0 +1,322 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the mija advertisement parser. The AD structures are walked with
+*       length checks, several objects per frame are decoded, truncated and mutated
+*       frames are parsed from buffers of their exact length so the address sanitizer
+*       reports reads behind the input. The benchmark compares the throughput with the
+*       former fixed offset parser.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_ccm.h"
+
+#include "mijaProcl.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define BENCH_FRAMES        2000000U
+#define FUZZ_ROUNDS         200000U
+
+// fixed offsets of the parser before the AD structures were walked
+#define LEGACY_UUID_LOW_ADR         5U
+#define LEGACY_UUID_HIGH_ADR        6U
+#define LEGACY_MSG_CNT_ADR          11U
+#define LEGACY_MAC_ADR              17U
+#define LEGACY_TYPE_ADR             18U
+#define LEGACY_LEN_ADR              20U
+#define LEGACY_DATA_ADR             21U
+
+/****************************************************************************************/
+/* Local variables: */
+
+// the example of the module description: flags, service data with temperature/humidity
+static const uint8_t EXAMPLE_CU8A[] =
+{
+    0x02, 0x01, 0x06, 0x15, 0x16, 0x95, 0xFE, 0x50, 0x20, 0xAA, 0x01, 0x8E,
+    0x86, 0x10, 0x37, 0x34, 0x2D, 0x58, 0x0D, 0x10, 0x04, 0xCE, 0x00, 0xB9, 0x01
+};
+
+// a name and a foreign service in front, temperature, humidity, an unknown object and
+// the battery level in one frame
+static const uint8_t MULTI_CU8A[] =
+{
+    0x02, 0x01, 0x06,
+    0x04, 0x09, 0x4D, 0x4A, 0x41,
+    0x04, 0x16, 0x1A, 0x18, 0x00,
+    0x22, 0x16, 0x95, 0xFE, 0x50, 0x20, 0x5B, 0x05, 0x11,
+    0x86, 0x10, 0x37, 0x34, 0x2D, 0x58,
+    0x04, 0x10, 0x02, 0xD2, 0x00,
+    0x06, 0x10, 0x02, 0x8B, 0x01,
+    0x07, 0x10, 0x03, 0x01, 0x02, 0x03,
+    0x0A, 0x10, 0x01, 0x5D
+};
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* the parser before the AD structures were walked, reads fixed offsets without any
+   length check. Kept here as the reference of the throughput benchmark. */
+static bool LegacyParseRawSample_bol(const uint8_t *msg_cu8p,
+                                        mijaProcl_rawSample_t *out_stp)
+{
+    bool exeResult_bol = false;
+    uint8_t dataLen_u8;
+
+    if(   (UUID_DATA_LOW_VAL == msg_cu8p[LEGACY_UUID_LOW_ADR])
+       && (UUID_DATA_HIGH_VAL == msg_cu8p[LEGACY_UUID_HIGH_ADR]))
+    {
+        for(uint8_t macIdx_u8 = 0U; macIdx_u8 < mija_SIZE_MAC_ADDR; macIdx_u8++)
+        {
+            out_stp->macAddr_u8a[macIdx_u8] = msg_cu8p[LEGACY_MAC_ADR - macIdx_u8];
+        }
+        out_stp->msgCnt_u8 = msg_cu8p[LEGACY_MSG_CNT_ADR];
+        out_stp->dataType_u8 = msg_cu8p[LEGACY_TYPE_ADR];
+        out_stp->value1_u16 = ReadLe16_u16(&msg_cu8p[LEGACY_DATA_ADR]);
+        out_stp->value2_u16 = 0U;
+        dataLen_u8 = msg_cu8p[LEGACY_LEN_ADR];
+
+        switch(out_stp->dataType_u8)
+        {
+            case DATA_TYPE_ID_TEMP:
+            case DATA_TYPE_ID_HUM:
+                exeResult_bol = (DATA_LEN_TEMP_STD == dataLen_u8);
+                break;
+            case DATA_TYPE_ID_BATT:
+                out_stp->value1_u16 &= 0x00FFU;
+                exeResult_bol = (DATA_LEN_BATTERY_STD == dataLen_u8);
+                break;
+            case DATA_TYPE_ID_TEMPHUM:
+                out_stp->value2_u16 = ReadLe16_u16(&msg_cu8p[LEGACY_DATA_ADR + 2U]);
+                exeResult_bol = (DATA_LEN_TEMPHUM_STD == dataLen_u8);
+                break;
+            default:
+                exeResult_bol = false;
+                break;
+        }
+    }
+
+    return(exeResult_bol);
+}
+
+/* parses a copy of exactly len_u8 bytes, the address sanitizer reports any read
+   behind the advertisement */
+static uint8_t ParseExact_u8(const uint8_t *adv_cu8p, uint8_t len_u8,
+                                mijaProcl_rawSample_t *out_stap)
+{
+    uint8_t *copy_u8p = (uint8_t *)malloc((0U == len_u8) ? 1U : len_u8);
+    uint8_t samples_u8;
+
+    memcpy(copy_u8p, adv_cu8p, len_u8);
+    samples_u8 = mijaProcl_ParseRawSamples_u8(copy_u8p, len_u8, out_stap,
+                                                mija_MAX_OBJECTS);
+    free(copy_u8p);
+    return(samples_u8);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_ExampleFrame(void)
+{
+    static const uint8_t MAC_CU8A[mija_SIZE_MAC_ADDR] =
+                                            {0x58, 0x2D, 0x34, 0x37, 0x10, 0x86};
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    mijaProcl_parsedData_t parsed_st;
+
+    TEST_ASSERT_EQUAL_UINT8(1U, ParseExact_u8(EXAMPLE_CU8A, sizeof(EXAMPLE_CU8A),
+                                                &sample_sta[0]));
+    TEST_ASSERT_EQUAL_MEMORY(MAC_CU8A, sample_sta[0].macAddr_u8a, mija_SIZE_MAC_ADDR);
+    TEST_ASSERT_EQUAL_UINT8(0x8EU, sample_sta[0].msgCnt_u8);
+
+    TEST_ASSERT_TRUE(mijaProcl_ParseMessage_bol(EXAMPLE_CU8A, sizeof(EXAMPLE_CU8A),
+                                                &parsed_st));
+    TEST_ASSERT_EQUAL(mija_TYPE_TEMPHUM, parsed_st.dataType_en);
+    TEST_ASSERT_EQUAL_INT16(206, parsed_st.temperature_s16);
+    TEST_ASSERT_EQUAL_UINT16(441U, parsed_st.humidity_u16);
+}
+
+static void test_SeveralObjectsBehindOtherStructures(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+
+    // the unknown object 0x1007 is skipped
+    TEST_ASSERT_EQUAL_UINT8(3U, ParseExact_u8(MULTI_CU8A, sizeof(MULTI_CU8A),
+                                                &sample_sta[0]));
+    TEST_ASSERT_EQUAL_UINT8(mija_TYPE_TEMPERATURE, sample_sta[0].dataType_u8);
+    TEST_ASSERT_EQUAL_UINT16(210U, sample_sta[0].value1_u16);
+    TEST_ASSERT_EQUAL_UINT8(mija_TYPE_HUMIDITY, sample_sta[1].dataType_u8);
+    TEST_ASSERT_EQUAL_UINT16(395U, sample_sta[1].value1_u16);
+    TEST_ASSERT_EQUAL_UINT8(mija_TYPE_BATTERY, sample_sta[2].dataType_u8);
+    TEST_ASSERT_EQUAL_UINT16(93U, sample_sta[2].value1_u16);
+    TEST_ASSERT_EQUAL_UINT8(0x11U, sample_sta[2].msgCnt_u8);
+
+    // the caller limits the number of samples
+    TEST_ASSERT_EQUAL_UINT8(1U, mijaProcl_ParseRawSamples_u8(MULTI_CU8A, sizeof(MULTI_CU8A),
+                                                                &sample_sta[0], 1U));
+}
+
+static void test_TruncatedFramesAreRejected(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+
+    // the service data structure does not fit into a shorter advertisement
+    for(uint8_t len_u8 = 0U; len_u8 < sizeof(EXAMPLE_CU8A); len_u8++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(0U, ParseExact_u8(EXAMPLE_CU8A, len_u8, &sample_sta[0]));
+    }
+    for(uint8_t len_u8 = 0U; len_u8 < sizeof(MULTI_CU8A); len_u8++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(0U, ParseExact_u8(MULTI_CU8A, len_u8, &sample_sta[0]));
+    }
+}
+
+static void test_ObjectLengthsAreChecked(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t adv_u8a[sizeof(EXAMPLE_CU8A)];
+
+    // temperature/humidity object announced with 2 bytes only
+    memcpy(adv_u8a, EXAMPLE_CU8A, sizeof(adv_u8a));
+    adv_u8a[20] = 0x02U;
+    TEST_ASSERT_EQUAL_UINT8(0U, ParseExact_u8(adv_u8a, sizeof(adv_u8a), &sample_sta[0]));
+
+    // object data longer than the service data
+    adv_u8a[20] = 0x05U;
+    TEST_ASSERT_EQUAL_UINT8(0U, ParseExact_u8(adv_u8a, sizeof(adv_u8a), &sample_sta[0]));
+
+    // AD length pointing behind the advertisement
+    memcpy(adv_u8a, EXAMPLE_CU8A, sizeof(adv_u8a));
+    adv_u8a[3] = 0x16U;
+    TEST_ASSERT_EQUAL_UINT8(0U, ParseExact_u8(adv_u8a, sizeof(adv_u8a), &sample_sta[0]));
+
+    // frame without mac address
+    memcpy(adv_u8a, EXAMPLE_CU8A, sizeof(adv_u8a));
+    adv_u8a[7] = 0x40U;
+    TEST_ASSERT_EQUAL_UINT8(0U, ParseExact_u8(adv_u8a, sizeof(adv_u8a), &sample_sta[0]));
+}
+
+/* random mutations of valid frames, the parser must neither read behind the input nor
+   return more samples than requested */
+static void test_MutatedFrames(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    uint8_t adv_u8a[64];
+    uint32_t seed_u32 = 0xC0FFEEU;
+    uint32_t accepted_u32 = 0U;
+    uint8_t len_u8;
+    uint8_t samples_u8;
+
+    for(uint32_t round_u32 = 0U; round_u32 < FUZZ_ROUNDS; round_u32++)
+    {
+        seed_u32 = (seed_u32 * 1103515245U) + 12345U;
+        if(0U == (round_u32 & 1U))
+        {
+            len_u8 = sizeof(EXAMPLE_CU8A);
+            memcpy(adv_u8a, EXAMPLE_CU8A, len_u8);
+        }
+        else
+        {
+            len_u8 = sizeof(MULTI_CU8A);
+            memcpy(adv_u8a, MULTI_CU8A, len_u8);
+        }
+        // one to four random bytes and a random length
+        for(uint32_t flip_u32 = 0U; flip_u32 <= ((seed_u32 >> 4) & 3U); flip_u32++)
+        {
+            seed_u32 = (seed_u32 * 1103515245U) + 12345U;
+            adv_u8a[(seed_u32 >> 8) % len_u8] = (uint8_t)(seed_u32 >> 16);
+        }
+        len_u8 = (uint8_t)(len_u8 - ((seed_u32 >> 24) % 4U));
+
+        samples_u8 = ParseExact_u8(adv_u8a, len_u8, &sample_sta[0]);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(mija_MAX_OBJECTS, samples_u8);
+        accepted_u32 += (0U < samples_u8) ? 1U : 0U;
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, accepted_u32);
+}
+
+/* frames per second of the fixed offset parser against the walking parser */
+static void test_BenchAgainstFixedOffsets(void)
+{
+    mijaProcl_rawSample_t sample_sta[mija_MAX_OBJECTS];
+    volatile uint32_t samples_u32 = 0U;
+    uint64_t startNs_u64;
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t frame_u32 = 0U; frame_u32 < BENCH_FRAMES; frame_u32++)
+    {
+        samples_u32 += (true == LegacyParseRawSample_bol(EXAMPLE_CU8A, &sample_sta[0])) ?
+                            1U : 0U;
+    }
+    fake_Bench_vd("mijaProcl fixed offsets, 1 object", BENCH_FRAMES,
+                    fake_HostNs_u64() - startNs_u64);
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t frame_u32 = 0U; frame_u32 < BENCH_FRAMES; frame_u32++)
+    {
+        samples_u32 += mijaProcl_ParseRawSamples_u8(EXAMPLE_CU8A, sizeof(EXAMPLE_CU8A),
+                                                    &sample_sta[0], mija_MAX_OBJECTS);
+    }
+    fake_Bench_vd("mijaProcl AD walk, 1 object", BENCH_FRAMES,
+                    fake_HostNs_u64() - startNs_u64);
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t frame_u32 = 0U; frame_u32 < BENCH_FRAMES; frame_u32++)
+    {
+        samples_u32 += mijaProcl_ParseRawSamples_u8(MULTI_CU8A, sizeof(MULTI_CU8A),
+                                                    &sample_sta[0], mija_MAX_OBJECTS);
+    }
+    fake_Bench_vd("mijaProcl AD walk, 3 objects", BENCH_FRAMES,
+                    fake_HostNs_u64() - startNs_u64);
+
+    TEST_ASSERT_EQUAL_UINT32(5U * BENCH_FRAMES, samples_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ExampleFrame);
+    RUN_TEST(test_SeveralObjectsBehindOtherStructures);
+    RUN_TEST(test_TruncatedFramesAreRejected);
+    RUN_TEST(test_ObjectLengthsAreChecked);
+    RUN_TEST(test_MutatedFrames);
+    RUN_TEST(test_BenchAgainstFixedOffsets);
+    return(UNITY_END());
+}
@@ -0,0 +1,278 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the last value cache of mqttdrv. Unchanged values are suppressed
+*       until the max age, while disconnected only the newest value per topic is kept
+*       and published with its acknowledge after reconnection.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_mqtt.h"
+
+#include "utils.c"
+#include "mqttdrv.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define ACK_LATENCY_US      20000U      // broker round trip of the simulation
+
+/****************************************************************************************/
+/* Local variables: */
+
+static uint32_t ackedCalls_u32s;
+static uint32_t lastRxUs_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static void OnAcked_vd(uint32_t rxUs_u32, uint32_t queuedUs_u32, uint32_t ackUs_u32)
+{
+    (void)queuedUs_u32;
+    (void)ackUs_u32;
+    ackedCalls_u32s++;
+    lastRxUs_u32s = rxUs_u32;
+}
+
+/* one pass of the mqtt task for a publish request */
+static void RunMqttTask_vd(void)
+{
+    EventBits_t bits_u32 = xEventGroupWaitBits(mqttEventGroup_sts, PUBLISH_REQ, true, 
+                                                false, 0U);
+
+    if(0U != (bits_u32 & PUBLISH_REQ))
+    {
+        PublishPendingSlots_vd();
+        if((true == lvcFlushPending_bol) && (STATE_CONNECTED == this_sst.state_en))
+        {
+            FlushCache_vd();
+        }
+    }
+}
+
+/* publishes one value and hands it over to the client */
+static esp_err_t Publish_td(const char *topic_cchp, const char *data_cchp, 
+                            mqttif_Acked_td acked_fp)
+{
+    mqttif_msg_t msg_st;
+    esp_err_t result_st;
+
+    memset(&msg_st, 0, sizeof(msg_st));
+    msg_st.topic_chp = (char *)topic_cchp;
+    msg_st.topicLen_u32 = strlen(topic_cchp);
+    msg_st.data_chp = (char *)data_cchp;
+    msg_st.dataLen_u32 = strlen(data_cchp);
+    msg_st.qos_s32 = 1;
+    msg_st.rxUs_u32 = (uint32_t)fake_nowUs_s64;
+    msg_st.acked_fp = acked_fp;
+    result_st = mqttdrv_Publish_td(&msg_st, 0U);
+    RunMqttTask_vd();
+    fake_AdvanceUs_vd(ACK_LATENCY_US);
+    (void)fake_MqttDeliverAcks_u32();
+    return(result_st);
+}
+
+static mqttdrv_cacheStats_t GetStats_st(void)
+{
+    mqttdrv_cacheStats_t stats_st;
+
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_GetCacheStats_td(&stats_st));
+    return(stats_st);
+}
+
+void setUp(void)
+{
+    mqttdrv_param_t param_st;
+
+    fake_MqttReset_vd();
+    fake_mqttAckLatencyUs_u32 = ACK_LATENCY_US;
+    ackedCalls_u32s = 0U;
+    lastRxUs_u32s = 0U;
+
+    this_sst.state_en = STATE_NOT_INITIALIZED;
+    memset(lvcEntries_sta, 0, sizeof(lvcEntries_sta));
+    memset(&lvcStats_sts, 0, sizeof(lvcStats_sts));
+    memset(earlyAcks_s32a, 0, sizeof(earlyAcks_s32a));
+    lvcFlushPending_bol = false;
+
+    (void)mqttdrv_InitializeParameter_td(&param_st);
+    strcpy((char *)param_st.host_u8a, "127.0.0.1");
+    param_st.port_u32 = 1883U;
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_Initialize_td(&param_st));
+    TEST_ASSERT_EQUAL(ESP_OK, Connect());
+    fake_MqttEvent_vd(MQTT_EVENT_CONNECTED, 0);
+    TEST_ASSERT_EQUAL(STATE_CONNECTED, this_sst.state_en);
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_UnchangedValueIsSuppressed(void)
+{
+    mqttdrv_cacheStats_t stats_st;
+
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.5", NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.5", NULL));
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_mqttPublishCalls_u32);
+
+    // a changed value and a different topic are published
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.6", NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/hum", "21.6", NULL));
+    TEST_ASSERT_EQUAL_UINT32(3U, fake_mqttPublishCalls_u32);
+    TEST_ASSERT_EQUAL_STRING("21.6", fake_MqttLastPub_cstp(1U)->data_ca);
+
+    stats_st = GetStats_st();
+    TEST_ASSERT_EQUAL_UINT32(2U, stats_st.hit_u32);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats_st.miss_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.suppressed_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, stats_st.coalesced_u32);
+}
+
+static void test_UnchangedValueIsRefreshedAfterMaxAge(void)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.5", NULL));
+    fake_AdvanceMs_vd(LVC_MAX_AGE_MS - 1000U);
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.5", NULL));
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_mqttPublishCalls_u32);
+
+    fake_AdvanceMs_vd(1000U);
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.5", NULL));
+    TEST_ASSERT_EQUAL_UINT32(2U, fake_mqttPublishCalls_u32);
+
+    // the max age starts again with the refresh
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.5", NULL));
+    TEST_ASSERT_EQUAL_UINT32(2U, fake_mqttPublishCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(2U, GetStats_st().suppressed_u32);
+}
+
+static void test_OfflineKeepsOnlyTheNewestValue(void)
+{
+    mqttdrv_cacheStats_t stats_st;
+
+    fake_MqttEvent_vd(MQTT_EVENT_DISCONNECTED, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.5", NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.6", NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.7", NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/hum", "48.0", NULL));
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_mqttPublishCalls_u32);
+
+    fake_MqttEvent_vd(MQTT_EVENT_CONNECTED, 0);
+    RunMqttTask_vd();
+    TEST_ASSERT_EQUAL_UINT32(2U, fake_mqttPublishCalls_u32);
+    TEST_ASSERT_EQUAL_STRING("dev/temp", fake_MqttLastPub_cstp(1U)->topic_ca);
+    TEST_ASSERT_EQUAL_STRING("21.7", fake_MqttLastPub_cstp(1U)->data_ca);
+    TEST_ASSERT_EQUAL_STRING("dev/hum", fake_MqttLastPub_cstp(0U)->topic_ca);
+
+    stats_st = GetStats_st();
+    TEST_ASSERT_EQUAL_UINT32(2U, stats_st.hit_u32);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats_st.miss_u32);
+    TEST_ASSERT_EQUAL_UINT32(2U, stats_st.coalesced_u32);
+
+    // the flushed value is the reference for the suppression
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.7", NULL));
+    TEST_ASSERT_EQUAL_UINT32(2U, fake_mqttPublishCalls_u32);
+}
+
+static void test_CachedValueIsAcknowledgedAfterFlush(void)
+{
+    uint32_t newestUs_u32;
+
+    fake_MqttEvent_vd(MQTT_EVENT_DISCONNECTED, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.5", OnAcked_vd));
+    newestUs_u32 = (uint32_t)fake_nowUs_s64;
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.6", OnAcked_vd));
+    TEST_ASSERT_EQUAL_UINT32(0U, ackedCalls_u32s);
+
+    // only the published newest value is acknowledged, with its reception stamp
+    fake_MqttEvent_vd(MQTT_EVENT_CONNECTED, 0);
+    RunMqttTask_vd();
+    fake_AdvanceUs_vd(ACK_LATENCY_US);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_MqttDeliverAcks_u32());
+    TEST_ASSERT_EQUAL_UINT32(1U, ackedCalls_u32s);
+    TEST_ASSERT_EQUAL_UINT32(newestUs_u32, lastRxUs_u32s);
+
+    // a suppressed value is never acknowledged
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/temp", "21.6", OnAcked_vd));
+    TEST_ASSERT_EQUAL_UINT32(1U, ackedCalls_u32s);
+}
+
+static void test_LeastRecentlyPublishedTopicIsReplaced(void)
+{
+    char topic_ca[16];
+    mqttdrv_cacheStats_t stats_st;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 <= LVC_ENTRIES_NUM; idx_u32++)
+    {
+        sprintf(topic_ca, "dev/s%u", idx_u32);
+        TEST_ASSERT_EQUAL(ESP_OK, Publish_td(topic_ca, "1", NULL));
+    }
+    TEST_ASSERT_EQUAL_UINT32(LVC_ENTRIES_NUM + 1U, GetStats_st().miss_u32);
+
+    // the first topic was replaced and is published again, the newest is still cached
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/s0", "1", NULL));
+    sprintf(topic_ca, "dev/s%u", LVC_ENTRIES_NUM);
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td(topic_ca, "1", NULL));
+    TEST_ASSERT_EQUAL_UINT32(LVC_ENTRIES_NUM + 2U, fake_mqttPublishCalls_u32);
+
+    stats_st = GetStats_st();
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.hit_u32);
+    TEST_ASSERT_EQUAL_UINT32(LVC_ENTRIES_NUM + 2U, stats_st.miss_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, stats_st.suppressed_u32);
+}
+
+static void test_LongValueBypassesTheCache(void)
+{
+    char data_ca[LVC_DATA_SIZE + 1U];
+
+    memset(data_ca, 'x', LVC_DATA_SIZE);
+    data_ca[LVC_DATA_SIZE] = '\0';
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/doc", data_ca, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td("dev/doc", data_ca, NULL));
+    TEST_ASSERT_EQUAL_UINT32(2U, fake_mqttPublishCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, GetStats_st().hit_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, GetStats_st().miss_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_UnchangedValueIsSuppressed);
+    RUN_TEST(test_UnchangedValueIsRefreshedAfterMaxAge);
+    RUN_TEST(test_OfflineKeepsOnlyTheNewestValue);
+    RUN_TEST(test_CachedValueIsAcknowledgedAfterFlush);
+    RUN_TEST(test_LeastRecentlyPublishedTopicIsReplaced);
+    RUN_TEST(test_LongValueBypassesTheCache);
+    return(UNITY_END());
+}
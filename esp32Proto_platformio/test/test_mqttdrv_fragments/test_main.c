@@ -0,0 +1,240 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the receive path of mqttdrv. Complete messages reach the
+*       subscription callback as views into the client event buffer, fragmented
+*       MQTT_EVENT_DATA events are collected and handed over once the last fragment
+*       arrived.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_mqtt.h"
+
+#include "utils.c"
+#include "mqttdrv.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define TOPIC               "home/kitchen/cmd"
+#define TOKEN               0x5A17U
+
+/****************************************************************************************/
+/* Local variables: */
+
+static mqttdrv_subsHdl_t subs_xps;
+static uint32_t received_u32s;
+static uint32_t lastToken_u32s;
+static const char *lastData_cchps;
+static char lastTopic_cas[mqttif_MAX_SIZE_OF_TOPIC];
+static char lastData_cas[mqttif_MAX_SIZE_OF_DATA + 1U];
+
+/****************************************************************************************/
+/* Local functions: */
+
+static void OnConnected_vd(void)
+{
+}
+
+/* the views are only valid during the call, the content is copied for the checks */
+static esp_err_t OnData_td(mqttif_msg_t *msg_stp)
+{
+    received_u32s++;
+    lastToken_u32s = msg_stp->token_u32;
+    lastData_cchps = msg_stp->data_chp;
+    memcpy(lastTopic_cas, msg_stp->topic_chp, msg_stp->topicLen_u32);
+    lastTopic_cas[msg_stp->topicLen_u32] = 0;
+    memcpy(lastData_cas, msg_stp->data_chp, msg_stp->dataLen_u32);
+    lastData_cas[msg_stp->dataLen_u32] = 0;
+    return(ESP_OK);
+}
+
+/* sends the payload in fragments of fragLen_s32 bytes like the client does for
+   messages larger than its receive buffer */
+static void SendFragmented_vd(const char *data_cchp, int fragLen_s32)
+{
+    int total_s32 = (int)strlen(data_cchp);
+    int len_s32;
+
+    for(int offset_s32 = 0; offset_s32 < total_s32; offset_s32 += fragLen_s32)
+    {
+        len_s32 = ((total_s32 - offset_s32) < fragLen_s32) ?
+                        (total_s32 - offset_s32) : fragLen_s32;
+        fake_MqttData_vd(TOPIC, &data_cchp[offset_s32], len_s32, offset_s32, total_s32);
+    }
+}
+
+static void FillPayload_vd(char *data_chp, uint32_t len_u32)
+{
+    for(uint32_t idx_u32 = 0U; idx_u32 < len_u32; idx_u32++)
+    {
+        data_chp[idx_u32] = (char)('a' + (idx_u32 % 26U));
+    }
+    data_chp[len_u32] = 0;
+}
+
+void setUp(void)
+{
+    mqttdrv_param_t param_st;
+    mqttif_substParam_t subsParam_st;
+
+    fake_MqttReset_vd();
+    received_u32s = 0U;
+    lastToken_u32s = 0U;
+    lastData_cchps = NULL;
+    memset(&rxAssembly_sts, 0, sizeof(rxAssembly_sts));
+
+    this_sst.state_en = STATE_NOT_INITIALIZED;
+    (void)mqttdrv_InitializeParameter_td(&param_st);
+    strcpy((char *)param_st.host_u8a, "127.0.0.1");
+    param_st.port_u32 = 1883U;
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_Initialize_td(&param_st));
+    TEST_ASSERT_EQUAL(ESP_OK, Connect());
+    fake_MqttEvent_vd(MQTT_EVENT_CONNECTED, 0);
+
+    memset(&subsParam_st, 0, sizeof(subsParam_st));
+    strcpy((char *)subsParam_st.topic_u8a, TOPIC);
+    subsParam_st.conn_fp = OnConnected_vd;
+    subsParam_st.dataRecv_fp = OnData_td;
+    subsParam_st.token_u32 = TOKEN;
+    subs_xps = mqttdrv_AllocSubs_xp(&subsParam_st);
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_Subscribe_td(subs_xps));
+}
+
+void tearDown(void)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_DeAllocSubs_st(subs_xps));
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_CompleteMessageIsNotCopied(void)
+{
+    static const char DATA_CCA[] = "{\"on\":1}";
+
+    fake_MqttData_vd(TOPIC, DATA_CCA, (int)strlen(DATA_CCA), 0, (int)strlen(DATA_CCA));
+    TEST_ASSERT_EQUAL_UINT32(1U, received_u32s);
+    TEST_ASSERT_EQUAL_UINT32(TOKEN, lastToken_u32s);
+    // the callback sees the buffer of the client event
+    TEST_ASSERT_EQUAL_PTR(DATA_CCA, lastData_cchps);
+    TEST_ASSERT_EQUAL_STRING(TOPIC, lastTopic_cas);
+    TEST_ASSERT_EQUAL_STRING(DATA_CCA, lastData_cas);
+}
+
+static void test_FragmentsAreDeliveredOnceComplete(void)
+{
+    char data_ca[mqttif_MAX_SIZE_OF_DATA + 1U];
+
+    FillPayload_vd(data_ca, 200U);
+    fake_MqttData_vd(TOPIC, data_ca, 64, 0, 200);
+    fake_MqttData_vd(TOPIC, &data_ca[64], 64, 64, 200);
+    fake_MqttData_vd(TOPIC, &data_ca[128], 64, 128, 200);
+    TEST_ASSERT_EQUAL_UINT32(0U, received_u32s);
+
+    fake_MqttData_vd(TOPIC, &data_ca[192], 8, 192, 200);
+    TEST_ASSERT_EQUAL_UINT32(1U, received_u32s);
+    TEST_ASSERT_EQUAL_UINT32(TOKEN, lastToken_u32s);
+    TEST_ASSERT_EQUAL_PTR(rxAssembly_sts.data_ca, lastData_cchps);
+    // the topic only came with the first fragment
+    TEST_ASSERT_EQUAL_STRING(TOPIC, lastTopic_cas);
+    TEST_ASSERT_EQUAL_STRING(data_ca, lastData_cas);
+}
+
+static void test_AllFragmentSizesAssembleTheSamePayload(void)
+{
+    char data_ca[mqttif_MAX_SIZE_OF_DATA + 1U];
+
+    FillPayload_vd(data_ca, mqttif_MAX_SIZE_OF_DATA);
+    for(int frag_s32 = 1; frag_s32 < (int)mqttif_MAX_SIZE_OF_DATA; frag_s32 += 7)
+    {
+        received_u32s = 0U;
+        SendFragmented_vd(data_ca, frag_s32);
+        TEST_ASSERT_EQUAL_UINT32(1U, received_u32s);
+        TEST_ASSERT_EQUAL_STRING(data_ca, lastData_cas);
+    }
+}
+
+static void test_MissingFragmentDropsMessage(void)
+{
+    char data_ca[mqttif_MAX_SIZE_OF_DATA + 1U];
+
+    FillPayload_vd(data_ca, 120U);
+    fake_MqttData_vd(TOPIC, data_ca, 40, 0, 120);
+    fake_MqttData_vd(TOPIC, &data_ca[80], 40, 80, 120);
+    fake_MqttData_vd(TOPIC, &data_ca[40], 40, 40, 120);
+    TEST_ASSERT_EQUAL_UINT32(0U, received_u32s);
+    TEST_ASSERT_FALSE(rxAssembly_sts.active_bol);
+
+    // the next message is assembled again
+    SendFragmented_vd(data_ca, 40);
+    TEST_ASSERT_EQUAL_UINT32(1U, received_u32s);
+    TEST_ASSERT_EQUAL_STRING(data_ca, lastData_cas);
+}
+
+static void test_NewMessageRestartsAssembly(void)
+{
+    char data_ca[mqttif_MAX_SIZE_OF_DATA + 1U];
+
+    FillPayload_vd(data_ca, 100U);
+    // the rest of the first message got lost with a reconnect
+    fake_MqttData_vd(TOPIC, "XXXXXXXXXX", 10, 0, 150);
+    SendFragmented_vd(data_ca, 30);
+    TEST_ASSERT_EQUAL_UINT32(1U, received_u32s);
+    TEST_ASSERT_EQUAL_STRING(data_ca, lastData_cas);
+}
+
+static void test_OversizedMessageIsDropped(void)
+{
+    static char data_ca[2U * mqttif_MAX_SIZE_OF_DATA + 1U];
+
+    FillPayload_vd(data_ca, 2U * mqttif_MAX_SIZE_OF_DATA);
+    SendFragmented_vd(data_ca, 100);
+    TEST_ASSERT_EQUAL_UINT32(0U, received_u32s);
+
+    // a fragment beyond the announced length is not written into the buffer
+    fake_MqttData_vd(TOPIC, data_ca, 50, 0, 60);
+    fake_MqttData_vd(TOPIC, &data_ca[50], 50, 50, 60);
+    TEST_ASSERT_EQUAL_UINT32(0U, received_u32s);
+    TEST_ASSERT_FALSE(rxAssembly_sts.active_bol);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_CompleteMessageIsNotCopied);
+    RUN_TEST(test_FragmentsAreDeliveredOnceComplete);
+    RUN_TEST(test_AllFragmentSizesAssembleTheSamePayload);
+    RUN_TEST(test_MissingFragmentDropsMessage);
+    RUN_TEST(test_NewMessageRestartsAssembly);
+    RUN_TEST(test_OversizedMessageIsDropped);
+    return(UNITY_END());
+}
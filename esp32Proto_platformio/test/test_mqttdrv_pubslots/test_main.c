@@ -0,0 +1,279 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the publication slots of mqttdrv. The esp-mqtt client is replaced
+*       by test/fakes/fake_mqtt.h which acknowledges QoS 1 publications after a
+*       configurable latency, also before the message id is stored. The benchmark
+*       compares the publication rate with the former single slot.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_mqtt.h"
+
+#include "utils.c"
+#include "mqttdrv.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define ACK_LATENCY_US      20000U      // broker round trip of the simulation
+#define BENCH_MESSAGES      1000U
+
+/****************************************************************************************/
+/* Local variables: */
+
+static uint32_t ackedCalls_u32s;
+static uint32_t lastRxUs_u32s;
+static uint32_t lastQueuedUs_u32s;
+static uint32_t lastAckUs_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static void OnAcked_vd(uint32_t rxUs_u32, uint32_t queuedUs_u32, uint32_t ackUs_u32)
+{
+    ackedCalls_u32s++;
+    lastRxUs_u32s = rxUs_u32;
+    lastQueuedUs_u32s = queuedUs_u32;
+    lastAckUs_u32s = ackUs_u32;
+}
+
+/* one pass of the mqtt task for a publish request */
+static void RunMqttTask_vd(void)
+{
+    EventBits_t bits_u32 = xEventGroupWaitBits(mqttEventGroup_sts, PUBLISH_REQ, true, 
+                                                false, 0U);
+
+    if(0U != (bits_u32 & PUBLISH_REQ))
+    {
+        PublishPendingSlots_vd();
+        if((true == lvcFlushPending_bol) && (STATE_CONNECTED == this_sst.state_en))
+        {
+            FlushCache_vd();
+        }
+    }
+}
+
+static esp_err_t Publish_td(uint32_t seq_u32, int32_t qos_s32, mqttif_Acked_td acked_fp)
+{
+    char topic_ca[32];
+    char data_ca[32];
+    mqttif_msg_t msg_st;
+
+    memset(&msg_st, 0, sizeof(msg_st));
+    msg_st.topicLen_u32 = (uint32_t)sprintf(topic_ca, "test/sens%u", seq_u32 % 8U);
+    msg_st.dataLen_u32 = (uint32_t)sprintf(data_ca, "%u", seq_u32);
+    msg_st.topic_chp = topic_ca;
+    msg_st.data_chp = data_ca;
+    msg_st.qos_s32 = qos_s32;
+    msg_st.rxUs_u32 = (uint32_t)fake_nowUs_s64;
+    msg_st.acked_fp = acked_fp;
+    return(mqttdrv_Publish_td(&msg_st, 0U));
+}
+
+static uint32_t CountSlots_u32(pubSlotState_t state_en)
+{
+    uint32_t count_u32 = 0U;
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < PUB_SLOTS_NUM; idx_u8++)
+    {
+        count_u32 += (state_en == pubSlots_sta[idx_u8].state_en) ? 1U : 0U;
+    }
+    return(count_u32);
+}
+
+void setUp(void)
+{
+    mqttdrv_param_t param_st;
+
+    fake_MqttReset_vd();
+    fake_mqttAckLatencyUs_u32 = ACK_LATENCY_US;
+    ackedCalls_u32s = 0U;
+
+    this_sst.state_en = STATE_NOT_INITIALIZED;
+    memset(lvcEntries_sta, 0, sizeof(lvcEntries_sta));
+    memset(earlyAcks_s32a, 0, sizeof(earlyAcks_s32a));
+    lvcFlushPending_bol = false;
+
+    (void)mqttdrv_InitializeParameter_td(&param_st);
+    strcpy((char *)param_st.host_u8a, "127.0.0.1");
+    param_st.port_u32 = 1883U;
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_Initialize_td(&param_st));
+    TEST_ASSERT_EQUAL(ESP_OK, Connect());
+    fake_MqttEvent_vd(MQTT_EVENT_CONNECTED, 0);
+    TEST_ASSERT_EQUAL(STATE_CONNECTED, this_sst.state_en);
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_AllSlotsInFlightUntilAcknowledged(void)
+{
+    for(uint32_t seq_u32 = 0U; seq_u32 < PUB_SLOTS_NUM; seq_u32++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, Publish_td(seq_u32, 1, NULL));
+        RunMqttTask_vd();
+    }
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, fake_mqttPublishCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, CountSlots_u32(SLOT_WAIT_ACK));
+
+    // ring is full, the next publication is rejected without timeout
+    TEST_ASSERT_EQUAL(ESP_FAIL, Publish_td(PUB_SLOTS_NUM, 1, NULL));
+
+    fake_AdvanceUs_vd(ACK_LATENCY_US);
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, fake_MqttDeliverAcks_u32());
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, CountSlots_u32(SLOT_FREE));
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td(PUB_SLOTS_NUM, 1, NULL));
+}
+
+static void test_QoS0ReleasesSlotAtOnce(void)
+{
+    for(uint32_t seq_u32 = 0U; seq_u32 < 100U; seq_u32++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, Publish_td(seq_u32, 0, NULL));
+        RunMqttTask_vd();
+    }
+    TEST_ASSERT_EQUAL_UINT32(100U, fake_mqttPublishCalls_u32);
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, CountSlots_u32(SLOT_FREE));
+}
+
+static void test_AcknowledgeBeforeMsgIdIsStored(void)
+{
+    fake_mqttAckInPublish_bol = true;
+    for(uint32_t seq_u32 = 0U; seq_u32 < (3U * PUB_SLOTS_NUM); seq_u32++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, Publish_td(seq_u32, 1, OnAcked_vd));
+        RunMqttTask_vd();
+    }
+    // the early acknowledges released every slot and were reported once each
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, CountSlots_u32(SLOT_FREE));
+    TEST_ASSERT_EQUAL_UINT32(3U * PUB_SLOTS_NUM, ackedCalls_u32s);
+    for(uint8_t idx_u8 = 0U; idx_u8 < EARLY_ACKS_NUM; idx_u8++)
+    {
+        TEST_ASSERT_EQUAL_INT32(0, earlyAcks_s32a[idx_u8]);
+    }
+}
+
+static void test_DisconnectReleasesWaitingSlots(void)
+{
+    for(uint32_t seq_u32 = 0U; seq_u32 < PUB_SLOTS_NUM; seq_u32++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, Publish_td(seq_u32, 1, OnAcked_vd));
+        RunMqttTask_vd();
+    }
+    fake_MqttEvent_vd(MQTT_EVENT_DISCONNECTED, 0);
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, CountSlots_u32(SLOT_FREE));
+
+    // acknowledges of the lost session neither release nor report anything
+    fake_AdvanceUs_vd(ACK_LATENCY_US);
+    (void)fake_MqttDeliverAcks_u32();
+    TEST_ASSERT_EQUAL_UINT32(0U, ackedCalls_u32s);
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, CountSlots_u32(SLOT_FREE));
+}
+
+static void test_ErrorReleasesWaitingSlots(void)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td(0U, 1, NULL));
+    RunMqttTask_vd();
+    TEST_ASSERT_EQUAL_UINT32(1U, CountSlots_u32(SLOT_WAIT_ACK));
+
+    fake_MqttEvent_vd(MQTT_EVENT_ERROR, 0);
+    TEST_ASSERT_EQUAL_UINT32(PUB_SLOTS_NUM, CountSlots_u32(SLOT_FREE));
+}
+
+static void test_AcknowledgeReportsTimeStamps(void)
+{
+    uint32_t startUs_u32 = (uint32_t)fake_nowUs_s64;
+
+    TEST_ASSERT_EQUAL(ESP_OK, Publish_td(0U, 1, OnAcked_vd));
+    fake_AdvanceUs_vd(500U);
+    RunMqttTask_vd();
+    fake_AdvanceUs_vd(ACK_LATENCY_US);
+    TEST_ASSERT_EQUAL_UINT32(1U, fake_MqttDeliverAcks_u32());
+
+    TEST_ASSERT_EQUAL_UINT32(1U, ackedCalls_u32s);
+    TEST_ASSERT_EQUAL_UINT32(startUs_u32, lastRxUs_u32s);
+    TEST_ASSERT_EQUAL_UINT32(startUs_u32, lastQueuedUs_u32s);
+    TEST_ASSERT_EQUAL_UINT32(startUs_u32 + 500U + ACK_LATENCY_US, lastAckUs_u32s);
+}
+
+/* publications per second of simulated time with a broker round trip of 20 ms, the
+   single slot of the former driver allowed one publication per round trip */
+static void test_BenchThroughputWithAckLatency(void)
+{
+    uint32_t sent_u32 = 0U;
+    int64_t startUs_s64 = fake_nowUs_s64;
+    uint64_t startNs_u64 = fake_HostNs_u64();
+    double simSec_f64;
+    double rate_f64;
+    char line_ca[96];
+
+    while(BENCH_MESSAGES > sent_u32)
+    {
+        if(ESP_OK == Publish_td(sent_u32, 1, NULL))
+        {
+            sent_u32++;
+            RunMqttTask_vd();
+        }
+        else
+        {
+            // all slots wait for their acknowledge
+            fake_AdvanceUs_vd(1000U);
+            (void)fake_MqttDeliverAcks_u32();
+        }
+    }
+    fake_Bench_vd("mqttdrv publish incl. simulated acks", BENCH_MESSAGES, 
+                    fake_HostNs_u64() - startNs_u64);
+
+    simSec_f64 = (double)(fake_nowUs_s64 - startUs_s64) / 1e6;
+    rate_f64 = (double)BENCH_MESSAGES / simSec_f64;
+    snprintf(line_ca, sizeof(line_ca), "%u slots: %.0f msg/s, single slot: %.0f msg/s",
+                PUB_SLOTS_NUM, rate_f64, 1e6 / ACK_LATENCY_US);
+    TEST_MESSAGE(line_ca);
+    TEST_ASSERT_TRUE(rate_f64 > (0.9 * PUB_SLOTS_NUM * 1e6 / (ACK_LATENCY_US + 1000U)));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_AllSlotsInFlightUntilAcknowledged);
+    RUN_TEST(test_QoS0ReleasesSlotAtOnce);
+    RUN_TEST(test_AcknowledgeBeforeMsgIdIsStored);
+    RUN_TEST(test_DisconnectReleasesWaitingSlots);
+    RUN_TEST(test_ErrorReleasesWaitingSlots);
+    RUN_TEST(test_AcknowledgeReportsTimeStamps);
+    RUN_TEST(test_BenchThroughputWithAckLatency);
+    return(UNITY_END());
+}
@@ -0,0 +1,359 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the topic index of mqttdrv. Received messages are handed to the
+*       event handler of the fake mqtt client and every subscription counts its
+*       callbacks. The benchmark dispatches 1M messages against 10, 100 and 1000
+*       subscriptions with '+' and '#' filters.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_mqtt.h"
+
+#include "utils.c"
+#include "mqttdrv.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define SUBS_MAX            1000U
+#define BENCH_MESSAGES      1000000U
+#define BENCH_TOPICS        64U         // distinct topics the benchmark cycles through
+
+/****************************************************************************************/
+/* Local variables: */
+
+static mqttdrv_subsHdl_t subs_xps[SUBS_MAX];
+static uint32_t subsNum_u32s;
+static uint32_t hits_u32sa[SUBS_MAX];
+static uint32_t received_u32s;
+static char lastData_cas[64];
+
+/****************************************************************************************/
+/* Local functions: */
+
+static void OnConnected_vd(void)
+{
+}
+
+static esp_err_t OnData_td(mqttif_msg_t *msg_stp)
+{
+    hits_u32sa[msg_stp->token_u32]++;
+    received_u32s++;
+    snprintf(lastData_cas, sizeof(lastData_cas), "%.*s", (int)msg_stp->dataLen_u32,
+                msg_stp->data_chp);
+    return(ESP_OK);
+}
+
+/* allocates and subscribes a filter, the token is the index of the subscription */
+static uint32_t AddSubs_u32(const char *filter_cchp)
+{
+    mqttif_substParam_t param_st;
+
+    memset(&param_st, 0, sizeof(param_st));
+    strncpy((char *)param_st.topic_u8a, filter_cchp, sizeof(param_st.topic_u8a) - 1U);
+    param_st.qos_u32 = 0U;
+    param_st.conn_fp = OnConnected_vd;
+    param_st.dataRecv_fp = OnData_td;
+    param_st.token_u32 = subsNum_u32s;
+    subs_xps[subsNum_u32s] = mqttdrv_AllocSubs_xp(&param_st);
+    TEST_ASSERT_NOT_NULL(subs_xps[subsNum_u32s]);
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_Subscribe_td(subs_xps[subsNum_u32s]));
+    return(subsNum_u32s++);
+}
+
+static void RemoveSubs_vd(uint32_t idx_u32)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_DeAllocSubs_st(subs_xps[idx_u32]));
+    subs_xps[idx_u32] = NULL;
+}
+
+static void Receive_vd(const char *topic_cchp, const char *data_cchp)
+{
+    int len_s32 = (int)strlen(data_cchp);
+
+    fake_MqttData_vd(topic_cchp, data_cchp, len_s32, 0, len_s32);
+}
+
+/* filters of the benchmark, ten devices per room, device 9 is a '+' filter and
+   device 0 the '#' filter of the room */
+static void AddBenchSubs_vd(uint32_t num_u32)
+{
+    char filter_ca[48];
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < num_u32; idx_u32++)
+    {
+        if(0U == (idx_u32 % 10U))
+        {
+            snprintf(filter_ca, sizeof(filter_ca), "home/r%u/#", idx_u32 / 10U);
+        }
+        else if(9U == (idx_u32 % 10U))
+        {
+            snprintf(filter_ca, sizeof(filter_ca), "home/r%u/+/hum", idx_u32 / 10U);
+        }
+        else
+        {
+            snprintf(filter_ca, sizeof(filter_ca), "home/r%u/d%u/temp", idx_u32 / 10U,
+                        idx_u32 % 10U);
+        }
+        (void)AddSubs_u32(filter_ca);
+    }
+}
+
+void setUp(void)
+{
+    mqttdrv_param_t param_st;
+
+    fake_MqttReset_vd();
+    memset(subs_xps, 0, sizeof(subs_xps));
+    memset(hits_u32sa, 0, sizeof(hits_u32sa));
+    subsNum_u32s = 0U;
+    received_u32s = 0U;
+
+    this_sst.state_en = STATE_NOT_INITIALIZED;
+    (void)mqttdrv_InitializeParameter_td(&param_st);
+    strcpy((char *)param_st.host_u8a, "127.0.0.1");
+    param_st.port_u32 = 1883U;
+    TEST_ASSERT_EQUAL(ESP_OK, mqttdrv_Initialize_td(&param_st));
+    TEST_ASSERT_EQUAL(ESP_OK, Connect());
+    fake_MqttEvent_vd(MQTT_EVENT_CONNECTED, 0);
+    TEST_ASSERT_EQUAL(STATE_CONNECTED, this_sst.state_en);
+}
+
+void tearDown(void)
+{
+    for(uint32_t idx_u32 = 0U; idx_u32 < subsNum_u32s; idx_u32++)
+    {
+        if(NULL != subs_xps[idx_u32])
+        {
+            RemoveSubs_vd(idx_u32);
+        }
+    }
+    // every level of the index is freed with its last subscription
+    TEST_ASSERT_EQUAL_UINT16(0U, topicRoot_sts.childsNum_u16);
+    TEST_ASSERT_NULL(topicRoot_sts.childs_stpp);
+    TEST_ASSERT_NULL(topicRoot_sts.wildOne_stp);
+    TEST_ASSERT_NULL(topicRoot_sts.wildAll_stp);
+    TEST_ASSERT_NULL(this_sst.subst_xp);
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_ExactFilterMatchesOnlyItsTopic(void)
+{
+    uint32_t subs_u32 = AddSubs_u32("home/kitchen/temp");
+
+    Receive_vd("home/kitchen/temp", "21.5");
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[subs_u32]);
+    TEST_ASSERT_EQUAL_STRING("21.5", lastData_cas);
+
+    // prefixes and extensions of the filter are different topics
+    Receive_vd("home/kitchen", "x");
+    Receive_vd("home/kitchen/te", "x");
+    Receive_vd("home/kitchen/temp/raw", "x");
+    Receive_vd("home/kitchen/tempx", "x");
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[subs_u32]);
+}
+
+static void test_TopicPrefixOfFilterDoesNotMatch(void)
+{
+    uint32_t long_u32 = AddSubs_u32("dev/cmd/reboot");
+    uint32_t short_u32 = AddSubs_u32("dev/cmd");
+
+    Receive_vd("dev/cmd", "1");
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[short_u32]);
+    TEST_ASSERT_EQUAL_UINT32(0U, hits_u32sa[long_u32]);
+}
+
+static void test_SingleLevelWildcard(void)
+{
+    uint32_t subs_u32 = AddSubs_u32("home/+/temp");
+
+    Receive_vd("home/kitchen/temp", "1");
+    Receive_vd("home/bath/temp", "2");
+    Receive_vd("home//temp", "3");
+    TEST_ASSERT_EQUAL_UINT32(3U, hits_u32sa[subs_u32]);
+
+    Receive_vd("home/temp", "x");
+    Receive_vd("home/kitchen/shelf/temp", "x");
+    Receive_vd("home/kitchen/hum", "x");
+    TEST_ASSERT_EQUAL_UINT32(3U, hits_u32sa[subs_u32]);
+}
+
+static void test_MultiLevelWildcard(void)
+{
+    uint32_t subs_u32 = AddSubs_u32("home/kitchen/#");
+    uint32_t all_u32 = AddSubs_u32("#");
+
+    Receive_vd("home/kitchen/temp", "1");
+    Receive_vd("home/kitchen/shelf/temp", "2");
+    // the wildcard also matches its parent level
+    Receive_vd("home/kitchen", "3");
+    TEST_ASSERT_EQUAL_UINT32(3U, hits_u32sa[subs_u32]);
+
+    Receive_vd("home/bath/temp", "x");
+    Receive_vd("home", "x");
+    TEST_ASSERT_EQUAL_UINT32(3U, hits_u32sa[subs_u32]);
+    TEST_ASSERT_EQUAL_UINT32(5U, hits_u32sa[all_u32]);
+}
+
+static void test_EveryMatchingFilterIsNotifiedOnce(void)
+{
+    uint32_t exact_u32 = AddSubs_u32("home/kitchen/temp");
+    uint32_t same_u32 = AddSubs_u32("home/kitchen/temp");
+    uint32_t one_u32 = AddSubs_u32("home/+/temp");
+    uint32_t all_u32 = AddSubs_u32("home/#");
+    uint32_t other_u32 = AddSubs_u32("home/+/hum");
+
+    Receive_vd("home/kitchen/temp", "1");
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[exact_u32]);
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[same_u32]);
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[one_u32]);
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[all_u32]);
+    TEST_ASSERT_EQUAL_UINT32(0U, hits_u32sa[other_u32]);
+    TEST_ASSERT_EQUAL_UINT32(4U, received_u32s);
+}
+
+static void test_RemovedSubscriptionIsNotNotified(void)
+{
+    uint32_t first_u32 = AddSubs_u32("home/kitchen/temp");
+    uint32_t second_u32 = AddSubs_u32("home/kitchen/temp");
+    uint32_t third_u32 = AddSubs_u32("home/+/temp");
+
+    // the head of the subscription list and of the node list
+    RemoveSubs_vd(first_u32);
+    TEST_ASSERT_EQUAL_UINT8(2U, mqttdrv_GetNumberOfSubscriptions_td());
+    Receive_vd("home/kitchen/temp", "1");
+    TEST_ASSERT_EQUAL_UINT32(0U, hits_u32sa[first_u32]);
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[second_u32]);
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[third_u32]);
+
+    RemoveSubs_vd(second_u32);
+    Receive_vd("home/kitchen/temp", "2");
+    TEST_ASSERT_EQUAL_UINT32(1U, hits_u32sa[second_u32]);
+    TEST_ASSERT_EQUAL_UINT32(2U, hits_u32sa[third_u32]);
+
+    // the exact level is pruned, the '+' level is still in use
+    TEST_ASSERT_EQUAL_UINT16(1U, topicRoot_sts.childsNum_u16);
+    TEST_ASSERT_EQUAL_UINT16(0U, topicRoot_sts.childs_stpp[0]->childsNum_u16);
+    TEST_ASSERT_NOT_NULL(topicRoot_sts.childs_stpp[0]->wildOne_stp);
+}
+
+static void test_SiblingLevelsStaySorted(void)
+{
+    uint32_t subs_u32a[40];
+    char topic_ca[32];
+    const topicNode_t *home_cstp;
+    const topicNode_t *prev_cstp;
+    const topicNode_t *next_cstp;
+
+    // rooms inserted out of order, with different level lengths
+    for(uint32_t idx_u32 = 0U; idx_u32 < 40U; idx_u32++)
+    {
+        snprintf(topic_ca, sizeof(topic_ca), "home/r%u/temp", (idx_u32 * 17U) % 41U);
+        subs_u32a[idx_u32] = AddSubs_u32(topic_ca);
+    }
+    home_cstp = topicRoot_sts.childs_stpp[0];
+    TEST_ASSERT_EQUAL_UINT16(40U, home_cstp->childsNum_u16);
+    for(uint16_t idx_u16 = 1U; idx_u16 < home_cstp->childsNum_u16; idx_u16++)
+    {
+        prev_cstp = home_cstp->childs_stpp[idx_u16 - 1U];
+        next_cstp = home_cstp->childs_stpp[idx_u16];
+        TEST_ASSERT_TRUE(   (prev_cstp->levelLen_u16 < next_cstp->levelLen_u16)
+                         || (   (prev_cstp->levelLen_u16 == next_cstp->levelLen_u16)
+                             && (0 > memcmp(prev_cstp->level_ca, next_cstp->level_ca,
+                                            prev_cstp->levelLen_u16))));
+    }
+
+    // every second room is removed, the others are still found
+    for(uint32_t idx_u32 = 0U; idx_u32 < 40U; idx_u32 += 2U)
+    {
+        RemoveSubs_vd(subs_u32a[idx_u32]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(20U, home_cstp->childsNum_u16);
+    for(uint32_t idx_u32 = 0U; idx_u32 < 40U; idx_u32++)
+    {
+        snprintf(topic_ca, sizeof(topic_ca), "home/r%u/temp", (idx_u32 * 17U) % 41U);
+        Receive_vd(topic_ca, "1");
+        TEST_ASSERT_EQUAL_UINT32(idx_u32 % 2U, hits_u32sa[subs_u32a[idx_u32]]);
+    }
+}
+
+/* messages per second dispatched against 10, 100 and 1000 subscriptions, each message
+   matches one exact or '+' filter and the '#' filter of its room */
+static void test_BenchDispatch(void)
+{
+    static const uint32_t SUBS_CU32A[] = {10U, 100U, 1000U};
+    static char topics_cas[BENCH_TOPICS][48];
+    char name_ca[48];
+    uint32_t rooms_u32;
+    uint32_t dev_u32;
+    uint64_t startNs_u64;
+
+    for(uint32_t run_u32 = 0U; run_u32 < 3U; run_u32++)
+    {
+        tearDown();
+        setUp();
+        AddBenchSubs_vd(SUBS_CU32A[run_u32]);
+        rooms_u32 = SUBS_CU32A[run_u32] / 10U;
+        for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_TOPICS; idx_u32++)
+        {
+            dev_u32 = 1U + (idx_u32 % 9U);
+            snprintf(topics_cas[idx_u32], sizeof(topics_cas[idx_u32]), "home/r%u/d%u/%s",
+                        (idx_u32 * 7U) % rooms_u32, dev_u32, (9U == dev_u32) ? "hum" : "temp");
+        }
+
+        startNs_u64 = fake_HostNs_u64();
+        for(uint32_t msg_u32 = 0U; msg_u32 < BENCH_MESSAGES; msg_u32++)
+        {
+            Receive_vd(topics_cas[msg_u32 % BENCH_TOPICS], "21.5");
+        }
+        snprintf(name_ca, sizeof(name_ca), "mqttdrv dispatch, %u subscriptions",
+                    SUBS_CU32A[run_u32]);
+        fake_Bench_vd(name_ca, BENCH_MESSAGES, fake_HostNs_u64() - startNs_u64);
+        TEST_ASSERT_EQUAL_UINT32(2U * BENCH_MESSAGES, received_u32s);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ExactFilterMatchesOnlyItsTopic);
+    RUN_TEST(test_TopicPrefixOfFilterDoesNotMatch);
+    RUN_TEST(test_SingleLevelWildcard);
+    RUN_TEST(test_MultiLevelWildcard);
+    RUN_TEST(test_EveryMatchingFilterIsNotifiedOnce);
+    RUN_TEST(test_RemovedSubscriptionIsNotNotified);
+    RUN_TEST(test_SiblingLevelsStaySorted);
+    RUN_TEST(test_BenchDispatch);
+    return(UNITY_END());
+}
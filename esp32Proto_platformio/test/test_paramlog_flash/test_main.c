@@ -0,0 +1,349 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host test of the append only log backend of paramif over the flash emulator,
+*       whose image can be stored in a file. The churn of health counters reports the
+*       write amplification and the erases per sector, power losses at every byte of an
+*       append or a sector header and at random points of the compaction check the
+*       recovery by the scan of the log.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include <unistd.h>
+#include "unity.h"
+#include "fake_partition.h"
+
+#include "paramlog.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define LOG_SECTORS         8U
+#define COUNTERS_NUM        10U         // health counters of 4 bytes
+#define STATS_LEN           100U        // sensor statistics record
+#define CHURN_WRITES        20000U
+#define POWER_CYCLES        300U
+#define REBOOT_PERIOD       5000U       // writes between two reboots of the churn
+
+/****************************************************************************************/
+/* Local variables: */
+
+static char keys_caa[COUNTERS_NUM][KEY_SIZE];
+static uint32_t expected_u32a[COUNTERS_NUM];
+static uint32_t seed_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static uint32_t Random_u32(void)
+{
+    seed_u32s = (seed_u32s * 1103515245U) + 12345U;
+    return(seed_u32s >> 8);
+}
+
+static uint32_t ReadCounter_u32(uint8_t idx_u8)
+{
+    uint32_t value_u32 = 0U;
+    size_t length_st = sizeof(value_u32);
+
+    TEST_ASSERT_EQUAL(ESP_OK, paramlog_Read_td(keys_caa[idx_u8], (uint8_t *)&value_u32,
+                                                &length_st));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(value_u32), length_st);
+    return(value_u32);
+}
+
+static void CheckCounters_vd(void)
+{
+    for(uint8_t idx_u8 = 0U; idx_u8 < COUNTERS_NUM; idx_u8++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(expected_u32a[idx_u8], ReadCounter_u32(idx_u8));
+    }
+}
+
+static uint32_t MinSectorErases_u32(void)
+{
+    fake_part_t *part_stp = fake_PartGet_stp(paramlog_PARTITION_LABEL);
+    uint32_t min_u32 = UINT32_MAX;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < LOG_SECTORS; idx_u32++)
+    {
+        min_u32 = (part_stp->erases_u32a[idx_u32] < min_u32) ?
+                    part_stp->erases_u32a[idx_u32] : min_u32;
+    }
+    return(min_u32);
+}
+
+void setUp(void)
+{
+    fake_PartSetup_vd(paramlog_PARTITION_LABEL, LOG_SECTORS * FAKE_PART_SECTOR_SIZE);
+    TEST_ASSERT_EQUAL(ESP_OK, paramlog_Initialize_td());
+    for(uint8_t idx_u8 = 0U; idx_u8 < COUNTERS_NUM; idx_u8++)
+    {
+        snprintf(keys_caa[idx_u8], KEY_SIZE, "health%u", idx_u8);
+        expected_u32a[idx_u8] = 0U;
+    }
+    seed_u32s = 0x5EEDU;
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+/* counters incremented round robin with reboots in between: the flash counters of the
+   emulator match the statistics of the log, the sectors wear evenly */
+static void test_ChurnWriteAmplification(void)
+{
+    fake_part_t *part_stp = fake_PartGet_stp(paramlog_PARTITION_LABEL);
+    uint8_t stats_u8a[STATS_LEN];
+    uint8_t read_u8a[STATS_LEN];
+    size_t length_st = sizeof(read_u8a);
+    paramlog_stats_t stats_st;
+    char line_ca[192];
+    uint8_t idx_u8;
+
+    memset(stats_u8a, 0x5A, sizeof(stats_u8a));
+    TEST_ASSERT_EQUAL(ESP_OK, paramlog_Write_td("sensStats", stats_u8a, STATS_LEN));
+    for(uint32_t write_u32 = 0U; write_u32 < CHURN_WRITES; write_u32++)
+    {
+        idx_u8 = write_u32 % COUNTERS_NUM;
+        expected_u32a[idx_u8]++;
+        TEST_ASSERT_EQUAL(ESP_OK, paramlog_Write_td(keys_caa[idx_u8],
+                                    (uint8_t *)&expected_u32a[idx_u8], sizeof(uint32_t)));
+        if(   ((REBOOT_PERIOD - 1U) == (write_u32 % REBOOT_PERIOD))
+           && ((write_u32 + 1U) < CHURN_WRITES))
+        {
+            TEST_ASSERT_EQUAL(ESP_OK, paramlog_Initialize_td());
+            CheckCounters_vd();
+        }
+    }
+    // the statistics were written once and survived all compactions
+    TEST_ASSERT_EQUAL(ESP_OK, paramlog_Read_td("sensStats", read_u8a, &length_st));
+    TEST_ASSERT_EQUAL_MEMORY(stats_u8a, read_u8a, STATS_LEN);
+
+    // the statistics of the last boot against the counters of the flash emulator
+    paramlog_GetStats_vd(&stats_st);
+    TEST_ASSERT_EQUAL_UINT32(REBOOT_PERIOD, stats_st.appends_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, part_stp->programErrors_u32);
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, stats_st.compactions_u32);
+    snprintf(line_ca, sizeof(line_ca), "paramlog %u writes of 4 bytes to %u sectors: "
+                "%u bytes programmed, %.1f bytes per write, %u erases, max %u min %u per "
+                "sector", CHURN_WRITES, LOG_SECTORS, part_stp->writtenBytes_u32,
+                (double)part_stp->writtenBytes_u32 / (CHURN_WRITES + 1U),
+                fake_PartErases_u32(paramlog_PARTITION_LABEL),
+                fake_PartMaxSectorErases_u32(paramlog_PARTITION_LABEL),
+                MinSectorErases_u32());
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+    snprintf(line_ca, sizeof(line_ca), "paramlog write amplification of the last boot: "
+                "%u user bytes, %u flash bytes, %.2f, %u relocated records",
+                stats_st.userBytes_u32, stats_st.flashBytes_u32,
+                (double)stats_st.flashBytes_u32 / stats_st.userBytes_u32,
+                stats_st.relocated_u32);
+    TEST_MESSAGE(line_ca);
+    printf("BENCH %s\n", line_ca);
+
+    // every sector is erased once per round through the log
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(MinSectorErases_u32() + 1U,
+                                fake_PartMaxSectorErases_u32(paramlog_PARTITION_LABEL));
+    // one 4 kB sector holds about 145 records of 28 bytes
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32((CHURN_WRITES / 100U) + LOG_SECTORS,
+                                        fake_PartErases_u32(paramlog_PARTITION_LABEL));
+}
+
+/* the flash image stored in a file is read by the next boot */
+static void test_FileBackedImage(void)
+{
+    char path_ca[64];
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < COUNTERS_NUM; idx_u8++)
+    {
+        expected_u32a[idx_u8] = 1000U + idx_u8;
+        TEST_ASSERT_EQUAL(ESP_OK, paramlog_Write_td(keys_caa[idx_u8],
+                                    (uint8_t *)&expected_u32a[idx_u8], sizeof(uint32_t)));
+    }
+    snprintf(path_ca, sizeof(path_ca), "%s/paramlog_%d.bin", P_tmpdir, (int)getpid());
+    TEST_ASSERT_TRUE(fake_PartSave_bol(paramlog_PARTITION_LABEL, path_ca));
+
+    fake_PartSetup_vd(paramlog_PARTITION_LABEL, LOG_SECTORS * FAKE_PART_SECTOR_SIZE);
+    TEST_ASSERT_TRUE(fake_PartLoad_bol(paramlog_PARTITION_LABEL, path_ca));
+    (void)remove(path_ca);
+    TEST_ASSERT_EQUAL(ESP_OK, paramlog_Initialize_td());
+    CheckCounters_vd();
+}
+
+/* a power loss at every byte of an append keeps the old or gives the new value */
+static void test_PowerLossDuringAppend(void)
+{
+    uint32_t value_u32;
+    uint32_t read_u32;
+    esp_err_t result_st;
+
+    expected_u32a[0] = 1U;
+    TEST_ASSERT_EQUAL(ESP_OK, paramlog_Write_td(keys_caa[0],
+                                    (uint8_t *)&expected_u32a[0], sizeof(uint32_t)));
+    for(int32_t budget_s32 = 0; budget_s32 <= (int32_t)(RECORD_HDR_SIZE + 4U);
+        budget_s32++)
+    {
+        value_u32 = expected_u32a[0] + 1U;
+        fake_partWriteBudget_s32 = budget_s32;
+        result_st = paramlog_Write_td(keys_caa[0], (uint8_t *)&value_u32,
+                                        sizeof(value_u32));
+        fake_PartPowerOn_vd();
+        TEST_ASSERT_EQUAL(ESP_OK, paramlog_Initialize_td());
+        read_u32 = ReadCounter_u32(0U);
+        if(ESP_OK == result_st)
+        {
+            TEST_ASSERT_EQUAL_UINT32(value_u32, read_u32);
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_UINT32(expected_u32a[0], read_u32);
+        }
+        expected_u32a[0] = read_u32;
+
+        // the log is usable after the recovery
+        value_u32 = expected_u32a[0] + 1U;
+        TEST_ASSERT_EQUAL(ESP_OK, paramlog_Write_td(keys_caa[0], (uint8_t *)&value_u32,
+                                                    sizeof(value_u32)));
+        expected_u32a[0] = value_u32;
+        TEST_ASSERT_EQUAL(ESP_OK, paramlog_Initialize_td());
+        TEST_ASSERT_EQUAL_UINT32(expected_u32a[0], ReadCounter_u32(0U));
+    }
+}
+
+/* a power loss while the header of the next sector is written: the torn sector is not
+   taken as head of the log, the ring keeps its order for the following rounds */
+static void test_PowerLossDuringSectorOpen(void)
+{
+    uint32_t value_u32;
+    esp_err_t result_st;
+
+    for(int32_t budget_s32 = 0; budget_s32 <= (int32_t)SECTOR_HDR_SIZE; budget_s32++)
+    {
+        setUp();
+        // fill the first sector up to the last record
+        do
+        {
+            expected_u32a[0]++;
+            TEST_ASSERT_EQUAL(ESP_OK, paramlog_Write_td(keys_caa[0],
+                                        (uint8_t *)&expected_u32a[0], sizeof(uint32_t)));
+        }while(   (this_sst.headOffset_u32 + RECORD_HDR_SIZE + sizeof(value_u32))
+               <= SECTOR_SIZE);
+        value_u32 = expected_u32a[0] + 1U;
+        fake_partWriteBudget_s32 = budget_s32;
+        result_st = paramlog_Write_td(keys_caa[0], (uint8_t *)&value_u32,
+                                        sizeof(value_u32));
+        TEST_ASSERT_NOT_EQUAL(ESP_OK, result_st);
+        fake_PartPowerOn_vd();
+        TEST_ASSERT_EQUAL(ESP_OK, paramlog_Initialize_td());
+        TEST_ASSERT_EQUAL_UINT32(expected_u32a[0], ReadCounter_u32(0U));
+
+        // two rounds through the ring with a reboot per sector
+        for(uint32_t write_u32 = 0U; write_u32 < (2U * LOG_SECTORS * 150U); write_u32++)
+        {
+            expected_u32a[write_u32 % 2U]++;
+            TEST_ASSERT_EQUAL(ESP_OK, paramlog_Write_td(keys_caa[write_u32 % 2U],
+                            (uint8_t *)&expected_u32a[write_u32 % 2U], sizeof(uint32_t)));
+            if(149U == (write_u32 % 150U))
+            {
+                TEST_ASSERT_EQUAL(ESP_OK, paramlog_Initialize_td());
+                TEST_ASSERT_EQUAL_UINT32(expected_u32a[0], ReadCounter_u32(0U));
+                TEST_ASSERT_EQUAL_UINT32(expected_u32a[1], ReadCounter_u32(1U));
+            }
+        }
+    }
+}
+
+/* power losses at random bytes of a churn with compactions: after the recovery by the
+   scan of the log every key holds its last acknowledged value or the interrupted one */
+static void test_PowerLossDuringCompaction(void)
+{
+    paramlog_stats_t stats_st;
+    uint32_t compactions_u32 = 0U;
+    uint32_t value_u32;
+    uint32_t read_u32;
+    uint8_t idx_u8 = 0U;
+
+    for(uint8_t key_u8 = 0U; key_u8 < COUNTERS_NUM; key_u8++)
+    {
+        TEST_ASSERT_EQUAL(ESP_OK, paramlog_Write_td(keys_caa[key_u8],
+                                    (uint8_t *)&expected_u32a[key_u8], sizeof(uint32_t)));
+    }
+
+    for(uint32_t cycle_u32 = 0U; cycle_u32 < POWER_CYCLES; cycle_u32++)
+    {
+        fake_partWriteBudget_s32 = (int32_t)(Random_u32() % (2U * FAKE_PART_SECTOR_SIZE));
+        do
+        {
+            idx_u8 = Random_u32() % COUNTERS_NUM;
+            value_u32 = expected_u32a[idx_u8] + 1U;
+            if(ESP_OK == paramlog_Write_td(keys_caa[idx_u8], (uint8_t *)&value_u32,
+                                            sizeof(value_u32)))
+            {
+                expected_u32a[idx_u8] = value_u32;
+            }
+        }while(false == fake_partPowerLost_bol);
+        paramlog_GetStats_vd(&stats_st);
+        compactions_u32 += stats_st.compactions_u32;
+
+        fake_PartPowerOn_vd();
+        TEST_ASSERT_EQUAL(ESP_OK, paramlog_Initialize_td());
+        for(uint8_t key_u8 = 0U; key_u8 < COUNTERS_NUM; key_u8++)
+        {
+            read_u32 = ReadCounter_u32(key_u8);
+            if(key_u8 == idx_u8)
+            {
+                TEST_ASSERT_TRUE(   (expected_u32a[key_u8] == read_u32)
+                                 || ((expected_u32a[key_u8] + 1U) == read_u32));
+                expected_u32a[key_u8] = read_u32;
+            }
+            else
+            {
+                TEST_ASSERT_EQUAL_UINT32(expected_u32a[key_u8], read_u32);
+            }
+        }
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(POWER_CYCLES / 4U, compactions_u32);
+    TEST_ASSERT_EQUAL_UINT32(0U, fake_PartGet_stp(paramlog_PARTITION_LABEL)
+                                    ->programErrors_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ChurnWriteAmplification);
+    RUN_TEST(test_FileBackedImage);
+    RUN_TEST(test_PowerLossDuringAppend);
+    RUN_TEST(test_PowerLossDuringSectorOpen);
+    RUN_TEST(test_PowerLossDuringCompaction);
+    return(UNITY_END());
+}
@@ -0,0 +1,300 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host test of the sensor history, the incremental aggregates of the 1 min, 15 min
+*       and 1 h windows are compared with a brute force evaluation of all samples, the
+*       ring with the samples of the trace. The benchmark measures the cost of a sample.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include "unity.h"
+#include "fake_esp.h"
+
+#include "sensHist.c"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define TRACE_SAMPLES       20000U
+#define BENCH_SAMPLES       1000000U
+
+/****************************************************************************************/
+/* Local variables: */
+
+static sensHist_sample_t trace_sta[TRACE_SAMPLES];
+static sensHist_series_t series_st;
+static uint32_t seed_u32s;
+
+/****************************************************************************************/
+/* Local functions: */
+
+static uint32_t Random_u32(void)
+{
+    seed_u32s = (seed_u32s * 1103515245U) + 12345U;
+    return(seed_u32s >> 8);
+}
+
+/* sensor like trace: irregular gaps with outages of hours, small steps with some jumps
+   to the limits of int16, so the coding uses every varint length */
+static void BuildTrace_vd(void)
+{
+    uint32_t time_u32 = 1U;
+    int32_t value_s32a[sensHist_CH_NUM] = {215, 480};
+    uint32_t dice_u32;
+
+    seed_u32s = 0x5E45U;
+    for(uint32_t idx_u32 = 0U; idx_u32 < TRACE_SAMPLES; idx_u32++)
+    {
+        dice_u32 = Random_u32() % 1000U;
+        time_u32 += (5U > dice_u32) ? (3600U + (Random_u32() % 10000U)) :
+                    (100U > dice_u32) ? 0U : (1U + (Random_u32() % 90U));
+        for(uint8_t ch_u8 = 0U; ch_u8 < sensHist_CH_NUM; ch_u8++)
+        {
+            dice_u32 = Random_u32() % 1000U;
+            if(3U > dice_u32)
+            {
+                value_s32a[ch_u8] = (0U == (dice_u32 & 1U)) ? INT16_MIN : INT16_MAX;
+            }
+            else if(10U > dice_u32)
+            {
+                value_s32a[ch_u8] = (int32_t)(Random_u32() % 65536U) + INT16_MIN;
+            }
+            else
+            {
+                value_s32a[ch_u8] += (int32_t)(Random_u32() % 7U) - 3;
+                value_s32a[ch_u8] = (INT16_MAX < value_s32a[ch_u8]) ? INT16_MAX :
+                                    (INT16_MIN > value_s32a[ch_u8]) ? INT16_MIN :
+                                    value_s32a[ch_u8];
+            }
+            trace_sta[idx_u32].value_s16a[ch_u8] = (int16_t)value_s32a[ch_u8];
+        }
+        trace_sta[idx_u32].time_u32 = time_u32;
+    }
+}
+
+/* brute force: the last window before the window of now which holds samples, built
+   from all samples added so far */
+static void BruteForce_vd(uint32_t added_u32, uint32_t now_u32, uint32_t len_u32,
+                            sensHist_aggregate_t *agg_stp)
+{
+    uint32_t start_u32 = 0U;
+    uint32_t time_u32;
+    bool found_bol = false;
+
+    memset(agg_stp, 0, sizeof(sensHist_aggregate_t));
+    for(uint32_t idx_u32 = added_u32; (0U < idx_u32) && (false == found_bol); idx_u32--)
+    {
+        time_u32 = trace_sta[idx_u32 - 1U].time_u32;
+        if((time_u32 - (time_u32 % len_u32)) < (now_u32 - (now_u32 % len_u32)))
+        {
+            start_u32 = time_u32 - (time_u32 % len_u32);
+            found_bol = true;
+        }
+    }
+    if(true == found_bol)
+    {
+        agg_stp->start_u32 = start_u32;
+        for(uint8_t ch_u8 = 0U; ch_u8 < sensHist_CH_NUM; ch_u8++)
+        {
+            agg_stp->min_s16a[ch_u8] = INT16_MAX;
+            agg_stp->max_s16a[ch_u8] = INT16_MIN;
+        }
+        for(uint32_t idx_u32 = 0U; idx_u32 < added_u32; idx_u32++)
+        {
+            time_u32 = trace_sta[idx_u32].time_u32;
+            if((time_u32 - (time_u32 % len_u32)) == start_u32)
+            {
+                agg_stp->count_u32++;
+                for(uint8_t ch_u8 = 0U; ch_u8 < sensHist_CH_NUM; ch_u8++)
+                {
+                    if(trace_sta[idx_u32].value_s16a[ch_u8] < agg_stp->min_s16a[ch_u8])
+                    {
+                        agg_stp->min_s16a[ch_u8] = trace_sta[idx_u32].value_s16a[ch_u8];
+                    }
+                    if(trace_sta[idx_u32].value_s16a[ch_u8] > agg_stp->max_s16a[ch_u8])
+                    {
+                        agg_stp->max_s16a[ch_u8] = trace_sta[idx_u32].value_s16a[ch_u8];
+                    }
+                    agg_stp->sum_s32a[ch_u8] += trace_sta[idx_u32].value_s16a[ch_u8];
+                }
+            }
+        }
+    }
+}
+
+static void CheckAggregates_vd(uint32_t added_u32, uint32_t now_u32)
+{
+    sensHist_aggregate_t expected_st;
+    const sensHist_aggregate_t *agg_cstp;
+
+    for(uint8_t win_u8 = 0U; win_u8 < sensHist_WIN_NUM; win_u8++)
+    {
+        BruteForce_vd(added_u32, now_u32,
+                        sensHist_GetWindowLength_u32((sensHist_window_t)win_u8),
+                        &expected_st);
+        agg_cstp = sensHist_GetAggregate_cstp(&series_st, (sensHist_window_t)win_u8);
+        TEST_ASSERT_EQUAL_UINT32(expected_st.count_u32, agg_cstp->count_u32);
+        if(0U < expected_st.count_u32)
+        {
+            TEST_ASSERT_EQUAL_MEMORY(&expected_st, agg_cstp, sizeof(sensHist_aggregate_t));
+        }
+    }
+}
+
+/* the ring holds the newest samples of the trace without gap */
+static void CheckRing_vd(uint32_t added_u32)
+{
+    sensHist_iter_t iter_st;
+    uint32_t idx_u32;
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, series_st.samples_u16);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(sensHist_RING_BYTES, series_st.used_u16);
+    idx_u32 = added_u32 - series_st.samples_u16;
+    sensHist_IterStart_vd(&series_st, &iter_st);
+    while(true == sensHist_IterNext_bol(&series_st, &iter_st))
+    {
+        TEST_ASSERT_EQUAL_MEMORY(&trace_sta[idx_u32], &iter_st.sample_st,
+                                    sizeof(sensHist_sample_t));
+        idx_u32++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(added_u32, idx_u32);
+    // the oldest sample is only dropped if the next one would not fit
+    TEST_ASSERT_GREATER_THAN_UINT32(sensHist_RING_BYTES - SAMPLE_MAX_BYTES,
+                                    (added_u32 > series_st.samples_u16) ?
+                                    series_st.used_u16 : sensHist_RING_BYTES);
+}
+
+void setUp(void)
+{
+    memset(&series_st, 0, sizeof(series_st));
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_WindowsAreAligned(void)
+{
+    sensHist_sample_t sample_st = {59U, {100, 500}};
+    const sensHist_aggregate_t *agg_cstp;
+
+    sensHist_AddSample_vd(&series_st, &sample_st);
+    sample_st.time_u32 = 60U;
+    sample_st.value_s16a[0] = -100;
+    sensHist_AddSample_vd(&series_st, &sample_st);
+
+    // the first sample closed its minute alone, the hour is still open
+    agg_cstp = sensHist_GetAggregate_cstp(&series_st, sensHist_WIN_1MIN);
+    TEST_ASSERT_EQUAL_UINT32(0U, agg_cstp->start_u32);
+    TEST_ASSERT_EQUAL_UINT32(1U, agg_cstp->count_u32);
+    TEST_ASSERT_EQUAL_INT16(100, agg_cstp->max_s16a[sensHist_CH_TEMP]);
+    TEST_ASSERT_EQUAL_UINT32(0U, sensHist_GetAggregate_cstp(&series_st,
+                                                    sensHist_WIN_1H)->count_u32);
+
+    // a silent sensor closes its windows with the time
+    sensHist_CloseWindows_vd(&series_st, 3599U);
+    TEST_ASSERT_EQUAL_UINT32(0U, sensHist_GetAggregate_cstp(&series_st,
+                                                    sensHist_WIN_1H)->count_u32);
+    sensHist_CloseWindows_vd(&series_st, 3600U);
+    agg_cstp = sensHist_GetAggregate_cstp(&series_st, sensHist_WIN_1H);
+    TEST_ASSERT_EQUAL_UINT32(2U, agg_cstp->count_u32);
+    TEST_ASSERT_EQUAL_INT16(-100, agg_cstp->min_s16a[sensHist_CH_TEMP]);
+    TEST_ASSERT_EQUAL_INT16(100, agg_cstp->max_s16a[sensHist_CH_TEMP]);
+    TEST_ASSERT_EQUAL(0, agg_cstp->sum_s32a[sensHist_CH_TEMP]);
+    TEST_ASSERT_EQUAL(1000, agg_cstp->sum_s32a[sensHist_CH_HUM]);
+
+    TEST_ASSERT_NULL(sensHist_GetAggregate_cstp(&series_st, sensHist_WIN_NUM));
+}
+
+/* the aggregates after every sample and at times between the samples */
+static void test_IncrementalAgainstBruteForce(void)
+{
+    uint32_t now_u32;
+
+    for(uint32_t idx_u32 = 0U; idx_u32 < TRACE_SAMPLES; idx_u32++)
+    {
+        sensHist_AddSample_vd(&series_st, &trace_sta[idx_u32]);
+        CheckAggregates_vd(idx_u32 + 1U, trace_sta[idx_u32].time_u32);
+
+        if(0U == (idx_u32 % 7U))
+        {
+            // the timer of the sensor module closes windows without sample
+            now_u32 = trace_sta[idx_u32].time_u32 + (Random_u32() % 4000U);
+            if(   ((idx_u32 + 1U) < TRACE_SAMPLES)
+               && (now_u32 <= trace_sta[idx_u32 + 1U].time_u32))
+            {
+                sensHist_CloseWindows_vd(&series_st, now_u32);
+                CheckAggregates_vd(idx_u32 + 1U, now_u32);
+            }
+        }
+    }
+}
+
+static void test_RingKeepsNewestSamples(void)
+{
+    for(uint32_t idx_u32 = 0U; idx_u32 < TRACE_SAMPLES; idx_u32++)
+    {
+        sensHist_AddSample_vd(&series_st, &trace_sta[idx_u32]);
+        CheckRing_vd(idx_u32 + 1U);
+    }
+}
+
+/* cost of a sample does not depend on the number of samples in the windows */
+static void test_BenchAddSample(void)
+{
+    sensHist_sample_t sample_st = {0U, {215, 480}};
+    uint64_t startNs_u64;
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_SAMPLES; idx_u32++)
+    {
+        sample_st.time_u32 += 1U + (idx_u32 & 15U);
+        sample_st.value_s16a[0] = (int16_t)(215 + (int32_t)(idx_u32 % 11U) - 5);
+        sample_st.value_s16a[1] = (int16_t)(480 + (int32_t)(idx_u32 % 7U) - 3);
+        sensHist_AddSample_vd(&series_st, &sample_st);
+    }
+    fake_Bench_vd("sensHist_AddSample_vd", BENCH_SAMPLES, fake_HostNs_u64() - startNs_u64);
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, sensHist_GetAggregate_cstp(&series_st,
+                                                    sensHist_WIN_1H)->count_u32);
+}
+
+int main(int argc, char **argv)
+{
+    BuildTrace_vd();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_WindowsAreAligned);
+    RUN_TEST(test_IncrementalAgainstBruteForce);
+    RUN_TEST(test_RingKeepsNewestSamples);
+    RUN_TEST(test_BenchAddSample);
+    return(UNITY_END());
+}
@@ -0,0 +1 @@
+#include "mijaProcl.c"
@@ -0,0 +1,214 @@
+/*****************************************************************************************
+* FILENAME :        test_main.c
+*
+* DESCRIPTION :
+*       Host tests of the fixed point formatter of the utils module, checked against a
+*       64 bit integer reference over the sensor range and the limits of int32. The
+*       conversion of negative raw temperatures is checked as well, the benchmark
+*       compares the formatter with the former sprintf of the float value.
+*
+* AUTHOR :    Stephan Wink        CREATED ON :    17.10.2026
+*
+* Copyright (c) [2026] [Stephan Wink]
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*****************************************************************************************/
+
+/****************************************************************************************/
+/* Include Interfaces */
+
+#include <limits.h>
+#include "unity.h"
+#include "fake_freertos.h"
+#include "fake_ccm.h"
+
+#include "utils.c"
+#include "mijaProcl.h"
+
+/****************************************************************************************/
+/* Local constant defines */
+
+#define BENCH_VALUES        1000000U
+#define STRING_SIZE         13U         // size required by utils_FixedPointToString_u32
+
+/****************************************************************************************/
+/* Local functions: */
+
+/* reference: the value scaled with 64 bit integers, so INT32_MIN is exact as well */
+static void Reference_vd(int32_t value_s32, uint8_t decimals_u8, char *buffer_chp)
+{
+    int64_t value_s64 = value_s32;
+    uint64_t magnitude_u64 = (uint64_t)((0 > value_s64) ? -value_s64 : value_s64);
+    uint64_t scale_u64 = 1U;
+
+    for(uint8_t idx_u8 = 0U; idx_u8 < decimals_u8; idx_u8++)
+    {
+        scale_u64 *= 10U;
+    }
+    if(0U == decimals_u8)
+    {
+        sprintf(buffer_chp, "%s%llu", (0 > value_s64) ? "-" : "",
+                (unsigned long long)magnitude_u64);
+    }
+    else
+    {
+        sprintf(buffer_chp, "%s%llu.%0*llu", (0 > value_s64) ? "-" : "",
+                (unsigned long long)(magnitude_u64 / scale_u64), (int)decimals_u8,
+                (unsigned long long)(magnitude_u64 % scale_u64));
+    }
+}
+
+static void CheckValue_vd(int32_t value_s32, uint8_t decimals_u8)
+{
+    char result_ca[STRING_SIZE];
+    char expected_ca[32];
+    uint32_t length_u32;
+
+    Reference_vd(value_s32, decimals_u8, expected_ca);
+    length_u32 = utils_FixedPointToString_u32(value_s32, decimals_u8, result_ca);
+    TEST_ASSERT_EQUAL_STRING(expected_ca, result_ca);
+    TEST_ASSERT_EQUAL_UINT32(strlen(expected_ca), length_u32);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/****************************************************************************************/
+/* Tests: */
+
+static void test_SensorValues(void)
+{
+    char result_ca[STRING_SIZE];
+
+    TEST_ASSERT_EQUAL_UINT32(4U, utils_FixedPointToString_u32(206, 1U, result_ca));
+    TEST_ASSERT_EQUAL_STRING("20.6", result_ca);
+    TEST_ASSERT_EQUAL_UINT32(5U, utils_FixedPointToString_u32(-206, 1U, result_ca));
+    TEST_ASSERT_EQUAL_STRING("-20.6", result_ca);
+    utils_FixedPointToString_u32(0, 1U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("0.0", result_ca);
+    // values below one keep the leading zero and the sign
+    utils_FixedPointToString_u32(-5, 1U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("-0.5", result_ca);
+    utils_FixedPointToString_u32(7, 2U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("0.07", result_ca);
+    utils_FixedPointToString_u32(1000, 1U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("100.0", result_ca);
+    utils_FixedPointToString_u32(93, 0U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("93", result_ca);
+}
+
+static void test_LimitsOfTheRange(void)
+{
+    char result_ca[STRING_SIZE];
+
+    TEST_ASSERT_EQUAL_UINT32(11U, utils_FixedPointToString_u32(INT_MIN, 0U, result_ca));
+    TEST_ASSERT_EQUAL_STRING("-2147483648", result_ca);
+    TEST_ASSERT_EQUAL_UINT32(12U, utils_FixedPointToString_u32(INT_MIN, 1U, result_ca));
+    TEST_ASSERT_EQUAL_STRING("-214748364.8", result_ca);
+    utils_FixedPointToString_u32(INT_MAX, 9U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("2.147483647", result_ca);
+    // the longest string: sign, ten digits and the point, 13 bytes with the zero
+    TEST_ASSERT_EQUAL_UINT32(12U, utils_FixedPointToString_u32(INT_MIN, 9U, result_ca));
+    TEST_ASSERT_EQUAL_STRING("-2.147483648", result_ca);
+    utils_FixedPointToString_u32(-1, 9U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("-0.000000001", result_ca);
+}
+
+static void test_AgainstReference(void)
+{
+    uint32_t seed_u32 = 0x5EEDU;
+
+    // every value of the int16 sensor range
+    for(int32_t value_s32 = INT16_MIN; value_s32 <= INT16_MAX; value_s32++)
+    {
+        CheckValue_vd(value_s32, 1U);
+        CheckValue_vd(value_s32, 2U);
+    }
+    // random values with all decimal places
+    for(uint32_t idx_u32 = 0U; idx_u32 < 100000U; idx_u32++)
+    {
+        seed_u32 = (seed_u32 * 1103515245U) + 12345U;
+        CheckValue_vd((int32_t)((seed_u32 << 16) ^ (seed_u32 >> 8)),
+                        (uint8_t)(idx_u32 % 10U));
+    }
+}
+
+/* negative temperatures arrive as two's complement in the raw u16 value */
+static void test_NegativeTemperatureConversion(void)
+{
+    mijaProcl_rawSample_t raw_st;
+    mijaProcl_parsedData_t parsed_st;
+    char result_ca[STRING_SIZE];
+
+    memset(&raw_st, 0, sizeof(raw_st));
+    raw_st.dataType_u8 = mija_TYPE_TEMPHUM;
+    raw_st.value1_u16 = (uint16_t)-153;
+    raw_st.value2_u16 = 871U;
+    TEST_ASSERT_TRUE(mijaProcl_ConvertRawSample_bol(&raw_st, &parsed_st));
+    TEST_ASSERT_EQUAL_INT16(-153, parsed_st.temperature_s16);
+    utils_FixedPointToString_u32(parsed_st.temperature_s16, 1U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("-15.3", result_ca);
+    utils_FixedPointToString_u32(parsed_st.humidity_u16, 1U, result_ca);
+    TEST_ASSERT_EQUAL_STRING("87.1", result_ca);
+}
+
+/* the formatter against the former float conversion with sprintf */
+static void test_BenchAgainstSprintf(void)
+{
+    char result_ca[STRING_SIZE];
+    volatile uint32_t length_u32 = 0U;
+    int16_t value_s16;
+    uint64_t startNs_u64;
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_VALUES; idx_u32++)
+    {
+        value_s16 = (int16_t)((int32_t)(idx_u32 % 1200U) - 400);
+        length_u32 += (uint32_t)sprintf(result_ca, "%.2f", (float)value_s16 / 10.0F);
+    }
+    fake_Bench_vd("sprintf %.2f of value / 10.0F", BENCH_VALUES,
+                    fake_HostNs_u64() - startNs_u64);
+
+    startNs_u64 = fake_HostNs_u64();
+    for(uint32_t idx_u32 = 0U; idx_u32 < BENCH_VALUES; idx_u32++)
+    {
+        value_s16 = (int16_t)((int32_t)(idx_u32 % 1200U) - 400);
+        length_u32 += utils_FixedPointToString_u32(value_s16, 1U, result_ca);
+    }
+    fake_Bench_vd("utils_FixedPointToString_u32", BENCH_VALUES,
+                    fake_HostNs_u64() - startNs_u64);
+    TEST_ASSERT_GREATER_THAN_UINT32(0U, length_u32);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_SensorValues);
+    RUN_TEST(test_LimitsOfTheRange);
+    RUN_TEST(test_AgainstReference);
+    RUN_TEST(test_NegativeTemperatureConversion);
+    RUN_TEST(test_BenchAgainstSprintf);
+    return(UNITY_END());
+}